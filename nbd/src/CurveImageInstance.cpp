@@ -0,0 +1,175 @@
+/*
+ *     Copyright (c) 2020 NetEase Inc.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Project: curve
+ * Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "nbd/src/CurveImageInstance.h"
+
+#include <errno.h>
+#include <glog/logging.h>
+
+namespace curve {
+namespace nbd {
+
+namespace {
+
+// libcurve的请求上下文，数据直接读写nbd请求的buffer，不做额外拷贝
+struct CurveNbdAioContext {
+    CurveAioContext curveCtx;
+    NebdClientAioContext* nbdCtx;
+};
+
+void CurveNbdAioCallback(CurveAioContext* curveCtx) {
+    auto ctx = reinterpret_cast<CurveNbdAioContext*>(
+        reinterpret_cast<char*>(curveCtx) -
+        offsetof(CurveNbdAioContext, curveCtx));
+    NebdClientAioContext* nbdCtx = ctx->nbdCtx;
+    if (curveCtx->ret < 0) {
+        LOG(ERROR) << "curve aio request failed, op = " << curveCtx->op
+                   << ", offset = " << curveCtx->offset
+                   << ", length = " << curveCtx->length
+                   << ", ret = " << curveCtx->ret;
+        nbdCtx->ret = -EIO;
+    } else {
+        nbdCtx->ret = 0;
+    }
+    delete ctx;
+    nbdCtx->cb(nbdCtx);
+}
+
+}  // namespace
+
+std::string CurveImageInstance::ParseFileName(const std::string& imageName) {
+    auto beginPos = imageName.find_first_of("/");
+    if (beginPos == std::string::npos) {
+        return "";
+    }
+    beginPos += 1;
+
+    auto endPos = imageName.find_last_of(":");
+    if (endPos == std::string::npos || endPos < beginPos) {
+        endPos = imageName.length();
+    }
+
+    if (endPos - beginPos <= 2) {
+        return "";
+    }
+
+    return imageName.substr(beginPos, endPos - beginPos);
+}
+
+bool CurveImageInstance::Open() {
+    fileName_ = ParseFileName(imageName_);
+    if (fileName_.empty()) {
+        LOG(ERROR) << "invalid image name: " << imageName_;
+        return false;
+    }
+
+    int ret = client_->Init(confPath_);
+    if (ret != 0) {
+        LOG(ERROR) << "init curve client failed, conf path = " << confPath_
+                   << ", ret = " << ret;
+        return false;
+    }
+
+    std::string sessionId;
+    ret = client_->Open(fileName_, &sessionId);
+    if (ret < 0) {
+        LOG(ERROR) << "open image failed, filename = " << fileName_
+                   << ", ret = " << ret;
+        client_->UnInit();
+        return false;
+    }
+
+    curveFd_ = ret;
+    return true;
+}
+
+void CurveImageInstance::Close() {
+    client_->Close(curveFd_);
+    client_->UnInit();
+    curveFd_ = -1;
+}
+
+void CurveImageInstance::AioRead(NebdClientAioContext* context) {
+    SubmitAio(context, LIBCURVE_OP::LIBCURVE_OP_READ);
+}
+
+void CurveImageInstance::AioWrite(NebdClientAioContext* context) {
+    SubmitAio(context, LIBCURVE_OP::LIBCURVE_OP_WRITE);
+}
+
+void CurveImageInstance::Trim(NebdClientAioContext* context) {
+    // libcurve不支持discard，与nebd-server的处理保持一致直接返回成功
+    context->ret = 0;
+    context->cb(context);
+}
+
+void CurveImageInstance::Flush(NebdClientAioContext* context) {
+    // libcurve的写请求返回时数据已经持久化，
+    // flush只需要覆盖已经返回的写请求，可以直接返回成功
+    context->ret = 0;
+    context->cb(context);
+}
+
+int64_t CurveImageInstance::GetImageSize() {
+    return client_->StatFile(fileName_);
+}
+
+void CurveImageInstance::SubmitAio(NebdClientAioContext* context,
+                                   LIBCURVE_OP op) {
+    CurveNbdAioContext* ctx = new CurveNbdAioContext();
+    ctx->nbdCtx = context;
+    ctx->curveCtx.offset = context->offset;
+    ctx->curveCtx.length = context->length;
+    ctx->curveCtx.op = op;
+    ctx->curveCtx.buf = context->buf;
+    ctx->curveCtx.cb = CurveNbdAioCallback;
+
+    int ret = 0;
+    if (op == LIBCURVE_OP::LIBCURVE_OP_READ) {
+        ret = client_->AioRead(curveFd_, &ctx->curveCtx,
+                               curve::client::UserDataType::RawBuffer);
+    } else {
+        ret = client_->AioWrite(curveFd_, &ctx->curveCtx,
+                                curve::client::UserDataType::RawBuffer);
+    }
+
+    if (ret != LIBCURVE_ERROR::OK) {
+        LOG(ERROR) << "submit curve aio request failed, op = " << op
+                   << ", offset = " << context->offset
+                   << ", length = " << context->length
+                   << ", ret = " << ret;
+        delete ctx;
+        context->ret = -EIO;
+        context->cb(context);
+    }
+}
+
+CurveImageInstance::~CurveImageInstance() {
+    if (curveFd_ != -1) {
+        Close();
+    }
+}
+
+}  // namespace nbd
+}  // namespace curve
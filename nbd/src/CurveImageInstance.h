@@ -0,0 +1,88 @@
+/*
+ *     Copyright (c) 2020 NetEase Inc.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Project: curve
+ * Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef NBD_SRC_CURVEIMAGEINSTANCE_H_
+#define NBD_SRC_CURVEIMAGEINSTANCE_H_
+
+#include <string>
+#include <memory>
+
+#include "include/client/libcurve.h"
+#include "nbd/src/ImageInstance.h"
+
+namespace curve {
+namespace nbd {
+
+using ::curve::client::CurveClient;
+
+// 直接通过libcurve访问卷，不经过nebd-server
+class CurveImageInstance : public ImageInstance {
+ public:
+    CurveImageInstance(const std::string& imageName,
+                       const std::string& confPath,
+                       std::shared_ptr<CurveClient> client =
+                           std::make_shared<CurveClient>())
+        : ImageInstance(imageName),
+          curveFd_(-1),
+          confPath_(confPath),
+          client_(client) {}
+
+    ~CurveImageInstance();
+
+    bool Open() override;
+    void Close() override;
+    void AioRead(NebdClientAioContext* context) override;
+    void AioWrite(NebdClientAioContext* context) override;
+    void Trim(NebdClientAioContext* context) override;
+    void Flush(NebdClientAioContext* context) override;
+    int64_t GetImageSize() override;
+
+    /**
+     * @brief 从卷名中解析出libcurve使用的文件名
+     *        cbd:pool1//cinder/volume-xxx_cinder_ => /cinder/volume-xxx_cinder_
+     * @param imageName 卷名
+     * @return 解析成功返回文件名，失败返回空字符串
+     */
+    static std::string ParseFileName(const std::string& imageName);
+
+ private:
+    // 提交异步请求，失败时直接以错误返回
+    void SubmitAio(NebdClientAioContext* context, LIBCURVE_OP op);
+
+    // libcurve返回的文件描述符
+    int curveFd_;
+
+    // libcurve使用的文件名
+    std::string fileName_;
+
+    // libcurve配置文件路径
+    std::string confPath_;
+
+    std::shared_ptr<CurveClient> client_;
+};
+
+}  // namespace nbd
+}  // namespace curve
+
+#endif  // NBD_SRC_CURVEIMAGEINSTANCE_H_
@@ -84,7 +84,7 @@ class ImageInstance {
      */
     virtual int64_t GetImageSize();
 
- private:
+ protected:
     // nebd返回的文件描述符
     int fd_;
 
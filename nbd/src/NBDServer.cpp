@@ -40,9 +40,11 @@
 #include "nbd/src/NBDServer.h"
 
 #include <signal.h>
+#include <bvar/bvar.h>
 #include <glog/logging.h>
 #include <inttypes.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 
 #include "nbd/src/util.h"
 
@@ -51,6 +53,51 @@ namespace nbd {
 
 #define REQUEST_TYPE_MASK 0x0000ffff
 
+// 进程内所有NBDServer共享的统计信息，用于观察每个请求的内存申请及回包写次数
+struct NBDServerMetric {
+    const std::string prefix = "curve_nbd";
+
+    // 已下发的请求数
+    bvar::Adder<uint64_t> ioCount;
+    // 数据缓冲区的申请次数
+    bvar::Adder<uint64_t> bufferAllocCount;
+    // 回包的写调用次数
+    bvar::Adder<uint64_t> replyWriteCount;
+    bvar::PassiveStatus<double> bufferAllocPerIO;
+    bvar::PassiveStatus<double> replyWritePerIO;
+
+    static double GetBufferAllocPerIO(void* arg) {
+        auto metric = reinterpret_cast<NBDServerMetric*>(arg);
+        return Ratio(metric->bufferAllocCount.get_value(),
+                     metric->ioCount.get_value());
+    }
+
+    static double GetReplyWritePerIO(void* arg) {
+        auto metric = reinterpret_cast<NBDServerMetric*>(arg);
+        return Ratio(metric->replyWriteCount.get_value(),
+                     metric->ioCount.get_value());
+    }
+
+    static double Ratio(uint64_t count, uint64_t total) {
+        return total == 0 ? 0 : static_cast<double>(count) / total;
+    }
+
+    static NBDServerMetric* GetInstance() {
+        static NBDServerMetric metric;
+        return &metric;
+    }
+
+ private:
+    NBDServerMetric()
+        : ioCount(prefix, "io_count"),
+          bufferAllocCount(prefix, "buffer_alloc_count"),
+          replyWriteCount(prefix, "reply_write_count"),
+          bufferAllocPerIO(prefix, "buffer_alloc_per_io",
+                           GetBufferAllocPerIO, this),
+          replyWritePerIO(prefix, "reply_write_per_io",
+                          GetReplyWritePerIO, this) {}
+};
+
 static std::ostream& operator<<(std::ostream& os, const IOContext& ctx) {
     os << "[" << std::hex
        << ntohll(*reinterpret_cast<uint64_t*>(
@@ -80,6 +127,64 @@ static std::ostream& operator<<(std::ostream& os, const IOContext& ctx) {
     return os;
 }
 
+IOContextPool::~IOContextPool() {
+    for (auto ctx : contexts_) {
+        delete ctx;
+    }
+    contexts_.clear();
+}
+
+IOContext* IOContextPool::Get() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!contexts_.empty()) {
+            IOContext* ctx = contexts_.back();
+            contexts_.pop_back();
+            return ctx;
+        }
+    }
+
+    return new IOContext();
+}
+
+void IOContextPool::ReserveData(IOContext* ctx, size_t len) {
+    if (ctx->capacity >= len) {
+        return;
+    }
+
+    ctx->data.reset(new char[len]);
+    ctx->capacity = len;
+    NBDServerMetric::GetInstance()->bufferAllocCount << 1;
+}
+
+void IOContextPool::Put(IOContext* ctx) {
+    if (ctx->capacity > maxCachedBufferSize_) {
+        ctx->data.reset();
+        ctx->capacity = 0;
+    }
+
+    memset(&ctx->request, 0, sizeof(ctx->request));
+    memset(&ctx->reply, 0, sizeof(ctx->reply));
+    memset(&ctx->nebdAioCtx, 0, sizeof(ctx->nebdAioCtx));
+    ctx->command = 0;
+    ctx->server = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (contexts_.size() < maxCachedCount_) {
+            contexts_.push_back(ctx);
+            return;
+        }
+    }
+
+    delete ctx;
+}
+
+size_t IOContextPool::CachedCount() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return contexts_.size();
+}
+
 void NBDServer::NBDAioCallback(struct NebdClientAioContext* aioCtx) {
     IOContext* ctx = reinterpret_cast<IOContext*>(
         reinterpret_cast<char*>(aioCtx) - offsetof(IOContext, nebdAioCtx));
@@ -106,7 +211,13 @@ NBDServer::~NBDServer() {
 
         started_ = false;
 
-        LOG(INFO) << "NBDServer quit";
+        NBDServerMetric* metric = NBDServerMetric::GetInstance();
+        LOG(INFO) << "NBDServer quit, io count: "
+                  << metric->ioCount.get_value()
+                  << ", buffer alloc per io: "
+                  << metric->bufferAllocPerIO.get_value()
+                  << ", reply write per io: "
+                  << metric->replyWritePerIO.get_value();
     }
 }
 
@@ -129,7 +240,7 @@ void NBDServer::WaitForDisconnect() {
     }
 
     std::unique_lock<std::mutex> lk(disconnectMutex_);
-    disconnectCond_.wait(lk);
+    disconnectCond_.wait(lk, [this]() { return disconnected_; });
 }
 
 void NBDServer::Shutdown() {
@@ -149,7 +260,7 @@ void NBDServer::ReaderFunc() {
     bool disconnect = false;
 
     while (!terminated_) {
-        std::unique_ptr<IOContext> ctx(new IOContext());
+        IOContextGuard ctx(pool_.Get(), IOContextRecycler(&pool_));
         ctx->server = this;
 
         r = safeIO_->ReadExact(sock_, &ctx->request, sizeof(ctx->request));
@@ -181,7 +292,7 @@ void NBDServer::ReaderFunc() {
                 disconnect = true;
                 break;
             case NBD_CMD_WRITE:
-                ctx->data.reset(new char[ctx->request.len]);
+                pool_.ReserveData(ctx.get(), ctx->request.len);
 
                 // 写请求，继续读取写入数据
                 r = safeIO_->ReadExact(sock_, ctx->data.get(),
@@ -193,7 +304,7 @@ void NBDServer::ReaderFunc() {
                 }
                 break;
             case NBD_CMD_READ:
-                ctx->data.reset(new char[ctx->request.len]);
+                pool_.ReserveData(ctx.get(), ctx->request.len);
                 break;
         }
 
@@ -202,6 +313,7 @@ void NBDServer::ReaderFunc() {
         }
 
         OnRequestStart();
+        NBDServerMetric::GetInstance()->ioCount << 1;
 
         IOContext* pctx = ctx.get();
         bool ret = StartAioRequest(ctx.release());
@@ -213,8 +325,11 @@ void NBDServer::ReaderFunc() {
         }
     }
 
-    std::lock_guard<std::mutex> lk(disconnectMutex_);
-    disconnectCond_.notify_all();
+    {
+        std::lock_guard<std::mutex> lk(disconnectMutex_);
+        disconnected_ = true;
+        disconnectCond_.notify_all();
+    }
 
     LOG(INFO) << "ReaderFunc terminated!";
 
@@ -227,28 +342,31 @@ void NBDServer::WriterFunc() {
     ssize_t r = 0;
 
     while (!terminated_) {
-        std::unique_ptr<IOContext> ctx(WaitRequestFinish());
+        IOContextGuard ctx(WaitRequestFinish(), IOContextRecycler(&pool_));
 
         if (ctx == nullptr) {
             LOG(INFO) << "No more requests, terminating";
             break;
         }
 
-        r = safeIO_->Write(sock_, &ctx->reply, sizeof(struct nbd_reply));
+        // 回包头部和读请求的数据通过一次writev写出
+        struct iovec iov[2];
+        int iovcnt = 1;
+        iov[0].iov_base = &ctx->reply;
+        iov[0].iov_len = sizeof(struct nbd_reply);
+        if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
+            iov[1].iov_base = ctx->data.get();
+            iov[1].iov_len = ctx->request.len;
+            iovcnt = 2;
+        }
+
+        r = safeIO_->WriteV(sock_, iov, iovcnt);
+        NBDServerMetric::GetInstance()->replyWriteCount << 1;
         if (r < 0) {
-            LOG(ERROR) << *ctx << ": failed to write reply header : "
+            LOG(ERROR) << *ctx << ": failed to write reply : "
                        << cpp_strerror(r);
             return;
         }
-
-        if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
-            r = safeIO_->Write(sock_, ctx->data.get(), ctx->request.len);
-            if (r < 0) {
-                LOG(ERROR) << *ctx << ": faield to write reply date : "
-                           << cpp_strerror(r);
-                return;
-            }
-        }
     }
 
     LOG(INFO) << "WriterFunc terminated!";
@@ -291,7 +409,7 @@ void NBDServer::WaitClean() {
     requestCond_.wait(lk, [this]() { return pendingRequestCounts_ == 0; });
 
     while (!finishedRequests_.empty()) {
-        std::unique_ptr<IOContext> ctx(finishedRequests_.front());
+        pool_.Put(finishedRequests_.front());
         finishedRequests_.pop_front();
     }
 }
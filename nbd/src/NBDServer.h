@@ -48,6 +48,7 @@
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "nbd/src/ImageInstance.h"
 #include "nbd/src/NBDController.h"
@@ -69,6 +70,8 @@ struct IOContext {
 
     NBDServer* server = nullptr;
     std::unique_ptr<char[]> data;
+    // data缓冲区的大小，上下文复用时据此判断是否需要重新申请
+    size_t capacity = 0;
 
     // NEBD请求上下文信息
     NebdClientAioContext nebdAioCtx;
@@ -78,6 +81,67 @@ struct IOContext {
     }
 };
 
+// IOContext对象池，请求完成后上下文连同数据缓冲区一起回收，
+// 稳定负载下读写请求不再申请内存
+class IOContextPool {
+ public:
+    /**
+     * @param maxCachedCount 最多缓存的上下文个数
+     * @param maxCachedBufferSize 缓冲区超过该大小时回收前释放，避免大请求长期占用内存
+     */
+    explicit IOContextPool(size_t maxCachedCount = kDefaultMaxCachedCount,
+                           size_t maxCachedBufferSize =
+                               kDefaultMaxCachedBufferSize)
+        : maxCachedCount_(maxCachedCount),
+          maxCachedBufferSize_(maxCachedBufferSize) {}
+
+    ~IOContextPool();
+
+    /**
+     * @brief 获取一个上下文，池为空时新建
+     */
+    IOContext* Get();
+
+    /**
+     * @brief 保证上下文的数据缓冲区不小于len，容量足够时直接复用
+     */
+    void ReserveData(IOContext* ctx, size_t len);
+
+    /**
+     * @brief 归还上下文，超过缓存个数时直接释放
+     */
+    void Put(IOContext* ctx);
+
+    /**
+     * 测试使用，返回当前缓存的上下文个数
+     */
+    size_t CachedCount();
+
+    static const size_t kDefaultMaxCachedCount = 64;
+    static const size_t kDefaultMaxCachedBufferSize = 1024 * 1024;
+
+ private:
+    const size_t maxCachedCount_;
+    const size_t maxCachedBufferSize_;
+
+    // 读线程获取，写线程归还
+    std::mutex mtx_;
+    std::vector<IOContext*> contexts_;
+};
+
+// unique_ptr的删除器，将上下文归还给对象池
+struct IOContextRecycler {
+    IOContextPool* pool = nullptr;
+
+    IOContextRecycler() = default;
+    explicit IOContextRecycler(IOContextPool* p) : pool(p) {}
+
+    void operator()(IOContext* ctx) const {
+        pool->Put(ctx);
+    }
+};
+using IOContextGuard = std::unique_ptr<IOContext, IOContextRecycler>;
+
 // NBDServer负责与nbd内核进行数据通信
 class NBDServer {
  public:
@@ -90,7 +154,8 @@ class NBDServer {
           nbdCtrl_(nbdCtrl),
           image_(imageInstance),
           pendingRequestCounts_(0),
-          safeIO_(safeIO) {}
+          safeIO_(safeIO),
+          disconnected_(false) {}
 
     ~NBDServer();
 
@@ -177,6 +242,9 @@ class NBDServer {
     std::shared_ptr<ImageInstance> image_;
     std::shared_ptr<SafeIO> safeIO_;
 
+    // 请求上下文及数据缓冲区的对象池
+    IOContextPool pool_;
+
     // 保护pendingRequestCounts_和finishedRequests_
     std::mutex requestMtx_;
     std::condition_variable requestCond_;
@@ -195,6 +263,8 @@ class NBDServer {
     // 等待断开连接锁/条件变量
     std::mutex disconnectMutex_;
     std::condition_variable disconnectCond_;
+    // 读线程是否已退出，多连接时可能在开始等待前就已断开
+    bool disconnected_;
 };
 using NBDServerPtr = std::shared_ptr<NBDServer>;
 
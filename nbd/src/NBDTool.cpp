@@ -27,6 +27,7 @@
 #include <memory>
 #include <string>
 #include "nbd/src/NBDTool.h"
+#include "nbd/src/CurveImageInstance.h"
 #include "nbd/src/argparse.h"
 #include "nbd/src/texttable.h"
 
@@ -44,7 +45,11 @@ std::ostream& operator<<(std::ostream& os, const DeviceInfo& info) {
     return os;
 }
 
+NBDControllerPtr g_test_controller = nullptr;
 NBDControllerPtr NBDTool::GetController(bool tryNetlink) {
+    if (g_test_controller != nullptr) {
+        return g_test_controller;
+    }
     if (tryNetlink) {
         auto ctrl = std::make_shared<NetLinkController>();
         bool supportNetLink = ctrl->Support();
@@ -58,16 +63,8 @@ NBDControllerPtr NBDTool::GetController(bool tryNetlink) {
 int NBDTool::Connect(NBDConfig *cfg) {
     // loadmodule 到时候放到外面做
 
-    // init socket pair
-    int ret = socketPair_.Init();
-    if (ret < 0) {
-        dout << "init socker pair failed, imgname = " << cfg->imgname
-             << std::endl;
-        return ret;
-    }
-
     // 初始化打开文件
-    ImagePtr imageInstance = GenerateImage(cfg->imgname);
+    ImagePtr imageInstance = GenerateImage(cfg);
     bool openSuccess = imageInstance->Open();
     if (!openSuccess) {
         dout << "curve-nbd: Could not open image, imgname = " << cfg->imgname
@@ -88,15 +85,37 @@ int NBDTool::Connect(NBDConfig *cfg) {
     }
 
     // load nbd module
-    ret = load_module(cfg);
+    int ret = load_module(cfg);
     if (ret < 0) {
         dout << "load module failed, imgname = " << cfg->imgname << std::endl;
         return ret;
     }
 
-    NBDControllerPtr nbdCtrl = GetController(cfg->try_netlink);
-    nbdServer_ = std::make_shared<NBDServer>(socketPair_.Second(), nbdCtrl,
-                                             imageInstance);
+    // 多连接只能通过netlink接口建立
+    NBDControllerPtr nbdCtrl =
+        GetController(cfg->try_netlink || cfg->connections > 1);
+    int connections = cfg->connections;
+    if (connections > 1 && !nbdCtrl->IsNetLink()) {
+        dout << "curve-nbd: multiple connections require netlink interface,"
+             << " fall back to one connection" << std::endl;
+        connections = 1;
+    }
+
+    // init socket pairs, 每个连接由独立的NBDServer读写
+    std::vector<int> sockfds;
+    for (int i = 0; i < connections; ++i) {
+        std::unique_ptr<NBDSocketPair> socketPair(new NBDSocketPair());
+        ret = socketPair->Init();
+        if (ret < 0) {
+            dout << "init socker pair failed, imgname = " << cfg->imgname
+                 << std::endl;
+            return ret;
+        }
+        sockfds.push_back(socketPair->First());
+        nbdServers_.push_back(std::make_shared<NBDServer>(
+            socketPair->Second(), nbdCtrl, imageInstance));
+        socketPairs_.push_back(std::move(socketPair));
+    }
 
     // setup controller
     uint64_t flags = NBD_FLAG_SEND_FLUSH | NBD_FLAG_SEND_TRIM |
@@ -104,7 +123,11 @@ int NBDTool::Connect(NBDConfig *cfg) {
     if (cfg->readonly) {
         flags |= NBD_FLAG_READ_ONLY;
     }
-    ret = nbdCtrl->SetUp(cfg, socketPair_.First(), fileSize, flags);
+    // 可写设备有多个连接时，内核要求带上该flag，否则拒绝启动设备
+    if (connections > 1) {
+        flags |= NBD_FLAG_CAN_MULTI_CONN;
+    }
+    ret = nbdCtrl->SetUp(cfg, sockfds, fileSize, flags);
     if (ret < 0) {
         dout << "nbd controller setup failed, imgname = " << cfg->imgname
              << std::endl;
@@ -151,14 +174,19 @@ int NBDTool::List(std::vector<DeviceInfo>* infos) {
 
 void NBDTool::RunServerUntilQuit() {
     // start nbd server
-    nbdServer_->Start();
+    for (auto& server : nbdServers_) {
+        server->Start();
+    }
 
     // start watch context
     nbdWatchCtx_->WatchImageSize();
 
-    NBDControllerPtr ctrl = nbdServer_->GetController();
+    NBDControllerPtr ctrl = nbdServers_[0]->GetController();
     if (ctrl->IsNetLink()) {
-        nbdServer_->WaitForDisconnect();
+        // 断开时内核会在每个连接上发送DISC请求
+        for (auto& server : nbdServers_) {
+            server->WaitForDisconnect();
+        }
     } else {
         ctrl->RunUntilQuit();
     }
@@ -167,12 +195,15 @@ void NBDTool::RunServerUntilQuit() {
 }
 
 ImagePtr g_test_image = nullptr;
-ImagePtr NBDTool::GenerateImage(const std::string& imageName) {
+ImagePtr NBDTool::GenerateImage(const NBDConfig* cfg) {
     ImagePtr result = nullptr;
-    if (imageName.compare(0, 4, "test") == 0) {
+    if (cfg->imgname.compare(0, 4, "test") == 0) {
         result = g_test_image;
+    } else if (cfg->curve_native) {
+        result = std::make_shared<CurveImageInstance>(cfg->imgname,
+                                                      cfg->curve_conf);
     } else {
-        result = std::make_shared<ImageInstance>(imageName);
+        result = std::make_shared<ImageInstance>(cfg->imgname);
     }
     return result;
 }
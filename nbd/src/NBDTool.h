@@ -38,6 +38,7 @@ namespace curve {
 namespace nbd {
 
 extern ImagePtr g_test_image;
+extern NBDControllerPtr g_test_controller;
 struct DeviceInfo {
     int pid;
     NBDConfig config;
@@ -66,7 +67,7 @@ class NBDTool {
     NBDServerPtr StartServer(int sockfd, NBDControllerPtr nbdCtrl,
                              ImagePtr imageInstance);
     // 生成image instance
-    ImagePtr GenerateImage(const std::string& imageName);
+    ImagePtr GenerateImage(const NBDConfig* cfg);
 
     // wait curve-nbd process to exit
     int WaitForTerminate(pid_t pid, const NBDConfig* config);
@@ -112,8 +113,9 @@ class NBDTool {
         int fd_[2];
     };
 
-    NBDSocketPair socketPair_;
-    NBDServerPtr nbdServer_;
+    // 每个连接对应一个socketpair和一个NBDServer
+    std::vector<std::unique_ptr<NBDSocketPair>> socketPairs_;
+    std::vector<NBDServerPtr> nbdServers_;
     std::shared_ptr<NBDWatchContext> nbdWatchCtx_;
 };
 
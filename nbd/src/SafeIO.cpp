@@ -42,5 +42,9 @@ ssize_t SafeIO::Write(int fd, const void* buf, size_t count) {
     return safe_write(fd, buf, count);
 }
 
+ssize_t SafeIO::WriteV(int fd, struct iovec* iov, int iovcnt) {
+    return safe_writev(fd, iov, iovcnt);
+}
+
 }  // namespace nbd
 }  // namespace curve
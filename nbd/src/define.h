@@ -56,6 +56,7 @@ namespace nbd {
 #define HELP_INFO 1
 #define VERSION_INFO 2
 #define CURVE_NBD_BLKSIZE 4096UL    // CURVE后端当前支持4096大小对齐的IO
+#define CURVE_NBD_MAX_CONNECTIONS 64
 
 #define NBD_MAX_PATH "/sys/module/nbd/parameters/nbds_max"
 #define PROCESS_NAME "curve-nbd"
@@ -77,6 +78,12 @@ struct NBDConfig {
     bool set_max_part = false;
     // 是否以netlink方式控制nbd内核模块
     bool try_netlink = false;
+    // 与nbd内核通信的连接数，每个连接有独立的读写线程，大于1时需要netlink接口
+    int connections = 1;
+    // 是否直接通过libcurve访问卷，不经过nebd-server
+    bool curve_native = false;
+    // 直接访问卷时使用的libcurve配置文件
+    std::string curve_conf = "/etc/curve/client.conf";
     // 需要映射的后端文件名称
     std::string imgname;
     // 指定需要映射的nbd设备路径
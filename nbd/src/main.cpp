@@ -87,6 +87,12 @@ static void Usage() {
         << "  --max_part <limit>      Override for module param max_part\n"
         << "  --timeout <seconds>     Set nbd request timeout\n"
         << "  --try-netlink           Use the nbd netlink interface\n"
+        << "  --connections <num>     Number of sockets to the nbd device, each served\n"  // NOLINT
+        << "                          by its own threads (netlink only, default: 1)\n"     // NOLINT
+        << "  --curve-native          Access the image through libcurve directly\n"       // NOLINT
+        << "                          instead of nebd-server\n"
+        << "  --curve-conf <path>     libcurve config file used with --curve-native\n"    // NOLINT
+        << "                          (default: " << nbdConfig->curve_conf << ")\n"       // NOLINT
         << "Unmap options:\n"
         << "  --retry_times <limit>       The number of retries waiting for the process to exit\n"  // NOLINT
         << "                              (default: " << nbdConfig->retry_times << ")\n"            // NOLINT
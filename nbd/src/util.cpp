@@ -153,6 +153,22 @@ int parse_args(std::vector<const char*>& args, std::ostream *err_msg,   // NOLIN
             }
         } else if (argparse_flag(args, i, "--try-netlink", (char *)NULL)) { // NOLINT
             cfg->try_netlink = true;
+        } else if (argparse_witharg(args, i, &cfg->connections, err,
+                                    "--connections", (char *)NULL)) {   // NOLINT
+            if (!err.str().empty()) {
+                *err_msg << "curve-nbd: " << err.str();
+                return -EINVAL;
+            }
+            if (cfg->connections < 1 ||
+                cfg->connections > CURVE_NBD_MAX_CONNECTIONS) {
+                *err_msg << "curve-nbd: Invalid argument for connections(1~"
+                         << CURVE_NBD_MAX_CONNECTIONS << ")!";
+                return -EINVAL;
+            }
+        } else if (argparse_flag(args, i, "--curve-native", (char *)NULL)) {    // NOLINT
+            cfg->curve_native = true;
+        } else if (argparse_witharg(args, i, &cfg->curve_conf, err,
+                                    "--curve-conf", (char *)NULL)) {    // NOLINT
         } else if (argparse_witharg(args, i, &cfg->retry_times, err, "--retry_times", (char*)(NULL))) {  // NOLINT
             if (!err.str().empty()) {
                 *err_msg << "curve-nbd: " << err.str();
@@ -466,5 +482,28 @@ ssize_t safe_write(int fd, const void* buf, size_t count) {
     return 0;
 }
 
+ssize_t safe_writev(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t r = writev(fd, iov, iovcnt);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        // 跳过已经写完的部分
+        while (iovcnt > 0 && static_cast<size_t>(r) >= iov->iov_len) {
+            r -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = reinterpret_cast<char*>(iov->iov_base) + r;
+            iov->iov_len -= r;
+        }
+    }
+    return 0;
+}
+
 }  // namespace nbd
 }  // namespace curve
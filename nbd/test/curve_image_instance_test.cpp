@@ -0,0 +1,167 @@
+/*
+ *     Copyright (c) 2020 NetEase Inc.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Project: curve
+ * Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <errno.h>
+#include <memory>
+#include "nbd/src/CurveImageInstance.h"
+#include "nbd/test/mock_curve_client.h"
+
+namespace curve {
+namespace nbd {
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Eq;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+const char* kCurveImage = "cbd:pool//test_curve_image_user_";
+const char* kCurveFileName = "/test_curve_image_user_";
+const char* kCurveConf = "/etc/curve/client.conf";
+
+class CurveImageInstanceTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        client_ = std::make_shared<MockCurveClient>();
+        image_ = std::make_shared<CurveImageInstance>(kCurveImage,
+                                                      kCurveConf, client_);
+        memset(&aioCtx_, 0, sizeof(aioCtx_));
+        aioCtx_.cb = AioCallback;
+        callbackRet_ = 1;
+    }
+
+    void OpenImage() {
+        EXPECT_CALL(*client_, Init(Eq(kCurveConf)))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*client_, Open(Eq(kCurveFileName), _))
+            .WillOnce(Return(3));
+        ASSERT_TRUE(image_->Open());
+    }
+
+    static void AioCallback(NebdClientAioContext* ctx) {
+        callbackRet_ = ctx->ret;
+    }
+
+ protected:
+    static int callbackRet_;
+    std::shared_ptr<MockCurveClient> client_;
+    std::shared_ptr<CurveImageInstance> image_;
+    NebdClientAioContext aioCtx_;
+};
+
+int CurveImageInstanceTest::callbackRet_ = 1;
+
+TEST_F(CurveImageInstanceTest, ParseFileNameTest) {
+    ASSERT_EQ("/cinder/volume-1_cinder_", CurveImageInstance::ParseFileName(
+        "cbd:pool1//cinder/volume-1_cinder_"));
+    ASSERT_EQ("/cinder/volume-1_cinder_", CurveImageInstance::ParseFileName(
+        "cbd:pool1//cinder/volume-1_cinder_:/etc/curve/client.conf"));
+    ASSERT_EQ("", CurveImageInstance::ParseFileName("cbd:pool1"));
+    ASSERT_EQ("", CurveImageInstance::ParseFileName("cbd:pool1//"));
+}
+
+TEST_F(CurveImageInstanceTest, OpenCloseTest) {
+    // init失败
+    EXPECT_CALL(*client_, Init(_))
+        .WillOnce(Return(-1));
+    ASSERT_FALSE(image_->Open());
+
+    // open失败
+    EXPECT_CALL(*client_, Init(_))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*client_, Open(_, _))
+        .WillOnce(Return(-1));
+    EXPECT_CALL(*client_, UnInit())
+        .Times(1);
+    ASSERT_FALSE(image_->Open());
+
+    OpenImage();
+    EXPECT_CALL(*client_, StatFile(Eq(kCurveFileName)))
+        .WillOnce(Return(10 * 1024 * 1024));
+    ASSERT_EQ(10 * 1024 * 1024, image_->GetImageSize());
+
+    EXPECT_CALL(*client_, Close(3))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*client_, UnInit())
+        .Times(1);
+    image_->Close();
+}
+
+TEST_F(CurveImageInstanceTest, AioTest) {
+    OpenImage();
+    char buf[4096];
+    aioCtx_.offset = 4096;
+    aioCtx_.length = sizeof(buf);
+    aioCtx_.buf = buf;
+
+    // 读请求直接使用nbd的buffer
+    CurveAioContext* curveCtx = nullptr;
+    EXPECT_CALL(*client_, AioRead(3, _, curve::client::UserDataType::RawBuffer))
+        .WillOnce(DoAll(SaveArg<1>(&curveCtx), Return(LIBCURVE_ERROR::OK)));
+    image_->AioRead(&aioCtx_);
+    ASSERT_NE(nullptr, curveCtx);
+    ASSERT_EQ(buf, curveCtx->buf);
+    ASSERT_EQ(4096, curveCtx->offset);
+    ASSERT_EQ(sizeof(buf), curveCtx->length);
+    ASSERT_EQ(LIBCURVE_OP::LIBCURVE_OP_READ, curveCtx->op);
+    curveCtx->ret = sizeof(buf);
+    curveCtx->cb(curveCtx);
+    ASSERT_EQ(0, callbackRet_);
+
+    // 写请求返回失败
+    EXPECT_CALL(*client_,
+                AioWrite(3, _, curve::client::UserDataType::RawBuffer))
+        .WillOnce(DoAll(SaveArg<1>(&curveCtx), Return(LIBCURVE_ERROR::OK)));
+    image_->AioWrite(&aioCtx_);
+    ASSERT_EQ(LIBCURVE_OP::LIBCURVE_OP_WRITE, curveCtx->op);
+    curveCtx->ret = -LIBCURVE_ERROR::FAILED;
+    curveCtx->cb(curveCtx);
+    ASSERT_EQ(-EIO, callbackRet_);
+
+    // 下发失败
+    callbackRet_ = 1;
+    EXPECT_CALL(*client_, AioWrite(_, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::FAILED));
+    image_->AioWrite(&aioCtx_);
+    ASSERT_EQ(-EIO, callbackRet_);
+
+    // trim和flush直接返回成功
+    callbackRet_ = 1;
+    image_->Trim(&aioCtx_);
+    ASSERT_EQ(0, callbackRet_);
+    callbackRet_ = 1;
+    image_->Flush(&aioCtx_);
+    ASSERT_EQ(0, callbackRet_);
+
+    EXPECT_CALL(*client_, Close(3))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*client_, UnInit())
+        .Times(1);
+}
+
+}  // namespace nbd
+}  // namespace curve
@@ -32,6 +32,7 @@ namespace curve {
 namespace nbd {
 
 using FuncType = std::function<ssize_t(int, void*, size_t)>;
+using WriteVFuncType = std::function<ssize_t(int, struct iovec*, int)>;
 
 class FakeSafeIO : public SafeIO {
  public:
@@ -47,6 +48,10 @@ class FakeSafeIO : public SafeIO {
         return writeTask_ ? writeTask_(fd, const_cast<void*>(buf), count) : -1;
     }
 
+    ssize_t WriteV(int fd, struct iovec* iov, int iovcnt) override {
+        return writevTask_ ? writevTask_(fd, iov, iovcnt) : -1;
+    }
+
     void SetReadExactTask(FuncType task) {
         readExactTask_ = task;
     }
@@ -59,10 +64,15 @@ class FakeSafeIO : public SafeIO {
         writeTask_ = task;
     }
 
+    void SetWriteVTask(WriteVFuncType task) {
+        writevTask_ = task;
+    }
+
  private:
     FuncType readExactTask_;
     FuncType readTask_;
     FuncType writeTask_;
+    WriteVFuncType writevTask_;
 };
 
 }  // namespace nbd
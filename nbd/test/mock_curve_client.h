@@ -0,0 +1,53 @@
+/*
+ *     Copyright (c) 2020 NetEase Inc.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Project: curve
+ * Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef NBD_TEST_MOCK_CURVE_CLIENT_H_
+#define NBD_TEST_MOCK_CURVE_CLIENT_H_
+
+#include <gmock/gmock.h>
+#include <string>
+#include "include/client/libcurve.h"
+
+namespace curve {
+namespace nbd {
+
+class MockCurveClient : public ::curve::client::CurveClient {
+ public:
+    MockCurveClient() {}
+    ~MockCurveClient() {}
+    MOCK_METHOD1(Init, int(const std::string&));
+    MOCK_METHOD0(UnInit, void());
+    MOCK_METHOD2(Open, int(const std::string&, std::string*));
+    MOCK_METHOD1(Close, int(int));
+    MOCK_METHOD1(StatFile, int64_t(const std::string&));
+    MOCK_METHOD3(AioRead,
+                 int(int, CurveAioContext*, curve::client::UserDataType));
+    MOCK_METHOD3(AioWrite,
+                 int(int, CurveAioContext*, curve::client::UserDataType));
+};
+
+}  // namespace nbd
+}  // namespace curve
+
+#endif  // NBD_TEST_MOCK_CURVE_CLIENT_H_
@@ -27,6 +27,7 @@
 
 #include <gmock/gmock.h>
 #include <string>
+#include <vector>
 #include "nbd/src/NBDController.h"
 
 namespace curve {
@@ -38,8 +39,10 @@ class MockNBDController : public NBDController {
     ~MockNBDController() = default;
 
     MOCK_METHOD1(Resize, int(uint64_t));
-    MOCK_METHOD4(SetUp, int(NBDConfig*, int, uint64_t, uint64_t));
+    MOCK_METHOD4(SetUp, int(NBDConfig*, const std::vector<int>&,
+                            uint64_t, uint64_t));
     MOCK_METHOD1(DisconnectByPath, int(const std::string&));
+    MOCK_METHOD0(IsNetLink, bool());
 };
 
 }  // namespace nbd
@@ -29,6 +29,7 @@
 #include <netinet/in.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <atomic>
 #include <memory>
 #include "nbd/src/NBDServer.h"
 #include "nbd/test/fake_safe_io.h"
@@ -262,6 +263,8 @@ TEST_F(NBDServerTest, DisconnectTest) {
     std::this_thread::sleep_for(std::chrono::milliseconds(kSleepTime));
 
     ASSERT_TRUE(server_->IsTerminated());
+    // 已经断开后再等待不会阻塞
+    server_->WaitForDisconnect();
 }
 
 TEST_F(NBDServerTest, ReadWriteDataErrorTest) {
@@ -296,5 +299,91 @@ TEST_F(NBDServerTest, ReadWriteDataErrorTest) {
     ASSERT_TRUE(server_->IsTerminated());
 }
 
+TEST_F(NBDServerTest, ReadReplyWriteVTest) {
+    auto fakeSafeIO = std::make_shared<FakeSafeIO>();
+    server_.reset(new NBDServer(fd_[1], nullptr, image_, fakeSafeIO));
+
+    request_.from = 0;
+    request_.len = htonl(8);
+    request_.type = htonl(NBD_CMD_READ);
+    request_.magic = htonl(NBD_REQUEST_MAGIC);
+    memcpy(&request_.handle, &handle_, sizeof(request_.handle));
+
+    fakeSafeIO->SetReadExactTask([this](int fd, void* buf, size_t count) {
+        static int callTime = 1;
+        if (callTime++ == 1) {
+            *reinterpret_cast<struct nbd_request*>(buf) = request_;
+            return 0;
+        }
+        // 等待回包写出后再断开
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(3 * kSleepTime));
+        return -1;
+    });
+
+    // 回包头部和数据通过一次writev写出
+    std::atomic<int> writevTimes(0);
+    int iovcnt = 0;
+    size_t dataLen = 0;
+    fakeSafeIO->SetWriteVTask([&](int fd, struct iovec* iov, int cnt) {
+        iovcnt = cnt;
+        dataLen = iov[cnt - 1].iov_len;
+        writevTimes.fetch_add(1);
+        return 0;
+    });
+
+    NebdClientAioContext* nebdContext;
+    EXPECT_CALL(*image_, AioRead(_))
+        .Times(1)
+        .WillOnce(SaveArg<0>(&nebdContext));
+
+    ASSERT_NO_THROW(server_->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSleepTime));
+
+    nebdContext->ret = 0;
+    nebdContext->cb(nebdContext);
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSleepTime));
+
+    ASSERT_EQ(1, writevTimes.load());
+    ASSERT_EQ(2, iovcnt);
+    ASSERT_EQ(8, dataLen);
+}
+
+TEST(IOContextPoolTest, ReuseTest) {
+    IOContextPool pool(2, 16);
+
+    // 缓冲区随上下文一起复用
+    IOContext* ctx = pool.Get();
+    pool.ReserveData(ctx, 8);
+    char* data = ctx->data.get();
+    ctx->command = NBD_CMD_READ;
+    pool.Put(ctx);
+    ASSERT_EQ(1, pool.CachedCount());
+
+    IOContext* reused = pool.Get();
+    ASSERT_EQ(ctx, reused);
+    ASSERT_EQ(0, reused->command);
+    ASSERT_EQ(0, pool.CachedCount());
+    pool.ReserveData(reused, 4);
+    ASSERT_EQ(data, reused->data.get());
+    ASSERT_EQ(8, reused->capacity);
+
+    // 超过上限的缓冲区在归还时释放
+    pool.ReserveData(reused, 32);
+    ASSERT_EQ(32, reused->capacity);
+    pool.Put(reused);
+    reused = pool.Get();
+    ASSERT_EQ(0, reused->capacity);
+    ASSERT_EQ(nullptr, reused->data.get());
+
+    // 超过缓存个数的上下文直接释放
+    {
+        IOContextGuard ctx1(pool.Get(), IOContextRecycler(&pool));
+        IOContextGuard ctx2(pool.Get(), IOContextRecycler(&pool));
+        IOContextGuard ctx3(reused, IOContextRecycler(&pool));
+    }
+    ASSERT_EQ(2, pool.CachedCount());
+}
+
 }  // namespace nbd
 }  // namespace curve
@@ -30,6 +30,7 @@
 #include <sys/socket.h>
 #include <memory>
 #include "nbd/test/mock_image_instance.h"
+#include "nbd/test/mock_nbd_controller.h"
 #include "nbd/src/NBDTool.h"
 #include "nbd/src/util.h"
 
@@ -58,7 +59,10 @@ class NBDToolTest : public ::testing::Test {
     }
 
     void TearDown() override {
-        nbdThread_.join();
+        if (nbdThread_.joinable()) {
+            nbdThread_.join();
+        }
+        g_test_controller = nullptr;
     }
 
     void StartInAnotherThread(NBDConfig* config) {
@@ -163,6 +167,80 @@ TEST_F(NBDToolTest, netlink_connect_test) {
     ASSERT_FALSE(isRunning_);
 }
 
+TEST_F(NBDToolTest, multi_connections_test) {
+    NBDConfig config;
+    config.imgname = kTestImage;
+    config.connections = 4;
+    StartInAnotherThread(&config);
+    ASSERT_TRUE(isRunning_);
+    AssertWriteSuccess(config.devpath);
+    ASSERT_EQ(0, tool_.Disconnect(&config));
+    sleep(1);
+    ASSERT_FALSE(isRunning_);
+}
+
+TEST_F(NBDToolTest, multi_connections_flags_test) {
+    auto nbdCtrl = std::make_shared<MockNBDController>();
+    g_test_controller = nbdCtrl;
+    EXPECT_CALL(*image_, Open())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*image_, GetImageSize())
+        .WillRepeatedly(Return(1 * kGB));
+
+    // netlink下多个连接，需要带上NBD_FLAG_CAN_MULTI_CONN
+    {
+        NBDConfig config;
+        config.imgname = kTestImage;
+        config.connections = 4;
+        std::vector<int> sockfds;
+        uint64_t flags = 0;
+        EXPECT_CALL(*nbdCtrl, IsNetLink())
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*nbdCtrl, SetUp(_, _, 1 * kGB, _))
+            .WillOnce(DoAll(SaveArg<1>(&sockfds), SaveArg<3>(&flags),
+                            Return(0)));
+        NBDTool tool;
+        ASSERT_EQ(0, tool.Connect(&config));
+        ASSERT_EQ(4, sockfds.size());
+        ASSERT_TRUE(flags & NBD_FLAG_CAN_MULTI_CONN);
+        ASSERT_TRUE(flags & NBD_FLAG_SEND_FLUSH);
+        ASSERT_FALSE(flags & NBD_FLAG_READ_ONLY);
+    }
+
+    // 单个连接不带该flag
+    {
+        NBDConfig config;
+        config.imgname = kTestImage;
+        std::vector<int> sockfds;
+        uint64_t flags = 0;
+        EXPECT_CALL(*nbdCtrl, SetUp(_, _, 1 * kGB, _))
+            .WillOnce(DoAll(SaveArg<1>(&sockfds), SaveArg<3>(&flags),
+                            Return(0)));
+        NBDTool tool;
+        ASSERT_EQ(0, tool.Connect(&config));
+        ASSERT_EQ(1, sockfds.size());
+        ASSERT_FALSE(flags & NBD_FLAG_CAN_MULTI_CONN);
+    }
+
+    // ioctl接口退化为单个连接，也不带该flag
+    {
+        NBDConfig config;
+        config.imgname = kTestImage;
+        config.connections = 4;
+        std::vector<int> sockfds;
+        uint64_t flags = 0;
+        EXPECT_CALL(*nbdCtrl, IsNetLink())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*nbdCtrl, SetUp(_, _, 1 * kGB, _))
+            .WillOnce(DoAll(SaveArg<1>(&sockfds), SaveArg<3>(&flags),
+                            Return(0)));
+        NBDTool tool;
+        ASSERT_EQ(0, tool.Connect(&config));
+        ASSERT_EQ(1, sockfds.size());
+        ASSERT_FALSE(flags & NBD_FLAG_CAN_MULTI_CONN);
+    }
+}
+
 TEST_F(NBDToolTest, readonly_test) {
     NBDConfig config;
     config.imgname = kTestImage;
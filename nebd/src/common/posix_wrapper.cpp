@@ -48,5 +48,9 @@ ssize_t PosixWrapper::pwrite(int fd,
     return ::pwrite(fd, buf, count, offset);
 }
 
+int PosixWrapper::fsync(int fd) {
+    return ::fsync(fd);
+}
+
 }   // namespace common
 }   // namespace nebd
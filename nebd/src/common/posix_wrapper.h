@@ -43,6 +43,7 @@ class PosixWrapper {
                            const void *buf,
                            size_t count,
                            off_t offset);
+    virtual int fsync(int fd);
 };
 }   // namespace common
 }   // namespace nebd
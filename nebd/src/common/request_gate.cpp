@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "nebd/src/common/request_gate.h"
+
+#include <glog/logging.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+#include <new>
+#include <thread>  // NOLINT
+
+namespace nebd {
+namespace common {
+
+// 计数个数的上限
+const uint32_t kMaxShardNum = 64;
+
+RequestGate::RequestGate() : closing_(false) {
+    uint32_t cpus = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t shardNum = 1;
+    while (shardNum < cpus && shardNum < kMaxShardNum) {
+        shardNum <<= 1;
+    }
+    shardMask_ = shardNum - 1;
+    void* mem = nullptr;
+    int ret = posix_memalign(&mem, alignof(Shard), sizeof(Shard) * shardNum);
+    CHECK(ret == 0) << "Allocate request gate shards failed, ret = " << ret;
+    shards_.reset(static_cast<Shard*>(mem));
+    for (uint32_t i = 0; i < shardNum; ++i) {
+        new (&shards_[i]) Shard();
+        shards_[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+RequestGate::Shard* RequestGate::LocalShard() {
+    int cpu = sched_getcpu();
+    return &shards_[cpu < 0 ? 0 : (cpu & shardMask_)];
+}
+
+void RequestGate::Enter() {
+    while (true) {
+        // 先增加计数再检查closing_，与Drain中的顺序相反，
+        // 保证请求要么被Drain看到，要么看到closing_后退出
+        Shard* shard = LocalShard();
+        shard->count.fetch_add(1);
+        if (!closing_.load()) {
+            return;
+        }
+
+        shard->count.fetch_sub(1);
+        NotifyDrainer();
+
+        std::unique_lock<bthread::Mutex> lock(mtx_);
+        while (closing_.load()) {
+            cond_.wait(lock);
+        }
+    }
+}
+
+void RequestGate::Exit() {
+    LocalShard()->count.fetch_sub(1);
+    if (closing_.load()) {
+        NotifyDrainer();
+    }
+}
+
+void RequestGate::Drain() {
+    std::unique_lock<bthread::Mutex> lock(mtx_);
+    while (closing_.load()) {
+        cond_.wait(lock);
+    }
+    closing_.store(true);
+    while (InflightCount() != 0) {
+        cond_.wait(lock);
+    }
+}
+
+void RequestGate::Resume() {
+    std::lock_guard<bthread::Mutex> lock(mtx_);
+    closing_.store(false);
+    cond_.notify_all();
+}
+
+int64_t RequestGate::InflightCount() const {
+    int64_t count = 0;
+    for (uint32_t i = 0; i <= shardMask_; ++i) {
+        count += shards_[i].count.load();
+    }
+    return count;
+}
+
+void RequestGate::NotifyDrainer() {
+    // 持锁通知，避免Drain在检查计数和等待之间错过唤醒
+    std::lock_guard<bthread::Mutex> lock(mtx_);
+    cond_.notify_all();
+}
+
+}  // namespace common
+}  // namespace nebd
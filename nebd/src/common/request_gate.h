@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef NEBD_SRC_COMMON_REQUEST_GATE_H_
+#define NEBD_SRC_COMMON_REQUEST_GATE_H_
+
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+
+#include "nebd/src/common/uncopyable.h"
+
+namespace nebd {
+namespace common {
+
+const size_t kCacheLineSize = 64;
+
+/**
+ * 请求准入控制，用于替代处理请求时加读锁、关闭时加写锁的方式
+ * 进行中的请求数按cpu分散计数，请求进出只需几次原子操作，
+ * Drain时阻止新请求进入，并等待各计数之和归零。
+ * 请求可以在其他线程结束，单个计数可能为负，只有总和有意义。
+ */
+class RequestGate : public Uncopyable {
+ public:
+    RequestGate();
+    ~RequestGate() = default;
+
+    /**
+     * @brief 请求进入，有Drain进行中时等待其结束
+     */
+    void Enter();
+
+    /**
+     * @brief 请求结束
+     */
+    void Exit();
+
+    /**
+     * @brief 阻止新请求进入，并等待进行中的请求全部结束
+     *        同一时刻只有一个Drain生效，须与Resume成对调用
+     */
+    void Drain();
+
+    /**
+     * @brief 允许新请求进入
+     */
+    void Resume();
+
+    /**
+     * @brief 返回进行中的请求数，测试使用
+     */
+    int64_t InflightCount() const;
+
+ private:
+    // 每个计数独占一个cache line，避免不同cpu之间的伪共享
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<int64_t> count;
+    };
+    static_assert(sizeof(Shard) == kCacheLineSize,
+                  "shard must occupy exactly one cache line");
+
+    // c++11的new不保证超过默认值的对齐，shards_由posix_memalign分配
+    struct ShardDeleter {
+        void operator()(Shard* shards) const {
+            free(shards);
+        }
+    };
+
+    Shard* LocalShard();
+
+    // 唤醒等待中的Drain
+    void NotifyDrainer();
+
+    uint32_t shardMask_;
+    std::unique_ptr<Shard[], ShardDeleter> shards_;
+    // 为true时新请求不能进入
+    std::atomic<bool> closing_;
+
+    bthread::Mutex mtx_;
+    bthread::ConditionVariable cond_;
+};
+
+class RequestGateGuard : public Uncopyable {
+ public:
+    explicit RequestGateGuard(RequestGate& gate) : gate_(gate) {  // NOLINT
+        gate_.Enter();
+    }
+
+    ~RequestGateGuard() {
+        gate_.Exit();
+    }
+
+ private:
+    RequestGate& gate_;
+};
+
+class RequestDrainGuard : public Uncopyable {
+ public:
+    explicit RequestDrainGuard(RequestGate& gate) : gate_(gate) {  // NOLINT
+        gate_.Drain();
+    }
+
+    ~RequestDrainGuard() {
+        gate_.Resume();
+    }
+
+ private:
+    RequestGate& gate_;
+};
+
+}  // namespace common
+}  // namespace nebd
+
+#endif  // NEBD_SRC_COMMON_REQUEST_GATE_H_
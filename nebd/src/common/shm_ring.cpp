@@ -0,0 +1,384 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "nebd/src/common/shm_ring.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+#include <cstring>
+
+namespace nebd {
+namespace common {
+
+namespace {
+
+const uint32_t kShmRingMagic = 0x4e454244;  // "NEBD"
+const uint32_t kShmRingVersion = 1;
+const uint64_t kShmRingAlign = 4096;
+const int kBufSize = 128;
+
+const char kRequestBellSuffix[] = ".sq";
+const char kCompletionBellSuffix[] = ".cq";
+
+uint64_t AlignUp(uint64_t size) {
+    return (size + kShmRingAlign - 1) / kShmRingAlign * kShmRingAlign;
+}
+
+}  // namespace
+
+struct ShmRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t depth;
+    uint32_t slotSize;
+    std::atomic<int32_t> serverPid;
+    // 生产者和消费者分别修改的字段放在不同的cacheline
+    alignas(64) std::atomic<uint32_t> requestHead;
+    alignas(64) std::atomic<uint32_t> requestTail;
+    std::atomic<uint32_t> requestNeedWakeup;
+    alignas(64) std::atomic<uint32_t> completionHead;
+    alignas(64) std::atomic<uint32_t> completionTail;
+    std::atomic<uint32_t> completionNeedWakeup;
+};
+
+namespace {
+
+// 按深度计算各部分的偏移，返回共享区域的总大小
+uint64_t Layout(uint32_t depth, uint32_t slotSize,
+                uint64_t* requestOff, uint64_t* completionOff,
+                uint64_t* dataOff) {
+    *requestOff = kShmRingAlign;
+    *completionOff = *requestOff + sizeof(ShmRingRequest) * depth;
+    *dataOff = AlignUp(*completionOff + sizeof(ShmRingCompletion) * depth);
+    return *dataOff + static_cast<uint64_t>(slotSize) * depth;
+}
+
+}  // namespace
+
+ShmRing::ShmRing()
+    : header_(nullptr),
+      requests_(nullptr),
+      completions_(nullptr),
+      data_(nullptr),
+      mapSize_(0),
+      depth_(0),
+      slotSize_(0),
+      requestBell_(-1),
+      completionBell_(-1) {
+    static_assert(sizeof(Header) <= kShmRingAlign,
+                  "shm ring header is too large");
+}
+
+ShmRing::~ShmRing() {
+    Unmap();
+    if (requestBell_ >= 0) {
+        close(requestBell_);
+    }
+    if (completionBell_ >= 0) {
+        close(completionBell_);
+    }
+}
+
+int ShmRing::Create(const std::string& path,
+                    uint32_t depth,
+                    uint32_t slotSize) {
+    if (depth == 0 || (depth & (depth - 1)) != 0 ||
+        slotSize == 0 || slotSize % kShmRingAlign != 0) {
+        LOG(ERROR) << "Invalid shm ring option, depth = " << depth
+                   << ", slotSize = " << slotSize;
+        return -1;
+    }
+
+    char buffer[kBufSize];
+    // 清理上次未正常删除的文件
+    Remove(path);
+    int fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "Create shm file failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", path = " << path;
+        return -1;
+    }
+
+    uint64_t requestOff, completionOff, dataOff;
+    uint64_t size = Layout(depth, slotSize,
+                           &requestOff, &completionOff, &dataOff);
+    if (ftruncate(fd, size) != 0) {
+        LOG(ERROR) << "Truncate shm file failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", path = " << path;
+        close(fd);
+        Remove(path);
+        return -1;
+    }
+
+    int ret = Map(fd, size);
+    close(fd);
+    if (ret != 0) {
+        Remove(path);
+        return -1;
+    }
+
+    for (const char* suffix : {kRequestBellSuffix, kCompletionBellSuffix}) {
+        std::string bell = path + suffix;
+        if (mkfifo(bell.c_str(), 0600) != 0) {
+            LOG(ERROR) << "Create shm ring bell failed, error = "
+                       << strerror_r(errno, buffer, kBufSize)
+                       << ", path = " << bell;
+            Unmap();
+            Remove(path);
+            return -1;
+        }
+    }
+    if (OpenBells(path) != 0) {
+        Unmap();
+        Remove(path);
+        return -1;
+    }
+
+    depth_ = depth;
+    slotSize_ = slotSize;
+    header_->depth = depth;
+    header_->slotSize = slotSize;
+    header_->serverPid.store(0);
+    header_->version = kShmRingVersion;
+    header_->magic = kShmRingMagic;
+    requests_ = reinterpret_cast<ShmRingRequest*>(
+        reinterpret_cast<char*>(header_) + requestOff);
+    completions_ = reinterpret_cast<ShmRingCompletion*>(
+        reinterpret_cast<char*>(header_) + completionOff);
+    data_ = reinterpret_cast<char*>(header_) + dataOff;
+    return 0;
+}
+
+int ShmRing::Attach(const std::string& path) {
+    char buffer[kBufSize];
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        LOG(ERROR) << "Open shm file failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", path = " << path;
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<uint64_t>(st.st_size) < kShmRingAlign) {
+        LOG(ERROR) << "Invalid shm file, path = " << path;
+        close(fd);
+        return -1;
+    }
+
+    int ret = Map(fd, st.st_size);
+    close(fd);
+    if (ret != 0) {
+        return -1;
+    }
+
+    uint64_t requestOff, completionOff, dataOff;
+    uint32_t depth = header_->depth;
+    uint32_t slotSize = header_->slotSize;
+    if (header_->magic != kShmRingMagic ||
+        header_->version != kShmRingVersion ||
+        depth == 0 || (depth & (depth - 1)) != 0 ||
+        Layout(depth, slotSize, &requestOff, &completionOff, &dataOff) !=
+            mapSize_) {
+        LOG(ERROR) << "Invalid shm ring header, path = " << path
+                   << ", magic = " << header_->magic
+                   << ", version = " << header_->version
+                   << ", depth = " << depth
+                   << ", slotSize = " << slotSize;
+        Unmap();
+        return -1;
+    }
+
+    if (OpenBells(path) != 0) {
+        Unmap();
+        return -1;
+    }
+
+    depth_ = depth;
+    slotSize_ = slotSize;
+    requests_ = reinterpret_cast<ShmRingRequest*>(
+        reinterpret_cast<char*>(header_) + requestOff);
+    completions_ = reinterpret_cast<ShmRingCompletion*>(
+        reinterpret_cast<char*>(header_) + completionOff);
+    data_ = reinterpret_cast<char*>(header_) + dataOff;
+    return 0;
+}
+
+void ShmRing::Remove(const std::string& path) {
+    unlink(path.c_str());
+    unlink((path + kRequestBellSuffix).c_str());
+    unlink((path + kCompletionBellSuffix).c_str());
+}
+
+bool ShmRing::PushRequest(const ShmRingRequest& request) {
+    uint32_t tail = header_->requestTail.load(std::memory_order_relaxed);
+    uint32_t head = header_->requestHead.load(std::memory_order_acquire);
+    if (tail - head >= depth_) {
+        return false;
+    }
+    requests_[tail & (depth_ - 1)] = request;
+    header_->requestTail.store(tail + 1, std::memory_order_release);
+    Ring(&header_->requestNeedWakeup, requestBell_);
+    return true;
+}
+
+bool ShmRing::PopRequest(ShmRingRequest* request) {
+    uint32_t head = header_->requestHead.load(std::memory_order_relaxed);
+    uint32_t tail = header_->requestTail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    *request = requests_[head & (depth_ - 1)];
+    header_->requestHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool ShmRing::PushCompletion(const ShmRingCompletion& completion) {
+    uint32_t tail = header_->completionTail.load(std::memory_order_relaxed);
+    uint32_t head = header_->completionHead.load(std::memory_order_acquire);
+    if (tail - head >= depth_) {
+        return false;
+    }
+    completions_[tail & (depth_ - 1)] = completion;
+    header_->completionTail.store(tail + 1, std::memory_order_release);
+    Ring(&header_->completionNeedWakeup, completionBell_);
+    return true;
+}
+
+bool ShmRing::PopCompletion(ShmRingCompletion* completion) {
+    uint32_t head = header_->completionHead.load(std::memory_order_relaxed);
+    uint32_t tail = header_->completionTail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    *completion = completions_[head & (depth_ - 1)];
+    header_->completionHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void ShmRing::WaitRequest(int timeoutMs) {
+    Wait(&header_->requestHead, &header_->requestTail,
+         &header_->requestNeedWakeup, requestBell_, timeoutMs);
+}
+
+void ShmRing::WaitCompletion(int timeoutMs) {
+    Wait(&header_->completionHead, &header_->completionTail,
+         &header_->completionNeedWakeup, completionBell_, timeoutMs);
+}
+
+void ShmRing::SetServerPid(int32_t pid) {
+    header_->serverPid.store(pid, std::memory_order_release);
+}
+
+int32_t ShmRing::GetServerPid() const {
+    return header_->serverPid.load(std::memory_order_acquire);
+}
+
+int ShmRing::Map(int fd, uint64_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        char buffer[kBufSize];
+        LOG(ERROR) << "mmap shm file failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", size = " << size;
+        return -1;
+    }
+    header_ = reinterpret_cast<Header*>(addr);
+    mapSize_ = size;
+    return 0;
+}
+
+int ShmRing::OpenBells(const std::string& path) {
+    char buffer[kBufSize];
+    // 以读写方式打开fifo，open不会阻塞，对端退出后也不会收到SIGPIPE
+    std::string requestBell = path + kRequestBellSuffix;
+    requestBell_ = open(requestBell.c_str(), O_RDWR | O_NONBLOCK);
+    if (requestBell_ < 0) {
+        LOG(ERROR) << "Open shm ring bell failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", path = " << requestBell;
+        return -1;
+    }
+    std::string completionBell = path + kCompletionBellSuffix;
+    completionBell_ = open(completionBell.c_str(), O_RDWR | O_NONBLOCK);
+    if (completionBell_ < 0) {
+        LOG(ERROR) << "Open shm ring bell failed, error = "
+                   << strerror_r(errno, buffer, kBufSize)
+                   << ", path = " << completionBell;
+        close(requestBell_);
+        requestBell_ = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void ShmRing::Unmap() {
+    if (header_ != nullptr) {
+        munmap(header_, mapSize_);
+        header_ = nullptr;
+        mapSize_ = 0;
+    }
+}
+
+void ShmRing::Wait(std::atomic<uint32_t>* head,
+                   std::atomic<uint32_t>* tail,
+                   std::atomic<uint32_t>* needWakeup,
+                   int bellFd,
+                   int timeoutMs) {
+    // 先声明需要唤醒再检查队列，与Ring中的顺序配合，不会错过唤醒
+    needWakeup->store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tail->load(std::memory_order_acquire) ==
+        head->load(std::memory_order_relaxed)) {
+        struct pollfd pfd;
+        pfd.fd = bellFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        poll(&pfd, 1, timeoutMs);
+    }
+    needWakeup->store(0, std::memory_order_relaxed);
+
+    char buf[64];
+    while (read(bellFd, buf, sizeof(buf)) > 0) {}
+}
+
+void ShmRing::Ring(std::atomic<uint32_t>* needWakeup, int bellFd) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (needWakeup->load(std::memory_order_relaxed) != 0) {
+        // fifo已满说明已经有未处理的唤醒，忽略EAGAIN
+        char c = 1;
+        ssize_t ret = write(bellFd, &c, 1);
+        (void)ret;
+    }
+}
+
+}  // namespace common
+}  // namespace nebd
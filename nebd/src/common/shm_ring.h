@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef NEBD_SRC_COMMON_SHM_RING_H_
+#define NEBD_SRC_COMMON_SHM_RING_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "nebd/src/common/uncopyable.h"
+
+namespace nebd {
+namespace common {
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "shm ring requires lock free 32-bit atomics");
+
+// 共享内存环中的请求类型，与LIBAIO_OP的取值一致
+enum class ShmRingOp : uint32_t {
+    READ = 0,
+    WRITE = 1,
+    DISCARD = 2,
+    FLUSH = 3,
+};
+
+// 提交队列中的请求，数据位于slot对应的数据区
+struct ShmRingRequest {
+    uint64_t id;
+    uint32_t op;
+    uint32_t slot;
+    uint64_t offset;
+    uint64_t length;
+};
+
+// 完成队列中的结果，ret为0表示成功，-1表示io失败
+struct ShmRingCompletion {
+    uint64_t id;
+    int64_t ret;
+};
+
+// part2不向part1返回io错误(returnRpcWhenIoError=false)时的结果，
+// part1收到后将请求改由rpc重新发送，与rpc路径的重试行为一致
+const int64_t kShmRingResend = -2;
+
+/**
+ * part1与part2之间基于共享内存的请求环
+ * 共享区域为一个文件(一般位于/dev/shm)，依次为头部、提交队列、完成队列和数据区，
+ * 数据区按队列深度分为等长的slot，每个进行中的请求占用一个slot。
+ * part1提交请求、part2消费请求；part2提交结果、part1消费结果，
+ * 两个队列各自只有一个生产者和一个消费者，多线程生产时由调用者串行化。
+ * 消费者空闲时在门铃上等待，门铃为与共享文件同名加.sq/.cq后缀的fifo，
+ * 只有消费者声明需要唤醒时生产者才写门铃，忙时没有系统调用。
+ */
+class ShmRing : public Uncopyable {
+ public:
+    ShmRing();
+    ~ShmRing();
+
+    /**
+     * @brief 创建共享区域及门铃，由part1调用
+     * @param path 共享文件路径
+     * @param depth 队列深度，须为2的幂
+     * @param slotSize 每个slot的大小，须为4KB的整数倍
+     * @return 成功返回0，失败返回-1
+     */
+    int Create(const std::string& path, uint32_t depth, uint32_t slotSize);
+
+    /**
+     * @brief 映射part1创建的共享区域，由part2调用
+     * @param path 共享文件路径
+     * @return 成功返回0，失败返回-1
+     */
+    int Attach(const std::string& path);
+
+    /**
+     * @brief 删除共享文件及门铃
+     */
+    static void Remove(const std::string& path);
+
+    /**
+     * @brief 提交请求，必要时唤醒消费者
+     * @return 队列已满时返回false
+     */
+    bool PushRequest(const ShmRingRequest& request);
+    bool PopRequest(ShmRingRequest* request);
+
+    /**
+     * @brief 提交结果，必要时唤醒消费者
+     * @return 队列已满时返回false
+     */
+    bool PushCompletion(const ShmRingCompletion& completion);
+    bool PopCompletion(ShmRingCompletion* completion);
+
+    /**
+     * @brief 提交队列为空时等待，直到有新的请求或超时
+     * @param timeoutMs 超时时间
+     */
+    void WaitRequest(int timeoutMs);
+
+    /**
+     * @brief 完成队列为空时等待，直到有新的结果或超时
+     * @param timeoutMs 超时时间
+     */
+    void WaitCompletion(int timeoutMs);
+
+    char* SlotData(uint32_t slot) const {
+        return data_ + static_cast<uint64_t>(slot) * slotSize_;
+    }
+
+    uint32_t Depth() const {
+        return depth_;
+    }
+
+    uint32_t SlotSize() const {
+        return slotSize_;
+    }
+
+    // part2 attach后记录自己的进程号，part1据此判断part2是否退出
+    void SetServerPid(int32_t pid);
+    int32_t GetServerPid() const;
+
+ private:
+    struct Header;
+
+    int Map(int fd, uint64_t size);
+    int OpenBells(const std::string& path);
+    void Unmap();
+
+    static void Wait(std::atomic<uint32_t>* head,
+                     std::atomic<uint32_t>* tail,
+                     std::atomic<uint32_t>* needWakeup,
+                     int bellFd,
+                     int timeoutMs);
+    static void Ring(std::atomic<uint32_t>* needWakeup, int bellFd);
+
+ private:
+    Header* header_;
+    ShmRingRequest* requests_;
+    ShmRingCompletion* completions_;
+    char* data_;
+    uint64_t mapSize_;
+    uint32_t depth_;
+    uint32_t slotSize_;
+    // 提交队列和完成队列的门铃
+    int requestBell_;
+    int completionBell_;
+};
+
+}  // namespace common
+}  // namespace nebd
+
+#endif  // NEBD_SRC_COMMON_SHM_RING_H_
@@ -22,6 +22,7 @@
 
 #include "nebd/src/part1/async_request_closure.h"
 
+#include <brpc/errno.pb.h>
 #include <glog/logging.h>
 #include <bthread/bthread.h>
 
@@ -111,5 +112,80 @@ void AsyncRequestClosure::Retry() const {
     }
 }
 
+void AioBatchClosure::Run() {
+    std::unique_ptr<AioBatchClosure> selfGuard(this);
+
+    if (cntl.Failed()) {
+        if (cntl.ErrorCode() == brpc::ENOMETHOD) {
+            // part2版本较低，不支持AioBatch
+            nebdClient.DisableAioBatch();
+            RetryEach();
+            return;
+        }
+
+        int64_t retryCount = 0;
+        for (auto ctx : aioCtxs) {
+            retryCount = std::max(retryCount,
+                                  static_cast<int64_t>(++ctx->retryCount));
+        }
+        int64_t sleepUs = GetRpcRetryIntervalUs(retryCount);
+        LOG_EVERY_SECOND(WARNING)
+            << "AioBatch rpc failed"
+            << ", error = " << cntl.ErrorText()
+            << ", fd = " << fd
+            << ", request count = " << aioCtxs.size()
+            << ", log id = " << cntl.log_id()
+            << ", retryCount = " << retryCount
+            << ", sleep " << (sleepUs / 1000) << " ms";
+        bthread_usleep(sleepUs);
+        RetryEach();
+        return;
+    }
+
+    bool batchOk = GetResponseRetCode() == RetCode::kOK &&
+        response.entryretcode_size() == static_cast<int>(aioCtxs.size());
+    if (!batchOk) {
+        LOG(ERROR) << "AioBatch failed, fd = " << fd
+                   << ", request count = " << aioCtxs.size()
+                   << ", retCode = " << GetResponseRetCode()
+                   << ", log id = " << cntl.log_id();
+    }
+
+    // 成功的读请求的数据按顺序放在attachment中
+    for (size_t i = 0; i < aioCtxs.size(); ++i) {
+        auto ctx = aioCtxs[i];
+        if (batchOk && response.entryretcode(i) == RetCode::kOK) {
+            if (ctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+                cntl.response_attachment().cutn(ctx->buf, ctx->length);
+            }
+            ctx->ret = 0;
+        } else {
+            if (batchOk) {
+                LOG(ERROR) << OpTypeToString(ctx->op) << " failed, fd = " << fd
+                           << ", offset = " << ctx->offset
+                           << ", length = " << ctx->length
+                           << ", retCode = " << response.entryretcode(i)
+                           << ", log id = " << cntl.log_id();
+            }
+            ctx->ret = -1;
+        }
+    }
+
+    // 回调中可能释放请求上下文，所以在数据拷贝完成后统一回调
+    for (auto ctx : aioCtxs) {
+        ctx->cb(ctx);
+    }
+}
+
+void AioBatchClosure::RetryEach() const {
+    for (auto ctx : aioCtxs) {
+        if (ctx->op == LIBAIO_OP::LIBAIO_OP_WRITE) {
+            nebdClient.AioWrite(fd, ctx);
+        } else {
+            nebdClient.AioRead(fd, ctx);
+        }
+    }
+}
+
 }  // namespace client
 }  // namespace nebd
@@ -25,6 +25,8 @@
 
 #include <brpc/controller.h>
 
+#include <vector>
+
 #include "nebd/src/part1/nebd_client.h"
 #include "nebd/src/part1/nebd_common.h"
 
@@ -123,6 +125,32 @@ struct AioFlushClosure : public AsyncRequestClosure {
     }
 };
 
+// 同一文件的多个读写请求合并后的AioBatch rpc
+struct AioBatchClosure : public AsyncRequestClosure {
+    AioBatchClosure(int fd,
+                    const std::vector<NebdClientAioContext*>& ctxs,
+                    const RequestOption& option)
+      : AsyncRequestClosure(
+          fd,
+          ctxs.front(),
+          option),
+        aioCtxs(ctxs) {}
+
+    void Run() override;
+
+    AioBatchResponse response;
+
+    RetCode GetResponseRetCode() const override {
+        return response.retcode();
+    }
+
+    // rpc失败时各请求单独重试
+    void RetryEach() const;
+
+    // 合并的全部请求上下文
+    std::vector<NebdClientAioContext*> aioCtxs;
+};
+
 inline const char* OpTypeToString(LIBAIO_OP opType) {
     switch (opType) {
     case LIBAIO_OP::LIBAIO_OP_READ:
@@ -119,6 +119,11 @@ void HeartbeatManager::SendHeartBeat() {
         LOG(WARNING) << "Heartbeat request failed, error = "
                      << cntl.ErrorText()
                      << ", log id = " << cntl.log_id();
+        return;
+    }
+
+    if (successCallback_) {
+        successCallback_();
     }
 }
 
@@ -26,6 +26,7 @@
 #include <brpc/channel.h>
 
 #include <thread>   // NOLINT
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -63,6 +64,14 @@ class HeartbeatManager {
      */
     int Init(const HeartbeatOption& option);
 
+    /**
+     * @brief 设置心跳成功后的回调，在心跳线程中执行，需在Run之前设置
+     * @param callback 回调函数
+     */
+    void SetHeartbeatSuccessCallback(const std::function<void()>& callback) {
+        successCallback_ = callback;
+    }
+
  private:
     /**
      * @brief: 心跳线程执行函数，定期发送心跳消息
@@ -81,6 +90,9 @@ class HeartbeatManager {
 
     std::shared_ptr<NebdClientMetaCache>  metaCache_;
 
+    // 心跳成功后的回调
+    std::function<void()> successCallback_;
+
     std::thread heartbeatThread_;
     nebd::common::InterruptibleSleeper sleeper_;
 
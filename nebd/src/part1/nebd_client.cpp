@@ -99,6 +99,10 @@ int NebdClient::Init(const char* confpath) {
         LOG(ERROR) << "Heartbeat Manager InitChannel failed";
         return -1;
     }
+    // part2重启后心跳恢复，为失效的共享内存环重新建立通道
+    heartbeatMgr_->SetHeartbeatSuccessCallback([this]() {
+        ReattachShmChannels();
+    });
 
     heartbeatMgr_->Run();
 
@@ -121,6 +125,15 @@ void NebdClient::Uninit() {
         heartbeatMgr_->Stop();
     }
 
+    std::unordered_map<int, std::shared_ptr<NebdShmChannel>> shmChannels;
+    {
+        nebd::common::WriteLockGuard guard(shmChannelsLock_);
+        shmChannels.swap(shmChannels_);
+    }
+    for (auto& item : shmChannels) {
+        item.second->Fini();
+    }
+
     // stop exec queue
     for (auto& q : rpcTaskQueues_) {
         bthread::execution_queue_stop(q);
@@ -182,10 +195,13 @@ int NebdClient::Open(const char* filename) {
     }
 
     metaCache_->AddFileInfo({fd, filename, fileLock});
+    AttachShmChannel(fd);
     return fd;
 }
 
 int NebdClient::Close(int fd) {
+    DetachShmChannel(fd);
+
     auto task = [&](brpc::Controller* cntl,
                     brpc::Channel* channel,
                     bool* rpcFailed) -> int64_t {
@@ -307,6 +323,13 @@ int64_t NebdClient::GetFileSize(int fd) {
 }
 
 int NebdClient::Discard(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmChannel(fd, aioctx)) {
+        return 0;
+    }
+    return DiscardByRpc(fd, aioctx);
+}
+
+int NebdClient::DiscardByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::DiscardRequest request;
@@ -321,12 +344,19 @@ int NebdClient::Discard(int fd, NebdClientAioContext* aioctx) {
         stub.Discard(&done->cntl, &request, &done->response, done);
     };
 
-    PushAsyncTask(task);
+    PushAsyncTask({task, fd, nullptr});
 
     return 0;
 }
 
 int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmChannel(fd, aioctx)) {
+        return 0;
+    }
+    return AioReadByRpc(fd, aioctx);
+}
+
+int NebdClient::AioReadByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::ReadRequest request;
@@ -341,7 +371,7 @@ int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
         stub.Read(&done->cntl, &request, &done->response, done);
     };
 
-    PushAsyncTask(task);
+    PushAsyncTask({task, fd, aioctx});
 
     return 0;
 }
@@ -349,6 +379,13 @@ int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
 static void EmptyDeleter(void* m) {}
 
 int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmChannel(fd, aioctx)) {
+        return 0;
+    }
+    return AioWriteByRpc(fd, aioctx);
+}
+
+int NebdClient::AioWriteByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::WriteRequest request;
@@ -366,12 +403,19 @@ int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
         stub.Write(&done->cntl, &request, &done->response, done);
     };
 
-    PushAsyncTask(task);
+    PushAsyncTask({task, fd, aioctx});
 
     return 0;
 }
 
 int NebdClient::Flush(int fd, NebdClientAioContext* aioctx) {
+    if (SubmitByShmChannel(fd, aioctx)) {
+        return 0;
+    }
+    return FlushByRpc(fd, aioctx);
+}
+
+int NebdClient::FlushByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::FlushRequest request;
@@ -384,11 +428,18 @@ int NebdClient::Flush(int fd, NebdClientAioContext* aioctx) {
         stub.Flush(&done->cntl, &request, &done->response, done);
     };
 
-    PushAsyncTask(task);
+    PushAsyncTask({task, fd, nullptr});
 
     return 0;
 }
 
+void NebdClient::DisableAioBatch() {
+    if (!aioBatchDisabled_.exchange(true)) {
+        LOG(WARNING) << "nebd-server does not support AioBatch, "
+                     << "aio requests will be sent one by one";
+    }
+}
+
 int64_t NebdClient::GetInfo(int fd) {
     auto task = [&](brpc::Controller* cntl,
                     brpc::Channel* channel,
@@ -516,15 +567,38 @@ int NebdClient::InitNebdClientOption(Configuration* conf) {
            "value is "
         << requestOption.rpcSendExecQueueNum;
 
+    // 可选配置项，不存在时不合并请求
+    conf->GetUInt32Value("request.aioBatchMaxSize",
+                         &requestOption.aioBatchMaxSize);
+    LOG(INFO) << "aio batch max size: " << requestOption.aioBatchMaxSize;
+
     option_.requestOption = requestOption;
 
     ret = conf->GetStringValue("log.path", &option_.logOption.logPath);
     LOG_IF(ERROR, ret != true) << "Load log.path failed";
     RETURN_IF_FALSE(ret);
 
+    InitShmRingOption(conf);
+
     return 0;
 }
 
+void NebdClient::InitShmRingOption(Configuration* conf) {
+    // 共享内存环为可选功能，配置项不存在时使用默认值
+    ShmRingOption* shmOption = &option_.shmRingOption;
+    conf->GetBoolValue("shm.enable", &shmOption->enable);
+    conf->GetStringValue("shm.path", &shmOption->path);
+    conf->GetUInt32Value("shm.queueDepth", &shmOption->queueDepth);
+    conf->GetUInt32Value("shm.slotSize", &shmOption->slotSize);
+    conf->GetUInt32Value("shm.serverCheckIntervalMs",
+                         &shmOption->serverCheckIntervalMs);
+    conf->GetUInt32Value("shm.finiTimeoutMs", &shmOption->finiTimeoutMs);
+    LOG(INFO) << "shm ring enable: " << shmOption->enable
+              << ", path: " << shmOption->path
+              << ", queue depth: " << shmOption->queueDepth
+              << ", slot size: " << shmOption->slotSize;
+}
+
 int NebdClient::InitHeartBeatOption(Configuration* conf,
                                     HeartbeatOption* heartbeatOption) {
     bool ret = conf->GetInt64Value("heartbeat.intervalS",
@@ -587,6 +661,181 @@ int64_t NebdClient::ExecuteSyncRpc(RpcTask task) {
     return -1;
 }
 
+void NebdClient::AttachShmChannel(int fd, bool reattach) {
+    const ShmRingOption& shmOption = option_.shmRingOption;
+    if (!shmOption.enable) {
+        return;
+    }
+
+    std::string path = shmOption.path + "/nebd-" + std::to_string(getpid()) +
+                       "-" + std::to_string(fd);
+    auto shmChannel = std::make_shared<NebdShmChannel>(
+        fd, shmOption, [this, fd](NebdClientAioContext* aioctx) {
+            ResendByRpc(fd, aioctx);
+        });
+    if (shmChannel->Init(path) != 0) {
+        LOG(WARNING) << "Init shm channel failed, use rpc only, fd = " << fd;
+        nebd::common::ShmRing::Remove(path);
+        return;
+    }
+
+    auto task = [&](brpc::Controller* cntl,
+                    brpc::Channel* channel,
+                    bool* rpcFailed) -> int64_t {
+        NebdFileService_Stub stub(channel);
+        AttachShmRingRequest request;
+        AttachShmRingResponse response;
+
+        request.set_fd(fd);
+        request.set_path(path);
+        stub.AttachShmRing(cntl, &request, &response, nullptr);
+
+        *rpcFailed = cntl->Failed();
+        if (*rpcFailed) {
+            LOG(WARNING) << "AttachShmRing rpc failed, error = "
+                         << cntl->ErrorText()
+                         << ", log id = " << cntl->log_id();
+            return -1;
+        } else if (response.retcode() != RetCode::kOK) {
+            LOG(WARNING) << "AttachShmRing failed, "
+                         << "retcode = " << response.retcode()
+                         << ", retmsg = " << response.retmsg()
+                         << ", fd = " << fd
+                         << ", log id = " << cntl->log_id();
+            return -1;
+        }
+        return 0;
+    };
+
+    int64_t ret = ExecuteSyncRpc(task);
+    // part2已映射或放弃映射，共享文件不再需要，删除后进程退出也不会残留
+    nebd::common::ShmRing::Remove(path);
+    if (ret != 0) {
+        LOG(WARNING) << "Attach shm ring failed, use rpc only, fd = " << fd;
+        return;
+    }
+
+    std::shared_ptr<NebdShmChannel> old;
+    {
+        nebd::common::WriteLockGuard guard(shmChannelsLock_);
+        auto iter = shmChannels_.find(fd);
+        if (iter != shmChannels_.end()) {
+            old = iter->second;
+            iter->second = shmChannel;
+        } else if (!reattach) {
+            shmChannels_.emplace(fd, shmChannel);
+        } else {
+            // 重新建立期间文件已关闭，part2关闭文件时会停止新的环
+            shmChannel = nullptr;
+        }
+    }
+    if (old != nullptr) {
+        // 失效通道上的请求都已改由rpc发送
+        old->Fini();
+    }
+    if (shmChannel == nullptr) {
+        LOG(INFO) << "File closed while reattaching shm ring, fd = " << fd;
+        return;
+    }
+    LOG(INFO) << "Attach shm ring success, fd = " << fd;
+}
+
+void NebdClient::ReattachShmChannels() {
+    if (!option_.shmRingOption.enable) {
+        return;
+    }
+
+    std::vector<int> brokenFds;
+    {
+        nebd::common::ReadLockGuard guard(shmChannelsLock_);
+        for (const auto& item : shmChannels_) {
+            if (item.second->IsBroken()) {
+                brokenFds.push_back(item.first);
+            }
+        }
+    }
+
+    // 失败时保留失效的通道，下次心跳成功后再次尝试
+    for (int fd : brokenFds) {
+        LOG(INFO) << "Reattach shm ring, fd = " << fd;
+        AttachShmChannel(fd, true);
+    }
+}
+
+void NebdClient::DetachShmChannel(int fd) {
+    std::shared_ptr<NebdShmChannel> shmChannel;
+    {
+        nebd::common::WriteLockGuard guard(shmChannelsLock_);
+        auto iter = shmChannels_.find(fd);
+        if (iter == shmChannels_.end()) {
+            return;
+        }
+        shmChannel = iter->second;
+        shmChannels_.erase(iter);
+    }
+    shmChannel->Fini();
+    if (shmChannel->IsBroken()) {
+        return;
+    }
+
+    auto task = [&](brpc::Controller* cntl,
+                    brpc::Channel* channel,
+                    bool* rpcFailed) -> int64_t {
+        NebdFileService_Stub stub(channel);
+        DetachShmRingRequest request;
+        DetachShmRingResponse response;
+
+        request.set_fd(fd);
+        stub.DetachShmRing(cntl, &request, &response, nullptr);
+
+        *rpcFailed = cntl->Failed();
+        if (*rpcFailed) {
+            LOG(WARNING) << "DetachShmRing rpc failed, error = "
+                         << cntl->ErrorText()
+                         << ", log id = " << cntl->log_id();
+            return -1;
+        }
+        return 0;
+    };
+    ExecuteSyncRpc(task);
+}
+
+bool NebdClient::SubmitByShmChannel(int fd, NebdClientAioContext* aioctx) {
+    if (!option_.shmRingOption.enable) {
+        return false;
+    }
+
+    nebd::common::ReadLockGuard guard(shmChannelsLock_);
+    auto iter = shmChannels_.find(fd);
+    if (iter == shmChannels_.end()) {
+        return false;
+    }
+    return iter->second->Submit(aioctx);
+}
+
+void NebdClient::ResendByRpc(int fd, NebdClientAioContext* aioctx) {
+    // 通道可能仍然可用，不能再经共享内存环提交
+    switch (aioctx->op) {
+        case LIBAIO_OP::LIBAIO_OP_READ:
+            AioReadByRpc(fd, aioctx);
+            break;
+        case LIBAIO_OP::LIBAIO_OP_WRITE:
+            AioWriteByRpc(fd, aioctx);
+            break;
+        case LIBAIO_OP::LIBAIO_OP_DISCARD:
+            DiscardByRpc(fd, aioctx);
+            break;
+        case LIBAIO_OP::LIBAIO_OP_FLUSH:
+            FlushByRpc(fd, aioctx);
+            break;
+        default:
+            LOG(ERROR) << "Unknown aio op: " << aioctx->op;
+            aioctx->ret = -1;
+            aioctx->cb(aioctx);
+            break;
+    }
+}
+
 std::string NebdClient::ReplaceSlash(const std::string& str) {
     std::string ret(str);
     for (auto& ch : ret) {
@@ -607,15 +856,81 @@ void NebdClient::InitLogger(const LogOption& logOption) {
     google::InitGoogleLogging(kProcessName);
 }
 
+void NebdClient::SendAioBatch(int fd, std::vector<AsyncRpcTask>* tasks) {
+    if (tasks->empty()) {
+        return;
+    }
+    if (tasks->size() == 1) {
+        tasks->front().func();
+        tasks->clear();
+        return;
+    }
+
+    nebd::client::NebdFileService_Stub stub(&channel_);
+    nebd::client::AioBatchRequest request;
+    request.set_fd(fd);
+
+    std::vector<NebdClientAioContext*> aioctxs;
+    aioctxs.reserve(tasks->size());
+    for (auto& task : *tasks) {
+        aioctxs.push_back(task.aioctx);
+    }
+
+    AioBatchClosure* done = new(std::nothrow) AioBatchClosure(
+        fd, aioctxs, option_.requestOption);
+    done->cntl.set_timeout_ms(-1);
+    done->cntl.set_log_id(logId_.fetch_add(1, std::memory_order_relaxed));
+    for (auto aioctx : aioctxs) {
+        auto entry = request.add_entries();
+        entry->set_offset(aioctx->offset);
+        entry->set_size(aioctx->length);
+        if (aioctx->op == LIBAIO_OP::LIBAIO_OP_WRITE) {
+            entry->set_op(nebd::client::AioBatchOp::kBatchWrite);
+            done->cntl.request_attachment().append_user_data(
+                aioctx->buf, aioctx->length, EmptyDeleter);
+        } else {
+            entry->set_op(nebd::client::AioBatchOp::kBatchRead);
+        }
+    }
+    tasks->clear();
+    stub.AioBatch(&done->cntl, &request, &done->response, done);
+}
+
 int NebdClient::ExecAsyncRpcTask(void* meta,
                                  bthread::TaskIterator<AsyncRpcTask>& iter) {  // NOLINT
     if (iter.is_queue_stopped()) {
         return 0;
     }
 
+    NebdClient* client = static_cast<NebdClient*>(meta);
+    if (!client->IsAioBatchEnabled()) {
+        for (; iter; ++iter) {
+            (*iter).func();
+        }
+        return 0;
+    }
+
+    // 暂存各文件可以合并的读写请求，本轮任务处理完后统一发送
+    uint32_t maxBatchSize = client->option_.requestOption.aioBatchMaxSize;
+    std::unordered_map<int, std::vector<AsyncRpcTask>> pending;
     for (; iter; ++iter) {
         auto& task = *iter;
-        task();
+        auto& tasks = pending[task.fd];
+        if (task.aioctx == nullptr) {
+            // flush和discard不能越过之前下发的读写请求
+            client->SendAioBatch(task.fd, &tasks);
+            task.func();
+            continue;
+        }
+
+        tasks.push_back(task);
+        if (tasks.size() >= maxBatchSize) {
+            client->SendAioBatch(task.fd, &tasks);
+        }
+    }
+
+    for (auto& item : pending) {
+        client->SendAioBatch(item.first, &item.second);
     }
 
     return 0;
@@ -26,9 +26,11 @@
 #include <brpc/channel.h>
 #include <bthread/execution_queue.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "nebd/src/part1/nebd_common.h"
@@ -37,6 +39,8 @@
 #include "nebd/src/part1/libnebd.h"
 #include "nebd/src/part1/heartbeat_manager.h"
 #include "nebd/src/part1/nebd_metacache.h"
+#include "nebd/src/part1/nebd_shm_channel.h"
+#include "nebd/src/common/rw_lock.h"
 
 #include "include/curve_compiler_specific.h"
 
@@ -146,12 +150,19 @@ class NebdClient {
      */
     int InvalidCache(int fd);
 
+    /**
+     *  @brief 停止合并读写请求，part2不支持AioBatch时调用
+     */
+    void DisableAioBatch();
+
  private:
     int InitNebdClientOption(Configuration* conf);
 
     int InitHeartBeatOption(Configuration* conf,
                             HeartbeatOption* hearbeatOption);
 
+    void InitShmRingOption(Configuration* conf);
+
     int InitChannel();
 
     void InitLogger(const LogOption& logOption);
@@ -165,6 +176,44 @@ class NebdClient {
     std::string ReplaceSlash(const std::string& str);
 
     int64_t ExecuteSyncRpc(RpcTask task);
+
+    int DiscardByRpc(int fd, NebdClientAioContext* aioctx);
+    int AioReadByRpc(int fd, NebdClientAioContext* aioctx);
+    int AioWriteByRpc(int fd, NebdClientAioContext* aioctx);
+    int FlushByRpc(int fd, NebdClientAioContext* aioctx);
+
+    /**
+     * @brief 为打开的文件建立共享内存环，失败时该文件只使用rpc
+     * @param fd 文件的fd
+     * @param reattach 是否替换已失效的通道，文件已关闭时不再建立
+     */
+    void AttachShmChannel(int fd, bool reattach = false);
+
+    /**
+     * @brief 为part2退出后失效的共享内存环重新建立通道，心跳成功后调用
+     */
+    void ReattachShmChannels();
+
+    /**
+     * @brief 停止文件的共享内存环，等待其上的请求返回
+     * @param fd 文件的fd
+     */
+    void DetachShmChannel(int fd);
+
+    /**
+     * @brief 尝试通过共享内存环提交异步请求
+     * @return 提交成功返回true，否则由调用者通过rpc发送
+     */
+    bool SubmitByShmChannel(int fd, NebdClientAioContext* aioctx);
+
+    // 将共享内存环上的请求改由rpc发送，用于通道失效或part2要求重试
+    void ResendByRpc(int fd, NebdClientAioContext* aioctx);
+
+    bool IsAioBatchEnabled() const {
+        return option_.requestOption.aioBatchMaxSize > 1 &&
+               !aioBatchDisabled_.load(std::memory_order_relaxed);
+    }
+
     // 心跳管理模块
     std::shared_ptr<HeartbeatManager> heartbeatMgr_;
     // 缓存模块
@@ -176,21 +225,44 @@ class NebdClient {
 
     std::atomic<uint64_t> logId_{1};
 
+    // 各文件的共享内存环
+    nebd::common::RWLock shmChannelsLock_;
+    std::unordered_map<int, std::shared_ptr<NebdShmChannel>> shmChannels_;
+
+    // part2不支持AioBatch时置为true
+    std::atomic<bool> aioBatchDisabled_{false};
+
  private:
-    using AsyncRpcTask = std::function<void()>;
+    struct AsyncRpcTask {
+        // 单独发送该请求
+        std::function<void()> func;
+        // 请求的文件
+        int fd;
+        // 可以与同一文件的其他请求合并的读写请求，其他请求为nullptr
+        NebdClientAioContext* aioctx;
+    };
 
     std::vector<bthread::ExecutionQueueId<AsyncRpcTask>> rpcTaskQueues_;
 
     static int ExecAsyncRpcTask(void* meta, bthread::TaskIterator<AsyncRpcTask>& iter);  // NOLINT
 
+    /**
+     * @brief 发送同一文件暂存的读写请求，只有一个请求时单独发送
+     * @param fd 文件的fd
+     * @param tasks 暂存的请求，发送后清空
+     */
+    void SendAioBatch(int fd, std::vector<AsyncRpcTask>* tasks);
+
     void PushAsyncTask(const AsyncRpcTask& task) {
         static thread_local unsigned int seed = time(nullptr);
 
-        int idx = rand_r(&seed) % rpcTaskQueues_.size();
+        // 合并请求时同一文件的请求进入同一个队列
+        int idx = IsAioBatchEnabled() ? task.fd % rpcTaskQueues_.size()
+                                      : rand_r(&seed) % rpcTaskQueues_.size();
         int rc = bthread::execution_queue_execute(rpcTaskQueues_[idx], task);
 
         if (CURVE_UNLIKELY(rc != 0)) {
-            task();
+            task.func();
         }
     }
 };
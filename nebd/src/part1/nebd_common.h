@@ -41,6 +41,8 @@ struct RequestOption {
     int64_t rpcMaxDelayHealthCheckIntervalMs;
     // rpc发送执行队列个数
     uint32_t rpcSendExecQueueNum = 2;
+    // 同一文件合并为一次rpc的读写请求数上限，不大于1时不合并
+    uint32_t aioBatchMaxSize = 1;
 };
 
 // 日志配置项
@@ -49,6 +51,22 @@ struct LogOption {
     std::string logPath;
 };
 
+// 共享内存环配置项
+struct ShmRingOption {
+    // 是否通过共享内存环传递读写请求
+    bool enable = false;
+    // 共享文件所在目录
+    std::string path = "/dev/shm";
+    // 队列深度，即每个文件同时进行的请求数上限，须为2的幂
+    uint32_t queueDepth = 128;
+    // 单个请求的最大长度，超过时走rpc
+    uint32_t slotSize = 131072;
+    // 有请求进行时检查part2是否存活的周期
+    uint32_t serverCheckIntervalMs = 1000;
+    // 关闭文件时等待进行中的请求返回的最长时间，超时后请求失败返回
+    uint32_t finiTimeoutMs = 10000;
+};
+
 // nebd client配置项
 struct NebdClientOption {
     // part2 socket file address
@@ -59,6 +77,8 @@ struct NebdClientOption {
     RequestOption requestOption;
     // 日志配置项
     LogOption logOption;
+    // 共享内存环配置项
+    ShmRingOption shmRingOption;
 };
 
 // heartbeat配置项
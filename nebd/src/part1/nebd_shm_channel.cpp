@@ -0,0 +1,270 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "nebd/src/part1/nebd_shm_channel.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <glog/logging.h>
+
+#include <cstring>
+
+#include "nebd/src/common/timeutility.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::ShmRingOp;
+using nebd::common::ShmRingRequest;
+using nebd::common::ShmRingCompletion;
+using nebd::common::TimeUtility;
+
+// 完成队列为空时的等待时间，也是Fini的最大延迟
+const int kWaitCompletionTimeoutMs = 100;
+const uint64_t kSlotMask = 0xffffffffULL;
+
+NebdShmChannel::NebdShmChannel(int fd, const ShmRingOption& option,
+                               const ShmFallbackFunc& fallback)
+    : fd_(fd)
+    , option_(option)
+    , fallback_(fallback)
+    , inflightCount_(0)
+    , sequence_(0)
+    , broken_(false)
+    , running_(false) {}
+
+NebdShmChannel::~NebdShmChannel() {
+    Fini();
+}
+
+int NebdShmChannel::Init(const std::string& path) {
+    int ret = ring_.Create(path, option_.queueDepth, option_.slotSize);
+    if (ret != 0) {
+        LOG(ERROR) << "Create shm ring failed, fd = " << fd_
+                   << ", path = " << path;
+        return -1;
+    }
+
+    uint32_t depth = ring_.Depth();
+    freeSlots_.reserve(depth);
+    for (uint32_t i = depth; i > 0; --i) {
+        freeSlots_.push_back(i - 1);
+    }
+    inflight_.assign(depth, nullptr);
+    inflightIds_.assign(depth, 0);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&NebdShmChannel::Run, this);
+    return 0;
+}
+
+void NebdShmChannel::Fini() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool NebdShmChannel::Submit(NebdClientAioContext* aioctx) {
+    if (aioctx->length > ring_.SlotSize() ||
+        broken_.load(std::memory_order_acquire) ||
+        !running_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    uint32_t slot;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (freeSlots_.empty()) {
+            return false;
+        }
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    // 拷贝数据时不持锁，其他线程可以同时提交
+    if (aioctx->op == LIBAIO_OP::LIBAIO_OP_WRITE) {
+        memcpy(ring_.SlotData(slot), aioctx->buf, aioctx->length);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (broken_.load(std::memory_order_relaxed)) {
+        freeSlots_.push_back(slot);
+        return false;
+    }
+
+    ShmRingRequest request;
+    request.id = (++sequence_ << 32) | slot;
+    request.op = static_cast<uint32_t>(aioctx->op);
+    request.slot = slot;
+    request.offset = aioctx->offset;
+    request.length = aioctx->length;
+    inflight_[slot] = aioctx;
+    inflightIds_[slot] = request.id;
+    ++inflightCount_;
+    // 进行中的请求数不超过slot数，提交队列不会满
+    bool pushed = ring_.PushRequest(request);
+    CHECK(pushed) << "Shm ring request queue is full, fd = " << fd_;
+    return true;
+}
+
+void NebdShmChannel::Run() {
+    uint64_t lastCheckMs = TimeUtility::GetTimeofDayMs();
+    uint64_t stopMs = 0;
+    while (true) {
+        ShmRingCompletion completion;
+        if (ring_.PopCompletion(&completion)) {
+            HandleCompletion(completion.id, completion.ret);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            // 退出前等待进行中的请求返回
+            if (inflightCount_ == 0) {
+                lastCheckMs = TimeUtility::GetTimeofDayMs();
+                if (!running_.load(std::memory_order_acquire)) {
+                    break;
+                }
+            }
+        }
+
+        // 等待有上限，part2未处理的请求不能让关闭文件一直阻塞
+        if (!running_.load(std::memory_order_acquire)) {
+            uint64_t nowMs = TimeUtility::GetTimeofDayMs();
+            if (stopMs == 0) {
+                stopMs = nowMs;
+            } else if (nowMs - stopMs >= option_.finiTimeoutMs) {
+                Cancel();
+                break;
+            }
+        }
+
+        ring_.WaitCompletion(kWaitCompletionTimeoutMs);
+
+        uint64_t nowMs = TimeUtility::GetTimeofDayMs();
+        if (nowMs - lastCheckMs >= option_.serverCheckIntervalMs) {
+            lastCheckMs = nowMs;
+            if (!IsServerAlive()) {
+                Break();
+            }
+        }
+    }
+}
+
+void NebdShmChannel::HandleCompletion(uint64_t id, int64_t ret) {
+    uint32_t slot = id & kSlotMask;
+    NebdClientAioContext* aioctx = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (slot >= inflight_.size() || inflightIds_[slot] != id ||
+            inflight_[slot] == nullptr) {
+            LOG(WARNING) << "Unknown shm ring completion, fd = " << fd_
+                         << ", id = " << id;
+            return;
+        }
+        aioctx = inflight_[slot];
+    }
+
+    if (ret == 0 && aioctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+        memcpy(aioctx->buf, ring_.SlotData(slot), aioctx->length);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        inflight_[slot] = nullptr;
+        freeSlots_.push_back(slot);
+        --inflightCount_;
+    }
+
+    if (ret == nebd::common::kShmRingResend) {
+        LOG(WARNING) << "Shm ring request failed and resend by rpc, fd = "
+                     << fd_ << ", op = " << aioctx->op
+                     << ", offset = " << aioctx->offset
+                     << ", length = " << aioctx->length;
+        fallback_(aioctx);
+        return;
+    }
+
+    if (ret != 0) {
+        LOG(ERROR) << "Shm ring request failed, fd = " << fd_
+                   << ", op = " << aioctx->op
+                   << ", offset = " << aioctx->offset
+                   << ", length = " << aioctx->length;
+    }
+    aioctx->ret = ret == 0 ? 0 : -1;
+    aioctx->cb(aioctx);
+}
+
+bool NebdShmChannel::IsServerAlive() const {
+    int32_t pid = ring_.GetServerPid();
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+void NebdShmChannel::Break() {
+    std::vector<NebdClientAioContext*> requests;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!broken_.load(std::memory_order_relaxed)) {
+            LOG(WARNING) << "nebd-server exited, shm ring of fd " << fd_
+                         << " is broken, " << inflightCount_
+                         << " inflight requests will be resent by rpc";
+        }
+        broken_.store(true, std::memory_order_release);
+        for (uint32_t slot = 0; slot < inflight_.size(); ++slot) {
+            if (inflight_[slot] != nullptr) {
+                requests.push_back(inflight_[slot]);
+                inflight_[slot] = nullptr;
+            }
+        }
+        inflightCount_ = 0;
+    }
+
+    for (auto aioctx : requests) {
+        fallback_(aioctx);
+    }
+}
+
+void NebdShmChannel::Cancel() {
+    std::vector<NebdClientAioContext*> requests;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        LOG(ERROR) << "Wait shm ring requests timeout, fd = " << fd_
+                   << ", " << inflightCount_
+                   << " inflight requests will be failed";
+        for (uint32_t slot = 0; slot < inflight_.size(); ++slot) {
+            if (inflight_[slot] != nullptr) {
+                requests.push_back(inflight_[slot]);
+                inflight_[slot] = nullptr;
+            }
+        }
+        inflightCount_ = 0;
+    }
+
+    for (auto aioctx : requests) {
+        aioctx->ret = -1;
+        aioctx->cb(aioctx);
+    }
+}
+
+}  // namespace client
+}  // namespace nebd
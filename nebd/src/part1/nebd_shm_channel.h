@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef NEBD_SRC_PART1_NEBD_SHM_CHANNEL_H_
+#define NEBD_SRC_PART1_NEBD_SHM_CHANNEL_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part1/libnebd.h"
+#include "nebd/src/part1/nebd_common.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::ShmRing;
+
+// 共享内存环不可用时，通过该函数将请求改由rpc发送
+using ShmFallbackFunc = std::function<void(NebdClientAioContext*)>;
+
+/**
+ * 单个文件在part1侧的共享内存环
+ * 读写请求的数据经slot拷贝，请求和结果经队列传递，part2无需经过brpc。
+ * 后台线程收取结果并回调；有请求进行时定期检查part2进程是否存活，
+ * part2退出后通道失效，进行中的请求及之后的请求都改由rpc发送，
+ * part2恢复后由调用者重新建立新的通道。
+ */
+class NebdShmChannel {
+ public:
+    NebdShmChannel(int fd, const ShmRingOption& option,
+                   const ShmFallbackFunc& fallback);
+    ~NebdShmChannel();
+
+    /**
+     * @brief 创建共享内存环并启动收取结果的线程
+     * @param path 共享文件路径
+     * @return 成功返回0，失败返回-1
+     */
+    int Init(const std::string& path);
+
+    /**
+     * @brief 等待进行中的请求返回并停止线程，
+     *        超过finiTimeoutMs仍未返回的请求以失败返回
+     */
+    void Fini();
+
+    /**
+     * @brief 通过共享内存环提交请求
+     * @return 成功返回true；通道失效、没有空闲slot或请求过大时返回false，
+     *         由调用者改用rpc发送
+     */
+    bool Submit(NebdClientAioContext* aioctx);
+
+    bool IsBroken() const {
+        return broken_.load(std::memory_order_acquire);
+    }
+
+ private:
+    void Run();
+    void HandleCompletion(uint64_t id, int64_t ret);
+    bool IsServerAlive() const;
+    // part2退出后将进行中的请求改由rpc发送
+    void Break();
+    // Fini超时后将进行中的请求失败返回
+    void Cancel();
+
+ private:
+    int fd_;
+    ShmRingOption option_;
+    ShmFallbackFunc fallback_;
+    ShmRing ring_;
+
+    // 保护以下成员，同时串行化提交队列的生产者
+    std::mutex mtx_;
+    std::vector<uint32_t> freeSlots_;
+    std::vector<NebdClientAioContext*> inflight_;
+    std::vector<uint64_t> inflightIds_;
+    uint32_t inflightCount_;
+    // 请求id的高32位，低32位为slot
+    uint64_t sequence_;
+
+    std::atomic<bool> broken_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+}  // namespace client
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART1_NEBD_SHM_CHANNEL_H_
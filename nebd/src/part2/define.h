@@ -122,6 +122,8 @@ const char HEARTBEATTIMEOUTSEC[] = "heartbeat.timeout.sec";
 const char HEARTBEATCHECKINTERVALMS[] = "heartbeat.check.interval.ms";
 const char CURVECLIENTCONFPATH[] = "curveclient.confPath";
 const char RESPONSERETURNRPCWHENIOERROR[] = "response.returnRpcWhenIoError";
+const char METAJOURNALENABLE[] = "meta.journal.enable";
+const char METAJOURNALCOMPACTBYTES[] = "meta.journal.compactBytes";
 
 }  // namespace server
 }  // namespace nebd
@@ -116,7 +116,7 @@ int NebdFileEntity::Close(bool removeMeta) {
     CHECK(executor_ != nullptr) << "file entity is not inited. "
                                 << "filename: " << fileName_;
     // 用于和其他用户请求互斥，避免文件被close后，请求发到后端导致返回失败
-    WriteLockGuard writeLock(rwLock_);
+    RequestDrainGuard drainGuard(requestGate_);
     // 这里的互斥锁是为了跟open请求互斥，以下情况可能导致close和open并发
     // part2重启，导致文件被reopen，然后由于超时，文件准备被close
     // 此时用户发送了挂载卷请求对文件进行open
@@ -256,9 +256,7 @@ int NebdFileEntity::ProcessSyncRequest(ProcessTask task) {
     CHECK(executor_ != nullptr) << "file entity is not inited. "
                                 << "filename: " << fileName_;
 
-    NebdRequestReadLockClosure* done =
-        new (std::nothrow) NebdRequestReadLockClosure(rwLock_);
-    brpc::ClosureGuard doneGuard(done);
+    RequestGateGuard gateGuard(requestGate_);
 
     bool isFileOpened = GuaranteeFileOpened();
     if (!isFileOpened) {
@@ -281,21 +279,21 @@ int NebdFileEntity::ProcessAsyncRequest(ProcessTask task,
                                 << "filename: " << fileName_;
     CHECK(aioctx != nullptr) << "AioContext should not be null.";
 
-    NebdRequestReadLockClosure* done =
-        new (std::nothrow) NebdRequestReadLockClosure(rwLock_);
-    brpc::ClosureGuard doneGuard(done);
-
+    requestGate_.Enter();
     bool isFileOpened = GuaranteeFileOpened();
     if (!isFileOpened) {
+        requestGate_.Exit();
         return -1;
     }
 
-    // 对于异步请求，将此closure传给aiocontext，从而在请求返回时释放读锁
-    done->SetClosure(aioctx->done);
-    aioctx->done = doneGuard.release();
+    // 对于异步请求，将此closure传给aiocontext，从而在请求返回时退出
+    NebdRequestGateClosure* done =
+        butil::get_object<NebdRequestGateClosure>();
+    done->Init(&requestGate_, aioctx->done);
+    aioctx->done = done;
     int ret = task();
     if (ret < 0) {
-        // 如果请求失败,这里要主动释放锁,并将aiocontext还原回去
+        // 如果请求失败,这里要主动退出,并将aiocontext还原回去
         brpc::ClosureGuard doneGuard(done);
         aioctx->done = done->GetClosure();
         done->SetClosure(nullptr);
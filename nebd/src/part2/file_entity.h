@@ -24,6 +24,7 @@
 #define NEBD_SRC_PART2_FILE_ENTITY_H_
 
 #include <brpc/closure_guard.h>
+#include <butil/object_pool.h>
 #include <limits.h>
 #include <memory>
 #include <string>
@@ -32,7 +33,7 @@
 #include <unordered_map>
 #include <functional>
 
-#include "nebd/src/common/rw_lock.h"
+#include "nebd/src/common/request_gate.h"
 #include "nebd/src/common/timeutility.h"
 #include "nebd/src/part2/define.h"
 #include "nebd/src/part2/util.h"
@@ -42,31 +43,40 @@
 namespace nebd {
 namespace server {
 
-using nebd::common::BthreadRWLock;
-using nebd::common::WriteLockGuard;
-using nebd::common::ReadLockGuard;
+using nebd::common::RequestGate;
+using nebd::common::RequestGateGuard;
+using nebd::common::RequestDrainGuard;
 using nebd::common::TimeUtility;
 
 class NebdFileInstance;
 class NebdRequestExecutor;
 using NebdFileInstancePtr = std::shared_ptr<NebdFileInstance>;
 
-// 处理用户请求时需要加读写锁，避免close时仍有用户IO未处理完成
-// 对于异步IO来说，只有返回时才能释放读锁，所以封装成Closure
+// 处理用户请求时需要先进入文件的RequestGate，避免close时仍有用户IO未处理完成
+// 对于异步IO来说，只有返回时才能退出，所以封装成Closure
 // 在发送异步请求前，将closure赋值给NebdServerAioContext
-class NebdRequestReadLockClosure : public Closure {
+// closure从对象池中获取，处理请求时不需要分配内存
+class NebdRequestGateClosure : public Closure {
  public:
-    explicit NebdRequestReadLockClosure(BthreadRWLock& rwLock)  // NOLINT
-        : rwLock_(rwLock)
-        , done_(nullptr) {
-        rwLock_.RDLock();
+    NebdRequestGateClosure()
+        : gate_(nullptr)
+        , done_(nullptr) {}
+    ~NebdRequestGateClosure() {}
+
+    // gate须已经Enter
+    void Init(RequestGate* gate, Closure* done) {
+        gate_ = gate;
+        done_ = done;
     }
-    ~NebdRequestReadLockClosure() {}
 
     void Run() {
-        std::unique_ptr<NebdRequestReadLockClosure> selfGuard(this);
+        // Exit之后文件可能被关闭，先将自身归还对象池
+        RequestGate* gate = gate_;
         brpc::ClosureGuard doneGuard(done_);
-        rwLock_.Unlock();
+        gate_ = nullptr;
+        done_ = nullptr;
+        butil::return_object(this);
+        gate->Exit();
     }
 
     void SetClosure(Closure* done) {
@@ -78,7 +88,7 @@ class NebdRequestReadLockClosure : public Closure {
     }
 
  private:
-    BthreadRWLock& rwLock_;
+    RequestGate* gate_;
     Closure* done_;
 };
 
@@ -181,6 +191,11 @@ class NebdFileEntity : public std::enable_shared_from_this<NebdFileEntity> {
         return status_.load();
     }
 
+    // 返回未返回的请求数，测试使用
+    int64_t GetInflightRequestCount() const {
+        return requestGate_.InflightCount();
+    }
+
  private:
     /**
      * 更新文件状态，包括元信息文件和内存状态
@@ -203,9 +218,9 @@ class NebdFileEntity : public std::enable_shared_from_this<NebdFileEntity> {
     bool GuaranteeFileOpened();
 
  private:
-    // 文件读写锁，处理请求前加读锁，close文件的时候加写锁
+    // 请求准入控制，处理请求前进入，close文件的时候等待进行中的请求结束
     // 避免close时还有请求未处理完
-    BthreadRWLock rwLock_;
+    RequestGate requestGate_;
     // 互斥锁，用于open、close之间的互斥
     bthread::Mutex fileStatusMtx_;
     // nebd server为该文件分配的唯一标识符
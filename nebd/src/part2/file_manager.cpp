@@ -20,6 +20,8 @@
  * Author: yangyaokai
  */
 
+#include <signal.h>
+#include <errno.h>
 #include <vector>
 #include <chrono>  // NOLINT
 #include <algorithm>
@@ -32,6 +34,7 @@ namespace server {
 
 NebdFileManager::NebdFileManager(MetaFileManagerPtr metaFileManager)
     : isRunning_(false)
+    , upgradePid_(0)
     , metaFileManager_(metaFileManager) {}
 
 NebdFileManager::~NebdFileManager() {}
@@ -85,7 +88,113 @@ int NebdFileManager::Load() {
     return 0;
 }
 
+void NebdFileManager::Freeze(int32_t upgradePid) {
+    // 等待正在处理的open和close结束
+    WriteLockGuard freezeLock(freezeLock_);
+    upgradePid_.store(upgradePid);
+}
+
+void NebdFileManager::Unfreeze() {
+    if (upgradePid_.exchange(0) > 0) {
+        OnUnfrozen();
+    }
+}
+
+void NebdFileManager::OnUnfrozen() {
+    int ret = metaFileManager_->Reload();
+    if (ret < 0) {
+        LOG(ERROR) << "Reload file metas after unfreeze failed.";
+    }
+}
+
+bool NebdFileManager::IsFrozen() {
+    int32_t pid = upgradePid_.load();
+    if (pid <= 0) {
+        return false;
+    }
+    // 新进程异常退出，没有机会通知本进程解除冻结
+    if (kill(pid, 0) != 0 && errno == ESRCH) {
+        LOG(WARNING) << "Upgrade process " << pid << " exited, "
+                     << "unfreeze file manager.";
+        if (upgradePid_.compare_exchange_strong(pid, 0)) {
+            OnUnfrozen();
+        }
+        return false;
+    }
+    return true;
+}
+
+int NebdFileManager::Reload() {
+    int ret = metaFileManager_->Reload();
+    if (ret < 0) {
+        LOG(ERROR) << "Reload file metas failed.";
+        return -1;
+    }
+    std::vector<NebdFileMeta> fileMetas;
+    ret = metaFileManager_->ListFileMeta(&fileMetas);
+    if (ret < 0) {
+        LOG(ERROR) << "List file metas failed.";
+        return -1;
+    }
+    std::unordered_map<int, std::string> metaMap;
+    for (const auto& fileMeta : fileMetas) {
+        metaMap.emplace(fileMeta.fd, fileMeta.fileName);
+    }
+
+    WriteLockGuard freezeLock(freezeLock_);
+    // 关闭旧进程已经关闭的文件，不修改元数据
+    for (const auto& pair : GetFileEntityMap()) {
+        auto iter = metaMap.find(pair.first);
+        if (iter != metaMap.end()
+            && iter->second == pair.second->GetFileName()) {
+            continue;
+        }
+        ret = pair.second->Close(false);
+        if (ret < 0) {
+            LOG(ERROR) << "Close file failed when reload. "
+                       << "filename: " << pair.second->GetFileName()
+                       << ", fd: " << pair.first;
+            return -1;
+        }
+        RemoveEntity(pair.first);
+        LOG(INFO) << "File closed by old nebd-server, remove entity. "
+                  << "filename: " << pair.second->GetFileName()
+                  << ", fd: " << pair.first;
+    }
+    // reopen旧进程新打开的文件
+    int maxFd = 0;
+    for (auto& fileMeta : fileMetas) {
+        maxFd = std::max(maxFd, fileMeta.fd);
+        if (GetFileEntity(fileMeta.fd) != nullptr) {
+            continue;
+        }
+        NebdFileEntityPtr entity =
+            GenerateFileEntity(fileMeta.fd, fileMeta.fileName);
+        if (entity == nullptr) {
+            LOG(ERROR) << "Generate file entity failed when reload. "
+                       << "filename: " << fileMeta.fileName
+                       << ", fd: " << fileMeta.fd;
+            return -1;
+        }
+        ret = entity->Reopen(fileMeta.xattr);
+        if (ret < 0) {
+            LOG(WARNING) << "Reopen file failed. "
+                         << "filename: " << fileMeta.fileName
+                         << ", fd: " << fileMeta.fd;
+        }
+    }
+    fdAlloc_.InitFd(maxFd);
+    LOG(INFO) << "Reload file record finished.";
+    return 0;
+}
+
 int NebdFileManager::Open(const std::string& filename) {
+    ReadLockGuard freezeLock(freezeLock_);
+    if (IsFrozen()) {
+        LOG(WARNING) << "Open file failed, file manager is frozen for "
+                     << "upgrade. filename: " << filename;
+        return -1;
+    }
     NebdFileEntityPtr entity = GetOrCreateFileEntity(filename);
     if (entity == nullptr) {
         LOG(ERROR) << "Open file failed. filename: " << filename;
@@ -95,6 +204,12 @@ int NebdFileManager::Open(const std::string& filename) {
 }
 
 int NebdFileManager::Close(int fd, bool removeRecord) {
+    ReadLockGuard freezeLock(freezeLock_);
+    if (IsFrozen()) {
+        LOG(WARNING) << "Close file failed, file manager is frozen for "
+                     << "upgrade. fd: " << fd;
+        return -1;
+    }
     NebdFileEntityPtr entity = GetFileEntity(fd);
     if (entity == nullptr) {
         LOG(WARNING) << "Close file failed. fd: " << fd;
@@ -135,6 +135,25 @@ class NebdFileManager {
     // 将所有文件状态输出到字符串
     std::string DumpAllFileStatus();
 
+    /**
+     * 热升级时冻结文件的打开和关闭，避免新进程加载元数据之后元数据发生变化
+     * 会等待正在处理的open和close请求结束后才返回
+     * 冻结期间的open和close请求返回失败，由part1重试到新进程
+     * 冻结一直持续到本进程退出，或者升级被放弃、新进程退出
+     * @param upgradePid: 新进程的pid
+     */
+    virtual void Freeze(int32_t upgradePid);
+    // 新进程放弃升级时解除冻结
+    virtual void Unfreeze();
+    // 文件的打开和关闭是否处于冻结状态
+    virtual bool IsFrozen();
+    /**
+     * 热升级时新进程接管监听地址之前，重新加载元数据并与当前打开的文件对齐
+     * 旧进程在本进程启动之后打开的文件会被reopen，关闭的文件会被close
+     * @return 成功返回0，失败返回-1
+     */
+    virtual int Reload();
+
     // set public for test
     // 启动时从metafile加载文件记录，并reopen文件
     int Load();
@@ -153,10 +172,16 @@ class NebdFileManager {
     NebdFileEntityPtr GenerateFileEntity(int fd, const std::string& fileName);
     // 删除指定fd对应的entity
     void RemoveEntity(int fd);
+    // 解除冻结后重新加载元数据，新进程加载元数据时可能已经重写了元数据文件和journal
+    void OnUnfrozen();
 
  private:
     // 当前filemanager的运行状态，true表示正在运行，false标为未运行
     std::atomic<bool> isRunning_;
+    // 冻结文件的新进程pid，0表示未冻结
+    std::atomic<int32_t> upgradePid_;
+    // open、close请求持有读锁，冻结时持有写锁，保证冻结后元数据不再变化
+    RWLock freezeLock_;
     // 文件名锁，对同名文件加锁
     NameLock nameLock_;
     // fd分配器
@@ -20,6 +20,7 @@
  * Author: yangyaokai
  */
 
+#include <errno.h>
 #include <brpc/closure_guard.h>
 #include <brpc/controller.h>
 
@@ -112,6 +113,56 @@ void NebdFileServiceCallback(NebdServerAioContext* context) {
     }
 }
 
+static void ReleaseBatch(const std::shared_ptr<NebdAioBatch>& batch) {
+    if (batch->pending.fetch_sub(1) != 1) {
+        return;
+    }
+
+    // 最后一个返回的请求负责回复rpc
+    brpc::ClosureGuard doneGuard(batch->done);
+    // for test
+    if (FLAGS_dropRpc) {
+        doneGuard.release();
+        delete batch->done;
+        LOG(ERROR) << "Batch io failed and drop the request rpc.";
+        return;
+    }
+
+    if (batch->ioError.load() && !batch->returnRpcWhenIoError) {
+        // drop the rpc to ensure not return ioerror
+        doneGuard.release();
+        delete batch->done;
+        LOG(ERROR) << "Batch io failed and drop the request rpc. "
+                   << "fd: " << batch->request->fd();
+        return;
+    }
+
+    const auto& entries = batch->request->entries();
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.Get(i).op() == nebd::client::AioBatchOp::kBatchRead &&
+            batch->response->entryretcode(i) == RetCode::kOK) {
+            batch->cntl->response_attachment().append(*batch->bufs[i]);
+        }
+    }
+    batch->response->set_retcode(RetCode::kOK);
+}
+
+void NebdBatchAioCallback(NebdServerAioContext* context) {
+    CHECK(context != nullptr);
+    std::unique_ptr<NebdBatchAioContext> contextGuard(
+        static_cast<NebdBatchAioContext*>(context));
+    // done由文件实体设置，用于在请求返回时退出文件的RequestGate
+    brpc::ClosureGuard doneGuard(context->done);
+    auto batch = contextGuard->batch;
+    if (context->ret < 0) {
+        LOG(ERROR) << *context;
+        batch->ioError.store(true);
+    } else {
+        batch->response->set_entryretcode(contextGuard->index, RetCode::kOK);
+    }
+    ReleaseBatch(batch);
+}
+
 void NebdFileServiceImpl::OpenFile(
     google::protobuf::RpcController* cntl_base,
     const nebd::client::OpenFileRequest* request,
@@ -119,6 +170,12 @@ void NebdFileServiceImpl::OpenFile(
     google::protobuf::Closure* done) {
     brpc::ClosureGuard doneGuard(done);
     response->set_retcode(RetCode::kNoOK);
+    // 热升级期间返回rpc失败，由part1重试到新进程
+    if (fileManager_->IsFrozen()) {
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+        cntl->SetFailed(EAGAIN, "nebd-server is upgrading");
+        return;
+    }
 
     int fd = fileManager_->Open(request->filename());
     if (fd > 0) {
@@ -304,6 +361,16 @@ void NebdFileServiceImpl::CloseFile(
     google::protobuf::Closure* done) {
     brpc::ClosureGuard doneGuard(done);
     response->set_retcode(RetCode::kNoOK);
+    // 热升级期间返回rpc失败，由part1重试到新进程
+    if (fileManager_->IsFrozen()) {
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+        cntl->SetFailed(EAGAIN, "nebd-server is upgrading");
+        return;
+    }
+
+    if (shmRingManager_ != nullptr) {
+        shmRingManager_->Detach(request->fd());
+    }
 
     int rc = fileManager_->Close(request->fd(), true);
     if (rc < 0) {
@@ -354,5 +421,126 @@ void NebdFileServiceImpl::InvalidateCache(
     }
 }
 
+void NebdFileServiceImpl::AttachShmRing(
+    google::protobuf::RpcController* cntl_base,
+    const nebd::client::AttachShmRingRequest* request,
+    nebd::client::AttachShmRingResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    response->set_retcode(RetCode::kNoOK);
+
+    if (shmRingManager_ == nullptr) {
+        response->set_retmsg("shm ring not supported");
+        return;
+    }
+
+    int rc = shmRingManager_->Attach(request->fd(), request->path());
+    if (rc < 0) {
+        LOG(ERROR) << "Attach shm ring failed. "
+                   << "fd: " << request->fd()
+                   << ", path: " << request->path()
+                   << ", return code: " << rc;
+    } else {
+        response->set_retcode(RetCode::kOK);
+    }
+}
+
+void NebdFileServiceImpl::DetachShmRing(
+    google::protobuf::RpcController* cntl_base,
+    const nebd::client::DetachShmRingRequest* request,
+    nebd::client::DetachShmRingResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    response->set_retcode(RetCode::kOK);
+
+    if (shmRingManager_ != nullptr) {
+        shmRingManager_->Detach(request->fd());
+    }
+}
+
+void NebdFileServiceImpl::AioBatch(
+    google::protobuf::RpcController* cntl_base,
+    const nebd::client::AioBatchRequest* request,
+    nebd::client::AioBatchResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    response->set_retcode(RetCode::kNoOK);
+
+    brpc::Controller* cntl = dynamic_cast<brpc::Controller *>(cntl_base);
+    const auto& entries = request->entries();
+    uint64_t writeSize = 0;
+    for (const auto& entry : entries) {
+        if (entry.op() == nebd::client::AioBatchOp::kBatchWrite) {
+            writeSize += entry.size();
+        }
+    }
+    if (entries.empty() || writeSize != cntl->request_attachment().size()) {
+        LOG(ERROR) << "Invalid batch request. "
+                   << "fd: " << request->fd()
+                   << ", entry count: " << entries.size()
+                   << ", write size: " << writeSize
+                   << ", attachment size: "
+                   << cntl->request_attachment().size();
+        return;
+    }
+
+    int fd = request->fd();
+    uint32_t count = entries.size();
+    // 下发线程持有一个计数，保证下发完成前不会回复rpc
+    auto batch = std::make_shared<NebdAioBatch>(count + 1);
+    batch->request = request;
+    batch->response = response;
+    batch->cntl = cntl;
+    batch->done = done;
+    batch->returnRpcWhenIoError = returnRpcWhenIoError_;
+    for (uint32_t i = 0; i < count; ++i) {
+        response->add_entryretcode(RetCode::kNoOK);
+        batch->bufs[i].reset(new butil::IOBuf());
+    }
+    doneGuard.release();
+
+    butil::IOBuf& attachment = cntl->request_attachment();
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& entry = entries.Get(i);
+        bool isWrite = entry.op() == nebd::client::AioBatchOp::kBatchWrite;
+        uint64_t offset = entry.offset();
+        uint64_t size = entry.size();
+
+        NebdBatchAioContext* aioContext
+            = new (std::nothrow) NebdBatchAioContext();
+        aioContext->offset = offset;
+        aioContext->size = size;
+        aioContext->op = isWrite ? LIBAIO_OP::LIBAIO_OP_WRITE
+                                 : LIBAIO_OP::LIBAIO_OP_READ;
+        aioContext->cb = NebdBatchAioCallback;
+        aioContext->returnRpcWhenIoError = returnRpcWhenIoError_;
+        aioContext->buf = batch->bufs[i].get();
+        aioContext->response = response;
+        // rpc的done由batch中最后返回的请求执行
+        aioContext->done = nullptr;
+        aioContext->cntl = cntl_base;
+        aioContext->batch = batch;
+        aioContext->index = i;
+        if (isWrite) {
+            attachment.cutn(batch->bufs[i].get(), size);
+        }
+
+        int rc = isWrite ? fileManager_->AioWrite(fd, aioContext)
+                         : fileManager_->AioRead(fd, aioContext);
+        if (rc < 0) {
+            LOG(ERROR) << Op2Str(aioContext->op) << " file failed. "
+                       << "fd: " << fd
+                       << ", offset: " << offset
+                       << ", size: " << size
+                       << ", return code: " << rc;
+            delete aioContext;
+            // 下发失败的请求直接返回错误码，不需要丢弃整个rpc
+            ReleaseBatch(batch);
+        }
+    }
+
+    ReleaseBatch(batch);
+}
+
 }  // namespace server
 }  // namespace nebd
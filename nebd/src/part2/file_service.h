@@ -23,26 +23,60 @@
 #ifndef NEBD_SRC_PART2_FILE_SERVICE_H_
 #define NEBD_SRC_PART2_FILE_SERVICE_H_
 
+#include <brpc/controller.h>
+#include <butil/iobuf.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <memory>
 
 #include "nebd/proto/client.pb.h"
 #include "nebd/src/part2/file_manager.h"
+#include "nebd/src/part2/shm_ring_service.h"
 
 namespace nebd {
 namespace server {
 
 void NebdFileServiceCallback(NebdServerAioContext* context);
 
+// 一次AioBatch rpc中的全部请求，最后一个请求返回后回复rpc
+struct NebdAioBatch {
+    explicit NebdAioBatch(size_t count)
+        : pending(count), ioError(false), bufs(count) {}
+
+    // 未返回的请求数，下发请求的线程也持有一个计数
+    std::atomic<size_t> pending;
+    // 是否有请求在执行过程中出错
+    std::atomic<bool> ioError;
+    // 各请求的数据
+    std::vector<std::unique_ptr<butil::IOBuf>> bufs;
+
+    const nebd::client::AioBatchRequest* request = nullptr;
+    nebd::client::AioBatchResponse* response = nullptr;
+    brpc::Controller* cntl = nullptr;
+    google::protobuf::Closure* done = nullptr;
+    bool returnRpcWhenIoError = false;
+};
+
+struct NebdBatchAioContext : public NebdServerAioContext {
+    std::shared_ptr<NebdAioBatch> batch;
+    // 请求在batch中的下标
+    uint32_t index = 0;
+};
+
+void NebdBatchAioCallback(NebdServerAioContext* context);
+
 class NebdFileServiceImpl : public nebd::client::NebdFileService {
  public:
     explicit NebdFileServiceImpl(std::shared_ptr<NebdFileManager> fileManager,
-                                 const bool returnRpcWhenIoError)
+                                 const bool returnRpcWhenIoError,
+                                 std::shared_ptr<NebdShmRingManager>
+                                     shmRingManager = nullptr)
                                  : fileManager_(fileManager),
-                                 returnRpcWhenIoError_(returnRpcWhenIoError) {}
+                                 returnRpcWhenIoError_(returnRpcWhenIoError),
+                                 shmRingManager_(shmRingManager) {}
 
     virtual ~NebdFileServiceImpl() {}
 
@@ -91,9 +125,26 @@ class NebdFileServiceImpl : public nebd::client::NebdFileService {
                             nebd::client::InvalidateCacheResponse* response,
                             google::protobuf::Closure* done);
 
+    virtual void AttachShmRing(google::protobuf::RpcController* cntl_base,
+                            const nebd::client::AttachShmRingRequest* request,
+                            nebd::client::AttachShmRingResponse* response,
+                            google::protobuf::Closure* done);
+
+    virtual void DetachShmRing(google::protobuf::RpcController* cntl_base,
+                            const nebd::client::DetachShmRingRequest* request,
+                            nebd::client::DetachShmRingResponse* response,
+                            google::protobuf::Closure* done);
+
+    virtual void AioBatch(google::protobuf::RpcController* cntl_base,
+                          const nebd::client::AioBatchRequest* request,
+                          nebd::client::AioBatchResponse* response,
+                          google::protobuf::Closure* done);
+
  private:
     std::shared_ptr<NebdFileManager> fileManager_;
     const bool returnRpcWhenIoError_;
+    // 为空时不支持共享内存环，part1只能使用rpc
+    std::shared_ptr<NebdShmRingManager> shmRingManager_;
 };
 
 }  // namespace server
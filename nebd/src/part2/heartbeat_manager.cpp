@@ -84,6 +84,11 @@ void HeartbeatManager::CheckTimeoutFunc() {
         LOG_EVERY_N(INFO, 60 * 1000 / checkTimeoutIntervalMs_)
             << "Checking timeout, file status: "
             << fileManager_->DumpAllFileStatus();
+        // 热升级期间文件由新进程接管，不再关闭超时的文件
+        if (fileManager_->IsFrozen()) {
+            RemoveTimeoutNebdClient();
+            continue;
+        }
         FileEntityMap fileEntityMap = fileManager_->GetFileEntityMap();
         NebdFileEntityPtr curEntity;
         for (const auto& entityPair : fileEntityMap) {
@@ -40,11 +40,11 @@ int main(int argc, char* argv[]) {
         LOG(ERROR) <<  "init nebd server fail";
         return -1;
     }
-    server->RunUntilAskedToQuit();
+    int runRes = server->RunUntilAskedToQuit();
 
     // 停止nebd server
     server->Fini();
 
     google::ShutdownGoogleLogging();
-    return 0;
+    return runRes;
 }
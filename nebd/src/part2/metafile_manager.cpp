@@ -32,25 +32,86 @@ namespace server {
 NebdMetaFileManager::NebdMetaFileManager()
     : metaFilePath_("")
     , wrapper_(nullptr)
-    , parser_(nullptr) {}
+    , parser_(nullptr)
+    , enableJournal_(false)
+    , journalCompactBytes_(0)
+    , journalFd_(-1)
+    , journalSize_(0)
+    , journalBroken_(false)
+    , journalCommitting_(false) {}
 
-NebdMetaFileManager::~NebdMetaFileManager() {}
+NebdMetaFileManager::~NebdMetaFileManager() {
+    if (journalFd_ >= 0) {
+        wrapper_->close(journalFd_);
+        journalFd_ = -1;
+    }
+}
 
 int NebdMetaFileManager::Init(const NebdMetaFileManagerOption& option) {
     metaFilePath_ = option.metaFilePath;
     wrapper_ = option.wrapper;
     parser_ = option.parser;
+    enableJournal_ = option.enableJournal;
+    journalCompactBytes_ = option.journalCompactBytes;
+    journalPath_ = metaFilePath_ + ".journal";
+    return Recover();
+}
+
+int NebdMetaFileManager::Reload() {
+    // 取得journal写入权，避免和本进程的写入交错
+    std::unique_lock<std::mutex> lock(journalMtx_);
+    journalCond_.wait(lock, [this] { return !journalCommitting_; });
+    journalCommitting_ = true;
+    lock.unlock();
+    int ret = Recover();
+    lock.lock();
+    journalCommitting_ = false;
+    journalCond_.notify_all();
+    return ret;
+}
+
+int NebdMetaFileManager::Recover() {
     int ret = LoadFileMeta();
     if (ret < 0) {
         LOG(ERROR) << "Load file meta from " << metaFilePath_ << " failed.";
         return -1;
     }
-    LOG(INFO) << "Init metafilemanager success.";
+
+    // 关闭journal后启动时也需要重放之前留下的journal
+    int replayed = ReplayJournal();
+    if (replayed < 0) {
+        LOG(ERROR) << "Replay journal " << journalPath_ << " failed.";
+        return -1;
+    }
+
+    if (enableJournal_) {
+        durableMetas_ = metaCache_;
+        if (CompactJournal() != 0) {
+            LOG(ERROR) << "Compact journal " << journalPath_ << " failed.";
+            return -1;
+        }
+    } else if (replayed > 0) {
+        if (UpdateMetaFile(metaCache_) != 0) {
+            LOG(ERROR) << "Save replayed file meta failed.";
+            return -1;
+        }
+        wrapper_->remove(journalPath_.c_str());
+    }
+    LOG(INFO) << "Load metafile success, journal enabled: "
+              << enableJournal_ << ", replayed records: " << replayed;
     return 0;
 }
 
 int NebdMetaFileManager::UpdateFileMeta(const std::string& fileName,
                                         const NebdFileMeta& fileMeta) {
+    if (enableJournal_) {
+        NebdMetaJournalRecord record;
+        record.op = MetaJournalOp::kUpdate;
+        record.fileName = fileName;
+        record.meta = fileMeta;
+        return CommitRecord(record);
+    }
+
     WriteLockGuard writeLock(rwLock_);
     bool needUpdate = metaCache_.find(fileName) == metaCache_.end()
                       || fileMeta != metaCache_[fileName];
@@ -74,6 +135,13 @@ int NebdMetaFileManager::UpdateFileMeta(const std::string& fileName,
 }
 
 int NebdMetaFileManager::RemoveFileMeta(const std::string& fileName) {
+    if (enableJournal_) {
+        NebdMetaJournalRecord record;
+        record.op = MetaJournalOp::kRemove;
+        record.fileName = fileName;
+        return CommitRecord(record);
+    }
+
     WriteLockGuard writeLock(rwLock_);
     bool isExist = metaCache_.find(fileName) != metaCache_.end();
     if (!isExist) {
@@ -117,29 +185,56 @@ int NebdMetaFileManager::AtomicWriteFile(const Json::Value& root) {
     std::string jsonString = root.toStyledString();
     int writeSize = wrapper_->pwrite(fd, jsonString.c_str(),
                                      jsonString.size(), 0);
-    wrapper_->close(fd);
     if (writeSize != jsonString.size()) {
+        wrapper_->close(fd);
         LOG(ERROR) << "Write tmp file " << tmpFilePath << " fail";
         return -1;
     }
+    // 合并journal后会清空journal，元数据文件必须先落盘
+    int res = wrapper_->fsync(fd);
+    wrapper_->close(fd);
+    if (res != 0) {
+        LOG(ERROR) << "Sync tmp file " << tmpFilePath << " fail";
+        return -1;
+    }
 
     // 重命名
-    int res = wrapper_->rename(tmpFilePath.c_str(), metaFilePath_.c_str());
+    res = wrapper_->rename(tmpFilePath.c_str(), metaFilePath_.c_str());
     if (res != 0) {
         LOG(ERROR) << "rename file " << tmpFilePath << " to "
                    << metaFilePath_ << " fail";
         return -1;
     }
+
+    // rename之后还需要sync所在目录，否则掉电后可能回到旧的元数据文件，
+    // 而journal在合并后已经被清空
+    std::string dirPath = ".";
+    size_t pos = metaFilePath_.find_last_of('/');
+    if (pos != std::string::npos) {
+        dirPath = pos == 0 ? "/" : metaFilePath_.substr(0, pos);
+    }
+    int dirFd = wrapper_->open(dirPath.c_str(), O_RDONLY|O_DIRECTORY, 0);
+    if (dirFd < 0) {
+        LOG(ERROR) << "Open dir " << dirPath << " fail";
+        return -1;
+    }
+    res = wrapper_->fsync(dirFd);
+    wrapper_->close(dirFd);
+    if (res != 0) {
+        LOG(ERROR) << "Sync dir " << dirPath << " fail";
+        return -1;
+    }
     return 0;
 }
 
 int NebdMetaFileManager::LoadFileMeta() {
-    ReadLockGuard readLock(rwLock_);
+    WriteLockGuard writeLock(rwLock_);
     FileMetaMap tempMetas;
     std::ifstream in(metaFilePath_, std::ios::binary);
     if (!in) {
         // 这里不应该返回错误，第一次初始化的时候文件可能还未创建
         LOG(WARNING) << "File not exist: " << metaFilePath_;
+        metaCache_.clear();
         return 0;
     }
 
@@ -163,6 +258,175 @@ int NebdMetaFileManager::LoadFileMeta() {
     return 0;
 }
 
+int NebdMetaFileManager::ReplayJournal() {
+    std::ifstream in(journalPath_, std::ios::binary);
+    if (!in) {
+        return 0;
+    }
+
+    WriteLockGuard writeLock(rwLock_);
+    int replayed = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        NebdMetaJournalRecord record;
+        // 最后一次写入可能不完整，之后的记录都没有返回成功；
+        // 如果解析失败的不是最后一条记录，说明journal已经损坏，
+        // 同样在这里停止重放，不能跳过损坏的记录继续应用
+        if (parser_->ParseRecord(line, &record) != 0) {
+            if (in.peek() != EOF) {
+                LOG(ERROR) << "Journal " << journalPath_
+                           << " is corrupted after " << replayed
+                           << " records, stop replay.";
+            } else {
+                LOG(WARNING) << "Journal " << journalPath_
+                             << " is truncated after " << replayed
+                             << " records.";
+            }
+            break;
+        }
+        ApplyRecord(record, &metaCache_);
+        ++replayed;
+    }
+    return replayed;
+}
+
+int NebdMetaFileManager::CommitRecord(const NebdMetaJournalRecord& record) {
+    bool existed = false;
+    NebdFileMeta oldMeta;
+    {
+        WriteLockGuard writeLock(rwLock_);
+        auto iter = metaCache_.find(record.fileName);
+        existed = iter != metaCache_.end();
+        // 如果元数据信息没发生变更，则不需要写journal
+        if (record.op == MetaJournalOp::kUpdate && existed &&
+            iter->second == record.meta) {
+            return 0;
+        }
+        if (record.op == MetaJournalOp::kRemove && !existed) {
+            return 0;
+        }
+        if (existed) {
+            oldMeta = iter->second;
+        }
+        ApplyRecord(record, &metaCache_);
+    }
+
+    int res = AppendJournal(record);
+    if (res != 0) {
+        WriteLockGuard writeLock(rwLock_);
+        if (existed) {
+            metaCache_[record.fileName] = oldMeta;
+        } else {
+            metaCache_.erase(record.fileName);
+        }
+        LOG(ERROR) << "Append journal failed, fileName: " << record.fileName;
+        return -1;
+    }
+
+    if (record.op == MetaJournalOp::kUpdate) {
+        LOG(INFO) << "Update file meta success. "
+                  << "file meta: " << record.meta;
+    } else {
+        LOG(INFO) << "Remove file meta success. "
+                  << "file name: " << record.fileName;
+    }
+    return 0;
+}
+
+int NebdMetaFileManager::AppendJournal(const NebdMetaJournalRecord& record) {
+    JournalWaiter waiter;
+    waiter.record = record;
+    waiter.data = parser_->ConvertRecordToString(record);
+
+    std::unique_lock<std::mutex> lock(journalMtx_);
+    pendingWaiters_.push_back(&waiter);
+    while (!waiter.done) {
+        if (journalCommitting_) {
+            journalCond_.wait(lock);
+            continue;
+        }
+
+        // 取得写入权，将等待中的变更一次写入
+        std::vector<JournalWaiter*> batch;
+        batch.swap(pendingWaiters_);
+        journalCommitting_ = true;
+        lock.unlock();
+        int res = WriteJournal(batch);
+        lock.lock();
+        journalCommitting_ = false;
+        for (auto w : batch) {
+            w->ret = res;
+            w->done = true;
+        }
+        journalCond_.notify_all();
+    }
+    return waiter.ret;
+}
+
+int NebdMetaFileManager::WriteJournal(
+    const std::vector<JournalWaiter*>& batch) {
+    if (journalBroken_ && CompactJournal() != 0) {
+        return -1;
+    }
+
+    std::string data;
+    for (auto waiter : batch) {
+        data.append(waiter->data);
+    }
+    ssize_t writeSize = wrapper_->pwrite(journalFd_, data.c_str(),
+                                         data.size(), journalSize_);
+    if (writeSize != static_cast<ssize_t>(data.size()) ||
+        wrapper_->fsync(journalFd_) != 0) {
+        LOG(ERROR) << "Write journal " << journalPath_ << " fail, "
+                   << "offset: " << journalSize_
+                   << ", length: " << data.size();
+        journalBroken_ = true;
+        return -1;
+    }
+    journalSize_ += data.size();
+    for (auto waiter : batch) {
+        ApplyRecord(waiter->record, &durableMetas_);
+    }
+
+    // 变更已经持久化，合并失败不影响本次写入的结果
+    if (journalSize_ >= journalCompactBytes_ && CompactJournal() != 0) {
+        LOG(WARNING) << "Compact journal " << journalPath_ << " fail";
+    }
+    return 0;
+}
+
+int NebdMetaFileManager::CompactJournal() {
+    int res = UpdateMetaFile(durableMetas_);
+    if (res != 0) {
+        journalBroken_ = true;
+        return -1;
+    }
+
+    // 元数据文件已包含journal中的全部变更，重建空的journal
+    if (journalFd_ >= 0) {
+        wrapper_->close(journalFd_);
+    }
+    journalFd_ = wrapper_->open(journalPath_.c_str(),
+                                O_CREAT|O_RDWR|O_TRUNC, 0644);
+    if (journalFd_ < 0) {
+        LOG(ERROR) << "Open journal " << journalPath_ << " fail";
+        journalBroken_ = true;
+        return -1;
+    }
+    journalSize_ = 0;
+    journalBroken_ = false;
+    return 0;
+}
+
+void NebdMetaFileManager::ApplyRecord(const NebdMetaJournalRecord& record,
+                                      FileMetaMap* fileMetas) {
+    if (record.op == MetaJournalOp::kUpdate) {
+        (*fileMetas)[record.fileName] = record.meta;
+    } else {
+        fileMetas->erase(record.fileName);
+    }
+}
+
 int NebdMetaFileManager::ListFileMeta(std::vector<NebdFileMeta>* fileMetas) {
     CHECK(fileMetas != nullptr) << "fileMetas is nullptr.";
     ReadLockGuard readLock(rwLock_);
@@ -261,5 +525,88 @@ Json::Value NebdMetaFileParser::ConvertFileMetasToJson(
     return root;
 }
 
+std::string NebdMetaFileParser::ConvertRecordToString(
+                        const NebdMetaJournalRecord& record) {
+    Json::Value root;
+    root[kOp] = static_cast<int>(record.op);
+    root[kFileName] = record.fileName;
+    if (record.op == MetaJournalOp::kUpdate) {
+        root[kFd] = record.meta.fd;
+        for (const auto& item : record.meta.xattr) {
+            root[item.first] = item.second;
+        }
+    }
+
+    // FastWriter输出单行并以换行结尾
+    Json::FastWriter writer;
+    std::string jsonString = writer.write(root);
+    root[kCRC] = nebd::common::CRC32(jsonString.c_str(), jsonString.size());
+    return writer.write(root);
+}
+
+int NebdMetaFileParser::ParseRecord(const std::string& line,
+                                    NebdMetaJournalRecord* record) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    JSONCPP_STRING errs;
+    if (!reader->parse(line.data(), line.data() + line.size(),
+                       &root, &errs)) {
+        LOG(ERROR) << "Parse journal record fail: " << errs;
+        return -1;
+    }
+
+    if (!root.isObject() || root[kCRC].isNull()) {
+        LOG(ERROR) << "Parse journal record: " << line << " fail, no crc";
+        return -1;
+    }
+    uint32_t crcValue = root[kCRC].asUInt();
+    root.removeMember(kCRC);
+    Json::FastWriter writer;
+    std::string jsonString = writer.write(root);
+    uint32_t crcCalc = nebd::common::CRC32(jsonString.c_str(),
+                                           jsonString.size());
+    if (crcValue != crcCalc) {
+        LOG(ERROR) << "Parse journal record: " << line
+                   << " fail, crc not match";
+        return -1;
+    }
+
+    if (root[kOp].isNull() || root[kFileName].isNull()) {
+        LOG(ERROR) << "Parse journal record: " << line
+                   << " fail, no op or filename";
+        return -1;
+    }
+    // 未知的op说明记录已经损坏，不能当作remove处理
+    int op = root[kOp].isInt() ? root[kOp].asInt() : -1;
+    if (op != static_cast<int>(MetaJournalOp::kUpdate) &&
+        op != static_cast<int>(MetaJournalOp::kRemove)) {
+        LOG(ERROR) << "Parse journal record: " << line
+                   << " fail, unknown op";
+        return -1;
+    }
+    record->op = static_cast<MetaJournalOp>(op);
+    record->fileName = root[kFileName].asString();
+    if (record->op != MetaJournalOp::kUpdate) {
+        return 0;
+    }
+
+    if (root[kFd].isNull()) {
+        LOG(ERROR) << "Parse journal record: " << line << " fail, no fd";
+        return -1;
+    }
+    record->meta.fileName = record->fileName;
+    record->meta.fd = root[kFd].asInt();
+    record->meta.xattr.clear();
+    // 除了op、filename和fd的部分统一放到xattr里面
+    for (const auto& name : root.getMemberNames()) {
+        if (name == kOp || name == kFileName || name == kFd) {
+            continue;
+        }
+        record->meta.xattr.emplace(name, root[name].asString());
+    }
+    return 0;
+}
+
 }  // namespace server
 }  // namespace nebd
@@ -24,6 +24,7 @@
 #define NEBD_SRC_PART2_METAFILE_MANAGER_H_
 
 #include <json/json.h>
+#include <condition_variable>  // NOLINT
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -50,12 +51,30 @@ const char kVolumes[] = "volumes";
 const char kFileName[] = "filename";
 const char kFd[] = "fd";
 const char kCRC[] = "crc";
+const char kOp[] = "op";
+
+// journal中记录的元数据变更
+enum class MetaJournalOp {
+    kUpdate = 0,
+    kRemove = 1,
+};
+
+struct NebdMetaJournalRecord {
+    MetaJournalOp op;
+    std::string fileName;
+    // op为kUpdate时有效
+    NebdFileMeta meta;
+};
 
 class NebdMetaFileParser {
  public:
     int Parse(Json::Value root,
               FileMetaMap* fileMetas);
     Json::Value ConvertFileMetasToJson(const FileMetaMap& fileMetas);
+
+    // journal记录与字符串之间的转换，每条记录占一行并带有crc
+    std::string ConvertRecordToString(const NebdMetaJournalRecord& record);
+    int ParseRecord(const std::string& line, NebdMetaJournalRecord* record);
 };
 
 struct NebdMetaFileManagerOption {
@@ -64,6 +83,10 @@ struct NebdMetaFileManagerOption {
         = std::make_shared<PosixWrapper>();
     std::shared_ptr<NebdMetaFileParser> parser
         = std::make_shared<NebdMetaFileParser>();
+    // 是否先将变更追加到journal，再定期合并到元数据文件
+    bool enableJournal = false;
+    // journal超过该大小后合并到元数据文件
+    uint64_t journalCompactBytes = 4 * 1024 * 1024;
 };
 
 class NebdMetaFileManager {
@@ -84,13 +107,39 @@ class NebdMetaFileManager {
     // 删除文件元数据
     virtual int RemoveFileMeta(const std::string& fileName);
 
+    // 重新从文件读取元数据，热升级时元数据文件和journal可能被另一个进程重写
+    virtual int Reload();
+
  private:
+    // 等待写入journal的变更
+    struct JournalWaiter {
+        NebdMetaJournalRecord record;
+        std::string data;
+        bool done = false;
+        int ret = 0;
+    };
+
     // 原子写文件
     int AtomicWriteFile(const Json::Value& root);
     // 更新元数据文件并更新内存缓存
     int UpdateMetaFile(const FileMetaMap& fileMetas);
     // 初始化从持久化文件读取到内存
     int LoadFileMeta();
+    // 读取元数据文件并重放journal，之后重建journal
+    int Recover();
+
+    // 重放上次退出前journal中的变更，返回重放的记录数，失败返回-1
+    int ReplayJournal();
+    // 更新内存缓存并写入journal，写入失败时回滚内存缓存
+    int CommitRecord(const NebdMetaJournalRecord& record);
+    // 将变更追加到journal，并发的变更合并为一次写入和fsync
+    int AppendJournal(const NebdMetaJournalRecord& record);
+    // 写入一批变更，同一时刻只有一个线程调用
+    int WriteJournal(const std::vector<JournalWaiter*>& batch);
+    // 将已持久化的元数据写入元数据文件，并清空journal
+    int CompactJournal();
+    static void ApplyRecord(const NebdMetaJournalRecord& record,
+                            FileMetaMap* fileMetas);
 
  private:
     // 元数据文件路径
@@ -103,6 +152,25 @@ class NebdMetaFileManager {
     RWLock rwLock_;
     // meta文件内存缓存
     FileMetaMap metaCache_;
+
+    // journal文件路径，为元数据文件路径加上.journal后缀
+    std::string journalPath_;
+    bool enableJournal_;
+    uint64_t journalCompactBytes_;
+
+    // 以下成员只由持有写入权的线程访问
+    int journalFd_;
+    uint64_t journalSize_;
+    // 写入失败后journal尾部可能有残留数据，下次写入前先合并
+    bool journalBroken_;
+    // 已写入journal或元数据文件的元数据
+    FileMetaMap durableMetas_;
+
+    // 保护等待队列和写入权
+    std::mutex journalMtx_;
+    std::condition_variable journalCond_;
+    std::vector<JournalWaiter*> pendingWaiters_;
+    bool journalCommitting_;
 };
 using MetaFileManagerPtr = std::shared_ptr<NebdMetaFileManager>;
 
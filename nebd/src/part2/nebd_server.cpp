@@ -20,16 +20,34 @@
  * Author: lixiaocui
  */
 
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <brpc/channel.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <memory>
 #include "nebd/src/common/file_lock.h"
+#include "nebd/src/common/timeutility.h"
 #include "nebd/src/part2/nebd_server.h"
 #include "nebd/src/part2/file_service.h"
 #include "nebd/src/part2/heartbeat_service.h"
+#include "nebd/src/part2/upgrade_service.h"
 #include "nebd/src/common/nebd_version.h"
 
+DEFINE_bool(upgrade, false, "take over the running nebd-server without "
+            "interrupting inflight io");
+DEFINE_uint32(upgradeTimeoutMs, 30000, "max time to wait for the old "
+              "nebd-server to exit during upgrade");
+
 namespace nebd {
 namespace server {
+
+using nebd::common::TimeUtility;
+
+// 等待旧进程退出时的检查间隔
+const uint32_t kWaitOldServerIntervalMs = 10;
 int NebdServer::Init(const std::string &confPath,
     std::shared_ptr<CurveClient> curveClient) {
     if (isRunning_) {
@@ -51,10 +69,21 @@ int NebdServer::Init(const std::string &confPath,
     }
     LOG(INFO) << "NebdServer init socket file address ok";
 
+    // 热升级时需要在加载元数据之前冻结旧进程，保证两个进程看到的元数据一致
+    if (FLAGS_upgrade) {
+        if (false == PrepareUpgrade()) {
+            LOG(ERROR) << "NebdServer prepare upgrade fail";
+            return -1;
+        }
+        LOG(INFO) << "NebdServer prepare upgrade ok, old server pid: "
+                  << oldServerPid_;
+    }
+
     curveClient_ = curveClient;
     bool initExecutorOk = InitCurveRequestExecutor();
     if (false == initExecutorOk) {
         LOG(ERROR) << "NebdServer init curveRequestExecutor fail";
+        AbortUpgrade();
         return -1;
     }
     LOG(INFO) << "NebdServer init curveRequestExecutor ok";
@@ -62,6 +91,7 @@ int NebdServer::Init(const std::string &confPath,
     bool initFileManagerOk = InitFileManager();
     if (false == initFileManagerOk) {
         LOG(ERROR) << "NebdServer init fileManager fail";
+        AbortUpgrade();
         return -1;
     }
     LOG(INFO) << "NebdServer init fileManager ok";
@@ -69,6 +99,7 @@ int NebdServer::Init(const std::string &confPath,
     bool initHeartbeatManagerOk = InitHeartbeatManager();
     if (false == initHeartbeatManagerOk) {
         LOG(ERROR) << "NebdServer init heartbeatManager fail";
+        AbortUpgrade();
         return -1;
     }
     LOG(INFO) << "NebdServer init heartbeatManager ok";
@@ -83,6 +114,7 @@ int NebdServer::Init(const std::string &confPath,
 int NebdServer::RunUntilAskedToQuit() {
     if (false == StartServer()) {
         LOG(INFO) << "start server fail";
+        AbortUpgrade();
         return -1;
     }
 
@@ -159,6 +191,10 @@ MetaFileManagerPtr NebdServer::InitMetaFileManager() {
     if (false == getOk) {
         return nullptr;
     }
+    // journal相关配置项可选，未配置时使用默认值
+    conf_.GetBoolValue(METAJOURNALENABLE, &option.enableJournal);
+    conf_.GetUInt64Value(METAJOURNALCOMPACTBYTES,
+                         &option.journalCompactBytes);
 
     MetaFileManagerPtr metaFileManager =
         std::make_shared<NebdMetaFileManager>();
@@ -208,6 +244,112 @@ bool NebdServer::InitHeartbeatManager() {
     return true;
 }
 
+bool NebdServer::PrepareUpgrade() {
+    brpc::Channel channel;
+    if (channel.InitWithSockFile(listenAddress_.c_str(), nullptr) != 0) {
+        LOG(ERROR) << "Init channel to old nebd-server failed, address: "
+                   << listenAddress_;
+        return false;
+    }
+
+    nebd::client::NebdUpgradeService_Stub stub(&channel);
+    nebd::client::PrepareUpgradeRequest request;
+    nebd::client::PrepareUpgradeResponse response;
+    brpc::Controller cntl;
+    request.set_pid(getpid());
+    stub.PrepareUpgrade(&cntl, &request, &response, nullptr);
+    if (cntl.Failed()) {
+        LOG(ERROR) << "PrepareUpgrade rpc failed, error: "
+                   << cntl.ErrorText();
+        return false;
+    }
+    if (response.retcode() != nebd::client::RetCode::kOK ||
+        !response.has_pid()) {
+        LOG(ERROR) << "PrepareUpgrade failed, retcode: "
+                   << response.retcode();
+        return false;
+    }
+
+    oldServerPid_ = response.pid();
+    return true;
+}
+
+void NebdServer::AbortUpgrade() {
+    // 接管监听地址之后旧进程已经开始退出，不能再恢复
+    if (!FLAGS_upgrade || oldServerPid_ <= 0 || tookOver_) {
+        return;
+    }
+
+    brpc::Channel channel;
+    if (channel.InitWithSockFile(listenAddress_.c_str(), nullptr) != 0) {
+        LOG(WARNING) << "Init channel to old nebd-server failed, address: "
+                     << listenAddress_;
+        return;
+    }
+    nebd::client::NebdUpgradeService_Stub stub(&channel);
+    nebd::client::AbortUpgradeRequest request;
+    nebd::client::AbortUpgradeResponse response;
+    brpc::Controller cntl;
+    stub.AbortUpgrade(&cntl, &request, &response, nullptr);
+    // 通知失败时旧进程会在本进程退出后自动解除冻结
+    if (cntl.Failed()) {
+        LOG(WARNING) << "AbortUpgrade rpc failed, error: "
+                     << cntl.ErrorText();
+        return;
+    }
+    LOG(INFO) << "Abort upgrade, old server pid: " << oldServerPid_;
+}
+
+bool NebdServer::TakeOverListenAddress(const brpc::ServerOptions& option) {
+    // 先在临时地址上启动，再原子地替换监听地址，
+    // 新的连接都会到达本进程，旧进程上已有的连接不受影响
+    std::string upgradeAddress = listenAddress_ + ".upgrade";
+    int ret = server_.StartAtSockFile(upgradeAddress.c_str(), &option);
+    if (0 != ret) {
+        LOG(ERROR) << "NebdServer start brpc server at " << upgradeAddress
+                   << " fail, res=" << ret;
+        return false;
+    }
+    // 本进程启动期间旧进程可能改写了元数据文件和journal，
+    // 在旧进程退出前重新加载，之后旧进程不会再修改元数据
+    if (fileManager_->Reload() != 0) {
+        LOG(ERROR) << "Reload file manager before take over fail";
+        server_.Stop(0);
+        server_.Join();
+        unlink(upgradeAddress.c_str());
+        return false;
+    }
+    if (rename(upgradeAddress.c_str(), listenAddress_.c_str()) != 0) {
+        LOG(ERROR) << "Rename " << upgradeAddress << " to " << listenAddress_
+                   << " fail, errno: " << errno;
+        server_.Stop(0);
+        server_.Join();
+        unlink(upgradeAddress.c_str());
+        return false;
+    }
+    tookOver_ = true;
+
+    // 旧进程收到SIGTERM后停止brpc server，会等待进行中的请求返回再退出
+    if (kill(oldServerPid_, SIGTERM) != 0 && errno != ESRCH) {
+        LOG(ERROR) << "Send SIGTERM to old nebd-server fail, pid: "
+                   << oldServerPid_ << ", errno: " << errno;
+        server_.Stop(0);
+        server_.Join();
+        return false;
+    }
+    uint64_t deadline = TimeUtility::GetTimeofDayMs() + FLAGS_upgradeTimeoutMs;
+    while (kill(oldServerPid_, 0) == 0) {
+        if (TimeUtility::GetTimeofDayMs() >= deadline) {
+            LOG(WARNING) << "Old nebd-server does not exit in "
+                         << FLAGS_upgradeTimeoutMs << " ms, pid: "
+                         << oldServerPid_;
+            break;
+        }
+        usleep(kWaitOldServerIntervalMs * 1000);
+    }
+    return true;
+}
+
 bool NebdServer::StartServer() {
     // add service
     bool returnRpcWhenIoError;
@@ -218,7 +360,10 @@ bool NebdServer::StartServer() {
         return false;
     }
 
-    NebdFileServiceImpl fileService(fileManager_, returnRpcWhenIoError);
+    auto shmRingManager = std::make_shared<NebdShmRingManager>(
+        fileManager_, returnRpcWhenIoError);
+    NebdFileServiceImpl fileService(fileManager_, returnRpcWhenIoError,
+                                    shmRingManager);
     int addFileServiceRes = server_.AddService(
         &fileService, brpc::SERVER_DOESNT_OWN_SERVICE);
     if (0 != addFileServiceRes) {
@@ -234,27 +379,54 @@ bool NebdServer::StartServer() {
         return false;
     }
 
+    NebdUpgradeServiceImpl upgradeService(fileManager_);
+    addFileServiceRes = server_.AddService(
+        &upgradeService, brpc::SERVER_DOESNT_OWN_SERVICE);
+    if (0 != addFileServiceRes) {
+        LOG(ERROR) << "NebdServer add upgrade service fail";
+        return false;
+    }
+
     // start brcp server
     brpc::ServerOptions option;
     option.idle_timeout_sec = -1;
-    // 获取文件锁
     common::FileLock fileLock(listenAddress_ + ".lock");
-    if (fileLock.AcquireFileLock() != 0) {
-        LOG(ERROR) << "Address already in use";
-        return -1;
-    }
-    int startBrpcServerRes = server_.StartAtSockFile(
-                                    listenAddress_.c_str(), &option);
-    if (0 != startBrpcServerRes) {
-        LOG(ERROR) << "NebdServer start brpc server fail, res="
-            << startBrpcServerRes;
-        return false;
+    if (FLAGS_upgrade) {
+        if (false == TakeOverListenAddress(option)) {
+            LOG(ERROR) << "NebdServer take over listen address fail";
+            return false;
+        }
+        // 旧进程退出后文件锁才会释放，拿不到锁说明旧进程还在，
+        // 两个进程同时修改元数据会导致元数据损坏，只能退出
+        if (fileLock.AcquireFileLock() != 0) {
+            LOG(ERROR) << "Acquire file lock fail after upgrade, old "
+                       << "nebd-server may be still running, pid: "
+                       << oldServerPid_;
+            server_.Stop(0);
+            server_.Join();
+            shmRingManager->Fini();
+            return false;
+        }
+    } else {
+        // 获取文件锁
+        if (fileLock.AcquireFileLock() != 0) {
+            LOG(ERROR) << "Address already in use";
+            return false;
+        }
+        int startBrpcServerRes = server_.StartAtSockFile(
+                                        listenAddress_.c_str(), &option);
+        if (0 != startBrpcServerRes) {
+            LOG(ERROR) << "NebdServer start brpc server fail, res="
+                << startBrpcServerRes;
+            return false;
+        }
     }
 
     isRunning_ = true;
     server_.RunUntilAskedToQuit();
 
     isRunning_ = false;
+    shmRingManager->Fini();
     fileLock.ReleaseFileLock();
     return true;
 }
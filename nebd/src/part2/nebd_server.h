@@ -89,6 +89,24 @@ class NebdServer {
      */
     bool InitHeartbeatManager();
 
+    /**
+     * @brief 热升级时通知旧进程冻结文件的打开和关闭，并获取旧进程的pid
+     * @return false-通知失败 true-通知成功
+     */
+    bool PrepareUpgrade();
+
+    /**
+     * @brief 热升级在接管监听地址之前失败时，通知旧进程解除冻结
+     */
+    void AbortUpgrade();
+
+    /**
+     * @brief 热升级时重新加载元数据，接管旧进程的监听地址，并等待旧进程退出
+     * @param[in] option brpc server的启动参数
+     * @return false-接管失败 true-接管成功
+     */
+    bool TakeOverListenAddress(const brpc::ServerOptions& option);
+
     /**
      * @brief 启动brpc service
      * @return false-启动service失败 true-启动service成功
@@ -102,6 +120,10 @@ class NebdServer {
     std::string listenAddress_;
     // NebdServer是否处于running状态
     bool isRunning_ =  false;
+    // 热升级时旧进程的pid
+    int32_t oldServerPid_ = -1;
+    // 热升级时是否已经接管了监听地址
+    bool tookOver_ = false;
 
     // brpc server
     brpc::Server server_;
@@ -24,11 +24,66 @@
 
 #include <glog/logging.h>
 
+#include <vector>
+
 namespace nebd {
 namespace server {
 
 using ::curve::client::UserInfo_t;
 
+uint64_t CurveWriteBarrier::StartWrite() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    uint64_t seq = nextSeq_++;
+    inflight_.insert(seq);
+    return seq;
+}
+
+void CurveWriteBarrier::FinishWrite(uint64_t seq, int ret) {
+    std::vector<FlushWaiter> ready;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        inflight_.erase(seq);
+        if (ret < 0) {
+            // 在该写请求之后下发的flush都需要返回失败
+            for (auto& waiter : waiters_) {
+                if (waiter.barrier >= seq) {
+                    waiter.ret = -1;
+                }
+            }
+        }
+
+        uint64_t minInflight = inflight_.empty() ? nextSeq_
+                                                 : *inflight_.begin();
+        while (!waiters_.empty() && waiters_.front().barrier < minInflight) {
+            ready.push_back(waiters_.front());
+            waiters_.pop_front();
+        }
+    }
+
+    for (auto& waiter : ready) {
+        waiter.aioctx->ret = waiter.ret;
+        waiter.aioctx->cb(waiter.aioctx);
+    }
+}
+
+void CurveWriteBarrier::Flush(NebdServerAioContext* aioctx) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!inflight_.empty()) {
+            waiters_.push_back({nextSeq_ - 1, aioctx, 0});
+            return;
+        }
+    }
+
+    aioctx->ret = 0;
+    aioctx->cb(aioctx);
+}
+
+size_t CurveWriteBarrier::InflightWrites() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return inflight_.size();
+}
+
 std::string FileNameParser::Parse(const std::string& fileName) {
     auto beginPos = fileName.find_first_of("/");
     if (beginPos == std::string::npos) {
@@ -201,10 +256,17 @@ int CurveRequestExecutor::AioWrite(
         return -1;
     }
 
+    // 必须在下发前分配序号，否则请求可能在记录前就已返回
+    auto writeBarrier = dynamic_cast<CurveFileInstance *>(fd)->writeBarrier;
+    uint64_t seq = writeBarrier->StartWrite();
+    curveCombineCtx->writeBarrier = writeBarrier;
+    curveCombineCtx->writeSeq = seq;
+
     ret = client_->AioWrite(curveFd, &curveCombineCtx->curveCtx,
                             curve::client::UserDataType::IOBuffer);
     if (ret !=  LIBCURVE_ERROR::OK) {
         delete curveCombineCtx;
+        writeBarrier->FinishWrite(seq, -1);
         return -1;
     }
 
@@ -213,10 +275,13 @@ int CurveRequestExecutor::AioWrite(
 
 int CurveRequestExecutor::Flush(
     NebdFileInstance* fd, NebdServerAioContext* aioctx) {
+    auto curveFileInstance = dynamic_cast<CurveFileInstance *>(fd);
+    if (curveFileInstance == nullptr) {
+        return -1;
+    }
 
-    aioctx->ret = 0;
-    aioctx->cb(aioctx);
-
+    // 等待之前下发的写请求全部返回
+    curveFileInstance->writeBarrier->Flush(aioctx);
     return 0;
 }
 
@@ -283,6 +348,11 @@ void CurveAioCallback(struct CurveAioContext* curveCtx) {
         offsetof(CurveAioCombineContext, curveCtx));
     curveCombineCtx->nebdCtx->ret = curveCtx->ret;
     curveCombineCtx->nebdCtx->cb(curveCombineCtx->nebdCtx);
+    // 写请求先于等待它的flush返回
+    if (curveCombineCtx->writeBarrier != nullptr) {
+        curveCombineCtx->writeBarrier->FinishWrite(
+            curveCombineCtx->writeSeq, curveCtx->ret < 0 ? -1 : 0);
+    }
     delete curveCombineCtx;
 }
 
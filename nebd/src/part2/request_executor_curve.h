@@ -23,6 +23,9 @@
 #ifndef NEBD_SRC_PART2_REQUEST_EXECUTOR_CURVE_H_
 #define NEBD_SRC_PART2_REQUEST_EXECUTOR_CURVE_H_
 
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
 #include <string>
 #include <memory>
 #include "nebd/src/part2/request_executor.h"
@@ -34,19 +37,75 @@ namespace server {
 
 using ::curve::client::CurveClient;
 
+/**
+ * 单个文件的写请求屏障
+ * 每个写请求下发时分配递增的序号，flush记录下发时最后一个写请求的序号，
+ * 在序号不大于该值的写请求全部返回后才返回。
+ * 之前的写请求有失败时，flush也返回失败。
+ */
+class CurveWriteBarrier {
+ public:
+    CurveWriteBarrier() : nextSeq_(1) {}
+
+    /**
+     * @brief 写请求下发前调用
+     * @return 写请求的序号
+     */
+    uint64_t StartWrite();
+
+    /**
+     * @brief 写请求返回后调用，唤醒已满足条件的flush
+     * @param seq 写请求的序号
+     * @param ret 写请求的返回值
+     */
+    void FinishWrite(uint64_t seq, int ret);
+
+    /**
+     * @brief 添加flush请求，没有需要等待的写请求时直接返回
+     * @param aioctx flush请求上下文
+     */
+    void Flush(NebdServerAioContext* aioctx);
+
+    /**
+     * 测试使用，返回正在执行的写请求个数
+     */
+    size_t InflightWrites();
+
+ private:
+    struct FlushWaiter {
+        // 需要等待的最后一个写请求序号
+        uint64_t barrier;
+        NebdServerAioContext* aioctx;
+        int ret;
+    };
+
+    std::mutex mtx_;
+    uint64_t nextSeq_;
+    // 正在执行的写请求序号
+    std::set<uint64_t> inflight_;
+    // 按barrier递增排列的flush请求
+    std::deque<FlushWaiter> waiters_;
+};
+
 class CurveFileInstance : public NebdFileInstance {
  public:
-    CurveFileInstance() {}
+    CurveFileInstance()
+        : writeBarrier(std::make_shared<CurveWriteBarrier>()) {}
     ~CurveFileInstance() {}
 
     int fd = -1;
     std::string fileName;
+    // 写请求返回时可能文件已关闭，由请求上下文共同持有
+    std::shared_ptr<CurveWriteBarrier> writeBarrier;
 };
 
 class CurveAioCombineContext {
  public:
     NebdServerAioContext* nebdCtx;
     CurveAioContext curveCtx;
+    // 写请求需要在返回时通知屏障
+    std::shared_ptr<CurveWriteBarrier> writeBarrier;
+    uint64_t writeSeq = 0;
 };
 void CurveAioCallback(struct CurveAioContext* curveCtx);
 
@@ -0,0 +1,246 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "nebd/src/part2/shm_ring_service.h"
+
+#include <brpc/closure_guard.h>
+#include <butil/iobuf.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include "nebd/src/part2/util.h"
+
+namespace nebd {
+namespace server {
+
+using nebd::common::ShmRingOp;
+
+// 提交队列为空时的等待时间，也是停止处理线程的最大延迟
+const int kWaitRequestTimeoutMs = 100;
+
+static void EmptyDeleter(void* m) {}
+
+void NebdShmRingCallback(NebdServerAioContext* context) {
+    CHECK(context != nullptr);
+    std::unique_ptr<NebdShmAioContext> contextGuard(
+        static_cast<NebdShmAioContext*>(context));
+    std::unique_ptr<butil::IOBuf> iobufGuard(
+        reinterpret_cast<butil::IOBuf*>(context->buf));
+    brpc::ClosureGuard doneGuard(context->done);
+    contextGuard->server->OnRequestComplete(contextGuard.get());
+}
+
+NebdShmRingServer::NebdShmRingServer(
+    int fd, std::shared_ptr<NebdFileManager> fileManager,
+    bool returnRpcWhenIoError)
+    : fd_(fd)
+    , fileManager_(fileManager)
+    , returnRpcWhenIoError_(returnRpcWhenIoError)
+    , running_(false) {}
+
+NebdShmRingServer::~NebdShmRingServer() {
+    Stop();
+}
+
+int NebdShmRingServer::Start(const std::string& path) {
+    if (ring_.Attach(path) != 0) {
+        LOG(ERROR) << "Attach shm ring failed. "
+                   << "fd: " << fd_ << ", path: " << path;
+        return -1;
+    }
+    ring_.SetServerPid(getpid());
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&NebdShmRingServer::Run, this);
+    LOG(INFO) << "Shm ring started. fd: " << fd_
+              << ", path: " << path
+              << ", depth: " << ring_.Depth()
+              << ", slot size: " << ring_.SlotSize();
+    return 0;
+}
+
+void NebdShmRingServer::Stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+        LOG(INFO) << "Shm ring stopped. fd: " << fd_;
+    }
+}
+
+void NebdShmRingServer::Run() {
+    while (running_.load(std::memory_order_acquire)) {
+        ShmRingRequest request;
+        if (!ring_.PopRequest(&request)) {
+            ring_.WaitRequest(kWaitRequestTimeoutMs);
+            continue;
+        }
+        HandleRequest(request);
+    }
+}
+
+void NebdShmRingServer::HandleRequest(const ShmRingRequest& request) {
+    if (request.slot >= ring_.Depth() || request.length > ring_.SlotSize()) {
+        LOG(ERROR) << "Invalid shm ring request. "
+                   << "fd: " << fd_
+                   << ", slot: " << request.slot
+                   << ", length: " << request.length;
+        PushCompletion(request.id, -1);
+        return;
+    }
+
+    NebdShmAioContext* context = new (std::nothrow) NebdShmAioContext();
+    context->server = shared_from_this();
+    context->id = request.id;
+    context->slot = request.slot;
+    context->offset = request.offset;
+    context->size = request.length;
+    context->cb = NebdShmRingCallback;
+    context->returnRpcWhenIoError = returnRpcWhenIoError_;
+
+    int rc = -1;
+    switch (static_cast<ShmRingOp>(request.op)) {
+        case ShmRingOp::READ:
+            context->op = LIBAIO_OP::LIBAIO_OP_READ;
+            context->buf = new butil::IOBuf();
+            rc = fileManager_->AioRead(fd_, context);
+            break;
+        case ShmRingOp::WRITE:
+        {
+            // 直接引用slot中的数据，请求返回前part1不会复用该slot
+            butil::IOBuf* buf = new butil::IOBuf();
+            buf->append_user_data(ring_.SlotData(request.slot),
+                                  request.length, EmptyDeleter);
+            context->op = LIBAIO_OP::LIBAIO_OP_WRITE;
+            context->buf = buf;
+            rc = fileManager_->AioWrite(fd_, context);
+            break;
+        }
+        case ShmRingOp::DISCARD:
+            context->op = LIBAIO_OP::LIBAIO_OP_DISCARD;
+            rc = fileManager_->Discard(fd_, context);
+            break;
+        case ShmRingOp::FLUSH:
+            context->op = LIBAIO_OP::LIBAIO_OP_FLUSH;
+            rc = fileManager_->Flush(fd_, context);
+            break;
+        default:
+            LOG(ERROR) << "Unknown shm ring request op: " << request.op;
+            break;
+    }
+
+    if (rc < 0) {
+        LOG(ERROR) << Op2Str(context->op) << " file failed. "
+                   << "fd: " << fd_
+                   << ", offset: " << request.offset
+                   << ", length: " << request.length
+                   << ", return code: " << rc;
+        delete reinterpret_cast<butil::IOBuf*>(context->buf);
+        delete context;
+        PushCompletion(request.id, -1);
+    }
+}
+
+void NebdShmRingServer::OnRequestComplete(NebdShmAioContext* context) {
+    int64_t ret = 0;
+    if (context->ret < 0 && !context->returnRpcWhenIoError) {
+        // 不返回io错误，由part1改走rpc重试，不能丢弃结果，否则part1一直等待
+        LOG(ERROR) << *context;
+        LOG(ERROR) << Op2Str(context->op)
+                   << " file failed and let part1 resend it by rpc.";
+        ret = kShmRingResend;
+    } else if (context->ret < 0) {
+        LOG(ERROR) << *context;
+        ret = -1;
+    } else if (context->op == LIBAIO_OP::LIBAIO_OP_READ) {
+        butil::IOBuf* buf = reinterpret_cast<butil::IOBuf*>(context->buf);
+        if (buf->size() != context->size) {
+            LOG(ERROR) << "Read size mismatch. " << *context
+                       << ", read size: " << buf->size();
+            ret = -1;
+        } else {
+            buf->copy_to(ring_.SlotData(context->slot), context->size);
+        }
+    }
+    PushCompletion(context->id, ret);
+}
+
+void NebdShmRingServer::PushCompletion(uint64_t id, int64_t ret) {
+    ShmRingCompletion completion = {id, ret};
+    std::lock_guard<std::mutex> lock(completionMtx_);
+    // 进行中的请求数不超过slot数，完成队列不会满，除非part1行为异常
+    if (!ring_.PushCompletion(completion)) {
+        LOG(ERROR) << "Shm ring completion queue is full. "
+                   << "fd: " << fd_ << ", id: " << id;
+    }
+}
+
+int NebdShmRingManager::Attach(int fd, const std::string& path) {
+    if (fileManager_->GetFileEntity(fd) == nullptr) {
+        LOG(ERROR) << "Attach shm ring failed, file not exist. fd: " << fd;
+        return -1;
+    }
+
+    auto server = std::make_shared<NebdShmRingServer>(
+        fd, fileManager_, returnRpcWhenIoError_);
+    if (server->Start(path) != 0) {
+        return -1;
+    }
+
+    std::shared_ptr<NebdShmRingServer> old;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        old = servers_[fd];
+        servers_[fd] = server;
+    }
+    if (old != nullptr) {
+        old->Stop();
+    }
+    return 0;
+}
+
+void NebdShmRingManager::Detach(int fd) {
+    std::shared_ptr<NebdShmRingServer> server;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto iter = servers_.find(fd);
+        if (iter == servers_.end()) {
+            return;
+        }
+        server = iter->second;
+        servers_.erase(iter);
+    }
+    server->Stop();
+}
+
+void NebdShmRingManager::Fini() {
+    std::unordered_map<int, std::shared_ptr<NebdShmRingServer>> servers;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        servers.swap(servers_);
+    }
+    for (auto& item : servers) {
+        item.second->Stop();
+    }
+}
+
+}  // namespace server
+}  // namespace nebd
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef NEBD_SRC_PART2_SHM_RING_SERVICE_H_
+#define NEBD_SRC_PART2_SHM_RING_SERVICE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part2/define.h"
+#include "nebd/src/part2/file_manager.h"
+
+namespace nebd {
+namespace server {
+
+using nebd::common::ShmRing;
+using nebd::common::ShmRingRequest;
+using nebd::common::ShmRingCompletion;
+using nebd::common::kShmRingResend;
+
+class NebdShmRingServer;
+
+// 经共享内存环到达的请求的上下文，请求返回时据此向完成队列提交结果
+struct NebdShmAioContext : public NebdServerAioContext {
+    std::shared_ptr<NebdShmRingServer> server;
+    // part1分配的请求id
+    uint64_t id = 0;
+    // 请求数据所在的slot
+    uint32_t slot = 0;
+};
+
+void NebdShmRingCallback(NebdServerAioContext* context);
+
+/**
+ * 单个文件的共享内存环服务端
+ * 后台线程从提交队列取出请求，转换为NebdServerAioContext交给NebdFileManager，
+ * 请求返回后将结果写入完成队列。
+ * 进行中的请求持有本对象的引用，保证请求返回前共享区域不会被解除映射。
+ */
+class NebdShmRingServer
+    : public std::enable_shared_from_this<NebdShmRingServer> {
+ public:
+    NebdShmRingServer(int fd,
+                      std::shared_ptr<NebdFileManager> fileManager,
+                      bool returnRpcWhenIoError);
+    ~NebdShmRingServer();
+
+    /**
+     * @brief 映射共享区域并启动处理线程
+     * @param path part1创建的共享文件路径
+     * @return 成功返回0，失败返回-1
+     */
+    int Start(const std::string& path);
+
+    /**
+     * @brief 停止处理线程，已提交的请求仍会正常返回
+     */
+    void Stop();
+
+    /**
+     * @brief 请求返回时调用，将结果写入完成队列，失败的请求也一定会写入
+     */
+    void OnRequestComplete(NebdShmAioContext* context);
+
+ private:
+    void Run();
+    void HandleRequest(const ShmRingRequest& request);
+    void PushCompletion(uint64_t id, int64_t ret);
+
+ private:
+    int fd_;
+    std::shared_ptr<NebdFileManager> fileManager_;
+    bool returnRpcWhenIoError_;
+    ShmRing ring_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    // 完成队列只允许一个生产者，请求可能在不同线程返回
+    std::mutex completionMtx_;
+};
+
+/**
+ * 管理part2所有的共享内存环，由AttachShmRing/DetachShmRing rpc驱动
+ */
+class NebdShmRingManager {
+ public:
+    NebdShmRingManager(std::shared_ptr<NebdFileManager> fileManager,
+                       bool returnRpcWhenIoError)
+        : fileManager_(fileManager)
+        , returnRpcWhenIoError_(returnRpcWhenIoError) {}
+    virtual ~NebdShmRingManager() {
+        Fini();
+    }
+
+    /**
+     * @brief 为文件映射共享内存环，已存在时替换旧的环
+     * @param fd 文件的fd
+     * @param path part1创建的共享文件路径
+     * @return 成功返回0，失败返回-1
+     */
+    virtual int Attach(int fd, const std::string& path);
+
+    /**
+     * @brief 停止文件的共享内存环，不存在时直接返回成功
+     * @param fd 文件的fd
+     */
+    virtual void Detach(int fd);
+
+    /**
+     * @brief 停止所有共享内存环
+     */
+    virtual void Fini();
+
+ private:
+    std::shared_ptr<NebdFileManager> fileManager_;
+    bool returnRpcWhenIoError_;
+    std::mutex mtx_;
+    std::unordered_map<int, std::shared_ptr<NebdShmRingServer>> servers_;
+};
+
+}  // namespace server
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART2_SHM_RING_SERVICE_H_
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <unistd.h>
+
+#include "nebd/src/part2/upgrade_service.h"
+
+namespace nebd {
+namespace server {
+
+void NebdUpgradeServiceImpl::PrepareUpgrade(
+        google::protobuf::RpcController* cntl_base,
+        const nebd::client::PrepareUpgradeRequest* request,
+        nebd::client::PrepareUpgradeResponse* response,
+        google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    // 新进程加载元数据之后，本进程不再修改元数据
+    fileManager_->Freeze(request->pid());
+    LOG(INFO) << "Prepare upgrade, files are frozen until upgrade finished, "
+              << "new nebd-server pid: " << request->pid();
+    response->set_retcode(nebd::client::RetCode::kOK);
+    response->set_pid(getpid());
+}
+
+void NebdUpgradeServiceImpl::AbortUpgrade(
+        google::protobuf::RpcController* cntl_base,
+        const nebd::client::AbortUpgradeRequest* request,
+        nebd::client::AbortUpgradeResponse* response,
+        google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    fileManager_->Unfreeze();
+    LOG(INFO) << "Upgrade aborted, files are unfrozen";
+    response->set_retcode(nebd::client::RetCode::kOK);
+}
+
+}  // namespace server
+}  // namespace nebd
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef NEBD_SRC_PART2_UPGRADE_SERVICE_H_
+#define NEBD_SRC_PART2_UPGRADE_SERVICE_H_
+
+#include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <memory>
+
+#include "nebd/proto/upgrade.pb.h"
+#include "nebd/src/part2/file_manager.h"
+
+namespace nebd {
+namespace server {
+
+// 热升级时由新的part2进程调用
+class NebdUpgradeServiceImpl : public nebd::client::NebdUpgradeService {
+ public:
+    explicit NebdUpgradeServiceImpl(
+        std::shared_ptr<NebdFileManager> fileManager)
+        : fileManager_(fileManager) {}
+    virtual ~NebdUpgradeServiceImpl() {}
+    virtual void PrepareUpgrade(google::protobuf::RpcController* cntl_base,
+                        const nebd::client::PrepareUpgradeRequest* request,
+                        nebd::client::PrepareUpgradeResponse* response,
+                        google::protobuf::Closure* done);
+    virtual void AbortUpgrade(google::protobuf::RpcController* cntl_base,
+                        const nebd::client::AbortUpgradeRequest* request,
+                        nebd::client::AbortUpgradeResponse* response,
+                        google::protobuf::Closure* done);
+
+ private:
+    std::shared_ptr<NebdFileManager> fileManager_;
+};
+
+}  // namespace server
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART2_UPGRADE_SERVICE_H_
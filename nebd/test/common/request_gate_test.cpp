@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "nebd/src/common/request_gate.h"
+
+namespace nebd {
+namespace common {
+
+TEST(RequestGateTest, basic_test) {
+    RequestGate gate;
+    ASSERT_EQ(0, gate.InflightCount());
+    {
+        RequestGateGuard guard1(gate);
+        RequestGateGuard guard2(gate);
+        ASSERT_EQ(2, gate.InflightCount());
+    }
+    ASSERT_EQ(0, gate.InflightCount());
+
+    // 没有进行中的请求时Drain直接返回
+    {
+        RequestDrainGuard drainGuard(gate);
+        ASSERT_EQ(0, gate.InflightCount());
+    }
+
+    // 请求可以在其他线程结束
+    gate.Enter();
+    std::thread t([&] { gate.Exit(); });
+    t.join();
+    ASSERT_EQ(0, gate.InflightCount());
+}
+
+TEST(RequestGateTest, drain_test) {
+    RequestGate gate;
+    std::atomic<bool> drained(false);
+    std::atomic<bool> entered(false);
+
+    // Drain等待进行中的请求结束
+    gate.Enter();
+    std::thread drainer([&] {
+        gate.Drain();
+        drained = true;
+    });
+    usleep(100 * 1000);
+    ASSERT_FALSE(drained.load());
+
+    // Drain开始后新请求需要等待
+    std::thread request([&] {
+        RequestGateGuard guard(gate);
+        entered = true;
+    });
+    usleep(100 * 1000);
+    ASSERT_FALSE(entered.load());
+
+    gate.Exit();
+    drainer.join();
+    ASSERT_TRUE(drained.load());
+    usleep(100 * 1000);
+    ASSERT_FALSE(entered.load());
+
+    gate.Resume();
+    request.join();
+    ASSERT_TRUE(entered.load());
+    ASSERT_EQ(0, gate.InflightCount());
+}
+
+TEST(RequestGateTest, concurrent_test) {
+    RequestGate gate;
+    std::atomic<bool> running(true);
+    // Drain期间为true，此时不应有请求在执行
+    std::atomic<bool> draining(false);
+    std::atomic<uint64_t> violations(0);
+    std::atomic<uint64_t> requests(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            while (running.load()) {
+                RequestGateGuard guard(gate);
+                if (draining.load()) {
+                    ++violations;
+                }
+                ++requests;
+            }
+        });
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        uint64_t before = requests.load();
+        while (requests.load() == before) {
+            std::this_thread::yield();
+        }
+        RequestDrainGuard drainGuard(gate);
+        draining = true;
+        ASSERT_EQ(0, gate.InflightCount());
+        draining = false;
+    }
+
+    running = false;
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(0, violations.load());
+    ASSERT_LT(0, requests.load());
+    ASSERT_EQ(0, gate.InflightCount());
+}
+
+}  // namespace common
+}  // namespace nebd
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "nebd/src/common/shm_ring.h"
+
+namespace nebd {
+namespace common {
+
+class ShmRingTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        path_ = "./nebd_shm_ring_test." + std::to_string(getpid());
+    }
+
+    void TearDown() override {
+        ShmRing::Remove(path_);
+    }
+
+    std::string path_;
+};
+
+TEST_F(ShmRingTest, CreateAndAttachTest) {
+    ShmRing client;
+    // 深度须为2的幂，slot须按4KB对齐
+    ASSERT_EQ(-1, client.Create(path_, 3, 4096));
+    ASSERT_EQ(-1, client.Create(path_, 4, 1000));
+    ASSERT_EQ(0, client.Create(path_, 4, 8192));
+    ASSERT_EQ(0, access((path_ + ".sq").c_str(), F_OK));
+    ASSERT_EQ(0, access((path_ + ".cq").c_str(), F_OK));
+
+    ShmRing server;
+    ASSERT_EQ(0, server.Attach(path_));
+    ASSERT_EQ(4, server.Depth());
+    ASSERT_EQ(8192, server.SlotSize());
+    server.SetServerPid(getpid());
+    ASSERT_EQ(getpid(), client.GetServerPid());
+
+    // 数据区是共享的
+    memset(client.SlotData(3), 'a', 8192);
+    ASSERT_EQ('a', server.SlotData(3)[0]);
+    ASSERT_EQ('a', server.SlotData(3)[8191]);
+
+    ShmRing other;
+    ASSERT_EQ(-1, other.Attach(path_ + ".notexist"));
+}
+
+TEST_F(ShmRingTest, PushPopTest) {
+    ShmRing client;
+    ShmRing server;
+    ASSERT_EQ(0, client.Create(path_, 4, 4096));
+    ASSERT_EQ(0, server.Attach(path_));
+
+    ShmRingRequest request;
+    ASSERT_FALSE(server.PopRequest(&request));
+
+    // 多次绕回，队列满时提交失败
+    uint64_t id = 0;
+    for (int round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            ShmRingRequest req = {id + i,
+                static_cast<uint32_t>(ShmRingOp::WRITE), i, i * 4096, 4096};
+            ASSERT_TRUE(client.PushRequest(req));
+        }
+        ShmRingRequest full = {100, 0, 0, 0, 0};
+        ASSERT_FALSE(client.PushRequest(full));
+
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_TRUE(server.PopRequest(&request));
+            ASSERT_EQ(id + i, request.id);
+            ASSERT_EQ(static_cast<uint32_t>(ShmRingOp::WRITE), request.op);
+            ASSERT_EQ(i, request.slot);
+            ASSERT_EQ(i * 4096, request.offset);
+            ASSERT_EQ(4096, request.length);
+            ShmRingCompletion comp = {request.id, -1 * (i % 2)};
+            ASSERT_TRUE(server.PushCompletion(comp));
+        }
+        ASSERT_FALSE(server.PopRequest(&request));
+
+        ShmRingCompletion completion;
+        for (uint32_t i = 0; i < 4; i++) {
+            ASSERT_TRUE(client.PopCompletion(&completion));
+            ASSERT_EQ(id + i, completion.id);
+            ASSERT_EQ(-1 * (i % 2), completion.ret);
+        }
+        ASSERT_FALSE(client.PopCompletion(&completion));
+        id += 4;
+    }
+}
+
+TEST_F(ShmRingTest, WaitTest) {
+    ShmRing client;
+    ShmRing server;
+    ASSERT_EQ(0, client.Create(path_, 64, 4096));
+    ASSERT_EQ(0, server.Attach(path_));
+
+    // 队列为空时等待超时
+    server.WaitRequest(10);
+    ShmRingRequest request;
+    ASSERT_FALSE(server.PopRequest(&request));
+
+    // 消费者等待时由门铃唤醒，所有请求都能收到结果
+    const uint64_t kRequestNum = 10000;
+    std::thread consumer([&]() {
+        uint64_t received = 0;
+        while (received < kRequestNum) {
+            ShmRingRequest req;
+            if (!server.PopRequest(&req)) {
+                server.WaitRequest(1000);
+                continue;
+            }
+            ShmRingCompletion comp = {req.id, 0};
+            while (!server.PushCompletion(comp)) {}
+            received++;
+        }
+    });
+
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    while (completed < kRequestNum) {
+        while (submitted < kRequestNum && submitted - completed < 64) {
+            ShmRingRequest req = {submitted, 0, 0, 0, 0};
+            ASSERT_TRUE(client.PushRequest(req));
+            submitted++;
+        }
+        ShmRingCompletion comp;
+        if (!client.PopCompletion(&comp)) {
+            client.WaitCompletion(1000);
+            continue;
+        }
+        ASSERT_EQ(completed, comp.id);
+        completed++;
+    }
+    consumer.join();
+}
+
+}  // namespace common
+}  // namespace nebd
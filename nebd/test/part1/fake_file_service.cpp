@@ -180,5 +180,28 @@ void FakeNebdFileService::InvalidateCache(
     return;
 }
 
+void FakeNebdFileService::AioBatch(::google::protobuf::RpcController* controller,  // NOLINT
+                       const ::nebd::client::AioBatchRequest* request,
+                       ::nebd::client::AioBatchResponse* response,
+                       ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+
+    LOG(INFO) << "logid = " << cntl->log_id() << ", AioBatch, "
+              << "entry count = " << request->entries_size();
+
+    for (const auto& entry : request->entries()) {
+        if (entry.op() == AioBatchOp::kBatchRead) {
+            cntl->response_attachment().append(buffer + entry.offset(),
+                                               entry.size());
+        }
+        response->add_entryretcode(RetCode::kOK);
+    }
+    response->set_retcode(RetCode::kOK);
+    response->set_retmsg("AioBatch OK");
+
+    return;
+}
+
 }  // namespace client
 }  // namespace nebd
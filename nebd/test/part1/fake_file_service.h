@@ -82,6 +82,11 @@ class FakeNebdFileService: public NebdFileService {
                        ::nebd::client::InvalidateCacheResponse* response,
                        ::google::protobuf::Closure* done) override;
 
+    void AioBatch(::google::protobuf::RpcController* controller,
+                       const ::nebd::client::AioBatchRequest* request,
+                       ::nebd::client::AioBatchResponse* response,
+                       ::google::protobuf::Closure* done) override;
+
  private:
     int64_t fileSize_;
 };
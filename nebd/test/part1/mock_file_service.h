@@ -73,6 +73,20 @@ class MockNebdFileService : public NebdFileService {
                        const ::nebd::client::InvalidateCacheRequest* request,
                        ::nebd::client::InvalidateCacheResponse* response,
                        ::google::protobuf::Closure* done));
+    MOCK_METHOD4(AioBatch, void(::google::protobuf::RpcController* controller,
+                       const ::nebd::client::AioBatchRequest* request,
+                       ::nebd::client::AioBatchResponse* response,
+                       ::google::protobuf::Closure* done));
+    MOCK_METHOD4(AttachShmRing, void(
+                       ::google::protobuf::RpcController* controller,
+                       const ::nebd::client::AttachShmRingRequest* request,
+                       ::nebd::client::AttachShmRingResponse* response,
+                       ::google::protobuf::Closure* done));
+    MOCK_METHOD4(DetachShmRing, void(
+                       ::google::protobuf::RpcController* controller,
+                       const ::nebd::client::DetachShmRingRequest* request,
+                       ::nebd::client::DetachShmRingResponse* response,
+                       ::google::protobuf::Closure* done));
 };
 }   // namespace client
 }   // namespace nebd
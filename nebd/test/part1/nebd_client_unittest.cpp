@@ -23,16 +23,24 @@
 #include <gtest/gtest.h>
 #include <gflags/gflags.h>
 #include <brpc/server.h>
+#include <brpc/errno.pb.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <mutex>  // NOLINT
 #include <condition_variable>  // NOLINT
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "nebd/src/part1/nebd_client.h"
 #include "nebd/src/part1/libnebd.h"
 #include "nebd/src/part1/libnebd_file.h"
 
+#include "nebd/src/common/shm_ring.h"
 #include "nebd/test/part1/fake_file_service.h"
+#include "nebd/test/part1/fake_heartbeat_service.h"
 #include "nebd/test/part1/mock_file_service.h"
 #include "nebd/test/utils/config_generator.h"
 
@@ -40,6 +48,8 @@ const char* kFileName = "nebd-test-filename";
 const char* kFileNameWithSlash = "nebd-test-filenae//filename";
 const char* kNebdServerTestAddress = "./nebd-client-test.sock";
 const char* kNebdClientConf = "./nebd/test/part1/nebd-client-test.conf";
+const char* kNebdClientShmConf =
+    "./nebd/test/part1/nebd-client-shm-test.conf";
 const int64_t kFileSize = 10LL * 1024 * 1024 * 1024;
 const int64_t kBufSize = 1024;
 
@@ -77,6 +87,16 @@ void AioRpcFailCallBack(NebdClientAioContext* ctx) {
     delete ctx;
 }
 
+std::atomic<int> batchReturnCount{0};
+
+void AioBatchCallBack(NebdClientAioContext* ctx) {
+    ASSERT_EQ(0, ctx->ret);
+    std::lock_guard<std::mutex> lk(mtx);
+    batchReturnCount.fetch_add(1);
+    cond.notify_one();
+    delete ctx;
+}
+
 template <typename Request, typename Response>
 void MockClientFunc(google::protobuf::RpcController* cntl_base,
                     const Request* request,
@@ -567,6 +587,237 @@ TEST_F(NebdFileClientTest, ResponseFailTest) {
     StopServer();
 }
 
+TEST_F(NebdFileClientTest, AioBatchTest) {
+    AddFakeService();
+    StartServer();
+    ASSERT_EQ(0, Init4Nebd(kNebdClientConf));
+
+    // 同一文件连续下发的请求可能被合并为一次AioBatch rpc
+    const int kRequestCount = 64;
+    const int kRequestSize = kBufSize / kRequestCount;
+    char writeBuf[kBufSize];
+    char readBuf[kBufSize];
+    memset(writeBuf, 'a', kBufSize);
+    memset(readBuf, 'b', kBufSize);
+
+    batchReturnCount = 0;
+    for (int i = 0; i < kRequestCount; ++i) {
+        for (auto op : {LIBAIO_OP_WRITE, LIBAIO_OP_READ}) {
+            NebdClientAioContext* ctx = new NebdClientAioContext();
+            ctx->offset = i * kRequestSize;
+            ctx->length = kRequestSize;
+            ctx->ret = -1;
+            ctx->op = op;
+            ctx->cb = AioBatchCallBack;
+            ctx->retryCount = 0;
+            if (op == LIBAIO_OP_WRITE) {
+                ctx->buf = writeBuf + ctx->offset;
+                ASSERT_EQ(0, AioWrite4Nebd(1, ctx));
+            } else {
+                ctx->buf = readBuf + ctx->offset;
+                ASSERT_EQ(0, AioRead4Nebd(1, ctx));
+            }
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, [&]() {
+            return batchReturnCount.load() == 2 * kRequestCount;
+        });
+    }
+
+    // 每个读请求都拿到了对应位置的数据
+    char expected[kBufSize];
+    memset(expected, 0, kBufSize);
+    ASSERT_EQ(0, memcmp(expected, readBuf, kBufSize));
+
+    ASSERT_NO_THROW(Uninit4Nebd());
+    StopServer();
+}
+
+TEST_F(NebdFileClientTest, AioBatchNotSupportedTest) {
+    AddMockService();
+    StartServer();
+    ASSERT_EQ(0, Init4Nebd(kNebdClientConf));
+
+    // part2不支持AioBatch时，合并的请求改为单独发送
+    const int kRequestCount = 32;
+    char buffer[kBufSize];
+    EXPECT_CALL(mockService, AioBatch(_, _, _, _))
+        .Times(AnyNumber())
+        .WillRepeatedly(Invoke([](google::protobuf::RpcController* cntl_base,
+                                  const AioBatchRequest* request,
+                                  AioBatchResponse* response,
+                                  google::protobuf::Closure* done) {
+            brpc::ClosureGuard doneGuard(done);
+            brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+            cntl->SetFailed(brpc::ENOMETHOD, "Fail to find method");
+        }));
+    EXPECT_CALL(mockService, Write(_, _, _, _))
+        .Times(kRequestCount)
+        .WillRepeatedly(Invoke([](google::protobuf::RpcController* cntl_base,
+                                  const WriteRequest* request,
+                                  WriteResponse* response,
+                                  google::protobuf::Closure* done) {
+            brpc::ClosureGuard doneGuard(done);
+            response->set_retcode(RetCode::kOK);
+        }));
+
+    batchReturnCount = 0;
+    for (int i = 0; i < kRequestCount; ++i) {
+        NebdClientAioContext* ctx = new NebdClientAioContext();
+        ctx->buf = buffer;
+        ctx->offset = 0;
+        ctx->length = kBufSize;
+        ctx->ret = -1;
+        ctx->op = LIBAIO_OP_WRITE;
+        ctx->cb = AioBatchCallBack;
+        ctx->retryCount = 0;
+        ASSERT_EQ(0, AioWrite4Nebd(1, ctx));
+    }
+
+    {
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, [&]() {
+            return batchReturnCount.load() == kRequestCount;
+        });
+    }
+
+    ASSERT_NO_THROW(Uninit4Nebd());
+    StopServer();
+}
+
+TEST_F(NebdFileClientTest, ShmReattachTest) {
+    using nebd::common::ShmRing;
+    using nebd::common::ShmRingRequest;
+
+    FakeHeartbeatService heartbeatService;
+    AddMockService();
+    ASSERT_EQ(0, server.AddService(&heartbeatService,
+                                   brpc::SERVER_DOESNT_OWN_SERVICE));
+    StartServer();
+    ASSERT_EQ(0, Init4Nebd(kNebdClientShmConf));
+
+    // 以已退出的子进程模拟退出的part2
+    pid_t deadPid = fork();
+    ASSERT_GE(deadPid, 0);
+    if (deadPid == 0) {
+        _exit(0);
+    }
+    ASSERT_EQ(deadPid, waitpid(deadPid, nullptr, 0));
+
+    // part2侧映射的共享内存环，第一个环所属的part2已退出
+    std::mutex ringsMtx;
+    std::vector<std::shared_ptr<ShmRing>> rings;
+    auto ringCount = [&]() {
+        std::lock_guard<std::mutex> lk(ringsMtx);
+        return rings.size();
+    };
+    EXPECT_CALL(mockService, AttachShmRing(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](google::protobuf::RpcController* cntl,
+                                   const AttachShmRingRequest* request,
+                                   AttachShmRingResponse* response,
+                                   google::protobuf::Closure* done) {
+            brpc::ClosureGuard doneGuard(done);
+            auto ring = std::make_shared<ShmRing>();
+            ASSERT_EQ(0, ring->Attach(request->path()));
+            std::lock_guard<std::mutex> lk(ringsMtx);
+            ring->SetServerPid(rings.empty() ? deadPid : getpid());
+            rings.push_back(ring);
+            response->set_retcode(RetCode::kOK);
+        }));
+
+    {
+        OpenFileResponse response;
+        response.set_retcode(RetCode::kOK);
+        response.set_fd(1);
+        EXPECT_CALL(mockService, OpenFile(_, _, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<2>(response),
+                Invoke(MockClientFunc<OpenFileRequest, OpenFileResponse>)));  // NOLINT
+        ASSERT_EQ(1, Open4Nebd(kFileName));
+        ASSERT_EQ(1, ringCount());
+    }
+
+    char buffer[kBufSize];
+    auto newWriteContext = [&]() {
+        NebdClientAioContext* ctx = new NebdClientAioContext();
+        ctx->buf = buffer;
+        ctx->offset = 0;
+        ctx->length = kBufSize;
+        ctx->ret = -1;
+        ctx->op = LIBAIO_OP_WRITE;
+        ctx->cb = AioCallBack;
+        ctx->retryCount = 0;
+        return ctx;
+    };
+
+    // part2退出，共享内存环上的请求改由rpc发送
+    {
+        WriteResponse response;
+        response.set_retcode(RetCode::kOK);
+        EXPECT_CALL(mockService, Write(_, _, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<2>(response),
+                Invoke(MockClientFunc<WriteRequest, WriteResponse>)));
+        aioOpReturn = false;
+        ASSERT_EQ(0, AioWrite4Nebd(1, newWriteContext()));
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, []() { return aioOpReturn.load(); });
+    }
+
+    // 心跳恢复后重新建立共享内存环
+    for (int i = 0; i < 50 && ringCount() < 2; ++i) {
+        usleep(100 * 1000);
+    }
+    ASSERT_EQ(2, ringCount());
+
+    // 之后的请求经新的共享内存环发送
+    {
+        aioOpReturn = false;
+        ASSERT_EQ(0, AioWrite4Nebd(1, newWriteContext()));
+        std::shared_ptr<ShmRing> ring;
+        {
+            std::lock_guard<std::mutex> lk(ringsMtx);
+            ring = rings[1];
+        }
+        ShmRingRequest request;
+        bool popped = false;
+        for (int i = 0; i < 50 && !popped; ++i) {
+            popped = ring->PopRequest(&request);
+            if (!popped) {
+                ring->WaitRequest(100);
+            }
+        }
+        ASSERT_TRUE(popped);
+        ASSERT_EQ(kBufSize, request.length);
+        ASSERT_TRUE(ring->PushCompletion({request.id, 0}));
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, []() { return aioOpReturn.load(); });
+    }
+
+    {
+        DetachShmRingResponse detachResponse;
+        detachResponse.set_retcode(RetCode::kOK);
+        EXPECT_CALL(mockService, DetachShmRing(_, _, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<2>(detachResponse),
+                Invoke(MockClientFunc<DetachShmRingRequest, DetachShmRingResponse>)));  // NOLINT
+        CloseFileResponse response;
+        response.set_retcode(RetCode::kOK);
+        EXPECT_CALL(mockService, CloseFile(_, _, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<2>(response),
+                Invoke(MockClientFunc<CloseFileRequest, CloseFileResponse>)));  // NOLINT
+        ASSERT_EQ(0, Close4Nebd(1));
+    }
+
+    ASSERT_NO_THROW(Uninit4Nebd());
+    StopServer();
+}
+
 TEST_F(NebdFileClientTest, InitAndUninitTest) {
     ASSERT_NO_FATAL_FAILURE(nebdClient.Uninit());
 
@@ -597,6 +848,17 @@ int main(int argc, char* argv[]) {
     generator.SetConfigOptions(nebdConfig);
     generator.Generate();
 
+    nebd::common::NebdClientConfigGenerator shmGenerator;
+    shmGenerator.SetConfigPath(kNebdClientShmConf);
+    shmGenerator.SetConfigOptions(nebdConfig);
+    shmGenerator.SetConfigOptions({
+        std::string("heartbeat.intervalS=1"),
+        std::string("shm.enable=true"),
+        std::string("shm.path=."),
+        std::string("shm.serverCheckIntervalMs=100")
+    });
+    shmGenerator.Generate();
+
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
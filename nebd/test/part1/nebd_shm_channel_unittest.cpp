@@ -0,0 +1,266 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "nebd/src/part1/nebd_shm_channel.h"
+#include "nebd/src/common/timeutility.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::ShmRingOp;
+using nebd::common::ShmRingRequest;
+using nebd::common::ShmRingCompletion;
+
+static std::atomic<int> completedCount(0);
+
+static void ShmChannelTestCallback(NebdClientAioContext* aioctx) {
+    completedCount.fetch_add(1);
+}
+
+static bool WaitCompleted(int expected) {
+    for (int i = 0; i < 500; i++) {
+        if (completedCount.load() == expected) {
+            return true;
+        }
+        usleep(10 * 1000);
+    }
+    return false;
+}
+
+static bool WaitRequest(ShmRing* ring, ShmRingRequest* request) {
+    for (int i = 0; i < 50; i++) {
+        if (ring->PopRequest(request)) {
+            return true;
+        }
+        ring->WaitRequest(100);
+    }
+    return false;
+}
+
+class NebdShmChannelTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        path_ = "./nebd_shm_channel_test." + std::to_string(getpid());
+        option_.queueDepth = 2;
+        option_.slotSize = 4096;
+        option_.serverCheckIntervalMs = 100;
+        completedCount.store(0);
+    }
+
+    void TearDown() override {
+        ShmRing::Remove(path_);
+    }
+
+    NebdClientAioContext MakeContext(LIBAIO_OP op, char* buf,
+                                     size_t length) {
+        NebdClientAioContext aioctx;
+        aioctx.offset = 8192;
+        aioctx.length = length;
+        aioctx.ret = -2;
+        aioctx.op = op;
+        aioctx.cb = ShmChannelTestCallback;
+        aioctx.buf = buf;
+        aioctx.retryCount = 0;
+        return aioctx;
+    }
+
+    std::string path_;
+    ShmRingOption option_;
+};
+
+TEST_F(NebdShmChannelTest, SubmitTest) {
+    std::vector<NebdClientAioContext*> resent;
+    NebdShmChannel channel(1, option_, [&](NebdClientAioContext* aioctx) {
+        resent.push_back(aioctx);
+    });
+    ASSERT_EQ(0, channel.Init(path_));
+    ShmRing server;
+    ASSERT_EQ(0, server.Attach(path_));
+    server.SetServerPid(getpid());
+
+    char writeBuf[4096];
+    memset(writeBuf, 'a', sizeof(writeBuf));
+    char readBuf[4096] = {0};
+    char largeBuf[8192];
+    auto write = MakeContext(LIBAIO_OP::LIBAIO_OP_WRITE, writeBuf, 4096);
+    auto read = MakeContext(LIBAIO_OP::LIBAIO_OP_READ, readBuf, 4096);
+    auto flush = MakeContext(LIBAIO_OP::LIBAIO_OP_FLUSH, nullptr, 0);
+    auto large = MakeContext(LIBAIO_OP::LIBAIO_OP_WRITE, largeBuf, 8192);
+
+    // 超过slot大小的请求走rpc
+    ASSERT_FALSE(channel.Submit(&large));
+    ASSERT_TRUE(channel.Submit(&write));
+    ASSERT_TRUE(channel.Submit(&read));
+    // 没有空闲的slot
+    ASSERT_FALSE(channel.Submit(&flush));
+
+    ShmRingRequest writeRequest;
+    ASSERT_TRUE(WaitRequest(&server, &writeRequest));
+    ASSERT_EQ(static_cast<uint32_t>(ShmRingOp::WRITE), writeRequest.op);
+    ASSERT_EQ(8192, writeRequest.offset);
+    ASSERT_EQ(4096, writeRequest.length);
+    ASSERT_EQ(0, memcmp(writeBuf, server.SlotData(writeRequest.slot), 4096));
+    ShmRingRequest readRequest;
+    ASSERT_TRUE(WaitRequest(&server, &readRequest));
+    ASSERT_EQ(static_cast<uint32_t>(ShmRingOp::READ), readRequest.op);
+    ASSERT_NE(writeRequest.slot, readRequest.slot);
+
+    // 读请求返回时数据从slot拷贝到用户buf
+    memset(server.SlotData(readRequest.slot), 'b', 4096);
+    ASSERT_TRUE(server.PushCompletion({readRequest.id, 0}));
+    ASSERT_TRUE(server.PushCompletion({writeRequest.id, -1}));
+    ASSERT_TRUE(WaitCompleted(2));
+    ASSERT_EQ(0, read.ret);
+    ASSERT_EQ('b', readBuf[0]);
+    ASSERT_EQ('b', readBuf[4095]);
+    ASSERT_EQ(-1, write.ret);
+
+    // 未知的结果被忽略
+    ASSERT_TRUE(server.PushCompletion({writeRequest.id, 0}));
+
+    // slot释放后可以继续提交
+    ASSERT_TRUE(channel.Submit(&flush));
+    ShmRingRequest flushRequest;
+    ASSERT_TRUE(WaitRequest(&server, &flushRequest));
+    ASSERT_EQ(static_cast<uint32_t>(ShmRingOp::FLUSH), flushRequest.op);
+    ASSERT_NE(writeRequest.id, flushRequest.id);
+    ASSERT_TRUE(server.PushCompletion({flushRequest.id, 0}));
+    ASSERT_TRUE(WaitCompleted(3));
+    ASSERT_EQ(0, flush.ret);
+
+    channel.Fini();
+    ASSERT_FALSE(channel.IsBroken());
+    ASSERT_TRUE(resent.empty());
+}
+
+TEST_F(NebdShmChannelTest, ServerExitTest) {
+    std::atomic<int> resentCount(0);
+    NebdShmChannel channel(1, option_, [&](NebdClientAioContext* aioctx) {
+        resentCount.fetch_add(1);
+    });
+    ASSERT_EQ(0, channel.Init(path_));
+    ShmRing server;
+    ASSERT_EQ(0, server.Attach(path_));
+
+    // 以已退出的子进程模拟退出的part2
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        _exit(0);
+    }
+    ASSERT_EQ(pid, waitpid(pid, nullptr, 0));
+    server.SetServerPid(pid);
+
+    char buf[4096];
+    auto write = MakeContext(LIBAIO_OP::LIBAIO_OP_WRITE, buf, 4096);
+    ASSERT_TRUE(channel.Submit(&write));
+
+    // 进行中的请求改由rpc发送，之后的请求不再使用共享内存环
+    for (int i = 0; i < 100 && resentCount.load() == 0; i++) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(1, resentCount.load());
+    ASSERT_TRUE(channel.IsBroken());
+    ASSERT_FALSE(channel.Submit(&write));
+    ASSERT_EQ(0, completedCount.load());
+    channel.Fini();
+}
+
+TEST_F(NebdShmChannelTest, ResendTest) {
+    std::atomic<NebdClientAioContext*> resent(nullptr);
+    NebdShmChannel channel(1, option_, [&](NebdClientAioContext* aioctx) {
+        resent.store(aioctx);
+    });
+    ASSERT_EQ(0, channel.Init(path_));
+    ShmRing server;
+    ASSERT_EQ(0, server.Attach(path_));
+    server.SetServerPid(getpid());
+
+    char buf[4096];
+    auto write = MakeContext(LIBAIO_OP::LIBAIO_OP_WRITE, buf, 4096);
+    ASSERT_TRUE(channel.Submit(&write));
+    ShmRingRequest request;
+    ASSERT_TRUE(WaitRequest(&server, &request));
+
+    // part2不返回io错误时，请求改由rpc发送，通道仍然可用
+    ASSERT_TRUE(server.PushCompletion({request.id,
+                                       nebd::common::kShmRingResend}));
+    for (int i = 0; i < 100 && resent.load() == nullptr; i++) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(&write, resent.load());
+    ASSERT_EQ(0, completedCount.load());
+    ASSERT_FALSE(channel.IsBroken());
+
+    // slot已释放
+    auto read = MakeContext(LIBAIO_OP::LIBAIO_OP_READ, buf, 4096);
+    ASSERT_TRUE(channel.Submit(&write));
+    ASSERT_TRUE(channel.Submit(&read));
+    ASSERT_TRUE(WaitRequest(&server, &request));
+    ASSERT_TRUE(server.PushCompletion({request.id, 0}));
+    ASSERT_TRUE(WaitRequest(&server, &request));
+    ASSERT_TRUE(server.PushCompletion({request.id, 0}));
+    ASSERT_TRUE(WaitCompleted(2));
+    channel.Fini();
+}
+
+TEST_F(NebdShmChannelTest, FiniTimeoutTest) {
+    option_.finiTimeoutMs = 500;
+    std::atomic<int> resentCount(0);
+    NebdShmChannel channel(1, option_, [&](NebdClientAioContext* aioctx) {
+        resentCount.fetch_add(1);
+    });
+    ASSERT_EQ(0, channel.Init(path_));
+    ShmRing server;
+    ASSERT_EQ(0, server.Attach(path_));
+    server.SetServerPid(getpid());
+
+    char buf[4096];
+    auto write = MakeContext(LIBAIO_OP::LIBAIO_OP_WRITE, buf, 4096);
+    ASSERT_TRUE(channel.Submit(&write));
+
+    // part2一直不返回，Fini超时后请求失败返回
+    uint64_t startMs = nebd::common::TimeUtility::GetTimeofDayMs();
+    channel.Fini();
+    uint64_t costMs = nebd::common::TimeUtility::GetTimeofDayMs() - startMs;
+    ASSERT_GE(costMs, option_.finiTimeoutMs);
+    ASSERT_LT(costMs, 5 * option_.finiTimeoutMs);
+    ASSERT_EQ(1, completedCount.load());
+    ASSERT_EQ(-1, write.ret);
+    ASSERT_EQ(0, resentCount.load());
+
+    // 停止后不再接受请求
+    ASSERT_FALSE(channel.Submit(&write));
+}
+
+}  // namespace client
+}  // namespace nebd
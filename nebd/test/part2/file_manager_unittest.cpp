@@ -22,8 +22,12 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <string>
 #include <memory>
+#include <thread>  // NOLINT
+#include <chrono>  // NOLINT
 
 #include "nebd/src/part2/file_manager.h"
 #include "nebd/src/part2/file_entity.h"
@@ -402,6 +406,103 @@ TEST_F(FileManagerTest, CloseFailTest) {
     ASSERT_EQ(entity1->GetFileStatus(), NebdFileStatus::CLOSED);
 }
 
+TEST_F(FileManagerTest, FreezeTest) {
+    InitEnv();
+    ASSERT_FALSE(fileManager_->IsFrozen());
+    fileManager_->Freeze(getpid());
+    ASSERT_TRUE(fileManager_->IsFrozen());
+
+    // 冻结期间open和close都返回失败
+    EXPECT_CALL(*executor_, Open(_))
+    .Times(0);
+    EXPECT_CALL(*executor_, Close(_))
+    .Times(0);
+    ASSERT_EQ(-1, fileManager_->Open(testFile2));
+    ASSERT_EQ(-1, fileManager_->Close(1, true));
+    NebdFileEntityPtr entity1 = fileManager_->GetFileEntity(1);
+    ASSERT_NE(nullptr, entity1);
+    ASSERT_EQ(entity1->GetFileStatus(), NebdFileStatus::OPENED);
+
+    // 新进程存活期间不会自动解除冻结
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(fileManager_->IsFrozen());
+
+    // 放弃升级后解除冻结，并重新加载元数据
+    EXPECT_CALL(*metaFileManager_, Reload())
+    .WillOnce(Return(0));
+    fileManager_->Unfreeze();
+    ASSERT_FALSE(fileManager_->IsFrozen());
+    EXPECT_CALL(*executor_, Close(NotNull()))
+    .WillOnce(Return(0));
+    EXPECT_CALL(*metaFileManager_, RemoveFileMeta(testFile1))
+    .WillOnce(Return(0));
+    ASSERT_EQ(0, fileManager_->Close(1, true));
+
+    // 新进程退出后自动解除冻结
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        _exit(0);
+    }
+    ASSERT_EQ(pid, waitpid(pid, nullptr, 0));
+    fileManager_->Freeze(pid);
+    EXPECT_CALL(*metaFileManager_, Reload())
+    .WillOnce(Return(0));
+    ASSERT_FALSE(fileManager_->IsFrozen());
+    ASSERT_FALSE(fileManager_->IsFrozen());
+}
+
+TEST_F(FileManagerTest, ReloadTest) {
+    InitEnv();
+    NebdFileEntityPtr entity1 = fileManager_->GetFileEntity(1);
+    ASSERT_NE(nullptr, entity1);
+
+    // 旧进程关闭了file1，打开了file2
+    NebdFileMeta meta;
+    meta.fd = 2;
+    meta.fileName = testFile2;
+    std::vector<NebdFileMeta> fileMetas;
+    fileMetas.emplace_back(meta);
+
+    // 重新加载元数据失败
+    EXPECT_CALL(*metaFileManager_, Reload())
+    .WillOnce(Return(-1));
+    ASSERT_EQ(-1, fileManager_->Reload());
+    ASSERT_EQ(entity1, fileManager_->GetFileEntity(1));
+
+    // file1被close但不删除元数据，file2被reopen
+    EXPECT_CALL(*metaFileManager_, Reload())
+    .WillOnce(Return(0));
+    EXPECT_CALL(*metaFileManager_, ListFileMeta(_))
+    .WillOnce(DoAll(SetArgPointee<0>(fileMetas),
+                    Return(0)));
+    EXPECT_CALL(*executor_, Close(NotNull()))
+    .WillOnce(Return(0));
+    EXPECT_CALL(*metaFileManager_, RemoveFileMeta(_))
+    .Times(0);
+    EXPECT_CALL(*executor_, Reopen(testFile2, _))
+    .WillOnce(Return(mockInstance_));
+    EXPECT_CALL(*metaFileManager_, UpdateFileMeta(testFile2, _))
+    .WillOnce(Return(0));
+    ASSERT_EQ(0, fileManager_->Reload());
+    ASSERT_EQ(nullptr, fileManager_->GetFileEntity(1));
+    ASSERT_EQ(entity1->GetFileStatus(), NebdFileStatus::CLOSED);
+    NebdFileEntityPtr entity2 = fileManager_->GetFileEntity(2);
+    ASSERT_NE(nullptr, entity2);
+    ASSERT_EQ(entity2->GetFileStatus(), NebdFileStatus::OPENED);
+
+    // 元数据没有变化时不会重复reopen
+    EXPECT_CALL(*metaFileManager_, Reload())
+    .WillOnce(Return(0));
+    EXPECT_CALL(*metaFileManager_, ListFileMeta(_))
+    .WillOnce(DoAll(SetArgPointee<0>(fileMetas),
+                    Return(0)));
+    EXPECT_CALL(*executor_, Reopen(_, _))
+    .Times(0);
+    ASSERT_EQ(0, fileManager_->Reload());
+    ASSERT_EQ(entity2, fileManager_->GetFileEntity(2));
+}
+
 TEST_F(FileManagerTest, ExtendTest) {
     auto task = [&](int fd)->int {
         return fileManager_->Extend(fd, 4096);
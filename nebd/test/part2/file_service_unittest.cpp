@@ -24,10 +24,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <brpc/controller.h>
+#include <unistd.h>
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <chrono>  // NOLINT
+#include <vector>
 
 #include "nebd/src/part2/file_service.h"
 #include "nebd/test/part2/mock_file_manager.h"
+#include "nebd/test/part2/mock_metafile_manager.h"
+#include "nebd/test/part2/mock_request_executor.h"
 
 namespace nebd {
 namespace server {
@@ -44,11 +52,13 @@ using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 using ::testing::SaveArgPointee;
 using ::testing::SaveArg;
+using ::testing::Invoke;
 
 using google::protobuf::RpcController;
 using google::protobuf::Closure;
 
 using nebd::client::RetCode;
+using nebd::common::ShmRingOp;
 
 class FileServiceTestClosure : public Closure {
  public:
@@ -541,6 +551,378 @@ TEST_F(FileServiceTest, CallbackTest) {
     }
 }
 
+// 等待part2返回一个结果
+static bool WaitShmCompletion(ShmRing* ring, ShmRingCompletion* completion) {
+    for (int i = 0; i < 50; i++) {
+        if (ring->PopCompletion(completion)) {
+            return true;
+        }
+        ring->WaitCompletion(100);
+    }
+    return false;
+}
+
+TEST_F(FileServiceTest, AioBatchTest) {
+    int fd = 1;
+    const uint64_t kSize = 4096;
+    char writeBuf[2 * kSize];
+    memset(writeBuf, 'w', 2 * kSize);
+    char readBuf[kSize];
+    memset(readBuf, 'r', kSize);
+
+    nebd::client::AioBatchRequest request;
+    request.set_fd(fd);
+    for (auto op : {nebd::client::AioBatchOp::kBatchWrite,
+                    nebd::client::AioBatchOp::kBatchRead,
+                    nebd::client::AioBatchOp::kBatchWrite}) {
+        auto entry = request.add_entries();
+        entry->set_op(op);
+        entry->set_offset((request.entries_size() - 1) * kSize);
+        entry->set_size(kSize);
+    }
+
+    // attachment size not equal total write size
+    {
+        brpc::Controller cntl;
+        cntl.request_attachment().append(writeBuf, kSize);
+        nebd::client::AioBatchResponse response;
+        FileServiceTestClosure done;
+        EXPECT_CALL(*fileManager_, AioWrite(_, _))
+        .Times(0);
+        EXPECT_CALL(*fileManager_, AioRead(_, _))
+        .Times(0);
+        fileService_->AioBatch(&cntl, &request, &response, &done);
+        ASSERT_TRUE(done.IsRunned());
+        ASSERT_EQ(response.retcode(), RetCode::kNoOK);
+    }
+    // the last request returns the rpc, submit failure only fails its entry
+    {
+        brpc::Controller cntl;
+        cntl.request_attachment().append(writeBuf, 2 * kSize);
+        nebd::client::AioBatchResponse response;
+        FileServiceTestClosure done;
+        NebdServerAioContext* writeCtx = nullptr;
+        NebdServerAioContext* readCtx = nullptr;
+        EXPECT_CALL(*fileManager_, AioWrite(fd, NotNull()))
+        .WillOnce(DoAll(SaveArg<1>(&writeCtx), Return(0)))
+        .WillOnce(Return(-1));
+        EXPECT_CALL(*fileManager_, AioRead(fd, NotNull()))
+        .WillOnce(DoAll(SaveArg<1>(&readCtx), Return(0)));
+        fileService_->AioBatch(&cntl, &request, &response, &done);
+        ASSERT_FALSE(done.IsRunned());
+        ASSERT_EQ(0, writeCtx->offset);
+        ASSERT_EQ(kSize, readCtx->offset);
+
+        butil::IOBuf data;
+        data.append(writeBuf, kSize);
+        ASSERT_EQ(*reinterpret_cast<butil::IOBuf*>(writeCtx->buf), data);
+
+        reinterpret_cast<butil::IOBuf*>(readCtx->buf)->append(readBuf, kSize);
+        readCtx->ret = kSize;
+        readCtx->cb(readCtx);
+        ASSERT_FALSE(done.IsRunned());
+        writeCtx->ret = kSize;
+        writeCtx->cb(writeCtx);
+        ASSERT_TRUE(done.IsRunned());
+
+        ASSERT_EQ(response.retcode(), RetCode::kOK);
+        ASSERT_THAT(response.entryretcode(),
+                    ElementsAre(RetCode::kOK, RetCode::kOK, RetCode::kNoOK));
+        butil::IOBuf readData;
+        readData.append(readBuf, kSize);
+        ASSERT_EQ(cntl.response_attachment(), readData);
+    }
+    // io error and don't return rpc
+    {
+        brpc::Controller cntl;
+        cntl.request_attachment().append(writeBuf, 2 * kSize);
+        nebd::client::AioBatchResponse response;
+        FileServiceTestClosure* done = new FileServiceTestClosure();
+        std::vector<NebdServerAioContext*> ctxs;
+        auto save = [&](int fd, NebdServerAioContext* ctx) {
+            ctxs.push_back(ctx);
+            return 0;
+        };
+        EXPECT_CALL(*fileManager_, AioWrite(fd, NotNull()))
+        .Times(2)
+        .WillRepeatedly(Invoke(save));
+        EXPECT_CALL(*fileManager_, AioRead(fd, NotNull()))
+        .WillOnce(Invoke(save));
+        fileService_->AioBatch(&cntl, &request, &response, done);
+        ASSERT_EQ(3, ctxs.size());
+        ASSERT_FALSE(done->IsRunned());
+        for (auto ctx : ctxs) {
+            ctx->ret = ctx == ctxs[1] ? -1 : kSize;
+            ctx->cb(ctx);
+        }
+        ASSERT_EQ(response.retcode(), RetCode::kNoOK);
+    }
+}
+
+TEST_F(FileServiceTest, AioBatchWithFileEntityTest) {
+    // 使用真实的文件实体，batch中的请求都返回后文件的RequestGate排空，
+    // close不再阻塞
+    int fd = 1;
+    const uint64_t kSize = 4096;
+    char writeBuf[2 * kSize];
+    memset(writeBuf, 'w', 2 * kSize);
+    auto executor = std::make_shared<MockRequestExecutor>();
+    g_test_executor = executor.get();
+    auto metaFileManager = std::make_shared<MockMetaFileManager>();
+    auto entity = std::make_shared<NebdFileEntity>();
+    NebdFileEntityOption option;
+    option.fd = fd;
+    option.fileName = testFile1;
+    option.metaFileManager_ = metaFileManager;
+    ASSERT_EQ(0, entity->Init(option));
+    EXPECT_CALL(*executor, Open(testFile1))
+    .WillOnce(Return(std::make_shared<MockFileInstance>()));
+    EXPECT_CALL(*metaFileManager, UpdateFileMeta(testFile1, _))
+    .WillOnce(Return(0));
+    ASSERT_EQ(fd, entity->Open());
+
+    auto aioWrite = [&](int fd, NebdServerAioContext* ctx) {
+        return entity->AioWrite(ctx);
+    };
+    auto aioRead = [&](int fd, NebdServerAioContext* ctx) {
+        return entity->AioRead(ctx);
+    };
+    EXPECT_CALL(*fileManager_, AioWrite(fd, NotNull()))
+    .Times(2)
+    .WillRepeatedly(Invoke(aioWrite));
+    EXPECT_CALL(*fileManager_, AioRead(fd, NotNull()))
+    .WillOnce(Invoke(aioRead));
+    std::vector<NebdServerAioContext*> ctxs;
+    auto save = [&](NebdFileInstance* file, NebdServerAioContext* ctx) {
+        ctxs.push_back(ctx);
+        return 0;
+    };
+    EXPECT_CALL(*executor, AioWrite(NotNull(), NotNull()))
+    .Times(2)
+    .WillRepeatedly(Invoke(save));
+    EXPECT_CALL(*executor, AioRead(NotNull(), NotNull()))
+    .WillOnce(Invoke(save));
+
+    nebd::client::AioBatchRequest request;
+    request.set_fd(fd);
+    for (auto op : {nebd::client::AioBatchOp::kBatchWrite,
+                    nebd::client::AioBatchOp::kBatchRead,
+                    nebd::client::AioBatchOp::kBatchWrite}) {
+        auto entry = request.add_entries();
+        entry->set_op(op);
+        entry->set_offset((request.entries_size() - 1) * kSize);
+        entry->set_size(kSize);
+    }
+    brpc::Controller cntl;
+    cntl.request_attachment().append(writeBuf, 2 * kSize);
+    nebd::client::AioBatchResponse response;
+    FileServiceTestClosure done;
+    fileService_->AioBatch(&cntl, &request, &response, &done);
+    ASSERT_EQ(3, ctxs.size());
+    ASSERT_EQ(3, entity->GetInflightRequestCount());
+    ASSERT_FALSE(done.IsRunned());
+
+    // 请求未返回时close等待
+    EXPECT_CALL(*executor, Close(NotNull()))
+    .WillOnce(Return(0));
+    std::atomic<bool> closed(false);
+    std::atomic<int> closeRet(-1);
+    std::thread closeThread([&]() {
+        closeRet.store(entity->Close(false));
+        closed.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(closed.load());
+
+    for (auto ctx : ctxs) {
+        ctx->ret = kSize;
+        ctx->cb(ctx);
+    }
+    ASSERT_TRUE(done.IsRunned());
+    ASSERT_EQ(response.retcode(), RetCode::kOK);
+    ASSERT_EQ(0, entity->GetInflightRequestCount());
+
+    for (int i = 0; i < 500 && !closed.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!closed.load()) {
+        closeThread.detach();
+        FAIL() << "close is blocked by the finished batch requests";
+    }
+    closeThread.join();
+    ASSERT_EQ(0, closeRet.load());
+    ASSERT_EQ(NebdFileStatus::CLOSED, entity->GetFileStatus());
+    g_test_executor = nullptr;
+}
+
+TEST_F(FileServiceTest, ShmRingTest) {
+    int fd = 1;
+    const uint32_t kSlotSize = 8192;
+    std::string path = "./nebd_file_service_shm." + std::to_string(getpid());
+    ShmRing ring;
+    ASSERT_EQ(0, ring.Create(path, 4, kSlotSize));
+
+    brpc::Controller cntl;
+    nebd::client::AttachShmRingRequest request;
+    request.set_fd(fd);
+    request.set_path(path);
+    nebd::client::AttachShmRingResponse response;
+    FileServiceTestClosure done;
+
+    // 未启用共享内存环
+    fileService_->AttachShmRing(&cntl, &request, &response, &done);
+    ASSERT_EQ(response.retcode(), RetCode::kNoOK);
+    ASSERT_TRUE(done.IsRunned());
+
+    auto shmRingManager =
+        std::make_shared<NebdShmRingManager>(fileManager_, true);
+    fileService_ = std::make_shared<NebdFileServiceImpl>(
+        fileManager_, true, shmRingManager);
+
+    // 文件不存在
+    done.Reset();
+    EXPECT_CALL(*fileManager_, GetFileEntity(fd))
+    .WillOnce(Return(nullptr));
+    fileService_->AttachShmRing(&cntl, &request, &response, &done);
+    ASSERT_EQ(response.retcode(), RetCode::kNoOK);
+    ASSERT_TRUE(done.IsRunned());
+
+    // attach success
+    done.Reset();
+    EXPECT_CALL(*fileManager_, GetFileEntity(fd))
+    .WillOnce(Return(std::make_shared<NebdFileEntity>()));
+    fileService_->AttachShmRing(&cntl, &request, &response, &done);
+    ASSERT_EQ(response.retcode(), RetCode::kOK);
+    ASSERT_TRUE(done.IsRunned());
+    ASSERT_EQ(getpid(), ring.GetServerPid());
+
+    // 写请求直接引用slot中的数据
+    memset(ring.SlotData(1), 'a', kSlotSize);
+    EXPECT_CALL(*fileManager_, AioWrite(fd, NotNull()))
+    .WillOnce(Invoke([&](int, NebdServerAioContext* context) {
+        butil::IOBuf data;
+        data.append(std::string(kSlotSize, 'a'));
+        EXPECT_EQ(*reinterpret_cast<butil::IOBuf*>(context->buf), data);
+        EXPECT_EQ(4096, context->offset);
+        context->ret = 0;
+        context->cb(context);
+        return 0;
+    }));
+    ShmRingRequest shmRequest = {100,
+        static_cast<uint32_t>(ShmRingOp::WRITE), 1, 4096, kSlotSize};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ShmRingCompletion completion;
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(100, completion.id);
+    ASSERT_EQ(0, completion.ret);
+
+    // 读请求返回时数据拷贝到slot
+    EXPECT_CALL(*fileManager_, AioRead(fd, NotNull()))
+    .WillOnce(Invoke([&](int, NebdServerAioContext* context) {
+        reinterpret_cast<butil::IOBuf*>(context->buf)->append(
+            std::string(context->size, 'b'));
+        context->ret = 0;
+        context->cb(context);
+        return 0;
+    }));
+    shmRequest = {101, static_cast<uint32_t>(ShmRingOp::READ), 2, 0, 4096};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(101, completion.id);
+    ASSERT_EQ(0, completion.ret);
+    ASSERT_EQ(std::string(4096, 'b'), std::string(ring.SlotData(2), 4096));
+
+    // 请求返回失败
+    EXPECT_CALL(*fileManager_, Flush(fd, NotNull()))
+    .WillOnce(Invoke([&](int, NebdServerAioContext* context) {
+        context->ret = -1;
+        context->cb(context);
+        return 0;
+    }));
+    shmRequest = {102, static_cast<uint32_t>(ShmRingOp::FLUSH), 0, 0, 0};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(102, completion.id);
+    ASSERT_EQ(-1, completion.ret);
+
+    // 提交失败
+    EXPECT_CALL(*fileManager_, Discard(fd, NotNull()))
+    .WillOnce(Return(-1));
+    shmRequest = {103, static_cast<uint32_t>(ShmRingOp::DISCARD), 0, 0, 4096};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(103, completion.id);
+    ASSERT_EQ(-1, completion.ret);
+
+    // 非法请求
+    shmRequest = {104, static_cast<uint32_t>(ShmRingOp::READ), 0, 0,
+                  2 * kSlotSize};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(104, completion.id);
+    ASSERT_EQ(-1, completion.ret);
+
+    // detach后不再处理请求
+    nebd::client::DetachShmRingRequest detachRequest;
+    detachRequest.set_fd(fd);
+    nebd::client::DetachShmRingResponse detachResponse;
+    done.Reset();
+    fileService_->DetachShmRing(&cntl, &detachRequest, &detachResponse,
+                                &done);
+    ASSERT_EQ(detachResponse.retcode(), RetCode::kOK);
+    ASSERT_TRUE(done.IsRunned());
+    shmRequest = {105, static_cast<uint32_t>(ShmRingOp::FLUSH), 0, 0, 0};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ring.WaitCompletion(200);
+    ASSERT_FALSE(ring.PopCompletion(&completion));
+
+    ShmRing::Remove(path);
+}
+
+TEST_F(FileServiceTest, ShmRingNotReturnIoErrorTest) {
+    int fd = 1;
+    std::string path = "./nebd_file_service_shm." + std::to_string(getpid());
+    ShmRing ring;
+    ASSERT_EQ(0, ring.Create(path, 4, 4096));
+
+    auto shmRingManager =
+        std::make_shared<NebdShmRingManager>(fileManager_, false);
+    EXPECT_CALL(*fileManager_, GetFileEntity(fd))
+    .WillOnce(Return(std::make_shared<NebdFileEntity>()));
+    ASSERT_EQ(0, shmRingManager->Attach(fd, path));
+
+    // 不返回io错误时也要写入结果，由part1改走rpc重试，不能让part1一直等待
+    EXPECT_CALL(*fileManager_, AioWrite(fd, NotNull()))
+    .WillOnce(Invoke([&](int, NebdServerAioContext* context) {
+        context->ret = -1;
+        context->cb(context);
+        return 0;
+    }));
+    ShmRingRequest shmRequest = {100,
+        static_cast<uint32_t>(ShmRingOp::WRITE), 0, 0, 4096};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ShmRingCompletion completion;
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(100, completion.id);
+    ASSERT_EQ(nebd::common::kShmRingResend, completion.ret);
+
+    // 请求成功时正常返回
+    EXPECT_CALL(*fileManager_, Flush(fd, NotNull()))
+    .WillOnce(Invoke([&](int, NebdServerAioContext* context) {
+        context->ret = 0;
+        context->cb(context);
+        return 0;
+    }));
+    shmRequest = {101, static_cast<uint32_t>(ShmRingOp::FLUSH), 1, 0, 0};
+    ASSERT_TRUE(ring.PushRequest(shmRequest));
+    ASSERT_TRUE(WaitShmCompletion(&ring, &completion));
+    ASSERT_EQ(101, completion.id);
+    ASSERT_EQ(0, completion.ret);
+
+    shmRingManager->Fini();
+    ShmRing::Remove(path);
+}
+
 }  // namespace server
 }  // namespace nebd
 
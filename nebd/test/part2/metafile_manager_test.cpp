@@ -23,12 +23,16 @@
 #include <gtest/gtest.h>
 #include <json/json.h>
 #include <fstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "nebd/src/part2/metafile_manager.h"
 #include "nebd/test/part2/mock_posix_wrapper.h"
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::ReturnArg;
 
 namespace nebd {
 namespace server {
@@ -51,6 +55,19 @@ class MetaFileManagerTest : public ::testing::Test {
         unlink(metaPath);
         std::string tmpPath = std::string(metaPath) + ".tmp";
         unlink(tmpPath.c_str());
+        unlink(JournalPath().c_str());
+    }
+    std::string JournalPath() {
+        return std::string(metaPath) + ".journal";
+    }
+    int JournalLines() {
+        std::ifstream in(JournalPath());
+        std::string line;
+        int lines = 0;
+        while (std::getline(in, line)) {
+            ++lines;
+        }
+        return lines;
     }
     std::shared_ptr<common::MockPosixWrapper> wrapper_;
 };
@@ -143,6 +160,40 @@ TEST_F(MetaFileManagerTest, UpdateMetaFailTest) {
     ASSERT_EQ(-1, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
     ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
     ASSERT_EQ(0, fileMetas.size());
+
+    // open目录失败
+    EXPECT_CALL(*wrapper_, open(_, _, _))
+        .WillOnce(Return(1))
+        .WillOnce(Return(-1));
+    EXPECT_CALL(*wrapper_, pwrite(_, _, _, _))
+        .WillOnce(Return(root.toStyledString().size()));
+    EXPECT_CALL(*wrapper_, close(_))
+    .Times(1);
+    EXPECT_CALL(*wrapper_, rename(_, _))
+        .WillOnce(Return(0));
+    ASSERT_EQ(-1, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(0, fileMetas.size());
+
+    // sync目录失败
+    EXPECT_CALL(*wrapper_, open(_, _, _))
+        .WillOnce(Return(1))
+        .WillOnce(Return(10));
+    EXPECT_CALL(*wrapper_, pwrite(_, _, _, _))
+        .WillOnce(Return(root.toStyledString().size()));
+    EXPECT_CALL(*wrapper_, fsync(1))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, fsync(10))
+        .WillOnce(Return(-1));
+    EXPECT_CALL(*wrapper_, close(1))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(10))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, rename(_, _))
+        .WillOnce(Return(0));
+    ASSERT_EQ(-1, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(0, fileMetas.size());
 }
 
 TEST_F(MetaFileManagerTest, RemoveMetaFailTest) {
@@ -160,13 +211,18 @@ TEST_F(MetaFileManagerTest, RemoveMetaFailTest) {
     NebdMetaFileParser parser;
     Json::Value root = parser.ConvertFileMetasToJson(fileMetaMap);
 
-    // 先插入一条数据
+    // 先插入一条数据，rename之后sync元数据文件所在目录
     EXPECT_CALL(*wrapper_, open(_, _, _))
-        .WillOnce(Return(1));
+        .WillOnce(Return(1))
+        .WillOnce(Return(10));
     EXPECT_CALL(*wrapper_, pwrite(_, _, _, _))
         .WillOnce(Return(root.toStyledString().size()));
+    EXPECT_CALL(*wrapper_, fsync(1))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(*wrapper_, fsync(10))
+        .WillOnce(Return(0));
     EXPECT_CALL(*wrapper_, close(_))
-    .Times(1);
+    .Times(2);
     EXPECT_CALL(*wrapper_, rename(_, _))
         .WillOnce(Return(0));
     ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
@@ -208,6 +264,273 @@ TEST_F(MetaFileManagerTest, RemoveMetaFailTest) {
     ASSERT_EQ(1, fileMetas.size());
 }
 
+TEST_F(MetaFileManagerTest, JournalTest) {
+    NebdMetaFileManagerOption option;
+    option.metaFilePath = metaPath;
+    option.enableJournal = true;
+    NebdFileMeta fileMeta1;
+    fileMeta1.fileName = "cbd:volume1";
+    fileMeta1.fd = 1;
+    fileMeta1.xattr["session"] = "session1";
+    NebdFileMeta fileMeta2;
+    fileMeta2.fileName = "cbd:volume2";
+    fileMeta2.fd = 2;
+    std::vector<NebdFileMeta> fileMetas;
+
+    // 1. 变更只追加到journal，相同的内容不重复写入
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, JournalLines());
+        ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta1.fileName,
+                                                    fileMeta1));
+        ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta1.fileName,
+                                                    fileMeta1));
+        ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta2.fileName,
+                                                    fileMeta2));
+        ASSERT_EQ(0, metaFileManager.RemoveFileMeta(fileMeta2.fileName));
+        ASSERT_EQ(0, metaFileManager.RemoveFileMeta("unknown"));
+        ASSERT_EQ(3, JournalLines());
+    }
+
+    // 2. 重启后从journal恢复，并合并到元数据文件
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, JournalLines());
+        ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+        ASSERT_EQ(1, fileMetas.size());
+        ASSERT_EQ(fileMeta1, fileMetas[0]);
+        ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta2.fileName,
+                                                    fileMeta2));
+    }
+
+    // 3. journal末尾不完整的记录被忽略
+    {
+        std::ofstream out(JournalPath(), std::ios::app);
+        out << "{\"op\":0,\"filename\":\"cbd:volume3\"";
+    }
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+        ASSERT_EQ(2, fileMetas.size());
+    }
+
+    // 4. 未知op的记录视为损坏，之后的记录都不再重放
+    {
+        NebdMetaFileParser parser;
+        NebdMetaJournalRecord record;
+        record.op = MetaJournalOp::kRemove;
+        record.fileName = fileMeta1.fileName;
+        std::string line = parser.ConvertRecordToString(record);
+        Json::Value root;
+        root[kOp] = 100;
+        root[kFileName] = fileMeta2.fileName;
+        Json::FastWriter writer;
+        std::string jsonString = writer.write(root);
+        root[kCRC] = nebd::common::CRC32(jsonString.c_str(),
+                                         jsonString.size());
+        std::ofstream out(JournalPath(), std::ios::trunc);
+        out << writer.write(root) << line;
+    }
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+        ASSERT_EQ(2, fileMetas.size());
+    }
+
+    // 5. 关闭journal后仍会重放之前留下的journal
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, metaFileManager.RemoveFileMeta(fileMeta1.fileName));
+    }
+    option.enableJournal = false;
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+        ASSERT_EQ(1, fileMetas.size());
+        ASSERT_EQ(fileMeta2, fileMetas[0]);
+    }
+}
+
+TEST_F(MetaFileManagerTest, JournalCompactAndConcurrentTest) {
+    NebdMetaFileManagerOption option;
+    option.metaFilePath = metaPath;
+    option.enableJournal = true;
+    option.journalCompactBytes = 1024;
+
+    const int kThreadNum = 8;
+    const int kFilePerThread = 32;
+    {
+        NebdMetaFileManager metaFileManager;
+        ASSERT_EQ(0, metaFileManager.Init(option));
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kThreadNum; ++i) {
+            threads.emplace_back([&, i]() {
+                for (int j = 0; j < kFilePerThread; ++j) {
+                    NebdFileMeta fileMeta;
+                    fileMeta.fd = i * kFilePerThread + j;
+                    fileMeta.fileName = "cbd:volume" +
+                                        std::to_string(fileMeta.fd);
+                    ASSERT_EQ(0, metaFileManager.UpdateFileMeta(
+                        fileMeta.fileName, fileMeta));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    // 超过阈值后合并，journal中只保留最近的变更
+    ASSERT_LT(JournalLines(), kThreadNum * kFilePerThread);
+
+    NebdMetaFileManager metaFileManager;
+    ASSERT_EQ(0, metaFileManager.Init(option));
+    std::vector<NebdFileMeta> fileMetas;
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(kThreadNum * kFilePerThread, fileMetas.size());
+}
+
+TEST_F(MetaFileManagerTest, JournalWriteFailTest) {
+    NebdMetaFileManagerOption option;
+    option.metaFilePath = metaPath;
+    option.wrapper = wrapper_;
+    option.enableJournal = true;
+    NebdFileMeta fileMeta;
+    fileMeta.fileName = "cbd:volume1";
+    fileMeta.fd = 111;
+    std::vector<NebdFileMeta> fileMetas;
+
+    // 初始化时合并到元数据文件并创建journal
+    EXPECT_CALL(*wrapper_, open(_, _, _))
+        .WillOnce(Return(1))
+        .WillOnce(Return(10))
+        .WillOnce(Return(2));
+    EXPECT_CALL(*wrapper_, pwrite(1, _, _, _))
+        .WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*wrapper_, fsync(1))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, fsync(10))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, close(1))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(10))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, rename(_, _))
+        .WillOnce(Return(0));
+    NebdMetaFileManager metaFileManager;
+    ASSERT_EQ(0, metaFileManager.Init(option));
+
+    // 写journal失败，内存中的修改回滚
+    EXPECT_CALL(*wrapper_, pwrite(2, _, _, 0))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(-1, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(0, fileMetas.size());
+
+    // fsync失败
+    EXPECT_CALL(*wrapper_, open(_, _, _))
+        .WillOnce(Return(1))
+        .WillOnce(Return(10))
+        .WillOnce(Return(3));
+    EXPECT_CALL(*wrapper_, pwrite(1, _, _, _))
+        .WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*wrapper_, fsync(1))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, fsync(10))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, close(1))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(10))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(2))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, rename(_, _))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, pwrite(3, _, _, 0))
+        .WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*wrapper_, fsync(3))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(-1, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(0, fileMetas.size());
+
+    // 之前写入失败，先合并并重建journal再写入
+    EXPECT_CALL(*wrapper_, open(_, _, _))
+        .WillOnce(Return(1))
+        .WillOnce(Return(10))
+        .WillOnce(Return(4));
+    EXPECT_CALL(*wrapper_, pwrite(1, _, _, _))
+        .WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*wrapper_, fsync(1))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, fsync(10))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, close(1))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(10))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, close(3))
+        .Times(1);
+    EXPECT_CALL(*wrapper_, rename(_, _))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*wrapper_, pwrite(4, _, _, 0))
+        .WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*wrapper_, fsync(4))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, metaFileManager.UpdateFileMeta(fileMeta.fileName, fileMeta));
+    ASSERT_EQ(0, metaFileManager.ListFileMeta(&fileMetas));
+    ASSERT_EQ(1, fileMetas.size());
+
+    EXPECT_CALL(*wrapper_, close(4))
+        .Times(1);
+}
+
+TEST(MetaFileParserTest, ParseRecord) {
+    NebdMetaFileParser parser;
+    NebdMetaJournalRecord record;
+    record.op = MetaJournalOp::kUpdate;
+    record.fileName = "cbd:volume1";
+    record.meta.fileName = record.fileName;
+    record.meta.fd = 1;
+    record.meta.xattr["session"] = "session1";
+
+    std::string line = parser.ConvertRecordToString(record);
+    ASSERT_EQ('\n', line.back());
+    NebdMetaJournalRecord parsed;
+    ASSERT_EQ(0, parser.ParseRecord(line, &parsed));
+    ASSERT_EQ(MetaJournalOp::kUpdate, parsed.op);
+    ASSERT_EQ(record.meta, parsed.meta);
+
+    // crc校验不正确
+    std::string corrupted = line;
+    corrupted[corrupted.find("session1")] = 'S';
+    ASSERT_EQ(-1, parser.ParseRecord(corrupted, &parsed));
+
+    // 不完整的记录
+    ASSERT_EQ(-1, parser.ParseRecord(line.substr(0, line.size() / 2),
+                                     &parsed));
+
+    record.op = MetaJournalOp::kRemove;
+    line = parser.ConvertRecordToString(record);
+    ASSERT_EQ(0, parser.ParseRecord(line, &parsed));
+    ASSERT_EQ(MetaJournalOp::kRemove, parsed.op);
+    ASSERT_EQ(record.fileName, parsed.fileName);
+
+    // 未知的op
+    Json::Value root;
+    root[kOp] = 100;
+    root[kFileName] = record.fileName;
+    Json::FastWriter writer;
+    std::string jsonString = writer.write(root);
+    root[kCRC] = nebd::common::CRC32(jsonString.c_str(), jsonString.size());
+    ASSERT_EQ(-1, parser.ParseRecord(writer.write(root), &parsed));
+}
+
 TEST(MetaFileParserTest, Parse) {
     NebdMetaFileParser parser;
     Json::Value root;
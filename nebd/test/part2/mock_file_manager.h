@@ -50,6 +50,10 @@ class MockFileManager : public NebdFileManager {
     MOCK_METHOD1(InvalidCache, int(int));
     MOCK_METHOD1(GetFileEntity, NebdFileEntityPtr(int));
     MOCK_METHOD0(GetFileEntityMap, FileEntityMap());
+    MOCK_METHOD1(Freeze, void(int32_t));
+    MOCK_METHOD0(Unfreeze, void());
+    MOCK_METHOD0(IsFrozen, bool());
+    MOCK_METHOD0(Reload, int());
 };
 
 }  // namespace server
@@ -41,6 +41,7 @@ class MockMetaFileManager : public NebdMetaFileManager {
     MOCK_METHOD1(ListFileMeta, int(std::vector<NebdFileMeta>*));
     MOCK_METHOD2(UpdateFileMeta, int(const std::string&, const NebdFileMeta&));
     MOCK_METHOD1(RemoveFileMeta, int(const std::string&));
+    MOCK_METHOD0(Reload, int());
 };
 
 }  // namespace server
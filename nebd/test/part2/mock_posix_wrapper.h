@@ -37,6 +37,7 @@ class MockPosixWrapper : public PosixWrapper {
     MOCK_METHOD2(rename, int(const char *, const char *));
     MOCK_METHOD4(pwrite, ssize_t(int fd, const void *buf,
                                  size_t count, off_t offset));
+    MOCK_METHOD1(fsync, int(int));
 };
 
 }   // namespace common
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <gflags/gflags.h>
+#include <brpc/channel.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "nebd/proto/client.pb.h"
+#include "nebd/proto/heartbeat.pb.h"
+#include "nebd/src/part2/nebd_server.h"
+#include "nebd/test/part2/mock_curve_client.h"
+
+DECLARE_bool(upgrade);
+DECLARE_uint32(upgradeTimeoutMs);
+
+namespace nebd {
+namespace server {
+
+using ::testing::NiceMock;
+
+const char kUpgradeConfPath[] = "./nebd/test/part2/nebd-server-upgrade.conf";
+const char kUpgradeListenAddress[] = "/tmp/nebd-server-upgrade-test.sock";
+const char kUpgradeMetaPath[] = "./nebd-server-upgrade-test.meta";
+
+static void PrepareUpgradeConf() {
+    Configuration conf;
+    conf.SetConfigPath(kUpgradeConfPath);
+    conf.SetStringValue("listen.address", kUpgradeListenAddress);
+    conf.SetStringValue("curveclient.confPath", "/etc/curve/client.conf");
+    conf.SetStringValue("meta.file.path", kUpgradeMetaPath);
+    conf.SetIntValue("heartbeat.timeout.sec", 30);
+    conf.SetIntValue("heartbeat.check.interval.ms", 3000);
+    conf.SetBoolValue("response.returnRpcWhenIoError", false);
+    conf.SaveConfig();
+    unlink(kUpgradeListenAddress);
+    unlink(kUpgradeMetaPath);
+}
+
+// 通过心跳rpc判断监听地址上是否有nebd-server在服务
+static bool KeepAlive() {
+    brpc::Channel channel;
+    if (channel.InitWithSockFile(kUpgradeListenAddress, nullptr) != 0) {
+        return false;
+    }
+    nebd::client::NebdHeartbeatService_Stub stub(&channel);
+    nebd::client::HeartbeatRequest request;
+    nebd::client::HeartbeatResponse response;
+    request.set_pid(getpid());
+    request.set_nebdversion("0.0.1");
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(1000);
+    stub.KeepAlive(&cntl, &request, &response, nullptr);
+    return !cntl.Failed() &&
+           response.retcode() == nebd::client::RetCode::kOK;
+}
+
+static bool WaitKeepAlive(int timeoutSec) {
+    for (int i = 0; i < timeoutSec * 10; ++i) {
+        if (KeepAlive()) {
+            return true;
+        }
+        usleep(100 * 1000);
+    }
+    return false;
+}
+
+// 旧进程必须在本进程使用brpc之前fork出来，所以放在第一个用例
+TEST(TestNebdServerUpgrade, take_over_old_server) {
+    PrepareUpgradeConf();
+    pid_t oldPid = fork();
+    ASSERT_GE(oldPid, 0);
+    if (oldPid == 0) {
+        // 旧进程正常启动，收到SIGTERM后退出
+        NebdServer oldServer;
+        auto curveClient = std::make_shared<NiceMock<MockCurveClient>>();
+        if (oldServer.Init(kUpgradeConfPath, curveClient) != 0) {
+            _exit(1);
+        }
+        int ret = oldServer.RunUntilAskedToQuit();
+        oldServer.Fini();
+        _exit(ret == 0 ? 0 : 2);
+    }
+    ASSERT_TRUE(WaitKeepAlive(10));
+
+    // 新进程初始化时冻结旧进程
+    FLAGS_upgrade = true;
+    FLAGS_upgradeTimeoutMs = 10000;
+    NebdServer newServer;
+    auto curveClient = std::make_shared<NiceMock<MockCurveClient>>();
+    ASSERT_EQ(0, newServer.Init(kUpgradeConfPath, curveClient));
+
+    // 冻结期间旧进程拒绝open，由part1重试到新进程
+    {
+        brpc::Channel channel;
+        ASSERT_EQ(0, channel.InitWithSockFile(kUpgradeListenAddress,
+                                              nullptr));
+        nebd::client::NebdFileService_Stub stub(&channel);
+        nebd::client::OpenFileRequest request;
+        nebd::client::OpenFileResponse response;
+        request.set_filename("test:/cinder/111");
+        brpc::Controller cntl;
+        stub.OpenFile(&cntl, &request, &response, nullptr);
+        ASSERT_TRUE(cntl.Failed());
+        ASSERT_EQ(EAGAIN, cntl.ErrorCode());
+    }
+
+    // 新进程接管监听地址，旧进程收到SIGTERM后退出
+    std::thread newServerThread(&NebdServer::RunUntilAskedToQuit, &newServer);
+    int status = 0;
+    ASSERT_EQ(oldPid, waitpid(oldPid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    // 监听地址由新进程服务
+    ASSERT_TRUE(WaitKeepAlive(10));
+    ASSERT_EQ(-1, access((std::string(kUpgradeListenAddress)
+                          + ".upgrade").c_str(), F_OK));
+
+    ASSERT_EQ(0, newServer.Fini());
+    newServerThread.join();
+    FLAGS_upgrade = false;
+}
+
+TEST(TestNebdServerUpgrade, upgrade_without_old_server) {
+    PrepareUpgradeConf();
+    // 没有旧进程时prepare upgrade失败
+    FLAGS_upgrade = true;
+    NebdServer server;
+    auto curveClient = std::make_shared<NiceMock<MockCurveClient>>();
+    ASSERT_EQ(-1, server.Init(kUpgradeConfPath, curveClient));
+    FLAGS_upgrade = false;
+}
+
+}  // namespace server
+}  // namespace nebd
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -392,6 +392,88 @@ TEST_F(TestReuqestExecutorCurve, test_Flush) {
     ASSERT_EQ(response.retcode(), nebd::client::RetCode::kOK);
 }
 
+TEST_F(TestReuqestExecutorCurve, test_FlushWaitWrites) {
+    auto executor = CurveRequestExecutor::GetInstance();
+    std::string curveFilename("/cinder/volume-1234_cinder_");
+    std::unique_ptr<CurveFileInstance> curveFileIns(new CurveFileInstance());
+    curveFileIns->fd = 1;
+    curveFileIns->fileName = curveFilename;
+
+    char buf[8];
+    NebdServerAioContext writeCtx[3];
+    for (auto& ctx : writeCtx) {
+        ctx.op = LIBAIO_OP::LIBAIO_OP_WRITE;
+        ctx.offset = 0;
+        ctx.size = sizeof(buf);
+        ctx.buf = buf;
+        ctx.cb = NebdUnitTestCallback;
+    }
+    CurveAioContext* curveCtx[3];
+    EXPECT_CALL(*curveClient_, AioWrite(1, _, _))
+        .WillOnce(DoAll(SaveArg<1>(&curveCtx[0]),
+                        Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SaveArg<1>(&curveCtx[1]),
+                        Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SaveArg<1>(&curveCtx[2]),
+                        Return(LIBCURVE_ERROR::OK)));
+
+    auto newFlushCtx = [](nebd::client::FlushResponse* response,
+                          TestReuqestExecutorCurveClosure* done) {
+        NebdServerAioContext* aioctx = new NebdServerAioContext();
+        aioctx->op = LIBAIO_OP::LIBAIO_OP_FLUSH;
+        aioctx->cb = NebdFileServiceCallback;
+        aioctx->response = response;
+        aioctx->done = done;
+        aioctx->returnRpcWhenIoError = true;
+        return aioctx;
+    };
+
+    // 1. flush等待之前下发的写请求全部返回
+    nebd::client::FlushResponse response1;
+    TestReuqestExecutorCurveClosure done1;
+    ASSERT_EQ(0, executor.AioWrite(curveFileIns.get(), &writeCtx[0]));
+    ASSERT_EQ(0, executor.AioWrite(curveFileIns.get(), &writeCtx[1]));
+    ASSERT_EQ(0, executor.Flush(curveFileIns.get(),
+                                newFlushCtx(&response1, &done1)));
+    ASSERT_FALSE(done1.IsRunned());
+
+    // 2. flush之后下发的写请求不影响之前的flush
+    nebd::client::FlushResponse response2;
+    TestReuqestExecutorCurveClosure done2;
+    ASSERT_EQ(0, executor.AioWrite(curveFileIns.get(), &writeCtx[2]));
+    ASSERT_EQ(0, executor.Flush(curveFileIns.get(),
+                                newFlushCtx(&response2, &done2)));
+    ASSERT_EQ(3, curveFileIns->writeBarrier->InflightWrites());
+
+    // 写请求乱序返回
+    curveCtx[1]->ret = sizeof(buf);
+    curveCtx[1]->cb(curveCtx[1]);
+    ASSERT_FALSE(done1.IsRunned());
+    curveCtx[0]->ret = sizeof(buf);
+    curveCtx[0]->cb(curveCtx[0]);
+    ASSERT_TRUE(done1.IsRunned());
+    ASSERT_EQ(nebd::client::RetCode::kOK, response1.retcode());
+    ASSERT_FALSE(done2.IsRunned());
+
+    // 3. 之前的写请求失败时flush返回失败
+    curveCtx[2]->ret = -LIBCURVE_ERROR::FAILED;
+    curveCtx[2]->cb(curveCtx[2]);
+    ASSERT_TRUE(done2.IsRunned());
+    ASSERT_EQ(nebd::client::RetCode::kNoOK, response2.retcode());
+    ASSERT_EQ(0, curveFileIns->writeBarrier->InflightWrites());
+
+    // 4. 下发失败的写请求不再等待
+    nebd::client::FlushResponse response3;
+    TestReuqestExecutorCurveClosure done3;
+    EXPECT_CALL(*curveClient_, AioWrite(1, _, _))
+        .WillOnce(Return(LIBCURVE_ERROR::FAILED));
+    ASSERT_EQ(-1, executor.AioWrite(curveFileIns.get(), &writeCtx[0]));
+    ASSERT_EQ(0, executor.Flush(curveFileIns.get(),
+                                newFlushCtx(&response3, &done3)));
+    ASSERT_TRUE(done3.IsRunned());
+    ASSERT_EQ(nebd::client::RetCode::kOK, response3.retcode());
+}
+
 TEST_F(TestReuqestExecutorCurve, test_InvalidCache) {
     auto executor = CurveRequestExecutor::GetInstance();
     std::string curveFilename("/cinder/volume-1234_cinder_");
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Project: nebd
+ * Create Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <brpc/channel.h>
+#include <brpc/server.h>
+#include <unistd.h>
+#include <string>
+
+#include "nebd/proto/upgrade.pb.h"
+#include "nebd/src/part2/upgrade_service.h"
+#include "nebd/test/part2/mock_file_manager.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+namespace nebd {
+namespace server {
+
+const std::string kSockFile_ = "/tmp/upgrade_service_test.sock";  // NOLINT
+
+class UpgradeServiceTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        fileManager_ = std::make_shared<MockFileManager>();
+    }
+    std::shared_ptr<MockFileManager> fileManager_;
+};
+
+TEST_F(UpgradeServiceTest, PrepareAndAbort) {
+    // 启动server
+    brpc::Server server;
+    NebdUpgradeServiceImpl upgradeService(fileManager_);
+    ASSERT_EQ(0, server.AddService(&upgradeService,
+                        brpc::SERVER_DOESNT_OWN_SERVICE));
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(0, server.StartAtSockFile(kSockFile_.c_str(), &option));
+
+    brpc::Channel channel;
+    ASSERT_EQ(0, channel.InitWithSockFile(kSockFile_.c_str(), nullptr));
+    nebd::client::NebdUpgradeService_Stub stub(&channel);
+
+    // 按新进程的pid冻结，并返回本进程的pid
+    nebd::client::PrepareUpgradeRequest prepareRequest;
+    nebd::client::PrepareUpgradeResponse prepareResponse;
+    prepareRequest.set_pid(12345);
+    brpc::Controller cntl;
+    EXPECT_CALL(*fileManager_, Freeze(12345))
+        .Times(1);
+    stub.PrepareUpgrade(&cntl, &prepareRequest, &prepareResponse, nullptr);
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(nebd::client::RetCode::kOK, prepareResponse.retcode());
+    ASSERT_TRUE(prepareResponse.has_pid());
+    ASSERT_EQ(getpid(), prepareResponse.pid());
+
+    // 放弃升级时解除冻结
+    nebd::client::AbortUpgradeRequest abortRequest;
+    nebd::client::AbortUpgradeResponse abortResponse;
+    cntl.Reset();
+    EXPECT_CALL(*fileManager_, Unfreeze())
+        .Times(1);
+    stub.AbortUpgrade(&cntl, &abortRequest, &abortResponse, nullptr);
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(nebd::client::RetCode::kOK, abortResponse.retcode());
+
+    // 停止server
+    server.Stop(0);
+    server.Join();
+}
+
+}  // namespace server
+}  // namespace nebd
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -26,6 +26,7 @@
 #include <brpc/closure_guard.h>
 #include <brpc/controller.h>
 
+#include <atomic>
 #include <memory>
 #include <cerrno>
 #include <vector>
@@ -39,6 +40,155 @@
 namespace curve {
 namespace chunkserver {
 
+namespace {
+
+/**
+ * 批量删除的上下文，批量请求拆成每个chunk一个DeleteChunkRequest提交给raft，
+ * 所有子请求都返回后汇总结果并返回批量请求
+ */
+class DeleteChunkBatchContext {
+ public:
+    DeleteChunkBatchContext(const DeleteChunkBatchRequest *request,
+                            DeleteChunkBatchResponse *response,
+                            Closure *done)
+        : response_(response),
+          done_(done),
+          subRequests_(request->chunkid_size()),
+          subResponses_(request->chunkid_size()),
+          pending_(request->chunkid_size()) {
+        for (int i = 0; i < request->chunkid_size(); i++) {
+            ChunkRequest &subRequest = subRequests_[i];
+            subRequest.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+            subRequest.set_logicpoolid(request->logicpoolid());
+            subRequest.set_copysetid(request->copysetid());
+            subRequest.set_chunkid(request->chunkid(i));
+            subRequest.set_sn(request->sn());
+        }
+    }
+
+    ChunkRequest *SubRequest(int i) { return &subRequests_[i]; }
+    ChunkResponse *SubResponse(int i) { return &subResponses_[i]; }
+
+    void OnSubRequestDone() {
+        if (pending_.fetch_sub(1) != 1) {
+            return;
+        }
+        std::unique_ptr<DeleteChunkBatchContext> selfGuard(this);
+        brpc::ClosureGuard doneGuard(done_);
+        CHUNK_OP_STATUS status = CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+        for (auto &subResponse : subResponses_) {
+            CHUNK_OP_STATUS subStatus = subResponse.status();
+            response_->add_chunkstatus(subStatus);
+            if (subStatus == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS ||
+                subStatus == CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST) {
+                continue;
+            }
+            // 只要有一个子请求被重定向，就让mds刷新leader后重试整个批量
+            if (status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS ||
+                subStatus == CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED) {
+                status = subStatus;
+            }
+        }
+        response_->set_status(status);
+    }
+
+ private:
+    DeleteChunkBatchResponse *response_;
+    Closure *done_;
+    std::vector<ChunkRequest> subRequests_;
+    std::vector<ChunkResponse> subResponses_;
+    std::atomic<int> pending_;
+};
+
+class DeleteChunkBatchSubClosure : public Closure {
+ public:
+    explicit DeleteChunkBatchSubClosure(DeleteChunkBatchContext *ctx)
+        : ctx_(ctx) {}
+
+    void Run() override {
+        std::unique_ptr<DeleteChunkBatchSubClosure> selfGuard(this);
+        ctx_->OnSubRequestDone();
+    }
+
+ private:
+    DeleteChunkBatchContext *ctx_;
+};
+
+/**
+ * 批量恢复的上下文，批量请求拆成每个chunk一个RecoverChunk请求交给clone manager，
+ * 所有子请求都返回后汇总结果并返回批量请求
+ */
+class RecoverChunkBatchContext {
+ public:
+    RecoverChunkBatchContext(const ChunkRequest *request,
+                             ChunkResponse *response,
+                             Closure *done)
+        : response_(response),
+          done_(done),
+          subRequests_(request->clonechunks_size()),
+          subResponses_(request->clonechunks_size()),
+          pending_(request->clonechunks_size()) {
+        for (int i = 0; i < request->clonechunks_size(); i++) {
+            const CloneChunkDesc &desc = request->clonechunks(i);
+            ChunkRequest &subRequest = subRequests_[i];
+            subRequest.set_optype(CHUNK_OP_TYPE::CHUNK_OP_RECOVER);
+            subRequest.set_logicpoolid(request->logicpoolid());
+            subRequest.set_copysetid(request->copysetid());
+            subRequest.set_chunkid(desc.chunkid());
+            subRequest.set_offset(desc.offset());
+            subRequest.set_size(desc.size());
+        }
+    }
+
+    ChunkRequest *SubRequest(int i) { return &subRequests_[i]; }
+    ChunkResponse *SubResponse(int i) { return &subResponses_[i]; }
+
+    void OnSubRequestDone() {
+        if (pending_.fetch_sub(1) != 1) {
+            return;
+        }
+        std::unique_ptr<RecoverChunkBatchContext> selfGuard(this);
+        brpc::ClosureGuard doneGuard(done_);
+        CHUNK_OP_STATUS status = CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+        for (auto &subResponse : subResponses_) {
+            CHUNK_OP_STATUS subStatus = subResponse.status();
+            response_->add_chunkstatus(subStatus);
+            if (subStatus == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+                continue;
+            }
+            // 只要有一个子请求被重定向，就让client刷新leader后重试整个批量
+            if (status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS ||
+                subStatus == CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED) {
+                status = subStatus;
+            }
+        }
+        response_->set_status(status);
+    }
+
+ private:
+    ChunkResponse *response_;
+    Closure *done_;
+    std::vector<ChunkRequest> subRequests_;
+    std::vector<ChunkResponse> subResponses_;
+    std::atomic<int> pending_;
+};
+
+class RecoverChunkBatchSubClosure : public Closure {
+ public:
+    explicit RecoverChunkBatchSubClosure(RecoverChunkBatchContext *ctx)
+        : ctx_(ctx) {}
+
+    void Run() override {
+        std::unique_ptr<RecoverChunkBatchSubClosure> selfGuard(this);
+        ctx_->OnSubRequestDone();
+    }
+
+ private:
+    RecoverChunkBatchContext *ctx_;
+};
+
+}  // namespace
+
 ChunkServiceImpl::ChunkServiceImpl(ChunkServiceOptions chunkServiceOptions) :
     chunkServiceOptions_(chunkServiceOptions),
     copysetNodeManager_(chunkServiceOptions.copysetNodeManager),
@@ -86,6 +236,63 @@ void ChunkServiceImpl::DeleteChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::DeleteChunkBatch(RpcController *controller,
+                                        const DeleteChunkBatchRequest *request,
+                                        DeleteChunkBatchResponse *response,
+                                        Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               nullptr,
+                                               nullptr,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "DeleteChunkBatch: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    if (request->chunkid_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        return;
+    }
+
+    // check the existence of the copyset
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "delete chunk batch failed, "
+                     << "copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    if (!nodePtr->IsLeaderTerm()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+        return;
+    }
+
+    DeleteChunkBatchContext *ctx = new (std::nothrow) DeleteChunkBatchContext(
+        request, response, doneGuard.release());
+    CHECK(nullptr != ctx) << "new delete chunk batch context failed";
+    for (int i = 0; i < request->chunkid_size(); i++) {
+        std::shared_ptr<DeleteChunkRequest>
+            req = std::make_shared<DeleteChunkRequest>(
+                nodePtr,
+                controller,
+                ctx->SubRequest(i),
+                ctx->SubResponse(i),
+                new DeleteChunkBatchSubClosure(ctx));
+        req->Process();
+    }
+}
+
 void ChunkServiceImpl::WriteChunk(RpcController *controller,
                                   const ChunkRequest *request,
                                   ChunkResponse *response,
@@ -305,6 +512,219 @@ void ChunkServiceImpl::RecoverChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::CreateCloneChunkBatch(RpcController *controller,
+                                             const ChunkRequest *request,
+                                             ChunkResponse *response,
+                                             Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "CreateCloneChunkBatch: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    if (request->optype() != CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH ||
+        request->clonechunks_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        LOG(ERROR) << "Invalid create clone chunk batch request, op: "
+                   << request->optype()
+                   << " chunk num: " << request->clonechunks_size();
+        return;
+    }
+
+    // the size of the chunk doesn't match the size configured in the copyset
+    for (const auto &desc : request->clonechunks()) {
+        if (desc.size() != maxChunkSize_) {
+            response->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+            DVLOG(9) << "Invalid chunk size: " << request->optype()
+                     << " request size: " << desc.size()
+                     << " copyset size: " << maxChunkSize_;
+            return;
+        }
+    }
+
+    // check the existence of the copyset
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "create clone chunk batch failed, "
+                     << "copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<CreateCloneChunkBatchRequest>
+        req = std::make_shared<CreateCloneChunkBatchRequest>(
+            nodePtr,
+            controller,
+            request,
+            response,
+            doneGuard.release());
+    req->Process();
+}
+
+void ChunkServiceImpl::RecoverChunkBatch(RpcController *controller,
+                                         const ChunkRequest *request,
+                                         ChunkResponse *response,
+                                         Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               nullptr,
+                                               nullptr,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "RecoverChunkBatch: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    if (request->clonechunks_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        return;
+    }
+
+    // check whether the params of the request are legal
+    for (const auto &desc : request->clonechunks()) {
+        if (!CheckRequestOffsetAndLength(desc.offset(), desc.size())) {
+            response->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+            LOG(ERROR) << "I/O request, op: RecoverChunkBatch"
+                       << " chunkid: " << desc.chunkid()
+                       << " offset: " << desc.offset()
+                       << " size: " << desc.size()
+                       << " max size: " << maxChunkSize_;
+            return;
+        }
+    }
+
+    // check the existence of the copyset
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "recover chunk batch failed, "
+                     << "copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    if (!nodePtr->IsLeaderTerm()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+        return;
+    }
+
+    RecoverChunkBatchContext *ctx = new (std::nothrow) RecoverChunkBatchContext(
+        request, response, doneGuard.release());
+    CHECK(nullptr != ctx) << "new recover chunk batch context failed";
+    for (int i = 0; i < request->clonechunks_size(); i++) {
+        // RecoverChunk request shares ReadChunkRequest with ReadChunk request
+        std::shared_ptr<ReadChunkRequest>
+            req = std::make_shared<ReadChunkRequest>(
+                nodePtr,
+                chunkServiceOptions_.cloneManager,
+                controller,
+                ctx->SubRequest(i),
+                ctx->SubResponse(i),
+                new RecoverChunkBatchSubClosure(ctx));
+        req->Process();
+    }
+}
+
+void ChunkServiceImpl::WriteChunkBulk(RpcController *controller,
+                                      const ChunkRequest *request,
+                                      ChunkResponse *response,
+                                      Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "WriteChunkBulk: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    if (request->optype() != CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK ||
+        request->clonechunks_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        LOG(ERROR) << "Invalid write chunk bulk request, op: "
+                   << request->optype()
+                   << " chunk num: " << request->clonechunks_size();
+        return;
+    }
+
+    // check whether the params of the request are legal, and the data of all
+    // ranges are carried by the attachment
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+    uint64_t totalSize = 0;
+    for (const auto &desc : request->clonechunks()) {
+        if (!CheckRequestOffsetAndLength(desc.offset(), desc.size())) {
+            response->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+            LOG(ERROR) << "I/O request, op: WriteChunkBulk"
+                       << " chunkid: " << desc.chunkid()
+                       << " offset: " << desc.offset()
+                       << " size: " << desc.size()
+                       << " max size: " << maxChunkSize_;
+            return;
+        }
+        totalSize += desc.size();
+    }
+    if (totalSize != cntl->request_attachment().size()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        LOG(ERROR) << "Invalid write chunk bulk request, data size: "
+                   << totalSize
+                   << " attachment size: "
+                   << cntl->request_attachment().size();
+        return;
+    }
+
+    // check the existence of the copyset
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "write chunk bulk failed, "
+                     << "copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<WriteChunkBulkRequest>
+        req = std::make_shared<WriteChunkBulkRequest>(
+            nodePtr,
+            controller,
+            request,
+            response,
+            doneGuard.release());
+    req->Process();
+}
+
 void ChunkServiceImpl::ReadChunkSnapshot(RpcController *controller,
                                          const ChunkRequest *request,
                                          ChunkResponse *response,
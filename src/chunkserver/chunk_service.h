@@ -48,6 +48,11 @@ class ChunkServiceImpl : public ChunkService {
                      ChunkResponse *response,
                      Closure *done);
 
+    void DeleteChunkBatch(RpcController *controller,
+                          const DeleteChunkBatchRequest *request,
+                          DeleteChunkBatchResponse *response,
+                          Closure *done);
+
     void ReadChunk(RpcController *controller,
                    const ChunkRequest *request,
                    ChunkResponse *response,
@@ -81,6 +86,21 @@ class ChunkServiceImpl : public ChunkService {
                       ChunkResponse *response,
                       Closure *done);
 
+    void CreateCloneChunkBatch(RpcController *controller,
+                               const ChunkRequest *request,
+                               ChunkResponse *response,
+                               Closure *done);
+
+    void RecoverChunkBatch(RpcController *controller,
+                           const ChunkRequest *request,
+                           ChunkResponse *response,
+                           Closure *done);
+
+    void WriteChunkBulk(RpcController *controller,
+                        const ChunkRequest *request,
+                        ChunkResponse *response,
+                        Closure *done);
+
     void GetChunkInfo(RpcController *controller,
                       const GetChunkInfoRequest *request,
                       GetChunkInfoResponse *response,
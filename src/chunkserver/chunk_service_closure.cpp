@@ -67,7 +67,8 @@ void ChunkServiceClosure::OnRequest() {
                               CSIOMetricType::READ_CHUNK);
             break;
         }
-        case CHUNK_OP_TYPE::CHUNK_OP_WRITE: {
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK: {
             metric->OnRequest(request_->logicpoolid(),
                               request_->copysetid(),
                               CSIOMetricType::WRITE_CHUNK);
@@ -117,7 +118,8 @@ void ChunkServiceClosure::OnResonse() {
                                hasError);
             break;
         }
-        case CHUNK_OP_TYPE::CHUNK_OP_WRITE: {
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK: {
             hasError = response_->status()
                        != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
             metric->OnResponse(request_->logicpoolid(),
@@ -43,6 +43,7 @@
 #include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 #include "src/common/curve_version.h"
+#include "src/common/string_util.h"
 
 using ::curve::fs::LocalFileSystem;
 using ::curve::fs::LocalFileSystemOption;
@@ -164,6 +165,12 @@ int ChunkServer::Run(int argc, char** argv) {
     // Remote copy management module options
     CopyerOptions copyerOptions;
     InitCopyerOptions(&conf, &copyerOptions);
+    CloneSourceCacheOptions sourceCacheOptions;
+    InitCloneSourceCacheOptions(&conf, &sourceCacheOptions);
+    if (sourceCacheOptions.enable) {
+        copyerOptions.sourceCache =
+            std::make_shared<CloneSourceCache>(sourceCacheOptions, fs);
+    }
     auto copyer = std::make_shared<OriginCopyer>();
     LOG_IF(FATAL, copyer->Init(copyerOptions) != 0)
         << "Failed to initialize clone copyer.";
@@ -175,8 +182,15 @@ int ChunkServer::Run(int argc, char** argv) {
     LOG_IF(FATAL, !conf.GetUInt32Value("clone.slice_size", &sliceSize));
     bool enablePaste = false;
     LOG_IF(FATAL, !conf.GetBoolValue("clone.enable_paste", &enablePaste));
-    cloneOptions.core =
-        std::make_shared<CloneCore>(sliceSize, enablePaste, copyer);
+    CloneReadMissReporterOptions reporterOptions;
+    InitCloneReadMissReporterOptions(&conf, &reporterOptions);
+    std::shared_ptr<CloneReadMissReporter> readMissReporter;
+    if (reporterOptions.enable) {
+        readMissReporter =
+            std::make_shared<CloneReadMissReporter>(reporterOptions);
+    }
+    cloneOptions.core = std::make_shared<CloneCore>(
+        sliceSize, enablePaste, copyer, readMissReporter);
     LOG_IF(FATAL, cloneManager_.Init(cloneOptions) != 0)
         << "Failed to initialize clone manager.";
 
@@ -390,6 +404,10 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to start trash.";
     LOG_IF(FATAL, cloneManager_.Run() != 0)
         << "Failed to start clone manager.";
+    if (readMissReporter != nullptr) {
+        LOG_IF(FATAL, readMissReporter->Run() != 0)
+            << "Failed to start clone read miss reporter.";
+    }
     LOG_IF(FATAL, heartbeat_.Run() != 0)
         << "Failed to start heartbeat manager.";
     LOG_IF(FATAL, copysetNodeManager_->Run() != 0)
@@ -413,6 +431,10 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to shutdown CopysetNodeManager.";
     LOG_IF(ERROR, cloneManager_.Fini() != 0)
         << "Failed to shutdown clone manager.";
+    if (readMissReporter != nullptr) {
+        LOG_IF(ERROR, readMissReporter->Fini() != 0)
+            << "Failed to shutdown clone read miss reporter.";
+    }
     LOG_IF(ERROR, copyer->Fini() != 0)
         << "Failed to shutdown clone copyer.";
     LOG_IF(ERROR, trash_->Fini() != 0)
@@ -535,6 +557,9 @@ void ChunkServer::InitCopysetNodeOptions(
         &copysetNodeOptions->finishLoadMargin));
     LOG_IF(FATAL, !conf->GetUInt32Value("copyset.check_loadmargin_interval_ms",
         &copysetNodeOptions->checkLoadMarginIntervalMs));
+    // Optional, chunk files are opened with O_DSYNC if not configured
+    conf->GetBoolValue("copyset.enable_odsync_when_open_chunkfile",
+        &copysetNodeOptions->enableOdsyncWhenOpenChunkFile);
 }
 
 void ChunkServer::InitCopyerOptions(
@@ -565,6 +590,60 @@ void ChunkServer::InitCopyerOptions(
     } else {
         copyerOptions->s3Client = std::make_shared<S3Adapter>();
     }
+
+    // The local snapshot data store is optional, disabled if not configured
+    conf->GetStringValue("clone.local_snapshot_dir",
+        &copyerOptions->localSnapshotDir);
+}
+
+void ChunkServer::InitCloneSourceCacheOptions(
+    common::Configuration *conf, CloneSourceCacheOptions *sourceCacheOptions) {
+    // The source cache is optional, the defaults are used if not configured
+    conf->GetBoolValue("clone.source_cache.enable",
+        &sourceCacheOptions->enable);
+    if (!sourceCacheOptions->enable) {
+        return;
+    }
+    conf->GetUInt32Value("clone.source_cache.block_size",
+        &sourceCacheOptions->blockSize);
+    conf->GetUInt64Value("clone.source_cache.memory_capacity",
+        &sourceCacheOptions->memoryCapacity);
+    conf->GetStringValue("clone.source_cache.disk_dir",
+        &sourceCacheOptions->diskCacheDir);
+    conf->GetUInt64Value("clone.source_cache.disk_capacity",
+        &sourceCacheOptions->diskCapacity);
+    conf->GetUInt32Value("clone.source_cache.version_ttl_sec",
+        &sourceCacheOptions->versionTtlSec);
+
+    // blocks must not cross the boundary of the source chunks
+    uint32_t chunkSize = 0;
+    LOG_IF(FATAL, !conf->GetUInt32Value("global.chunk_size", &chunkSize));
+    LOG_IF(FATAL, sourceCacheOptions->blockSize == 0 ||
+                  chunkSize % sourceCacheOptions->blockSize != 0)
+        << "clone.source_cache.block_size must divide global.chunk_size, "
+        << "block size: " << sourceCacheOptions->blockSize
+        << ", chunk size: " << chunkSize;
+}
+
+void ChunkServer::InitCloneReadMissReporterOptions(
+    common::Configuration *conf, CloneReadMissReporterOptions *reporterOptions) {
+    // Reporting is optional, the defaults are used if not configured
+    conf->GetBoolValue("clone.read_miss_report.enable",
+        &reporterOptions->enable);
+    if (!reporterOptions->enable) {
+        return;
+    }
+    std::string addrs;
+    LOG_IF(FATAL,
+           !conf->GetStringValue("clone.read_miss_report.addrs", &addrs))
+        << "clone.read_miss_report.addrs must be set if reporting is enabled";
+    ::curve::common::SplitString(addrs, ",", &reporterOptions->addrs);
+    conf->GetUInt32Value("clone.read_miss_report.interval_ms",
+        &reporterOptions->intervalMs);
+    conf->GetUInt32Value("clone.read_miss_report.timeout_ms",
+        &reporterOptions->timeoutMs);
+    conf->GetUInt32Value("clone.read_miss_report.max_chunks",
+        &reporterOptions->maxChunks);
 }
 
 void ChunkServer::InitCloneOptions(
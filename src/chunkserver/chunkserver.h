@@ -71,6 +71,12 @@ class ChunkServer {
     void InitCopyerOptions(common::Configuration *conf,
         CopyerOptions *copyerOptions);
 
+    void InitCloneSourceCacheOptions(common::Configuration *conf,
+        CloneSourceCacheOptions *sourceCacheOptions);
+
+    void InitCloneReadMissReporterOptions(common::Configuration *conf,
+        CloneReadMissReporterOptions *reporterOptions);
+
     void InitCloneOptions(common::Configuration *conf,
         CloneOptions *cloneOptions);
 
@@ -21,11 +21,29 @@
  */
 
 #include "src/chunkserver/clone_copyer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "src/chunkserver/clone_core.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace chunkserver {
 
+using curve::common::ChunkCodec;
+using curve::common::EncodedSplit;
+using curve::common::SplitEncodeType;
+using curve::common::TimeUtility;
+
 std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
     out  << "{ location: " << rhs.location
         << ", offset: " << rhs.offset
@@ -35,7 +53,7 @@ std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
 }
 
 struct CurveAioCombineContext {
-    DownloadClosure* done;
+    std::function<void(int)> cb;
     CurveAioContext curveCtx;
 };
 
@@ -43,22 +61,123 @@ void CurveAioCallback(struct CurveAioContext* context) {
     auto curveCombineCtx = reinterpret_cast<CurveAioCombineContext *>(
         reinterpret_cast<char *>(context) -
         offsetof(CurveAioCombineContext, curveCtx));
-    DownloadClosure* done = curveCombineCtx->done;
-    if (context->ret < 0) {
-        done->SetFailed();
-    }
+    std::function<void(int)> cb = std::move(curveCombineCtx->cb);
+    int ret = context->ret < 0 ? -1 : 0;
     delete curveCombineCtx;
 
-    brpc::ClosureGuard doneGuard(done);
+    cb(ret);
+}
+
+// Max infos of snapshot objects kept, the map is cleared when exceeded
+const size_t kMaxCachedObjectInfos = 65536;
+// Max opened files of the local snapshot objects, the map is cleared
+// when exceeded
+const size_t kMaxCachedLocalFiles = 4096;
+
+// File of a local snapshot object opened for reading
+struct LocalObjectFile {
+    LocalObjectFile(int fd, const std::string& version)
+        : fd(fd), version(version) {}
+    ~LocalObjectFile() {
+        close(fd);
+    }
+    int fd;
+    // Version of the file when opened
+    std::string version;
+};
+
+// Version of the local file, a replaced or rewritten file has another
+// inode or mtime
+std::string LocalFileVersion(const struct stat& st) {
+    uint64_t mtimeNs = st.st_mtim.tv_sec * 1000000000ull + st.st_mtim.tv_nsec;
+    return std::to_string(st.st_ino) + "-" + std::to_string(mtimeNs) +
+           "-" + std::to_string(st.st_size);
+}
+
+// Suffix of the location of the origin type, the same path in different
+// origins must not be mixed in the caches
+std::string OriginSuffix(OriginType type) {
+    switch (type) {
+        case OriginType::CurveOrigin:
+            return std::string(curve::common::kOriginTypeSeprator) +
+                   curve::common::CURVE_TYPE;
+        case OriginType::LocalOrigin:
+            return std::string(curve::common::kOriginTypeSeprator) +
+                   curve::common::LOCAL_TYPE;
+        default:
+            return std::string(curve::common::kOriginTypeSeprator) +
+                   curve::common::S3_TYPE;
+    }
+}
+
+// Part of a encoded split overlapped with the request
+struct SplitPiece {
+    EncodedSplit split;
+    // Offset of the split in the chunk
+    uint64_t rawOff;
+    // Offset of the split data in the object
+    uint64_t storedOff;
+    // Overlapped range of the chunk
+    uint64_t from;
+    uint64_t to;
+};
+
+// Decode the pieces into buf, data holds the object from fetchOff
+int DecodeSplitPieces(const std::vector<SplitPiece>& pieces,
+                      const char* data,
+                      uint64_t fetchOff,
+                      off_t off,
+                      char* buf) {
+    for (const auto& piece : pieces) {
+        char* dst = buf + (piece.from - off);
+        uint64_t len = piece.to - piece.from;
+        if (piece.split.type == SplitEncodeType::kZero) {
+            memset(dst, 0, len);
+        } else if (piece.split.type == SplitEncodeType::kRaw) {
+            memcpy(dst, data + (piece.storedOff - fetchOff) +
+                        (piece.from - piece.rawOff), len);
+        } else {
+            const char* src = data + (piece.storedOff - fetchOff);
+            // decompress into buf directly if the whole split is requested
+            if (len == piece.split.rawLen) {
+                if (!ChunkCodec::Uncompress(src, piece.split.storedLen,
+                                            dst, len)) {
+                    return -1;
+                }
+                continue;
+            }
+            std::string raw(piece.split.rawLen, '\0');
+            if (!ChunkCodec::Uncompress(src, piece.split.storedLen,
+                                        &raw[0], raw.size())) {
+                return -1;
+            }
+            memcpy(dst, raw.data() + (piece.from - piece.rawOff), len);
+        }
+    }
+    return 0;
 }
 
+// Contexts of a download split into the blocks of the source cache
+struct CacheDownloadContext {
+    std::atomic<uint32_t> pending;
+    std::atomic<bool> failed;
+    off_t off;
+    size_t size;
+    char* buf;
+    std::function<void(int)> cb;
+};
+
 OriginCopyer::OriginCopyer()
     : curveClient_(nullptr)
-    , s3Client_(nullptr) {}
+    , s3Client_(nullptr)
+    , sourceCache_(nullptr)
+    , versionTtlUs_(0) {}
 
 int OriginCopyer::Init(const CopyerOptions& options) {
     curveClient_ = options.curveClient;
     s3Client_ = options.s3Client;
+    localSnapshotDir_ = options.localSnapshotDir;
+    sourceCache_ = options.sourceCache;
     if (curveClient_ != nullptr) {
         int errorCode = curveClient_->Init(options.curveConf.c_str());
         if (errorCode != 0) {
@@ -75,19 +194,38 @@ int OriginCopyer::Init(const CopyerOptions& options) {
     } else {
         LOG(WARNING) << "s3 adapter is disabled.";
     }
+    if (localSnapshotDir_.empty()) {
+        LOG(INFO) << "Local snapshot data store is disabled.";
+    }
+    if (sourceCache_ != nullptr) {
+        if (sourceCache_->Init() != 0) {
+            LOG(ERROR) << "Init clone source cache failed.";
+            return -1;
+        }
+        // without the cache every read checks the version of the object,
+        // so the version only needs to be got again for the cached blocks
+        versionTtlUs_ = sourceCache_->GetVersionTtlSec() * 1000000ull;
+    }
     return 0;
 }
 
 int OriginCopyer::Fini() {
     if (curveClient_ != nullptr) {
         for (auto &pair : fdMap_) {
-            curveClient_->Close(pair.second);
+            curveClient_->Close(pair.second.fd);
         }
         curveClient_->UnInit();
     }
     if (s3Client_ != nullptr) {
         s3Client_->Deinit();
     }
+    if (sourceCache_ != nullptr) {
+        sourceCache_->Fini();
+    }
+    {
+        std::lock_guard<std::mutex> lock(localMtx_);
+        localFileMap_.clear();
+    }
     return 0;
 }
 
@@ -97,6 +235,7 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
     std::string originPath;
     OriginType type =
         LocationOperator::ParseLocation(context->location, &originPath);
+    off_t off = context->offset;
     if (type == OriginType::CurveOrigin) {
         off_t chunkOffset;
         std::string fileName;
@@ -108,104 +247,512 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
             done->SetFailed();
             return;
         }
-        DownloadFromCurve(fileName, chunkOffset + context->offset,
-                          context->size, context->buf,
-                          done);
-        doneGuard.release();
-    } else if (type == OriginType::S3Origin) {
-        DownloadFromS3(originPath, context->offset,
-                       context->size, context->buf,
-                       done);
-        doneGuard.release();
-    } else {
+        originPath = fileName;
+        off += chunkOffset;
+    } else if (type != OriginType::S3Origin &&
+               type != OriginType::LocalOrigin) {
         LOG(ERROR) << "Unknown origin location."
                    << "location: " << context->location;
         done->SetFailed();
+        return;
+    }
+
+    DownloadCallback cb = [done](int ret) {
+        brpc::ClosureGuard doneGuard(done);
+        if (ret < 0) {
+            done->SetFailed();
+        }
+    };
+    doneGuard.release();
+    if (sourceCache_ != nullptr) {
+        DownloadWithCache(type, originPath, off,
+                          context->size, context->buf, cb);
+    } else {
+        Download(type, originPath, off, context->size, context->buf, cb);
     }
 }
 
-void OriginCopyer::DownloadFromS3(const string& objectName,
-                                 off_t off,
-                                 size_t size,
-                                 char* buf,
-                                 DownloadClosure* done) {
-    brpc::ClosureGuard doneGuard(done);
-    if (s3Client_ == nullptr) {
+void OriginCopyer::Download(OriginType type,
+                            const string& path,
+                            off_t off,
+                            size_t size,
+                            char* buf,
+                            const DownloadCallback& cb) {
+    if (type == OriginType::CurveOrigin) {
+        DownloadFromCurve(path, off, size, buf, cb);
+    } else {
+        DownloadObject(type, path, off, size, buf, cb);
+    }
+}
+
+void OriginCopyer::DownloadWithCache(OriginType type,
+                                     const string& path,
+                                     off_t off,
+                                     size_t size,
+                                     char* buf,
+                                     const DownloadCallback& cb) {
+    std::string prefix = path + OriginSuffix(type) + "#";
+    if (type == OriginType::CurveOrigin) {
+        // the file is read through the fd opened with the id got, so the
+        // blocks downloaded are always of the file of the id
+        CurveFile file;
+        if (OpenCurveFile(path, &file) != 0) {
+            cb(-1);
+            return;
+        }
+        BlockLoader loader = [this, path](off_t blockOff, size_t blockLen,
+                                          char* blockBuf,
+                                          const DownloadCallback& done) {
+            DownloadFromCurve(path, blockOff, blockLen, blockBuf, done);
+        };
+        DownloadBlocks(prefix + std::to_string(file.id), off, size, buf,
+                       loader, cb);
+        return;
+    }
+
+    if (!CheckObjectOrigin(type)) {
+        cb(-1);
+        return;
+    }
+    GetObjectInfo(type, path, [=](int ret, const ObjectInfo& info) {
+        if (ret < 0) {
+            cb(-1);
+            return;
+        }
+        // the blocks are downloaded with the same info, and fail if the
+        // object is no longer of the version
+        BlockLoader loader = [this, type, path, info](
+            off_t blockOff, size_t blockLen, char* blockBuf,
+            const DownloadCallback& done) {
+            DownloadObjectOfInfo(type, path, info, blockOff, blockLen,
+                                 blockBuf, done);
+        };
+        DownloadBlocks(prefix + info.version, off, size, buf, loader, cb);
+    });
+}
+
+void OriginCopyer::DownloadBlocks(const string& prefix,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  const BlockLoader& loader,
+                                  const DownloadCallback& cb) {
+    uint64_t blockSize = sourceCache_->GetBlockSize();
+    uint64_t begin = off / blockSize * blockSize;
+    uint64_t end = off + size;
+
+    auto ctx = std::make_shared<CacheDownloadContext>();
+    ctx->pending.store((end - begin + blockSize - 1) / blockSize);
+    ctx->failed.store(false);
+    ctx->off = off;
+    ctx->size = size;
+    ctx->buf = buf;
+    ctx->cb = cb;
+
+    for (uint64_t blockOff = begin; blockOff < end; blockOff += blockSize) {
+        std::string key = prefix + ":" + std::to_string(blockOff);
+        auto blockLoader = [loader, blockOff](
+            char* blockBuf, size_t blockLen,
+            const CloneSourceCache::LoadDone& done) {
+            loader(blockOff, blockLen, blockBuf, done);
+        };
+        auto onBlock = [ctx, blockOff, blockSize](int ret,
+                                       const CloneSourceCache::Block& block) {
+            if (ret < 0) {
+                ctx->failed.store(true);
+            } else {
+                // copy the part of the block overlapped with the request
+                uint64_t from = std::max<uint64_t>(blockOff, ctx->off);
+                uint64_t to = std::min<uint64_t>(blockOff + blockSize,
+                                                 ctx->off + ctx->size);
+                if (blockOff + block->size() < to) {
+                    ctx->failed.store(true);
+                } else {
+                    memcpy(ctx->buf + (from - ctx->off),
+                           block->data() + (from - blockOff), to - from);
+                }
+            }
+            if (ctx->pending.fetch_sub(1) == 1) {
+                ctx->cb(ctx->failed.load() ? -1 : 0);
+            }
+        };
+        sourceCache_->GetBlock(key, blockLoader, onBlock);
+    }
+}
+
+bool OriginCopyer::CheckObjectOrigin(OriginType type) {
+    if (type == OriginType::LocalOrigin && localSnapshotDir_.empty()) {
+        LOG(ERROR) << "Failed to read local snapshot object."
+                   << "local snapshot data store is disabled";
+        return false;
+    }
+    if (type == OriginType::S3Origin && s3Client_ == nullptr) {
         LOG(ERROR) << "Failed to get s3 object."
                    << "s3 adapter is disabled";
-        done->SetFailed();
+        return false;
+    }
+    return true;
+}
+
+void OriginCopyer::DownloadObject(OriginType type,
+                                  const string& objectName,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  const DownloadCallback& cb) {
+    if (!CheckObjectOrigin(type)) {
+        cb(-1);
         return;
     }
+    GetObjectInfo(type, objectName,
+        [=](int ret, const ObjectInfo& info) {
+            if (ret < 0) {
+                cb(-1);
+            } else {
+                DownloadObjectOfInfo(type, objectName, info,
+                                     off, size, buf, cb);
+            }
+        });
+}
+
+void OriginCopyer::DownloadObjectOfInfo(OriginType type,
+                                        const string& objectName,
+                                        const ObjectInfo& info,
+                                        off_t off,
+                                        size_t size,
+                                        char* buf,
+                                        const DownloadCallback& cb) {
+    // The object may be replaced since the info was got, then the info
+    // is dropped so that the retry gets the new one
+    DownloadCallback readcb = [=](int ret) {
+        if (ret < 0) {
+            InvalidateObjectInfo(type, objectName, info.version);
+        }
+        cb(ret);
+    };
+    if (info.layout == nullptr) {
+        ReadObject(type, objectName, info.version, off, size, buf,
+                   [readcb](int ret, const std::string& version) {
+                       readcb(ret);
+                   });
+    } else {
+        DownloadEncodedObject(type, objectName, info, off, size, buf,
+                              readcb);
+    }
+}
 
-    GetObjectAsyncCallBack cb =
+void OriginCopyer::GetObjectInfo(OriginType type,
+                                 const string& objectName,
+                                 const ObjectInfoCallback& cb) {
+    std::string infoKey = objectName + OriginSuffix(type);
+    // The local object file may be replaced, which is found by the version
+    // of the path. The version of the s3 object is got again after the ttl
+    std::string version;
+    if (type == OriginType::LocalOrigin) {
+        std::string path = localSnapshotDir_ + "/" + objectName;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            LOG(ERROR) << "Stat local snapshot object failed."
+                       << "path: " << path
+                       << ", errno: " << errno;
+            cb(-1, ObjectInfo());
+            return;
+        }
+        version = LocalFileVersion(st);
+    }
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    {
+        std::unique_lock<std::mutex> lock(infoMtx_);
+        auto iter = infoMap_.find(infoKey);
+        if (iter != infoMap_.end()) {
+            bool valid = type == OriginType::LocalOrigin
+                       ? iter->second.version == version
+                       : versionTtlUs_ == 0 ||
+                         iter->second.timeUs + versionTtlUs_ > nowUs;
+            if (valid) {
+                ObjectInfo info = iter->second;
+                lock.unlock();
+                cb(0, info);
+                return;
+            }
+        }
+    }
+
+    auto header = std::make_shared<std::string>(
+        curve::common::kMaxEncodedChunkHeaderSize, '\0');
+    ReadCallback readcb = [=](int ret, const std::string& readVersion) {
+        if (ret < 0) {
+            LOG(ERROR) << "Failed to get object header."
+                       << "object name: " << objectName;
+            cb(-1, ObjectInfo());
+            return;
+        }
+        ObjectInfo info;
+        auto layout = std::make_shared<EncodedChunkHeader>();
+        if (layout->Decode(header->data(), header->size())) {
+            info.layout = layout;
+        }
+        info.version = readVersion;
+        info.timeUs = nowUs;
+        {
+            std::lock_guard<std::mutex> lock(infoMtx_);
+            if (infoMap_.size() >= kMaxCachedObjectInfos) {
+                infoMap_.clear();
+            }
+            infoMap_[infoKey] = info;
+        }
+        cb(0, info);
+    };
+    ReadObject(type, objectName, version, 0, header->size(), &(*header)[0],
+               readcb);
+}
+
+void OriginCopyer::InvalidateObjectInfo(OriginType type,
+                                        const string& objectName,
+                                        const std::string& version) {
+    std::lock_guard<std::mutex> lock(infoMtx_);
+    auto iter = infoMap_.find(objectName + OriginSuffix(type));
+    if (iter != infoMap_.end() && iter->second.version == version) {
+        infoMap_.erase(iter);
+    }
+}
+
+void OriginCopyer::DownloadEncodedObject(OriginType type,
+                                        const string& objectName,
+                                        const ObjectInfo& info,
+                                        off_t off,
+                                        size_t size,
+                                        char* buf,
+                                        const DownloadCallback& cb) {
+    const ObjectLayout& layout = info.layout;
+    uint64_t end = off + size;
+    if (end > layout->GetRawSize()) {
+        LOG(ERROR) << "Download out of range of the encoded object."
+                   << "object name: " << objectName
+                   << ", offset: " << off
+                   << ", size: " << size
+                   << ", object raw size: " << layout->GetRawSize();
+        cb(-1);
+        return;
+    }
+
+    // Collect the splits overlapped with the request, and the stored range
+    // of them. All-zero splits have no data, and raw splits only need the
+    // overlapped part
+    auto pieces = std::make_shared<std::vector<SplitPiece>>();
+    uint64_t fetchBegin = UINT64_MAX;
+    uint64_t fetchEnd = 0;
+    uint64_t rawOff = 0;
+    uint64_t storedOff = layout->GetHeaderSize();
+    for (const auto& split : layout->GetSplits()) {
+        uint64_t from = std::max<uint64_t>(off, rawOff);
+        uint64_t to = std::min<uint64_t>(end, rawOff + split.rawLen);
+        if (from < to) {
+            pieces->push_back({split, rawOff, storedOff, from, to});
+            if (split.type == SplitEncodeType::kRaw) {
+                fetchBegin = std::min(fetchBegin, storedOff + from - rawOff);
+                fetchEnd = std::max(fetchEnd, storedOff + to - rawOff);
+            } else if (split.type == SplitEncodeType::kSnappy) {
+                fetchBegin = std::min(fetchBegin, storedOff);
+                fetchEnd = std::max<uint64_t>(fetchEnd,
+                                              storedOff + split.storedLen);
+            }
+        }
+        rawOff += split.rawLen;
+        storedOff += split.storedLen;
+    }
+
+    if (fetchBegin >= fetchEnd) {
+        cb(DecodeSplitPieces(*pieces, nullptr, 0, off, buf));
+        return;
+    }
+
+    auto data = std::make_shared<std::string>(fetchEnd - fetchBegin, '\0');
+    ReadCallback readcb = [=](int ret, const std::string& version) {
+        if (ret < 0) {
+            cb(-1);
+            return;
+        }
+        ret = DecodeSplitPieces(*pieces, data->data(), fetchBegin, off, buf);
+        LOG_IF(ERROR, ret < 0) << "Failed to decode snapshot object."
+                               << "object name: " << objectName;
+        cb(ret);
+    };
+    ReadObject(type, objectName, info.version, fetchBegin, data->size(),
+               &(*data)[0], readcb);
+}
+
+void OriginCopyer::ReadObject(OriginType type,
+                              const string& objectName,
+                              const std::string& version,
+                              off_t off,
+                              size_t size,
+                              char* buf,
+                              const ReadCallback& cb) {
+    if (type == OriginType::LocalOrigin) {
+        ReadLocalObject(objectName, version, off, size, buf, cb);
+        return;
+    }
+
+    GetObjectAsyncCallBack s3cb =
         [=] (const S3Adapter* adapter,
              const std::shared_ptr<GetObjectAsyncContext>& context) {
-            brpc::ClosureGuard doneGuard(done);
-            if (context->retCode != 0) {
-                done->SetFailed();
-            }
+            cb(context->retCode != 0 ? -1 : 0, context->etag);
         };
 
+    // s3 fails the read if the etag of the object is not the version
     auto context = std::make_shared<GetObjectAsyncContext>();
     context->key = objectName;
     context->buf = buf;
     context->offset = off;
     context->len = size;
-    context->cb = cb;
+    context->cb = s3cb;
+    context->etag = version;
 
     s3Client_->GetObjectAsync(context);
-    doneGuard.release();
 }
 
-void OriginCopyer::DownloadFromCurve(const string& fileName,
-                                    off_t off,
-                                    size_t size,
-                                    char* buf,
-                                    DownloadClosure* done) {
-    brpc::ClosureGuard doneGuard(done);
+void OriginCopyer::ReadLocalObject(const string& objectName,
+                                  const std::string& version,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  const ReadCallback& cb) {
+    std::shared_ptr<LocalObjectFile> file;
+    {
+        std::lock_guard<std::mutex> lock(localMtx_);
+        auto iter = localFileMap_.find(objectName);
+        if (iter != localFileMap_.end()) {
+            file = iter->second;
+        }
+    }
+    // the file opened may be replaced, open the path again
+    if (file == nullptr || (!version.empty() && file->version != version)) {
+        std::string path = localSnapshotDir_ + "/" + objectName;
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG(ERROR) << "Open local snapshot object failed."
+                       << "path: " << path
+                       << ", errno: " << errno;
+            cb(-1, "");
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            LOG(ERROR) << "Stat local snapshot object failed."
+                       << "path: " << path
+                       << ", errno: " << errno;
+            close(fd);
+            cb(-1, "");
+            return;
+        }
+        file = std::make_shared<LocalObjectFile>(fd, LocalFileVersion(st));
+        std::lock_guard<std::mutex> lock(localMtx_);
+        if (localFileMap_.size() >= kMaxCachedLocalFiles) {
+            localFileMap_.clear();
+        }
+        localFileMap_[objectName] = file;
+    }
+    if (!version.empty() && file->version != version) {
+        LOG(WARNING) << "Local snapshot object is replaced."
+                     << "object name: " << objectName
+                     << ", expected version: " << version
+                     << ", version: " << file->version;
+        cb(-1, file->version);
+        return;
+    }
+
+    // The object may be shorter than the header prefix read, the rest of
+    // the buffer is filled with zero
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = pread(file->fd, buf + done, size - done, off + done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            LOG(ERROR) << "Read local snapshot object failed."
+                       << "object name: " << objectName
+                       << ", offset: " << off
+                       << ", size: " << size
+                       << ", errno: " << errno;
+            cb(-1, file->version);
+            return;
+        }
+        if (ret == 0) {
+            memset(buf + done, 0, size - done);
+            break;
+        }
+        done += ret;
+    }
+    cb(0, file->version);
+}
+
+int OriginCopyer::OpenCurveFile(const string& fileName, CurveFile* file) {
     if (curveClient_ == nullptr) {
         LOG(ERROR) << "Failed to read curve file."
                    << "curve client is disabled";
-        done->SetFailed();
-        return;
+        return -1;
     }
-
-    int fd = 0;
-    {
-        std::unique_lock<std::mutex> lock(mtx_);
-        auto iter = fdMap_.find(fileName);
-        if (iter != fdMap_.end()) {
-            fd = iter->second;
-        } else {
-            fd = curveClient_->Open4ReadOnly(fileName, curveUser_, true);
-            if (fd < 0) {
-                LOG(ERROR) << "Open curve file failed."
-                        << "file name: " << fileName
-                        << " ,return code: " << fd;
-                done->SetFailed();
-                return;
-            }
-            fdMap_[fileName] = fd;
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto iter = fdMap_.find(fileName);
+    if (iter != fdMap_.end()) {
+        *file = iter->second;
+        return 0;
+    }
+    int fd = curveClient_->Open4ReadOnly(fileName, curveUser_, true);
+    if (fd < 0) {
+        LOG(ERROR) << "Open curve file failed."
+                << "file name: " << fileName
+                << " ,return code: " << fd;
+        return -1;
+    }
+    file->fd = fd;
+    file->id = 0;
+    // The id tells a file recreated with the same name from the former
+    // one, which is needed by the keys of the cached blocks
+    if (sourceCache_ != nullptr) {
+        FileStatInfo info;
+        int ret = curveClient_->StatFile(fileName, curveUser_, &info);
+        if (ret != LIBCURVE_ERROR::OK) {
+            LOG(ERROR) << "Stat curve file failed."
+                       << "file name: " << fileName
+                       << " ,return code: " << ret;
+            curveClient_->Close(fd);
+            return -1;
         }
+        file->id = info.id;
+    }
+    fdMap_[fileName] = *file;
+    return 0;
+}
+
+void OriginCopyer::DownloadFromCurve(const string& fileName,
+                                    off_t off,
+                                    size_t size,
+                                    char* buf,
+                                    const DownloadCallback& cb) {
+    CurveFile file;
+    if (OpenCurveFile(fileName, &file) != 0) {
+        cb(-1);
+        return;
     }
 
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
-    curveCombineCtx->done = done;
+    curveCombineCtx->cb = cb;
     curveCombineCtx->curveCtx.offset = off;
     curveCombineCtx->curveCtx.length = size;
     curveCombineCtx->curveCtx.buf = buf;
     curveCombineCtx->curveCtx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
     curveCombineCtx->curveCtx.cb = CurveAioCallback;
 
-    int ret = curveClient_->AioRead(fd,  &curveCombineCtx->curveCtx);
+    int ret = curveClient_->AioRead(file.fd,  &curveCombineCtx->curveCtx);
     if (ret !=  LIBCURVE_ERROR::OK) {
         LOG(ERROR) << "Read curve file failed."
                    << "file name: " << fileName
                    << " ,error code: " << ret;
         delete curveCombineCtx;
-        done->SetFailed();
-    } else {
-        doneGuard.release();
+        cb(-1);
     }
 }
 
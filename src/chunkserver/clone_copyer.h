@@ -24,6 +24,7 @@
 #define SRC_CHUNKSERVER_CLONE_COPYER_H_
 
 #include <glog/logging.h>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -35,6 +36,8 @@
 #include "src/client/client_common.h"
 #include "include/client/libcurve.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/chunk_codec.h"
+#include "src/chunkserver/clone_source_cache.h"
 
 namespace curve {
 namespace chunkserver {
@@ -46,9 +49,11 @@ using curve::common::LocationOperator;
 using curve::common::OriginType;
 using curve::common::GetObjectAsyncCallBack;
 using curve::common::GetObjectAsyncContext;
+using curve::common::EncodedChunkHeader;
 using std::string;
 
 class DownloadClosure;
+struct LocalObjectFile;
 
 struct CopyerOptions {
     // root user information of curvefs
@@ -61,6 +66,11 @@ struct CopyerOptions {
     std::shared_ptr<FileClient> curveClient;
     // object pointer to s3 adapter
     std::shared_ptr<S3Adapter> s3Client;
+    // directory of the local snapshot data store shared with the
+    // snapshotcloneserver, empty means disabled
+    std::string localSnapshotDir;
+    // cache of the source data, nullptr means disabled
+    std::shared_ptr<CloneSourceCache> sourceCache;
 };
 
 struct AsyncDownloadContext {
@@ -102,16 +112,147 @@ class OriginCopyer {
     virtual void DownloadAsync(DownloadClosure* done);
 
  private:
-    void DownloadFromS3(const string& objectName,
-                       off_t off,
-                       size_t size,
-                       char* buf,
-                       DownloadClosure* done);
+    // Callback of a download, ret < 0 means failed
+    using DownloadCallback = std::function<void(int ret)>;
+    // Download size bytes from off of the source into buf
+    using BlockLoader = std::function<void(off_t off, size_t size,
+                                           char* buf,
+                                           const DownloadCallback& cb)>;
+
+    // Layout of the encoded snapshot object, nullptr means not encoded
+    using ObjectLayout = std::shared_ptr<const EncodedChunkHeader>;
+
+    // Snapshot object being read, the reads of the object data only
+    // succeed if the object is still of the version
+    struct ObjectInfo {
+        ObjectLayout layout;
+        // ETag of the s3 object, or inode, mtime and size of the local
+        // object file
+        std::string version;
+        // Time in us when the version was got
+        uint64_t timeUs = 0;
+    };
+    using ObjectInfoCallback =
+        std::function<void(int ret, const ObjectInfo& info)>;
+    // Callback of a read of the snapshot object, version is the version
+    // of the object read
+    using ReadCallback =
+        std::function<void(int ret, const std::string& version)>;
+
+    // Curve file opened for reading
+    struct CurveFile {
+        int fd;
+        // Id of the file, only got if the source cache is enabled
+        uint64_t id;
+    };
+
+    void Download(OriginType type,
+                  const string& path,
+                  off_t off,
+                  size_t size,
+                  char* buf,
+                  const DownloadCallback& cb);
+    /**
+     * Download through the source cache. The blocks are keyed by the
+     * version of the source as well, so a replaced source never hits
+     * the blocks of the former one
+     */
+    void DownloadWithCache(OriginType type,
+                           const string& path,
+                           off_t off,
+                           size_t size,
+                           char* buf,
+                           const DownloadCallback& cb);
+    /**
+     * Download the range through the source cache, the range is split
+     * into blocks aligned to the block size of the cache
+     * @param prefix: Key prefix of the blocks, source and version included
+     * @param loader: Download a block of the same version on miss
+     */
+    void DownloadBlocks(const string& prefix,
+                        off_t off,
+                        size_t size,
+                        char* buf,
+                        const BlockLoader& loader,
+                        const DownloadCallback& cb);
+
+    /**
+     * Download from the snapshot object in s3 or the local directory,
+     * the objects may be encoded with all-zero splits skipped and the
+     * others compressed
+     */
+    void DownloadObject(OriginType type,
+                        const string& objectName,
+                        off_t off,
+                        size_t size,
+                        char* buf,
+                        const DownloadCallback& cb);
+    /**
+     * Download from the snapshot object of the info, fail if the object
+     * is no longer of the version, and the info is dropped then
+     */
+    void DownloadObjectOfInfo(OriginType type,
+                              const string& objectName,
+                              const ObjectInfo& info,
+                              off_t off,
+                              size_t size,
+                              char* buf,
+                              const DownloadCallback& cb);
+    // Check if the origin of the snapshot objects is enabled
+    bool CheckObjectOrigin(OriginType type);
+    /**
+     * Get the layout and version of the snapshot object, the header is
+     * read from the prefix of the object on first access. The local
+     * object is revalidated on every access, and the s3 object after
+     * versionTtlUs_
+     */
+    void GetObjectInfo(OriginType type,
+                       const string& objectName,
+                       const ObjectInfoCallback& cb);
+    // Drop the info of the object if it is still of the version
+    void InvalidateObjectInfo(OriginType type,
+                              const string& objectName,
+                              const std::string& version);
+    /**
+     * Download the stored range of the splits overlapped with the request
+     * in one request, and decode them into buf
+     */
+    void DownloadEncodedObject(OriginType type,
+                               const string& objectName,
+                               const ObjectInfo& info,
+                               off_t off,
+                               size_t size,
+                               char* buf,
+                               const DownloadCallback& cb);
+    /**
+     * Read the stored data of the object, asynchronously from s3 and
+     * synchronously from the local directory
+     * @param version: Fail if the object is not of the version,
+     * empty means any version
+     */
+    void ReadObject(OriginType type,
+                    const string& objectName,
+                    const std::string& version,
+                    off_t off,
+                    size_t size,
+                    char* buf,
+                    const ReadCallback& cb);
+    void ReadLocalObject(const string& objectName,
+                         const std::string& version,
+                         off_t off,
+                         size_t size,
+                         char* buf,
+                         const ReadCallback& cb);
+    /**
+     * Open the curve file on first access, the file is kept opened
+     * @return: Return 0 for success, -1 for failure
+     */
+    int OpenCurveFile(const string& fileName, CurveFile* file);
     void DownloadFromCurve(const string& fileName,
                           off_t off,
                           size_t size,
                           char* buf,
-                          DownloadClosure* done);
+                          const DownloadCallback& cb);
 
  private:
     // root user information of curvefs
@@ -120,10 +261,27 @@ class OriginCopyer {
     std::shared_ptr<FileClient> curveClient_;
     // Responsible for communicating with s3
     std::shared_ptr<S3Adapter>  s3Client_;
+    // Cache of the source data, shared by all the clone chunks
+    std::shared_ptr<CloneSourceCache> sourceCache_;
     // Mutex lock which protects fdMap_
     std::mutex  mtx_;
-    // File name->file fd map
-    std::unordered_map<std::string, int> fdMap_;
+    // File name->opened file map
+    std::unordered_map<std::string, CurveFile> fdMap_;
+    // Mutex lock which protects infoMap_
+    std::mutex infoMtx_;
+    // Object location->object info map of the snapshot objects read
+    std::unordered_map<std::string, ObjectInfo> infoMap_;
+    // Time in us after which the version of the s3 object is got again,
+    // 0 means never
+    uint64_t versionTtlUs_;
+    // Directory of the local snapshot data store
+    std::string localSnapshotDir_;
+    // Mutex lock which protects localFileMap_
+    std::mutex localMtx_;
+    // Object name->file map of the local snapshot objects read, the file
+    // is closed when the last reader releases it
+    std::unordered_map<std::string, std::shared_ptr<LocalObjectFile>>
+        localFileMap_;
 };
 
 }  // namespace chunkserver
@@ -177,6 +177,10 @@ int CloneCore::CloneReadByLocalInfo(
         // copy should be triggered If there is a page within the requested read
         // range in the chunk that has not been written, the data needs to be
         // copied from the source
+        if (readMissReporter_ != nullptr &&
+            CHUNK_OP_TYPE::CHUNK_OP_READ == request->optype()) {
+            readMissReporter_->Record(request->chunkid());
+        }
         AsyncDownloadContext* downloadCtx =
             new (std::nothrow) AsyncDownloadContext;
         downloadCtx->location = chunkInfo.location;
@@ -209,6 +213,10 @@ void CloneCore::CloneReadByRequestInfo(std::shared_ptr<ReadChunkRequest>
     readRequest, Closure* done) {
     brpc::ClosureGuard doneGuard(done);
     const ChunkRequest*  chunkRequest = readRequest->request_;
+    if (readMissReporter_ != nullptr &&
+        CHUNK_OP_TYPE::CHUNK_OP_READ == chunkRequest->optype()) {
+        readMissReporter_->Record(chunkRequest->chunkid());
+    }
 
     auto func = ::curve::common::LocationOperator::GenerateCurveLocation;
     std::string location = func(chunkRequest->clonefilesource(),
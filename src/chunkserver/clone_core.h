@@ -33,6 +33,7 @@
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/common/timeutility.h"
 #include "src/chunkserver/clone_copyer.h"
+#include "src/chunkserver/clone_read_miss_reporter.h"
 #include "src/chunkserver/datastore/define.h"
 
 namespace curve {
@@ -115,10 +116,13 @@ class CloneCore : public std::enable_shared_from_this<CloneCore> {
     friend class DownloadClosure;
  public:
     CloneCore(uint32_t sliceSize, bool enablePaste,
-              std::shared_ptr<OriginCopyer> copyer)
+              std::shared_ptr<OriginCopyer> copyer,
+              std::shared_ptr<CloneReadMissReporter> readMissReporter =
+                  nullptr)
         : sliceSize_(sliceSize)
         , enablePaste_(enablePaste)
-        , copyer_(copyer) {}
+        , copyer_(copyer)
+        , readMissReporter_(readMissReporter) {}
     virtual ~CloneCore() {}
 
     /**
@@ -203,6 +207,9 @@ class CloneCore : public std::enable_shared_from_this<CloneCore> {
     bool enablePaste_;
     // Responsible for downloading data from the source
     std::shared_ptr<OriginCopyer> copyer_;
+    // Reports user reads that have to download from the source,
+    // nullptr means not reporting
+    std::shared_ptr<CloneReadMissReporter> readMissReporter_;
 };
 
 }  // namespace chunkserver
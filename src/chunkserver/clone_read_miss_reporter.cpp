@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/chunkserver/clone_read_miss_reporter.h"
+
+#include <brpc/channel.h>
+#include <brpc/controller.h>
+#include <glog/logging.h>
+#include <json/json.h>
+
+#include <chrono>
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::LockGuard;
+
+namespace {
+const char kReadMissMetricPrefix[] = "chunkserver_clone_read_miss";
+// Must be consistent with the http service of the snapshotcloneserver
+const char kReadMissReportPath[] =
+    "/SnapshotCloneService?Action=ReportCloneReadMiss&Version=1";
+const char kReadMissStr[] = "ReadMiss";
+const char kChunkIdStr[] = "ChunkId";
+const char kCountStr[] = "Count";
+}  // namespace
+
+CloneReadMissReporter::CloneReadMissReporter(
+    const CloneReadMissReporterOptions& options)
+    : options_(options),
+      serverIndex_(0),
+      isStop_(true),
+      recorded_(kReadMissMetricPrefix, "recorded"),
+      dropped_(kReadMissMetricPrefix, "dropped"),
+      reportFailed_(kReadMissMetricPrefix, "report_failed") {}
+
+CloneReadMissReporter::~CloneReadMissReporter() {
+    Fini();
+}
+
+int CloneReadMissReporter::Run() {
+    if (options_.addrs.empty()) {
+        LOG(ERROR) << "No snapshotcloneserver address to report read misses";
+        return -1;
+    }
+    if (isStop_.exchange(false)) {
+        reportThread_ = Thread(&CloneReadMissReporter::ReportLoop, this);
+        LOG(INFO) << "Start clone read miss reporter ok.";
+        return 0;
+    }
+    return -1;
+}
+
+int CloneReadMissReporter::Fini() {
+    if (!isStop_.exchange(true)) {
+        LOG(INFO) << "stop clone read miss reporter...";
+        sleeper_.interrupt();
+        reportThread_.join();
+    }
+    return 0;
+}
+
+void CloneReadMissReporter::Record(ChunkID chunkId) {
+    LockGuard guard(mtx_);
+    auto iter = misses_.find(chunkId);
+    if (iter != misses_.end()) {
+        iter->second++;
+    } else if (misses_.size() < options_.maxChunks) {
+        misses_.emplace(chunkId, 1);
+    } else {
+        dropped_ << 1;
+        return;
+    }
+    recorded_ << 1;
+}
+
+void CloneReadMissReporter::ReportLoop() {
+    while (sleeper_.wait_for(std::chrono::milliseconds(options_.intervalMs))) {
+        ReportOnce();
+    }
+}
+
+void CloneReadMissReporter::ReportOnce() {
+    std::unordered_map<ChunkID, uint32_t> misses;
+    {
+        LockGuard guard(mtx_);
+        misses.swap(misses_);
+    }
+    if (misses.empty()) {
+        return;
+    }
+
+    Json::Value list(Json::arrayValue);
+    for (const auto& miss : misses) {
+        Json::Value item;
+        item[kChunkIdStr] = static_cast<Json::UInt64>(miss.first);
+        item[kCountStr] = miss.second;
+        list.append(item);
+    }
+    Json::Value body;
+    body[kReadMissStr] = list;
+    Json::FastWriter writer;
+    std::string content = writer.write(body);
+
+    // Start from the server that accepted the last report, which is
+    // most likely the leader
+    uint32_t serverNum = options_.addrs.size();
+    for (uint32_t i = 0; i < serverNum; ++i) {
+        uint32_t index = (serverIndex_ + i) % serverNum;
+        if (Send(options_.addrs[index], content)) {
+            serverIndex_ = index;
+            return;
+        }
+    }
+    reportFailed_ << 1;
+    LOG_EVERY_N(WARNING, 100) << "Failed to report clone read misses"
+                              << ", chunk num: " << misses.size();
+}
+
+bool CloneReadMissReporter::Send(const std::string& addr,
+                                 const std::string& body) {
+    brpc::Channel channel;
+    brpc::ChannelOptions options;
+    options.protocol = brpc::PROTOCOL_HTTP;
+    options.timeout_ms = options_.timeoutMs;
+    options.max_retry = 0;
+    if (channel.Init(addr.c_str(), &options) != 0) {
+        return false;
+    }
+    brpc::Controller cntl;
+    cntl.http_request().uri() = addr + kReadMissReportPath;
+    cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+    cntl.request_attachment().append(body);
+    channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+    return !cntl.Failed();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_CLONE_READ_MISS_REPORTER_H_
+#define SRC_CHUNKSERVER_CLONE_READ_MISS_REPORTER_H_
+
+#include <bvar/bvar.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/chunkserver/chunkserver_common.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::curve::common::Atomic;
+using ::curve::common::InterruptibleSleeper;
+using ::curve::common::Thread;
+
+struct CloneReadMissReporterOptions {
+    // Whether read misses of clone chunks are reported
+    bool enable = false;
+    // Addresses of the snapshotcloneserver, tried in order until one
+    // accepts the report
+    std::vector<std::string> addrs;
+    // Interval between two reports
+    uint32_t intervalMs = 1000;
+    // Timeout of one report request
+    uint32_t timeoutMs = 1000;
+    // Max chunks kept between two reports, misses of more chunks are dropped
+    uint32_t maxChunks = 65536;
+};
+
+/**
+ * CloneReadMissReporter reports the user reads of clone chunks that have
+ * to download data from the clone source to the snapshotcloneserver.
+ * The snapshotcloneserver recovers the chunks with more read misses first,
+ * and slows down the recovery when the volume has too many read misses.
+ * Reports are best effort, misses are dropped if no server accepts them.
+ */
+class CloneReadMissReporter {
+ public:
+    explicit CloneReadMissReporter(
+        const CloneReadMissReporterOptions& options);
+    virtual ~CloneReadMissReporter();
+
+    int Run();
+    int Fini();
+
+    /**
+     * Record a read miss of the chunk
+     * @param chunkId: Id of the clone chunk
+     */
+    void Record(ChunkID chunkId);
+
+    /**
+     * Report the recorded misses and clear them
+     */
+    void ReportOnce();
+
+ protected:
+    /**
+     * Send the report to the server
+     * @param addr: Address of the server
+     * @param body: Body of the report
+     * @return: true if the server accepted the report
+     */
+    virtual bool Send(const std::string& addr, const std::string& body);
+
+ private:
+    void ReportLoop();
+
+ private:
+    CloneReadMissReporterOptions options_;
+
+    curve::common::Mutex mtx_;
+    std::unordered_map<ChunkID, uint32_t> misses_;
+
+    // Index of the server that accepted the last report
+    uint32_t serverIndex_;
+
+    Thread reportThread_;
+    Atomic<bool> isStop_;
+    InterruptibleSleeper sleeper_;
+
+    bvar::Adder<uint64_t> recorded_;
+    bvar::Adder<uint64_t> dropped_;
+    bvar::Adder<uint64_t> reportFailed_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_CLONE_READ_MISS_REPORTER_H_
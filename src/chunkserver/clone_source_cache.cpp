@@ -0,0 +1,389 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/chunkserver/clone_source_cache.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::LockGuard;
+
+namespace {
+const char kCloneSourceCacheMetricPrefix[] = "chunkserver_clone_source_cache";
+const char kDiskTmpSuffix[] = ".tmp";
+}  // namespace
+
+CloneSourceCache::CloneSourceCache(const CloneSourceCacheOptions& options,
+                                   std::shared_ptr<LocalFileSystem> fs)
+    : options_(options),
+      fs_(fs),
+      diskEnabled_(false),
+      memoryBytes_(0),
+      diskBytes_(0),
+      pendingDiskWrites_(0),
+      memoryHit_(kCloneSourceCacheMetricPrefix, "memory_hit"),
+      diskHit_(kCloneSourceCacheMetricPrefix, "disk_hit"),
+      coalesced_(kCloneSourceCacheMetricPrefix, "coalesced"),
+      miss_(kCloneSourceCacheMetricPrefix, "miss"),
+      bytesSaved_(kCloneSourceCacheMetricPrefix, "bytes_saved"),
+      bytesDownloaded_(kCloneSourceCacheMetricPrefix, "bytes_downloaded"),
+      hitRatio_(kCloneSourceCacheMetricPrefix, "hit_ratio",
+                &CloneSourceCache::GetHitRatio, this) {}
+
+CloneSourceCache::~CloneSourceCache() {
+    Fini();
+}
+
+int CloneSourceCache::Init() {
+    if (options_.blockSize == 0) {
+        LOG(ERROR) << "Invalid clone source cache block size: 0";
+        return -1;
+    }
+
+    if (options_.diskCacheDir.empty() || options_.diskCapacity == 0) {
+        LOG(INFO) << "Clone source cache init, blockSize: "
+                  << options_.blockSize
+                  << ", memoryCapacity: " << options_.memoryCapacity
+                  << ", disk tier disabled";
+        return 0;
+    }
+
+    if (fs_ == nullptr) {
+        LOG(ERROR) << "Local filesystem is required by the disk tier.";
+        return -1;
+    }
+    if (!fs_->DirExists(options_.diskCacheDir)) {
+        if (fs_->Mkdir(options_.diskCacheDir) != 0) {
+            LOG(ERROR) << "Failed to create clone source cache dir: "
+                       << options_.diskCacheDir;
+            return -1;
+        }
+    }
+
+    // The disk index lives in memory, drop the blocks left by last run
+    std::vector<std::string> names;
+    if (fs_->List(options_.diskCacheDir, &names) != 0) {
+        LOG(ERROR) << "Failed to list clone source cache dir: "
+                   << options_.diskCacheDir;
+        return -1;
+    }
+    for (const auto& name : names) {
+        fs_->Delete(options_.diskCacheDir + "/" + name);
+    }
+
+    if (diskWriter_.Start(1) != 0) {
+        LOG(ERROR) << "Failed to start clone source cache disk writer.";
+        return -1;
+    }
+    diskEnabled_ = true;
+    LOG(INFO) << "Clone source cache init, blockSize: " << options_.blockSize
+              << ", memoryCapacity: " << options_.memoryCapacity
+              << ", diskCacheDir: " << options_.diskCacheDir
+              << ", diskCapacity: " << options_.diskCapacity;
+    return 0;
+}
+
+void CloneSourceCache::Fini() {
+    if (diskEnabled_) {
+        diskWriter_.Stop();
+        diskEnabled_ = false;
+    }
+}
+
+void CloneSourceCache::GetBlock(const std::string& key,
+                                const Loader& loader,
+                                const ReadDone& done) {
+    Block block;
+    {
+        LockGuard lk(mtx_);
+        if (GetFromMemory(key, &block)) {
+            memoryHit_ << 1;
+        } else {
+            auto iter = inflight_.find(key);
+            if (iter != inflight_.end()) {
+                // someone is downloading it, wait for the result
+                iter->second.emplace_back(done);
+                coalesced_ << 1;
+                return;
+            }
+        }
+    }
+    if (block != nullptr) {
+        bytesSaved_ << block->size();
+        done(0, block);
+        return;
+    }
+
+    if (diskEnabled_ && GetFromDisk(key, &block)) {
+        diskHit_ << 1;
+        bytesSaved_ << block->size();
+        {
+            LockGuard lk(mtx_);
+            PutToMemory(key, block);
+        }
+        done(0, block);
+        return;
+    }
+
+    {
+        LockGuard lk(mtx_);
+        // the block may be loaded or being loaded while reading the disk
+        if (GetFromMemory(key, &block)) {
+            memoryHit_ << 1;
+        } else {
+            auto iter = inflight_.find(key);
+            if (iter != inflight_.end()) {
+                iter->second.emplace_back(done);
+                coalesced_ << 1;
+                return;
+            }
+            inflight_[key].emplace_back(done);
+        }
+    }
+    if (block != nullptr) {
+        bytesSaved_ << block->size();
+        done(0, block);
+        return;
+    }
+
+    miss_ << 1;
+    auto data = std::make_shared<std::string>(options_.blockSize, '\0');
+    loader(&(*data)[0], data->size(), [this, key, data](int ret) {
+        OnLoaded(key, data, ret);
+    });
+}
+
+void CloneSourceCache::OnLoaded(const std::string& key,
+                                const std::shared_ptr<std::string>& data,
+                                int ret) {
+    Block block;
+    std::vector<ReadDone> waiters;
+    {
+        LockGuard lk(mtx_);
+        auto iter = inflight_.find(key);
+        if (iter != inflight_.end()) {
+            waiters.swap(iter->second);
+            inflight_.erase(iter);
+        }
+        if (ret >= 0) {
+            block = data;
+            PutToMemory(key, block);
+        }
+    }
+
+    if (ret < 0) {
+        LOG(WARNING) << "Failed to download clone source block: " << key
+                     << ", ret: " << ret;
+        for (const auto& waiter : waiters) {
+            waiter(ret, nullptr);
+        }
+        return;
+    }
+
+    bytesDownloaded_ << block->size();
+    if (waiters.size() > 1) {
+        bytesSaved_ << block->size() * (waiters.size() - 1);
+    }
+    for (const auto& waiter : waiters) {
+        waiter(0, block);
+    }
+
+    if (diskEnabled_) {
+        PutToDisk(key, block);
+    }
+}
+
+bool CloneSourceCache::GetFromMemory(const std::string& key, Block* block) {
+    auto iter = memoryIndex_.find(key);
+    if (iter == memoryIndex_.end()) {
+        return false;
+    }
+    memoryLru_.splice(memoryLru_.begin(), memoryLru_, iter->second);
+    *block = iter->second->second;
+    return true;
+}
+
+void CloneSourceCache::PutToMemory(const std::string& key,
+                                   const Block& block) {
+    if (block->size() > options_.memoryCapacity) {
+        return;
+    }
+
+    auto iter = memoryIndex_.find(key);
+    if (iter != memoryIndex_.end()) {
+        memoryBytes_ -= iter->second->second->size();
+        memoryLru_.erase(iter->second);
+        memoryIndex_.erase(iter);
+    }
+
+    memoryLru_.emplace_front(key, block);
+    memoryIndex_[key] = memoryLru_.begin();
+    memoryBytes_ += block->size();
+
+    while (memoryBytes_ > options_.memoryCapacity) {
+        auto& oldest = memoryLru_.back();
+        memoryBytes_ -= oldest.second->size();
+        memoryIndex_.erase(oldest.first);
+        memoryLru_.pop_back();
+    }
+}
+
+std::string CloneSourceCache::DiskPath(const std::string& key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016zx", std::hash<std::string>()(key));
+    return options_.diskCacheDir + "/" + name;
+}
+
+bool CloneSourceCache::GetFromDisk(const std::string& key, Block* block) {
+    std::string path = DiskPath(key);
+    {
+        LockGuard lk(diskMtx_);
+        auto iter = diskIndex_.find(path);
+        if (iter == diskIndex_.end() || iter->second.key != key) {
+            return false;
+        }
+        diskLru_.splice(diskLru_.begin(), diskLru_, iter->second.lruIter);
+    }
+
+    // file layout: | key length(4 bytes) | key | block data |
+    // the file may be replaced after unlock, so the key is checked again
+    int fd = fs_->Open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    bool ok = false;
+    auto data = std::make_shared<std::string>();
+    uint32_t keyLen = 0;
+    if (fs_->Fstat(fd, &info) == 0 &&
+        info.st_size >= static_cast<off_t>(sizeof(keyLen) + key.size())) {
+        std::string content(info.st_size, '\0');
+        if (fs_->Read(fd, &content[0], 0, content.size()) ==
+            static_cast<int>(content.size())) {
+            memcpy(&keyLen, content.data(), sizeof(keyLen));
+            if (keyLen == key.size() &&
+                content.compare(sizeof(keyLen), keyLen, key) == 0) {
+                data->assign(content, sizeof(keyLen) + keyLen,
+                             std::string::npos);
+                ok = true;
+            }
+        }
+    }
+    fs_->Close(fd);
+
+    if (ok) {
+        *block = data;
+    }
+    return ok;
+}
+
+void CloneSourceCache::PutToDisk(const std::string& key,
+                                 const Block& block) {
+    {
+        LockGuard lk(diskMtx_);
+        auto iter = diskIndex_.find(DiskPath(key));
+        if (iter != diskIndex_.end() && iter->second.key == key) {
+            return;
+        }
+    }
+    // never block the download callback on the disk
+    if (pendingDiskWrites_.fetch_add(1) >= options_.maxPendingDiskWrites) {
+        pendingDiskWrites_.fetch_sub(1);
+        return;
+    }
+    diskWriter_.Enqueue([this, key, block]() {
+        WriteToDisk(key, block);
+        pendingDiskWrites_.fetch_sub(1);
+    });
+}
+
+void CloneSourceCache::WriteToDisk(const std::string& key,
+                                   const Block& block) {
+    std::string content;
+    uint32_t keyLen = key.size();
+    content.reserve(sizeof(keyLen) + key.size() + block->size());
+    content.append(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+    content.append(key);
+    content.append(*block);
+
+    std::string path = DiskPath(key);
+    std::string tmpPath = path + kDiskTmpSuffix;
+    int fd = fs_->Open(tmpPath, O_RDWR | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        LOG(WARNING) << "Failed to open clone source cache file: " << tmpPath;
+        return;
+    }
+    int ret = fs_->Write(fd, content.data(), 0, content.size());
+    fs_->Close(fd);
+    if (ret != static_cast<int>(content.size())) {
+        LOG(WARNING) << "Failed to write clone source cache file: "
+                     << tmpPath << ", ret: " << ret;
+        fs_->Delete(tmpPath);
+        return;
+    }
+
+    LockGuard lk(diskMtx_);
+    if (fs_->Rename(tmpPath, path) != 0) {
+        LOG(WARNING) << "Failed to rename clone source cache file: "
+                     << tmpPath;
+        fs_->Delete(tmpPath);
+        return;
+    }
+    // the block with the same file name is replaced
+    auto iter = diskIndex_.find(path);
+    if (iter != diskIndex_.end()) {
+        diskBytes_ -= iter->second.size;
+        diskLru_.erase(iter->second.lruIter);
+        diskIndex_.erase(iter);
+    }
+    diskLru_.emplace_front(path);
+    diskIndex_[path] = DiskEntry{key, diskLru_.begin(), content.size()};
+    diskBytes_ += content.size();
+
+    while (diskBytes_ > options_.diskCapacity && diskLru_.size() > 1) {
+        const std::string& oldest = diskLru_.back();
+        auto oldestIter = diskIndex_.find(oldest);
+        diskBytes_ -= oldestIter->second.size;
+        fs_->Delete(oldest);
+        diskIndex_.erase(oldestIter);
+        diskLru_.pop_back();
+    }
+}
+
+double CloneSourceCache::GetHitRatio(void* arg) {
+    CloneSourceCache* cache = static_cast<CloneSourceCache*>(arg);
+    uint64_t hit = cache->memoryHit_.get_value() +
+                   cache->diskHit_.get_value() +
+                   cache->coalesced_.get_value();
+    uint64_t total = hit + cache->miss_.get_value();
+    return total == 0 ? 0 : static_cast<double>(hit) / total;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
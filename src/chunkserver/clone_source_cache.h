@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_CLONE_SOURCE_CACHE_H_
+#define SRC_CHUNKSERVER_CLONE_SOURCE_CACHE_H_
+
+#include <bvar/bvar.h>
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFileSystem;
+
+struct CloneSourceCacheOptions {
+    // Whether the clone source data is cached
+    bool enable = false;
+    // Size of the cached block, must divide the chunk size.
+    // Downloads are aligned to and split by blocks
+    uint32_t blockSize = 1024 * 1024;
+    // Max bytes of blocks kept in memory
+    uint64_t memoryCapacity = 512 * 1024 * 1024ull;
+    // Directory of the local disk tier, empty means disabled
+    std::string diskCacheDir;
+    // Max bytes of blocks kept on the local disk
+    uint64_t diskCapacity = 0;
+    // Max blocks waiting to be written to the local disk,
+    // more blocks are only kept in memory
+    uint32_t maxPendingDiskWrites = 64;
+    // Seconds after which the version of a s3 source is checked again,
+    // blocks of a replaced s3 object may be hit until then.
+    // 0 means never
+    uint32_t versionTtlSec = 60;
+};
+
+/**
+ * CloneSourceCache caches the data read from clone sources (curvefs files
+ * or s3 objects) on a chunkserver, so that many clone chunks from the same
+ * source only download each block once.
+ * 1. Blocks are kept in a LRU memory tier, and optionally a LRU disk tier.
+ * 2. Concurrent misses of the same block share one download.
+ */
+class CloneSourceCache {
+ public:
+    using Block = std::shared_ptr<const std::string>;
+    // Callback of a download, ret < 0 means failed
+    using LoadDone = std::function<void(int ret)>;
+    // Download size bytes of the block into buf, and call done at the end
+    using Loader = std::function<void(char* buf, size_t size,
+                                      const LoadDone& done)>;
+    // Callback of GetBlock, block is valid only if ret == 0
+    using ReadDone = std::function<void(int ret, const Block& block)>;
+
+    CloneSourceCache(const CloneSourceCacheOptions& options,
+                     std::shared_ptr<LocalFileSystem> fs);
+    virtual ~CloneSourceCache();
+
+    /**
+     * Prepare the disk tier. Blocks left by last run are dropped
+     * @return: Return 0 for success, -1 for failure
+     */
+    int Init();
+
+    void Fini();
+
+    uint32_t GetBlockSize() const {
+        return options_.blockSize;
+    }
+
+    uint32_t GetVersionTtlSec() const {
+        return options_.versionTtlSec;
+    }
+
+    /**
+     * Get the block from cache, or download it by loader on miss.
+     * done may be called synchronously in this function
+     * @param key: Unique name of the block, source and offset included
+     * @param loader: Used to download the block on miss
+     * @param done: Called with the block
+     */
+    void GetBlock(const std::string& key, const Loader& loader,
+                  const ReadDone& done);
+
+ private:
+    struct DiskEntry {
+        // key of the block, blocks of different keys may have
+        // the same file name
+        std::string key;
+        std::list<std::string>::iterator lruIter;
+        uint64_t size;
+    };
+
+    bool GetFromMemory(const std::string& key, Block* block);
+    void PutToMemory(const std::string& key, const Block& block);
+
+    bool GetFromDisk(const std::string& key, Block* block);
+    void PutToDisk(const std::string& key, const Block& block);
+    void WriteToDisk(const std::string& key, const Block& block);
+    std::string DiskPath(const std::string& key) const;
+
+    void OnLoaded(const std::string& key,
+                  const std::shared_ptr<std::string>& data,
+                  int ret);
+
+    static double GetHitRatio(void* arg);
+
+ private:
+    CloneSourceCacheOptions options_;
+    std::shared_ptr<LocalFileSystem> fs_;
+    bool diskEnabled_;
+
+    // Protects the memory tier and inflight_
+    curve::common::Mutex mtx_;
+    std::list<std::pair<std::string, Block>> memoryLru_;
+    std::unordered_map<std::string,
+        std::list<std::pair<std::string, Block>>::iterator> memoryIndex_;
+    uint64_t memoryBytes_;
+    // Waiters of the blocks being downloaded
+    std::unordered_map<std::string, std::vector<ReadDone>> inflight_;
+
+    // Protects the index of the disk tier, which is keyed by the file path
+    curve::common::Mutex diskMtx_;
+    std::list<std::string> diskLru_;
+    std::unordered_map<std::string, DiskEntry> diskIndex_;
+    uint64_t diskBytes_;
+    std::atomic<uint32_t> pendingDiskWrites_;
+    curve::common::TaskThreadPool<> diskWriter_;
+
+    // metrics
+    bvar::Adder<uint64_t> memoryHit_;
+    bvar::Adder<uint64_t> diskHit_;
+    bvar::Adder<uint64_t> coalesced_;
+    bvar::Adder<uint64_t> miss_;
+    bvar::Adder<uint64_t> bytesSaved_;
+    bvar::Adder<uint64_t> bytesDownloaded_;
+    bvar::PassiveStatus<double> hitRatio_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_CLONE_SOURCE_CACHE_H_
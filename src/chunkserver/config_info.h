@@ -125,6 +125,10 @@ struct CopysetNodeOptions {
     uint32_t finishLoadMargin = 2000;
     // Internal sleep time to loop to check if copyset is loaded
     uint32_t checkLoadMarginIntervalMs = 1000;
+    // Whether to open chunk files with O_DSYNC. If not, the chunk files
+    // written are synced when the raft snapshot is saved, before the raft
+    // log is truncated
+    bool enableOdsyncWhenOpenChunkFile = true;
 
     CopysetNodeOptions();
 };
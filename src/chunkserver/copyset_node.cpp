@@ -112,6 +112,8 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.chunkSize = options.maxChunkSize;
     dsOptions.pageSize = options.pageSize;
     dsOptions.locationLimit = options.locationLimit;
+    dsOptions.enableOdsyncWhenOpenChunkFile =
+        options.enableOdsyncWhenOpenChunkFile;
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkFilePool,
                                                dsOptions);
@@ -255,12 +257,9 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             CHECK(nullptr != chunkClosure)
                 << "ChunkClosure dynamic cast failed";
             std::shared_ptr<ChunkOpRequest> opRequest = chunkClosure->request_;
-            auto task = std::bind(&ChunkOpRequest::OnApply,
-                                  opRequest,
-                                  iter.index(),
-                                  doneGuard.release());
-            concurrentapply_->Push(
-                opRequest->ChunkId(), opRequest->OpType(), task);
+            opRequest->ScheduleApply(concurrentapply_,
+                                     iter.index(),
+                                     doneGuard.release());
         } else {
             // get log entry
             butil::IOBuf log = iter.data();
@@ -274,13 +273,10 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             ChunkRequest request;
             butil::IOBuf data;
             auto opReq = ChunkOpRequest::Decode(log, &request, &data);
-            auto chunkId = request.chunkid();
-            auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
-                                  opReq,
-                                  dataStore_,
-                                  std::move(request),
-                                  data);
-            concurrentapply_->Push(chunkId, request.optype(), task);
+            opReq->ScheduleApplyFromLog(concurrentapply_,
+                                        dataStore_,
+                                        std::move(request),
+                                        std::move(data));
         }
     }
 }
@@ -298,6 +294,19 @@ void CopysetNode::on_snapshot_save(::braft::SnapshotWriter *writer,
      */
     concurrentapply_->Flush();
 
+    /**
+     * If the chunk files are opened without O_DSYNC, the data written has
+     * to be synced before the raft log is truncated
+     */
+    CSErrorCode errorCode = dataStore_->SyncDirtyChunks();
+    if (errorCode != CSErrorCode::Success) {
+        done->status().set_error(EIO, "sync chunk files failed");
+        LOG(ERROR) << "Sync dirty chunks failed. "
+                   << "Copyset: " << GroupIdString()
+                   << ", error code: " << errorCode;
+        return;
+    }
+
     /**
      * 2.Save the configuration epoch: conf.epoch, note that conf.epoch is
      * stored in the data directory
@@ -141,7 +141,8 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
       snapshot_(nullptr),
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
-      metric_(options.metric) {
+      metric_(options.metric),
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
     CHECK(!baseDir_.empty()) << "Create chunk file failed";
     CHECK(lfs_ != nullptr) << "Create chunk file failed";
     metaPage_.sn = options.sn;
@@ -201,7 +202,13 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
             return CSErrorCode::InternalError;
         }
     }
-    int rc = lfs_->Open(chunkFilePath, O_RDWR|O_NOATIME|O_DSYNC);
+    int flags = O_RDWR|O_NOATIME;
+    // Without O_DSYNC, the data written is persisted by Sync, the raft log
+    // can not be truncated before that
+    if (enableOdsyncWhenOpenChunkFile_) {
+        flags |= O_DSYNC;
+    }
+    int rc = lfs_->Open(chunkFilePath, flags);
     if (rc < 0) {
         LOG(ERROR) << "Error occured when opening file."
                    << " filepath = " << chunkFilePath;
@@ -706,6 +713,22 @@ void CSChunkFile::GetInfo(CSChunkInfo* info)  {
         info->bitmap = nullptr;
 }
 
+CSErrorCode CSChunkFile::Sync() {
+    ReadLockGuard readGuard(rwLock_);
+    // The chunk file has been deleted
+    if (fd_ < 0) {
+        return CSErrorCode::Success;
+    }
+    int rc = lfs_->Fdatasync(fd_);
+    if (rc < 0) {
+        LOG(ERROR) << "Sync chunk file failed."
+                   << "ChunkID: " << chunkId_
+                   << ", rc: " << rc;
+        return CSErrorCode::InternalError;
+    }
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSChunkFile::GetHash(off_t offset,
                                  size_t length,
                                  std::string* hash)  {
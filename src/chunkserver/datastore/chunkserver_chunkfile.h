@@ -107,6 +107,9 @@ struct ChunkOptions {
     PageSizeType    pageSize;
     // datastore internal statistical metric
     std::shared_ptr<DataStoreMetric> metric;
+    // Whether to open the chunk file with O_DSYNC. If not, the written data
+    // only reaches the disk after Sync is called
+    bool enableOdsyncWhenOpenChunkFile;
 
     ChunkOptions() : id(0)
                    , sn(0)
@@ -115,7 +118,8 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
-                   , metric(nullptr) {}
+                   , metric(nullptr)
+                   , enableOdsyncWhenOpenChunkFile(true) {}
 };
 
 class CSChunkFile {
@@ -233,6 +237,13 @@ class CSChunkFile {
     CSErrorCode GetHash(off_t offset,
                         size_t length,
                         std::string *hash);
+    /**
+     * Flush the written data of the chunk file to disk, only needed when
+     * the chunk file is opened without O_DSYNC.
+     * There may be concurrency, add read lock
+     * @return: return error code
+     */
+    CSErrorCode Sync();
 
  private:
     /**
@@ -383,6 +394,8 @@ class CSChunkFile {
     std::shared_ptr<LocalFileSystem> lfs_;
     // datastore internal statistical indicators
     std::shared_ptr<DataStoreMetric> metric_;
+    // Whether to open the chunk file with O_DSYNC
+    bool enableOdsyncWhenOpenChunkFile_;
 };
 }  // namespace chunkserver
 }  // namespace curve
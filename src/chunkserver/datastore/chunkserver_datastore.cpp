@@ -42,7 +42,8 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       baseDir_(options.baseDir),
       locationLimit_(options.locationLimit),
       chunkFilePool_(chunkFilePool),
-      lfs_(lfs) {
+      lfs_(lfs),
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkFilePool_ != nullptr) << "Create datastore failed";
@@ -130,6 +131,7 @@ CSErrorCode CSDataStore::DeleteSnapshotChunkOrCorrectSn(
     ChunkID id, SequenceNum correctedSn) {
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile != nullptr) {
+        MarkChunkDirty(id);
         CSErrorCode errorCode = chunkFile->DeleteSnapshotOrCorrectSn(correctedSn);  // NOLINT
         if (errorCode != CSErrorCode::Success) {
             LOG(WARNING) << "Delete snapshot chunk or correct sn failed."
@@ -233,12 +235,14 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.location = cloneSourceLocation;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
         }
     }
     // write chunk file
+    MarkChunkDirty(id);
     CSErrorCode errorCode = chunkFile->Write(sn,
                                              buf,
                                              offset,
@@ -281,10 +285,12 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
         }
+        MarkChunkDirty(id);
     }
     // Check whether the specified parameters match the information
     // in the existing Chunk
@@ -321,6 +327,7 @@ CSErrorCode CSDataStore::PasteChunk(ChunkID id,
                      << "ChunkID = " << id;
         return CSErrorCode::ChunkNotExistError;
     }
+    MarkChunkDirty(id);
     CSErrorCode errcode = chunkFile->Paste(buf, offset, length);
     if (errcode != CSErrorCode::Success) {
         LOG(WARNING) << "Paste Chunk failed, Chunk not exists."
@@ -363,6 +370,44 @@ DataStoreStatus CSDataStore::GetStatus() {
     return status;
 }
 
+CSErrorCode CSDataStore::SyncDirtyChunks() {
+    if (enableOdsyncWhenOpenChunkFile_) {
+        return CSErrorCode::Success;
+    }
+
+    std::unordered_set<ChunkID> chunks;
+    {
+        LockGuard lockGuard(dirtyChunksMtx_);
+        chunks.swap(dirtyChunks_);
+    }
+
+    CSErrorCode errorCode = CSErrorCode::Success;
+    for (auto id : chunks) {
+        auto chunkFile = metaCache_.Get(id);
+        // The chunk has been deleted
+        if (chunkFile == nullptr) {
+            continue;
+        }
+        CSErrorCode rc = chunkFile->Sync();
+        if (rc != CSErrorCode::Success) {
+            LOG(ERROR) << "Sync chunk file failed."
+                       << "ChunkID = " << id;
+            // Keep it dirty so that the next call will retry
+            MarkChunkDirty(id);
+            errorCode = rc;
+        }
+    }
+    return errorCode;
+}
+
+void CSDataStore::MarkChunkDirty(ChunkID id) {
+    if (enableOdsyncWhenOpenChunkFile_) {
+        return;
+    }
+    LockGuard lockGuard(dirtyChunksMtx_);
+    dirtyChunks_.insert(id);
+}
+
 CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
     // If the chunk file has not been loaded yet, load it into metaCache
     if (metaCache_.Get(id) == nullptr) {
@@ -373,6 +418,7 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
         CSChunkFilePtr chunkFilePtr =
             std::make_shared<CSChunkFile>(lfs_,
                                           chunkFilePool_,
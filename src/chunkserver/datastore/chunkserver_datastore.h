@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 #include "include/curve_compiler_specific.h"
@@ -44,6 +45,8 @@ namespace curve {
 namespace chunkserver {
 using curve::fs::LocalFileSystem;
 using ::curve::common::Atomic;
+using ::curve::common::Mutex;
+using ::curve::common::LockGuard;
 using CSChunkFilePtr = std::shared_ptr<CSChunkFile>;
 
 inline void TrivialDeleter(void* ptr) {}
@@ -59,6 +62,9 @@ struct DataStoreOptions {
     ChunkSizeType                       chunkSize;
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
+    // Whether to open chunk files with O_DSYNC. If not, the written data
+    // is persisted by SyncDirtyChunks
+    bool                                enableOdsyncWhenOpenChunkFile = true;
 };
 
 /**
@@ -291,11 +297,20 @@ class CSDataStore {
      * @return: internal statistics of datastore
      */
     virtual DataStoreStatus GetStatus();
+    /**
+     * Flush all the chunks written since the last call to disk.
+     * Only takes effect when chunk files are opened without O_DSYNC, the
+     * caller must call it before truncating the raft log.
+     * @return: return error code
+     */
+    virtual CSErrorCode SyncDirtyChunks();
 
  private:
     CSErrorCode loadChunkFile(ChunkID id);
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
                                 CSChunkFilePtr* chunkFile);
+    // Record the chunk that has been modified but not synced
+    void MarkChunkDirty(ChunkID id);
 
  private:
     // The size of each chunk
@@ -315,6 +330,12 @@ class CSDataStore {
     std::shared_ptr<LocalFileSystem> lfs_;
     // internal statistics of datastore
     DataStoreMetricPtr metric_;
+    // Whether to open chunk files with O_DSYNC
+    bool enableOdsyncWhenOpenChunkFile_ = true;
+    // protect dirtyChunks_
+    Mutex dirtyChunksMtx_;
+    // chunks that have been modified but not synced
+    std::unordered_set<ChunkID> dirtyChunks_;
 };
 
 }  // namespace chunkserver
@@ -27,8 +27,11 @@
 #include <butil/sys_byteorder.h>
 #include <brpc/closure_guard.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/chunk_closure.h"
@@ -38,6 +41,135 @@
 namespace curve {
 namespace chunkserver {
 
+namespace {
+
+/**
+ * Create one clone chunk of CreateCloneChunkBatch
+ * @return the status of the chunk, CHUNK_OP_STATUS_CHUNK_EXIST if the chunk
+ * has been created
+ */
+CHUNK_OP_STATUS CreateOneCloneChunk(std::shared_ptr<CSDataStore> datastore,
+                                    const ChunkRequest &request,
+                                    const CloneChunkDesc &desc) {
+    auto ret = datastore->CreateCloneChunk(desc.chunkid(),
+                                           desc.sn(),
+                                           desc.correctedsn(),
+                                           desc.size(),
+                                           desc.location());
+    if (CSErrorCode::Success == ret) {
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+    }
+    if (CSErrorCode::ChunkConflictError == ret) {
+        LOG(WARNING) << "create clone chunk exist: "
+                     << " logic pool id: " << request.logicpoolid()
+                     << " copyset id: " << request.copysetid()
+                     << " chunkid: " << desc.chunkid()
+                     << " sn " << desc.sn()
+                     << " correctedSn: " << desc.correctedsn()
+                     << " location: " << desc.location();
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_EXIST;
+    }
+    if (CSErrorCode::InternalError == ret ||
+        CSErrorCode::CrcCheckError == ret ||
+        CSErrorCode::FileFormatError == ret) {
+        LOG(FATAL) << "create clone failed: "
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunkid: " << desc.chunkid()
+                   << " sn " << desc.sn()
+                   << " correctedSn: " << desc.correctedsn()
+                   << " location: " << desc.location();
+    } else {
+        LOG(ERROR) << "create clone failed: "
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunkid: " << desc.chunkid()
+                   << " sn " << desc.sn()
+                   << " correctedSn: " << desc.correctedsn()
+                   << " location: " << desc.location();
+    }
+    return CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN;
+}
+
+/**
+ * Write one range of WriteChunkBulk, the chunk is created if it doesn't exist
+ * @return the status of the range
+ */
+CHUNK_OP_STATUS WriteOneChunkOfBulk(std::shared_ptr<CSDataStore> datastore,
+                                    const ChunkRequest &request,
+                                    const CloneChunkDesc &desc,
+                                    const butil::IOBuf &data) {
+    uint32_t cost;
+    auto ret = datastore->WriteChunk(desc.chunkid(),
+                                     desc.sn(),
+                                     data,
+                                     desc.offset(),
+                                     desc.size(),
+                                     &cost);
+    if (CSErrorCode::Success == ret) {
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+    }
+    if (CSErrorCode::BackwardRequestError == ret) {
+        LOG(WARNING) << "write bulk failed: "
+                     << " logic pool id: " << request.logicpoolid()
+                     << " copyset id: " << request.copysetid()
+                     << " chunkid: " << desc.chunkid()
+                     << " offset: " << desc.offset()
+                     << " data size: " << desc.size()
+                     << " data store return: " << ret;
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_BACKWARD;
+    }
+    if (CSErrorCode::InternalError == ret ||
+        CSErrorCode::CrcCheckError == ret ||
+        CSErrorCode::FileFormatError == ret) {
+        LOG(FATAL) << "write bulk failed: "
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunkid: " << desc.chunkid()
+                   << " offset: " << desc.offset()
+                   << " data size: " << desc.size()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "write bulk failed: "
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunkid: " << desc.chunkid()
+                   << " offset: " << desc.offset()
+                   << " data size: " << desc.size()
+                   << " data store return: " << ret;
+    }
+    return CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN;
+}
+
+/**
+ * Split the data of a multi-chunk op into the pieces of its chunks, the data
+ * of the chunks is stored in order. Chunks of an op carrying no data get
+ * empty pieces
+ */
+std::vector<butil::IOBuf> SplitChunkData(const ChunkRequest &request,
+                                         const butil::IOBuf &data) {
+    std::vector<butil::IOBuf> pieces(request.clonechunks_size());
+    butil::IOBuf left = data;
+    for (int i = 0; i < request.clonechunks_size(); i++) {
+        left.cutn(&pieces[i], request.clonechunks(i).size());
+    }
+    return pieces;
+}
+
+/**
+ * Shared by the per chunk tasks of a multi-chunk op
+ */
+struct MultiChunkApplyContext {
+    explicit MultiChunkApplyContext(int count) :
+        pending(count),
+        chunkStatus(count, CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {}
+
+    std::atomic<int> pending;
+    std::vector<CHUNK_OP_STATUS> chunkStatus;
+};
+
+}  // namespace
+
 ChunkOpRequest::ChunkOpRequest() :
     datastore_(nullptr),
     node_(nullptr),
@@ -170,11 +302,40 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
             return std::make_shared<PasteChunkInternalRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE:
             return std::make_shared<CreateCloneChunkRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH:
+            return std::make_shared<CreateCloneChunkBatchRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK:
+            return std::make_shared<WriteChunkBulkRequest>();
         default:LOG(ERROR) << "Unknown chunk op";
             return nullptr;
     }
 }
 
+void ChunkOpRequest::ScheduleApply(ConcurrentApplyModule *applyModule,
+                                   uint64_t index,
+                                   ::google::protobuf::Closure *done) {
+    auto task = std::bind(&ChunkOpRequest::OnApply,
+                          shared_from_this(),
+                          index,
+                          done);
+    applyModule->Push(ChunkId(), OpType(), task);
+}
+
+void ChunkOpRequest::ScheduleApplyFromLog(
+    ConcurrentApplyModule *applyModule,
+    std::shared_ptr<CSDataStore> datastore,
+    ChunkRequest request,
+    butil::IOBuf data) {
+    auto chunkId = request.chunkid();
+    auto opType = request.optype();
+    auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
+                          shared_from_this(),
+                          datastore,
+                          std::move(request),
+                          std::move(data));
+    applyModule->Push(chunkId, opType, task);
+}
+
 void DeleteChunkRequest::OnApply(uint64_t index,
                                  ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
@@ -820,6 +981,147 @@ void CreateCloneChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datast
     }
 }
 
+void MultiChunkOpRequest::OnApply(uint64_t index,
+                                  ::google::protobuf::Closure *done) {
+    butil::IOBuf data;
+    if (nullptr != cntl_) {
+        data = cntl_->request_attachment();
+    }
+    auto pieces = SplitChunkData(*request_, data);
+    std::vector<CHUNK_OP_STATUS> chunkStatus;
+    for (int i = 0; i < request_->clonechunks_size(); i++) {
+        chunkStatus.push_back(ApplyChunk(datastore_,
+                                         *request_,
+                                         request_->clonechunks(i),
+                                         pieces[i]));
+    }
+    OnAllApplied(index, done, chunkStatus);
+}
+
+void MultiChunkOpRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  //NOLINT
+                                         const ChunkRequest &request,
+                                         const butil::IOBuf &data) {
+    // NOTE: datastore/request passed in as a parameter is preferred in the
+    // process
+    auto pieces = SplitChunkData(request, data);
+    for (int i = 0; i < request.clonechunks_size(); i++) {
+        ApplyChunk(datastore, request, request.clonechunks(i), pieces[i]);
+    }
+}
+
+void MultiChunkOpRequest::ScheduleApply(ConcurrentApplyModule *applyModule,
+                                        uint64_t index,
+                                        ::google::protobuf::Closure *done) {
+    int count = request_->clonechunks_size();
+    if (0 == count) {
+        ChunkOpRequest::ScheduleApply(applyModule, index, done);
+        return;
+    }
+
+    butil::IOBuf data;
+    if (nullptr != cntl_) {
+        data = cntl_->request_attachment();
+    }
+    auto pieces = SplitChunkData(*request_, data);
+    auto self =
+        std::dynamic_pointer_cast<MultiChunkOpRequest>(shared_from_this());
+    auto ctx = std::make_shared<MultiChunkApplyContext>(count);
+    for (int i = 0; i < count; i++) {
+        butil::IOBuf piece = pieces[i];
+        auto task = [self, ctx, i, index, done, piece]() {
+            const ChunkRequest &request = *self->request_;
+            ctx->chunkStatus[i] = self->ApplyChunk(
+                self->datastore_, request, request.clonechunks(i), piece);
+            // the last applied chunk finishes the op
+            if (1 == ctx->pending.fetch_sub(1, std::memory_order_acq_rel)) {
+                self->OnAllApplied(index, done, ctx->chunkStatus);
+            }
+        };
+        applyModule->Push(request_->clonechunks(i).chunkid(), OpType(), task);
+    }
+}
+
+void MultiChunkOpRequest::ScheduleApplyFromLog(
+    ConcurrentApplyModule *applyModule,
+    std::shared_ptr<CSDataStore> datastore,
+    ChunkRequest request,
+    butil::IOBuf data) {
+    auto pieces = SplitChunkData(request, data);
+    auto self =
+        std::dynamic_pointer_cast<MultiChunkOpRequest>(shared_from_this());
+    auto sharedRequest = std::make_shared<ChunkRequest>(std::move(request));
+    for (int i = 0; i < sharedRequest->clonechunks_size(); i++) {
+        butil::IOBuf piece = pieces[i];
+        auto task = [self, datastore, sharedRequest, i, piece]() {
+            self->ApplyChunk(datastore,
+                             *sharedRequest,
+                             sharedRequest->clonechunks(i),
+                             piece);
+        };
+        applyModule->Push(sharedRequest->clonechunks(i).chunkid(),
+                          sharedRequest->optype(),
+                          task);
+    }
+}
+
+void MultiChunkOpRequest::OnAllApplied(
+    uint64_t index,
+    ::google::protobuf::Closure *done,
+    const std::vector<CHUNK_OP_STATUS> &chunkStatus) {
+    brpc::ClosureGuard doneGuard(done);
+
+    for (auto status : chunkStatus) {
+        response_->add_chunkstatus(status);
+    }
+    CHUNK_OP_STATUS status = MergeStatus(chunkStatus);
+    response_->set_status(status);
+    if (CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS == status) {
+        node_->UpdateAppliedIndex(index);
+    }
+    auto maxIndex =
+        (index > node_->GetAppliedIndex() ? index : node_->GetAppliedIndex());
+    response_->set_appliedindex(maxIndex);
+}
+
+CHUNK_OP_STATUS CreateCloneChunkBatchRequest::ApplyChunk(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request,
+    const CloneChunkDesc &desc,
+    const butil::IOBuf &data) {
+    return CreateOneCloneChunk(datastore, request, desc);
+}
+
+CHUNK_OP_STATUS CreateCloneChunkBatchRequest::MergeStatus(
+    const std::vector<CHUNK_OP_STATUS> &chunkStatus) {
+    // Chunks that already exist are created by the previous request, the
+    // batch fails only if some chunk can not be created
+    for (auto status : chunkStatus) {
+        if (CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN == status) {
+            return status;
+        }
+    }
+    return CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+}
+
+CHUNK_OP_STATUS WriteChunkBulkRequest::ApplyChunk(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request,
+    const CloneChunkDesc &desc,
+    const butil::IOBuf &data) {
+    return WriteOneChunkOfBulk(datastore, request, desc, data);
+}
+
+CHUNK_OP_STATUS WriteChunkBulkRequest::MergeStatus(
+    const std::vector<CHUNK_OP_STATUS> &chunkStatus) {
+    // the first failed chunk decides the status of the bulk
+    for (auto status : chunkStatus) {
+        if (CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS != status) {
+            return status;
+        }
+    }
+    return CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+}
+
 void PasteChunkInternalRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
     /**
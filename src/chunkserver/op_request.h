@@ -28,6 +28,7 @@
 #include <brpc/controller.h>
 
 #include <memory>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -98,6 +99,27 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
                                 const ChunkRequest &request,
                                 const butil::IOBuf &data) = 0;
 
+    /**
+     * Push the on apply logic to the concurrent apply module. It is scheduled
+     * on the queue of the chunk, so that ops on the same chunk are applied in
+     * the order of the log
+     * @param applyModule: concurrent apply module
+     * @param index:op log entry's index
+     * @param done:corresponding ChunkClosure
+     */
+    virtual void ScheduleApply(ConcurrentApplyModule *applyModule,
+                               uint64_t index,
+                               ::google::protobuf::Closure *done);
+
+    /**
+     * Same as ScheduleApply, for the op deserialized from the log entry,
+     * see OnApplyFromLog
+     */
+    virtual void ScheduleApplyFromLog(ConcurrentApplyModule *applyModule,
+                                      std::shared_ptr<CSDataStore> datastore,
+                                      ChunkRequest request,
+                                      butil::IOBuf data);
+
     /**
      * Return the request's done member
      */
@@ -333,6 +355,133 @@ class CreateCloneChunkRequest : public ChunkOpRequest {
                         const butil::IOBuf &data) override;
 };
 
+/**
+ * Base of the ops which carry several chunks of the same copyset in one
+ * request, all of them are proposed as one raft log entry.
+ * The entry is split into one task per chunk when it is applied, each task is
+ * scheduled on the apply queue of its own chunk, so that it is ordered with
+ * the other ops on that chunk. The op is finished after the last chunk is
+ * applied.
+ */
+class MultiChunkOpRequest : public ChunkOpRequest {
+ public:
+    MultiChunkOpRequest() :
+        ChunkOpRequest() {}
+    MultiChunkOpRequest(std::shared_ptr<CopysetNode> nodePtr,
+                        RpcController *cntl,
+                        const ChunkRequest *request,
+                        ChunkResponse *response,
+                        ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       cntl,
+                       request,
+                       response,
+                       done) {}
+    virtual ~MultiChunkOpRequest() = default;
+
+    /**
+     * Apply all the chunks one by one in the calling thread
+     */
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+
+    void ScheduleApply(ConcurrentApplyModule *applyModule,
+                       uint64_t index,
+                       ::google::protobuf::Closure *done) override;
+    void ScheduleApplyFromLog(ConcurrentApplyModule *applyModule,
+                              std::shared_ptr<CSDataStore> datastore,
+                              ChunkRequest request,
+                              butil::IOBuf data) override;
+
+ protected:
+    /**
+     * Apply one chunk of the op
+     * @param datastore:chunk data persistence layer
+     * @param request:the request of the whole op
+     * @param desc:the chunk to apply
+     * @param data:the data of the chunk, empty if the op carries no data
+     * @return the status of the chunk
+     */
+    virtual CHUNK_OP_STATUS ApplyChunk(std::shared_ptr<CSDataStore> datastore,
+                                       const ChunkRequest &request,
+                                       const CloneChunkDesc &desc,
+                                       const butil::IOBuf &data) = 0;
+
+    /**
+     * Return the status of the whole op by the status of every chunk
+     */
+    virtual CHUNK_OP_STATUS MergeStatus(
+        const std::vector<CHUNK_OP_STATUS> &chunkStatus) = 0;
+
+ private:
+    /**
+     * Fill the response and run done after all the chunks are applied
+     */
+    void OnAllApplied(uint64_t index,
+                      ::google::protobuf::Closure *done,
+                      const std::vector<CHUNK_OP_STATUS> &chunkStatus);
+};
+
+/**
+ * Create the clone chunks of the same copyset carried by one request
+ */
+class CreateCloneChunkBatchRequest : public MultiChunkOpRequest {
+ public:
+    CreateCloneChunkBatchRequest() :
+        MultiChunkOpRequest() {}
+    CreateCloneChunkBatchRequest(std::shared_ptr<CopysetNode> nodePtr,
+                                 RpcController *cntl,
+                                 const ChunkRequest *request,
+                                 ChunkResponse *response,
+                                 ::google::protobuf::Closure *done) :
+        MultiChunkOpRequest(nodePtr,
+                            cntl,
+                            request,
+                            response,
+                            done) {}
+    virtual ~CreateCloneChunkBatchRequest() = default;
+
+ protected:
+    CHUNK_OP_STATUS ApplyChunk(std::shared_ptr<CSDataStore> datastore,
+                               const ChunkRequest &request,
+                               const CloneChunkDesc &desc,
+                               const butil::IOBuf &data) override;
+    CHUNK_OP_STATUS MergeStatus(
+        const std::vector<CHUNK_OP_STATUS> &chunkStatus) override;
+};
+
+/**
+ * Write ranges of several chunks of the same copyset carried by one request,
+ * the data of the ranges is stored in order in the attachment. Chunks that
+ * don't exist are created by the write.
+ */
+class WriteChunkBulkRequest : public MultiChunkOpRequest {
+ public:
+    WriteChunkBulkRequest() :
+        MultiChunkOpRequest() {}
+    WriteChunkBulkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                          RpcController *cntl,
+                          const ChunkRequest *request,
+                          ChunkResponse *response,
+                          ::google::protobuf::Closure *done) :
+        MultiChunkOpRequest(nodePtr,
+                            cntl,
+                            request,
+                            response,
+                            done) {}
+    virtual ~WriteChunkBulkRequest() = default;
+
+ protected:
+    CHUNK_OP_STATUS ApplyChunk(std::shared_ptr<CSDataStore> datastore,
+                               const ChunkRequest &request,
+                               const CloneChunkDesc &desc,
+                               const butil::IOBuf &data) override;
+    CHUNK_OP_STATUS MergeStatus(
+        const std::vector<CHUNK_OP_STATUS> &chunkStatus) override;
+};
+
 class PasteChunkInternalRequest : public ChunkOpRequest {
  public:
     PasteChunkInternalRequest() :
@@ -586,6 +586,57 @@ void RecoverChunkClosure::SendRetryRequest() {
                           done_);
 }
 
+void CreateCloneChunkBatchClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    // 批量成功时每个chunk都已创建或已存在
+    auto& items = *reqCtx_->batchItems_;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (static_cast<int>(i) < response_->chunkstatus_size() &&
+            response_->chunkstatus(i) ==
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_EXIST) {
+            items[i].ret = -LIBCURVE_ERROR::EXISTS;
+        } else {
+            items[i].ret = LIBCURVE_ERROR::OK;
+        }
+    }
+}
+
+void CreateCloneChunkBatchClosure::SendRetryRequest() {
+    client_->CreateCloneChunkBatch(reqCtx_->idinfo_,
+                                   reqCtx_->batchItems_,
+                                   done_);
+}
+
+void RecoverChunkBatchClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    for (auto& item : *reqCtx_->batchItems_) {
+        item.ret = LIBCURVE_ERROR::OK;
+    }
+}
+
+void RecoverChunkBatchClosure::SendRetryRequest() {
+    client_->RecoverChunkBatch(reqCtx_->idinfo_,
+                               reqCtx_->batchItems_,
+                               done_);
+}
+
+void WriteChunkBulkClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    for (auto& item : *reqCtx_->batchItems_) {
+        item.ret = LIBCURVE_ERROR::OK;
+    }
+}
+
+void WriteChunkBulkClosure::SendRetryRequest() {
+    client_->WriteChunkBulk(reqCtx_->idinfo_,
+                            reqCtx_->batchItems_,
+                            reqCtx_->writeData_,
+                            done_);
+}
+
 int ClientClosure::UpdateLeaderWithRedirectInfo(const std::string& leaderInfo) {
     ChunkServerID leaderId = 0;
     ChunkServerAddr leaderAddr;
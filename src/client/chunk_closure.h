@@ -305,6 +305,33 @@ class RecoverChunkClosure : public ClientClosure {
     void SendRetryRequest() override;
 };
 
+class CreateCloneChunkBatchClosure : public ClientClosure {
+ public:
+    CreateCloneChunkBatchClosure(CopysetClient* client, Closure* done)
+        : ClientClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
+class RecoverChunkBatchClosure : public ClientClosure {
+ public:
+    RecoverChunkBatchClosure(CopysetClient* client, Closure* done)
+        : ClientClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
+class WriteChunkBulkClosure : public ClientClosure {
+ public:
+    WriteChunkBulkClosure(CopysetClient* client, Closure* done)
+        : ClientClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
 }   // namespace client
 }   // namespace curve
 
@@ -58,6 +58,9 @@ enum class OpType {
     CREATE_CLONE,
     RECOVER_CHUNK,
     GET_CHUNK_INFO,
+    CREATE_CLONE_BATCH,
+    RECOVER_CHUNK_BATCH,
+    WRITE_BULK,
     UNKNOWN
 };
 
@@ -93,6 +96,23 @@ typedef struct ChunkIDInfo {
     }
 } ChunkIDInfo_t;
 
+// 批量CreateCloneChunk/RecoverChunk/WriteChunkBulk中的一个chunk，
+// 同一个批量请求中的chunk属于同一个copyset
+typedef struct CloneChunkBatchItem {
+    ChunkID         cid = 0;
+    // for CreateCloneChunk, 数据源的url、chunk的版本号及大小
+    std::string     location;
+    uint64_t        sn = 0;
+    uint64_t        correctedSn = 0;
+    uint64_t        chunkSize = 0;
+    // for RecoverChunk/WriteChunkBulk, 恢复或写入的范围，
+    // WriteChunkBulk写入的版本号也使用sn
+    uint64_t        offset = 0;
+    uint64_t        len = 0;
+    // 请求成功返回后每个chunk的结果，-LIBCURVE_ERROR::EXISTS表示chunk已存在
+    int             ret = -LIBCURVE_ERROR::FAILED;
+} CloneChunkBatchItem_t;
+
 // 保存每个chunk对应的版本信息
 typedef struct ChunkInfoDetail {
     std::vector<uint64_t> chunkSn;
@@ -245,6 +265,12 @@ inline const char* OpTypeToString(OpType optype) {
         return "RecoverChunk";
     case OpType::GET_CHUNK_INFO:
         return "GetChunkInfo";
+    case OpType::CREATE_CLONE_BATCH:
+        return "CreateCloneChunkBatch";
+    case OpType::RECOVER_CHUNK_BATCH:
+        return "RecoverChunkBatch";
+    case OpType::WRITE_BULK:
+        return "WriteChunkBulk";
     case OpType::UNKNOWN:
     default:
         return "Unknown";
@@ -207,6 +207,39 @@ int ClientConfig::Init(const char* configpath) {
         &fileServiceOption_.metaServerOpt.mdsMaxFailedTimesBeforeChangeMDS);
     LOG_IF(ERROR, ret == false) << "config no mds.maxFailedTimesBeforeChangeMDS info";  // NOLINT
 
+    std::string followerReadAddr;
+    if (conf_.GetStringValue("mds.followerRead.addr", &followerReadAddr) &&
+        !followerReadAddr.empty()) {
+        std::vector<std::string> followerAddrs;
+        common::SplitString(followerReadAddr, ",", &followerAddrs);
+        for (auto& addr : followerAddrs) {
+            if (!curve::common::NetCommon::CheckAddressValid(addr)) {
+                LOG(ERROR) << "follower read address invalid: " << addr;
+                return -1;
+            }
+        }
+        fileServiceOption_.metaServerOpt.followerReadAddrs.assign(
+            followerAddrs.begin(), followerAddrs.end());
+    }
+
+    ret = conf_.GetBoolValue("mds.followerRead.getFileInfo",
+        &fileServiceOption_.metaServerOpt.followerReadGetFileInfo);
+    LOG_IF(WARNING, ret == false)
+        << "config no mds.followerRead.getFileInfo info, using default value "
+        << fileServiceOption_.metaServerOpt.followerReadGetFileInfo;
+
+    ret = conf_.GetBoolValue("mds.followerRead.listDir",
+        &fileServiceOption_.metaServerOpt.followerReadListDir);
+    LOG_IF(WARNING, ret == false)
+        << "config no mds.followerRead.listDir info, using default value "
+        << fileServiceOption_.metaServerOpt.followerReadListDir;
+
+    ret = conf_.GetUInt64Value("mds.followerRead.maxRetryMS",
+        &fileServiceOption_.metaServerOpt.followerReadMaxRetryMS);
+    LOG_IF(WARNING, ret == false)
+        << "config no mds.followerRead.maxRetryMS info, using default value "
+        << fileServiceOption_.metaServerOpt.followerReadMaxRetryMS;
+
     ret = conf_.GetBoolValue("mds.registerToMDS",
         &fileServiceOption_.commonOpt.mdsRegisterToMDS);
     LOG_IF(ERROR, ret == false) << "config no mds.registerToMDS info";
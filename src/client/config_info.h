@@ -60,6 +60,10 @@ struct InFlightIOCntlInfo {
  * @mdsMaxFailedTimesBeforeChangeMDS: 如果重试的rpc在一个mds节点上连续失败超过该值
  *                       就需要主动触发切换mds再重试。
  * @mdsAddrs: mds server地址，存放mds集群的多个地址信息
+ * @followerReadAddrs: 所有mds上只读元数据服务的地址，为空时不开启follower读
+ * @followerReadGetFileInfo: GetFileInfo是否优先发往只读元数据服务
+ * @followerReadListDir: Listdir是否优先发往只读元数据服务
+ * @followerReadMaxRetryMS: 只读元数据服务的重试总时间，失败后再发往leader
  */
 struct MetaServerOption {
     uint64_t mdsMaxRetryMS = 8000;
@@ -68,6 +72,10 @@ struct MetaServerOption {
     uint32_t mdsRPCRetryIntervalUS = 50000;
     uint32_t mdsMaxFailedTimesBeforeChangeMDS = 5;
     std::vector<std::string> mdsAddrs;
+    std::vector<std::string> followerReadAddrs;
+    bool followerReadGetFileInfo = false;
+    bool followerReadListDir = false;
+    uint64_t followerReadMaxRetryMS = 1000;
 };
 
 /**
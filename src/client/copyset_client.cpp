@@ -240,6 +240,40 @@ int CopysetClient::RecoverChunk(const ChunkIDInfo& idinfo,
     return DoRPCTask(idinfo, task, done);
 }
 
+int CopysetClient::CreateCloneChunkBatch(const ChunkIDInfo& idinfo,
+    std::vector<CloneChunkBatchItem>* items, Closure* done) {
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        CreateCloneChunkBatchClosure* createCloneDone =
+            new CreateCloneChunkBatchClosure(this, done);
+        senderPtr->CreateCloneChunkBatch(idinfo, createCloneDone, *items);
+    };
+
+    return DoRPCTask(idinfo, task, done);
+}
+
+int CopysetClient::RecoverChunkBatch(const ChunkIDInfo& idinfo,
+    std::vector<CloneChunkBatchItem>* items, Closure* done) {
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        RecoverChunkBatchClosure* recoverChunkDone =
+            new RecoverChunkBatchClosure(this, done);
+        senderPtr->RecoverChunkBatch(idinfo, recoverChunkDone, *items);
+    };
+
+    return DoRPCTask(idinfo, task, done);
+}
+
+int CopysetClient::WriteChunkBulk(const ChunkIDInfo& idinfo,
+    std::vector<CloneChunkBatchItem>* items, const butil::IOBuf& data,
+    Closure* done) {
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        WriteChunkBulkClosure* writeDone =
+            new WriteChunkBulkClosure(this, done);
+        senderPtr->WriteChunkBulk(idinfo, writeDone, *items, data);
+    };
+
+    return DoRPCTask(idinfo, task, done);
+}
+
 int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
     std::function<void(Closure* done,
     std::shared_ptr<RequestSender> senderptr)> task, Closure *done) {
@@ -28,6 +28,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "include/curve_compiler_specific.h"
 #include "src/client/client_common.h"
@@ -177,6 +178,41 @@ class CopysetClient {
                   uint64_t len,
                   Closure *done);
 
+    /**
+    * @brief 批量lazy创建同一个copyset上的clone chunk
+    * @param idinfo为copyset的id信息
+    * @param items 待创建的chunk，成功返回后记录每个chunk的结果
+    * @param done:上一层异步回调的closure
+    * @return 错误码
+    */
+    int CreateCloneChunkBatch(const ChunkIDInfo& idinfo,
+                  std::vector<CloneChunkBatchItem>* items,
+                  Closure *done);
+
+   /**
+    * @brief 批量恢复同一个copyset上的chunk数据
+    * @param idinfo为copyset的id信息
+    * @param items 待恢复的chunk范围
+    * @param done:上一层异步回调的closure
+    * @return 错误码
+    */
+    int RecoverChunkBatch(const ChunkIDInfo& idinfo,
+                  std::vector<CloneChunkBatchItem>* items,
+                  Closure *done);
+
+   /**
+    * @brief 批量写入同一个copyset上的多个chunk，chunk不存在时由写入创建
+    * @param idinfo为copyset的id信息
+    * @param items 写入的chunk范围
+    * @param data 各范围的数据，按items的顺序依次存放
+    * @param done:上一层异步回调的closure
+    * @return 错误码
+    */
+    int WriteChunkBulk(const ChunkIDInfo& idinfo,
+                  std::vector<CloneChunkBatchItem>* items,
+                  const butil::IOBuf& data,
+                  Closure *done);
+
     /**
      * @brief 如果csId对应的RequestSender不健康，就进行重置
      * @param csId chunkserver id
@@ -369,6 +369,101 @@ void IOTracker::RecoverChunk(const ChunkIDInfo& cinfo, uint64_t offset,
     }
 }
 
+void IOTracker::CreateCloneChunkBatch(const ChunkIDInfo& cinfo,
+                                      std::vector<CloneChunkBatchItem>* items,
+                                      SnapCloneClosure* scc) {
+    type_ = OpType::CREATE_CLONE_BATCH;
+    scc_ = scc;
+
+    int ret = -1;
+    do {
+        RequestContext* newreqNode = RequestContext::NewInitedRequestContext();
+        if (newreqNode == nullptr) {
+            break;
+        }
+
+        newreqNode->batchItems_ = items;
+        FillCommonFields(cinfo, newreqNode);
+
+        reqlist_.push_back(newreqNode);
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } while (false);
+
+    if (ret == -1) {
+        LOG(ERROR) << "CreateCloneChunkBatch request schedule failed,"
+                   << " return and recycle resource!";
+        ReturnOnFail();
+    }
+}
+
+void IOTracker::RecoverChunkBatch(const ChunkIDInfo& cinfo,
+                                  std::vector<CloneChunkBatchItem>* items,
+                                  SnapCloneClosure* scc) {
+    type_ = OpType::RECOVER_CHUNK_BATCH;
+    scc_ = scc;
+
+    int ret = -1;
+    do {
+        RequestContext* newreqNode = RequestContext::NewInitedRequestContext();
+        if (newreqNode == nullptr) {
+            break;
+        }
+
+        newreqNode->batchItems_ = items;
+        FillCommonFields(cinfo, newreqNode);
+
+        reqlist_.push_back(newreqNode);
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } while (false);
+
+    if (ret == -1) {
+        LOG(ERROR) << "RecoverChunkBatch request schedule failed,"
+                   << " return and recycle resource!";
+        ReturnOnFail();
+    }
+}
+
+void IOTracker::WriteChunkBulk(const ChunkIDInfo& cinfo,
+                               std::vector<CloneChunkBatchItem>* items,
+                               const char* buf,
+                               SnapCloneClosure* scc) {
+    type_ = OpType::WRITE_BULK;
+    scc_ = scc;
+
+    int ret = -1;
+    do {
+        RequestContext* newreqNode = RequestContext::NewInitedRequestContext();
+        if (newreqNode == nullptr) {
+            break;
+        }
+
+        size_t length = 0;
+        for (const auto& item : *items) {
+            length += item.len;
+        }
+        newreqNode->batchItems_ = items;
+        newreqNode->rawlength_ = length;
+        newreqNode->writeData_.append_user_data(const_cast<char*>(buf),
+                                                length, TrivialDeleter);
+        FillCommonFields(cinfo, newreqNode);
+
+        reqlist_.push_back(newreqNode);
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } while (false);
+
+    if (ret == -1) {
+        LOG(ERROR) << "WriteChunkBulk request schedule failed,"
+                   << " return and recycle resource!";
+        ReturnOnFail();
+    }
+}
+
 void IOTracker::FillCommonFields(ChunkIDInfo idinfo, RequestContext* req) {
     req->optype_      = type_;
     req->idinfo_      = idinfo;
@@ -158,6 +158,38 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     void RecoverChunk(const ChunkIDInfo& chunkIdInfo, uint64_t offset,
                       uint64_t len, SnapCloneClosure* scc);
 
+    /**
+     * @brief 批量lazy创建同一个copyset上的clone chunk
+     * @param:copysetidinfo copyset的id信息
+     * @param:items 待创建的chunk，成功返回后记录每个chunk的结果
+     * @param: scc是异步回调
+     */
+    void CreateCloneChunkBatch(const ChunkIDInfo& copysetidinfo,
+                               std::vector<CloneChunkBatchItem>* items,
+                               SnapCloneClosure* scc);
+
+    /**
+     * @brief 批量恢复同一个copyset上的chunk数据
+     * @param:copysetidinfo copyset的id信息
+     * @param:items 待恢复的chunk范围
+     * @param: scc是异步回调
+     */
+    void RecoverChunkBatch(const ChunkIDInfo& copysetidinfo,
+                           std::vector<CloneChunkBatchItem>* items,
+                           SnapCloneClosure* scc);
+
+    /**
+     * @brief 批量写入同一个copyset上的多个chunk
+     * @param:copysetidinfo copyset的id信息
+     * @param:items 写入的chunk范围
+     * @param:buf 各范围的数据，按items的顺序依次存放
+     * @param: scc是异步回调
+     */
+    void WriteChunkBulk(const ChunkIDInfo& copysetidinfo,
+                        std::vector<CloneChunkBatchItem>* items,
+                        const char* buf,
+                        SnapCloneClosure* scc);
+
     /**
      * Wait用于同步接口等待，因为用户下来的IO被client内部线程接管之后
      * 调用就可以向上返回了，但是用户的同步IO语意是要等到结果返回才能向上
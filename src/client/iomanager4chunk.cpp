@@ -98,6 +98,28 @@ int IOManager4Chunk::RecoverChunk(const ChunkIDInfo& chunkIdInfo,
     return 0;
 }
 
+int IOManager4Chunk::CreateCloneChunkBatch(const ChunkIDInfo& copysetidinfo,
+    std::vector<CloneChunkBatchItem>* items, SnapCloneClosure* scc) {
+    IOTracker* ioTracker = new IOTracker(this, &mc_, scheduler_);
+    ioTracker->CreateCloneChunkBatch(copysetidinfo, items, scc);
+    return 0;
+}
+
+int IOManager4Chunk::RecoverChunkBatch(const ChunkIDInfo& copysetidinfo,
+    std::vector<CloneChunkBatchItem>* items, SnapCloneClosure* scc) {
+    IOTracker* ioTracker = new IOTracker(this, &mc_, scheduler_);
+    ioTracker->RecoverChunkBatch(copysetidinfo, items, scc);
+    return 0;
+}
+
+int IOManager4Chunk::WriteChunkBulk(const ChunkIDInfo& copysetidinfo,
+    std::vector<CloneChunkBatchItem>* items, const char* buf,
+    SnapCloneClosure* scc) {
+    IOTracker* ioTracker = new IOTracker(this, &mc_, scheduler_);
+    ioTracker->WriteChunkBulk(copysetidinfo, items, buf, scc);
+    return 0;
+}
+
 void IOManager4Chunk::HandleAsyncIOResponse(IOTracker* iotracker) {
     delete iotracker;
 }
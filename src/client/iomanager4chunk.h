@@ -27,6 +27,7 @@
 #include <mutex>    // NOLINT
 #include <string>
 #include <condition_variable>   // NOLINT
+#include <vector>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager.h"
@@ -108,6 +109,43 @@ class IOManager4Chunk : public IOManager {
     int RecoverChunk(const ChunkIDInfo& chunkIdInfo, uint64_t offset,
                      uint64_t len, SnapCloneClosure* scc);
 
+    /**
+     * @brief 批量lazy创建同一个copyset上的clone chunk
+     * @param copysetidinfo copyset的id信息
+     * @param items 待创建的chunk，成功返回后记录每个chunk的结果，
+     *              在回调之前调用者需保证其有效
+     * @param scc 异步回调
+     * @return 成功返回0， 否则-1
+     */
+    int CreateCloneChunkBatch(const ChunkIDInfo& copysetidinfo,
+                              std::vector<CloneChunkBatchItem>* items,
+                              SnapCloneClosure* scc);
+
+    /**
+     * @brief 批量恢复同一个copyset上的chunk数据
+     * @param copysetidinfo copyset的id信息
+     * @param items 待恢复的chunk范围，在回调之前调用者需保证其有效
+     * @param scc 异步回调
+     * @return 成功返回0， 否则-1
+     */
+    int RecoverChunkBatch(const ChunkIDInfo& copysetidinfo,
+                          std::vector<CloneChunkBatchItem>* items,
+                          SnapCloneClosure* scc);
+
+    /**
+     * @brief 批量写入同一个copyset上的多个chunk
+     * @param copysetidinfo copyset的id信息
+     * @param items 写入的chunk范围，在回调之前调用者需保证其有效
+     * @param buf 各范围的数据，按items的顺序依次存放，
+     *            在回调之前调用者需保证其有效
+     * @param scc 异步回调
+     * @return 成功返回0， 否则-1
+     */
+    int WriteChunkBulk(const ChunkIDInfo& copysetidinfo,
+                       std::vector<CloneChunkBatchItem>* items,
+                       const char* buf,
+                       SnapCloneClosure* scc);
+
     /**
      * 因为curve client底层都是异步IO，每个IO会分配一个IOtracker跟踪IO
      * 当这个IO做完之后，底层需要告知当前io manager来释放这个IOTracker，
@@ -24,6 +24,10 @@
 
 #include <glog/logging.h>
 
+#include <map>
+#include <set>
+#include <vector>
+
 #include "include/curve_compiler_specific.h"
 #include "src/client/client_common.h"
 #include "src/client/client_config.h"
@@ -149,6 +153,43 @@ int SnapshotClient::GetSnapshotSegmentInfo(const std::string& filename,
                          segInfo->lpcpIDInfo.cpidVec);
 }
 
+int SnapshotClient::ListSnapshotSegment(const std::string& filename,
+                                        const UserInfo_t& userinfo,
+                                        uint64_t seq,
+                                        uint64_t startOffset,
+                                        uint32_t limit,
+                                        std::vector<SegmentInfo> *segInfos,
+                                        uint64_t *nextOffset) {
+    int ret = mdsclient_.ListSnapshotSegment(filename, userinfo, seq,
+                                             startOffset, limit,
+                                             segInfos, nextOffset);
+    if (ret != LIBCURVE_ERROR::OK) {
+        LOG(WARNING) << "ListSnapshotSegment failed, ret = " << ret;
+        return -ret;
+    }
+
+    // 一页内的copyset合并后一次获取server列表
+    std::map<LogicPoolID, std::set<CopysetID>> copysets;
+    for (const auto& segInfo : *segInfos) {
+        for (const auto& iter : segInfo.chunkvec) {
+            iomanager4chunk_.GetMetaCache()->UpdateChunkInfoByID(iter.cid_,
+                                                                 iter);
+        }
+        copysets[segInfo.lpcpIDInfo.lpid].insert(
+            segInfo.lpcpIDInfo.cpidVec.begin(),
+            segInfo.lpcpIDInfo.cpidVec.end());
+    }
+
+    for (const auto& item : copysets) {
+        ret = GetServerList(item.first, std::vector<CopysetID>(
+            item.second.begin(), item.second.end()));
+        if (ret != LIBCURVE_ERROR::OK) {
+            return ret;
+        }
+    }
+    return LIBCURVE_ERROR::OK;
+}
+
 int SnapshotClient::GetServerList(const LogicPoolID& lpid,
                                         const std::vector<CopysetID>& csid) {
     std::vector<CopysetInfo> cpinfoVec;
@@ -267,6 +308,25 @@ int SnapshotClient::RecoverChunk(const ChunkIDInfo &chunkidinfo,
     return iomanager4chunk_.RecoverChunk(chunkidinfo, offset, len, scc);
 }
 
+int SnapshotClient::CreateCloneChunkBatch(const ChunkIDInfo &copysetidinfo,
+                                          std::vector<CloneChunkBatchItem>* items,  // NOLINT
+                                          SnapCloneClosure* scc) {
+    return iomanager4chunk_.CreateCloneChunkBatch(copysetidinfo, items, scc);
+}
+
+int SnapshotClient::RecoverChunkBatch(const ChunkIDInfo &copysetidinfo,
+                                      std::vector<CloneChunkBatchItem>* items,
+                                      SnapCloneClosure* scc) {
+    return iomanager4chunk_.RecoverChunkBatch(copysetidinfo, items, scc);
+}
+
+int SnapshotClient::WriteChunkBulk(const ChunkIDInfo &copysetidinfo,
+                                   std::vector<CloneChunkBatchItem>* items,
+                                   const char* buf,
+                                   SnapCloneClosure* scc) {
+    return iomanager4chunk_.WriteChunkBulk(copysetidinfo, items, buf, scc);
+}
+
 int SnapshotClient::ReadChunkSnapshot(ChunkIDInfo cidinfo,
                                         uint64_t seq,
                                         uint64_t offset,
@@ -111,6 +111,25 @@ class SnapshotClient {
                             uint64_t offset,
                             SegmentInfo *segInfo);
 
+  /**
+   * 从startOffset开始分页获取快照已分配的segment信息，并更新到metacache
+   * @param：filename是要快照的文件名
+   * @param：userinfo是用户信息
+   * @param：seq是创建快照时文件的版本信息
+   * @param：startOffset是起始偏移，需按segment对齐
+   * @param：limit是本次最多获取的segment数
+   * @param：segInfos是出参，按offset顺序保存获取到的segment信息
+   * @param：nextOffset是出参，下一页的起始偏移，没有更多segment时为0
+   * @return: 成功返回LIBCURVE_ERROR::OK,否则LIBCURVE_ERROR::FAILED
+   */
+  int ListSnapshotSegment(const std::string& filename,
+                          const UserInfo_t& userinfo,
+                          uint64_t seq,
+                          uint64_t startOffset,
+                          uint32_t limit,
+                          std::vector<SegmentInfo> *segInfos,
+                          uint64_t *nextOffset);
+
   /**
    * 读取seq版本号的快照数据
    * @param: cidinfo是当前chunk对应的id信息
@@ -201,6 +220,47 @@ class SnapshotClient {
                    uint64_t offset, uint64_t len,
                    SnapCloneClosure* scc);
 
+  /**
+   * @brief 批量lazy创建同一个copyset上的clone chunk
+   *
+   * @param:copysetidinfo copyset的id信息
+   * @param:items 待创建的chunk，成功返回后记录每个chunk的结果
+   * @param: scc是异步回调
+   *
+   * @return 错误码
+   */
+  int CreateCloneChunkBatch(const ChunkIDInfo &copysetidinfo,
+                            std::vector<CloneChunkBatchItem>* items,
+                            SnapCloneClosure* scc);
+
+  /**
+   * @brief 批量恢复同一个copyset上的chunk数据
+   *
+   * @param:copysetidinfo copyset的id信息
+   * @param:items 待恢复的chunk范围
+   * @param: scc是异步回调
+   *
+   * @return 错误码
+   */
+  int RecoverChunkBatch(const ChunkIDInfo &copysetidinfo,
+                        std::vector<CloneChunkBatchItem>* items,
+                        SnapCloneClosure* scc);
+
+  /**
+   * @brief 批量写入同一个copyset上的多个chunk，chunk不存在时由写入创建
+   *
+   * @param:copysetidinfo copyset的id信息
+   * @param:items 写入的chunk范围
+   * @param:buf 各范围的数据，按items的顺序依次存放
+   * @param: scc是异步回调
+   *
+   * @return 错误码
+   */
+  int WriteChunkBulk(const ChunkIDInfo &copysetidinfo,
+                     std::vector<CloneChunkBatchItem>* items,
+                     const char* buf,
+                     SnapCloneClosure* scc);
+
   /**
    * @brief 通知mds完成Clone Meta
    *
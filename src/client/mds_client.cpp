@@ -48,6 +48,7 @@ using curve::mds::DeleteFileResponse;
 using curve::mds::RecoverFileResponse;
 using curve::mds::GetFileInfoResponse;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::ListSegmentResponse;
 using curve::mds::RenameFileResponse;
 using curve::mds::ExtendFileResponse;
 using curve::mds::ChangeOwnerResponse;
@@ -88,6 +89,12 @@ LIBCURVE_ERROR MDSClient::Initialize(const MetaServerOption& metaServerOpt) {
 
     rpcExcutor.SetOption(metaServerOpt);
 
+    if (!metaServerOpt.followerReadAddrs.empty()) {
+        MetaServerOption followerOpt = metaServerOpt;
+        followerOpt.mdsAddrs = metaServerOpt.followerReadAddrs;
+        followerReadExcutor_.SetOption(followerOpt);
+    }
+
     inited_ = true;
     return LIBCURVE_ERROR::OK;
 }
@@ -414,6 +421,17 @@ LIBCURVE_ERROR MDSClient::GetFileInfo(const std::string& filename,
             << ", log id = " << cntl->log_id();
         return retcode;
     };
+
+    if (metaServerOpt_.followerReadGetFileInfo &&
+        !metaServerOpt_.followerReadAddrs.empty()) {
+        // follower失败或者不支持时再发往leader
+        LIBCURVE_ERROR ret = followerReadExcutor_.DoRPCTask(task,
+            metaServerOpt_.followerReadMaxRetryMS);
+        if (ret != LIBCURVE_ERROR::FAILED &&
+            ret != LIBCURVE_ERROR::NOT_SUPPORT) {
+            return ret;
+        }
+    }
     return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
 }
 
@@ -609,6 +627,82 @@ LIBCURVE_ERROR MDSClient::GetSnapshotSegmentInfo(const std::string& filename,
     return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
 }
 
+LIBCURVE_ERROR MDSClient::ListSnapshotSegment(
+    const std::string& filename,
+    const UserInfo_t& userinfo,
+    uint64_t seq,
+    uint64_t startOffset,
+    uint32_t limit,
+    std::vector<SegmentInfo>* segInfos,
+    uint64_t* nextOffset) {
+    auto task = RPCTaskDefine {
+        ListSegmentResponse response;
+        mdsClientBase_.ListSnapshotSegment(filename, userinfo, seq,
+                                           startOffset, limit,
+                                           &response, cntl, channel);
+        if (cntl->Failed()) {
+            // 未升级的mds没有该rpc，返回不支持，由调用方逐个segment查询
+            if (cntl->ErrorCode() == brpc::ENOMETHOD) {
+                LOG(WARNING) << "mds does not support ListSegment"
+                             << ", filename = " << filename
+                             << ", error content:" << cntl->ErrorText();
+                return LIBCURVE_ERROR::NOT_SUPPORT;
+            }
+            LOG(WARNING) << "list snap file segment failed, errcorde = "
+                << cntl->ErrorCode()
+                << ", error content:" << cntl->ErrorText();
+            return -cntl->ErrorCode();
+        }
+
+        LIBCURVE_ERROR retcode;
+        StatusCode stcode = response.statuscode();
+        MDSStatusCode2LibcurveError(stcode, &retcode);
+        if (stcode != StatusCode::kOK) {
+            LOG(WARNING) << "ListSnapshotSegment return error"
+                       << ", filename = " << filename
+                       << ", owner = " << userinfo.owner
+                       << ", seq = " << seq
+                       << ", startOffset = " << startOffset
+                       << ", errocde = " << retcode
+                       << ", error msg = " << StatusCode_Name(stcode);
+            return retcode;
+        }
+
+        segInfos->clear();
+        segInfos->reserve(response.segments_size());
+        for (const auto& packed : response.segments()) {
+            if (packed.chunkid_size() != packed.copysetid_size() ||
+                packed.chunkid_size() == 0) {
+                LOG(WARNING) << "ListSnapshotSegment got invalid segment"
+                             << ", filename = " << filename
+                             << ", startOffset = " << packed.startoffset()
+                             << ", chunk num = " << packed.chunkid_size()
+                             << ", copyset num = " << packed.copysetid_size();
+                return LIBCURVE_ERROR::FAILED;
+            }
+
+            SegmentInfo segInfo;
+            LogicPoolID logicpoolid = packed.logicalpoolid();
+            segInfo.segmentsize = response.segmentsize();
+            segInfo.chunksize = response.chunksize();
+            segInfo.startoffset = packed.startoffset();
+            segInfo.lpcpIDInfo.lpid = logicpoolid;
+            segInfo.lpcpIDInfo.cpidVec.reserve(packed.copysetid_size());
+            segInfo.chunkvec.reserve(packed.chunkid_size());
+            for (int i = 0; i < packed.chunkid_size(); i++) {
+                CopysetID copysetid = packed.copysetid(i);
+                segInfo.lpcpIDInfo.cpidVec.push_back(copysetid);
+                segInfo.chunkvec.emplace_back(packed.chunkid(i), logicpoolid,
+                                              copysetid);
+            }
+            segInfos->emplace_back(std::move(segInfo));
+        }
+        *nextOffset = response.has_nextoffset() ? response.nextoffset() : 0;
+        return LIBCURVE_ERROR::OK;
+    };
+    return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
+}
+
 LIBCURVE_ERROR MDSClient::RefreshSession(const std::string& filename,
                                          const UserInfo_t& userinfo,
                                          const std::string& sessionid,
@@ -1179,6 +1273,17 @@ LIBCURVE_ERROR MDSClient::Listdir(const std::string& dirpath,
         }
         return retcode;
     };
+
+    if (metaServerOpt_.followerReadListDir &&
+        !metaServerOpt_.followerReadAddrs.empty()) {
+        // follower失败或者不支持时再发往leader
+        LIBCURVE_ERROR ret = followerReadExcutor_.DoRPCTask(task,
+            metaServerOpt_.followerReadMaxRetryMS);
+        if (ret != LIBCURVE_ERROR::FAILED &&
+            ret != LIBCURVE_ERROR::NOT_SUPPORT) {
+            return ret;
+        }
+    }
     return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
 }
 
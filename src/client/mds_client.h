@@ -222,6 +222,26 @@ class MDSClient {
                                           uint64_t seq,
                                           uint64_t offset,
                                           SegmentInfo* segInfo);
+
+    /**
+     * 从startOffset开始分页获取快照已分配的segment信息
+     * @param: filename是要快照的文件名
+     * @param: userinfo是用户信息
+     * @param: seq是创建快照时文件的版本信息
+     * @param: startOffset是起始偏移，需按segment对齐
+     * @param: limit是本次最多获取的segment数
+     * @param[out]: segInfos为获取到的segment信息，按offset有序
+     * @param[out]: nextOffset为下一页的起始偏移，没有更多segment时为0
+     * @return: 成功返回LIBCURVE_ERROR::OK,如果认证失败返回LIBCURVE_ERROR::AUTHFAIL，
+     *          否则返回LIBCURVE_ERROR::FAILED
+     */
+    LIBCURVE_ERROR ListSnapshotSegment(const std::string& filename,
+                                       const UserInfo_t& userinfo,
+                                       uint64_t seq,
+                                       uint64_t startOffset,
+                                       uint32_t limit,
+                                       std::vector<SegmentInfo>* segInfos,
+                                       uint64_t* nextOffset);
     /**
      * 获取快照状态
      * @param: filenam文件名
@@ -539,6 +559,9 @@ class MDSClient {
     MDSClientBase mdsClientBase_;
 
     MDSRPCExcutor rpcExcutor;
+
+    // 只读元数据服务的rpc执行器，使用followerReadAddrs作为mds地址
+    MDSRPCExcutor followerReadExcutor_;
 };
 }   // namespace client
 }   // namespace curve
@@ -213,6 +213,32 @@ void MDSClientBase::GetSnapshotSegmentInfo(
     stub.GetSnapShotFileSegment(cntl, &request, response, nullptr);
 }
 
+void MDSClientBase::ListSnapshotSegment(const std::string& filename,
+                                        const UserInfo_t& userinfo,
+                                        uint64_t seq,
+                                        uint64_t startOffset,
+                                        uint32_t limit,
+                                        ListSegmentResponse* response,
+                                        brpc::Controller* cntl,
+                                        brpc::Channel* channel) {
+    ListSegmentRequest request;
+    request.set_filename(filename);
+    request.set_seqnum(seq);
+    request.set_startoffset(startOffset);
+    request.set_limit(limit);
+    FillUserInfo(&request, userinfo);
+
+    LOG(INFO) << "ListSnapshotSegment: filename = " << filename
+                << ", owner = " << userinfo.owner
+                << ", seqnum = " << seq
+                << ", startOffset = " << startOffset
+                << ", limit = " << limit
+                << ", log id = " << cntl->log_id();
+
+    curve::mds::CurveFSService_Stub stub(channel);
+    stub.ListSegment(cntl, &request, response, nullptr);
+}
+
 void MDSClientBase::RefreshSession(const std::string& filename,
                                    const UserInfo_t& userinfo,
                                    const std::string& sessionid,
@@ -78,6 +78,8 @@ using curve::mds::ListSnapShotFileInfoRequest;
 using curve::mds::ListSnapShotFileInfoResponse;
 using curve::mds::GetOrAllocateSegmentRequest;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::ListSegmentRequest;
+using curve::mds::ListSegmentResponse;
 using curve::mds::topology::GetChunkServerListInCopySetsRequest;
 using curve::mds::topology::GetChunkServerListInCopySetsResponse;
 using curve::mds::topology::GetClusterInfoRequest;
@@ -220,6 +222,26 @@ class MDSClientBase {
                                 brpc::Controller* cntl,
                                 brpc::Channel* channel);
 
+    /**
+     * 从startOffset开始分页获取快照的segment信息
+     * @param: filename是要快照的文件名
+     * @param: userinfo是用户信息
+     * @param: seq是创建快照时文件的版本信息
+     * @param: startOffset是起始偏移，需按segment对齐
+     * @param: limit是本次最多获取的segment数
+     * @param[out]: response为该rpc的response，提供给外部处理
+     * @param[in|out]: cntl既是入参，也是出参，返回RPC状态
+     * @param[in]:channel是当前与mds建立的通道
+     */
+    void ListSnapshotSegment(const std::string& filename,
+                             const UserInfo_t& userinfo,
+                             uint64_t seq,
+                             uint64_t startOffset,
+                             uint32_t limit,
+                             ListSegmentResponse* response,
+                             brpc::Controller* cntl,
+                             brpc::Channel* channel);
+
     /**
      * 文件接口在打开文件的时候需要与mds保持心跳，refresh用来续约
      * 续约结果将会通过LeaseRefreshResult* resp返回给调用层
@@ -27,6 +27,7 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "src/client/client_common.h"
 #include "src/client/request_closure.h"
@@ -110,6 +111,10 @@ struct CURVE_CACHELINE_ALIGNMENT RequestContext {
     // create clone chunk时候用于修改chunk的correctedSn
     uint64_t            correctedSeq_ = 0;
 
+    // 批量CreateCloneChunk/RecoverChunk/WriteChunkBulk的chunk，
+    // 同时也是出参，由调用者持有
+    std::vector<CloneChunkBatchItem>* batchItems_ = nullptr;
+
     // 当前request context id
     uint64_t            id_ = 0;
 
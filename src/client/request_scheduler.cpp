@@ -195,6 +195,18 @@ void RequestScheduler::ProcessOne(RequestContext* ctx) {
             client_.RecoverChunk(ctx->idinfo_, ctx->offset_, ctx->rawlength_,
                                  guard.release());
             break;
+        case OpType::CREATE_CLONE_BATCH:
+            client_.CreateCloneChunkBatch(ctx->idinfo_, ctx->batchItems_,
+                                          guard.release());
+            break;
+        case OpType::RECOVER_CHUNK_BATCH:
+            client_.RecoverChunkBatch(ctx->idinfo_, ctx->batchItems_,
+                                      guard.release());
+            break;
+        case OpType::WRITE_BULK:
+            client_.WriteChunkBulk(ctx->idinfo_, ctx->batchItems_,
+                                   ctx->writeData_, guard.release());
+            break;
         default:
             /* TODO(wudemiao) 后期整个链路错误发统一了在处理 */
             ctx->done_->SetFailed(-1);
@@ -36,6 +36,7 @@ namespace client {
 using curve::chunkserver::ChunkRequest;
 using curve::chunkserver::ChunkResponse;
 using curve::chunkserver::ChunkService_Stub;
+using curve::chunkserver::CloneChunkDesc;
 using curve::chunkserver::GetChunkInfoRequest;
 using curve::chunkserver::GetChunkInfoResponse;
 using curve::common::TimeUtility;
@@ -267,6 +268,91 @@ int RequestSender::RecoverChunk(const ChunkIDInfo& idinfo,
     stub.RecoverChunk(cntl, &request, response, doneGuard.release());
 }
 
+int RequestSender::CreateCloneChunkBatch(const ChunkIDInfo& idinfo,
+    ClientClosure *done, const std::vector<CloneChunkBatchItem>& items) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+
+    UpdateRpcRPS(done, OpType::CREATE_CLONE_BATCH);
+    SetRpcStuff(done, cntl, response);
+
+    ChunkRequest request;
+    request.set_optype(
+        curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(items.empty() ? idinfo.cid_ : items.front().cid);
+    for (const auto& item : items) {
+        CloneChunkDesc* desc = request.add_clonechunks();
+        desc->set_chunkid(item.cid);
+        desc->set_location(item.location);
+        desc->set_sn(item.sn);
+        desc->set_correctedsn(item.correctedSn);
+        desc->set_size(item.chunkSize);
+    }
+
+    ChunkService_Stub stub(&channel_);
+    stub.CreateCloneChunkBatch(cntl, &request, response, doneGuard.release());
+    return 0;
+}
+
+int RequestSender::RecoverChunkBatch(const ChunkIDInfo& idinfo,
+    ClientClosure *done, const std::vector<CloneChunkBatchItem>& items) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+
+    UpdateRpcRPS(done, OpType::RECOVER_CHUNK_BATCH);
+    SetRpcStuff(done, cntl, response);
+
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_RECOVER);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(items.empty() ? idinfo.cid_ : items.front().cid);
+    for (const auto& item : items) {
+        CloneChunkDesc* desc = request.add_clonechunks();
+        desc->set_chunkid(item.cid);
+        desc->set_offset(item.offset);
+        desc->set_size(item.len);
+    }
+
+    ChunkService_Stub stub(&channel_);
+    stub.RecoverChunkBatch(cntl, &request, response, doneGuard.release());
+    return 0;
+}
+
+int RequestSender::WriteChunkBulk(const ChunkIDInfo& idinfo,
+    ClientClosure *done, const std::vector<CloneChunkBatchItem>& items,
+    const butil::IOBuf& data) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+
+    UpdateRpcRPS(done, OpType::WRITE_BULK);
+    SetRpcStuff(done, cntl, response);
+
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(items.empty() ? idinfo.cid_ : items.front().cid);
+    request.set_size(data.size());
+    for (const auto& item : items) {
+        CloneChunkDesc* desc = request.add_clonechunks();
+        desc->set_chunkid(item.cid);
+        desc->set_sn(item.sn);
+        desc->set_offset(item.offset);
+        desc->set_size(item.len);
+    }
+    cntl->request_attachment().append(data);
+
+    ChunkService_Stub stub(&channel_);
+    stub.WriteChunkBulk(cntl, &request, response, doneGuard.release());
+    return 0;
+}
+
 int RequestSender::ResetSender(ChunkServerID chunkServerId,
                                butil::EndPoint serverEndPoint) {
     chunkServerId_ = chunkServerId;
@@ -28,6 +28,7 @@
 #include <butil/iobuf.h>
 
 #include <string>
+#include <vector>
 
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
@@ -159,6 +160,44 @@ class RequestSender {
     */
     int RecoverChunk(const ChunkIDInfo& idinfo,
                      ClientClosure* done, uint64_t offset, uint64_t len);
+
+    /**
+    * @brief 批量lazy创建同一个copyset上的clone chunk
+    * @param idinfo为copyset的id信息
+    * @param done:上一层异步回调的closure
+    * @param items 待创建的chunk
+    *
+    * @return 错误码
+    */
+    int CreateCloneChunkBatch(const ChunkIDInfo& idinfo,
+                              ClientClosure *done,
+                              const std::vector<CloneChunkBatchItem>& items);
+
+   /**
+    * @brief 批量恢复同一个copyset上的chunk数据
+    * @param idinfo为copyset的id信息
+    * @param done:上一层异步回调的closure
+    * @param items 待恢复的chunk范围
+    *
+    * @return 错误码
+    */
+    int RecoverChunkBatch(const ChunkIDInfo& idinfo,
+                          ClientClosure *done,
+                          const std::vector<CloneChunkBatchItem>& items);
+
+   /**
+    * @brief 批量写入同一个copyset上的多个chunk
+    * @param idinfo为copyset的id信息
+    * @param done:上一层异步回调的closure
+    * @param items 写入的chunk范围
+    * @param data 各范围的数据，按items的顺序依次存放
+    *
+    * @return 错误码
+    */
+    int WriteChunkBulk(const ChunkIDInfo& idinfo,
+                       ClientClosure *done,
+                       const std::vector<CloneChunkBatchItem>& items,
+                       const butil::IOBuf& data);
     /**
      * 重置和Chunk Server的链接
      * @param chunkServerId:Chunk Server唯一标识
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/common/chunk_codec.h"
+
+#include <butil/third_party/snappy/snappy.h>
+#include <glog/logging.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+const char kChunkMagic[] = "CURVECE1";
+const uint32_t kMagicLen = 8;
+const uint32_t kSplitEntryLen = 9;
+
+void PutFixed32(char *buf, uint32_t value) {
+    buf[0] = value & 0xff;
+    buf[1] = (value >> 8) & 0xff;
+    buf[2] = (value >> 16) & 0xff;
+    buf[3] = (value >> 24) & 0xff;
+}
+
+uint32_t GetFixed32(const char *buf) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(buf);
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+}  // namespace
+
+uint64_t EncodedChunkHeader::GetHeaderSize(uint32_t splitNum) {
+    return kMagicLen + sizeof(uint32_t) +
+           static_cast<uint64_t>(splitNum) * kSplitEntryLen +
+           sizeof(uint32_t);
+}
+
+void EncodedChunkHeader::Encode(std::string *data) const {
+    data->assign(GetHeaderSize(), '\0');
+    char *p = &(*data)[0];
+    memcpy(p, kChunkMagic, kMagicLen);
+    p += kMagicLen;
+    PutFixed32(p, splits_.size());
+    p += sizeof(uint32_t);
+    for (const auto &split : splits_) {
+        p[0] = static_cast<char>(split.type);
+        PutFixed32(p + 1, split.rawLen);
+        PutFixed32(p + 5, split.storedLen);
+        p += kSplitEntryLen;
+    }
+    PutFixed32(p, CRC32(data->data(), p - data->data()));
+}
+
+bool EncodedChunkHeader::Decode(const char *buf, uint64_t len) {
+    if (len < GetHeaderSize(0) || memcmp(buf, kChunkMagic, kMagicLen) != 0) {
+        return false;
+    }
+    uint32_t splitNum = GetFixed32(buf + kMagicLen);
+    uint64_t headerSize = GetHeaderSize(splitNum);
+    if (headerSize > kMaxEncodedChunkHeaderSize || headerSize > len) {
+        return false;
+    }
+    uint64_t crcOffset = headerSize - sizeof(uint32_t);
+    if (CRC32(buf, crcOffset) != GetFixed32(buf + crcOffset)) {
+        return false;
+    }
+
+    std::vector<EncodedSplit> splits;
+    const char *p = buf + kMagicLen + sizeof(uint32_t);
+    for (uint32_t i = 0; i < splitNum; ++i, p += kSplitEntryLen) {
+        EncodedSplit split;
+        split.type = static_cast<SplitEncodeType>(p[0]);
+        split.rawLen = GetFixed32(p + 1);
+        split.storedLen = GetFixed32(p + 5);
+        bool valid = (split.type == SplitEncodeType::kZero &&
+                      split.storedLen == 0) ||
+                     (split.type == SplitEncodeType::kRaw &&
+                      split.storedLen == split.rawLen) ||
+                     split.type == SplitEncodeType::kSnappy;
+        if (!valid) {
+            return false;
+        }
+        splits.push_back(split);
+    }
+    splits_.swap(splits);
+    return true;
+}
+
+uint64_t EncodedChunkHeader::GetRawOffset(uint32_t index) const {
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < index && i < splits_.size(); ++i) {
+        offset += splits_[i].rawLen;
+    }
+    return offset;
+}
+
+uint64_t EncodedChunkHeader::GetStoredOffset(uint32_t index) const {
+    uint64_t offset = GetHeaderSize();
+    for (uint32_t i = 0; i < index && i < splits_.size(); ++i) {
+        offset += splits_[i].storedLen;
+    }
+    return offset;
+}
+
+uint64_t EncodedChunkHeader::GetRawSize() const {
+    return GetRawOffset(splits_.size());
+}
+
+bool ChunkCodec::IsZero(const char *buf, uint64_t len) {
+    // 按8字节比较，便于编译器向量化
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, buf + i, sizeof(uint64_t));
+        if (word != 0) {
+            return false;
+        }
+    }
+    for (; i < len; ++i) {
+        if (buf[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+EncodedSplit ChunkCodec::EncodeSplit(const char *buf, uint32_t len,
+                                     std::string *out) {
+    EncodedSplit split;
+    split.rawLen = len;
+    if (IsZero(buf, len)) {
+        split.type = SplitEncodeType::kZero;
+        split.storedLen = 0;
+        return split;
+    }
+    butil::snappy::Compress(buf, len, out);
+    // 压缩节省不足1/8时原样存储，省去读取时的解压
+    if (out->size() < len - len / 8) {
+        split.type = SplitEncodeType::kSnappy;
+        split.storedLen = out->size();
+    } else {
+        out->clear();
+        split.type = SplitEncodeType::kRaw;
+        split.storedLen = len;
+    }
+    return split;
+}
+
+bool ChunkCodec::Uncompress(const char *in, uint64_t inLen,
+                            char *out, uint64_t outLen) {
+    size_t rawLen = 0;
+    if (!butil::snappy::GetUncompressedLength(in, inLen, &rawLen) ||
+        rawLen != outLen) {
+        return false;
+    }
+    return butil::snappy::RawUncompress(in, inLen, out);
+}
+
+bool ChunkCodec::EncodeChunk(const std::string &data, uint32_t splitSize,
+                             std::string *out) {
+    if (splitSize == 0) {
+        return false;
+    }
+    uint32_t splitNum = (data.size() + splitSize - 1) / splitSize;
+    if (EncodedChunkHeader::GetHeaderSize(splitNum) >
+        kMaxEncodedChunkHeaderSize) {
+        return false;
+    }
+    EncodedChunkHeader header;
+    std::string body;
+    for (uint64_t offset = 0; offset < data.size(); offset += splitSize) {
+        uint32_t len = std::min<uint64_t>(splitSize, data.size() - offset);
+        std::string compressed;
+        EncodedSplit split =
+            EncodeSplit(data.data() + offset, len, &compressed);
+        if (split.type == SplitEncodeType::kSnappy) {
+            body.append(compressed);
+        } else if (split.type == SplitEncodeType::kRaw) {
+            body.append(data, offset, len);
+        }
+        header.AddSplit(split);
+    }
+    header.Encode(out);
+    out->append(body);
+    return true;
+}
+
+bool ChunkCodec::DecodeChunk(std::string *data) {
+    EncodedChunkHeader header;
+    if (!header.Decode(data->data(), data->size())) {
+        return true;
+    }
+    const auto &splits = header.GetSplits();
+    if (header.GetStoredOffset(splits.size()) != data->size()) {
+        LOG(ERROR) << "Encoded chunk size mismatch, header = "
+                   << header.GetStoredOffset(splits.size())
+                   << ", object size = " << data->size();
+        return false;
+    }
+
+    std::string raw(header.GetRawSize(), '\0');
+    const char *stored = data->data() + header.GetHeaderSize();
+    char *dst = &raw[0];
+    for (const auto &split : splits) {
+        if (split.type == SplitEncodeType::kRaw) {
+            memcpy(dst, stored, split.rawLen);
+        } else if (split.type == SplitEncodeType::kSnappy &&
+                   !Uncompress(stored, split.storedLen, dst, split.rawLen)) {
+            LOG(ERROR) << "Uncompress chunk split failed.";
+            return false;
+        }
+        stored += split.storedLen;
+        dst += split.rawLen;
+    }
+    data->swap(raw);
+    return true;
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_COMMON_CHUNK_CODEC_H_
+#define SRC_COMMON_CHUNK_CODEC_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace curve {
+namespace common {
+
+/**
+ * 快照chunk数据对象的编码格式
+ * 对象 = 头部 + 各非全零分片的存储数据(按分片顺序)
+ * 头部 = magic(8) + 分片数(4) + 分片数 * [类型(1) + 原始长度(4) + 存储长度(4)]
+ *      + crc32(4)，整数均为小端
+ * 全零分片不占用存储空间，未编码的对象即原始数据，读取时根据头部区分
+ */
+enum class SplitEncodeType : uint8_t {
+    // 全零分片，不存储数据
+    kZero = 0,
+    // 原样存储
+    kRaw = 1,
+    // snappy压缩存储
+    kSnappy = 2,
+};
+
+struct EncodedSplit {
+    SplitEncodeType type;
+    // 分片原始数据长度
+    uint32_t rawLen;
+    // 分片在对象中存储的数据长度
+    uint32_t storedLen;
+};
+
+class EncodedChunkHeader {
+ public:
+    EncodedChunkHeader() = default;
+
+    void AddSplit(const EncodedSplit &split) {
+        splits_.push_back(split);
+    }
+
+    const std::vector<EncodedSplit>& GetSplits() const {
+        return splits_;
+    }
+
+    /**
+     * 头部编码后的长度
+     */
+    uint64_t GetHeaderSize() const {
+        return GetHeaderSize(splits_.size());
+    }
+
+    static uint64_t GetHeaderSize(uint32_t splitNum);
+
+    /**
+     * 编码头部
+     * @param[out] data 编码后的头部
+     */
+    void Encode(std::string *data) const;
+
+    /**
+     * 从对象的前缀解析头部
+     * @param buf 对象起始的数据
+     * @param len 数据长度，不小于头部长度时才能解析成功
+     * @return: true 对象已编码且头部完整/ false 对象未编码或头部不完整
+     */
+    bool Decode(const char *buf, uint64_t len);
+
+    /**
+     * 获取分片原始数据在chunk中的偏移，以及存储数据在对象中的偏移
+     */
+    uint64_t GetRawOffset(uint32_t index) const;
+    uint64_t GetStoredOffset(uint32_t index) const;
+
+    /**
+     * chunk原始数据长度
+     */
+    uint64_t GetRawSize() const;
+
+ private:
+    std::vector<EncodedSplit> splits_;
+};
+
+// 头部的最大长度，读取时预读该长度的对象前缀用于解析头部
+const uint32_t kMaxEncodedChunkHeaderSize = 4096;
+
+class ChunkCodec {
+ public:
+    /**
+     * 判断数据是否全零
+     */
+    static bool IsZero(const char *buf, uint64_t len);
+
+    /**
+     * 编码一个分片，全零的分片不产生数据，压缩收益不足时原样存储
+     * @param buf 分片数据
+     * @param len 分片长度
+     * @param[out] out 压缩后的数据，仅kSnappy时有效
+     * @return: 分片的编码信息
+     */
+    static EncodedSplit EncodeSplit(const char *buf, uint32_t len,
+                                    std::string *out);
+
+    /**
+     * 解压一个kSnappy分片
+     * @param in 存储数据
+     * @param inLen 存储数据长度
+     * @param[out] out 原始数据，长度为outLen
+     * @return: true 成功/ false 数据损坏或长度不符
+     */
+    static bool Uncompress(const char *in, uint64_t inLen,
+                           char *out, uint64_t outLen);
+
+    /**
+     * 按分片编码整个chunk
+     * @param data chunk原始数据
+     * @param splitSize 分片大小
+     * @param[out] out 编码后的对象数据
+     * @return: true 成功/ false 分片大小为0或分片过多头部超过最大长度
+     */
+    static bool EncodeChunk(const std::string &data, uint32_t splitSize,
+                            std::string *out);
+
+    /**
+     * 解码整个对象，未编码的对象原样返回
+     * @param[in,out] data 对象数据，解码后为chunk原始数据
+     * @return: true 成功/ false 数据损坏
+     */
+    static bool DecodeChunk(std::string *data);
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CHUNK_CODEC_H_
@@ -119,6 +119,22 @@ class TaskThreadPool : public Uncopyable {
         notEmpty_.notify_one();
     }
 
+    /**
+     * 与 Enqueue 相同，但队列满时不阻塞，直接返回 false
+     * @return task 是否 push 成功
+     */
+    template <class F, class... Args>
+    bool TryEnqueue(F&& f, Args&&... args) {
+        std::unique_lock<MutexT> guard(mutex_);
+        if (IsFullUnlock()) {
+            return false;
+        }
+        auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        queue_.push_back(std::move(task));
+        notEmpty_.notify_one();
+        return true;
+    }
+
     /* 返回线程池 queue 的容量 */
     int QueueCapacity() const {
         return capacity_;
@@ -32,6 +32,13 @@ std::string LocationOperator::GenerateS3Location(
     return location;
 }
 
+std::string LocationOperator::GenerateLocalLocation(
+    const std::string& objectName) {
+    std::string location(objectName);
+    location.append(kOriginTypeSeprator).append(LOCAL_TYPE);
+    return location;
+}
+
 std::string LocationOperator::GenerateCurveLocation(
     const std::string& fileName, off_t offset) {
     std::string location(fileName);
@@ -62,6 +69,8 @@ OriginType LocationOperator::ParseLocation(
         type = OriginType::CurveOrigin;
     } else if (typeStr.compare(S3_TYPE) == 0) {
         type = OriginType::S3Origin;
+    } else if (typeStr.compare(LOCAL_TYPE) == 0) {
+        type = OriginType::LocalOrigin;
     }
 
     return type;
@@ -31,6 +31,7 @@ namespace common {
 
 const char CURVE_TYPE[] = "cs";
 const char S3_TYPE[] = "s3";
+const char LOCAL_TYPE[] = "local";
 const char kOriginTypeSeprator[] = "@";
 const char kOriginPathSeprator[] = ":";
 
@@ -38,6 +39,7 @@ enum class OriginType {
     S3Origin = 0,
     CurveOrigin = 1,
     InvalidOrigin = 2,
+    LocalOrigin = 3,
 };
 
 class LocationOperator {
@@ -49,6 +51,13 @@ class LocationOperator {
      * @return:生成的location
      */
     static std::string GenerateS3Location(const std::string& objectName);
+    /**
+     * 生成本地目录快照存储的location
+     * location格式:${objectname}@local
+     * @param objectName:快照数据对象的名称，即相对于快照目录的路径
+     * @return:生成的location
+     */
+    static std::string GenerateLocalLocation(const std::string& objectName);
     /**
      * 生成curve的location
      * location格式:${filename}:${offset}@cs
@@ -60,10 +69,11 @@ class LocationOperator {
      * location格式:
      * s3示例：${objectname}@s3
      * curve示例：${filename}:${offset}@cs
+     * 本地目录示例：${objectname}@local
      *
      * @param location[in]:数据源的位置，其格式为originPath@originType
      * @param originPath[out]:表示数据源在源端的路径
-     * @return:返回OriginType，表示源数据的源端类型是s3还是curve
+     * @return:返回OriginType，表示源数据的源端类型是s3、curve还是本地目录
      *         如果路径格式不正确或者originType无法识别，则返回InvalidOrigin
      */
     static OriginType ParseLocation(const std::string& location,
@@ -21,14 +21,56 @@
  ************************************************************************/
 #include "src/common/s3_adapter.h"
 #include <glog/logging.h>
+#include <bvar/bvar.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
 #include "src/common/curve_define.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace common {
 
+namespace {
+// 进程内所有S3Adapter共用的指标
+struct S3AdapterMetric {
+    S3AdapterMetric()
+        : getLatency("s3_adapter_get"),
+          putLatency("s3_adapter_put"),
+          getBytes("s3_adapter_get_bytes"),
+          putBytes("s3_adapter_put_bytes"),
+          getBps("s3_adapter_get_bps", &getBytes),
+          putBps("s3_adapter_put_bps", &putBytes),
+          getCoalesced("s3_adapter_get_coalesced"),
+          asyncPending("s3_adapter_async_pending") {}
+
+    // 读写请求的延时(us)和qps，写请求包括分片上传
+    bvar::LatencyRecorder getLatency;
+    bvar::LatencyRecorder putLatency;
+    // 读写的数据量及带宽
+    bvar::Adder<uint64_t> getBytes;
+    bvar::Adder<uint64_t> putBytes;
+    bvar::PerSecond<bvar::Adder<uint64_t>> getBps;
+    bvar::PerSecond<bvar::Adder<uint64_t>> putBps;
+    // 被合并到其他请求中发送的读请求数
+    bvar::Adder<uint64_t> getCoalesced;
+    // 因窗口已满而排队的异步请求数
+    bvar::Adder<int64_t> asyncPending;
+};
+
+S3AdapterMetric *GetS3AdapterMetric() {
+    static S3AdapterMetric metric;
+    return &metric;
+}
+
+std::string GetRangeString(off_t offset, size_t len) {
+    return "bytes=" + std::to_string(offset) + "-" +
+           std::to_string(offset + len - 1);
+}
+}  // namespace
+
 void S3Adapter::Init(const std::string &path) {
     LOG(INFO) << "Loading s3 configurations";
     conf_.SetConfigPath(path);
@@ -92,6 +134,19 @@ void S3Adapter::Init(const std::string &path) {
 
     throttle_ = new Throttle();
     throttle_->UpdateThrottleParams(params);
+
+    uint32_t maxAsyncInflight = 0;
+    uint64_t maxCoalesceBytes = 0;
+    conf_.GetUInt32Value("s3.max_async_request_inflight", &maxAsyncInflight);
+    conf_.GetUInt64Value("s3.max_coalesce_bytes", &maxCoalesceBytes);
+    SetAsyncRequestWindow(maxAsyncInflight, maxCoalesceBytes);
+}
+
+void S3Adapter::SetAsyncRequestWindow(uint32_t maxInflight,
+                                      uint64_t maxCoalesceBytes) {
+    LockGuard guard(asyncMtx_);
+    maxAsyncInflight_ = maxInflight;
+    maxCoalesceBytes_ = maxCoalesceBytes;
 }
 
 void S3Adapter::Deinit() {
@@ -194,8 +249,12 @@ int S3Adapter::PutObject(const Aws::String &key,
         throttle_->Add(false, data.size());
     }
 
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     auto response = s3Client_->PutObject(request);
     if (response.IsSuccess()) {
+        GetS3AdapterMetric()->putLatency <<
+            TimeUtility::GetTimeofDayUs() - startUs;
+        GetS3AdapterMetric()->putBytes << data.size();
         return 0;
     } else {
         LOG(ERROR) << "PutObject error:"
@@ -268,9 +327,13 @@ int S3Adapter::GetObject(const std::string &key,
     if (throttle_) {
         throttle_->Add(true, len);
     }
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     auto response = s3Client_->GetObject(request);
     if (response.IsSuccess()) {
         response.GetResult().GetBody().rdbuf()->sgetn(buf, len);
+        GetS3AdapterMetric()->getLatency <<
+            TimeUtility::GetTimeofDayUs() - startUs;
+        GetS3AdapterMetric()->getBytes << len;
         return 0;
     } else {
         LOG(ERROR) << "GetObject error: "
@@ -281,39 +344,285 @@ int S3Adapter::GetObject(const std::string &key,
 }
 
 void S3Adapter::GetObjectAsync(std::shared_ptr<GetObjectAsyncContext> context) {
+    if (throttle_) {
+        throttle_->Add(true, context->len);
+    }
+    AsyncRequest request;
+    request.getContext = context;
+    SubmitAsyncRequest(request);
+}
+
+void S3Adapter::PutObjectAsync(std::shared_ptr<PutObjectAsyncContext> context) {
+    if (throttle_) {
+        throttle_->Add(false, context->bufferSize);
+    }
+    AsyncRequest asyncRequest;
+    asyncRequest.issue = [this, context]() {
+        Aws::S3::Model::PutObjectRequest request;
+        request.SetBucket(bucketName_);
+        request.SetKey(context->key.c_str());
+        std::shared_ptr<Aws::IOStream> input_data =
+            Aws::MakeShared<Aws::StringStream>("stream");
+        input_data->write(context->buffer, context->bufferSize);
+        request.SetBody(input_data);
+
+        uint64_t startUs = TimeUtility::GetTimeofDayUs();
+        Aws::S3::PutObjectResponseReceivedHandler handler =
+            [this, context, startUs] (
+            const Aws::S3::S3Client* client,
+            const Aws::S3::Model::PutObjectRequest& request,
+            const Aws::S3::Model::PutObjectOutcome& response,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+            if (response.IsSuccess()) {
+                GetS3AdapterMetric()->putLatency <<
+                    TimeUtility::GetTimeofDayUs() - startUs;
+                GetS3AdapterMetric()->putBytes << context->bufferSize;
+                context->retCode = 0;
+            } else {
+                LOG(ERROR) << "PutObjectAsync error: "
+                        << context->key
+                        << "--"
+                        << response.GetError().GetExceptionName()
+                        << response.GetError().GetMessage();
+                context->retCode = -1;
+            }
+            context->cb(this, context);
+            OnAsyncRequestDone();
+        };
+        s3Client_->PutObjectAsync(request, handler, context);
+    };
+    SubmitAsyncRequest(asyncRequest);
+}
+
+void S3Adapter::UploadOnePartAsync(
+    std::shared_ptr<UploadPartAsyncContext> context) {
+    if (throttle_) {
+        throttle_->Add(false, context->partSize);
+    }
+    AsyncRequest asyncRequest;
+    asyncRequest.issue = [this, context]() {
+        Aws::S3::Model::UploadPartRequest request;
+        request.SetBucket(bucketName_);
+        request.SetKey(context->key.c_str());
+        request.SetUploadId(context->uploadId.c_str());
+        request.SetPartNumber(context->partNum);
+        request.SetContentLength(context->partSize);
+        auto input_data =
+            Aws::MakeShared<Aws::StringStream>("UploadPartStream");
+        input_data->write(context->buf, context->partSize);
+        request.SetBody(input_data);
+
+        uint64_t startUs = TimeUtility::GetTimeofDayUs();
+        Aws::S3::UploadPartResponseReceivedHandler handler =
+            [this, context, startUs] (
+            const Aws::S3::S3Client* client,
+            const Aws::S3::Model::UploadPartRequest& request,
+            const Aws::S3::Model::UploadPartOutcome& response,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+            if (response.IsSuccess()) {
+                GetS3AdapterMetric()->putLatency <<
+                    TimeUtility::GetTimeofDayUs() - startUs;
+                GetS3AdapterMetric()->putBytes << context->partSize;
+                context->completedPart = Aws::S3::Model::CompletedPart()
+                    .WithETag(response.GetResult().GetETag())
+                    .WithPartNumber(context->partNum);
+                context->retCode = 0;
+            } else {
+                LOG(ERROR) << "UploadOnePartAsync error: "
+                        << context->key
+                        << "--"
+                        << context->partNum
+                        << "--"
+                        << response.GetError().GetExceptionName()
+                        << response.GetError().GetMessage();
+                context->completedPart = Aws::S3::Model::CompletedPart()
+                    .WithETag("errorTag").WithPartNumber(-1);
+                context->retCode = -1;
+            }
+            context->cb(this, context);
+            OnAsyncRequestDone();
+        };
+        s3Client_->UploadPartAsync(request, handler, context);
+    };
+    SubmitAsyncRequest(asyncRequest);
+}
+
+void S3Adapter::SubmitAsyncRequest(const AsyncRequest &request) {
+    {
+        LockGuard guard(asyncMtx_);
+        if (maxAsyncInflight_ > 0 && inflightNum_ >= maxAsyncInflight_) {
+            pendingRequests_.push_back(request);
+            GetS3AdapterMetric()->asyncPending << 1;
+            return;
+        }
+        inflightNum_++;
+    }
+    if (request.getContext != nullptr) {
+        IssueGets({request.getContext});
+    } else {
+        request.issue();
+    }
+}
+
+void S3Adapter::OnAsyncRequestDone() {
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> gets;
+    AsyncRequest request;
+    {
+        LockGuard guard(asyncMtx_);
+        if (pendingRequests_.empty()) {
+            inflightNum_--;
+            return;
+        }
+        // 窗口中的位置直接交给排队的请求
+        PopPendingRequest(&gets, &request);
+    }
+    if (!gets.empty()) {
+        IssueGets(gets);
+    } else {
+        request.issue();
+    }
+}
+
+void S3Adapter::PopPendingRequest(
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> *gets,
+    AsyncRequest *request) {
+    *request = pendingRequests_.front();
+    pendingRequests_.pop_front();
+    GetS3AdapterMetric()->asyncPending << -1;
+    if (request->getContext == nullptr) {
+        return;
+    }
+
+    auto first = request->getContext;
+    gets->push_back(first);
+    if (0 == maxCoalesceBytes_) {
+        return;
+    }
+    // 从队列中找出与已合并的范围相邻或重叠的同一对象的读请求，
+    // 直到没有可以合并的请求或者达到合并长度上限
+    off_t start = first->offset;
+    off_t end = first->offset + first->len;
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = pendingRequests_.begin();
+             it != pendingRequests_.end(); ++it) {
+            auto ctx = it->getContext;
+            if (ctx == nullptr || ctx->key != first->key ||
+                ctx->etag != first->etag) {
+                continue;
+            }
+            off_t ctxEnd = ctx->offset + ctx->len;
+            if (ctx->offset > end || ctxEnd < start) {
+                continue;
+            }
+            off_t newStart = std::min(start, ctx->offset);
+            off_t newEnd = std::max(end, ctxEnd);
+            if (static_cast<uint64_t>(newEnd - newStart) > maxCoalesceBytes_) {
+                continue;
+            }
+            start = newStart;
+            end = newEnd;
+            gets->push_back(ctx);
+            pendingRequests_.erase(it);
+            GetS3AdapterMetric()->asyncPending << -1;
+            GetS3AdapterMetric()->getCoalesced << 1;
+            merged = true;
+            break;
+        }
+    }
+    std::sort(gets->begin(), gets->end(),
+        [](const std::shared_ptr<GetObjectAsyncContext> &a,
+           const std::shared_ptr<GetObjectAsyncContext> &b) {
+            return a->offset < b->offset;
+        });
+}
+
+void S3Adapter::IssueGets(
+    const std::vector<std::shared_ptr<GetObjectAsyncContext>> &gets) {
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    if (gets.size() == 1) {
+        auto ctx = gets[0];
+        IssueGetObjectAsync(ctx->key, ctx->offset, ctx->len, ctx->buf,
+            ctx->etag, [this, ctx, startUs](int ret, const std::string &etag) {
+                if (0 == ret) {
+                    GetS3AdapterMetric()->getLatency <<
+                        TimeUtility::GetTimeofDayUs() - startUs;
+                    GetS3AdapterMetric()->getBytes << ctx->len;
+                    ctx->etag = etag;
+                }
+                ctx->retCode = ret;
+                ctx->cb(this, ctx);
+                OnAsyncRequestDone();
+            });
+        return;
+    }
+
+    // 合并的读请求先读到临时缓冲区，再拷贝给各个请求
+    off_t start = gets[0]->offset;
+    off_t end = start;
+    for (const auto &ctx : gets) {
+        end = std::max<off_t>(end, ctx->offset + ctx->len);
+    }
+    size_t len = end - start;
+    std::shared_ptr<char> buf(new char[len], std::default_delete<char[]>());
+    IssueGetObjectAsync(gets[0]->key, start, len, buf.get(), gets[0]->etag,
+        [this, gets, buf, start, len, startUs](int ret,
+                                               const std::string &etag) {
+            if (0 == ret) {
+                GetS3AdapterMetric()->getLatency <<
+                    TimeUtility::GetTimeofDayUs() - startUs;
+                GetS3AdapterMetric()->getBytes << len;
+            }
+            for (const auto &ctx : gets) {
+                if (0 == ret) {
+                    memcpy(ctx->buf, buf.get() + (ctx->offset - start),
+                           ctx->len);
+                    ctx->etag = etag;
+                }
+                ctx->retCode = ret;
+                ctx->cb(this, ctx);
+            }
+            OnAsyncRequestDone();
+        });
+}
+
+void S3Adapter::IssueGetObjectAsync(const std::string &key,
+                                    off_t offset,
+                                    size_t len,
+                                    char *buf,
+                                    const std::string &etag,
+                                    std::function<void(int,
+                                        const std::string &)> done) {
     Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(bucketName_);
-    request.SetKey(context->key.c_str());
-    request.SetRange(("bytes=" + std::to_string(context->offset) + "-" + std::to_string(context->offset + context->len)).c_str()); //NOLINT
+    request.SetKey(key.c_str());
+    request.SetRange(GetRangeString(offset, len).c_str());
+    if (!etag.empty()) {
+        request.SetIfMatch(etag.c_str());
+    }
 
-    Aws::S3::GetObjectResponseReceivedHandler handler = [this] (
+    Aws::S3::GetObjectResponseReceivedHandler handler =
+        [buf, len, done] (
         const Aws::S3::S3Client* client,
         const Aws::S3::Model::GetObjectRequest& request,
         const Aws::S3::Model::GetObjectOutcome& response,
-        const std::shared_ptr<const Aws::Client::AsyncCallerContext>& awsCtx) {
-        std::shared_ptr<const GetObjectAsyncContext> cctx =
-            std::dynamic_pointer_cast<const GetObjectAsyncContext>(awsCtx);
-        std::shared_ptr<GetObjectAsyncContext> ctx =
-            std::const_pointer_cast<GetObjectAsyncContext>(cctx);
+        const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
         if (response.IsSuccess()) {
             const Aws::S3::Model::GetObjectResult &result =
                 response.GetResult();
             Aws::S3::Model::GetObjectResult &ret =
                 const_cast<Aws::S3::Model::GetObjectResult&>(result);
-            ret.GetBody().rdbuf()->sgetn(ctx->buf, ctx->len);  // NOLINT
-            ctx->retCode = 0;
+            ret.GetBody().rdbuf()->sgetn(buf, len);  // NOLINT
+            done(0, std::string(result.GetETag().c_str()));
         } else {
             LOG(ERROR) << "GetObjectAsync error: "
                     << response.GetError().GetExceptionName()
                     << response.GetError().GetMessage();
-            ctx->retCode = -1;
+            done(-1, "");
         }
-        ctx->cb(this, ctx);
     };
-    if (throttle_) {
-        throttle_->Add(true, context->len);
-    }
-    s3Client_->GetObjectAsync(request, handler, context);
+    s3Client_->GetObjectAsync(request, handler, nullptr);
 }
 
 bool S3Adapter::ObjectExist(const Aws::String &key) {
@@ -427,8 +736,12 @@ Aws::S3::Model::CompletedPart S3Adapter:: UploadOnePart(
     if (throttle_) {
         throttle_->Add(false, partSize);
     }
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     auto result = s3Client_->UploadPart(request);
     if (result.IsSuccess()) {
+        GetS3AdapterMetric()->putLatency <<
+            TimeUtility::GetTimeofDayUs() - startUs;
+        GetS3AdapterMetric()->putBytes << partSize;
         return Aws::S3::Model::CompletedPart()
             .WithETag(result.GetResult().GetETag()).WithPartNumber(partNum);
     } else {
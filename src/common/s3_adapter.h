@@ -23,8 +23,11 @@
 #ifndef SRC_COMMON_S3_ADAPTER_H_
 #define SRC_COMMON_S3_ADAPTER_H_
 #include <map>
+#include <list>
 #include <string>
 #include <memory>
+#include <vector>
+#include <functional>
 #include <aws/core/utils/memory/AWSMemory.h>  //NOLINT
 #include <aws/core/Aws.h>   //NOLINT
 #include <aws/s3/S3Client.h>  //NOLINT
@@ -51,6 +54,7 @@
 #include <aws/core/utils/threading/Executor.h> // NOLINT
 #include "src/common/configuration.h"
 #include "src/common/throttle.h"
+#include "src/common/concurrent/concurrent.h"
 
 namespace curve {
 namespace common {
@@ -69,6 +73,41 @@ struct GetObjectAsyncContext : public Aws::Client::AsyncCallerContext {
     size_t len;
     GetObjectAsyncCallBack cb;
     int retCode;
+    // 非空时只在对象的ETag与之相同时读取，成功后为读到的对象的ETag
+    std::string etag;
+};
+
+struct PutObjectAsyncContext;
+typedef std::function<void(const S3Adapter*,
+    const std::shared_ptr<PutObjectAsyncContext>&)>
+        PutObjectAsyncCallBack;
+
+struct PutObjectAsyncContext : public Aws::Client::AsyncCallerContext {
+    std::string key;
+    // 回调之前需保证数据有效
+    const char *buffer;
+    size_t bufferSize;
+    PutObjectAsyncCallBack cb;
+    int retCode;
+};
+
+struct UploadPartAsyncContext;
+typedef std::function<void(const S3Adapter*,
+    const std::shared_ptr<UploadPartAsyncContext>&)>
+        UploadPartAsyncCallBack;
+
+struct UploadPartAsyncContext : public Aws::Client::AsyncCallerContext {
+    std::string key;
+    std::string uploadId;
+    // 第几个分片（从1开始）
+    int partNum;
+    // 回调之前需保证数据有效
+    const char *buf;
+    size_t partSize;
+    UploadPartAsyncCallBack cb;
+    int retCode;
+    // 上传成功后用于CompleteMultiUpload的分片信息
+    Aws::S3::Model::CompletedPart completedPart;
 };
 
 class S3Adapter {
@@ -138,6 +177,31 @@ class S3Adapter {
      */
     virtual void GetObjectAsync(std::shared_ptr<GetObjectAsyncContext> context);
 
+    /**
+     * @brief 异步上传数据到对象存储
+     *
+     * @param context 异步上下文
+     */
+    virtual void PutObjectAsync(std::shared_ptr<PutObjectAsyncContext> context);
+
+    /**
+     * @brief 异步上传分片上传任务中的一个分片
+     *
+     * @param context 异步上下文
+     */
+    virtual void UploadOnePartAsync(
+        std::shared_ptr<UploadPartAsyncContext> context);
+
+    /**
+     * @brief 设置异步请求窗口，超过上限的请求排队等待，
+     *        排队中同一对象相邻或重叠的读请求合并为一个请求发送
+     *
+     * @param maxInflight 同时进行的异步请求数上限，0表示不限制
+     * @param maxCoalesceBytes 合并后读请求的最大长度，0表示不合并
+     */
+    void SetAsyncRequestWindow(uint32_t maxInflight,
+                               uint64_t maxCoalesceBytes);
+
     /**
      * 删除对象
      * @param 对象名
@@ -204,6 +268,60 @@ class S3Adapter {
         return bucketName_;
     }
 
+ protected:
+    /**
+     * @brief 向对象存储发送一个异步范围读请求
+     *
+     * @param key 对象名
+     * @param offset 读取的偏移
+     * @param len 读取的长度
+     * @param buf 读取的数据，完成之前需保证其有效
+     * @param etag 非空时只在对象的ETag与之相同时读取
+     * @param done 请求完成后以返回值(0 成功/-1 失败)和对象的ETag调用
+     */
+    virtual void IssueGetObjectAsync(const std::string &key,
+                                     off_t offset,
+                                     size_t len,
+                                     char *buf,
+                                     const std::string &etag,
+                                     std::function<void(int,
+                                         const std::string &)> done);
+
+ private:
+    // 排队等待发送的异步请求
+    struct AsyncRequest {
+        // 非空时为读请求，可与同一对象、同一ETag条件的相邻读请求合并
+        std::shared_ptr<GetObjectAsyncContext> getContext;
+        // 发送写请求
+        std::function<void()> issue;
+    };
+
+    /**
+     * @brief 提交异步请求，窗口已满时排队
+     */
+    void SubmitAsyncRequest(const AsyncRequest &request);
+
+    /**
+     * @brief 一个异步请求完成，窗口中的位置交给排队的请求
+     */
+    void OnAsyncRequestDone();
+
+    /**
+     * @brief 从队列中取出下一个请求，读请求连同可以合并的读请求一起取出
+     *
+     * @param[out] gets 按偏移排序的读请求，为空时表示取出的是写请求
+     * @param[out] request 取出的写请求
+     */
+    void PopPendingRequest(
+        std::vector<std::shared_ptr<GetObjectAsyncContext>> *gets,
+        AsyncRequest *request);
+
+    /**
+     * @brief 发送一组连续的读请求
+     */
+    void IssueGets(
+        const std::vector<std::shared_ptr<GetObjectAsyncContext>> &gets);
+
  private:
     // S3服务器地址，由配置文件指定
     Aws::String s3Address_;
@@ -218,7 +336,17 @@ class S3Adapter {
     Aws::S3::S3Client *s3Client_;
     Configuration conf_;
 
-    Throttle *throttle_;
+    Throttle *throttle_ = nullptr;
+
+    Mutex asyncMtx_;
+    // 排队等待发送的异步请求
+    std::list<AsyncRequest> pendingRequests_;
+    // 正在进行的异步请求数
+    uint32_t inflightNum_ = 0;
+    // 同时进行的异步请求数上限，0表示不限制
+    uint32_t maxAsyncInflight_ = 0;
+    // 合并后读请求的最大长度，0表示不合并
+    uint64_t maxCoalesceBytes_ = 0;
 };
 }  // namespace common
 }  // namespace curve
@@ -41,6 +41,7 @@ const char* kFlattenAction = "Flatten";
 const char* kGetFileSnapshotListAction = "GetFileSnapshotList";
 const char* kGetCloneTaskListAction = "GetCloneTaskList";
 const char* kGetCloneRefStatusAction = "GetCloneRefStatus";
+const char* kReportCloneReadMissAction = "ReportCloneReadMiss";
 
 const char* kActionStr = "Action";
 const char* kVersionStr = "Version";
@@ -65,6 +66,9 @@ const char* kSnapshotsStr = "Snapshots";
 const char* kTaskInfosStr = "TaskInfos";
 const char* kRefStatusStr = "RefStatus";
 const char* kCloneFileInfoStr = "CloneFileInfo";
+const char* kReadMissStr = "ReadMiss";
+const char* kChunkIdStr = "ChunkId";
+const char* kCountStr = "Count";
 
 std::map<int, std::string> code2Msg = {
     {kErrCodeSuccess, "Exec success."},
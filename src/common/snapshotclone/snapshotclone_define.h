@@ -44,6 +44,7 @@ extern const char* kFlattenAction;
 extern const char* kGetFileSnapshotListAction;
 extern const char* kGetCloneTaskListAction;
 extern const char* kGetCloneRefStatusAction;
+extern const char* kReportCloneReadMissAction;
 // param
 extern const char* kActionStr;
 extern const char* kVersionStr;
@@ -69,6 +70,9 @@ extern const char* kSnapshotsStr;
 extern const char* kTaskInfosStr;
 extern const char* kRefStatusStr;
 extern const char* kCloneFileInfoStr;
+extern const char* kReadMissStr;
+extern const char* kChunkIdStr;
+extern const char* kCountStr;
 
 typedef std::string UUID;
 using TaskIdType = UUID;
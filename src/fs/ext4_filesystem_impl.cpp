@@ -394,5 +394,14 @@ int Ext4FileSystemImpl::Fsync(int fd) {
     return 0;
 }
 
+int Ext4FileSystemImpl::Fdatasync(int fd) {
+    int rc = posixWrapper_->fdatasync(fd);
+    if (rc < 0) {
+        LOG(ERROR) << "fdatasync failed: " << strerror(errno);
+        return -errno;
+    }
+    return 0;
+}
+
 }  // namespace fs
 }  // namespace curve
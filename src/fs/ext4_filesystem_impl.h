@@ -60,6 +60,7 @@ class Ext4FileSystemImpl : public LocalFileSystem {
                   int length) override;
     int Fstat(int fd, struct stat* info) override;
     int Fsync(int fd) override;
+    int Fdatasync(int fd) override;
 
  private:
     explicit Ext4FileSystemImpl(std::shared_ptr<PosixWrapper>);
@@ -206,6 +206,13 @@ class LocalFileSystem {
      */
     virtual int Fsync(int fd) = 0;
 
+    /**
+     * 将文件数据刷新到磁盘，只刷新读取数据必需的元数据
+     * @param fd：文件句柄id，通过Open接口获取
+     * @return 成功返回0
+     */
+    virtual int Fdatasync(int fd) = 0;
+
  private:
     virtual int DoRename(const string& oldPath,
                          const string& newPath,
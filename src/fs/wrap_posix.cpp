@@ -108,6 +108,10 @@ int PosixWrapper::fsync(int fd) {
     return ::fsync(fd);
 }
 
+int PosixWrapper::fdatasync(int fd) {
+    return ::fdatasync(fd);
+}
+
 int PosixWrapper::statfs(const char *path, struct statfs *buf) {
     return ::statfs(path, buf);
 }
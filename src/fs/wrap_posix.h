@@ -62,6 +62,7 @@ class PosixWrapper {
     virtual int fstat(int fd, struct stat *buf);
     virtual int fallocate(int fd, int mode, off_t offset, off_t len);
     virtual int fsync(int fd);
+    virtual int fdatasync(int fd);
     virtual int statfs(const char *path, struct statfs *buf);
     virtual int uname(struct utsname *buf);
 };
@@ -178,6 +178,9 @@ int EtcdClientImp::TxnN(const std::vector<Operation> &ops) {
             errCode = EtcdClientTxn2(timeout_, ops[0], ops[1]);
         } else if (ops.size() == 3) {
             errCode = EtcdClientTxn3(timeout_, ops[0], ops[1], ops[2]);
+        } else if (ops.size() > 3) {
+            errCode = EtcdClientTxnN(timeout_,
+                const_cast<Operation*>(ops.data()), ops.size());
         } else {
             LOG(ERROR) << "do not support Txn " << ops.size();
             return EtcdErrCode::EtcdInvalidArgument;
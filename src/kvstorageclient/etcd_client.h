@@ -78,6 +78,24 @@ class KVStorageClient {
     virtual int List(const std::string &startKey, const std::string &endKey,
         std::vector<std::string> *values) = 0;
 
+    /**
+     * @brief ListWithLimitAndRevision
+     *        get key-value pairs between [startKey, endKey)
+     *        with specify number and revision
+     *
+     * @param[in] startKey start key
+     * @param[in] endKey end key, not included
+     * @param[in] limit max number
+     * @param[in] revision get the key <= revision, 0 means the latest
+     * @param[out] values the value vector of all the key-value pairs
+     * @param[out] lastKey the last key of the vector
+     *
+     * @return error code
+     */
+    virtual int ListWithLimitAndRevision(const std::string &startKey,
+        const std::string &endKey, int64_t limit, int64_t revision,
+        std::vector<std::string> *values, std::string *lastKey) = 0;
+
     /**
      * @brief Delete Delete the value of the specified key
      *
@@ -99,7 +117,7 @@ class KVStorageClient {
         const std::string &key, int64_t *revision) = 0;
 
     /*
-    * @brief TxnN Operate transactions in the order of ops[0] ops[1] ..., currently 2 and 3 operations are supported //NOLINT
+    * @brief TxnN Operate transactions in the order of ops[0] ops[1] ..., at least 2 operations are required //NOLINT
     *
     * @param[in] ops Operation set
     *
@@ -163,21 +181,9 @@ class EtcdClientImp : public KVStorageClient {
 
     virtual int GetCurrentRevision(int64_t *revision);
 
-    /**
-     * @brief ListWithLimitAndRevision
-     *        get key-value pairs between [startKey, endKey)
-     *        with specify number and revision
-     *
-     * @param[in] startKey start key
-     * @param[in] endKey end key, not included
-     * @param[in] limit max number
-     * @param[in] revision get the key <= revision
-     * @param[out] values the value vector of all the key-value pairs
-     * @param[out] lastKey the last key of the vector
-     */
-    virtual int ListWithLimitAndRevision(const std::string &startKey,
+    int ListWithLimitAndRevision(const std::string &startKey,
         const std::string &endKey, int64_t limit, int64_t revision,
-        std::vector<std::string> *values, std::string *lastKey);
+        std::vector<std::string> *values, std::string *lastKey) override;
 
     /**
      * @brief CampaignLeader Leader campaign through etcd, return directly if
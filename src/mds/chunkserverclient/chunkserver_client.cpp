@@ -22,6 +22,8 @@
 
 #include "src/mds/chunkserverclient/chunkserver_client.h"
 
+#include <brpc/errno.pb.h>
+
 #include <string>
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
@@ -35,6 +37,8 @@ using ::curve::mds::topology::ONLINE;
 using ::curve::chunkserver::ChunkService_Stub;
 using ::curve::chunkserver::ChunkRequest;
 using ::curve::chunkserver::ChunkResponse;
+using ::curve::chunkserver::DeleteChunkBatchRequest;
+using ::curve::chunkserver::DeleteChunkBatchResponse;
 using ::curve::chunkserver::CHUNK_OP_TYPE;
 using ::curve::chunkserver::CHUNK_OP_STATUS;
 
@@ -228,6 +232,105 @@ int ChunkServerClient::DeleteChunk(ChunkServerIdType leaderId,
     return kMdsSuccess;
 }
 
+int ChunkServerClient::DeleteChunkBatch(ChunkServerIdType leaderId,
+    LogicalPoolID logicalPoolId,
+    CopysetID copysetId,
+    const std::vector<ChunkID> &chunkIds,
+    uint64_t sn) {
+    ChannelPtr channelPtr;
+    int res = GetOrInitChannel(leaderId, &channelPtr);
+    if (res != kMdsSuccess) {
+        return res;
+    }
+    ChunkService_Stub stub(channelPtr.get());
+
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(rpcTimeoutMs_);
+
+    DeleteChunkBatchRequest request;
+    request.set_logicpoolid(logicalPoolId);
+    request.set_copysetid(copysetId);
+    for (ChunkID chunkId : chunkIds) {
+        request.add_chunkid(chunkId);
+    }
+    request.set_sn(sn);
+
+    DeleteChunkBatchResponse response;
+    uint32_t retry = 0;
+    do {
+        cntl.Reset();
+        cntl.set_timeout_ms(rpcTimeoutMs_);
+        stub.DeleteChunkBatch(&cntl,
+            &request,
+            &response,
+            nullptr);
+        LOG(INFO) << "Send DeleteChunkBatch[log_id=" << cntl.log_id()
+                  << "] from " << cntl.local_side()
+                  << " to " << cntl.remote_side()
+                  << ". logicalPoolId = " << logicalPoolId
+                  << ", copysetId = " << copysetId
+                  << ", chunk num = " << chunkIds.size()
+                  << ", sn = " << sn;
+        if (cntl.Failed()) {
+            // 未升级的chunkserver没有该rpc，重试也不会成功
+            if (cntl.ErrorCode() == brpc::ENOMETHOD) {
+                LOG(WARNING) << "Send DeleteChunkBatch error, chunkserver "
+                             << "does not support it, cntl.errorText = "
+                             << cntl.ErrorText();
+                return kCsClientNotSupport;
+            }
+            LOG(WARNING) << "Send DeleteChunkBatch error, "
+                       << "cntl.errorText = "
+                       << cntl.ErrorText()
+                       << ", retry, time = "
+                       << retry;
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(rpcRetryIntervalMs_));
+        }
+        retry++;
+    } while (cntl.Failed() && retry < rpcRetryTimes_);
+
+    if (cntl.Failed()) {
+        LOG(ERROR) << "Send DeleteChunkBatch error, retry fail,"
+                   << "cntl.errorText = "
+                   << cntl.ErrorText() << std::endl;
+        return kRpcFail;
+    } else {
+        switch (response.status()) {
+            case CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS:
+            case CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST: {
+                    LOG(INFO) << "Received DeleteChunkBatch[log_id="
+                          << cntl.log_id()
+                          << "] from " << cntl.remote_side()
+                          << " to " << cntl.local_side()
+                          << ", status = "
+                          << ::curve::chunkserver::CHUNK_OP_STATUS_Name(
+                                response.status());
+                    return kMdsSuccess;
+                }
+            case CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED: {
+                    LOG(INFO) << "Received DeleteChunkBatch, not leader, "
+                              << "redirect. [log_id=" << cntl.log_id()
+                              << "] from " << cntl.remote_side()
+                              << " to " << cntl.local_side()
+                              << ". [DeleteChunkBatchResponse] "
+                              << response.DebugString();
+                    return kCsClientNotLeader;
+                }
+            default: {
+                    LOG(ERROR) << "Received DeleteChunkBatch error, [log_id="
+                              << cntl.log_id()
+                              << "] from " << cntl.remote_side()
+                              << " to " << cntl.local_side()
+                              << ". [DeleteChunkBatchResponse] "
+                              << response.DebugString();
+                    return kCsClientReturnFail;
+                }
+        }
+    }
+    return kMdsSuccess;
+}
+
 int ChunkServerClient::GetLeader(ChunkServerIdType csId,
     LogicalPoolID logicalPoolId,
     CopysetID copysetId,
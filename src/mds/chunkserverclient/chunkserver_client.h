@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
@@ -94,6 +95,23 @@ class ChunkServerClient {
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief delete a batch of chunk files in the same copyset with one rpc
+     *
+     * @param leaderId
+     * @param logicalPoolId
+     * @param copysetId
+     * @param chunkIds chunk file IDs
+     * @param sn file version number
+     *
+     * @return error code
+     */
+    virtual int DeleteChunkBatch(ChunkServerIdType leaderId,
+        LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief get the leader
      * @detail
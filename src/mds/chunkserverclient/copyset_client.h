@@ -24,6 +24,7 @@
 #define SRC_MDS_CHUNKSERVERCLIENT_COPYSET_CLIENT_H_
 
 #include <memory>
+#include <vector>
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
 
@@ -55,6 +56,8 @@ class CopysetClient {
           updateLeaderRetryIntervalMs_(option.updateLeaderRetryIntervalMs) {
     }
 
+    virtual ~CopysetClient() {}
+
     void SetChunkServerClient(std::shared_ptr<ChunkServerClient> csClient) {
         chunkserverClient_ = csClient;
     }
@@ -72,7 +75,7 @@ class CopysetClient {
      *
      * @return error code
      */
-    int DeleteChunkSnapshotOrCorrectSn(LogicalPoolID logicalPoolId,
+    virtual int DeleteChunkSnapshotOrCorrectSn(LogicalPoolID logicalPoolId,
         CopysetID copysetId,
         ChunkID chunkId,
         uint64_t correctedSn);
@@ -87,11 +90,27 @@ class CopysetClient {
      *
      * @return error code
      */
-    int DeleteChunk(LogicalPoolID logicalPoolId,
+    virtual int DeleteChunk(LogicalPoolID logicalPoolId,
         CopysetID copysetId,
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief delete a batch of chunk files in the same copyset,
+     *        retry on the new leader as DeleteChunk does
+     *
+     * @param logicPoolId
+     * @param copysetId
+     * @param chunkIds
+     * @param sn file version number
+     *
+     * @return error code
+     */
+    virtual int DeleteChunkBatch(LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief update leader
      *
@@ -46,11 +46,19 @@ const int kRpcFail = -5;
 const int kCsClientReturnFail = -5;
 // error code: chunkserver offline
 const int kCsClientCSOffline = -6;
+// error code: chunkserver does not support the request
+const int kCsClientNotSupport = -7;
 
 // kStaledRequestTimeIntervalUs indicates the expiration time of the request
 // to prevent the request from being intercepted and played back
 const uint64_t kStaledRequestTimeIntervalUs = 15 * 1000 * 1000u;
 
+// kListSegmentDefaultLimit is the page size used when listing the segments
+// of a file page by page, kListSegmentMaxLimit is the max page size a client
+// can ask for in one ListSegment request
+const uint32_t kListSegmentDefaultLimit = 1024u;
+const uint32_t kListSegmentMaxLimit = 4096u;
+
 }  // namespace mds
 }  // namespace curve
 
@@ -46,6 +46,9 @@ struct HeartbeatOption {
         this->heartbeatIntervalMs = heartbeatInterval;
         this->heartbeatMissTimeOutMs = heartbeatMissTimeout;
         this->offLineTimeOutMs = offLineTimeout;
+        this->workerShardNum = 0;
+        this->workerQueueCapacity = 0;
+        this->enableCopysetReportDiff = false;
     }
 
     // heartbeatIntervalMs: normal heartbeat interval.
@@ -69,6 +72,18 @@ struct HeartbeatOption {
 
     // the time when the mds start (fetch from system)
     steady_clock::time_point mdsStartTime;
+
+    // heartbeats are dispatched to worker shards by chunkserver id, so
+    // heartbeats of one chunkserver are handled in order and the cpu used
+    // for heartbeat is bounded. 0 means handling heartbeat in rpc thread
+    uint32_t workerShardNum;
+
+    // the max number of heartbeats queued in one worker shard
+    uint32_t workerQueueCapacity;
+
+    // skip comparing with topology for copysets whose report
+    // have not changed since last heartbeat
+    bool enableCopysetReportDiff;
 };
 
 struct HeartbeatInfo {
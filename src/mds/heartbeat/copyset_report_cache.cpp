@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/mds/heartbeat/copyset_report_cache.h"
+
+using ::curve::common::LockGuard;
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+CopysetReportCache::CopysetReportCache(uint32_t stripeNum) {
+    if (stripeNum == 0) {
+        stripeNum = kDefaultStripeNum;
+    }
+    stripes_.reserve(stripeNum);
+    for (uint32_t i = 0; i < stripeNum; i++) {
+        stripes_.emplace_back(new Stripe());
+    }
+}
+
+CopysetReportCache::Stripe *CopysetReportCache::GetStripe(
+    const CopySetKey &key) const {
+    uint64_t hash = (static_cast<uint64_t>(key.first) << 32) | key.second;
+    return stripes_[hash % stripes_.size()].get();
+}
+
+bool CopysetReportCache::IsSameAsLast(
+    const ::curve::mds::topology::CopySetInfo &report) const {
+    CopySetKey key = report.GetCopySetKey();
+    Stripe *stripe = GetStripe(key);
+    LockGuard guard(stripe->mtx);
+    auto it = stripe->reports.find(key);
+    if (it == stripe->reports.end()) {
+        return false;
+    }
+    const ReportState &last = it->second;
+    return last.epoch == report.GetEpoch() &&
+           last.leader == report.GetLeader() &&
+           last.candidate == report.GetCandidate() &&
+           last.peers == report.GetCopySetMembers();
+}
+
+void CopysetReportCache::Record(
+    const ::curve::mds::topology::CopySetInfo &report) {
+    ReportState state;
+    state.epoch = report.GetEpoch();
+    state.leader = report.GetLeader();
+    state.candidate = report.GetCandidate();
+    state.peers = report.GetCopySetMembers();
+
+    CopySetKey key = report.GetCopySetKey();
+    Stripe *stripe = GetStripe(key);
+    LockGuard guard(stripe->mtx);
+    stripe->reports[key] = std::move(state);
+}
+
+void CopysetReportCache::Invalidate(const CopySetKey &key) {
+    Stripe *stripe = GetStripe(key);
+    LockGuard guard(stripe->mtx);
+    stripe->reports.erase(key);
+}
+
+void CopysetReportCache::Clear() {
+    for (auto &stripe : stripes_) {
+        LockGuard guard(stripe->mtx);
+        stripe->reports.clear();
+    }
+}
+
+uint64_t CopysetReportCache::Size() const {
+    uint64_t size = 0;
+    for (auto &stripe : stripes_) {
+        LockGuard guard(stripe->mtx);
+        size += stripe->reports.size();
+    }
+    return size;
+}
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
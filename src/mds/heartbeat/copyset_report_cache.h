@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_HEARTBEAT_COPYSET_REPORT_CACHE_H_
+#define SRC_MDS_HEARTBEAT_COPYSET_REPORT_CACHE_H_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+
+#include "src/mds/topology/topology_item.h"
+#include "src/common/concurrent/concurrent.h"
+
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::ChunkServerIdType;
+using ::curve::mds::topology::EpochType;
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+// CopysetReportCache remembers the last copyset state reported by the leader
+// and applied by TopoUpdater. A leader reports the same state in every
+// heartbeat when nothing changes, so heartbeat manager can skip comparing it
+// with topology again.
+// The cache is keyed by copyset rather than by chunkserver, so a leader
+// transfer back and forth is always seen as a change.
+// The map is divided into stripes to avoid heartbeats from different
+// chunkservers contending on the same lock.
+class CopysetReportCache {
+ public:
+    explicit CopysetReportCache(uint32_t stripeNum = kDefaultStripeNum);
+
+    /**
+     * @brief IsSameAsLast check whether the report is the same as the last one
+     *        recorded of this copyset
+     *
+     * @param[in] report copyset info reported by leader
+     *
+     * @return true if epoch, leader, members and candidate are all the same
+     */
+    bool IsSameAsLast(
+        const ::curve::mds::topology::CopySetInfo &report) const;
+
+    /**
+     * @brief Record record the report after it is handled by TopoUpdater
+     *
+     * @param[in] report copyset info reported by leader
+     */
+    void Record(const ::curve::mds::topology::CopySetInfo &report);
+
+    /**
+     * @brief Invalidate drop the record of the copyset, should be called when
+     *        topology of the copyset is changed outside of TopoUpdater,
+     *        e.g. candidate is set by CopysetConfGenerator
+     *
+     * @param[in] key copyset key
+     */
+    void Invalidate(const CopySetKey &key);
+
+    /**
+     * @brief Clear drop all the records
+     */
+    void Clear();
+
+    /**
+     * @brief Size number of copysets recorded
+     */
+    uint64_t Size() const;
+
+ private:
+    struct ReportState {
+        EpochType epoch;
+        ChunkServerIdType leader;
+        ChunkServerIdType candidate;
+        std::set<ChunkServerIdType> peers;
+    };
+
+    struct Stripe {
+        mutable ::curve::common::Mutex mtx;
+        std::map<CopySetKey, ReportState> reports;
+    };
+
+    Stripe *GetStripe(const CopySetKey &key) const;
+
+ private:
+    static const uint32_t kDefaultStripeNum = 64;
+
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+};
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_HEARTBEAT_COPYSET_REPORT_CACHE_H_
@@ -21,10 +21,15 @@
  */
 
 #include <glog/logging.h>
+#include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <brpc/errno.pb.h>
 #include <utility>
 #include <set>
 #include "src/mds/heartbeat/heartbeat_manager.h"
 #include "src/common/string_util.h"
+#include "src/common/timeutility.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "src/mds/topology/topology_stat.h"
 
 using ::curve::mds::topology::ChunkServer;
@@ -37,6 +42,10 @@ using ::curve::mds::topology::ChunkServerStatus;
 using ::curve::mds::topology::ChunkServerStat;
 using ::curve::mds::topology::CopysetStat;
 using ::curve::mds::topology::SplitPeerId;
+using ::curve::common::TimeUtility;
+using ::curve::common::ReadLockGuard;
+using ::curve::common::WriteLockGuard;
+using ::curve::common::CountDownEvent;
 
 namespace curve {
 namespace mds {
@@ -58,6 +67,11 @@ HeartbeatManager::HeartbeatManager(HeartbeatOption option,
 
     isStop_ = true;
     chunkserverHealthyCheckerRunInter_ = option.heartbeatMissTimeOutMs;
+
+    workerShardNum_ = option.workerShardNum;
+    workerQueueCapacity_ = option.workerQueueCapacity;
+    workerShardsRunning_ = false;
+    enableCopysetReportDiff_ = option.enableCopysetReportDiff;
 }
 
 void HeartbeatManager::Init() {
@@ -75,6 +89,17 @@ void HeartbeatManager::Run() {
     if (isStop_.exchange(false)) {
         backEndThread_ =
             Thread(&HeartbeatManager::ChunkServerHealthyChecker, this);
+
+        WriteLockGuard wlock(workerShardsLock_);
+        for (uint32_t i = 0; i < workerShardNum_; i++) {
+            std::unique_ptr<TaskThreadPool<>> shard(new TaskThreadPool<>());
+            int ret = workerQueueCapacity_ > 0 ?
+                shard->Start(1, workerQueueCapacity_) : shard->Start(1);
+            LOG_IF(FATAL, ret != 0) << "start heartbeat worker shard " << i
+                                    << " fail, ret = " << ret;
+            workerShards_.emplace_back(std::move(shard));
+        }
+        workerShardsRunning_ = !workerShards_.empty();
     }
 }
 
@@ -83,6 +108,23 @@ void HeartbeatManager::Stop() {
         LOG(INFO) << "stop heartbeatManager...";
         sleeper_.interrupt();
         backEndThread_.join();
+        std::vector<std::unique_ptr<TaskThreadPool<>>> shards;
+        {
+            WriteLockGuard wlock(workerShardsLock_);
+            workerShardsRunning_ = false;
+            shards.swap(workerShards_);
+        }
+        // TaskThreadPool::Stop drops queued tasks, drain the queues first so
+        // that every queued heartbeat runs its done. They see isStop_ and
+        // fail fast
+        CountDownEvent drained(shards.size());
+        for (auto &shard : shards) {
+            shard->Enqueue([&drained]() { drained.Signal(); });
+        }
+        drained.Wait();
+        for (auto &shard : shards) {
+            shard->Stop();
+        }
         LOG(INFO) << "stop heartbeatManager ok.";
     } else {
         LOG(INFO) << "heartbeatManager not running.";
@@ -180,12 +222,62 @@ void HeartbeatManager::UpdateChunkServerStatistics(
     topologyStat_->UpdateChunkServerStat(request.chunkserverid(), stat);
 }
 
+void HeartbeatManager::ChunkServerHeartbeatAsync(
+    google::protobuf::RpcController *controller,
+    const ChunkServerHeartbeatRequest *request,
+    ChunkServerHeartbeatResponse *response,
+    google::protobuf::Closure *done) {
+    brpc::Controller *cntl = static_cast<brpc::Controller *>(controller);
+    bool rejected = false;
+    {
+        ReadLockGuard rlock(workerShardsLock_);
+        if (workerShardsRunning_) {
+            // heartbeats of the same chunkserver always go to the same shard,
+            // so they are handled in the order they arrive
+            uint64_t enqueueUs = TimeUtility::GetTimeofDayUs();
+            auto &shard =
+                workerShards_[request->chunkserverid() % workerShards_.size()];
+            // never block the brpc worker on a full queue
+            bool queued = shard->TryEnqueue(
+                [this, cntl, request, response, done, enqueueUs]() {
+                    brpc::ClosureGuard doneGuard(done);
+                    if (isStop_.load()) {
+                        cntl->SetFailed(brpc::ELOGOFF,
+                                        "heartbeat manager is stopping");
+                        return;
+                    }
+                    metrics_.queueLatency <<
+                        (TimeUtility::GetTimeofDayUs() - enqueueUs);
+                    ChunkServerHeartbeat(*request, response);
+                });
+            if (queued) {
+                return;
+            }
+            rejected = true;
+        }
+    }
+
+    brpc::ClosureGuard doneGuard(done);
+    if (rejected) {
+        // the chunkserver reports again in the next heartbeat interval
+        metrics_.rejected << 1;
+        LOG(WARNING) << "heartbeat worker queue is full, reject heartbeat "
+                     << "from chunkserver " << request->chunkserverid();
+        cntl->SetFailed(brpc::ELIMIT, "heartbeat worker queue is full");
+        return;
+    }
+    ChunkServerHeartbeat(*request, response);
+}
+
 void HeartbeatManager::ChunkServerHeartbeat(
     const ChunkServerHeartbeatRequest &request,
     ChunkServerHeartbeatResponse *response) {
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     response->set_statuscode(HeartbeatStatusCode::hbOK);
     // check validity of heartbeat request
     HeartbeatStatusCode ret = CheckRequest(request);
+    uint64_t stageUs = TimeUtility::GetTimeofDayUs();
+    metrics_.checkLatency << (stageUs - startUs);
     if (ret != HeartbeatStatusCode::hbOK) {
         LOG(ERROR) << "heartbeatManager get error request";
         response->set_statuscode(ret);
@@ -205,10 +297,20 @@ void HeartbeatManager::ChunkServerHeartbeat(
     UpdateChunkServerDiskStatus(request);
 
     UpdateChunkServerStatistics(request);
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    metrics_.statisticsLatency << (nowUs - stageUs);
+    stageUs = nowUs;
+
     // no copyset info in the request
     if (request.copysetinfos_size() == 0) {
         response->set_statuscode(HeartbeatStatusCode::hbRequestNoCopyset);
     }
+    // copysets whose leader is the reporting chunkserver, the topology
+    // of them will be updated in batch after all copysets are handled
+    std::vector<::curve::mds::topology::CopySetInfo> leaderCopySetInfos;
+    // leader copysets that no new configuration dispatched to, their reports
+    // can be recorded in the report cache after topology updated
+    std::vector<::curve::mds::topology::CopySetInfo> toRecordCopySetInfos;
     // dealing with copysets included in the heartbeat request
     for (auto &value : request.copysetinfos()) {
         // discard copysets of invalid logical pool
@@ -234,19 +336,45 @@ void HeartbeatManager::ChunkServerHeartbeat(
         // forward reported copyset info to CopysetConfGenerator
         CopySetConf conf;
         ConfigChangeInfo configChInfo;
-        if (copysetConfGenerator_->GenCopysetConf(
+        bool confGenerated = copysetConfGenerator_->GenCopysetConf(
                 request.chunkserverid(), reportCopySetInfo,
-                value.configchangeinfo(), &conf)) {
+                value.configchangeinfo(), &conf);
+        if (confGenerated) {
             CopySetConf *res = response->add_needupdatecopysets();
             *res = conf;
+            // topology of the copyset may be changed by the generator
+            reportCache_.Invalidate(reportCopySetInfo.GetCopySetKey());
         }
 
         // if a copyset is the leader, update (e.g. epoch) topology according
         // to its info
         if (request.chunkserverid() == reportCopySetInfo.GetLeader()) {
-            topoUpdater_->UpdateTopo(reportCopySetInfo);
+            metrics_.copysetReported << 1;
+            if (enableCopysetReportDiff_ && !confGenerated &&
+                reportCache_.IsSameAsLast(reportCopySetInfo)) {
+                metrics_.copysetUnchanged << 1;
+                continue;
+            }
+            if (enableCopysetReportDiff_ && !confGenerated) {
+                toRecordCopySetInfos.emplace_back(reportCopySetInfo);
+            }
+            leaderCopySetInfos.emplace_back(std::move(reportCopySetInfo));
+        }
+    }
+    nowUs = TimeUtility::GetTimeofDayUs();
+    metrics_.copysetConfLatency << (nowUs - stageUs);
+    stageUs = nowUs;
+
+    if (!leaderCopySetInfos.empty()) {
+        if (topoUpdater_->UpdateTopo(leaderCopySetInfos)) {
+            for (const auto &info : toRecordCopySetInfos) {
+                reportCache_.Record(info);
+            }
         }
     }
+    nowUs = TimeUtility::GetTimeofDayUs();
+    metrics_.topoUpdateLatency << (nowUs - stageUs);
+    metrics_.totalLatency << (nowUs - startUs);
 }
 
 HeartbeatStatusCode HeartbeatManager::CheckRequest(
@@ -34,8 +34,11 @@
 #include "src/mds/heartbeat/topo_updater.h"
 #include "src/mds/heartbeat/copyset_conf_generator.h"
 #include "src/mds/heartbeat/chunkserver_healthy_checker.h"
+#include "src/mds/heartbeat/copyset_report_cache.h"
+#include "src/mds/heartbeat/heartbeat_metrics.h"
 #include "src/mds/schedule/coordinator.h"
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/interruptible_sleeper.h"
 #include "proto/heartbeat.pb.h"
 #include "src/mds/topology/topology_stat.h"
@@ -50,6 +53,7 @@ using ::curve::mds::schedule::Coordinator;
 using ::curve::common::Thread;
 using ::curve::common::Atomic;
 using ::curve::common::RWLock;
+using ::curve::common::TaskThreadPool;
 using ::curve::common::InterruptibleSleeper;
 
 namespace curve {
@@ -70,6 +74,11 @@ namespace heartbeat {
 // 3. update topology information
 //    - update epoch, copy relationship and other statistical data of topology
 //      according to the copyset information reported by the chunkserver
+//
+// heartbeat is handled as a pipeline: check request -> update statistics ->
+// generate copyset configuration -> update topology in batch. When worker
+// shards are enabled, heartbeats are dispatched to shards by chunkserver id
+// and handled in the worker threads.
 
 class HeartbeatManager {
  public:
@@ -110,6 +119,24 @@ class HeartbeatManager {
     void ChunkServerHeartbeat(const ChunkServerHeartbeatRequest &request,
                                 ChunkServerHeartbeatResponse *response);
 
+    /**
+     * @brief ChunkServerHeartbeatAsync Dispatch heartbeat request to the
+     *        worker shard of the chunkserver, and run done after it's
+     *        handled. The request is handled in place if worker shards
+     *        are disabled or not running. The rpc fails with ELIMIT if the
+     *        shard queue is full, and with ELOGOFF if the manager stops
+     *        before the request is handled
+     *
+     * @param[in] controller RPC controller
+     * @param[in] request RPC heartbeat request
+     * @param[out] response Response of heartbeat request
+     * @param[in] done closure to run after request is handled
+     */
+    void ChunkServerHeartbeatAsync(google::protobuf::RpcController *controller,
+                                const ChunkServerHeartbeatRequest *request,
+                                ChunkServerHeartbeatResponse *response,
+                                google::protobuf::Closure *done);
+
  private:
     /**
      * @brief Update disk status data of chunkserver
@@ -189,6 +216,21 @@ class HeartbeatManager {
     Atomic<bool> isStop_;
     InterruptibleSleeper sleeper_;
     int chunkserverHealthyCheckerRunInter_;
+
+    // worker shards which heartbeats are dispatched to by chunkserver id,
+    // each shard has only one thread
+    uint32_t workerShardNum_;
+    uint32_t workerQueueCapacity_;
+    std::vector<std::unique_ptr<TaskThreadPool<>>> workerShards_;
+    // protect workerShards_ from being stopped while dispatching
+    RWLock workerShardsLock_;
+    bool workerShardsRunning_;
+
+    // last copyset state reported by leaders
+    bool enableCopysetReportDiff_;
+    CopysetReportCache reportCache_;
+
+    HeartbeatMetrics metrics_;
 };
 
 }  // namespace heartbeat
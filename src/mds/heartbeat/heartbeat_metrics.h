@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_HEARTBEAT_HEARTBEAT_METRICS_H_
+#define SRC_MDS_HEARTBEAT_HEARTBEAT_METRICS_H_
+
+#include <bvar/bvar.h>
+#include <string>
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+// latency of each stage of heartbeat processing, in us
+class HeartbeatMetrics {
+ public:
+    HeartbeatMetrics() :
+        queueLatency(HeartbeatMetricsPrefix, "queue"),
+        checkLatency(HeartbeatMetricsPrefix, "check"),
+        statisticsLatency(HeartbeatMetricsPrefix, "statistics"),
+        copysetConfLatency(HeartbeatMetricsPrefix, "copyset_conf"),
+        topoUpdateLatency(HeartbeatMetricsPrefix, "topo_update"),
+        totalLatency(HeartbeatMetricsPrefix, "total"),
+        copysetReported(HeartbeatMetricsPrefix, "copyset_reported"),
+        copysetUnchanged(HeartbeatMetricsPrefix, "copyset_unchanged"),
+        rejected(HeartbeatMetricsPrefix, "rejected") {}
+
+ public:
+    const std::string HeartbeatMetricsPrefix = "mds_heartbeat_metric";
+
+    // time that a heartbeat waits in the worker shard queue
+    bvar::LatencyRecorder queueLatency;
+    // request validation
+    bvar::LatencyRecorder checkLatency;
+    // disk status and statistics update
+    bvar::LatencyRecorder statisticsLatency;
+    // copyset configuration generation for all copysets in a heartbeat
+    bvar::LatencyRecorder copysetConfLatency;
+    // topology update for all copysets in a heartbeat
+    bvar::LatencyRecorder topoUpdateLatency;
+    bvar::LatencyRecorder totalLatency;
+
+    // copysets reported by leaders
+    bvar::Adder<uint64_t> copysetReported;
+    // copysets reported by leaders but not changed since last report
+    bvar::Adder<uint64_t> copysetUnchanged;
+
+    // heartbeats rejected because the worker shard queue is full
+    bvar::Adder<uint64_t> rejected;
+};
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_HEARTBEAT_HEARTBEAT_METRICS_H_
@@ -36,8 +36,8 @@ void HeartbeatServiceImpl::ChunkServerHeartbeat(
     const ::curve::mds::heartbeat::ChunkServerHeartbeatRequest *request,
     ::curve::mds::heartbeat::ChunkServerHeartbeatResponse *response,
     ::google::protobuf::Closure *done) {
-    brpc::ClosureGuard doneGuard(done);
-    heartbeatManager_->ChunkServerHeartbeat(*request, response);
+    heartbeatManager_->ChunkServerHeartbeatAsync(controller, request, response,
+                                                  done);
 }
 }  // namespace heartbeat
 }  // namespace mds
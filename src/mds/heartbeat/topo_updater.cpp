@@ -27,6 +27,51 @@ namespace curve {
 namespace mds {
 namespace heartbeat {
 void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
+    if (!NeedUpdateTopo(reportCopySetInfo)) {
+        return;
+    }
+
+    // update changes to database and RAM
+    LOG(INFO) << "topoUpdater find copyset("
+              << reportCopySetInfo.GetLogicalPoolId() << ","
+              << reportCopySetInfo.GetId() << ") need to update";
+
+    int updateCode = topo_->UpdateCopySetTopo(reportCopySetInfo);
+    if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
+        LOG(ERROR) << "topoUpdater update copyset("
+                   << reportCopySetInfo.GetLogicalPoolId()
+                   << "," << reportCopySetInfo.GetId()
+                   << ") got error code: " << updateCode;
+    }
+}
+
+bool TopoUpdater::UpdateTopo(
+    const std::vector<CopySetInfo> &reportCopySetInfos) {
+    std::vector<CopySetInfo> needUpdate;
+    for (const auto &info : reportCopySetInfos) {
+        if (NeedUpdateTopo(info)) {
+            LOG(INFO) << "topoUpdater find copyset("
+                      << info.GetLogicalPoolId() << ","
+                      << info.GetId() << ") need to update";
+            needUpdate.emplace_back(info);
+        }
+    }
+
+    if (needUpdate.empty()) {
+        return true;
+    }
+
+    // apply all the changes in one acquisition of the copyset map lock
+    int updateCode = topo_->BatchUpdateCopySetTopo(needUpdate);
+    if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
+        LOG(ERROR) << "topoUpdater update " << needUpdate.size()
+                   << " copysets got error code: " << updateCode;
+        return false;
+    }
+    return true;
+}
+
+bool TopoUpdater::NeedUpdateTopo(const CopySetInfo &reportCopySetInfo) {
     CopySetInfo recordCopySetInfo;
     if (!topo_->GetCopySet(
         reportCopySetInfo.GetCopySetKey(), &recordCopySetInfo)) {
@@ -34,7 +79,7 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                    << reportCopySetInfo.GetLogicalPoolId()
                    << "," << reportCopySetInfo.GetId()
                    << ") information, but can not get info from topology";
-        return;
+        return false;
     }
     // here we compare epoch number reported by heartbeat and stored in mds
     // record, and there're three possible cases:
@@ -84,7 +129,7 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                        << recordCopySetInfo.GetCopySetMembersStr()
                        << ", but epoch is same: "
                        << recordCopySetInfo.GetEpoch();
-            return;
+            return false;
         }
 
         // no configuration changes in heartbeat report (no candidate)
@@ -124,25 +169,10 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                    << "), record epoch:" << recordCopySetInfo.GetEpoch()
                    << " bigger than report epoch:"
                    << reportCopySetInfo.GetEpoch();
-        return;
+        return false;
     }
 
-    // update changes to database and RAM
-    if (needUpdate) {
-        LOG(INFO) << "topoUpdater find copyset("
-                  << reportCopySetInfo.GetLogicalPoolId() << ","
-                  << reportCopySetInfo.GetId() << ") need to update";
-
-        int updateCode =
-            topo_->UpdateCopySetTopo(reportCopySetInfo);
-        if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
-            LOG(ERROR) << "topoUpdater update copyset("
-                       << reportCopySetInfo.GetLogicalPoolId()
-                       << "," << reportCopySetInfo.GetId()
-                       << ") got error code: " << updateCode;
-            return;
-        }
-    }
+    return needUpdate;
 }
 }  // namespace heartbeat
 }  // namespace mds
@@ -24,6 +24,7 @@
 #define SRC_MDS_HEARTBEAT_TOPO_UPDATER_H_
 
 #include <memory>
+#include <vector>
 #include "src/mds/topology/topology_item.h"
 #include "src/mds/topology/topology.h"
 
@@ -46,7 +47,26 @@ class TopoUpdater {
     */
     void UpdateTopo(const CopySetInfo &reportCopySetInfo);
 
+   /*
+    * @brief UpdateTopo update copysets reported by leaders in one heartbeat.
+    *                   copysets need to update are applied to topology in
+    *                   a batch, so that the copyset map lock is only
+    *                   acquired once
+    * @param[in] reportCopySetInfos copysets info reported by chunkserver
+    * @return false if failed to apply the updates to topology
+    */
+    bool UpdateTopo(const std::vector<CopySetInfo> &reportCopySetInfos);
+
  private:
+   /*
+    * @brief NeedUpdateTopo compare reported copyset with the one recorded
+    *                       in topology
+    * @param[in] reportCopySetInfo copyset info reported by chunkserver
+    * @return true if the record in topology falls behind and need update
+    */
+    bool NeedUpdateTopo(const CopySetInfo &reportCopySetInfo);
+
+
     std::shared_ptr<Topology> topo_;
 };
 }  // namespace heartbeat
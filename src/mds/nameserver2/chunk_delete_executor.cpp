@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/mds/nameserver2/chunk_delete_executor.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <utility>
+
+using ::curve::common::LockGuard;
+using ::curve::common::UniqueLock;
+using ::curve::common::LeakyBucket;
+
+namespace curve {
+namespace mds {
+
+ChunkDeleteExecutor::ChunkDeleteExecutor(
+    std::shared_ptr<CopysetClient> copysetClient,
+    const ChunkDeleteOption &option)
+    : copysetClient_(copysetClient),
+      option_(option),
+      running_(false),
+      batchSupported_(true) {
+    option_.maxInflightPerTask = std::max(option_.maxInflightPerTask, 1u);
+    option_.maxInflightPerCopyset =
+        std::max(option_.maxInflightPerCopyset, 1u);
+    option_.batchSize = std::max(option_.batchSize, 1u);
+    option_.segmentWindow = std::max(option_.segmentWindow, 1u);
+}
+
+ChunkDeleteExecutor::~ChunkDeleteExecutor() {
+    Stop();
+}
+
+int ChunkDeleteExecutor::Start() {
+    if (option_.deleteChunkRateLimit > 0 && throttle_ == nullptr) {
+        throttle_.reset(new LeakyBucket("mds_clean_chunk_delete"));
+        if (!throttle_->SetLimit(option_.deleteChunkRateLimit, 0, 0)) {
+            LOG(ERROR) << "ChunkDeleteExecutor set delete rate limit fail, "
+                       << "limit = " << option_.deleteChunkRateLimit;
+            throttle_.reset();
+            return -1;
+        }
+    }
+
+    if (option_.threadNum > 0 && !running_.exchange(true)) {
+        if (0 != pool_.Start(option_.threadNum)) {
+            LOG(ERROR) << "ChunkDeleteExecutor start thread pool fail";
+            running_.store(false);
+            return -1;
+        }
+    }
+
+    LOG(INFO) << "ChunkDeleteExecutor start, threadNum = "
+              << option_.threadNum
+              << ", maxInflightPerTask = " << option_.maxInflightPerTask
+              << ", maxInflightPerCopyset = " << option_.maxInflightPerCopyset
+              << ", batchSize = " << option_.batchSize
+              << ", deleteChunkRateLimit = " << option_.deleteChunkRateLimit
+              << ", segmentWindow = " << option_.segmentWindow;
+    return 0;
+}
+
+void ChunkDeleteExecutor::Stop() {
+    if (running_.exchange(false)) {
+        pool_.Stop();
+    }
+    if (throttle_ != nullptr) {
+        throttle_->Stop();
+    }
+}
+
+int ChunkDeleteExecutor::DeleteChunks(
+    const std::vector<PageFileSegment> &segments, uint64_t sn) {
+    return DoDelete(SplitBatches(segments), false, sn);
+}
+
+int ChunkDeleteExecutor::DeleteChunkSnapshots(
+    const std::vector<PageFileSegment> &segments, uint64_t correctedSn) {
+    return DoDelete(SplitBatches(segments), true, correctedSn);
+}
+
+std::vector<ChunkDeleteExecutor::DeleteBatch>
+ChunkDeleteExecutor::SplitBatches(
+    const std::vector<PageFileSegment> &segments) const {
+    std::map<CopySetKey, std::vector<ChunkID>> copysetChunks;
+    for (const auto &segment : segments) {
+        for (const auto &chunk : segment.chunks()) {
+            copysetChunks[CopySetKey(segment.logicalpoolid(),
+                                     chunk.copysetid())]
+                .push_back(chunk.chunkid());
+        }
+    }
+
+    // 每个copyset的第i个请求排在一起，使相邻的请求落在不同的copyset上
+    std::vector<DeleteBatch> batches;
+    for (size_t offset = 0; !copysetChunks.empty();
+         offset += option_.batchSize) {
+        for (auto it = copysetChunks.begin(); it != copysetChunks.end();) {
+            const std::vector<ChunkID> &chunkIds = it->second;
+            size_t end = std::min(chunkIds.size(),
+                                  offset + option_.batchSize);
+            DeleteBatch batch;
+            batch.logicalPoolId = it->first.first;
+            batch.copysetId = it->first.second;
+            batch.chunkIds.assign(chunkIds.begin() + offset,
+                                  chunkIds.begin() + end);
+            batches.emplace_back(std::move(batch));
+            if (end == chunkIds.size()) {
+                it = copysetChunks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return batches;
+}
+
+int ChunkDeleteExecutor::DoDelete(const std::vector<DeleteBatch> &batches,
+                                  bool snapshot, uint64_t sn) {
+    if (!running_.load()) {
+        for (const auto &batch : batches) {
+            if (throttle_ != nullptr) {
+                throttle_->Add(batch.chunkIds.size());
+            }
+            int ret = ExecuteBatch(batch, snapshot, sn);
+            if (ret != kMdsSuccess) {
+                return ret;
+            }
+        }
+        return kMdsSuccess;
+    }
+
+    DeleteTracker tracker;
+    for (const auto &batch : batches) {
+        CopySetKey key(batch.logicalPoolId, batch.copysetId);
+        {
+            UniqueLock lk(mutex_);
+            cond_.wait(lk, [&]() {
+                if (tracker.ret != kMdsSuccess) {
+                    return true;
+                }
+                if (tracker.inflight >= option_.maxInflightPerTask) {
+                    return false;
+                }
+                auto it = copysetInflight_.find(key);
+                return it == copysetInflight_.end() ||
+                       it->second < option_.maxInflightPerCopyset;
+            });
+            if (tracker.ret != kMdsSuccess) {
+                break;
+            }
+            tracker.inflight++;
+            copysetInflight_[key]++;
+        }
+
+        if (throttle_ != nullptr) {
+            throttle_->Add(batch.chunkIds.size());
+        }
+        const DeleteBatch *batchPtr = &batch;
+        DeleteTracker *trackerPtr = &tracker;
+        pool_.Enqueue([this, batchPtr, trackerPtr, key, snapshot, sn]() {
+            int ret = ExecuteBatch(*batchPtr, snapshot, sn);
+            OnBatchDone(key, trackerPtr, ret);
+        });
+    }
+
+    // batches和tracker在请求返回前都需要有效
+    UniqueLock lk(mutex_);
+    cond_.wait(lk, [&]() { return tracker.inflight == 0; });
+    return tracker.ret;
+}
+
+int ChunkDeleteExecutor::ExecuteBatch(const DeleteBatch &batch,
+                                      bool snapshot, uint64_t sn) {
+    int ret = kMdsSuccess;
+    if (!snapshot && batch.chunkIds.size() > 1 && batchSupported_.load()) {
+        ret = copysetClient_->DeleteChunkBatch(batch.logicalPoolId,
+                                               batch.copysetId,
+                                               batch.chunkIds,
+                                               sn);
+        if (ret != kCsClientNotSupport) {
+            if (ret != kMdsSuccess) {
+                LOG(ERROR) << "DeleteChunkBatch fail, ret = " << ret
+                           << ", logicalPoolId = " << batch.logicalPoolId
+                           << ", copysetId = " << batch.copysetId
+                           << ", chunk num = " << batch.chunkIds.size()
+                           << ", sn = " << sn;
+            }
+            return ret;
+        }
+
+        // 集群中还有未升级的chunkserver，之后都使用单chunk的删除接口
+        LOG(WARNING) << "DeleteChunkBatch is not supported by chunkserver, "
+                     << "fall back to DeleteChunk"
+                     << ", logicalPoolId = " << batch.logicalPoolId
+                     << ", copysetId = " << batch.copysetId;
+        batchSupported_.store(false);
+    }
+
+    for (ChunkID chunkId : batch.chunkIds) {
+        if (snapshot) {
+            ret = copysetClient_->DeleteChunkSnapshotOrCorrectSn(
+                batch.logicalPoolId, batch.copysetId, chunkId, sn);
+        } else {
+            ret = copysetClient_->DeleteChunk(
+                batch.logicalPoolId, batch.copysetId, chunkId, sn);
+        }
+        if (ret != kMdsSuccess) {
+            LOG(ERROR) << (snapshot ? "DeleteChunkSnapshotOrCorrectSn"
+                                    : "DeleteChunk")
+                       << " fail, ret = " << ret
+                       << ", logicalPoolId = " << batch.logicalPoolId
+                       << ", copysetId = " << batch.copysetId
+                       << ", chunkId = " << chunkId
+                       << ", sn = " << sn;
+            return ret;
+        }
+    }
+    return kMdsSuccess;
+}
+
+void ChunkDeleteExecutor::OnBatchDone(const CopySetKey &key,
+                                      DeleteTracker *tracker, int ret) {
+    LockGuard lk(mutex_);
+    tracker->inflight--;
+    if (ret != kMdsSuccess && tracker->ret == kMdsSuccess) {
+        tracker->ret = ret;
+    }
+    auto it = copysetInflight_.find(key);
+    if (it != copysetInflight_.end() && --it->second == 0) {
+        copysetInflight_.erase(it);
+    }
+    cond_.notify_all();
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_CHUNK_DELETE_EXECUTOR_H_
+#define SRC_MDS_NAMESERVER2_CHUNK_DELETE_EXECUTOR_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "proto/nameserver2.pb.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/leaky_bucket.h"
+#include "src/mds/chunkserverclient/copyset_client.h"
+#include "src/mds/common/mds_define.h"
+#include "src/mds/topology/topology_item.h"
+
+using ::curve::mds::chunkserverclient::CopysetClient;
+using ::curve::mds::topology::CopySetKey;
+
+namespace curve {
+namespace mds {
+
+struct ChunkDeleteOption {
+    // 执行删除请求的线程数，为0时在清理任务自身的线程中串行删除
+    uint32_t threadNum;
+    // 单个清理任务同时在途的删除请求数上限
+    uint32_t maxInflightPerTask;
+    // 单个copyset同时在途的删除请求数上限，所有清理任务共享
+    uint32_t maxInflightPerCopyset;
+    // 一个批量删除请求中的chunk数，为1时使用单chunk的删除接口，
+    // chunkserver不支持批量删除时也会退回到单chunk的删除接口
+    uint32_t batchSize;
+    // 每秒删除的chunk数上限，所有清理任务共享，为0时不限速
+    uint64_t deleteChunkRateLimit;
+    // 清理任务每次加载并一起删除的segment数
+    uint32_t segmentWindow;
+
+    ChunkDeleteOption()
+        : threadNum(0),
+          maxInflightPerTask(1),
+          maxInflightPerCopyset(1),
+          batchSize(1),
+          deleteChunkRateLimit(0),
+          segmentWindow(1) {}
+};
+
+/**
+ * ChunkDeleteExecutor 负责清理任务中chunk的并发删除
+ * 1. 将一批segment中的chunk按copyset分组，每组再按batchSize切分成删除请求
+ * 2. 在线程池中并发执行删除请求，分别限制单个任务和单个copyset的在途请求数
+ * 3. 按chunk数全局限速，避免清理影响前台IO
+ */
+class ChunkDeleteExecutor {
+ public:
+    ChunkDeleteExecutor(std::shared_ptr<CopysetClient> copysetClient,
+                        const ChunkDeleteOption &option);
+
+    ~ChunkDeleteExecutor();
+
+    /**
+     * @brief 启动删除线程池
+     * @return 成功返回0，失败返回-1
+     */
+    int Start();
+
+    /**
+     * @brief 停止删除线程池
+     */
+    void Stop();
+
+    /**
+     * @brief 删除segment中所有的chunk，阻塞直到全部请求返回
+     * @param segments: 要删除的segment
+     * @param sn: 文件的版本号
+     * @return 全部成功返回kMdsSuccess，否则返回第一个失败请求的错误码
+     */
+    int DeleteChunks(const std::vector<PageFileSegment> &segments,
+                     uint64_t sn);
+
+    /**
+     * @brief 删除segment中所有chunk的快照或修正chunk的correctedSn，
+     *        阻塞直到全部请求返回
+     * @param segments: 快照文件对应的segment
+     * @param correctedSn: chunk不存在快照时需要修正的版本号
+     * @return 全部成功返回kMdsSuccess，否则返回第一个失败请求的错误码
+     */
+    int DeleteChunkSnapshots(const std::vector<PageFileSegment> &segments,
+                             uint64_t correctedSn);
+
+    const ChunkDeleteOption &GetOption() const {
+        return option_;
+    }
+
+ private:
+    // 同一个copyset上的一组chunk，对应一次删除请求
+    struct DeleteBatch {
+        LogicalPoolID logicalPoolId;
+        CopysetID copysetId;
+        std::vector<ChunkID> chunkIds;
+    };
+
+    // 单次DeleteChunks/DeleteChunkSnapshots调用的执行状态
+    struct DeleteTracker {
+        uint32_t inflight = 0;
+        int ret = kMdsSuccess;
+    };
+
+    /**
+     * @brief 将segment中的chunk按copyset分组切分成删除请求，
+     *        不同copyset的请求交错排列，避免等待单个copyset的配额
+     */
+    std::vector<DeleteBatch> SplitBatches(
+        const std::vector<PageFileSegment> &segments) const;
+
+    int DoDelete(const std::vector<DeleteBatch> &batches,
+                 bool snapshot, uint64_t sn);
+
+    int ExecuteBatch(const DeleteBatch &batch, bool snapshot, uint64_t sn);
+
+    void OnBatchDone(const CopySetKey &key, DeleteTracker *tracker, int ret);
+
+ private:
+    std::shared_ptr<CopysetClient> copysetClient_;
+    ChunkDeleteOption option_;
+
+    ::curve::common::TaskThreadPool<> pool_;
+    // 线程池是否在运行，未运行时在调用者线程中串行删除
+    ::curve::common::Atomic<bool> running_;
+    std::unique_ptr<::curve::common::LeakyBucket> throttle_;
+    // chunkserver不支持批量删除时置为false，之后按chunk逐个删除
+    ::curve::common::Atomic<bool> batchSupported_;
+
+    // 保护tracker和copysetInflight_
+    ::curve::common::Mutex mutex_;
+    ::curve::common::ConditionVariable cond_;
+    std::map<CopySetKey, uint32_t> copysetInflight_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_CHUNK_DELETE_EXECUTOR_H_
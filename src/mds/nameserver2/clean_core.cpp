@@ -32,15 +32,21 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
     }
     uint32_t  segmentNum = fileInfo.length() / fileInfo.segmentsize();
     uint64_t segmentSize = fileInfo.segmentsize();
+    uint32_t segmentWindow = chunkDeleter_->GetOption().segmentWindow;
+    // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
+    // 防止删除快照后，后续的写触发chunk的快照
+    // correctSn为创建快照后文件的版本号，也就是快照版本号+1
+    SeqNum correctSn = fileInfo.seqnum() + 1;
+    std::vector<PageFileSegment> segments;
     for (uint32_t i = 0; i < segmentNum; i++) {
         // load  segment
         PageFileSegment segment;
         StoreStatus storeRet = storage_->GetSegment(fileInfo.parentid(),
                                                     i * segmentSize,
                                                     &segment);
-        if (storeRet == StoreStatus::KeyNotExist) {
-            continue;
-        } else if (storeRet !=  StoreStatus::OK) {
+        if (storeRet == StoreStatus::OK) {
+            segments.push_back(segment);
+        } else if (storeRet != StoreStatus::KeyNotExist) {
             LOG(ERROR) << "cleanSnapShot File Error: "
             << "GetSegment Error, inodeid = " << fileInfo.id()
             << ", filename = " << fileInfo.filename()
@@ -50,19 +56,14 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
             return StatusCode::kSnapshotFileDeleteError;
         }
 
+        if (segments.size() < segmentWindow && i + 1 != segmentNum) {
+            continue;
+        }
+
         // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
-            // 防止删除快照后，后续的写触发chunk的快照
-            // correctSn为创建快照后文件的版本号，也就是快照版本号+1
-            SeqNum correctSn = fileInfo.seqnum() + 1;
-            int ret = copysetClient_->DeleteChunkSnapshotOrCorrectSn(
-                logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                correctSn);
+        if (!segments.empty()) {
+            int ret = chunkDeleter_->DeleteChunkSnapshots(segments,
+                                                          correctSn);
             if (ret != 0) {
                 LOG(ERROR) << "CleanSnapShotFile Error: "
                     << "DeleteChunkSnapshotOrCorrectSn Error"
@@ -73,6 +74,7 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
                 progress->SetStatus(TaskStatus::FAILED);
                 return StatusCode::kSnapshotFileDeleteError;
             }
+            segments.clear();
         }
         progress->SetProgress(100 * (i+1) / segmentNum);
     }
@@ -104,14 +106,18 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
 
     int  segmentNum = commonFile.length() / commonFile.segmentsize();
     uint64_t segmentSize = commonFile.segmentsize();
+    uint32_t segmentWindow = chunkDeleter_->GetOption().segmentWindow;
+    std::vector<PageFileSegment> segments;
+    std::vector<uint64_t> offsets;
     for (int i = 0; i != segmentNum; i++) {
         // load  segment
         PageFileSegment segment;
         StoreStatus storeRet = storage_->GetSegment(commonFile.id(),
                                     i * segmentSize, &segment);
-        if (storeRet == StoreStatus::KeyNotExist) {
-            continue;
-        } else if (storeRet !=  StoreStatus::OK) {
+        if (storeRet == StoreStatus::OK) {
+            segments.push_back(segment);
+            offsets.push_back(i * segmentSize);
+        } else if (storeRet != StoreStatus::KeyNotExist) {
             LOG(ERROR) << "Clean common File Error: "
                 << "GetSegment Error, inodeid = " << commonFile.id()
                 << ", filename = " << commonFile.filename()
@@ -120,42 +126,19 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
             return StatusCode::kCommonFileDeleteError;
         }
 
-        // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            SeqNum seq = commonFile.seqnum();
-            int ret = copysetClient_->DeleteChunk(logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                seq);
-            if (ret != 0) {
-                LOG(ERROR) << "Clean common File Error: "
-                    << "DeleteChunk Error"
-                    << ", ret = " << ret
-                    << ", inodeid = " << commonFile.id()
-                    << ", filename = " << commonFile.filename()
-                    << ", sequenceNum = " << seq;
-                progress->SetStatus(TaskStatus::FAILED);
-                return StatusCode::kCommonFileDeleteError;
-            }
+        if (segments.size() < segmentWindow && i + 1 != segmentNum) {
+            continue;
         }
 
-        // delete segment
-        int64_t revision;
-        storeRet = storage_->DeleteSegment(
-            commonFile.id(), i * segmentSize, &revision);
-        if (storeRet != StoreStatus::OK) {
-            LOG(ERROR) << "Clean common File Error: "
-            << "DeleteSegment Error, inodeid = " << commonFile.id()
-            << ", filename = " << commonFile.filename()
-            << ", offset = " << i * segmentSize
-            << ", sequenceNum = " << commonFile.seqnum();
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kCommonFileDeleteError;
+        if (!segments.empty()) {
+            StatusCode ret = CleanFileSegments(commonFile, segments, offsets);
+            if (ret != StatusCode::kOK) {
+                progress->SetStatus(TaskStatus::FAILED);
+                return ret;
+            }
+            segments.clear();
+            offsets.clear();
         }
-        allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
-            segment.segmentsize(), revision);
         progress->SetProgress(100 * (i + 1) / segmentNum);
     }
 
@@ -176,5 +159,40 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
     progress->SetStatus(TaskStatus::SUCCESS);
     return StatusCode::kOK;
 }
+
+StatusCode CleanCore::CleanFileSegments(const FileInfo & commonFile,
+    const std::vector<PageFileSegment> &segments,
+    const std::vector<uint64_t> &offsets) {
+    // delete chunks in chunkserver
+    SeqNum seq = commonFile.seqnum();
+    int ret = chunkDeleter_->DeleteChunks(segments, seq);
+    if (ret != 0) {
+        LOG(ERROR) << "Clean common File Error: "
+            << "DeleteChunk Error"
+            << ", ret = " << ret
+            << ", inodeid = " << commonFile.id()
+            << ", filename = " << commonFile.filename()
+            << ", sequenceNum = " << seq;
+        return StatusCode::kCommonFileDeleteError;
+    }
+
+    // delete segment, 作为清理进度持久化，mds切换后从未删除的segment继续
+    for (size_t i = 0; i < segments.size(); i++) {
+        int64_t revision;
+        StoreStatus storeRet = storage_->DeleteSegment(
+            commonFile.id(), offsets[i], &revision);
+        if (storeRet != StoreStatus::OK) {
+            LOG(ERROR) << "Clean common File Error: "
+            << "DeleteSegment Error, inodeid = " << commonFile.id()
+            << ", filename = " << commonFile.filename()
+            << ", offset = " << offsets[i]
+            << ", sequenceNum = " << commonFile.seqnum();
+            return StatusCode::kCommonFileDeleteError;
+        }
+        allocStatistic_->DeAllocSpace(segments[i].logicalpoolid(),
+            segments[i].segmentsize(), revision);
+    }
+    return StatusCode::kOK;
+}
 }  // namespace mds
 }  // namespace curve
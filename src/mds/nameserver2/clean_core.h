@@ -24,12 +24,14 @@
 #define SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 
 #include <memory>
+#include <vector>
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/task_progress.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "src/mds/topology/topology.h"
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic.h"
+#include "src/mds/nameserver2/chunk_delete_executor.h"
 
 using ::curve::mds::chunkserverclient::CopysetClient;
 using ::curve::mds::topology::Topology;
@@ -44,7 +46,18 @@ class CleanCore {
         std::shared_ptr<AllocStatistic> allocStatistic)
         : storage_(storage),
           copysetClient_(copysetClient),
-          allocStatistic_(allocStatistic) {}
+          allocStatistic_(allocStatistic),
+          chunkDeleter_(std::make_shared<ChunkDeleteExecutor>(
+              copysetClient, ChunkDeleteOption())) {}
+
+    CleanCore(std::shared_ptr<NameServerStorage> storage,
+        std::shared_ptr<CopysetClient> copysetClient,
+        std::shared_ptr<AllocStatistic> allocStatistic,
+        std::shared_ptr<ChunkDeleteExecutor> chunkDeleter)
+        : storage_(storage),
+          copysetClient_(copysetClient),
+          allocStatistic_(allocStatistic),
+          chunkDeleter_(chunkDeleter) {}
 
     /**
      * @brief 删除快照文件，更新task状态
@@ -61,14 +74,29 @@ class CleanCore {
      * @param progress: CleanFile接口属于时间较长的偏异步任务
      *                  这里传入进度进行跟踪反馈
      * @return 是否执行成功，成功返回StatusCode::kOK
+     * chunk删除成功后才删除对应的segment，mds切换后重新执行清理时
+     * 已删除的segment会被跳过，从上次的进度继续
      */
     StatusCode CleanFile(const FileInfo & commonFile,
                         TaskProgress* progress);
 
  private:
+    /**
+     * @brief 删除一批segment中的chunk，成功后删除segment元数据
+     * @param commonFile: 需要清理的普通文件
+     * @param segments: 本次要清理的segment
+     * @param offsets: segment在文件中的偏移，与segments一一对应
+     * @return 是否执行成功，成功返回StatusCode::kOK
+     */
+    StatusCode CleanFileSegments(const FileInfo & commonFile,
+        const std::vector<PageFileSegment> &segments,
+        const std::vector<uint64_t> &offsets);
+
+
     std::shared_ptr<NameServerStorage> storage_;
     std::shared_ptr<CopysetClient> copysetClient_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
+    std::shared_ptr<ChunkDeleteExecutor> chunkDeleter_;
 };
 
 }  // namespace mds
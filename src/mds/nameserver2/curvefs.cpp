@@ -1477,6 +1477,90 @@ StatusCode CurveFS::GetSnapShotFileSegment(
     }
 }
 
+StatusCode CurveFS::ListSegment(const std::string &fileName,
+                                FileSeqType seq,
+                                offset_t startOffset,
+                                uint32_t limit,
+                                std::vector<PageFileSegment> *segments,
+                                offset_t *nextOffset,
+                                FileInfo *fileInfo) {
+    assert(segments != nullptr);
+    assert(nextOffset != nullptr);
+    assert(fileInfo != nullptr);
+    segments->clear();
+    *nextOffset = 0;
+
+    if (limit == 0) {
+        limit = kListSegmentDefaultLimit;
+    } else if (limit > kListSegmentMaxLimit) {
+        limit = kListSegmentMaxLimit;
+    }
+
+    FileInfo originFileInfo;
+    StatusCode ret = GetFileInfo(fileName, &originFileInfo);
+    if (ret != StatusCode::kOK) {
+        LOG(WARNING) << "ListSegment get file info fail, fileName = "
+                     << fileName << ", ret = " << ret;
+        return ret;
+    }
+
+    if (originFileInfo.filetype() != FileType::INODE_PAGEFILE) {
+        LOG(WARNING) << "ListSegment file type not supported, fileName = "
+                     << fileName
+                     << ", fileType = " << originFileInfo.filetype();
+        return StatusCode::kNotSupported;
+    }
+
+    // 快照与原文件共用segment，只列出快照时文件长度以内的部分
+    if (seq != 0) {
+        ret = GetSnapShotFileInfo(fileName, seq, fileInfo);
+        if (ret != StatusCode::kOK) {
+            LOG(WARNING) << "ListSegment get snapshot file info fail, "
+                         << "fileName = " << fileName << ", seq = " << seq
+                         << ", ret = " << ret;
+            return ret;
+        }
+    } else {
+        *fileInfo = originFileInfo;
+    }
+
+    if (startOffset % originFileInfo.segmentsize() != 0) {
+        LOG(WARNING) << "ListSegment offset not align with segment, fileName = "
+                     << fileName << ", startOffset = " << startOffset
+                     << ", segmentsize = " << originFileInfo.segmentsize();
+        return StatusCode::kParaError;
+    }
+
+    uint64_t length = fileInfo->length();
+    if (startOffset >= length) {
+        return StatusCode::kOK;
+    }
+
+    StoreStatus storeRet = storage_->ListSegmentWithLimit(
+        originFileInfo.id(), startOffset, limit, segments);
+    if (storeRet != StoreStatus::OK) {
+        LOG(ERROR) << "ListSegment fail, fileName = " << fileName
+                   << ", id = " << originFileInfo.id()
+                   << ", startOffset = " << startOffset
+                   << ", limit = " << limit << ", ret = " << storeRet;
+        segments->clear();
+        return StatusCode::kStorageError;
+    }
+
+    bool truncated = false;
+    while (!segments->empty() && segments->back().startoffset() >= length) {
+        segments->pop_back();
+        truncated = true;
+    }
+
+    if (!truncated && segments->size() == limit) {
+        offset_t next = segments->back().startoffset() +
+                        originFileInfo.segmentsize();
+        *nextOffset = next < length ? next : 0;
+    }
+    return StatusCode::kOK;
+}
+
 StatusCode CurveFS::OpenFile(const std::string &fileName,
                              const std::string &clientIP,
                              ProtoSession *protoSession,
@@ -2120,28 +2204,41 @@ StatusCode CurveFS::ListCloneSourceFileSegments(
         return ret;
     }
 
-    std::vector<PageFileSegment> segments;
-    StoreStatus status =
-        storage_->ListSegment(cloneSourceFileInfo.id(), &segments);
-    if (status != StoreStatus::OK) {
-        LOG(ERROR) << "OpenFile failed, list clone source segment failed, "
-                      "filename = "
-                   << fileInfo->filename()
-                   << ", source file name = " << fileInfo->clonesource()
-                   << ", ret = " << status;
-        return StatusCode::kStorageError;
+    // 分页加载源文件的segment，只保留offset，避免大卷一次加载全部segment
+    offset_t startOffset = 0;
+    while (true) {
+        std::vector<PageFileSegment> segments;
+        StoreStatus status = storage_->ListSegmentWithLimit(
+            cloneSourceFileInfo.id(), startOffset, kListSegmentDefaultLimit,
+            &segments);
+        if (status != StoreStatus::OK) {
+            LOG(ERROR) << "OpenFile failed, list clone source segment failed, "
+                          "filename = "
+                       << fileInfo->filename()
+                       << ", source file name = " << fileInfo->clonesource()
+                       << ", startOffset = " << startOffset
+                       << ", ret = " << status;
+            cloneSourceSegment->clear_allocatedsegmentoffset();
+            return StatusCode::kStorageError;
+        }
+
+        for (const auto& segment : segments) {
+            cloneSourceSegment->add_allocatedsegmentoffset(
+                segment.startoffset());
+        }
+
+        if (segments.size() < kListSegmentDefaultLimit) {
+            break;
+        }
+        startOffset = segments.back().startoffset() +
+                      cloneSourceFileInfo.segmentsize();
     }
 
     cloneSourceSegment->set_segmentsize(fileInfo->segmentsize());
 
-    if (segments.empty()) {
+    if (cloneSourceSegment->allocatedsegmentoffset_size() == 0) {
         LOG(WARNING) << "Clone source file has no segments, filename = "
                      << fileInfo->clonesource();
-    } else {
-        for (const auto& segment : segments) {
-            cloneSourceSegment->add_allocatedsegmentoffset(
-                segment.startoffset());
-        }
     }
 
     return StatusCode::kOK;
@@ -2176,28 +2273,39 @@ StatusCode CurveFS::ListVolumesOnCopyset(
         copysetMap[copyset.logicalpoolid()].insert(copyset.copysetid());
     }
     for (const auto& file : files) {
-        std::vector<PageFileSegment> segments;
-        StoreStatus ret = storage_->ListSegment(file.id(), &segments);
-        if (ret != StoreStatus::OK) {
-            LOG(ERROR) << "List segments of " << file.filename() << " fail";
-            return StatusCode::kStorageError;
-        }
+        // 分页遍历segment，找到第一个在指定copyset上的chunk即停止
         bool found = false;
-        for (const auto& segment : segments) {
-            if (copysetMap.find(segment.logicalpoolid()) == copysetMap.end()) {
-                continue;
+        offset_t startOffset = 0;
+        while (!found) {
+            std::vector<PageFileSegment> segments;
+            StoreStatus ret = storage_->ListSegmentWithLimit(
+                file.id(), startOffset, kListSegmentDefaultLimit, &segments);
+            if (ret != StoreStatus::OK) {
+                LOG(ERROR) << "List segments of " << file.filename()
+                           << " fail";
+                return StatusCode::kStorageError;
             }
-            for (int i = 0; i < segment.chunks_size(); i++) {
-                auto copysetId = segment.chunks(i).copysetid();
-                if (copysetMap[segment.logicalpoolid()].count(copysetId) != 0) {
-                    fileNames->emplace_back(file.filename());
-                    found = true;
+            for (const auto& segment : segments) {
+                auto iter = copysetMap.find(segment.logicalpoolid());
+                if (iter == copysetMap.end()) {
+                    continue;
+                }
+                for (int i = 0; i < segment.chunks_size(); i++) {
+                    auto copysetId = segment.chunks(i).copysetid();
+                    if (iter->second.count(copysetId) != 0) {
+                        fileNames->emplace_back(file.filename());
+                        found = true;
+                        break;
+                    }
+                }
+                if (found) {
                     break;
                 }
             }
-            if (found) {
+            if (segments.size() < kListSegmentDefaultLimit) {
                 break;
             }
+            startOffset = segments.back().startoffset() + file.segmentsize();
         }
     }
     return StatusCode::kOK;
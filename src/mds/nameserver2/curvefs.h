@@ -348,6 +348,27 @@ class CurveFS {
             offset_t offset,
             PageFileSegment *segment);
 
+    /**
+     *  @brief list the allocated segments of the file or its snapshot
+     *         in offset order, at most limit segments one time
+     *  @param filename
+     *  @param seq: sequence of the snapshot, 0 means the file itself
+     *  @param startOffset: offset to start with, must align with segment
+     *  @param limit: max number of segments to list
+     *  @param[out] segments: segments whose offset >= startOffset
+     *  @param[out] nextOffset: startOffset of the next page if there may be
+     *              more segments, otherwise 0
+     *  @param[out] fileInfo: info of the file or snapshot listed
+     *  @return StatusCode::kOK if succeeded
+     */
+    StatusCode ListSegment(const std::string &filename,
+                           FileSeqType seq,
+                           offset_t startOffset,
+                           uint32_t limit,
+                           std::vector<PageFileSegment> *segments,
+                           offset_t *nextOffset,
+                           FileInfo *fileInfo);
+
     // session ops
     /**
      *  @brief open file
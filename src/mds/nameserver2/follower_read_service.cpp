@@ -0,0 +1,370 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/mds/nameserver2/follower_read_service.h"
+
+#include <glog/logging.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "src/common/authenticator.h"
+#include "src/common/string_util.h"
+#include "src/common/timeutility.h"
+#include "src/mds/common/mds_define.h"
+#include "src/mds/nameserver2/namespace_service.h"
+
+using ::curve::common::Authenticator;
+using ::curve::common::ExpiredTime;
+using ::curve::common::TimeUtility;
+using ::curve::mds::topology::CopySetIdType;
+using ::curve::mds::topology::LogicalPoolIdType;
+
+namespace curve {
+namespace mds {
+
+FollowerReadService::FollowerReadService(
+    std::shared_ptr<NameServerStorage> storage,
+    const RootAuthOption &authOption)
+    : storage_(storage), authOption_(authOption) {}
+
+void FollowerReadService::GetFileInfo(
+                        ::google::protobuf::RpcController* controller,
+                        const ::curve::mds::GetFileInfoRequest* request,
+                        ::curve::mds::GetFileInfoResponse* response,
+                        ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", follower GetFileInfo request path is invalid, filename = "
+            << request->filename();
+        return;
+    }
+
+    StatusCode retCode = LookUpFileWithOwner(request->filename(),
+        request->owner(), request->signature(), request->date(),
+        response->mutable_fileinfo());
+    response->set_statuscode(retCode);
+    if (retCode != StatusCode::kOK) {
+        response->clear_fileinfo();
+        LOG_IF(ERROR, google::ERROR == GetMdsLogLevel(retCode))
+            << "logid = " << cntl->log_id()
+            << ", follower GetFileInfo fail, filename = "
+            << request->filename()
+            << ", owner = " << request->owner()
+            << ", statusCode = " << retCode
+            << ", StatusCode_Name = " << StatusCode_Name(retCode)
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+        return;
+    }
+    VLOG(3) << "logid = " << cntl->log_id()
+            << ", follower GetFileInfo ok, filename = " << request->filename()
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+}
+
+void FollowerReadService::ListDir(
+                        ::google::protobuf::RpcController* controller,
+                        const ::curve::mds::ListDirRequest* request,
+                        ::curve::mds::ListDirResponse* response,
+                        ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", follower ListDir request path is invalid, filename = "
+            << request->filename();
+        return;
+    }
+
+    FileInfo dirInfo;
+    StatusCode retCode = LookUpFileWithOwner(request->filename(),
+        request->owner(), request->signature(), request->date(), &dirInfo);
+    if (retCode == StatusCode::kOK) {
+        if (dirInfo.filetype() != FileType::INODE_DIRECTORY) {
+            retCode = StatusCode::kNotDirectory;
+        } else {
+            std::vector<FileInfo> files;
+            if (storage_->ListFile(dirInfo.id(), dirInfo.id() + 1, &files)
+                != StoreStatus::OK) {
+                retCode = StatusCode::kStorageError;
+            } else {
+                for (auto &file : files) {
+                    response->add_fileinfo()->Swap(&file);
+                }
+            }
+        }
+    } else if (retCode == StatusCode::kFileNotExists &&
+               request->owner() == authOption_.rootOwner) {
+        // same as the leader, whose ReadDir is not preceded by a
+        // path owner check for the root user
+        retCode = StatusCode::kDirNotExist;
+    }
+
+    response->set_statuscode(retCode);
+    if (retCode != StatusCode::kOK) {
+        LOG_IF(ERROR, google::ERROR == GetMdsLogLevel(retCode))
+            << "logid = " << cntl->log_id()
+            << ", follower ListDir fail, filename = " << request->filename()
+            << ", owner = " << request->owner()
+            << ", statusCode = " << retCode
+            << ", StatusCode_Name = " << StatusCode_Name(retCode)
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+        return;
+    }
+    VLOG(3) << "logid = " << cntl->log_id()
+            << ", follower ListDir ok, filename = " << request->filename()
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+}
+
+void FollowerReadService::ListVolumesOnCopysets(
+                ::google::protobuf::RpcController* controller,
+                const ::curve::mds::ListVolumesOnCopysetsRequest* request,
+                ::curve::mds::ListVolumesOnCopysetsResponse* response,
+                ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    std::vector<std::string> fileNames;
+    std::vector<common::CopysetInfo> copysets;
+    for (int i = 0; i < request->copysets_size(); i++) {
+        copysets.emplace_back(request->copysets(i));
+    }
+
+    StatusCode retCode = ListVolumesOnCopyset(copysets, &fileNames);
+    response->set_statuscode(retCode);
+    if (retCode != StatusCode::kOK) {
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", follower ListVolumesOnCopysets fail, statusCode = "
+            << retCode << ", StatusCode_Name = " << StatusCode_Name(retCode)
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+        return;
+    }
+    for (const auto& fileName : fileNames) {
+        response->add_filenames(fileName);
+    }
+    VLOG(3) << "logid = " << cntl->log_id()
+            << ", follower ListVolumesOnCopysets ok, volume num: "
+            << fileNames.size()
+            << ", cost " << expiredTime.ExpiredMs() << " ms";
+}
+
+StatusCode FollowerReadService::ListAllFiles(uint64_t inodeId,
+    std::vector<FileInfo>* files) const {
+    std::vector<FileInfo> tempFiles;
+    if (storage_->ListFile(inodeId, inodeId + 1, &tempFiles)
+        != StoreStatus::OK) {
+        return StatusCode::kStorageError;
+    }
+    for (const auto& file : tempFiles) {
+        if (file.filetype() == FileType::INODE_PAGEFILE) {
+            files->emplace_back(file);
+        } else if (file.filetype() == FileType::INODE_DIRECTORY) {
+            StatusCode ret = ListAllFiles(file.id(), files);
+            if (ret != StatusCode::kOK) {
+                LOG(ERROR) << "ListAllFiles in file " << inodeId << " fail";
+                return ret;
+            }
+        }
+    }
+    return StatusCode::kOK;
+}
+
+StatusCode FollowerReadService::ListVolumesOnCopyset(
+    const std::vector<common::CopysetInfo>& copysets,
+    std::vector<std::string>* fileNames) const {
+    std::vector<FileInfo> files;
+    StatusCode ret = ListAllFiles(ROOTINODEID, &files);
+    if (ret != StatusCode::kOK) {
+        LOG(ERROR) << "List all files in root directory fail";
+        return ret;
+    }
+    std::map<LogicalPoolIdType, std::set<CopySetIdType>> copysetMap;
+    for (const auto& copyset : copysets) {
+        copysetMap[copyset.logicalpoolid()].insert(copyset.copysetid());
+    }
+    for (const auto& file : files) {
+        // list the segments page by page, stop at the first chunk found
+        // on the copysets
+        bool found = false;
+        offset_t startOffset = 0;
+        while (!found) {
+            std::vector<PageFileSegment> segments;
+            if (storage_->ListSegmentWithLimit(file.id(), startOffset,
+                    kListSegmentDefaultLimit, &segments) != StoreStatus::OK) {
+                LOG(ERROR) << "List segments of " << file.filename()
+                           << " fail";
+                return StatusCode::kStorageError;
+            }
+            for (const auto& segment : segments) {
+                auto iter = copysetMap.find(segment.logicalpoolid());
+                if (iter == copysetMap.end()) {
+                    continue;
+                }
+                for (int i = 0; i < segment.chunks_size(); i++) {
+                    if (iter->second.count(segment.chunks(i).copysetid())) {
+                        fileNames->emplace_back(file.filename());
+                        found = true;
+                        break;
+                    }
+                }
+                if (found) {
+                    break;
+                }
+            }
+            if (segments.size() < kListSegmentDefaultLimit) {
+                break;
+            }
+            startOffset = segments.back().startoffset() + file.segmentsize();
+        }
+    }
+    return StatusCode::kOK;
+}
+
+StatusCode FollowerReadService::LookUpFileWithOwner(
+    const std::string &filename, const std::string &owner,
+    const std::string &signature, uint64_t date,
+    FileInfo *fileInfo) const {
+    if (owner.empty()) {
+        LOG(ERROR) << "file owner is empty, filename = " << filename;
+        return StatusCode::kOwnerAuthFail;
+    }
+
+    if (!CheckDate(date)) {
+        LOG(ERROR) << "check date fail, request is staled.";
+        return StatusCode::kOwnerAuthFail;
+    }
+
+    // root user is verified with signature and can read any file,
+    // other users must own every level of the path
+    bool isRoot = (owner == authOption_.rootOwner);
+    if (isRoot && !CheckSignature(owner, signature, date)) {
+        LOG(ERROR) << "check root owner fail, signature auth fail.";
+        return StatusCode::kOwnerAuthFail;
+    }
+
+    std::vector<std::string> paths;
+    ::curve::common::SplitString(filename, "/", &paths);
+    if (paths.empty()) {
+        if (!isRoot) {
+            return StatusCode::kOwnerAuthFail;
+        }
+        fileInfo->set_id(ROOTINODEID);
+        fileInfo->set_filename(ROOTFILENAME);
+        fileInfo->set_filetype(FileType::INODE_DIRECTORY);
+        fileInfo->set_owner(authOption_.rootOwner);
+        return StatusCode::kOK;
+    }
+
+    uint64_t parentID = ROOTINODEID;
+    for (uint32_t i = 0; i < paths.size(); i++) {
+        auto ret = storage_->GetFile(parentID, paths[i], fileInfo);
+        if (ret == StoreStatus::KeyNotExist) {
+            return StatusCode::kFileNotExists;
+        } else if (ret != StoreStatus::OK) {
+            LOG(ERROR) << "GetFile " << paths[i] << " error, errcode = "
+                       << ret;
+            return StatusCode::kStorageError;
+        }
+
+        bool isLast = (i + 1 == paths.size());
+        if (!isLast && fileInfo->filetype() != FileType::INODE_DIRECTORY) {
+            LOG(INFO) << fileInfo->filename() << " is not an directory";
+            return isRoot ? StatusCode::kFileNotExists
+                          : StatusCode::kNotDirectory;
+        }
+
+        if (!isRoot && fileInfo->owner() != owner) {
+            LOG(ERROR) << fileInfo->filename() << " auth fail, owner = "
+                       << owner;
+            return StatusCode::kOwnerAuthFail;
+        }
+        parentID = fileInfo->id();
+    }
+    return StatusCode::kOK;
+}
+
+bool FollowerReadService::CheckDate(uint64_t date) const {
+    uint64_t current = TimeUtility::GetTimeofDayUs();
+    uint64_t interval = (date > current) ? date - current : current - date;
+    return interval < kStaledRequestTimeIntervalUs;
+}
+
+bool FollowerReadService::CheckSignature(const std::string &owner,
+                                         const std::string &signature,
+                                         uint64_t date) const {
+    std::string str2sig = Authenticator::GetString2Signature(date, owner);
+    std::string sig = Authenticator::CalcString2Signature(str2sig,
+                                                authOption_.rootPassword);
+    return signature == sig;
+}
+
+int FollowerReadServer::Start(const std::string &listenAddr) {
+    if (started_) {
+        return 0;
+    }
+
+    if (server_.AddService(&service_,
+                           brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
+        LOG(ERROR) << "add follower read service fail";
+        return -1;
+    }
+    if (topology_ != nullptr &&
+        server_.AddService(&topologyService_,
+                           brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
+        LOG(ERROR) << "add follower topology service fail";
+        return -1;
+    }
+
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    if (server_.Start(listenAddr.c_str(), &option) != 0) {
+        LOG(ERROR) << "start follower read server fail, listen addr = "
+                   << listenAddr;
+        return -1;
+    }
+
+    started_ = true;
+    LOG(INFO) << "follower read server start, listen addr = " << listenAddr;
+    return 0;
+}
+
+void FollowerReadServer::Stop() {
+    if (!started_) {
+        return;
+    }
+    server_.Stop(0);
+    server_.Join();
+    started_ = false;
+    LOG(INFO) << "follower read server stopped";
+}
+
+}  // namespace mds
+}  // namespace curve
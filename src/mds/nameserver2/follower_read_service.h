@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_FOLLOWER_READ_SERVICE_H_
+#define SRC_MDS_NAMESERVER2_FOLLOWER_READ_SERVICE_H_
+
+#include <brpc/server.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "proto/nameserver2.pb.h"
+#include "src/mds/nameserver2/curvefs.h"
+#include "src/mds/nameserver2/namespace_storage.h"
+#include "src/mds/topology/topology_follower.h"
+
+namespace curve {
+namespace mds {
+
+struct FollowerReadOption {
+    // whether every mds serves metadata reads, leader or not
+    bool enable = false;
+    // the address the follower read service listens to
+    std::string listenAddr;
+    // max staleness of the metadata cached, 0 means always read from etcd
+    uint32_t maxStalenessMs = 0;
+    // max count of the metadata cached
+    int cacheCount = 0;
+    // whether the topology reads are served as well
+    bool topologyEnable = false;
+    // interval of reloading the topology from etcd, which bounds the
+    // staleness of the topology served
+    uint32_t topologyReloadIntervalMs = 1000;
+};
+
+/**
+ * FollowerReadService serves the read-only namespace requests on every mds.
+ * It reads the metadata from etcd directly instead of the leader's memory,
+ * so it can run before the mds wins the election. Only GetFileInfo,
+ * ListDir and ListVolumesOnCopysets are supported now, other requests fail
+ * with "not implemented" and should be sent to the leader.
+ */
+class FollowerReadService : public CurveFSService {
+ public:
+    FollowerReadService(std::shared_ptr<NameServerStorage> storage,
+                        const RootAuthOption &authOption);
+
+    void GetFileInfo(::google::protobuf::RpcController* controller,
+                     const ::curve::mds::GetFileInfoRequest* request,
+                     ::curve::mds::GetFileInfoResponse* response,
+                     ::google::protobuf::Closure* done) override;
+
+    void ListDir(::google::protobuf::RpcController* controller,
+                 const ::curve::mds::ListDirRequest* request,
+                 ::curve::mds::ListDirResponse* response,
+                 ::google::protobuf::Closure* done) override;
+
+    void ListVolumesOnCopysets(
+                ::google::protobuf::RpcController* controller,
+                const ::curve::mds::ListVolumesOnCopysetsRequest* request,
+                ::curve::mds::ListVolumesOnCopysetsResponse* response,
+                ::google::protobuf::Closure* done) override;
+
+ private:
+    /**
+     *  @brief walk the path and check the owner of every level at the same
+     *         time, with the same rules as CurveFS::CheckFileOwner
+     *  @param filename
+     *  @param owner
+     *  @param signature
+     *  @param date
+     *  @param[out] fileInfo: info of the file found
+     *  @return StatusCode::kOK if succeeded
+     */
+    StatusCode LookUpFileWithOwner(const std::string &filename,
+                                   const std::string &owner,
+                                   const std::string &signature,
+                                   uint64_t date,
+                                   FileInfo *fileInfo) const;
+
+    /**
+     *  @brief list the page files under the directory recursively,
+     *         same as CurveFS::ListAllFiles
+     */
+    StatusCode ListAllFiles(uint64_t inodeId,
+                            std::vector<FileInfo>* files) const;
+
+    /**
+     *  @brief same as CurveFS::ListVolumesOnCopyset
+     */
+    StatusCode ListVolumesOnCopyset(
+        const std::vector<common::CopysetInfo>& copysets,
+        std::vector<std::string>* fileNames) const;
+
+    bool CheckDate(uint64_t date) const;
+
+    bool CheckSignature(const std::string &owner,
+                        const std::string &signature,
+                        uint64_t date) const;
+
+ private:
+    std::shared_ptr<NameServerStorage> storage_;
+    RootAuthOption authOption_;
+};
+
+/**
+ * FollowerReadServer owns the brpc server of the follower read service,
+ * and of the follower topology service if a topology is given
+ */
+class FollowerReadServer {
+ public:
+    FollowerReadServer(std::shared_ptr<NameServerStorage> storage,
+                       const RootAuthOption &authOption,
+                       std::shared_ptr<topology::FollowerTopology> topology =
+                           nullptr)
+        : service_(storage, authOption), topology_(topology),
+          topologyService_(topology), started_(false) {}
+
+    ~FollowerReadServer() {
+        Stop();
+    }
+
+    /**
+     *  @brief start the brpc server at listenAddr
+     *  @return 0 if succeeded, -1 if failed
+     */
+    int Start(const std::string &listenAddr);
+
+    void Stop();
+
+ private:
+    FollowerReadService service_;
+    std::shared_ptr<topology::FollowerTopology> topology_;
+    topology::FollowerTopologyServiceImpl topologyService_;
+    brpc::Server server_;
+    bool started_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_FOLLOWER_READ_SERVICE_H_
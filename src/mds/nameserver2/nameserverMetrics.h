@@ -37,6 +37,14 @@ class NameserverCacheMetrics {
         cacheHit(NameServerMetricsPrefix, "cache_hit"),
         cacheMiss(NameServerMetricsPrefix, "cache_miss") {}
 
+    // constructor with the metric prefix, for more than one cache
+    explicit NameserverCacheMetrics(const std::string &prefix) :
+        NameServerMetricsPrefix(prefix),
+        cacheCount(NameServerMetricsPrefix, "cache_count"),
+        cacheBytes(NameServerMetricsPrefix, "cache_bytes"),
+        cacheHit(NameServerMetricsPrefix, "cache_hit"),
+        cacheMiss(NameServerMetricsPrefix, "cache_miss") {}
+
     void UpdateAddToCacheCount();
 
     void UpdateRemoveFromCacheCount();
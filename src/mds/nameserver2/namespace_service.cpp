@@ -1257,6 +1257,115 @@ void NameSpaceService::GetSnapShotFileSegment(
     return;
 }
 
+void NameSpaceService::ListSegment(
+                    ::google::protobuf::RpcController* controller,
+                    const ::curve::mds::ListSegmentRequest* request,
+                    ::curve::mds::ListSegmentResponse* response,
+                    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+              << ", ListSegment request path is invalid, filename = "
+              << request->filename();
+        return;
+    }
+
+    LOG(INFO) << "logid = " << cntl->log_id()
+              << ", ListSegment request, filename = " << request->filename()
+              << ", seqnum = " << request->seqnum()
+              << ", startOffset = " << request->startoffset()
+              << ", limit = " << request->limit();
+
+    FileReadLockGuard guard(fileLockManager_, request->filename());
+
+    std::string signature;
+    if (request->has_signature()) {
+        signature = request->signature();
+    }
+
+    StatusCode retCode;
+    retCode = kCurveFS.CheckFileOwner(request->filename(), request->owner(),
+                                      signature, request->date());
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        }
+        return;
+    }
+
+    std::vector<PageFileSegment> segments;
+    offset_t nextOffset = 0;
+    FileInfo fileInfo;
+    FileSeqType seq = request->has_seqnum() ? request->seqnum() : 0;
+    retCode = kCurveFS.ListSegment(request->filename(),
+                                   seq,
+                                   request->startoffset(),
+                                   request->limit(),
+                                   &segments,
+                                   &nextOffset,
+                                   &fileInfo);
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", ListSegment fail, filename = " << request->filename()
+                << ", seqnum = " << request->seqnum()
+                << ", startOffset = " << request->startoffset()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                << ", cost " << expiredTime.ExpiredMs() << " ms";
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", ListSegment fail, filename = " << request->filename()
+                << ", seqnum = " << request->seqnum()
+                << ", startOffset = " << request->startoffset()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                << ", cost " << expiredTime.ExpiredMs() << " ms";
+        }
+        return;
+    }
+
+    // 以定长数组返回chunk信息，segment大小和chunk大小在文件内一致，只返回一次
+    response->set_segmentsize(fileInfo.segmentsize());
+    response->set_chunksize(fileInfo.chunksize());
+    for (const auto &segment : segments) {
+        PackedSegment *packed = response->add_segments();
+        packed->set_startoffset(segment.startoffset());
+        packed->set_logicalpoolid(segment.logicalpoolid());
+        packed->mutable_chunkid()->Reserve(segment.chunks_size());
+        packed->mutable_copysetid()->Reserve(segment.chunks_size());
+        for (const auto &chunk : segment.chunks()) {
+            packed->add_chunkid(chunk.chunkid());
+            packed->add_copysetid(chunk.copysetid());
+        }
+    }
+    if (nextOffset != 0) {
+        response->set_nextoffset(nextOffset);
+    }
+    response->set_statuscode(StatusCode::kOK);
+    LOG(INFO) << "logid = " << cntl->log_id()
+              << ", ListSegment ok, filename = " << request->filename()
+              << ", seqnum = " << request->seqnum()
+              << ", startOffset = " << request->startoffset()
+              << ", segment num = " << segments.size()
+              << ", nextOffset = " << nextOffset
+              << ", cost " << expiredTime.ExpiredMs() << " ms";
+}
+
 void NameSpaceService::OpenFile(::google::protobuf::RpcController* controller,
                     const ::curve::mds::OpenFileRequest* request,
                     ::curve::mds::OpenFileResponse* response,
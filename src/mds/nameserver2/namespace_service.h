@@ -137,6 +137,11 @@ class NameSpaceService: public CurveFSService {
                        ::curve::mds::GetOrAllocateSegmentResponse* response,
                        ::google::protobuf::Closure* done);
 
+    void ListSegment(::google::protobuf::RpcController* controller,
+                       const ::curve::mds::ListSegmentRequest* request,
+                       ::curve::mds::ListSegmentResponse* response,
+                       ::google::protobuf::Closure* done) override;
+
     void OpenFile(::google::protobuf::RpcController* controller,
                        const ::curve::mds::OpenFileRequest* request,
                        ::curve::mds::OpenFileResponse* response,
@@ -411,6 +411,43 @@ StoreStatus NameServerStorageImp::ListSegment(InodeID id,
     return StoreStatus::OK;
 }
 
+StoreStatus NameServerStorageImp::ListSegmentWithLimit(InodeID id,
+                                    uint64_t startOffset,
+                                    uint32_t limit,
+                                    std::vector<PageFileSegment> *segments) {
+    // segment的key按(inodeid, offset)大端编码，同一文件的segment按offset有序
+    std::string startStoreKey =
+                NameSpaceStorageCodec::EncodeSegmentStoreKey(id, startOffset);
+    std::string endStoreKey =
+                NameSpaceStorageCodec::EncodeSegmentStoreKey(id + 1, 0);
+
+    std::vector<std::string> out;
+    std::string lastKey;
+    int errCode = client_->ListWithLimitAndRevision(
+        startStoreKey, endStoreKey, limit, 0, &out, &lastKey);
+
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "list segment with limit err:" << errCode
+                   << ", id = " << id << ", startOffset = " << startOffset
+                   << ", limit = " << limit;
+        return getErrorCode(errCode);
+    }
+
+    segments->reserve(segments->size() + out.size());
+    for (size_t i = 0; i < out.size(); i++) {
+        PageFileSegment segment;
+        bool decodeOK = NameSpaceStorageCodec::DecodeSegment(out[i],
+                                                             &segment);
+        if (decodeOK) {
+            segments->emplace_back(std::move(segment));
+        } else {
+            LOG(ERROR) << "decode one segment err";
+            return StoreStatus::InternalError;
+        }
+    }
+    return StoreStatus::OK;
+}
+
 StoreStatus NameServerStorageImp::ListSnapshotFile(InodeID startid,
                                            InodeID endid,
                                            std::vector<FileInfo> *files) {
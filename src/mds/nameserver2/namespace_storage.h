@@ -167,6 +167,22 @@ class NameServerStorage {
     virtual StoreStatus ListSegment(InodeID id,
                                     std::vector<PageFileSegment> *segments) = 0;
 
+    /**
+     * @brief ListSegmentWithLimit: Get at most limit segments of the file
+     *                              whose offset >= startOffset, in offset order
+     *
+     * @param[in] id: Inode ID of the file
+     * @param[in] startOffset: Offset of the first segment to list
+     * @param[in] limit: Max number of segments to return
+     * @param[out] segments: Segment list
+     *
+     * @return StoreStatus: error code
+     */
+    virtual StoreStatus ListSegmentWithLimit(InodeID id,
+                                    uint64_t startOffset,
+                                    uint32_t limit,
+                                    std::vector<PageFileSegment> *segments) = 0;
+
     /**
      * @brief ListSnapshotFile: Get all snapshot files between [startid, endid)
      *
@@ -279,6 +295,11 @@ class NameServerStorageImp : public NameServerStorage {
     StoreStatus ListSegment(InodeID id,
                             std::vector<PageFileSegment> *segments) override;
 
+    StoreStatus ListSegmentWithLimit(InodeID id,
+                            uint64_t startOffset,
+                            uint32_t limit,
+                            std::vector<PageFileSegment> *segments) override;
+
     StoreStatus ListSnapshotFile(InodeID startid,
                         InodeID endid,
                         std::vector<FileInfo> * files) override;
@@ -21,7 +21,9 @@
  */
 
 #include <glog/logging.h>
+#include <cstring>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace mds {
@@ -104,5 +106,39 @@ void LRUCache::RemoveElement(const std::list<Item>::iterator &elem) {
     ll_.erase(elem);
 }
 
+void TimedLRUCache::Put(const std::string &key, const std::string &value) {
+    uint64_t now = ::curve::common::TimeUtility::GetTimeofDayUs();
+    std::string timedValue(sizeof(now), '\0');
+    std::memcpy(&timedValue[0], &now, sizeof(now));
+    timedValue.append(value);
+    cache_.Put(key, timedValue);
+}
+
+bool TimedLRUCache::Get(const std::string &key, std::string *value) {
+    std::string timedValue;
+    if (!cache_.Get(key, &timedValue)) {
+        return false;
+    }
+
+    uint64_t putTime;
+    if (timedValue.size() < sizeof(putTime)) {
+        cache_.Remove(key);
+        return false;
+    }
+    std::memcpy(&putTime, timedValue.data(), sizeof(putTime));
+    uint64_t now = ::curve::common::TimeUtility::GetTimeofDayUs();
+    if (now - putTime >= expireUs_) {
+        cache_.Remove(key);
+        return false;
+    }
+
+    value->assign(timedValue, sizeof(putTime), std::string::npos);
+    return true;
+}
+
+void TimedLRUCache::Remove(const std::string &key) {
+    cache_.Remove(key);
+}
+
 }  // namespace mds
 }  // namespace curve
@@ -73,6 +73,9 @@ class LRUCache : public Cache {
     explicit LRUCache(int maxCount) : maxCount_(maxCount) {
         cacheMetrics_ = std::make_shared<NameserverCacheMetrics>();
     }
+    LRUCache(int maxCount,
+             std::shared_ptr<NameserverCacheMetrics> cacheMetrics)
+        : maxCount_(maxCount), cacheMetrics_(cacheMetrics) {}
 
     void Put(const std::string &key, const std::string &value) override;
     bool Get(const std::string &key, std::string *value) override;
@@ -128,6 +131,28 @@ class LRUCache : public Cache {
     std::shared_ptr<NameserverCacheMetrics> cacheMetrics_;
 };
 
+/**
+ * TimedLRUCache is a LRUCache whose items expire expireMs after being put.
+ * It is used by mds followers which can not see the writes of the leader,
+ * so the staleness of the items read from it is bounded by expireMs.
+ */
+class TimedLRUCache : public Cache {
+ public:
+    TimedLRUCache(int maxCount, uint32_t expireMs,
+                  std::shared_ptr<NameserverCacheMetrics> cacheMetrics)
+        : cache_(maxCount, cacheMetrics),
+          expireUs_(static_cast<uint64_t>(expireMs) * 1000) {}
+
+    void Put(const std::string &key, const std::string &value) override;
+    bool Get(const std::string &key, std::string *value) override;
+    void Remove(const std::string &key) override;
+
+ private:
+    // the put time in us is stored in front of the value
+    LRUCache cache_;
+    uint64_t expireUs_;
+};
+
 }  // namespace mds
 }  // namespace curve
 
@@ -50,6 +50,7 @@ void MDS::InitMdsOptions(std::shared_ptr<Configuration> conf) {
     InitCopysetOption(&options_.copysetOption);
     InitChunkServerClientOption(&options_.chunkServerClientOption);
     InitSnapshotCloneClientOption(&options_.snapshotCloneClientOption);
+    InitFollowerReadOption(&options_.followerReadOption);
 
     conf_->GetValueFatalIfFail(
         "mds.segment.alloc.retryInterMs", &options_.retryInterTimes);
@@ -97,6 +98,9 @@ void MDS::StartCompaginLeader() {
     InitEtcdConf(&etcdConf);
     InitEtcdClient(etcdConf, etcdTimeout, etcdRetryTimes);
 
+    // serve metadata reads while campaigning
+    StartFollowerRead();
+
     // leader election
     LeaderElectionOptions leaderElectionOp;
     InitMdsLeaderElectionOption(&leaderElectionOp);
@@ -174,6 +178,13 @@ void MDS::Stop() {
 
     segmentAllocStatistic_->Stop();
 
+    if (followerReadServer_ != nullptr) {
+        followerReadServer_->Stop();
+    }
+    if (followerTopology_ != nullptr) {
+        followerTopology_->Stop();
+    }
+
     etcdClient_->CloseClient();
 }
 
@@ -497,9 +508,17 @@ void MDS::InitCleanManager() {
         std::make_shared<CopysetClient>(topology_, chunkServerClientOption,
                                                         channelPool);
 
+    ChunkDeleteOption chunkDeleteOption;
+    InitChunkDeleteOption(&chunkDeleteOption);
+    auto chunkDeleter = std::make_shared<ChunkDeleteExecutor>(copysetClient,
+                                                        chunkDeleteOption);
+    LOG_IF(FATAL, chunkDeleter->Start() != 0)
+        << "start chunk delete executor fail";
+
     auto cleanCore = std::make_shared<CleanCore>(nameServerStorage_,
                                                  copysetClient,
-                                                 segmentAllocStatistic_);
+                                                 segmentAllocStatistic_,
+                                                 chunkDeleter);
 
     cleanManager_ = std::make_shared<CleanManager>(cleanCore,
                                             taskManager, nameServerStorage_);
@@ -520,6 +539,95 @@ void MDS::InitChunkServerClientOption(ChunkServerClientOption *option) {
         &option->updateLeaderRetryIntervalMs);
 }
 
+void MDS::InitChunkDeleteOption(ChunkDeleteOption *option) {
+    if (!conf_->GetUInt32Value("mds.clean.deleteThreadNum",
+        &option->threadNum)) {
+        option->threadNum = 0;
+    }
+    if (!conf_->GetUInt32Value("mds.clean.maxInflightPerTask",
+        &option->maxInflightPerTask)) {
+        option->maxInflightPerTask = 1;
+    }
+    if (!conf_->GetUInt32Value("mds.clean.maxInflightPerCopyset",
+        &option->maxInflightPerCopyset)) {
+        option->maxInflightPerCopyset = 1;
+    }
+    if (!conf_->GetUInt32Value("mds.clean.deleteBatchSize",
+        &option->batchSize)) {
+        option->batchSize = 1;
+    }
+    if (!conf_->GetUInt64Value("mds.clean.deleteChunkRateLimit",
+        &option->deleteChunkRateLimit)) {
+        option->deleteChunkRateLimit = 0;
+    }
+    if (!conf_->GetUInt32Value("mds.clean.segmentWindow",
+        &option->segmentWindow)) {
+        option->segmentWindow = 1;
+    }
+}
+
+void MDS::InitFollowerReadOption(FollowerReadOption *option) {
+    if (!conf_->GetBoolValue("mds.followerRead.enable", &option->enable)) {
+        option->enable = false;
+    }
+    if (!option->enable) {
+        return;
+    }
+    conf_->GetValueFatalIfFail("mds.followerRead.listen.addr",
+                               &option->listenAddr);
+    if (!conf_->GetUInt32Value("mds.followerRead.maxStalenessMs",
+        &option->maxStalenessMs)) {
+        option->maxStalenessMs = 1000;
+    }
+    if (!conf_->GetIntValue("mds.followerRead.cache.count",
+        &option->cacheCount)) {
+        option->cacheCount = 100000;
+    }
+    if (!conf_->GetBoolValue("mds.followerRead.topology.enable",
+        &option->topologyEnable)) {
+        option->topologyEnable = false;
+    }
+    if (!conf_->GetUInt32Value("mds.followerRead.topology.reloadIntervalMs",
+        &option->topologyReloadIntervalMs)) {
+        option->topologyReloadIntervalMs = 1000;
+    }
+    LOG_IF(FATAL, option->topologyEnable &&
+        option->topologyReloadIntervalMs == 0)
+        << "mds.followerRead.topology.reloadIntervalMs must be positive";
+}
+
+void MDS::StartFollowerRead() {
+    const FollowerReadOption &option = options_.followerReadOption;
+    if (!option.enable) {
+        return;
+    }
+
+    // entries cached are dropped maxStalenessMs after being read from etcd,
+    // which bounds the staleness of the metadata returned by a follower
+    auto cache = std::make_shared<TimedLRUCache>(option.cacheCount,
+        option.maxStalenessMs,
+        std::make_shared<NameserverCacheMetrics>(
+            "mds_follower_read_cache_metric"));
+    auto storage = std::make_shared<NameServerStorageImp>(etcdClient_, cache);
+
+    // the topology is loaded in the background if it fails now, requests
+    // fail and go to the leader until then
+    if (option.topologyEnable) {
+        auto topologyStorage = std::make_shared<TopologyStorageEtcd>(
+            etcdClient_, std::make_shared<TopologyStorageCodec>());
+        followerTopology_ = std::make_shared<FollowerTopology>(
+            topologyStorage, options_.topologyOption,
+            option.topologyReloadIntervalMs);
+        followerTopology_->Reload();
+        followerTopology_->Run();
+    }
+
+    followerReadServer_.reset(new FollowerReadServer(storage,
+        options_.authOptions, followerTopology_));
+    LOG_IF(FATAL, followerReadServer_->Start(option.listenAddr) != 0)
+        << "start follower read server fail";
+}
+
 void MDS::InitCoordinator() {
     // init option
     ScheduleOption scheduleOption;
@@ -591,6 +699,18 @@ void MDS::InitHeartbeatOption(HeartbeatOption* heartbeatOption) {
                         &heartbeatOption->offLineTimeOutMs);
     conf_->GetValueFatalIfFail("mds.heartbeat.clean_follower_afterMs",
                         &heartbeatOption->cleanFollowerAfterMs);
+    if (!conf_->GetUInt32Value("mds.heartbeat.workerShardNum",
+                        &heartbeatOption->workerShardNum)) {
+        heartbeatOption->workerShardNum = 0;
+    }
+    if (!conf_->GetUInt32Value("mds.heartbeat.workerQueueCapacity",
+                        &heartbeatOption->workerQueueCapacity)) {
+        heartbeatOption->workerQueueCapacity = 0;
+    }
+    if (!conf_->GetBoolValue("mds.heartbeat.enableCopysetReportDiff",
+                        &heartbeatOption->enableCopysetReportDiff)) {
+        heartbeatOption->enableCopysetReportDiff = false;
+    }
 }
 }  // namespace mds
 }  // namespace curve
@@ -32,6 +32,7 @@
 
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/nameserver2/namespace_service.h"
+#include "src/mds/nameserver2/follower_read_service.h"
 #include "src/mds/nameserver2/curvefs.h"
 #include "src/mds/nameserver2/clean_manager.h"
 #include "src/mds/nameserver2/clean_core.h"
@@ -65,6 +66,7 @@ using ::curve::mds::topology::TopologyImpl;
 using ::curve::mds::topology::TopologyOption;
 using ::curve::mds::topology::TopologyStatImpl;
 using ::curve::mds::topology::TopologyMetricService;
+using ::curve::mds::topology::FollowerTopology;
 using ::curve::mds::copyset::CopysetManager;
 using ::curve::mds::copyset::CopysetOption;
 using ::curve::mds::heartbeat::HeartbeatServiceImpl;
@@ -104,6 +106,7 @@ struct MDSOptions {
     CopysetOption copysetOption;
     ChunkServerClientOption chunkServerClientOption;
     SnapshotCloneClientOption snapshotCloneClientOption;
+    FollowerReadOption followerReadOption;
 };
 
 class MDS {
@@ -165,6 +168,8 @@ class MDS {
 
     void InitChunkServerClientOption(ChunkServerClientOption *option);
 
+    void InitChunkDeleteOption(ChunkDeleteOption *option);
+
     void InitSnapshotCloneClientOption(SnapshotCloneClientOption *option);
 
     void InitEtcdClient(const EtcdConf& etcdConf,
@@ -204,6 +209,14 @@ class MDS {
 
     void InitThrottleOption(ThrottleOption* option);
 
+    void InitFollowerReadOption(FollowerReadOption *option);
+
+    /**
+     * @brief start the read-only metadata service served by every mds,
+     *        leader or not, if it is enabled
+     */
+    void StartFollowerRead();
+
  private:
     // mds configuration items
     std::shared_ptr<Configuration> conf_;
@@ -230,6 +243,8 @@ class MDS {
     char* etcdEndpoints_;
     FileLockManager* fileLockManager_;
     std::shared_ptr<SnapshotCloneClient> snapshotCloneClient_;
+    std::unique_ptr<FollowerReadServer> followerReadServer_;
+    std::shared_ptr<FollowerTopology> followerTopology_;
 };
 
 }  // namespace mds
@@ -879,7 +879,6 @@ int TopologyImpl::Init(const TopologyOption &option) {
     WriteLockGuard wlockZone(zoneMutex_);
     WriteLockGuard wlockServer(serverMutex_);
     WriteLockGuard wlockChunkServer(chunkServerMutex_);
-    WriteLockGuard wlockCopySet(copySetMutex_);
 
     PoolIdType maxLogicalPoolId;
     if (!storage_->LoadLogicalPool(&logicalPoolMap_, &maxLogicalPoolId)) {
@@ -962,13 +961,15 @@ int TopologyImpl::Init(const TopologyOption &option) {
     LOG(INFO) << "Calc physicalPool capacity success.";
 
     std::map<PoolIdType, CopySetIdType> copySetIdMaxMap;
-    if (!storage_->LoadCopySet(&copySetMap_, &copySetIdMaxMap)) {
+    std::map<CopySetKey, CopySetInfo> copySetMap;
+    if (!storage_->LoadCopySet(&copySetMap, &copySetIdMaxMap)) {
         LOG(ERROR) << "[TopologyImpl::init], LoadCopySet fail.";
         return kTopoErrCodeStorgeFail;
     }
+    copySetStore_.Init(copySetMap);
     idGenerator_->initCopySetIdGenerator(copySetIdMaxMap);
     LOG(INFO) << "[TopologyImpl::init], LoadCopySet success, "
-              << "copyset num = " << copySetMap_.size();
+              << "copyset num = " << copySetMap.size();
 
     for (auto it : zoneMap_) {
         PoolIdType poolid = it.second.GetPhysicalPoolId();
@@ -1007,14 +1008,15 @@ void TopologyImpl::SetChunkServerExternalIp() {
 int TopologyImpl::CleanInvalidLogicalPoolAndCopyset() {
     for (auto ix = logicalPoolMap_.begin(); ix != logicalPoolMap_.end();) {
         if (false == ix->second.GetLogicalPoolAvaliableFlag()) {
-            for (auto it = copySetMap_.begin(); it != copySetMap_.end();) {
-                if (it->second.GetLogicalPoolId() == ix->first) {
-                    if (!storage_->DeleteCopySet(it->first)) {
-                        return kTopoErrCodeStorgeFail;
-                    }
-                    it = copySetMap_.erase(it);
-                } else {
-                    it++;
+            auto snapshot = copySetStore_.GetSnapshot();
+            for (const CopySetInfo *info :
+                    snapshot->GetCopySetsInLogicalPool(ix->first)) {
+                int ret = copySetStore_.Remove(info->GetCopySetKey(),
+                    [this] (const CopySetKey &key) {
+                        return storage_->DeleteCopySet(key);
+                    });
+                if (ret == kTopoErrCodeStorgeFail) {
+                    return ret;
                 }
             }
             if (!storage_->DeleteLogicalPool(ix->first)) {
@@ -1035,104 +1037,111 @@ CopySetIdType TopologyImpl::AllocateCopySetId(PoolIdType logicalPoolId) {
 
 int TopologyImpl::AddCopySet(const CopySetInfo &data) {
     ReadLockGuard rlockLogicalPool(logicalPoolMutex_);
-    WriteLockGuard wlockCopySetMap(copySetMutex_);
     auto it = logicalPoolMap_.find(data.GetLogicalPoolId());
     if (it != logicalPoolMap_.end()) {
-        CopySetKey key(data.GetLogicalPoolId(), data.GetId());
-        if (copySetMap_.find(key) == copySetMap_.end()) {
-            if (!storage_->StorageCopySet(data)) {
-                return kTopoErrCodeStorgeFail;
-            }
-            copySetMap_[key] = data;
-            return kTopoErrCodeSuccess;
-        } else {
-            return kTopoErrCodeIdDuplicated;
-        }
+        return copySetStore_.Add(data,
+            [this] (const CopySetInfo &info) {
+                return storage_->StorageCopySet(info);
+            });
     } else {
         return kTopoErrCodeLogicalPoolNotFound;
     }
 }
 
 int TopologyImpl::RemoveCopySet(CopySetKey key) {
-    WriteLockGuard wlockCopySetMap(copySetMutex_);
-    auto it = copySetMap_.find(key);
-    if (it != copySetMap_.end()) {
-        if (!storage_->DeleteCopySet(key)) {
-            return kTopoErrCodeStorgeFail;
-        }
-        copySetMap_.erase(key);
-        return kTopoErrCodeSuccess;
+    return copySetStore_.Remove(key,
+        [this] (const CopySetKey &key) {
+            return storage_->DeleteCopySet(key);
+        });
+}
+
+namespace {
+int ApplyCopySetTopo(const CopySetInfo &data, CopySetInfo *record) {
+    record->SetLeader(data.GetLeader());
+    record->SetEpoch(data.GetEpoch());
+    record->SetCopySetMembers(data.GetCopySetMembers());
+    if (data.HasCandidate()) {
+        record->SetCandidate(data.GetCandidate());
     } else {
-        return kTopoErrCodeCopySetNotFound;
+        record->ClearCandidate();
     }
+    record->SetDirtyFlag(true);
+    return kTopoErrCodeSuccess;
 }
+}  // namespace
 
 int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
-    ReadLockGuard rlockCopySetMap(copySetMutex_);
     CopySetKey key(data.GetLogicalPoolId(), data.GetId());
-    auto it = copySetMap_.find(key);
-    if (it != copySetMap_.end()) {
-        WriteLockGuard wlockCopySet(it->second.GetRWLockRef());
-        it->second.SetLeader(data.GetLeader());
-        it->second.SetEpoch(data.GetEpoch());
-        it->second.SetCopySetMembers(data.GetCopySetMembers());
-        if (data.HasCandidate()) {
-            it->second.SetCandidate(data.GetCandidate());
-        } else {
-            it->second.ClearCandidate();
-        }
-        it->second.SetDirtyFlag(true);
-        return kTopoErrCodeSuccess;
-    } else {
+    int ret = copySetStore_.Modify(key, [&data] (CopySetInfo *record) {
+        return ApplyCopySetTopo(data, record);
+    });
+    if (ret == kTopoErrCodeCopySetNotFound) {
         LOG(WARNING) << "UpdateCopySetTopo can not find copyset, "
                      << "logicalPoolId = " << data.GetLogicalPoolId()
                      << ", copysetId = " << data.GetId();
-        return kTopoErrCodeCopySetNotFound;
     }
+    return ret;
+}
+
+int TopologyImpl::BatchUpdateCopySetTopo(
+    const std::vector<CopySetInfo> &datas) {
+    std::vector<CopySetKey> keys;
+    keys.reserve(datas.size());
+    for (const auto &data : datas) {
+        keys.emplace_back(data.GetLogicalPoolId(), data.GetId());
+    }
+    std::vector<int> rets;
+    int ret = copySetStore_.BatchModify(keys,
+        [&datas] (size_t index, CopySetInfo *record) {
+            return ApplyCopySetTopo(datas[index], record);
+        }, &rets);
+    for (size_t i = 0; i < rets.size(); i++) {
+        if (rets[i] == kTopoErrCodeCopySetNotFound) {
+            LOG(WARNING) << "BatchUpdateCopySetTopo can not find copyset, "
+                         << "logicalPoolId = " << keys[i].first
+                         << ", copysetId = " << keys[i].second;
+        } else if (rets[i] != kTopoErrCodeSuccess) {
+            LOG(WARNING) << "BatchUpdateCopySetTopo update copyset fail, "
+                         << "logicalPoolId = " << keys[i].first
+                         << ", copysetId = " << keys[i].second
+                         << ", ret = " << rets[i];
+        }
+    }
+    return ret;
 }
 
 int TopologyImpl::SetCopySetAvalFlag(const CopySetKey &key, bool aval) {
-    ReadLockGuard rlockCopySetMap(copySetMutex_);
-    auto it = copySetMap_.find(key);
-    if (it != copySetMap_.end()) {
-        WriteLockGuard wlockCopySet(it->second.GetRWLockRef());
-        auto copysetInfo = it->second;
+    int ret = copySetStore_.Modify(key, [this, aval] (CopySetInfo *record) {
+        auto copysetInfo = *record;
         copysetInfo.SetAvailableFlag(aval);
-        bool ret = storage_->UpdateCopySet(copysetInfo);
-        if (!ret) {
+        if (!storage_->UpdateCopySet(copysetInfo)) {
             LOG(ERROR) << "UpdateCopySet met storage error";
             return kTopoErrCodeStorgeFail;
         }
-        it->second.SetAvailableFlag(aval);
+        record->SetAvailableFlag(aval);
         return kTopoErrCodeSuccess;
-    } else {
+    });
+    if (ret == kTopoErrCodeCopySetNotFound) {
         LOG(WARNING) << "SetCopySetAvalFlag can not find copyset, "
                      << "logicalPoolId = " << key.first
                      << ", copysetId = " << key.second;
-        return kTopoErrCodeCopySetNotFound;
     }
+    return ret;
 }
 
 bool TopologyImpl::GetCopySet(CopySetKey key, CopySetInfo *out) const {
-    ReadLockGuard rlockCopySetMap(copySetMutex_);
-    auto it = copySetMap_.find(key);
-    if (it != copySetMap_.end()) {
-        ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
-        *out = it->second;
-        return true;
-    } else {
-        return false;
-    }
+    return copySetStore_.Get(key, out);
 }
 
 std::vector<CopySetIdType> TopologyImpl::GetCopySetsInLogicalPool(
     PoolIdType logicalPoolId,
     CopySetFilter filter) const {
     std::vector<CopySetIdType> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.first.first == logicalPoolId) {
-            ret.push_back(it.first.second);
+    auto snapshot = copySetStore_.GetSnapshot();
+    for (const CopySetInfo *info :
+            snapshot->GetCopySetsInLogicalPool(logicalPoolId)) {
+        if (filter(*info)) {
+            ret.push_back(info->GetId());
         }
     }
     return ret;
@@ -1142,10 +1151,11 @@ std::vector<CopySetInfo> TopologyImpl::GetCopySetInfosInLogicalPool(
     PoolIdType logicalPoolId,
     CopySetFilter filter) const {
     std::vector<CopySetInfo> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.first.first == logicalPoolId) {
-            ret.push_back(it.second);
+    auto snapshot = copySetStore_.GetSnapshot();
+    for (const CopySetInfo *info :
+            snapshot->GetCopySetsInLogicalPool(logicalPoolId)) {
+        if (filter(*info)) {
+            ret.push_back(*info);
         }
     }
     return ret;
@@ -1154,10 +1164,10 @@ std::vector<CopySetInfo> TopologyImpl::GetCopySetInfosInLogicalPool(
 std::vector<CopySetKey> TopologyImpl::GetCopySetsInCluster(
     CopySetFilter filter) const {
     std::vector<CopySetKey> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second)) {
-            ret.push_back(it.first);
+    auto snapshot = copySetStore_.GetSnapshot();
+    for (const CopySetInfo *info : snapshot->GetCopySets()) {
+        if (filter(*info)) {
+            ret.push_back(info->GetCopySetKey());
         }
     }
     return ret;
@@ -1167,10 +1177,11 @@ std::vector<CopySetKey> TopologyImpl::GetCopySetsInChunkServer(
     ChunkServerIdType id,
     CopySetFilter filter) const {
     std::vector<CopySetKey> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.second.GetCopySetMembers().count(id) > 0) {
-            ret.push_back(it.first);
+    for (const auto &key : copySetStore_.GetCopySetsInChunkServer(id)) {
+        CopySetInfo info;
+        if (copySetStore_.Get(key, &info) &&
+            filter(info) && info.HasMember(id)) {
+            ret.push_back(key);
         }
     }
     return ret;
@@ -1203,22 +1214,14 @@ void TopologyImpl::BackEndFunc() {
 }
 
 void TopologyImpl::FlushCopySetToStorage() {
-    std::vector<PoolIdType> pools = GetLogicalPoolInCluster();
-    for (const auto poolId : pools) {
-        ReadLockGuard rlockCopySetMap(copySetMutex_);
-        for (auto &c : copySetMap_) {
-            WriteLockGuard wlockCopySet(c.second.GetRWLockRef());
-            if (c.second.GetDirtyFlag() &&
-                        c.second.GetLogicalPoolId() == poolId) {
-                c.second.SetDirtyFlag(false);
-                if (!storage_->UpdateCopySet(c.second)) {
-                    LOG(WARNING) << "update copyset("
-                                 << c.second.GetLogicalPoolId()
-                                 << "," << c.second.GetId() << ") to repo fail";
-                }
-            }
+    copySetStore_.ForEachDirty([this] (CopySetInfo *c) {
+        c->SetDirtyFlag(false);
+        if (!storage_->UpdateCopySet(*c)) {
+            LOG(WARNING) << "update copyset("
+                         << c->GetLogicalPoolId()
+                         << "," << c->GetId() << ") to repo fail";
         }
-    }
+    });
 }
 
 void TopologyImpl::FlushChunkServerToStorage() {
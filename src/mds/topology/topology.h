@@ -35,6 +35,7 @@
 #include "src/mds/topology/topology_id_generator.h"
 #include "src/mds/topology/topology_token_generator.h"
 #include "src/mds/topology/topology_storge.h"
+#include "src/mds/topology/topology_copyset_store.h"
 #include "src/common/concurrent/rw_lock.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/interruptible_sleeper.h"
@@ -178,6 +179,20 @@ class Topology {
      */
     virtual int UpdateCopySetTopo(const CopySetInfo &data) = 0;
 
+    /**
+     * @brief update a batch of copysets, copysets in the same stripe of
+     *        the copyset store are updated in one acquisition of its lock
+     * - same as UpdateCopySetTopo, only RAM will be updated
+     * - copysets that can not be found are skipped, others still get updated
+     *
+     * @param datas copyset data list
+     *
+     * @return kTopoErrCodeSuccess if all copysets updated, otherwise
+     *         the last error code met
+     */
+    virtual int BatchUpdateCopySetTopo(
+        const std::vector<CopySetInfo> &datas) = 0;
+
     virtual int SetCopySetAvalFlag(const CopySetKey &key, bool aval) = 0;
 
     virtual PoolIdType
@@ -389,6 +404,9 @@ class TopologyImpl : public Topology {
 
     int UpdateCopySetTopo(const CopySetInfo &data) override;
 
+    int BatchUpdateCopySetTopo(
+        const std::vector<CopySetInfo> &datas) override;
+
     int SetCopySetAvalFlag(const CopySetKey &key, bool aval) override;
 
     PoolIdType FindLogicalPool(const std::string &logicalPoolName,
@@ -580,7 +598,8 @@ class TopologyImpl : public Topology {
     std::unordered_map<ServerIdType, Server> serverMap_;
     std::unordered_map<ChunkServerIdType, ChunkServer> chunkServerMap_;
 
-    std::map<CopySetKey, CopySetInfo> copySetMap_;
+    // copysets are kept in a lock striped store, which has its own locks
+    CopySetStore copySetStore_;
 
     // cluster info
     ClusterInformation clusterInfo;
@@ -595,7 +614,6 @@ class TopologyImpl : public Topology {
     mutable curve::common::RWLock zoneMutex_;
     mutable curve::common::RWLock serverMutex_;
     mutable curve::common::RWLock chunkServerMutex_;
-    mutable curve::common::RWLock copySetMutex_;
 
     TopologyOption option_;
     curve::common::Thread backEndThread_;
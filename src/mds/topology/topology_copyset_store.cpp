@@ -0,0 +1,371 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/mds/topology/topology_copyset_store.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <utility>
+
+using ::curve::common::ReadLockGuard;
+using ::curve::common::WriteLockGuard;
+using ::curve::common::LockGuard;
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+namespace {
+bool CopySetKeyLess(const CopySetInfo *a, const CopySetInfo *b) {
+    return a->GetCopySetKey() < b->GetCopySetKey();
+}
+
+// the stripe a copyset belongs to, shared by the store and its snapshots
+size_t StripeIndex(const CopySetKey &key, size_t stripeNum) {
+    uint64_t hash = (static_cast<uint64_t>(key.first) << 32) | key.second;
+    return hash % stripeNum;
+}
+}  // namespace
+
+uint64_t CopySetSnapshot::Size() const {
+    uint64_t size = 0;
+    for (const auto &stripe : stripes) {
+        size += stripe->copysets.size();
+    }
+    return size;
+}
+
+const CopySetInfo *CopySetSnapshot::Find(const CopySetKey &key) const {
+    if (stripes.empty()) {
+        return nullptr;
+    }
+    const auto &copysets = stripes[StripeIndex(key, stripes.size())]->copysets;
+    auto it = copysets.find(key);
+    if (it == copysets.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::vector<const CopySetInfo *> CopySetSnapshot::GetCopySets() const {
+    std::vector<const CopySetInfo *> ret;
+    ret.reserve(Size());
+    for (const auto &stripe : stripes) {
+        for (const auto &pair : stripe->copysets) {
+            ret.push_back(&pair.second);
+        }
+    }
+    std::sort(ret.begin(), ret.end(), CopySetKeyLess);
+    return ret;
+}
+
+std::vector<const CopySetInfo *> CopySetSnapshot::GetCopySetsInLogicalPool(
+    PoolIdType logicalPoolId) const {
+    std::vector<const CopySetInfo *> ret;
+    for (const auto &stripe : stripes) {
+        auto it = stripe->copysets.lower_bound(CopySetKey(logicalPoolId, 0));
+        for (; it != stripe->copysets.end() &&
+                it->first.first == logicalPoolId; it++) {
+            ret.push_back(&it->second);
+        }
+    }
+    std::sort(ret.begin(), ret.end(), CopySetKeyLess);
+    return ret;
+}
+
+CopySetStore::CopySetStore(uint32_t stripeNum)
+    : version_(0) {
+    if (stripeNum == 0) {
+        stripeNum = kDefaultStripeNum;
+    }
+    auto snapshot = std::make_shared<CopySetSnapshot>();
+    stripes_.reserve(stripeNum);
+    snapshot->stripes.reserve(stripeNum);
+    for (uint32_t i = 0; i < stripeNum; i++) {
+        stripes_.emplace_back(new Stripe());
+        snapshot->stripes.emplace_back(
+            std::make_shared<CopySetStripeSnapshot>());
+    }
+    snapshot_ = snapshot;
+}
+
+CopySetStore::Stripe *CopySetStore::GetStripe(const CopySetKey &key) const {
+    return stripes_[StripeIndex(key, stripes_.size())].get();
+}
+
+void CopySetStore::AddToIndex(const CopySetKey &key,
+    const std::set<ChunkServerIdType> &members) {
+    WriteLockGuard wlock(indexMutex_);
+    for (auto csId : members) {
+        csIndex_[csId].emplace(key);
+    }
+}
+
+void CopySetStore::RemoveFromIndex(const CopySetKey &key,
+    const std::set<ChunkServerIdType> &members) {
+    WriteLockGuard wlock(indexMutex_);
+    for (auto csId : members) {
+        auto it = csIndex_.find(csId);
+        if (it == csIndex_.end()) {
+            continue;
+        }
+        it->second.erase(key);
+        if (it->second.empty()) {
+            csIndex_.erase(it);
+        }
+    }
+}
+
+void CopySetStore::Init(const std::map<CopySetKey, CopySetInfo> &copysets) {
+    for (auto &stripe : stripes_) {
+        WriteLockGuard wlock(stripe->mtx);
+        stripe->copysets.clear();
+        stripe->version.fetch_add(1, std::memory_order_acq_rel);
+    }
+    {
+        WriteLockGuard wlock(indexMutex_);
+        csIndex_.clear();
+    }
+
+    for (const auto &pair : copysets) {
+        Stripe *stripe = GetStripe(pair.first);
+        WriteLockGuard wlock(stripe->mtx);
+        stripe->copysets.emplace(pair.first, pair.second);
+        AddToIndex(pair.first, pair.second.GetCopySetMembers());
+        stripe->version.fetch_add(1, std::memory_order_acq_rel);
+    }
+    version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+int CopySetStore::Add(const CopySetInfo &data,
+    const std::function<bool(const CopySetInfo &)> &persist) {
+    CopySetKey key(data.GetLogicalPoolId(), data.GetId());
+    Stripe *stripe = GetStripe(key);
+    {
+        WriteLockGuard wlock(stripe->mtx);
+        if (stripe->copysets.find(key) != stripe->copysets.end()) {
+            return kTopoErrCodeIdDuplicated;
+        }
+        if (!persist(data)) {
+            return kTopoErrCodeStorgeFail;
+        }
+        stripe->copysets.emplace(key, data);
+        AddToIndex(key, data.GetCopySetMembers());
+        stripe->version.fetch_add(1, std::memory_order_acq_rel);
+    }
+    version_.fetch_add(1, std::memory_order_acq_rel);
+    return kTopoErrCodeSuccess;
+}
+
+int CopySetStore::Remove(const CopySetKey &key,
+    const std::function<bool(const CopySetKey &)> &persist) {
+    Stripe *stripe = GetStripe(key);
+    {
+        WriteLockGuard wlock(stripe->mtx);
+        auto it = stripe->copysets.find(key);
+        if (it == stripe->copysets.end()) {
+            return kTopoErrCodeCopySetNotFound;
+        }
+        if (!persist(key)) {
+            return kTopoErrCodeStorgeFail;
+        }
+        RemoveFromIndex(key, it->second.GetCopySetMembers());
+        stripe->copysets.erase(it);
+        stripe->version.fetch_add(1, std::memory_order_acq_rel);
+    }
+    version_.fetch_add(1, std::memory_order_acq_rel);
+    return kTopoErrCodeSuccess;
+}
+
+int CopySetStore::ModifyLocked(Stripe *stripe, const CopySetKey &key,
+    const std::function<int(CopySetInfo *)> &fn) {
+    auto it = stripe->copysets.find(key);
+    if (it == stripe->copysets.end()) {
+        return kTopoErrCodeCopySetNotFound;
+    }
+    WriteLockGuard wlockCopySet(it->second.GetRWLockRef());
+    std::set<ChunkServerIdType> oldMembers = it->second.GetCopySetMembers();
+    int ret = fn(&it->second);
+    if (ret != kTopoErrCodeSuccess) {
+        return ret;
+    }
+    const std::set<ChunkServerIdType> &newMembers =
+        it->second.GetCopySetMembers();
+    if (oldMembers != newMembers) {
+        RemoveFromIndex(key, oldMembers);
+        AddToIndex(key, newMembers);
+    }
+    return ret;
+}
+
+int CopySetStore::Modify(const CopySetKey &key,
+    const std::function<int(CopySetInfo *)> &fn) {
+    Stripe *stripe = GetStripe(key);
+    int ret;
+    {
+        ReadLockGuard rlock(stripe->mtx);
+        ret = ModifyLocked(stripe, key, fn);
+        if (ret != kTopoErrCodeSuccess) {
+            return ret;
+        }
+        stripe->version.fetch_add(1, std::memory_order_acq_rel);
+    }
+    version_.fetch_add(1, std::memory_order_acq_rel);
+    return ret;
+}
+
+int CopySetStore::BatchModify(const std::vector<CopySetKey> &keys,
+    const std::function<int(size_t, CopySetInfo *)> &fn,
+    std::vector<int> *rets) {
+    rets->assign(keys.size(), kTopoErrCodeSuccess);
+    // stripe index -> indexes of the keys in that stripe
+    std::map<size_t, std::vector<size_t>> keysInStripe;
+    for (size_t i = 0; i < keys.size(); i++) {
+        keysInStripe[StripeIndex(keys[i], stripes_.size())].push_back(i);
+    }
+
+    bool changed = false;
+    for (const auto &pair : keysInStripe) {
+        Stripe *stripe = stripes_[pair.first].get();
+        bool stripeChanged = false;
+        ReadLockGuard rlock(stripe->mtx);
+        for (size_t i : pair.second) {
+            int modifyRet = ModifyLocked(stripe, keys[i],
+                [&fn, i] (CopySetInfo *info) {
+                    return fn(i, info);
+                });
+            (*rets)[i] = modifyRet;
+            if (modifyRet == kTopoErrCodeSuccess) {
+                stripeChanged = true;
+            }
+        }
+        if (stripeChanged) {
+            stripe->version.fetch_add(1, std::memory_order_acq_rel);
+            changed = true;
+        }
+    }
+    if (changed) {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    int ret = kTopoErrCodeSuccess;
+    for (int modifyRet : *rets) {
+        if (modifyRet != kTopoErrCodeSuccess) {
+            ret = modifyRet;
+        }
+    }
+    return ret;
+}
+
+bool CopySetStore::Get(const CopySetKey &key, CopySetInfo *out) const {
+    Stripe *stripe = GetStripe(key);
+    ReadLockGuard rlock(stripe->mtx);
+    auto it = stripe->copysets.find(key);
+    if (it == stripe->copysets.end()) {
+        return false;
+    }
+    ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
+    *out = it->second;
+    return true;
+}
+
+void CopySetStore::ForEachDirty(const std::function<void(CopySetInfo *)> &fn) {
+    for (auto &stripe : stripes_) {
+        ReadLockGuard rlock(stripe->mtx);
+        for (auto &pair : stripe->copysets) {
+            WriteLockGuard wlockCopySet(pair.second.GetRWLockRef());
+            if (pair.second.GetDirtyFlag()) {
+                fn(&pair.second);
+            }
+        }
+    }
+}
+
+std::vector<CopySetKey> CopySetStore::GetCopySetsInChunkServer(
+    ChunkServerIdType id) const {
+    std::vector<CopySetKey> ret;
+    ReadLockGuard rlock(indexMutex_);
+    auto it = csIndex_.find(id);
+    if (it != csIndex_.end()) {
+        ret.assign(it->second.begin(), it->second.end());
+    }
+    return ret;
+}
+
+CopySetSnapshotPtr CopySetStore::GetSnapshot() const {
+    CopySetSnapshotPtr snapshot = std::atomic_load(&snapshot_);
+    if (snapshot->version == Version()) {
+        return snapshot;
+    }
+
+    LockGuard guard(snapshotMutex_);
+    // someone else may have rebuilt it
+    snapshot = std::atomic_load(&snapshot_);
+    uint64_t version = Version();
+    if (snapshot->version == version) {
+        return snapshot;
+    }
+
+    // a stripe version is increased before version_, so every change
+    // included in version is seen by the stripe versions read after it
+    auto newSnapshot = std::make_shared<CopySetSnapshot>();
+    newSnapshot->version = version;
+    newSnapshot->stripes.reserve(stripes_.size());
+    for (size_t i = 0; i < stripes_.size(); i++) {
+        newSnapshot->stripes.emplace_back(
+            GetStripeSnapshot(*stripes_[i], snapshot->stripes[i]));
+    }
+    snapshot = newSnapshot;
+    std::atomic_store(&snapshot_, snapshot);
+    return snapshot;
+}
+
+CopySetStripeSnapshotPtr CopySetStore::GetStripeSnapshot(
+    const Stripe &stripe, const CopySetStripeSnapshotPtr &last) const {
+    // the version is taken before copying, changes happen during copying
+    // may or may not be included, and will trigger another copy
+    uint64_t version = stripe.version.load(std::memory_order_acquire);
+    if (last->version == version) {
+        return last;
+    }
+
+    auto stripeSnapshot = std::make_shared<CopySetStripeSnapshot>();
+    stripeSnapshot->version = version;
+    ReadLockGuard rlock(stripe.mtx);
+    for (auto &pair : stripe.copysets) {
+        ReadLockGuard rlockCopySet(pair.second.GetRWLockRef());
+        stripeSnapshot->copysets.emplace(pair.first, pair.second);
+    }
+    return stripeSnapshot;
+}
+
+uint64_t CopySetStore::Size() const {
+    uint64_t size = 0;
+    for (auto &stripe : stripes_) {
+        ReadLockGuard rlock(stripe->mtx);
+        size += stripe->copysets.size();
+    }
+    return size;
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
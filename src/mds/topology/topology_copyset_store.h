@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_COPYSET_STORE_H_
+#define SRC_MDS_TOPOLOGY_TOPOLOGY_COPYSET_STORE_H_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+#include "src/mds/common/mds_define.h"
+#include "src/mds/topology/topology_item.h"
+#include "src/common/concurrent/rw_lock.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+/**
+ * @brief immutable copy of the copysets in one stripe
+ */
+struct CopySetStripeSnapshot {
+    // all the changes of the stripe whose version <= this one are included
+    uint64_t version = 0;
+    std::map<CopySetKey, CopySetInfo> copysets;
+};
+
+using CopySetStripeSnapshotPtr = std::shared_ptr<const CopySetStripeSnapshot>;
+
+/**
+ * @brief immutable copy of all copysets at some version, shared by readers.
+ *        It is made up of one copy per stripe, and a stripe that has not
+ *        changed since the last snapshot shares its copy with it
+ */
+struct CopySetSnapshot {
+    // all the changes whose version <= this one are included
+    uint64_t version = 0;
+    std::vector<CopySetStripeSnapshotPtr> stripes;
+
+    uint64_t Size() const;
+
+    /**
+     * @brief Find find a copyset in the snapshot
+     *
+     * @return nullptr if not found
+     */
+    const CopySetInfo *Find(const CopySetKey &key) const;
+
+    /**
+     * @brief GetCopySets get all copysets, sorted by
+     *        (logicalPoolId, copysetId). The pointers are valid as long as
+     *        the snapshot is held
+     */
+    std::vector<const CopySetInfo *> GetCopySets() const;
+
+    /**
+     * @brief GetCopySetsInLogicalPool get copysets of the logical pool,
+     *        sorted by copysetId. The pointers are valid as long as
+     *        the snapshot is held
+     */
+    std::vector<const CopySetInfo *> GetCopySetsInLogicalPool(
+        PoolIdType logicalPoolId) const;
+};
+
+using CopySetSnapshotPtr = std::shared_ptr<const CopySetSnapshot>;
+
+/**
+ * @brief CopySetStore keeps copysets of topology in memory.
+ *
+ * - copysets are divided into stripes by (logicalPoolId, copysetId), each
+ *   stripe has its own lock, so that heartbeats updating different copysets
+ *   do not contend on one lock
+ * - copysets of every chunkserver are indexed, so lookup by chunkserver
+ *   does not need to scan all copysets
+ * - readers who scan all copysets (metric, scheduler) read from an immutable
+ *   snapshot. The snapshot is rebuilt lazily by the first reader after any
+ *   change, and shared by readers until next change, so scans never hold
+ *   the locks that heartbeat writers need. Only the stripes changed since
+ *   the last snapshot are copied when rebuilding, so a few heartbeat
+ *   updates between two scans do not cost a copy of all copysets.
+ *
+ * lock order: stripe lock -> copyset lock -> index lock
+ */
+class CopySetStore {
+ public:
+    explicit CopySetStore(uint32_t stripeNum = kDefaultStripeNum);
+
+    /**
+     * @brief Init replace all copysets, used when loading from storage
+     *
+     * @param copysets copysets loaded
+     */
+    void Init(const std::map<CopySetKey, CopySetInfo> &copysets);
+
+    /**
+     * @brief Add add a copyset
+     *
+     * @param data copyset to add
+     * @param persist called under the stripe lock before inserting to memory,
+     *        the copyset is not inserted if it returns false
+     *
+     * @return kTopoErrCodeSuccess, kTopoErrCodeIdDuplicated or
+     *         kTopoErrCodeStorgeFail
+     */
+    int Add(const CopySetInfo &data,
+        const std::function<bool(const CopySetInfo &)> &persist);
+
+    /**
+     * @brief Remove remove a copyset
+     *
+     * @param key copyset to remove
+     * @param persist called under the stripe lock before removing from memory,
+     *        the copyset is not removed if it returns false
+     *
+     * @return kTopoErrCodeSuccess, kTopoErrCodeCopySetNotFound or
+     *         kTopoErrCodeStorgeFail
+     */
+    int Remove(const CopySetKey &key,
+        const std::function<bool(const CopySetKey &)> &persist);
+
+    /**
+     * @brief Modify modify a copyset in place, fn is called with the copyset
+     *        write locked. The copyset is regarded as unchanged if fn
+     *        does not return kTopoErrCodeSuccess
+     *
+     * @param key copyset to modify
+     * @param fn modification
+     *
+     * @return kTopoErrCodeCopySetNotFound or the return value of fn
+     */
+    int Modify(const CopySetKey &key,
+        const std::function<int(CopySetInfo *)> &fn);
+
+    /**
+     * @brief BatchModify modify a batch of copysets, copysets in the same
+     *        stripe are modified in one acquisition of the stripe lock.
+     *        Each copyset is handled as in Modify, a failed one does not
+     *        stop the others
+     *
+     * @param keys copysets to modify
+     * @param fn modification, called with the index of the key in keys
+     * @param[out] rets return code of each key, same as Modify
+     *
+     * @return kTopoErrCodeSuccess if all copysets are modified, otherwise
+     *         the last error code met
+     */
+    int BatchModify(const std::vector<CopySetKey> &keys,
+        const std::function<int(size_t, CopySetInfo *)> &fn,
+        std::vector<int> *rets);
+
+    /**
+     * @brief Get get a copy of the copyset
+     *
+     * @return false if not found
+     */
+    bool Get(const CopySetKey &key, CopySetInfo *out) const;
+
+    /**
+     * @brief ForEachDirty visit every copyset whose dirty flag is set,
+     *        fn is called with the copyset write locked and is expected to
+     *        clear the flag after flushing it. Members must not be changed
+     *        in fn, and the change is not reflected in snapshot
+     */
+    void ForEachDirty(const std::function<void(CopySetInfo *)> &fn);
+
+    /**
+     * @brief GetCopySetsInChunkServer get copysets the chunkserver is a
+     *        member of, by the index
+     */
+    std::vector<CopySetKey> GetCopySetsInChunkServer(
+        ChunkServerIdType id) const;
+
+    /**
+     * @brief GetSnapshot get the snapshot which includes all the changes
+     *        finished before calling
+     */
+    CopySetSnapshotPtr GetSnapshot() const;
+
+    uint64_t Size() const;
+
+    uint64_t Version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+ private:
+    struct Stripe {
+        Stripe() : version(0) {}
+
+        mutable curve::common::RWLock mtx;
+        std::map<CopySetKey, CopySetInfo> copysets;
+        // increased after every change of the stripe, before version_
+        curve::common::Atomic<uint64_t> version;
+    };
+
+    Stripe *GetStripe(const CopySetKey &key) const;
+
+    /**
+     * @brief ModifyLocked modify a copyset of the stripe with the stripe
+     *        lock held, the stripe version is left to the caller
+     *
+     * @return kTopoErrCodeCopySetNotFound or the return value of fn
+     */
+    int ModifyLocked(Stripe *stripe, const CopySetKey &key,
+        const std::function<int(CopySetInfo *)> &fn);
+
+    /**
+     * @brief GetStripeSnapshot return last if the stripe has not changed
+     *        since it was taken, otherwise copy the stripe
+     */
+    CopySetStripeSnapshotPtr GetStripeSnapshot(const Stripe &stripe,
+        const CopySetStripeSnapshotPtr &last) const;
+
+    void AddToIndex(const CopySetKey &key,
+        const std::set<ChunkServerIdType> &members);
+
+    void RemoveFromIndex(const CopySetKey &key,
+        const std::set<ChunkServerIdType> &members);
+
+ private:
+    static const uint32_t kDefaultStripeNum = 64;
+
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+
+    // chunkserver -> copysets the chunkserver is a member of
+    mutable curve::common::RWLock indexMutex_;
+    std::unordered_map<ChunkServerIdType, std::set<CopySetKey>> csIndex_;
+
+    // increased after every change finished
+    curve::common::Atomic<uint64_t> version_;
+    // latest snapshot built, accessed by std::atomic_load/atomic_store
+    mutable CopySetSnapshotPtr snapshot_;
+    // only one reader rebuilds the snapshot at a time
+    mutable curve::common::Mutex snapshotMutex_;
+};
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_TOPOLOGY_TOPOLOGY_COPYSET_STORE_H_
@@ -0,0 +1,260 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/mds/topology/topology_follower.h"
+
+#include <glog/logging.h>
+#include <errno.h>
+
+#include <chrono>  // NOLINT
+
+#include "src/mds/topology/topology_id_generator.h"
+#include "src/mds/topology/topology_token_generator.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+int FollowerTopology::Reload() {
+    auto topology = std::make_shared<TopologyImpl>(
+        std::make_shared<DefaultIdGenerator>(),
+        std::make_shared<DefaultTokenGenerator>(),
+        storage_);
+    int ret = topology->Init(option_);
+    if (kTopoErrCodeSuccess != ret) {
+        LOG(WARNING) << "follower reload topology fail, ret = " << ret;
+        return ret;
+    }
+    // the copyset manager is only used to create copysets, which is
+    // not served by a follower
+    auto serviceManager =
+        std::make_shared<TopologyServiceManager>(topology, nullptr);
+    serviceManager->Init(option_);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    serviceManager_ = serviceManager;
+    return kTopoErrCodeSuccess;
+}
+
+int FollowerTopology::Run() {
+    if (isStop_.exchange(false)) {
+        backEndThread_ = curve::common::Thread(
+            &FollowerTopology::BackEndFunc, this);
+    }
+    return 0;
+}
+
+int FollowerTopology::Stop() {
+    if (!isStop_.exchange(true)) {
+        LOG(INFO) << "stop FollowerTopology...";
+        sleeper_.interrupt();
+        backEndThread_.join();
+        LOG(INFO) << "stop FollowerTopology ok.";
+    }
+    return 0;
+}
+
+std::shared_ptr<TopologyServiceManager> FollowerTopology::GetServiceManager() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return serviceManager_;
+}
+
+void FollowerTopology::BackEndFunc() {
+    while (sleeper_.wait_for(
+        std::chrono::milliseconds(reloadIntervalMs_))) {
+        Reload();
+    }
+}
+
+template <typename Request, typename Response>
+void FollowerTopologyServiceImpl::Serve(
+    google::protobuf::RpcController* cntl_base,
+    const Request* request,
+    Response* response,
+    google::protobuf::Closure* done,
+    void (TopologyServiceManager::*func)(const Request*, Response*)) {
+    brpc::ClosureGuard done_guard(done);
+
+    brpc::Controller* cntl =
+        static_cast<brpc::Controller*>(cntl_base);
+
+    std::shared_ptr<TopologyServiceManager> serviceManager =
+        topology_->GetServiceManager();
+    if (nullptr == serviceManager) {
+        cntl->SetFailed(EAGAIN, "follower topology is not loaded yet");
+        return;
+    }
+
+    ((*serviceManager).*func)(request, response);
+
+    if (kTopoErrCodeSuccess != response->statuscode()) {
+        LOG(ERROR) << "Send follower response[log_id=" << cntl->log_id()
+                   << "] from " << cntl->local_side()
+                   << " to " << cntl->remote_side()
+                   << ". [" << response->GetTypeName() << "] "
+                   << response->DebugString();
+    } else {
+        VLOG(3) << "Send follower response[log_id=" << cntl->log_id()
+                << "] from " << cntl->local_side()
+                << " to " << cntl->remote_side()
+                << ". [" << response->GetTypeName() << "]";
+    }
+}
+
+void FollowerTopologyServiceImpl::ListChunkServer(
+    google::protobuf::RpcController* cntl_base,
+    const ListChunkServerRequest* request,
+    ListChunkServerResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListChunkServer);
+}
+
+void FollowerTopologyServiceImpl::GetChunkServer(
+    google::protobuf::RpcController* cntl_base,
+    const GetChunkServerInfoRequest* request,
+    GetChunkServerInfoResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetChunkServer);
+}
+
+void FollowerTopologyServiceImpl::GetServer(
+    google::protobuf::RpcController* cntl_base,
+    const GetServerRequest* request,
+    GetServerResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetServer);
+}
+
+void FollowerTopologyServiceImpl::ListZoneServer(
+    google::protobuf::RpcController* cntl_base,
+    const ListZoneServerRequest* request,
+    ListZoneServerResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListZoneServer);
+}
+
+void FollowerTopologyServiceImpl::GetZone(
+    google::protobuf::RpcController* cntl_base,
+    const ZoneRequest* request,
+    ZoneResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetZone);
+}
+
+void FollowerTopologyServiceImpl::ListPoolZone(
+    google::protobuf::RpcController* cntl_base,
+    const ListPoolZoneRequest* request,
+    ListPoolZoneResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListPoolZone);
+}
+
+void FollowerTopologyServiceImpl::GetPhysicalPool(
+    google::protobuf::RpcController* cntl_base,
+    const PhysicalPoolRequest* request,
+    PhysicalPoolResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetPhysicalPool);
+}
+
+void FollowerTopologyServiceImpl::ListPhysicalPool(
+    google::protobuf::RpcController* cntl_base,
+    const ListPhysicalPoolRequest* request,
+    ListPhysicalPoolResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListPhysicalPool);
+}
+
+void FollowerTopologyServiceImpl::GetLogicalPool(
+    google::protobuf::RpcController* cntl_base,
+    const GetLogicalPoolRequest* request,
+    GetLogicalPoolResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetLogicalPool);
+}
+
+void FollowerTopologyServiceImpl::ListLogicalPool(
+    google::protobuf::RpcController* cntl_base,
+    const ListLogicalPoolRequest* request,
+    ListLogicalPoolResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListLogicalPool);
+}
+
+void FollowerTopologyServiceImpl::GetChunkServerListInCopySets(
+    google::protobuf::RpcController* cntl_base,
+    const GetChunkServerListInCopySetsRequest* request,
+    GetChunkServerListInCopySetsResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetChunkServerListInCopySets);
+}
+
+void FollowerTopologyServiceImpl::GetCopySetsInChunkServer(
+    google::protobuf::RpcController* cntl_base,
+    const GetCopySetsInChunkServerRequest* request,
+    GetCopySetsInChunkServerResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetCopySetsInChunkServer);
+}
+
+void FollowerTopologyServiceImpl::GetCopySetsInCluster(
+    google::protobuf::RpcController* cntl_base,
+    const GetCopySetsInClusterRequest* request,
+    GetCopySetsInClusterResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetCopySetsInCluster);
+}
+
+void FollowerTopologyServiceImpl::GetClusterInfo(
+    google::protobuf::RpcController* cntl_base,
+    const GetClusterInfoRequest* request,
+    GetClusterInfoResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::GetClusterInfo);
+}
+
+void FollowerTopologyServiceImpl::ListUnAvailCopySets(
+    google::protobuf::RpcController* cntl_base,
+    const ListUnAvailCopySetsRequest* request,
+    ListUnAvailCopySetsResponse* response,
+    google::protobuf::Closure* done) {
+    Serve(cntl_base, request, response, done,
+          &TopologyServiceManager::ListUnAvailCopySets);
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
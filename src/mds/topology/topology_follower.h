@@ -0,0 +1,296 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_FOLLOWER_H_
+#define SRC_MDS_TOPOLOGY_TOPOLOGY_FOLLOWER_H_
+
+#include <brpc/server.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "proto/topology.pb.h"
+#include "src/mds/topology/topology.h"
+#include "src/mds/topology/topology_service_manager.h"
+#include "src/mds/topology/topology_storge.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+/**
+ * ReadOnlyTopologyStorage loads the topology from the storage of the leader
+ * and drops every write. TopologyImpl::Init may write, e.g. to clean the
+ * invalid logical pools, a follower only applies the change to its memory
+ * and leaves the storage to the leader.
+ */
+class ReadOnlyTopologyStorage : public TopologyStorage {
+ public:
+    explicit ReadOnlyTopologyStorage(std::shared_ptr<TopologyStorage> storage)
+        : storage_(storage) {}
+
+    bool LoadLogicalPool(
+        std::unordered_map<PoolIdType, LogicalPool> *logicalPoolMap,
+        PoolIdType *maxLogicalPoolId) override {
+        return storage_->LoadLogicalPool(logicalPoolMap, maxLogicalPoolId);
+    }
+    bool LoadPhysicalPool(
+        std::unordered_map<PoolIdType, PhysicalPool> *physicalPoolMap,
+        PoolIdType *maxPhysicalPoolId) override {
+        return storage_->LoadPhysicalPool(physicalPoolMap,
+                                          maxPhysicalPoolId);
+    }
+    bool LoadZone(
+        std::unordered_map<ZoneIdType, Zone> *zoneMap,
+        ZoneIdType *maxZoneId) override {
+        return storage_->LoadZone(zoneMap, maxZoneId);
+    }
+    bool LoadServer(
+        std::unordered_map<ServerIdType, Server> *serverMap,
+        ServerIdType *maxServerId) override {
+        return storage_->LoadServer(serverMap, maxServerId);
+    }
+    bool LoadChunkServer(
+        std::unordered_map<ChunkServerIdType, ChunkServer> *chunkServerMap,
+        ChunkServerIdType *maxChunkServerId) override {
+        return storage_->LoadChunkServer(chunkServerMap, maxChunkServerId);
+    }
+    bool LoadCopySet(
+        std::map<CopySetKey, CopySetInfo> *copySetMap,
+        std::map<PoolIdType, CopySetIdType> *copySetIdMaxMap) override {
+        return storage_->LoadCopySet(copySetMap, copySetIdMaxMap);
+    }
+    bool LoadClusterInfo(std::vector<ClusterInformation> *info) override {
+        return storage_->LoadClusterInfo(info);
+    }
+
+    bool StorageLogicalPool(const LogicalPool &data) override {
+        return true;
+    }
+    bool StoragePhysicalPool(const PhysicalPool &data) override {
+        return true;
+    }
+    bool StorageZone(const Zone &data) override { return true; }
+    bool StorageServer(const Server &data) override { return true; }
+    bool StorageChunkServer(const ChunkServer &data) override {
+        return true;
+    }
+    bool StorageCopySet(const CopySetInfo &data) override { return true; }
+
+    bool DeleteLogicalPool(PoolIdType id) override { return true; }
+    bool DeletePhysicalPool(PoolIdType id) override { return true; }
+    bool DeleteZone(ZoneIdType id) override { return true; }
+    bool DeleteServer(ServerIdType id) override { return true; }
+    bool DeleteChunkServer(ChunkServerIdType id) override { return true; }
+    bool DeleteCopySet(CopySetKey key) override { return true; }
+
+    bool UpdateLogicalPool(const LogicalPool &data) override { return true; }
+    bool UpdatePhysicalPool(const PhysicalPool &data) override {
+        return true;
+    }
+    bool UpdateZone(const Zone &data) override { return true; }
+    bool UpdateServer(const Server &data) override { return true; }
+    bool UpdateChunkServer(const ChunkServer &data) override { return true; }
+    bool UpdateCopySet(const CopySetInfo &data) override { return true; }
+
+    bool StorageClusterInfo(const ClusterInformation &info) override {
+        return true;
+    }
+
+ private:
+    std::shared_ptr<TopologyStorage> storage_;
+};
+
+/**
+ * FollowerTopology keeps an in-memory topology on a mds that is not the
+ * leader. The topology is reloaded from storage every reloadIntervalMs, so
+ * the topology served is at most that old. The online state of the
+ * chunkservers is only known by the leader from the heartbeats and is not
+ * served correctly by a follower.
+ */
+class FollowerTopology {
+ public:
+    FollowerTopology(std::shared_ptr<TopologyStorage> storage,
+                     const TopologyOption &option,
+                     uint32_t reloadIntervalMs)
+        : storage_(std::make_shared<ReadOnlyTopologyStorage>(storage)),
+          option_(option),
+          reloadIntervalMs_(reloadIntervalMs),
+          isStop_(true) {}
+
+    ~FollowerTopology() {
+        Stop();
+    }
+
+    /**
+     * @brief load the whole topology from storage and replace the one served
+     *
+     * @return error code
+     */
+    int Reload();
+
+    /**
+     * @brief start the background thread reloading the topology
+     */
+    int Run();
+    int Stop();
+
+    /**
+     * @brief get the service manager on the latest topology loaded
+     *
+     * @return nullptr if the topology has never been loaded
+     */
+    std::shared_ptr<TopologyServiceManager> GetServiceManager();
+
+ private:
+    void BackEndFunc();
+
+ private:
+    std::shared_ptr<TopologyStorage> storage_;
+    TopologyOption option_;
+    uint32_t reloadIntervalMs_;
+
+    // protect serviceManager_, which is replaced by every reload
+    std::mutex mutex_;
+    std::shared_ptr<TopologyServiceManager> serviceManager_;
+
+    curve::common::Thread backEndThread_;
+    std::atomic_bool isStop_;
+    curve::common::InterruptibleSleeper sleeper_;
+};
+
+/**
+ * FollowerTopologyServiceImpl serves the read-only topology requests from
+ * the topology of a FollowerTopology, other requests fail with
+ * "not implemented" and should be sent to the leader.
+ */
+class FollowerTopologyServiceImpl : public TopologyService {
+ public:
+    explicit FollowerTopologyServiceImpl(
+        std::shared_ptr<FollowerTopology> topology)
+        : topology_(topology) {}
+
+    void ListChunkServer(google::protobuf::RpcController* cntl_base,
+                         const ListChunkServerRequest* request,
+                         ListChunkServerResponse* response,
+                         google::protobuf::Closure* done) override;
+
+    void GetChunkServer(google::protobuf::RpcController* cntl_base,
+                        const GetChunkServerInfoRequest* request,
+                        GetChunkServerInfoResponse* response,
+                        google::protobuf::Closure* done) override;
+
+    void GetServer(google::protobuf::RpcController* cntl_base,
+                   const GetServerRequest* request,
+                   GetServerResponse* response,
+                   google::protobuf::Closure* done) override;
+
+    void ListZoneServer(google::protobuf::RpcController* cntl_base,
+                        const ListZoneServerRequest* request,
+                        ListZoneServerResponse* response,
+                        google::protobuf::Closure* done) override;
+
+    void GetZone(google::protobuf::RpcController* cntl_base,
+                 const ZoneRequest* request,
+                 ZoneResponse* response,
+                 google::protobuf::Closure* done) override;
+
+    void ListPoolZone(google::protobuf::RpcController* cntl_base,
+                      const ListPoolZoneRequest* request,
+                      ListPoolZoneResponse* response,
+                      google::protobuf::Closure* done) override;
+
+    void GetPhysicalPool(google::protobuf::RpcController* cntl_base,
+                         const PhysicalPoolRequest* request,
+                         PhysicalPoolResponse* response,
+                         google::protobuf::Closure* done) override;
+
+    void ListPhysicalPool(google::protobuf::RpcController* cntl_base,
+                          const ListPhysicalPoolRequest* request,
+                          ListPhysicalPoolResponse* response,
+                          google::protobuf::Closure* done) override;
+
+    void GetLogicalPool(google::protobuf::RpcController* cntl_base,
+                        const GetLogicalPoolRequest* request,
+                        GetLogicalPoolResponse* response,
+                        google::protobuf::Closure* done) override;
+
+    void ListLogicalPool(google::protobuf::RpcController* cntl_base,
+                         const ListLogicalPoolRequest* request,
+                         ListLogicalPoolResponse* response,
+                         google::protobuf::Closure* done) override;
+
+    void GetChunkServerListInCopySets(
+        google::protobuf::RpcController* cntl_base,
+        const GetChunkServerListInCopySetsRequest* request,
+        GetChunkServerListInCopySetsResponse* response,
+        google::protobuf::Closure* done) override;
+
+    void GetCopySetsInChunkServer(
+        google::protobuf::RpcController* cntl_base,
+        const GetCopySetsInChunkServerRequest* request,
+        GetCopySetsInChunkServerResponse* response,
+        google::protobuf::Closure* done) override;
+
+    void GetCopySetsInCluster(
+        google::protobuf::RpcController* cntl_base,
+        const GetCopySetsInClusterRequest* request,
+        GetCopySetsInClusterResponse* response,
+        google::protobuf::Closure* done) override;
+
+    void GetClusterInfo(google::protobuf::RpcController* cntl_base,
+                        const GetClusterInfoRequest* request,
+                        GetClusterInfoResponse* response,
+                        google::protobuf::Closure* done) override;
+
+    void ListUnAvailCopySets(google::protobuf::RpcController* cntl_base,
+                             const ListUnAvailCopySetsRequest* request,
+                             ListUnAvailCopySetsResponse* response,
+                             google::protobuf::Closure* done) override;
+
+ private:
+    /**
+     * @brief serve a read request with the service manager on the latest
+     *        topology, the rpc fails if the topology is not loaded yet
+     */
+    template <typename Request, typename Response>
+    void Serve(google::protobuf::RpcController* cntl_base,
+               const Request* request,
+               Response* response,
+               google::protobuf::Closure* done,
+               void (TopologyServiceManager::*func)(const Request*,
+                                                    Response*));
+
+ private:
+    std::shared_ptr<FollowerTopology> topology_;
+};
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_TOPOLOGY_TOPOLOGY_FOLLOWER_H_
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/snapshotcloneserver/clone/clone_chunk_heat.h"
+
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+
+namespace curve {
+namespace snapshotcloneserver {
+
+CloneChunkHeatMap::CloneChunkHeatMap(uint32_t windowSec)
+    : windowSec_(std::max<uint32_t>(1, windowSec)) {}
+
+void CloneChunkHeatMap::RegisterTask(const TaskIdType &taskId,
+    const std::vector<uint64_t> &chunkIds) {
+    LockGuard guard(mutex_);
+    TaskHeat &heat = taskHeats_[taskId];
+    heat.missCounts.clear();
+    heat.windowStart = TimeUtility::GetTimeofDaySec();
+    heat.windowMiss = 0;
+    heat.lastRate = 0;
+    for (uint64_t chunkId : chunkIds) {
+        chunkTasks_[chunkId] = taskId;
+    }
+}
+
+void CloneChunkHeatMap::UnregisterTask(const TaskIdType &taskId) {
+    LockGuard guard(mutex_);
+    for (auto it = chunkTasks_.begin(); it != chunkTasks_.end();) {
+        if (it->second == taskId) {
+            it = chunkTasks_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    taskHeats_.erase(taskId);
+}
+
+void CloneChunkHeatMap::ReportReadMiss(
+    const std::map<uint64_t, uint32_t> &missCounts) {
+    uint64_t now = TimeUtility::GetTimeofDaySec();
+    LockGuard guard(mutex_);
+    for (const auto &item : missCounts) {
+        auto chunkIt = chunkTasks_.find(item.first);
+        if (chunkIt == chunkTasks_.end()) {
+            continue;
+        }
+        auto heatIt = taskHeats_.find(chunkIt->second);
+        if (heatIt == taskHeats_.end()) {
+            continue;
+        }
+        TaskHeat &heat = heatIt->second;
+        RollWindow(&heat, now);
+        heat.missCounts[item.first] += item.second;
+        heat.windowMiss += item.second;
+    }
+}
+
+bool CloneChunkHeatMap::PopHottestChunk(const TaskIdType &taskId,
+    uint64_t *chunkId) {
+    LockGuard guard(mutex_);
+    auto heatIt = taskHeats_.find(taskId);
+    if (heatIt == taskHeats_.end() || heatIt->second.missCounts.empty()) {
+        return false;
+    }
+    auto &missCounts = heatIt->second.missCounts;
+    auto hottest = std::max_element(missCounts.begin(), missCounts.end(),
+        [](const std::pair<const uint64_t, uint64_t> &a,
+           const std::pair<const uint64_t, uint64_t> &b) {
+            return a.second < b.second;
+        });
+    *chunkId = hottest->first;
+    missCounts.erase(hottest);
+    chunkTasks_.erase(*chunkId);
+    return true;
+}
+
+void CloneChunkHeatMap::RemoveChunk(uint64_t chunkId) {
+    LockGuard guard(mutex_);
+    auto chunkIt = chunkTasks_.find(chunkId);
+    if (chunkIt == chunkTasks_.end()) {
+        return;
+    }
+    auto heatIt = taskHeats_.find(chunkIt->second);
+    if (heatIt != taskHeats_.end()) {
+        heatIt->second.missCounts.erase(chunkId);
+    }
+    chunkTasks_.erase(chunkIt);
+}
+
+uint64_t CloneChunkHeatMap::GetReadMissRate(const TaskIdType &taskId) {
+    uint64_t now = TimeUtility::GetTimeofDaySec();
+    LockGuard guard(mutex_);
+    auto heatIt = taskHeats_.find(taskId);
+    if (heatIt == taskHeats_.end()) {
+        return 0;
+    }
+    RollWindow(&heatIt->second, now);
+    return heatIt->second.lastRate;
+}
+
+void CloneChunkHeatMap::RollWindow(TaskHeat *heat, uint64_t now) {
+    if (now < heat->windowStart + windowSec_) {
+        return;
+    }
+    // 长时间没有读缺失时，窗口被拉长，速率随之下降
+    heat->lastRate = heat->windowMiss / (now - heat->windowStart);
+    heat->windowStart = now;
+    heat->windowMiss = 0;
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_SNAPSHOTCLONESERVER_CLONE_CLONE_CHUNK_HEAT_H_
+#define SRC_SNAPSHOTCLONESERVER_CLONE_CLONE_CHUNK_HEAT_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/snapshotclone/snapshotclone_define.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+/**
+ * @brief 记录lazy克隆卷未恢复chunk的读缺失，用于决定RecoverChunk的顺序和速度
+ * @detail
+ *  chunkserver在读取未恢复的克隆chunk需要从源端下载时上报读缺失，
+ *  1. 读缺失次数多的chunk优先恢复
+ *  2. 任务最近的读缺失速率反映前台IO对未恢复数据的压力，用于限制恢复并发
+ *  只记录已登记的任务中尚未开始恢复的chunk，chunkId全局唯一
+ */
+class CloneChunkHeatMap {
+ public:
+    /**
+     * @param windowSec 统计读缺失速率的时间窗口(秒)
+     */
+    explicit CloneChunkHeatMap(uint32_t windowSec);
+
+    /**
+     * @brief 登记任务待恢复的chunk
+     *
+     * @param taskId 任务id
+     * @param chunkIds 待恢复的chunk
+     */
+    void RegisterTask(const TaskIdType &taskId,
+        const std::vector<uint64_t> &chunkIds);
+
+    /**
+     * @brief 注销任务，清除其全部记录
+     *
+     * @param taskId 任务id
+     */
+    void UnregisterTask(const TaskIdType &taskId);
+
+    /**
+     * @brief 记录读缺失，未登记的chunk忽略
+     *
+     * @param missCounts key为chunkId，value为读缺失次数
+     */
+    void ReportReadMiss(const std::map<uint64_t, uint32_t> &missCounts);
+
+    /**
+     * @brief 取出任务中读缺失最多的chunk，取出的chunk不再记录
+     *
+     * @param taskId 任务id
+     * @param[out] chunkId 读缺失最多的chunk
+     *
+     * @retval true 取出成功
+     * @retval false 任务没有发生读缺失的chunk
+     */
+    bool PopHottestChunk(const TaskIdType &taskId, uint64_t *chunkId);
+
+    /**
+     * @brief chunk已开始恢复，不再记录
+     *
+     * @param chunkId chunk id
+     */
+    void RemoveChunk(uint64_t chunkId);
+
+    /**
+     * @brief 获取任务最近一个时间窗口的读缺失速率
+     *
+     * @param taskId 任务id
+     *
+     * @return 读缺失速率(次/秒)
+     */
+    uint64_t GetReadMissRate(const TaskIdType &taskId);
+
+ private:
+    struct TaskHeat {
+        // 尚未开始恢复的chunk的读缺失次数，只包含发生过读缺失的chunk
+        std::unordered_map<uint64_t, uint64_t> missCounts;
+        // 当前时间窗口的开始时间(秒)
+        uint64_t windowStart;
+        // 当前时间窗口的读缺失次数
+        uint64_t windowMiss;
+        // 上一个时间窗口的读缺失速率
+        uint64_t lastRate;
+    };
+
+    void RollWindow(TaskHeat *heat, uint64_t now);
+
+ private:
+    uint32_t windowSec_;
+    curve::common::Mutex mutex_;
+    // 尚未开始恢复的chunk所属的任务
+    std::unordered_map<uint64_t, TaskIdType> chunkTasks_;
+    std::unordered_map<TaskIdType, TaskHeat> taskHeats_;
+};
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
+
+#endif  // SRC_SNAPSHOTCLONESERVER_CLONE_CLONE_CHUNK_HEAT_H_
@@ -26,16 +26,22 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <unordered_map>
+#include <map>
+#include <utility>
+#include <algorithm>
 
 #include "src/snapshotcloneserver/clone/clone_task.h"
 #include "src/common/location_operator.h"
 #include "src/common/uuid.h"
 #include "src/common/concurrent/name_lock.h"
+#include "src/common/chunk_codec.h"
 
 using ::curve::common::UUIDGenerator;
 using ::curve::common::LocationOperator;
 using ::curve::common::NameLock;
 using ::curve::common::NameLockGuard;
+using ::curve::common::ChunkCodec;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -48,6 +54,18 @@ int CloneCoreImpl::Init() {
                    << ", dirpath = " << cloneTempDir_;
         return kErrCodeServerInitFail;
     }
+    ret = mergeDeltaPool_.Start(
+        std::max<uint32_t>(1, createCloneChunkConcurrency_));
+    if (ret < 0) {
+        LOG(ERROR) << "Start merge delta pool fail, ret = " << ret;
+        return kErrCodeServerInitFail;
+    }
+    ret = bulkReadPool_.Start(
+        std::max<uint32_t>(1, bulkReadConcurrency_));
+    if (ret < 0) {
+        LOG(ERROR) << "Start bulk read pool fail, ret = " << ret;
+        return kErrCodeServerInitFail;
+    }
     return kErrCodeSuccess;
 }
 
@@ -234,6 +252,11 @@ int CloneCoreImpl::CloneOrRecoverPre(const UUID &source,
     UUID uuid = UUIDGenerator().GenerateUUID();
     CloneInfo info(uuid, user, taskType,
         source, destination, fileType, lazyFlag);
+    // 是否批量写入随任务持久化，重启后按相同的方式继续
+    if (bulkRestoreEnable_ && !lazyFlag &&
+        CloneFileType::kSnapshot == fileType) {
+        info.SetIsBulk(true);
+    }
     if (CloneTaskType::kClone == taskType) {
         info.SetStatus(CloneStatus::cloning);
     } else {
@@ -509,6 +532,9 @@ int CloneCoreImpl::BuildFileInfoFromSnapshot(
         CloneChunkInfo info;
         info.location = chunkDataName.ToDataChunkKey();
         info.needRecover = true;
+        // 按页增量存储的chunk在CreateCloneChunk时并行合并出全量数据
+        info.needMerge = snapMeta.GetChunkDeltaBase(chunkIndex,
+                                                    &info.deltaBase);
         if (IsRecover(task)) {
             info.seqNum = chunkDataName.chunkSeqNum_;
         } else {
@@ -701,6 +727,33 @@ int CloneCoreImpl::CreateCloneChunk(
     const FInfo &fInfo,
     CloneSegmentMap *segInfos) {
     int ret = kErrCodeSuccess;
+    // 按页增量存储的chunk需合并出全量数据，供chunkserver直接读取
+    auto mergeTracker = std::make_shared<TaskTracker>();
+    // 批量写入时chunk由WriteChunkBulk直接创建，不需要clone chunk
+    if (IsBulk(task)) {
+        for (auto & cloneSegmentInfo : *segInfos) {
+            for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
+                ret = StartAsyncMergeChunkDelta(task, mergeTracker,
+                    cloneChunkInfo.second);
+                if (ret < 0) {
+                    return kErrCodeInternalError;
+                }
+            }
+        }
+        mergeTracker->Wait();
+        if (mergeTracker->GetResult() < 0) {
+            return kErrCodeInternalError;
+        }
+        task->GetCloneInfo().SetNextStep(CloneStep::kCompleteCloneMeta);
+        ret = metaStore_->UpdateCloneInfo(task->GetCloneInfo());
+        if (ret < 0) {
+            LOG(ERROR) << "UpdateCloneInfo after CreateCloneChunk error."
+                       << " ret = " << ret
+                       << ", taskid = " << task->GetTaskId();
+            return kErrCodeInternalError;
+        }
+        return kErrCodeSuccess;
+    }
     uint32_t chunkSize = fInfo.chunksize;
     uint32_t correctSn = 0;
     // 克隆时correctSn为0，恢复时为新产生的文件版本
@@ -710,11 +763,33 @@ int CloneCoreImpl::CreateCloneChunk(
         correctSn = fInfo.seqnum;
     }
     auto tracker = std::make_shared<CreateCloneChunkTaskTracker>();
+    auto sendRequest = [&](CreateCloneChunkContextPtr context) {
+        context->csn = correctSn;
+        context->chunkSize = chunkSize;
+        context->taskid = task->GetTaskId();
+        context->startTime = TimeUtility::GetTimeofDaySec();
+        context->clientAsyncMethodRetryTimeSec =
+            clientAsyncMethodRetryTimeSec_;
+        int ret = StartAsyncCreateCloneChunk(task, tracker, context);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+
+        if (tracker->GetTaskNum() >= createCloneChunkConcurrency_) {
+            tracker->WaitSome(1);
+        }
+        std::list<CreateCloneChunkContextPtr> results =
+            tracker->PopResultContexts();
+        return HandleCreateCloneChunkResultsAndRetry(task, tracker, results);
+    };
+    // 批量创建时各copyset上尚未发送的chunk
+    std::map<std::pair<LogicPoolID, CopysetID>, CreateCloneChunkContextPtr>
+        batches;
     for (auto & cloneSegmentInfo : *segInfos) {
         for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
             std::string location;
             if (IsSnapshot(task)) {
-                location = LocationOperator::GenerateS3Location(
+                location = dataStore_->GetChunkDataLocation(
                     cloneChunkInfo.second.location);
             } else {
                 location = LocationOperator::GenerateCurveLocation(
@@ -722,35 +797,61 @@ int CloneCoreImpl::CreateCloneChunk(
                     std::stoull(cloneChunkInfo.second.location));
             }
             ChunkIDInfo cidInfo = cloneChunkInfo.second.chunkIdInfo;
-
-            auto context = std::make_shared<CreateCloneChunkContext>();
-            context->location = location;
-            context->cidInfo = cidInfo;
-            context->cloneChunkInfo = &cloneChunkInfo.second;
-            context->sn = cloneChunkInfo.second.seqNum;
-            context->csn = correctSn;
-            context->chunkSize = chunkSize;
-            context->taskid = task->GetTaskId();
-            context->startTime = TimeUtility::GetTimeofDaySec();
-            context->clientAsyncMethodRetryTimeSec =
-                clientAsyncMethodRetryTimeSec_;
-
-            ret = StartAsyncCreateCloneChunk(task, tracker, context);
+            ret = StartAsyncMergeChunkDelta(task, mergeTracker,
+                cloneChunkInfo.second);
             if (ret < 0) {
                 return kErrCodeInternalError;
             }
 
-            if (tracker->GetTaskNum() >= createCloneChunkConcurrency_) {
-                tracker->WaitSome(1);
+            if (createCloneChunkBatchSize_ <= 1) {
+                auto context = std::make_shared<CreateCloneChunkContext>();
+                context->location = location;
+                context->cidInfo = cidInfo;
+                context->cloneChunkInfo = &cloneChunkInfo.second;
+                context->sn = cloneChunkInfo.second.seqNum;
+                ret = sendRequest(context);
+                if (ret < 0) {
+                    return kErrCodeInternalError;
+                }
+                continue;
+            }
+
+            auto &batch = batches[std::make_pair(cidInfo.lpid_,
+                cidInfo.cpid_)];
+            if (nullptr == batch) {
+                batch = std::make_shared<CreateCloneChunkContext>();
+                batch->cidInfo = cidInfo;
+                batch->cloneChunkInfo = nullptr;
+                batch->sn = 0;
             }
-            std::list<CreateCloneChunkContextPtr> results =
-                tracker->PopResultContexts();
-            ret = HandleCreateCloneChunkResultsAndRetry(task, tracker, results);
-            if (ret < 0) {
-                return kErrCodeInternalError;
+            CloneChunkBatchItem item;
+            item.cid = cidInfo.cid_;
+            item.location = location;
+            item.sn = cloneChunkInfo.second.seqNum;
+            item.correctedSn = correctSn;
+            item.chunkSize = chunkSize;
+            batch->batchItems.push_back(item);
+            batch->batchChunkInfos.push_back(&cloneChunkInfo.second);
+            if (batch->batchItems.size() >= createCloneChunkBatchSize_) {
+                CreateCloneChunkContextPtr context = batch;
+                batch = nullptr;
+                ret = sendRequest(context);
+                if (ret < 0) {
+                    return kErrCodeInternalError;
+                }
             }
         }
     }
+    // 发送各copyset上不足一批的chunk
+    for (auto &batch : batches) {
+        if (nullptr == batch.second) {
+            continue;
+        }
+        ret = sendRequest(batch.second);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+    }
     // 最后剩余数量不足的任务
     do {
         tracker->WaitSome(1);
@@ -765,6 +866,11 @@ int CloneCoreImpl::CreateCloneChunk(
             return kErrCodeInternalError;
         }
     } while (true);
+    // chunkserver读clone chunk时对象必须已经存在
+    mergeTracker->Wait();
+    if (mergeTracker->GetResult() < 0) {
+        return kErrCodeInternalError;
+    }
 
     if (IsLazy(task) && IsFile(task)) {
         task->GetCloneInfo().SetNextStep(CloneStep::kRecoverChunk);
@@ -781,6 +887,44 @@ int CloneCoreImpl::CreateCloneChunk(
     return kErrCodeSuccess;
 }
 
+int CloneCoreImpl::StartAsyncMergeChunkDelta(
+    std::shared_ptr<CloneTaskInfo> task,
+    std::shared_ptr<TaskTracker> tracker,
+    const CloneChunkInfo &info) {
+    if (!info.needMerge) {
+        return kErrCodeSuccess;
+    }
+    ChunkDataName chunkDataName;
+    if (!ToChunkDataName(info.location, &chunkDataName)) {
+        return kErrCodeInternalError;
+    }
+    ChunkDataName base = info.deltaBase;
+    std::shared_ptr<SnapshotDataStore> dataStore = dataStore_;
+    TaskIdType taskId = task->GetTaskId();
+    tracker->AddOneTrace();
+    mergeDeltaPool_.Enqueue([=]() {
+        int ret = kErrCodeSuccess;
+        // 重试时chunk可能已经合并过
+        if (!dataStore->ChunkDataExist(chunkDataName)) {
+            ret = dataStore->MergeChunkDeltaData(chunkDataName, base);
+        }
+        if (ret < 0) {
+            LOG(ERROR) << "MergeChunkDeltaData error"
+                       << ", ret = " << ret
+                       << ", chunkDataName = "
+                       << chunkDataName.ToDataChunkKey()
+                       << ", base = " << base.ToDataChunkKey()
+                       << ", taskid = " << taskId;
+            ret = kErrCodeInternalError;
+        }
+        tracker->HandleResponse(ret);
+    });
+    if (tracker->GetTaskNum() >= createCloneChunkConcurrency_) {
+        tracker->WaitSome(1);
+    }
+    return tracker->GetResult();
+}
+
 int CloneCoreImpl::StartAsyncCreateCloneChunk(
     std::shared_ptr<CloneTaskInfo> task,
     std::shared_ptr<CreateCloneChunkTaskTracker> tracker,
@@ -788,6 +932,29 @@ int CloneCoreImpl::StartAsyncCreateCloneChunk(
     CreateCloneChunkClosure *cb =
         new CreateCloneChunkClosure(tracker, context);
     tracker->AddOneTrace();
+    if (!context->batchItems.empty()) {
+        LOG(INFO) << "Doing CreateCloneChunkBatch"
+                  << ", logicalPoolId = " << context->cidInfo.lpid_
+                  << ", copysetId = " << context->cidInfo.cpid_
+                  << ", firstChunkId = " << context->cidInfo.cid_
+                  << ", batchSize = " << context->batchItems.size()
+                  << ", csn = " << context->csn
+                  << ", taskid = " << task->GetTaskId();
+        int ret = client_->CreateCloneChunkBatch(context->cidInfo,
+            &context->batchItems,
+            cb);
+        if (ret != LIBCURVE_ERROR::OK) {
+            LOG(ERROR) << "CreateCloneChunkBatch fail"
+                       << ", ret = " << ret
+                       << ", logicalPoolId = " << context->cidInfo.lpid_
+                       << ", copysetId = " << context->cidInfo.cpid_
+                       << ", firstChunkId = " << context->cidInfo.cid_
+                       << ", batchSize = " << context->batchItems.size()
+                       << ", taskid = " << task->GetTaskId();
+            return ret;
+        }
+        return kErrCodeSuccess;
+    }
     LOG(INFO) << "Doing CreateCloneChunk"
               << ", location = " << context->location
               << ", logicalPoolId = " << context->cidInfo.lpid_
@@ -834,6 +1001,23 @@ int CloneCoreImpl::HandleCreateCloneChunkResultsAndRetry(
                       << ", csn = " << context->csn
                       << ", taskid = " << task->GetTaskId();
             context->cloneChunkInfo->needRecover = false;
+        } else if (context->retCode == LIBCURVE_ERROR::OK) {
+            // 批量创建时逐个检查chunk是否已存在
+            for (size_t i = 0; i < context->batchItems.size(); i++) {
+                const CloneChunkBatchItem &item = context->batchItems[i];
+                if (item.ret == -LIBCURVE_ERROR::EXISTS) {
+                    LOG(INFO) << "CreateCloneChunkBatch chunk exist"
+                              << ", location = " << item.location
+                              << ", logicalPoolId = "
+                              << context->cidInfo.lpid_
+                              << ", copysetId = " << context->cidInfo.cpid_
+                              << ", chunkId = " << item.cid
+                              << ", seqNum = " << item.sn
+                              << ", csn = " << item.correctedSn
+                              << ", taskid = " << task->GetTaskId();
+                    context->batchChunkInfos[i]->needRecover = false;
+                }
+            }
         } else if (context->retCode != LIBCURVE_ERROR::OK) {
             uint64_t nowTime = TimeUtility::GetTimeofDaySec();
             if (nowTime - context->startTime <
@@ -898,12 +1082,6 @@ int CloneCoreImpl::RecoverChunk(
     int ret = kErrCodeSuccess;
     uint32_t chunkSize = fInfo.chunksize;
 
-    uint32_t totalProgress =
-        kProgressRecoverChunkEnd - kProgressRecoverChunkBegin;
-    uint32_t segNum = segInfos.size();
-    double progressPerData = static_cast<double>(totalProgress) / segNum;
-    uint32_t index = 0;
-
     if (0 == cloneChunkSplitSize_ ||
         chunkSize % cloneChunkSplitSize_ != 0) {
         LOG(ERROR) << "chunk is not align to cloneChunkSplitSize"
@@ -911,54 +1089,389 @@ int CloneCoreImpl::RecoverChunk(
         return kErrCodeChunkSizeNotAligned;
     }
 
-    auto tracker = std::make_shared<RecoverChunkTaskTracker>();
-    uint64_t workingChunkNum = 0;
-    // 为避免发往同一个chunk碰撞，异步请求不同的chunk
+    if (IsBulk(task)) {
+        ret = BulkWriteChunk(task, fInfo, segInfos);
+    } else {
+        std::vector<const CloneChunkInfo *> chunks;
+        std::vector<uint64_t> chunkIds;
+        for (auto & cloneSegmentInfo : segInfos) {
+            for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
+                if (!cloneChunkInfo.second.needRecover) {
+                    continue;
+                }
+                chunks.push_back(&cloneChunkInfo.second);
+                chunkIds.push_back(cloneChunkInfo.second.chunkIdInfo.cid_);
+            }
+        }
+
+        // 登记后chunkserver上报的读缺失才会被记录
+        chunkHeatMap_->RegisterTask(task->GetTaskId(), chunkIds);
+        ret = ScheduleRecoverChunk(task, chunkSize, chunks);
+        chunkHeatMap_->UnregisterTask(task->GetTaskId());
+    }
+    if (ret < 0) {
+        return kErrCodeInternalError;
+    }
+
+    task->GetCloneInfo().SetNextStep(CloneStep::kCompleteCloneFile);
+    ret = metaStore_->UpdateCloneInfo(task->GetCloneInfo());
+    if (ret < 0) {
+        LOG(ERROR) << "UpdateCloneInfo after RecoverChunk error."
+                   << " ret = " << ret
+                   << ", taskid = " << task->GetTaskId();
+        return kErrCodeInternalError;
+    }
+    return kErrCodeSuccess;
+}
+
+int CloneCoreImpl::BulkWriteChunk(
+    std::shared_ptr<CloneTaskInfo> task,
+    const FInfo &fInfo,
+    const CloneSegmentMap &segInfos) {
+    int ret = kErrCodeSuccess;
+    uint32_t chunkSize = fInfo.chunksize;
+    uint64_t maxSize = std::max<uint64_t>(bulkWriteMaxSize_,
+        cloneChunkSplitSize_);
+    // 各copyset上尚未发送的数据总量超过该值时全部发送，限制内存占用
+    uint64_t maxPendingSize =
+        maxSize * std::max<uint32_t>(1, bulkWriteConcurrency_);
+    uint32_t totalProgress =
+        kProgressRecoverChunkEnd - kProgressRecoverChunkBegin;
+    uint64_t totalChunkNum = 0;
+    for (auto & cloneSegmentInfo : segInfos) {
+        totalChunkNum += cloneSegmentInfo.second.size();
+    }
+
+    auto tracker = std::make_shared<BulkWriteChunkTaskTracker>();
+    auto sendRequest = [&](BulkWriteChunkContextPtr context) {
+        context->taskid = task->GetTaskId();
+        context->startTime = TimeUtility::GetTimeofDaySec();
+        context->clientAsyncMethodRetryTimeSec =
+            clientAsyncMethodRetryTimeSec_;
+        int ret = StartAsyncBulkWriteChunk(task, tracker, context);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+
+        if (tracker->GetTaskNum() >= bulkWriteConcurrency_) {
+            tracker->WaitSome(1);
+        }
+        std::list<BulkWriteChunkContextPtr> results =
+            tracker->PopResultContexts();
+        return HandleBulkWriteChunkResultsAndRetry(task, tracker, results);
+    };
+    // 各copyset上尚未发送的数据
+    std::map<std::pair<LogicPoolID, CopysetID>, BulkWriteChunkContextPtr>
+        batches;
+    uint64_t pendingSize = 0;
+    auto flushAll = [&]() {
+        for (auto &batch : batches) {
+            if (nullptr == batch.second) {
+                continue;
+            }
+            BulkWriteChunkContextPtr context = batch.second;
+            batch.second = nullptr;
+            int ret = sendRequest(context);
+            if (ret < 0) {
+                return kErrCodeInternalError;
+            }
+        }
+        pendingSize = 0;
+        return kErrCodeSuccess;
+    };
+
+    std::vector<const CloneChunkInfo *> chunks;
     for (auto & cloneSegmentInfo : segInfos) {
         for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
-            if (!cloneChunkInfo.second.needRecover) {
+            chunks.push_back(&cloneChunkInfo.second);
+        }
+    }
+    // 按顺序处理chunk，之后的chunk数据在后台预读
+    uint32_t readConcurrency = std::max<uint32_t>(1, bulkReadConcurrency_);
+    std::list<BulkReadChunkContextPtr> readings;
+    size_t nextRead = 0;
+
+    uint64_t doneChunkNum = 0;
+    uint64_t skipSplitNum = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        while (nextRead < chunks.size() &&
+            readings.size() < readConcurrency) {
+            BulkReadChunkContextPtr reading =
+                StartAsyncReadChunkData(task, *chunks[nextRead]);
+            if (nullptr == reading) {
+                return kErrCodeInternalError;
+            }
+            readings.push_back(reading);
+            nextRead++;
+        }
+        BulkReadChunkContextPtr reading = readings.front();
+        readings.pop_front();
+        reading->done.Wait();
+        const CloneChunkInfo &info = *chunks[i];
+        ChunkIDInfo cidInfo = info.chunkIdInfo;
+        if (reading->retCode < 0) {
+            LOG(ERROR) << "GetChunkData fail"
+                       << ", location = " << info.location
+                       << ", chunkId = " << cidInfo.cid_
+                       << ", taskid = " << task->GetTaskId();
+            return kErrCodeInternalError;
+        }
+        // 数据不足chunk大小时，之后的部分视为全零
+        const std::string &data = reading->chunkData.data_;
+        if (data.size() > chunkSize) {
+            LOG(ERROR) << "chunk data is larger than chunk size"
+                       << ", location = " << info.location
+                       << ", dataSize = " << data.size()
+                       << ", chunkSize = " << chunkSize
+                       << ", taskid = " << task->GetTaskId();
+            return kErrCodeInternalError;
+        }
+        for (uint64_t offset = 0; offset < data.size();
+            offset += cloneChunkSplitSize_) {
+            uint64_t len = std::min<uint64_t>(cloneChunkSplitSize_,
+                data.size() - offset);
+            // 新文件上未写过的区域读出为零，全零的分片不需要写入
+            if (ChunkCodec::IsZero(data.data() + offset, len)) {
+                skipSplitNum++;
                 continue;
             }
-            // 当前并发工作的chunk数已大于要求的并发数时，先消化一部分
-            while (workingChunkNum >= recoverChunkConcurrency_) {
-                uint64_t completeChunkNum = 0;
-                ret = ContinueAsyncRecoverChunkPartAndWaitSomeChunkEnd(task,
-                    tracker,
-                    &completeChunkNum);
+            auto &batch = batches[std::make_pair(cidInfo.lpid_,
+                cidInfo.cpid_)];
+            if (nullptr == batch) {
+                batch = std::make_shared<BulkWriteChunkContext>();
+                batch->cidInfo = cidInfo;
+            }
+            // 同一chunk上连续的分片合并为一段
+            if (!batch->batchItems.empty() &&
+                batch->batchItems.back().cid == cidInfo.cid_ &&
+                batch->batchItems.back().offset +
+                    batch->batchItems.back().len == offset) {
+                batch->batchItems.back().len += len;
+            } else {
+                CloneChunkBatchItem item;
+                item.cid = cidInfo.cid_;
+                item.sn = fInfo.seqnum;
+                item.offset = offset;
+                item.len = len;
+                batch->batchItems.push_back(item);
+            }
+            batch->data.append(data.data() + offset, len);
+            pendingSize += len;
+            if (batch->data.size() >= maxSize) {
+                BulkWriteChunkContextPtr context = batch;
+                batch = nullptr;
+                pendingSize -= context->data.size();
+                ret = sendRequest(context);
                 if (ret < 0) {
                     return kErrCodeInternalError;
                 }
-                workingChunkNum -= completeChunkNum;
             }
-            // 加入新的工作的chunk
-            workingChunkNum++;
-            auto context = std::make_shared<RecoverChunkContext>();
-            context->cidInfo = cloneChunkInfo.second.chunkIdInfo;
-            context->totalPartNum = chunkSize / cloneChunkSplitSize_;
-            context->partIndex = 0;
-            context->partSize = cloneChunkSplitSize_;
-            context->taskid = task->GetTaskId();
-            context->startTime = TimeUtility::GetTimeofDaySec();
-            context->clientAsyncMethodRetryTimeSec =
-                clientAsyncMethodRetryTimeSec_;
+        }
+        if (pendingSize >= maxPendingSize) {
+            ret = flushAll();
+            if (ret < 0) {
+                return kErrCodeInternalError;
+            }
+        }
+        doneChunkNum++;
+        task->SetProgress(static_cast<uint32_t>(
+            kProgressRecoverChunkBegin +
+            doneChunkNum * totalProgress / totalChunkNum));
+        task->UpdateMetric();
+    }
+    // 发送各copyset上剩余的数据
+    ret = flushAll();
+    if (ret < 0) {
+        return kErrCodeInternalError;
+    }
+    do {
+        tracker->WaitSome(1);
+        std::list<BulkWriteChunkContextPtr> results =
+            tracker->PopResultContexts();
+        if (0 == results.size()) {
+            // 已经完成，没有新的结果了
+            break;
+        }
+        ret = HandleBulkWriteChunkResultsAndRetry(task, tracker, results);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+    } while (true);
+    LOG(INFO) << "BulkWriteChunk finish"
+              << ", chunkNum = " << totalChunkNum
+              << ", skipSplitNum = " << skipSplitNum
+              << ", taskid = " << task->GetTaskId();
+    return kErrCodeSuccess;
+}
 
-            LOG(INFO) << "RecoverChunk start"
-                       << ", logicalPoolId = "
-                       << context->cidInfo.lpid_
-                       << ", copysetId = " << context->cidInfo.cpid_
-                       << ", chunkId = " << context->cidInfo.cid_
-                       << ", len = " << context->partSize
+int CloneCoreImpl::StartAsyncBulkWriteChunk(
+    std::shared_ptr<CloneTaskInfo> task,
+    std::shared_ptr<BulkWriteChunkTaskTracker> tracker,
+    std::shared_ptr<BulkWriteChunkContext> context) {
+    BulkWriteChunkClosure *cb =
+        new BulkWriteChunkClosure(tracker, context);
+    tracker->AddOneTrace();
+    LOG_EVERY_SECOND(INFO) << "Doing WriteChunkBulk"
+                           << ", logicalPoolId = " << context->cidInfo.lpid_
+                           << ", copysetId = " << context->cidInfo.cpid_
+                           << ", firstChunkId = " << context->cidInfo.cid_
+                           << ", batchSize = " << context->batchItems.size()
+                           << ", dataSize = " << context->data.size()
+                           << ", taskid = " << task->GetTaskId();
+    int ret = client_->WriteChunkBulk(context->cidInfo,
+        &context->batchItems,
+        context->data.data(),
+        cb);
+    if (ret != LIBCURVE_ERROR::OK) {
+        LOG(ERROR) << "WriteChunkBulk fail"
+                   << ", ret = " << ret
+                   << ", logicalPoolId = " << context->cidInfo.lpid_
+                   << ", copysetId = " << context->cidInfo.cpid_
+                   << ", firstChunkId = " << context->cidInfo.cid_
+                   << ", batchSize = " << context->batchItems.size()
+                   << ", taskid = " << task->GetTaskId();
+        return ret;
+    }
+    return kErrCodeSuccess;
+}
+
+std::shared_ptr<BulkReadChunkContext> CloneCoreImpl::StartAsyncReadChunkData(
+    std::shared_ptr<CloneTaskInfo> task,
+    const CloneChunkInfo &info) {
+    auto context = std::make_shared<BulkReadChunkContext>();
+    if (!ToChunkDataName(info.location, &context->name)) {
+        LOG(ERROR) << "ToChunkDataName fail"
+                   << ", location = " << info.location
+                   << ", chunkId = " << info.chunkIdInfo.cid_
+                   << ", taskid = " << task->GetTaskId();
+        return nullptr;
+    }
+    std::shared_ptr<SnapshotDataStore> dataStore = dataStore_;
+    bulkReadPool_.Enqueue([=]() {
+        context->retCode =
+            dataStore->GetChunkData(context->name, &context->chunkData);
+        context->done.Signal();
+    });
+    return context;
+}
+
+int CloneCoreImpl::HandleBulkWriteChunkResultsAndRetry(
+    std::shared_ptr<CloneTaskInfo> task,
+    std::shared_ptr<BulkWriteChunkTaskTracker> tracker,
+    const std::list<BulkWriteChunkContextPtr> &results) {
+    int ret = kErrCodeSuccess;
+    for (auto context : results) {
+        if (context->retCode == LIBCURVE_ERROR::OK) {
+            continue;
+        }
+        uint64_t nowTime = TimeUtility::GetTimeofDaySec();
+        if (nowTime - context->startTime <
+            context->clientAsyncMethodRetryTimeSec) {
+            // retry
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(
+                    clientAsyncMethodRetryIntervalMs_));
+            ret = StartAsyncBulkWriteChunk(task, tracker, context);
+            if (ret < 0) {
+                return kErrCodeInternalError;
+            }
+        } else {
+            LOG(ERROR) << "WriteChunkBulk tracker GetResult fail"
+                       << ", ret = " << context->retCode
                        << ", taskid = " << task->GetTaskId();
+            return kErrCodeInternalError;
+        }
+    }
+    return ret;
+}
+
+int CloneCoreImpl::ScheduleRecoverChunk(
+    std::shared_ptr<CloneTaskInfo> task,
+    uint32_t chunkSize,
+    const std::vector<const CloneChunkInfo *> &chunks) {
+    int ret = kErrCodeSuccess;
+    const TaskIdType &taskId = task->GetTaskId();
+    uint32_t totalProgress =
+        kProgressRecoverChunkEnd - kProgressRecoverChunkBegin;
 
-            ret = StartAsyncRecoverChunkPart(task, tracker, context);
+    std::unordered_map<uint64_t, size_t> chunkIndex;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        chunkIndex[chunks[i]->chunkIdInfo.cid_] = i;
+    }
+    std::vector<bool> started(chunks.size(), false);
+    // 按顺序恢复的下一个chunk，之前的chunk都已开始恢复
+    size_t nextIndex = 0;
+
+    auto tracker = std::make_shared<RecoverChunkTaskTracker>();
+    uint64_t workingChunkNum = 0;
+    // 为避免发往同一个chunk碰撞，异步请求不同的chunk
+    for (size_t startedNum = 0; startedNum < chunks.size(); startedNum++) {
+        uint32_t concurrency = recoverChunkConcurrency_;
+        if (cloneReadMissThrottleRate_ > 0 &&
+            chunkHeatMap_->GetReadMissRate(taskId) >=
+                cloneReadMissThrottleRate_) {
+            concurrency = std::min(concurrency,
+                std::max(1u, recoverChunkThrottledConcurrency_));
+        }
+        // 当前并发工作的chunk数已大于要求的并发数时，先消化一部分
+        while (workingChunkNum >= concurrency) {
+            uint64_t completeChunkNum = 0;
+            ret = ContinueAsyncRecoverChunkPartAndWaitSomeChunkEnd(task,
+                tracker,
+                &completeChunkNum);
             if (ret < 0) {
                 return kErrCodeInternalError;
             }
+            workingChunkNum -= completeChunkNum;
         }
-        task->SetProgress(static_cast<uint32_t>(
-            kProgressRecoverChunkBegin + index * progressPerData));
+
+        // 优先恢复读缺失最多的chunk
+        size_t index = chunks.size();
+        uint64_t hotChunkId = 0;
+        if (chunkHeatMap_->PopHottestChunk(taskId, &hotChunkId)) {
+            auto it = chunkIndex.find(hotChunkId);
+            if (it != chunkIndex.end() && !started[it->second]) {
+                index = it->second;
+            }
+        }
+        bool hot = (index != chunks.size());
+        if (!hot) {
+            while (started[nextIndex]) {
+                nextIndex++;
+            }
+            index = nextIndex;
+            chunkHeatMap_->RemoveChunk(chunks[index]->chunkIdInfo.cid_);
+        }
+        started[index] = true;
+
+        // 加入新的工作的chunk
+        workingChunkNum++;
+        auto context = std::make_shared<RecoverChunkContext>();
+        context->cidInfo = chunks[index]->chunkIdInfo;
+        context->totalPartNum = chunkSize / cloneChunkSplitSize_;
+        context->partIndex = 0;
+        context->partSize = cloneChunkSplitSize_;
+        context->taskid = taskId;
+        context->startTime = TimeUtility::GetTimeofDaySec();
+        context->clientAsyncMethodRetryTimeSec =
+            clientAsyncMethodRetryTimeSec_;
+
+        LOG(INFO) << "RecoverChunk start"
+                   << ", logicalPoolId = "
+                   << context->cidInfo.lpid_
+                   << ", copysetId = " << context->cidInfo.cpid_
+                   << ", chunkId = " << context->cidInfo.cid_
+                   << ", len = " << context->partSize
+                   << ", hot = " << hot
+                   << ", taskid = " << taskId;
+
+        ret = StartAsyncRecoverChunkPart(task, tracker, context);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+        task->SetProgress(static_cast<uint32_t>(kProgressRecoverChunkBegin +
+            (startedNum + 1) * totalProgress / chunks.size()));
         task->UpdateMetric();
-        index++;
     }
 
     while (workingChunkNum > 0) {
@@ -971,15 +1484,6 @@ int CloneCoreImpl::RecoverChunk(
         }
         workingChunkNum -= completeChunkNum;
     }
-
-    task->GetCloneInfo().SetNextStep(CloneStep::kCompleteCloneFile);
-    ret = metaStore_->UpdateCloneInfo(task->GetCloneInfo());
-    if (ret < 0) {
-        LOG(ERROR) << "UpdateCloneInfo after RecoverChunk error."
-                   << " ret = " << ret
-                   << ", taskid = " << task->GetTaskId();
-        return kErrCodeInternalError;
-    }
     return kErrCodeSuccess;
 }
 
@@ -990,6 +1494,44 @@ int CloneCoreImpl::StartAsyncRecoverChunkPart(
     RecoverChunkClosure *cb = new RecoverChunkClosure(tracker, context);
     tracker->AddOneTrace();
     uint64_t offset = context->partIndex * context->partSize;
+    context->requestPartNum = std::min<uint64_t>(
+        std::max(1u, recoverChunkBatchPartNum_),
+        context->totalPartNum - context->partIndex);
+    if (context->requestPartNum > 1) {
+        context->batchItems.clear();
+        for (uint64_t i = 0; i < context->requestPartNum; i++) {
+            CloneChunkBatchItem item;
+            item.cid = context->cidInfo.cid_;
+            item.offset = offset + i * context->partSize;
+            item.len = context->partSize;
+            context->batchItems.push_back(item);
+        }
+        LOG_EVERY_SECOND(INFO) << "Doing RecoverChunkBatch"
+                   << ", logicalPoolId = "
+                   << context->cidInfo.lpid_
+                   << ", copysetId = " << context->cidInfo.cpid_
+                   << ", chunkId = " << context->cidInfo.cid_
+                   << ", offset = " << offset
+                   << ", partNum = " << context->requestPartNum
+                   << ", partSize = " << context->partSize
+                   << ", taskid = " << task->GetTaskId();
+        int ret = client_->RecoverChunkBatch(context->cidInfo,
+            &context->batchItems,
+            cb);
+        if (ret != LIBCURVE_ERROR::OK) {
+            LOG(ERROR) << "RecoverChunkBatch fail"
+                       << ", ret = " << ret
+                       << ", logicalPoolId = "
+                       << context->cidInfo.lpid_
+                       << ", copysetId = " << context->cidInfo.cpid_
+                       << ", chunkId = " << context->cidInfo.cid_
+                       << ", offset = " << offset
+                       << ", partNum = " << context->requestPartNum
+                       << ", taskid = " << task->GetTaskId();
+            return ret;
+        }
+        return kErrCodeSuccess;
+    }
     LOG_EVERY_SECOND(INFO) << "Doing RecoverChunk"
                << ", logicalPoolId = "
                << context->cidInfo.lpid_
@@ -1045,8 +1587,8 @@ int CloneCoreImpl::ContinueAsyncRecoverChunkPartAndWaitSomeChunkEnd(
                 return context->retCode;
             }
         } else {
-            // 启动一个新的分片，index++，并重置开始时间
-            context->partIndex++;
+            // 启动新的分片，index后移已恢复的分片数，并重置开始时间
+            context->partIndex += context->requestPartNum;
             context->startTime = TimeUtility::GetTimeofDaySec();
             if (context->partIndex < context->totalPartNum) {
                 int ret = StartAsyncRecoverChunkPart(task, tracker, context);
@@ -1363,6 +1905,10 @@ inline bool CloneCoreImpl::IsLazy(std::shared_ptr<CloneTaskInfo> task) {
     return task->GetCloneInfo().GetIsLazy();
 }
 
+inline bool CloneCoreImpl::IsBulk(std::shared_ptr<CloneTaskInfo> task) {
+    return task->GetCloneInfo().GetIsBulk();
+}
+
 inline bool CloneCoreImpl::IsSnapshot(std::shared_ptr<CloneTaskInfo> task) {
     return CloneFileType::kSnapshot == task->GetCloneInfo().GetFileType();
 }
@@ -1673,6 +2219,11 @@ int CloneCoreImpl::HandleDeleteCloneInfo(const CloneInfo &cloneInfo) {
     return kErrCodeSuccess;
 }
 
+void CloneCoreImpl::ReportCloneReadMiss(
+    const std::map<uint64_t, uint32_t> &missCounts) {
+    chunkHeatMap_->ReportReadMiss(missCounts);
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
@@ -35,7 +35,10 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "src/snapshotcloneserver/common/snapshot_reference.h"
 #include "src/snapshotcloneserver/clone/clone_reference.h"
+#include "src/snapshotcloneserver/clone/clone_chunk_heat.h"
 #include "src/snapshotcloneserver/common/thread_pool.h"
+#include "src/snapshotcloneserver/common/task_tracker.h"
+#include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/concurrent/name_lock.h"
 
 using ::curve::common::NameLock;
@@ -44,6 +47,7 @@ namespace curve {
 namespace snapshotcloneserver {
 
 class CloneTaskInfo;
+struct BulkReadChunkContext;
 
 class CloneCore {
  public:
@@ -192,6 +196,14 @@ class CloneCore {
      * @return 错误码
      */
     virtual int HandleDeleteCloneInfo(const CloneInfo &cloneInfo) = 0;
+
+    /**
+     * @brief 记录chunkserver上报的克隆chunk读缺失
+     *
+     * @param missCounts key为chunkId，value为读缺失次数
+     */
+    virtual void ReportCloneReadMiss(
+        const std::map<uint64_t, uint32_t> &missCounts) = 0;
 };
 
 /**
@@ -206,6 +218,9 @@ struct CloneChunkInfo {
     uint64_t seqNum;
     // chunk是否需要recover
     bool needRecover;
+    // 按页增量存储，创建clone chunk时需先与deltaBase合并出全量数据
+    bool needMerge = false;
+    ChunkDataName deltaBase;
 };
 
 // 克隆/恢复所需segment信息，key是ChunkIndex In Segment, value是chunk信息
@@ -235,11 +250,25 @@ class CloneCoreImpl : public CloneCore {
         mdsRootUser_(option.mdsRootUser),
         createCloneChunkConcurrency_(option.createCloneChunkConcurrency),
         recoverChunkConcurrency_(option.recoverChunkConcurrency),
+        createCloneChunkBatchSize_(option.createCloneChunkBatchSize),
+        recoverChunkBatchPartNum_(option.recoverChunkBatchPartNum),
         clientAsyncMethodRetryTimeSec_(option.clientAsyncMethodRetryTimeSec),
         clientAsyncMethodRetryIntervalMs_(
-            option.clientAsyncMethodRetryIntervalMs) {}
+            option.clientAsyncMethodRetryIntervalMs),
+        cloneReadMissThrottleRate_(option.cloneReadMissThrottleRate),
+        recoverChunkThrottledConcurrency_(
+            option.recoverChunkThrottledConcurrency),
+        bulkRestoreEnable_(option.bulkRestoreEnable),
+        bulkWriteMaxSize_(option.bulkWriteMaxSize),
+        bulkWriteConcurrency_(option.bulkWriteConcurrency),
+        bulkReadConcurrency_(option.bulkReadConcurrency) {
+        chunkHeatMap_ = std::make_shared<CloneChunkHeatMap>(
+            option.cloneReadMissWindowSec);
+    }
 
     ~CloneCoreImpl() {
+        mergeDeltaPool_.Stop();
+        bulkReadPool_.Stop();
     }
 
     int Init();
@@ -286,6 +315,9 @@ class CloneCoreImpl : public CloneCore {
                         uint64_t inodeId) override;
     int HandleDeleteCloneInfo(const CloneInfo &cloneInfo) override;
 
+    void ReportCloneReadMiss(
+        const std::map<uint64_t, uint32_t> &missCounts) override;
+
  private:
     /**
      * @brief 从快照构建克隆/恢复的文件信息
@@ -393,6 +425,20 @@ class CloneCoreImpl : public CloneCore {
         const FInfo &fInfo,
         CloneSegmentMap *segInfos);
 
+    /**
+     * @brief 在后台合并按页增量存储的chunk，合并中的数量达到并发数时等待
+     *
+     * @param task 任务信息
+     * @param tracker 合并任务追踪器
+     * @param info chunk信息
+     *
+     * @return 错误码
+     */
+    int StartAsyncMergeChunkDelta(
+        std::shared_ptr<CloneTaskInfo> task,
+        std::shared_ptr<TaskTracker> tracker,
+        const CloneChunkInfo &info);
+
     /**
      * @brief 开始CreateCloneChunk的异步请求
      *
@@ -449,6 +495,23 @@ class CloneCoreImpl : public CloneCore {
         const FInfo &fInfo,
         const CloneSegmentMap &segInfos);
 
+    /**
+     * @brief 调度需要恢复的chunk
+     * @detail
+     *  优先恢复读缺失最多的chunk，其余按顺序恢复；
+     *  读缺失速率过高时降低并发，为前台IO让出带宽
+     *
+     * @param task 任务信息
+     * @param chunkSize chunk大小
+     * @param chunks 需要恢复的chunk，按文件偏移排序
+     *
+     * @return 错误码
+     */
+    int ScheduleRecoverChunk(
+        std::shared_ptr<CloneTaskInfo> task,
+        uint32_t chunkSize,
+        const std::vector<const CloneChunkInfo *> &chunks);
+
     /**
      * @brief 开始RecoverChunk的异步请求
      *
@@ -477,6 +540,64 @@ class CloneCoreImpl : public CloneCore {
         std::shared_ptr<RecoverChunkTaskTracker> tracker,
         uint64_t *completeChunkNum);
 
+    /**
+     * @brief 批量写入快照数据，用于非lazy的从快照克隆/恢复
+     * @detail
+     *  由snapshotcloneserver读出快照数据，跳过全零的分片，
+     *  将同一copyset的数据合并为WriteChunkBulk请求直接写入chunkserver，
+     *  代替CreateCloneChunk + RecoverChunk
+     *
+     * @param task 任务信息
+     * @param fInfo 新文件的文件信息
+     * @param segInfos 新文件所需的segment信息
+     *
+     * @return 错误码
+     */
+    int BulkWriteChunk(
+        std::shared_ptr<CloneTaskInfo> task,
+        const FInfo &fInfo,
+        const CloneSegmentMap &segInfos);
+
+    /**
+     * @brief 开始WriteChunkBulk的异步请求
+     *
+     * @param task 任务信息
+     * @param tracker WriteChunkBulk任务追踪器
+     * @param context WriteChunkBulk上下文
+     *
+     * @return 错误码
+     */
+    int StartAsyncBulkWriteChunk(
+        std::shared_ptr<CloneTaskInfo> task,
+        std::shared_ptr<BulkWriteChunkTaskTracker> tracker,
+        std::shared_ptr<BulkWriteChunkContext> context);
+
+    /**
+     * @brief 在后台从快照读取chunk数据，完成时通知context->done
+     *
+     * @param task 任务信息
+     * @param info chunk信息
+     *
+     * @return 读取上下文
+     */
+    std::shared_ptr<BulkReadChunkContext> StartAsyncReadChunkData(
+        std::shared_ptr<CloneTaskInfo> task,
+        const CloneChunkInfo &info);
+
+    /**
+     * @brief 处理WriteChunkBulk的结果并重试
+     *
+     * @param task 任务信息
+     * @param tracker WriteChunkBulk任务追踪器
+     * @param results WriteChunkBulk结果列表
+     *
+     * @return 错误码
+     */
+    int HandleBulkWriteChunkResultsAndRetry(
+        std::shared_ptr<CloneTaskInfo> task,
+        std::shared_ptr<BulkWriteChunkTaskTracker> tracker,
+        const std::list<BulkWriteChunkContextPtr> &results);
+
     /**
      * @brief 修改克隆文件的owner
      *
@@ -572,6 +693,7 @@ class CloneCoreImpl : public CloneCore {
     void HandleCleanError(std::shared_ptr<CloneTaskInfo> task);
 
     bool IsLazy(std::shared_ptr<CloneTaskInfo> task);
+    bool IsBulk(std::shared_ptr<CloneTaskInfo> task);
     bool IsSnapshot(std::shared_ptr<CloneTaskInfo> task);
     bool IsFile(std::shared_ptr<CloneTaskInfo> task);
     bool IsRecover(std::shared_ptr<CloneTaskInfo> task);
@@ -594,10 +716,32 @@ class CloneCoreImpl : public CloneCore {
     uint32_t createCloneChunkConcurrency_;
     // RecoverChunk同时进行的异步请求数量
     uint32_t recoverChunkConcurrency_;
+    // 一个CreateCloneChunkBatch请求中同一copyset的chunk数
+    uint32_t createCloneChunkBatchSize_;
+    // 一个RecoverChunkBatch请求中同一chunk的分片数
+    uint32_t recoverChunkBatchPartNum_;
     // client异步请求重试时间
     uint64_t clientAsyncMethodRetryTimeSec_;
     // 调用client异步方法重试时间间隔
     uint64_t clientAsyncMethodRetryIntervalMs_;
+    // 读缺失速率达到该值时降低RecoverChunk并发，0表示不限制
+    uint32_t cloneReadMissThrottleRate_;
+    // 前台读缺失频繁时RecoverChunk的并发数
+    uint32_t recoverChunkThrottledConcurrency_;
+    // 未恢复chunk的读缺失记录，决定RecoverChunk的顺序和速度
+    std::shared_ptr<CloneChunkHeatMap> chunkHeatMap_;
+    // 非lazy的从快照克隆/恢复是否使用WriteChunkBulk批量写入
+    bool bulkRestoreEnable_;
+    // 一个WriteChunkBulk请求的最大数据量
+    uint32_t bulkWriteMaxSize_;
+    // WriteChunkBulk同时进行的异步请求数量
+    uint32_t bulkWriteConcurrency_;
+    // 批量写入时同时从快照预读的chunk数量
+    uint32_t bulkReadConcurrency_;
+    // 合并增量chunk的线程池，与CreateCloneChunk请求并行
+    curve::common::TaskThreadPool<> mergeDeltaPool_;
+    // 批量写入时预读快照chunk数据的线程池，与WriteChunkBulk请求并行
+    curve::common::TaskThreadPool<> bulkReadPool_;
 };
 
 }  // namespace snapshotcloneserver
@@ -531,6 +531,11 @@ int CloneServiceManager::GetFinishedCloneTask(
     return kErrCodeSuccess;
 }
 
+void CloneServiceManager::ReportCloneReadMiss(
+    const std::map<uint64_t, uint32_t> &missCounts) {
+    cloneCore_->ReportCloneReadMiss(missCounts);
+}
+
 int CloneServiceManager::CleanCloneTask(const std::string &user,
     const TaskIdType &taskId) {
     CloneInfo cloneInfo;
@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <map>
 
 #include "src/common/wait_interval.h"
 #include "src/snapshotcloneserver/clone/clone_core.h"
@@ -355,6 +356,14 @@ class CloneServiceManager {
     virtual int CleanCloneTask(const std::string &user,
         const TaskIdType &taskId);
 
+    /**
+     * @brief 记录chunkserver上报的克隆chunk读缺失，用于调度RecoverChunk
+     *
+     * @param missCounts key为chunkId，value为读缺失次数
+     */
+    virtual void ReportCloneReadMiss(
+        const std::map<uint64_t, uint32_t> &missCounts);
+
     /**
      * @brief 重启后恢复未完成clone和recover任务
      *
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "src/snapshotcloneserver/clone/clone_core.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
@@ -33,6 +34,7 @@
 #include "src/snapshotcloneserver/common/snapshotclone_metric.h"
 #include "src/snapshotcloneserver/common/curvefs_client.h"
 #include "src/snapshotcloneserver/clone/clone_closure.h"
+#include "src/common/concurrent/count_down_event.h"
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -149,6 +151,10 @@ struct CreateCloneChunkContext {
     uint64_t clientAsyncMethodRetryTimeSec;
     // chunk信息
     struct CloneChunkInfo *cloneChunkInfo;
+    // 批量创建时同一copyset的chunk，为空时只创建cidInfo对应的chunk
+    std::vector<CloneChunkBatchItem> batchItems;
+    // 批量创建时与batchItems一一对应的chunk信息
+    std::vector<struct CloneChunkInfo *> batchChunkInfos;
 };
 
 using CreateCloneChunkContextPtr = std::shared_ptr<CreateCloneChunkContext>;
@@ -169,6 +175,7 @@ struct CreateCloneChunkClosure : public SnapCloneClosure {
                        << ", logicalPoolId = " << context_->cidInfo.lpid_
                        << ", copysetId = " << context_->cidInfo.cpid_
                        << ", chunkId = " << context_->cidInfo.cid_
+                       << ", batchSize = " << context_->batchItems.size()
                        << ", seqNum = " << context_->sn
                        << ", csn = " << context_->csn
                        << ", taskid = " << context_->taskid;
@@ -189,6 +196,10 @@ struct RecoverChunkContext {
     uint64_t totalPartNum;
     // 分片大小
     uint64_t partSize;
+    // 当前请求恢复的分片数，大于1时批量恢复
+    uint64_t requestPartNum = 1;
+    // 批量恢复时各分片的范围
+    std::vector<CloneChunkBatchItem> batchItems;
     // 返回值
     int retCode;
     // taskid
@@ -217,6 +228,7 @@ struct RecoverChunkClosure : public SnapCloneClosure {
                          << ", copysetId = " << context_->cidInfo.cpid_
                          << ", chunkId = " << context_->cidInfo.cid_
                          << ", partIndex = " << context_->partIndex
+                         << ", partNum = " << context_->requestPartNum
                          << ", partSize = " << context_->partSize
                          << ", taskid = " << context_->taskid;
         }
@@ -227,6 +239,65 @@ struct RecoverChunkClosure : public SnapCloneClosure {
     RecoverChunkContextPtr context_;
 };
 
+struct BulkWriteChunkContext {
+    // 批量写入的第一个chunk的id信息
+    ChunkIDInfo cidInfo;
+    // 同一copyset的各段数据范围
+    std::vector<CloneChunkBatchItem> batchItems;
+    // 按batchItems顺序拼接的数据
+    std::string data;
+    // 返回值
+    int retCode;
+    // taskid
+    TaskIdType taskid;
+    // 异步请求开始时间
+    uint64_t startTime;
+    // 异步请求重试总时间
+    uint64_t clientAsyncMethodRetryTimeSec;
+};
+
+using BulkWriteChunkContextPtr = std::shared_ptr<BulkWriteChunkContext>;
+
+struct BulkWriteChunkClosure : public SnapCloneClosure {
+    BulkWriteChunkClosure(std::shared_ptr<BulkWriteChunkTaskTracker> tracker,
+        BulkWriteChunkContextPtr context)
+        : tracker_(tracker),
+          context_(context) {}
+    void Run() {
+        std::unique_ptr<BulkWriteChunkClosure> self_guard(this);
+        context_->retCode = GetRetCode();
+        if (context_->retCode < 0) {
+            LOG(WARNING) << "BulkWriteChunkClosure return fail"
+                         << ", ret = " << context_->retCode
+                         << ", logicalPoolId = "
+                         << context_->cidInfo.lpid_
+                         << ", copysetId = " << context_->cidInfo.cpid_
+                         << ", chunkId = " << context_->cidInfo.cid_
+                         << ", batchSize = " << context_->batchItems.size()
+                         << ", dataSize = " << context_->data.size()
+                         << ", taskid = " << context_->taskid;
+        }
+        tracker_->PushResultContext(context_);
+        tracker_->HandleResponse(context_->retCode);
+    }
+    std::shared_ptr<BulkWriteChunkTaskTracker> tracker_;
+    BulkWriteChunkContextPtr context_;
+};
+
+struct BulkReadChunkContext {
+    BulkReadChunkContext() : retCode(kErrCodeSuccess), done(1) {}
+    // 快照chunk数据名
+    ChunkDataName name;
+    // 读出的chunk数据
+    ChunkData chunkData;
+    // 返回值
+    int retCode;
+    // 读取完成时通知
+    curve::common::CountDownEvent done;
+};
+
+using BulkReadChunkContextPtr = std::shared_ptr<BulkReadChunkContext>;
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
@@ -67,6 +67,18 @@ struct SnapshotCloneServerOptions {
     uint32_t mdsSessionTimeUs;
     // ReadChunkSnapshot同时进行的异步请求数量
     uint32_t readChunkSnapshotConcurrency;
+    // 是否按页增量转储快照数据，只上传相对上一个快照变化的页
+    bool snapshotDeltaEnable = false;
+    // 增量转储的页大小，需整除chunkSplitSize
+    uint32_t snapshotDeltaPageSize = 4096;
+    // 是否编码存储快照数据，全零分片不存储，其余分片压缩存储
+    bool snapshotEncodeEnable = false;
+    // 所有快照任务转储时分片缓冲区的总大小上限(字节)
+    uint64_t snapshotTransferBufferPoolSize = 256 * 1024 * 1024ull;
+    // 所有快照任务同时进行的ReadChunkSnapshot数上限
+    uint32_t snapshotTransferReadConcurrency = 64;
+    // 上传分片(含摘要和编码)的线程数
+    uint32_t snapshotTransferUploadThreadNum = 16;
 
     // 用于Lazy克隆元数据部分的线程池线程数
     int stage1PoolThreadNum;
@@ -86,6 +98,24 @@ struct SnapshotCloneServerOptions {
     uint32_t createCloneChunkConcurrency;
     // RecoverChunk同时进行的异步请求数量
     uint32_t recoverChunkConcurrency;
+    // 一个CreateCloneChunkBatch请求中同一copyset的chunk数，1表示逐个创建
+    uint32_t createCloneChunkBatchSize = 1;
+    // 一个RecoverChunkBatch请求中同一chunk的分片数，1表示逐个分片恢复
+    uint32_t recoverChunkBatchPartNum = 1;
+    // 统计克隆卷读缺失速率的时间窗口(秒)
+    uint32_t cloneReadMissWindowSec = 10;
+    // 克隆卷读缺失速率(次/秒)达到该值时降低RecoverChunk并发，0表示不限制
+    uint32_t cloneReadMissThrottleRate = 0;
+    // 读缺失速率过高时RecoverChunk的并发数
+    uint32_t recoverChunkThrottledConcurrency = 1;
+    // 非lazy从快照克隆/恢复时是否将快照数据直接批量写入chunk
+    bool bulkRestoreEnable = false;
+    // 一个WriteChunkBulk请求的最大数据量(字节)
+    uint32_t bulkWriteMaxSize = 4 * 1024 * 1024;
+    // WriteChunkBulk同时进行的异步请求数量
+    uint32_t bulkWriteConcurrency = 16;
+    // 批量写入时同时从快照预读的chunk数量
+    uint32_t bulkReadConcurrency = 4;
     // 引用计数后台扫描每条记录间隔
     uint32_t backEndReferenceRecordScanIntervalMs;
     // 引用计数后台扫描每轮间隔
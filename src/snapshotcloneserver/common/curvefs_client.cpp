@@ -121,6 +121,29 @@ int CurveFsClientImpl::GetSnapshotSegmentInfo(const std::string &filename,
         clientMethodRetryIntervalMs_);
 }
 
+int CurveFsClientImpl::ListSnapshotSegmentInfo(const std::string &filename,
+    const std::string &user,
+    uint64_t seq,
+    uint64_t startOffset,
+    uint32_t limit,
+    std::vector<SegmentInfo> *segInfos,
+    uint64_t *nextOffset) {
+    UserInfo userInfo = GetUserInfo(user);
+    RetryMethod method = [this, &filename, &userInfo, seq, startOffset,
+                          limit, segInfos, nextOffset] () {
+        return snapClient_->ListSnapshotSegment(
+            filename, userInfo,
+            seq, startOffset, limit, segInfos, nextOffset);
+    };
+    RetryCondition condition = [] (int ret) {
+        return ret != LIBCURVE_ERROR::OK &&
+               ret != -LIBCURVE_ERROR::NOT_SUPPORT;
+    };
+    RetryHelper retryHelper(method, condition);
+    return retryHelper.RetryTimeSecAndReturn(clientMethodRetryTimeSec_,
+        clientMethodRetryIntervalMs_);
+}
+
 int CurveFsClientImpl::ReadChunkSnapshot(ChunkIDInfo cidinfo,
                         uint64_t seq,
                         uint64_t offset,
@@ -235,6 +258,52 @@ int CurveFsClientImpl::RecoverChunk(
         clientMethodRetryIntervalMs_);
 }
 
+int CurveFsClientImpl::CreateCloneChunkBatch(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    SnapCloneClosure* scc) {
+    RetryMethod method = [this, &copysetidinfo, items, scc] () {
+        return snapClient_->CreateCloneChunkBatch(copysetidinfo, items, scc);
+    };
+    RetryCondition condition = [] (int ret) {
+        return ret < 0;
+    };
+    RetryHelper retryHelper(method, condition);
+    return retryHelper.RetryTimeSecAndReturn(clientMethodRetryTimeSec_,
+        clientMethodRetryIntervalMs_);
+}
+
+int CurveFsClientImpl::RecoverChunkBatch(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    SnapCloneClosure* scc) {
+    RetryMethod method = [this, &copysetidinfo, items, scc] () {
+        return snapClient_->RecoverChunkBatch(copysetidinfo, items, scc);
+    };
+    RetryCondition condition = [] (int ret) {
+        return ret < 0;
+    };
+    RetryHelper retryHelper(method, condition);
+    return retryHelper.RetryTimeSecAndReturn(clientMethodRetryTimeSec_,
+        clientMethodRetryIntervalMs_);
+}
+
+int CurveFsClientImpl::WriteChunkBulk(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    const char *buf,
+    SnapCloneClosure* scc) {
+    RetryMethod method = [this, &copysetidinfo, items, buf, scc] () {
+        return snapClient_->WriteChunkBulk(copysetidinfo, items, buf, scc);
+    };
+    RetryCondition condition = [] (int ret) {
+        return ret < 0;
+    };
+    RetryHelper retryHelper(method, condition);
+    return retryHelper.RetryTimeSecAndReturn(clientMethodRetryTimeSec_,
+        clientMethodRetryIntervalMs_);
+}
+
 int CurveFsClientImpl::CompleteCloneMeta(
     const std::string &filename,
     const std::string &user) {
@@ -45,6 +45,7 @@ using ::curve::client::CopysetID;
 using ::curve::client::ChunkID;
 using ::curve::client::ChunkInfoDetail;
 using ::curve::client::ChunkIDInfo;
+using ::curve::client::CloneChunkBatchItem;
 using ::curve::client::FInfo;
 using ::curve::client::FileStatus;
 using ::curve::client::SnapCloneClosure;
@@ -165,6 +166,30 @@ class CurveFsClient {
         uint64_t offset,
         SegmentInfo *segInfo) = 0;
 
+    /**
+     * @brief 从startOffset开始分页查询快照文件已分配的segment信息
+     *
+     * @param filename 文件名
+     * @param user 用户信息
+     * @param seq 快照版本号
+     * @param startOffset 起始偏移，需按segment对齐
+     * @param limit 本次最多查询的segment数
+     * @param[out] segInfos 按offset有序的segment信息
+     * @param[out] nextOffset 下一页的起始偏移，没有更多segment时为0
+     *
+     * @return 错误码，不支持分页查询时返回-LIBCURVE_ERROR::NOT_SUPPORT，
+     *         调用者需退回到GetSnapshotSegmentInfo逐个查询
+     */
+    virtual int ListSnapshotSegmentInfo(const std::string &filename,
+        const std::string &user,
+        uint64_t seq,
+        uint64_t startOffset,
+        uint32_t limit,
+        std::vector<SegmentInfo> *segInfos,
+        uint64_t *nextOffset) {
+        return -LIBCURVE_ERROR::NOT_SUPPORT;
+    }
+
     /**
      * @brief 读取snapshot chunk的数据
      *
@@ -277,6 +302,53 @@ class CurveFsClient {
         uint64_t len,
         SnapCloneClosure* scc) = 0;
 
+    /**
+     * @brief 批量lazy创建同一个copyset上的clone chunk，
+     *        所有chunk在chunkserver上作为一条raft日志提交
+     *
+     * @param copysetidinfo copyset的id信息
+     * @param items 待创建的chunk，成功返回后记录每个chunk的结果，
+     *              回调之前需保证其有效
+     * @param: scc是异步回调
+     *
+     * @return 错误码
+     */
+    virtual int CreateCloneChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc) = 0;
+
+    /**
+     * @brief 批量恢复同一个copyset上的chunk数据
+     *
+     * @param copysetidinfo copyset的id信息
+     * @param items 待恢复的chunk范围，回调之前需保证其有效
+     * @param: scc是异步回调
+     *
+     * @return 错误码
+     */
+    virtual int RecoverChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc) = 0;
+
+    /**
+     * @brief 批量写入同一个copyset上的多个chunk，chunk不存在时由写入创建，
+     *        所有写入在chunkserver上作为一条raft日志提交
+     *
+     * @param copysetidinfo copyset的id信息
+     * @param items 写入的chunk范围，回调之前需保证其有效
+     * @param buf 各范围的数据，按items的顺序依次存放，回调之前需保证其有效
+     * @param: scc是异步回调
+     *
+     * @return 错误码
+     */
+    virtual int WriteChunkBulk(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        const char *buf,
+        SnapCloneClosure* scc) = 0;
+
     /**
      * @brief 通知mds完成Clone Meta
      *
@@ -434,6 +506,14 @@ class CurveFsClientImpl : public CurveFsClient {
         uint64_t offset,
         SegmentInfo *segInfo) override;
 
+    int ListSnapshotSegmentInfo(const std::string &filename,
+        const std::string &user,
+        uint64_t seq,
+        uint64_t startOffset,
+        uint32_t limit,
+        std::vector<SegmentInfo> *segInfos,
+        uint64_t *nextOffset) override;
+
     int ReadChunkSnapshot(ChunkIDInfo cidinfo,
                         uint64_t seq,
                         uint64_t offset,
@@ -474,6 +554,22 @@ class CurveFsClientImpl : public CurveFsClient {
         uint64_t len,
         SnapCloneClosure* scc) override;
 
+    int CreateCloneChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc) override;
+
+    int RecoverChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc) override;
+
+    int WriteChunkBulk(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        const char *buf,
+        SnapCloneClosure* scc) override;
+
     int CompleteCloneMeta(
         const std::string &filename,
         const std::string &user) override;
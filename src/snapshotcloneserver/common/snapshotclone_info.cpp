@@ -41,6 +41,7 @@ bool CloneInfo::SerializeToString(std::string *value) const {
     data.set_time(time_);
     data.set_filetype(static_cast<int>(fileType_));
     data.set_islazy(isLazy_);
+    data.set_isbulk(isBulk_);
     data.set_nextstep(static_cast<int>(nextStep_));
     data.set_status(static_cast<int>(status_));
     return data.SerializeToString(value);
@@ -59,6 +60,7 @@ bool CloneInfo::ParseFromString(const std::string &value) {
     time_ = data.time();
     fileType_ = static_cast<CloneFileType>(data.filetype());
     isLazy_ = data.islazy();
+    isBulk_ = data.isbulk();
     nextStep_ = static_cast<CloneStep>(data.nextstep());
     status_ = static_cast<CloneStatus>(data.status());
     return ret;
@@ -76,6 +78,7 @@ std::ostream& operator<<(std::ostream& os, const CloneInfo &cloneInfo) {
     os << ", time : " << cloneInfo.GetTime();
     os << ", fileType : " << static_cast<int>(cloneInfo.GetFileType());
     os << ", isLazy : " << cloneInfo.GetIsLazy();
+    os << ", isBulk : " << cloneInfo.GetIsBulk();
     os << ", nextStep : " << static_cast<int>(cloneInfo.GetNextStep());
     os << ", status : " << static_cast<int>(cloneInfo.GetStatus());
     os << " }";
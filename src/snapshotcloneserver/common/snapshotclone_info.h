@@ -71,6 +71,7 @@ class CloneInfo {
           time_(0),
           fileType_(CloneFileType::kSnapshot),
           isLazy_(false),
+          isBulk_(false),
           nextStep_(CloneStep::kCreateCloneFile),
           status_(CloneStatus::error) {}
 
@@ -91,6 +92,7 @@ class CloneInfo {
           time_(0),
           fileType_(fileType),
           isLazy_(isLazy),
+          isBulk_(false),
           nextStep_(CloneStep::kCreateCloneFile),
           status_(CloneStatus::cloning) {}
 
@@ -116,6 +118,7 @@ class CloneInfo {
           time_(time),
           fileType_(fileType),
           isLazy_(isLazy),
+          isBulk_(false),
           nextStep_(nextStep),
           status_(status) {}
 
@@ -199,6 +202,14 @@ class CloneInfo {
       isLazy_ = flag;
   }
 
+  bool GetIsBulk() const {
+      return isBulk_;
+  }
+
+  void SetIsBulk(bool flag) {
+      isBulk_ = flag;
+  }
+
   CloneStep GetNextStep() const {
     return nextStep_;
   }
@@ -239,6 +250,8 @@ class CloneInfo {
     CloneFileType fileType_;
     // 是否lazy
     bool isLazy_;
+    // 非lazy从快照克隆/恢复时，是否直接将快照数据批量写入chunk
+    bool isBulk_;
     // 克隆进度, 下一个步骤
     CloneStep nextStep_;
     // 处理的状态
@@ -37,6 +37,21 @@
 namespace curve {
 namespace snapshotcloneserver {
 
+// 快照列表的过滤条件，为nullptr的条件不过滤
+struct SnapshotListFilter {
+    const UUID *uuid = nullptr;
+    const std::string *file = nullptr;
+    const std::string *user = nullptr;
+    const Status *status = nullptr;
+
+    bool IsMatch(const SnapshotInfo &info) const {
+        return (uuid == nullptr || *uuid == info.GetUuid()) &&
+               (file == nullptr || *file == info.GetFileName()) &&
+               (user == nullptr || *user == info.GetUser()) &&
+               (status == nullptr || *status == info.GetStatus());
+    }
+};
+
 class SnapshotCloneMetaStore {
  public:
     SnapshotCloneMetaStore() {}
@@ -82,6 +97,23 @@ class SnapshotCloneMetaStore {
      */
     virtual int GetSnapshotList(std::vector<SnapshotInfo> *list) = 0;
 
+    /**
+     * @brief 按uuid顺序分页获取满足过滤条件的快照信息，只拷贝当前页
+     *
+     * @param filter 过滤条件
+     * @param offset 跳过的记录数
+     * @param limit 本页最多返回的记录数
+     * @param[out] list 本页的快照信息
+     * @param[out] total 满足过滤条件的记录总数
+     *
+     * @return 0 获取成功/ -1 获取失败
+     */
+    virtual int GetSnapshotListByPage(const SnapshotListFilter &filter,
+                                      uint64_t offset,
+                                      uint64_t limit,
+                                      std::vector<SnapshotInfo> *list,
+                                      uint64_t *total) = 0;
+
     /**
      * @brief 获取快照总数
      *
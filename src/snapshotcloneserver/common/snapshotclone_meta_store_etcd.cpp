@@ -22,12 +22,58 @@
 
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store_etcd.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
 #include <vector>
 #include <string>
 
 namespace curve {
 namespace snapshotcloneserver {
 
+namespace {
+
+// 快照和克隆的进度更新等非终态的写可以合并
+bool IsMergeableStatus(Status status) {
+    return status == Status::pending;
+}
+
+bool IsMergeableStatus(CloneStatus status) {
+    return status == CloneStatus::cloning ||
+           status == CloneStatus::recovering;
+}
+
+template <typename K>
+void EraseFromIndex(std::map<K, std::set<std::string>> *index,
+                    const K &key, const std::string &id) {
+    auto it = index->find(key);
+    if (it != index->end()) {
+        it->second.erase(id);
+        if (it->second.empty()) {
+            index->erase(it);
+        }
+    }
+}
+
+}  // namespace
+
+SnapshotCloneMetaStoreEtcd::SnapshotCloneMetaStoreEtcd(
+    std::shared_ptr<KVStorageClient> client,
+    std::shared_ptr<SnapshotCloneCodec> codec,
+    uint32_t shardNum,
+    uint32_t batchMaxOps)
+    : client_(client),
+      codec_(codec),
+      batchMaxOps_(std::min(std::max(batchMaxOps, 1u),
+                            kMaxMetaStoreBatchMaxOps)),
+      committing_(false) {
+    shardNum = std::max(shardNum, 1u);
+    for (uint32_t i = 0; i < shardNum; i++) {
+        snapShards_.emplace_back(new SnapshotShard());
+        cloneShards_.emplace_back(new CloneShard());
+    }
+}
+
 int SnapshotCloneMetaStoreEtcd::Init() {
     int ret = LoadSnapshotInfos();
     if (ret < 0) {
@@ -40,6 +86,165 @@ int SnapshotCloneMetaStoreEtcd::Init() {
     return 0;
 }
 
+SnapshotCloneMetaStoreEtcd::SnapshotShard &
+SnapshotCloneMetaStoreEtcd::GetSnapshotShard(const UUID &uuid) {
+    return *snapShards_[std::hash<std::string>()(uuid) % snapShards_.size()];
+}
+
+SnapshotCloneMetaStoreEtcd::CloneShard &
+SnapshotCloneMetaStoreEtcd::GetCloneShard(const std::string &taskId) {
+    return *cloneShards_[
+        std::hash<std::string>()(taskId) % cloneShards_.size()];
+}
+
+void SnapshotCloneMetaStoreEtcd::InsertSnapshotIndex(SnapshotShard *shard,
+    const SnapshotInfo &info) {
+    shard->fileIndex[info.GetFileName()].insert(info.GetUuid());
+    shard->userIndex[info.GetUser()].insert(info.GetUuid());
+    shard->statusIndex[info.GetStatus()].insert(info.GetUuid());
+}
+
+void SnapshotCloneMetaStoreEtcd::EraseSnapshotIndex(SnapshotShard *shard,
+    const SnapshotInfo &info) {
+    EraseFromIndex(&shard->fileIndex, info.GetFileName(), info.GetUuid());
+    EraseFromIndex(&shard->userIndex, info.GetUser(), info.GetUuid());
+    EraseFromIndex(&shard->statusIndex, info.GetStatus(), info.GetUuid());
+}
+
+void SnapshotCloneMetaStoreEtcd::PutSnapshot(SnapshotShard *shard,
+    const SnapshotInfo &info) {
+    auto search = shard->infos.find(info.GetUuid());
+    if (search != shard->infos.end()) {
+        EraseSnapshotIndex(shard, search->second);
+        search->second = info;
+    } else {
+        shard->infos.emplace(info.GetUuid(), info);
+    }
+    InsertSnapshotIndex(shard, info);
+}
+
+void SnapshotCloneMetaStoreEtcd::PutCloneInfo(CloneShard *shard,
+    const CloneInfo &info) {
+    auto search = shard->infos.find(info.GetTaskId());
+    if (search != shard->infos.end()) {
+        EraseFromIndex(&shard->destIndex, search->second.GetDest(),
+            info.GetTaskId());
+        search->second = info;
+    } else {
+        shard->infos.emplace(info.GetTaskId(), info);
+    }
+    shard->destIndex[info.GetDest()].insert(info.GetTaskId());
+}
+
+void SnapshotCloneMetaStoreEtcd::EraseCloneInfo(CloneShard *shard,
+    const std::string &taskId) {
+    auto search = shard->infos.find(taskId);
+    if (search != shard->infos.end()) {
+        EraseFromIndex(&shard->destIndex, search->second.GetDest(), taskId);
+        shard->infos.erase(search);
+    }
+}
+
+int SnapshotCloneMetaStoreEtcd::CommitOp(OpType type, const std::string &key,
+    const std::string &value, bool mergeable, std::function<void()> apply) {
+    std::unique_lock<std::mutex> lk(queueMutex_);
+    PendingOpPtr op;
+    auto search = mergeableOps_.find(key);
+    if (mergeable && search != mergeableOps_.end()) {
+        // 与尚未提交的非终态写合并，只提交最新的值
+        op = search->second;
+        op->value = value;
+        op->apply = apply;
+    } else {
+        op = std::make_shared<PendingOp>();
+        op->type = type;
+        op->key = key;
+        op->value = value;
+        op->mergeable = mergeable;
+        op->apply = apply;
+        pendingOps_.push_back(op);
+        if (mergeable) {
+            mergeableOps_[key] = op;
+        } else if (search != mergeableOps_.end()) {
+            // 之后同一key的写不能越过本次写与之前的写合并
+            mergeableOps_.erase(search);
+        }
+    }
+
+    while (!op->done) {
+        if (!committing_) {
+            committing_ = true;
+            CommitBatch(&lk);
+            committing_ = false;
+            queueCond_.notify_all();
+        } else {
+            queueCond_.wait(lk);
+        }
+    }
+    return op->ret;
+}
+
+void SnapshotCloneMetaStoreEtcd::CommitBatch(
+    std::unique_lock<std::mutex> *lk) {
+    std::vector<PendingOpPtr> batch;
+    std::set<std::string> keys;
+    while (!pendingOps_.empty() && batch.size() < batchMaxOps_) {
+        PendingOpPtr op = pendingOps_.front();
+        // etcd事务中同一key只能出现一次，留到下一批提交
+        if (!keys.insert(op->key).second) {
+            break;
+        }
+        pendingOps_.pop_front();
+        auto search = mergeableOps_.find(op->key);
+        if (search != mergeableOps_.end() && search->second == op) {
+            mergeableOps_.erase(search);
+        }
+        batch.push_back(op);
+    }
+    if (batch.empty()) {
+        return;
+    }
+    lk->unlock();
+
+    int errCode;
+    if (batch.size() == 1) {
+        PendingOpPtr op = batch[0];
+        if (op->type == OpType::OpPut) {
+            errCode = client_->Put(op->key, op->value);
+        } else {
+            errCode = client_->Delete(op->key);
+        }
+    } else {
+        std::vector<Operation> ops;
+        ops.reserve(batch.size());
+        for (auto &op : batch) {
+            ops.push_back(Operation{op->type,
+                const_cast<char*>(op->key.c_str()),
+                const_cast<char*>(op->value.c_str()),
+                static_cast<int>(op->key.size()),
+                static_cast<int>(op->value.size())});
+        }
+        errCode = client_->TxnN(ops);
+    }
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "Commit meta to etcd err"
+                   << ", errcode = " << errCode
+                   << ", op num = " << batch.size()
+                   << ", first key = " << batch[0]->key;
+    } else {
+        // 仍持有提交权，按提交顺序更新内存记录
+        for (auto &op : batch) {
+            op->apply();
+        }
+    }
+
+    lk->lock();
+    for (auto &op : batch) {
+        op->ret = errCode;
+        op->done = true;
+    }
+}
+
 int SnapshotCloneMetaStoreEtcd::AddSnapshot(const SnapshotInfo &info) {
     std::string key = codec_->EncodeSnapshotKey(info.GetUuid());
     std::string value;
@@ -50,33 +255,41 @@ int SnapshotCloneMetaStoreEtcd::AddSnapshot(const SnapshotInfo &info) {
         return -1;
     }
 
-    WriteLockGuard guard(snapInfos_mutex);
-    int errCode = client_->Put(key, value);
+    SnapshotShard *shard = &GetSnapshotShard(info.GetUuid());
+    int errCode = CommitOp(OpType::OpPut, key, value, false,
+        [shard, info]() {
+            WriteLockGuard guard(shard->lock);
+            if (shard->infos.find(info.GetUuid()) == shard->infos.end()) {
+                PutSnapshot(shard, info);
+            }
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put snapInfo into etcd err"
                    << ", errcode = " << errCode
                    << ", snapInfo : " << info;
         return -1;
     }
-
-    snapInfos_.emplace(info.GetUuid(), info);
     return 0;
 }
 
 int SnapshotCloneMetaStoreEtcd::DeleteSnapshot(const UUID &uuid) {
     std::string key = codec_->EncodeSnapshotKey(uuid);
-    WriteLockGuard guard(snapInfos_mutex);
-    int errCode = client_->Delete(key);
+    SnapshotShard *shard = &GetSnapshotShard(uuid);
+    int errCode = CommitOp(OpType::OpDelete, key, "", false,
+        [shard, uuid]() {
+            WriteLockGuard guard(shard->lock);
+            auto search = shard->infos.find(uuid);
+            if (search != shard->infos.end()) {
+                EraseSnapshotIndex(shard, search->second);
+                shard->infos.erase(search);
+            }
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "delete snapInfo from etcd err"
                    << ", errcode = " << errCode
                    << ", uuid = " << uuid;
         return -1;
     }
-    auto search = snapInfos_.find(uuid);
-    if (search != snapInfos_.end()) {
-        snapInfos_.erase(search);
-    }
     return 0;
 }
 
@@ -89,28 +302,28 @@ int SnapshotCloneMetaStoreEtcd::UpdateSnapshot(const SnapshotInfo &info) {
                    << ", snapInfo : " << info;
         return -1;
     }
-    WriteLockGuard guard(snapInfos_mutex);
-    int errCode = client_->Put(key, value);
+    SnapshotShard *shard = &GetSnapshotShard(info.GetUuid());
+    int errCode = CommitOp(OpType::OpPut, key, value,
+        IsMergeableStatus(info.GetStatus()),
+        [shard, info]() {
+            WriteLockGuard guard(shard->lock);
+            PutSnapshot(shard, info);
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put snapInfo into etcd err"
                    << ", errcode = " << errCode
                    << ", snapInfo : " << info;
         return -1;
     }
-    auto search = snapInfos_.find(info.GetUuid());
-    if (search != snapInfos_.end()) {
-        search->second = info;
-    } else {
-        snapInfos_.emplace(info.GetUuid(), info);
-    }
     return 0;
 }
 
 int SnapshotCloneMetaStoreEtcd::GetSnapshotInfo(
     const UUID &uuid, SnapshotInfo *info) {
-    ReadLockGuard guard(snapInfos_mutex);
-    auto search = snapInfos_.find(uuid);
-    if (search != snapInfos_.end()) {
+    SnapshotShard &shard = GetSnapshotShard(uuid);
+    ReadLockGuard guard(shard.lock);
+    auto search = shard.infos.find(uuid);
+    if (search != shard.infos.end()) {
         *info = search->second;
         return 0;
     }
@@ -119,14 +332,11 @@ int SnapshotCloneMetaStoreEtcd::GetSnapshotInfo(
 
 int SnapshotCloneMetaStoreEtcd::GetSnapshotList(const std::string &filename,
     std::vector<SnapshotInfo> *v) {
-    ReadLockGuard guard(snapInfos_mutex);
-    for (auto it = snapInfos_.begin();
-         it != snapInfos_.end();
-         it++) {
-        if (filename == it->second.GetFileName()) {
-            v->push_back(it->second);
-        }
-    }
+    SnapshotListFilter filter;
+    filter.file = &filename;
+    uint64_t total = 0;
+    GetSnapshotListByPage(filter, 0, std::numeric_limits<uint64_t>::max(),
+        v, &total);
     if (v->size() != 0) {
         return 0;
     }
@@ -135,21 +345,115 @@ int SnapshotCloneMetaStoreEtcd::GetSnapshotList(const std::string &filename,
 
 int SnapshotCloneMetaStoreEtcd::GetSnapshotList(
     std::vector<SnapshotInfo> *list) {
-    ReadLockGuard guard(snapInfos_mutex);
-    for (auto it = snapInfos_.begin();
-          it != snapInfos_.end();
-          it++) {
-       list->push_back(it->second);
-    }
+    uint64_t total = 0;
+    GetSnapshotListByPage(SnapshotListFilter(), 0,
+        std::numeric_limits<uint64_t>::max(), list, &total);
     if (list->size() != 0) {
         return 0;
     }
     return -1;
 }
 
+void SnapshotCloneMetaStoreEtcd::CollectSnapshots(const SnapshotShard &shard,
+    const SnapshotListFilter &filter,
+    std::vector<const SnapshotInfo*> *out) {
+    auto collect = [&](const UUID &uuid) {
+        auto search = shard.infos.find(uuid);
+        if (search != shard.infos.end() && filter.IsMatch(search->second)) {
+            out->push_back(&search->second);
+        }
+    };
+
+    // 优先使用区分度高的条件缩小范围，其余条件逐条检查
+    const std::set<UUID> *candidates = nullptr;
+    if (filter.uuid != nullptr) {
+        collect(*filter.uuid);
+        return;
+    } else if (filter.file != nullptr) {
+        auto it = shard.fileIndex.find(*filter.file);
+        if (it == shard.fileIndex.end()) {
+            return;
+        }
+        candidates = &it->second;
+    } else if (filter.user != nullptr) {
+        auto it = shard.userIndex.find(*filter.user);
+        if (it == shard.userIndex.end()) {
+            return;
+        }
+        candidates = &it->second;
+    } else if (filter.status != nullptr) {
+        auto it = shard.statusIndex.find(*filter.status);
+        if (it == shard.statusIndex.end()) {
+            return;
+        }
+        candidates = &it->second;
+    }
+
+    if (candidates != nullptr) {
+        out->reserve(candidates->size());
+        for (auto &uuid : *candidates) {
+            collect(uuid);
+        }
+    } else {
+        out->reserve(shard.infos.size());
+        for (auto &item : shard.infos) {
+            out->push_back(&item.second);
+        }
+    }
+}
+
+int SnapshotCloneMetaStoreEtcd::GetSnapshotListByPage(
+    const SnapshotListFilter &filter,
+    uint64_t offset,
+    uint64_t limit,
+    std::vector<SnapshotInfo> *list,
+    uint64_t *total) {
+    // 按固定顺序对所有分片加读锁，得到一致的快照视图
+    for (auto &shard : snapShards_) {
+        shard->lock.RDLock();
+    }
+    std::vector<std::vector<const SnapshotInfo*>> parts(snapShards_.size());
+    *total = 0;
+    for (size_t i = 0; i < snapShards_.size(); i++) {
+        CollectSnapshots(*snapShards_[i], filter, &parts[i]);
+        *total += parts[i].size();
+    }
+
+    // 各分片内已按uuid有序，多路归并得到全局有序的当前页
+    std::vector<size_t> pos(parts.size(), 0);
+    uint64_t index = 0;
+    uint64_t taken = 0;
+    while (index < *total && taken < limit) {
+        size_t minPart = parts.size();
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (pos[i] < parts[i].size() &&
+                (minPart == parts.size() ||
+                 parts[i][pos[i]]->GetUuid() <
+                 parts[minPart][pos[minPart]]->GetUuid())) {
+                minPart = i;
+            }
+        }
+        if (index >= offset) {
+            list->push_back(*parts[minPart][pos[minPart]]);
+            taken++;
+        }
+        pos[minPart]++;
+        index++;
+    }
+
+    for (auto &shard : snapShards_) {
+        shard->lock.Unlock();
+    }
+    return 0;
+}
+
 uint32_t SnapshotCloneMetaStoreEtcd::GetSnapshotCount() {
-    ReadLockGuard guard(snapInfos_mutex);
-    return snapInfos_.size();
+    uint32_t count = 0;
+    for (auto &shard : snapShards_) {
+        ReadLockGuard guard(shard->lock);
+        count += shard->infos.size();
+    }
+    return count;
 }
 
 int SnapshotCloneMetaStoreEtcd::AddCloneInfo(const CloneInfo &info) {
@@ -161,32 +465,37 @@ int SnapshotCloneMetaStoreEtcd::AddCloneInfo(const CloneInfo &info) {
                    << ", cloneInfo : " << info;
         return -1;
     }
-    WriteLockGuard guard(cloneInfos_lock_);
-    int errCode = client_->Put(key, value);
+    CloneShard *shard = &GetCloneShard(info.GetTaskId());
+    int errCode = CommitOp(OpType::OpPut, key, value, false,
+        [shard, info]() {
+            WriteLockGuard guard(shard->lock);
+            if (shard->infos.find(info.GetTaskId()) == shard->infos.end()) {
+                PutCloneInfo(shard, info);
+            }
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put cloneInfo into etcd err"
                    << ", errcode = " << errCode
                    << ", cloneInfo : " << info;
         return -1;
     }
-    cloneInfos_.emplace(info.GetTaskId(), info);
     return 0;
 }
 
 int SnapshotCloneMetaStoreEtcd::DeleteCloneInfo(const std::string &uuid) {
     std::string key = codec_->EncodeCloneInfoKey(uuid);
-    WriteLockGuard guard(cloneInfos_lock_);
-    int errCode = client_->Delete(key);
+    CloneShard *shard = &GetCloneShard(uuid);
+    int errCode = CommitOp(OpType::OpDelete, key, "", false,
+        [shard, uuid]() {
+            WriteLockGuard guard(shard->lock);
+            EraseCloneInfo(shard, uuid);
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "delete cloneInfo from etcd err"
                    << ", errcode = " << errCode
                    << ", uuid = " << uuid;
         return -1;
     }
-    auto search = cloneInfos_.find(uuid);
-    if (search != cloneInfos_.end()) {
-        cloneInfos_.erase(search);
-    }
     return 0;
 }
 
@@ -199,39 +508,39 @@ int SnapshotCloneMetaStoreEtcd::UpdateCloneInfo(const CloneInfo &info) {
                    << ", cloneInfo : " << info;
         return -1;
     }
-    WriteLockGuard guard(cloneInfos_lock_);
     // if old record not exist, return failed
-    std::string oldValue;
-    int errCode = client_->Get(key, &oldValue);
-    if (errCode != EtcdErrCode::EtcdOK) {
-        LOG(ERROR) << "Get old cloneInfo from etcd err"
-                   << ", errcode = " << errCode
-                   << ", cloneInfo : " << info;
-        return -1;
+    // 内存与etcd中的记录一致，无需再从etcd读取旧记录
+    CloneShard *shard = &GetCloneShard(info.GetTaskId());
+    {
+        ReadLockGuard guard(shard->lock);
+        if (shard->infos.find(info.GetTaskId()) == shard->infos.end()) {
+            LOG(ERROR) << "UpdateCloneInfo old record not exist"
+                       << ", cloneInfo : " << info;
+            return -1;
+        }
     }
 
-    errCode = client_->Put(key, value);
+    int errCode = CommitOp(OpType::OpPut, key, value,
+        IsMergeableStatus(info.GetStatus()),
+        [shard, info]() {
+            WriteLockGuard guard(shard->lock);
+            PutCloneInfo(shard, info);
+        });
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put cloneInfo into etcd err"
                    << ", errcode = " << errCode
                    << ", cloneInfo : " << info;
         return -1;
     }
-    auto search = cloneInfos_.find(info.GetTaskId());
-    if (search != cloneInfos_.end()) {
-        search->second = info;
-    } else {
-        LOG(ERROR) << "UpdateCloneInfo old record not exist";
-        return -1;
-    }
     return 0;
 }
 
 int SnapshotCloneMetaStoreEtcd::GetCloneInfo(
     const std::string &uuid, CloneInfo *info) {
-    ReadLockGuard guard(cloneInfos_lock_);
-    auto search = cloneInfos_.find(uuid);
-    if (search != cloneInfos_.end()) {
+    CloneShard &shard = GetCloneShard(uuid);
+    ReadLockGuard guard(shard.lock);
+    auto search = shard.infos.find(uuid);
+    if (search != shard.infos.end()) {
         *info = search->second;
         return 0;
     }
@@ -240,10 +549,14 @@ int SnapshotCloneMetaStoreEtcd::GetCloneInfo(
 
 int SnapshotCloneMetaStoreEtcd::GetCloneInfoByFileName(
     const std::string &fileName, std::vector<CloneInfo> *list) {
-    ReadLockGuard guard(cloneInfos_lock_);
-    for (auto it = cloneInfos_.begin(); it != cloneInfos_.end(); it++) {
-        if (it->second.GetDest() == fileName) {
-            list->push_back(it->second);
+    for (auto &shard : cloneShards_) {
+        ReadLockGuard guard(shard->lock);
+        auto it = shard->destIndex.find(fileName);
+        if (it == shard->destIndex.end()) {
+            continue;
+        }
+        for (auto &taskId : it->second) {
+            list->push_back(shard->infos.at(taskId));
         }
     }
     if (list->size() != 0) {
@@ -253,12 +566,16 @@ int SnapshotCloneMetaStoreEtcd::GetCloneInfoByFileName(
 }
 
 int SnapshotCloneMetaStoreEtcd::GetCloneInfoList(std::vector<CloneInfo> *list) {
-    ReadLockGuard guard(cloneInfos_lock_);
-    for (auto it = cloneInfos_.begin();
-             it != cloneInfos_.end();
-             it++) {
-            list->push_back(it->second);
+    for (auto &shard : cloneShards_) {
+        ReadLockGuard guard(shard->lock);
+        for (auto &item : shard->infos) {
+            list->push_back(item.second);
+        }
     }
+    std::sort(list->begin(), list->end(),
+        [](const CloneInfo &a, const CloneInfo &b) {
+            return a.GetTaskId() < b.GetTaskId();
+        });
     if (list->size() != 0) {
         return 0;
     }
@@ -268,7 +585,6 @@ int SnapshotCloneMetaStoreEtcd::GetCloneInfoList(std::vector<CloneInfo> *list) {
 int SnapshotCloneMetaStoreEtcd::LoadSnapshotInfos() {
     std::string startKey = SnapshotCloneCodec::GetSnapshotInfoKeyPrefix();
     std::string endKey = SnapshotCloneCodec::GetSnapshotInfoKeyEnd();
-    WriteLockGuard guard(snapInfos_mutex);
     std::vector<std::string> out;
     int errCode = client_->List(startKey, endKey, &out);
     if (errCode != EtcdErrCode::EtcdOK) {
@@ -282,16 +598,17 @@ int SnapshotCloneMetaStoreEtcd::LoadSnapshotInfos() {
             LOG(ERROR) << "DecodeSnapshotData err";
             return -1;
         }
-        snapInfos_.emplace(data.GetUuid(), data);
+        SnapshotShard &shard = GetSnapshotShard(data.GetUuid());
+        WriteLockGuard guard(shard.lock);
+        PutSnapshot(&shard, data);
     }
-    LOG(INFO) << "LoadSnapshotInfos size = " << snapInfos_.size();
+    LOG(INFO) << "LoadSnapshotInfos size = " << out.size();
     return 0;
 }
 
 int SnapshotCloneMetaStoreEtcd::LoadCloneInfos() {
     std::string startKey = SnapshotCloneCodec::GetCloneInfoKeyPrefix();
     std::string endKey = SnapshotCloneCodec::GetCloneInfoKeyEnd();
-    WriteLockGuard guard(cloneInfos_lock_);
     std::vector<std::string> out;
     int errCode = client_->List(startKey, endKey, &out);
     if (errCode != EtcdErrCode::EtcdOK) {
@@ -305,12 +622,13 @@ int SnapshotCloneMetaStoreEtcd::LoadCloneInfos() {
             LOG(ERROR) << "DecodeCloneInfoData err";
             return -1;
         }
-        cloneInfos_.emplace(data.GetTaskId(), data);
+        CloneShard &shard = GetCloneShard(data.GetTaskId());
+        WriteLockGuard guard(shard.lock);
+        PutCloneInfo(&shard, data);
     }
-    LOG(INFO) << "LoadCloneInfos size = " << cloneInfos_.size();
+    LOG(INFO) << "LoadCloneInfos size = " << out.size();
     return 0;
 }
 
 }  // namespace snapshotcloneserver
 }  // namespace curve
-
@@ -23,9 +23,14 @@
 #ifndef SRC_SNAPSHOTCLONESERVER_COMMON_SNAPSHOTCLONE_META_STORE_ETCD_H_
 #define SRC_SNAPSHOTCLONESERVER_COMMON_SNAPSHOTCLONE_META_STORE_ETCD_H_
 
+#include <condition_variable>  //NOLINT
+#include <deque>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <map>
+#include <mutex>  //NOLINT
+#include <set>
 #include <string>
 
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store.h"
@@ -42,12 +47,27 @@ using ::curve::common::WriteLockGuard;
 namespace curve {
 namespace snapshotcloneserver {
 
+// 内存中快照和克隆记录的默认分片数
+const uint32_t kDefaultMetaStoreShardNum = 16;
+// 一个etcd事务中最多合并的写操作数, etcd默认限制单个事务最多128个操作
+const uint32_t kDefaultMetaStoreBatchMaxOps = 64;
+const uint32_t kMaxMetaStoreBatchMaxOps = 128;
+
+/**
+ * 内存中的记录按uuid的hash分片，每个分片有独立的读写锁，
+ * 并在分片内维护按文件、用户、状态的二级索引。
+ *
+ * 所有对etcd的写按提交顺序排队，由排在最前面的调用者将队列中的写合并为
+ * 一个etcd事务提交(组提交)，其他调用者等待自己的写提交完成后返回。
+ * 非终态的更新(如快照和克隆过程中的进度更新)与同一记录尚未提交的非终态
+ * 更新合并，只提交最新的值；添加、删除和终态的更新不合并。
+ */
 class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
  public:
     SnapshotCloneMetaStoreEtcd(std::shared_ptr<KVStorageClient> client,
-        std::shared_ptr<SnapshotCloneCodec> codec)
-    : client_(client),
-      codec_(codec) {}
+        std::shared_ptr<SnapshotCloneCodec> codec,
+        uint32_t shardNum = kDefaultMetaStoreShardNum,
+        uint32_t batchMaxOps = kDefaultMetaStoreBatchMaxOps);
 
     int Init();
 
@@ -64,6 +84,12 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
 
     int GetSnapshotList(std::vector<SnapshotInfo> *list) override;
 
+    int GetSnapshotListByPage(const SnapshotListFilter &filter,
+                              uint64_t offset,
+                              uint64_t limit,
+                              std::vector<SnapshotInfo> *list,
+                              uint64_t *total) override;
+
     uint32_t GetSnapshotCount() override;
 
     int AddCloneInfo(const CloneInfo &info) override;
@@ -80,6 +106,81 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
     int GetCloneInfoList(std::vector<CloneInfo> *list) override;
 
  private:
+    struct SnapshotShard {
+        RWLock lock;
+        // key is UUID
+        std::map<UUID, SnapshotInfo> infos;
+        // 文件名 => uuid
+        std::map<std::string, std::set<UUID>> fileIndex;
+        // 用户名 => uuid
+        std::map<std::string, std::set<UUID>> userIndex;
+        // 状态 => uuid
+        std::map<Status, std::set<UUID>> statusIndex;
+    };
+
+    struct CloneShard {
+        RWLock lock;
+        // key is TaskIdType
+        std::map<std::string, CloneInfo> infos;
+        // 目标文件名 => taskId
+        std::map<std::string, std::set<std::string>> destIndex;
+    };
+
+    // 排队等待提交到etcd的写操作
+    struct PendingOp {
+        OpType type;
+        std::string key;
+        std::string value;
+        // 是否可与同一key之后的写合并
+        bool mergeable;
+        // 提交成功后更新内存记录
+        std::function<void()> apply;
+        bool done = false;
+        int ret = 0;
+    };
+    using PendingOpPtr = std::shared_ptr<PendingOp>;
+
+    /**
+     * @brief 将写操作排队，等待其提交到etcd后返回
+     *
+     * @param type 写操作类型
+     * @param key etcd的key
+     * @param value 写入的值，删除时为空
+     * @param mergeable 是否可与同一key上尚未提交的可合并写合并
+     * @param apply 提交成功后更新内存记录
+     *
+     * @return etcd错误码
+     */
+    int CommitOp(OpType type, const std::string &key,
+                 const std::string &value, bool mergeable,
+                 std::function<void()> apply);
+
+    /**
+     * @brief 取出队列头部的一批写操作，以一个etcd事务提交
+     *
+     * @param lk 已持有的队列锁，提交etcd时释放
+     */
+    void CommitBatch(std::unique_lock<std::mutex> *lk);
+
+    SnapshotShard &GetSnapshotShard(const UUID &uuid);
+    CloneShard &GetCloneShard(const std::string &taskId);
+
+    // 需在持有分片写锁时调用
+    static void InsertSnapshotIndex(SnapshotShard *shard,
+                                    const SnapshotInfo &info);
+    static void EraseSnapshotIndex(SnapshotShard *shard,
+                                   const SnapshotInfo &info);
+    static void PutSnapshot(SnapshotShard *shard, const SnapshotInfo &info);
+    static void PutCloneInfo(CloneShard *shard, const CloneInfo &info);
+    static void EraseCloneInfo(CloneShard *shard, const std::string &taskId);
+
+    /**
+     * @brief 收集分片内满足过滤条件的快照，按uuid有序，需持有分片读锁
+     */
+    static void CollectSnapshots(const SnapshotShard &shard,
+                                 const SnapshotListFilter &filter,
+                                 std::vector<const SnapshotInfo*> *out);
+
     /**
      * @brief 加载快照信息
      *
@@ -98,14 +199,20 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
     std::shared_ptr<KVStorageClient> client_;
     std::shared_ptr<SnapshotCloneCodec> codec_;
 
-    // key is UUID, map 需要考虑并发保护
-    std::map<UUID, SnapshotInfo> snapInfos_;
-    // snap info lock
-    RWLock snapInfos_mutex;
-    // key is TaskIdType, map 需要考虑并发保护
-    std::map<std::string, CloneInfo> cloneInfos_;
-    // clone info map lock
-    RWLock cloneInfos_lock_;
+    std::vector<std::unique_ptr<SnapshotShard>> snapShards_;
+    std::vector<std::unique_ptr<CloneShard>> cloneShards_;
+
+    // 一个etcd事务中最多合并的写操作数
+    uint32_t batchMaxOps_;
+    // 保护以下写队列相关的成员
+    std::mutex queueMutex_;
+    std::condition_variable queueCond_;
+    // 按提交顺序排队的写操作
+    std::deque<PendingOpPtr> pendingOps_;
+    // key => 队列中该key最后一个可合并的写操作
+    std::map<std::string, PendingOpPtr> mergeableOps_;
+    // 是否有调用者正在提交
+    bool committing_;
 };
 
 }  // namespace snapshotcloneserver
@@ -76,6 +76,33 @@ struct SnapshotMetric {
             GetSnapshotTotalNum, metaStore_.get()) {}
 };
 
+struct SnapshotTransferMetric {
+    const std::string SnapshotTransferMetricPrefix =
+        "snapshotcloneserver_snapshot_transfer_";
+
+    // 读阶段：从chunkserver读取的字节数及吞吐，正在进行的读取数
+    bvar::Adder<uint64_t> readBytes;
+    bvar::PerSecond<bvar::Adder<uint64_t>> readBps;
+    bvar::Adder<int32_t> readInflight;
+    // 上传阶段(含摘要和编码)：上传的原始字节数及吞吐，排队及正在上传的分片数
+    bvar::Adder<uint64_t> uploadBytes;
+    bvar::PerSecond<bvar::Adder<uint64_t>> uploadBps;
+    bvar::Adder<int32_t> uploadPending;
+    // 分片缓冲区：已使用的缓冲区数，因缓冲区用尽而等待的次数
+    bvar::Adder<int32_t> bufferUsed;
+    bvar::Adder<uint64_t> bufferWait;
+
+    SnapshotTransferMetric() :
+        readBytes(SnapshotTransferMetricPrefix, "read_bytes"),
+        readBps(SnapshotTransferMetricPrefix, "read_bps", &readBytes),
+        readInflight(SnapshotTransferMetricPrefix, "read_inflight"),
+        uploadBytes(SnapshotTransferMetricPrefix, "upload_bytes"),
+        uploadBps(SnapshotTransferMetricPrefix, "upload_bps", &uploadBytes),
+        uploadPending(SnapshotTransferMetricPrefix, "upload_pending"),
+        bufferUsed(SnapshotTransferMetricPrefix, "buffer_used"),
+        bufferWait(SnapshotTransferMetricPrefix, "buffer_wait") {}
+};
+
 struct SnapshotInfoMetric {
     const std::string SnapshotInfoMetricPrefix =
         "snapshotcloneserver_snapshotInfo_metric_";
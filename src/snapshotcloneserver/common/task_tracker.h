@@ -41,6 +41,7 @@ class TrackerTask;
 
 struct RecoverChunkContext;
 struct CreateCloneChunkContext;
+struct BulkWriteChunkContext;
 
 // 并发任务跟踪模块
 class TaskTracker : public std::enable_shared_from_this<TaskTracker> {
@@ -134,6 +135,10 @@ using CreateCloneChunkContextPtr = std::shared_ptr<CreateCloneChunkContext>;
 using CreateCloneChunkTaskTracker =
     ContextTaskTracker<CreateCloneChunkContextPtr>;
 
+using BulkWriteChunkContextPtr = std::shared_ptr<BulkWriteChunkContext>;
+using BulkWriteChunkTaskTracker =
+    ContextTaskTracker<BulkWriteChunkContextPtr>;
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
@@ -38,12 +38,21 @@ using ::curve::common::LockGuard;
 namespace curve {
 namespace snapshotcloneserver {
 
+// 分页查询快照segment时每页的segment数
+const uint32_t kListSnapshotSegmentLimit = 1024;
+
 int SnapshotCoreImpl::Init() {
     int ret = threadPool_->Start();
     if (ret < 0) {
         LOG(ERROR) << "SnapshotCoreImpl, thread start fail, ret = " << ret;
         return ret;
     }
+    ret = transferPipeline_->Start();
+    if (ret < 0) {
+        LOG(ERROR) << "SnapshotCoreImpl, transfer pipeline start fail"
+                   << ", ret = " << ret;
+        return ret;
+    }
     return kErrCodeSuccess;
 }
 
@@ -289,6 +298,19 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
         HandleCreateSnapshotError(task);
         return;
     }
+
+    // 重启时索引块中已记录了基准chunk，不再重新选择
+    if (snapshotDeltaEnable_ && !existIndexData &&
+        BuildChunkDeltaBase(fileSnapshotMap, &indexData)) {
+        ret = dataStore_->PutChunkIndexData(name, indexData);
+        if (ret < 0) {
+            LOG(ERROR) << "PutChunkIndexData with delta base error, "
+                       << " ret = " << ret
+                       << ", uuid = " << task->GetUuid();
+            HandleCreateSnapshotError(task);
+            return;
+        }
+    }
     task->SetProgress(kProgressBuildSnapshotMapComplete);
     task->UpdateMetric();
 
@@ -296,8 +318,12 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
         ret = TransferSnapshotData(indexData,
             *info,
             segInfos,
-            [this] (const ChunkDataName &chunkDataName) {
-                return dataStore_->ChunkDataExist(chunkDataName);
+            [this, &indexData] (const ChunkDataName &chunkDataName) {
+                ChunkDataName base;
+                return dataStore_->ChunkDataExist(chunkDataName) ||
+                    (indexData.GetChunkDeltaBase(
+                        chunkDataName.chunkIndex_, &base) &&
+                     dataStore_->ChunkDeltaDataExist(chunkDataName));
             },
             task);
     } else {
@@ -401,20 +427,18 @@ void SnapshotCoreImpl::CancelAfterTransferSnapshotData(
     for (auto &chunkIndex : chunkIndexVec) {
         ChunkDataName chunkDataName;
         indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-        if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
-            (dataStore_->ChunkDataExist(chunkDataName))) {
-            int ret =  dataStore_->DeleteChunkData(chunkDataName);
-            if (ret < 0) {
-                LOG(ERROR) << "DeleteChunkData error"
-                           << "while canceling CreateSnapshot, "
-                           << " ret = " << ret
-                           << ", fileName = " << task->GetFileName()
-                           << ", seqNum = " << chunkDataName.chunkSeqNum_
-                           << ", chunkIndex = " << chunkDataName.chunkIndex_
-                           << ", uuid = " << task->GetUuid();
-                HandleCreateSnapshotError(task);
-                return;
-            }
+        int ret = DeleteChunkDataNotInUse(indexData, chunkIndex,
+            fileSnapshotMap);
+        if (ret < 0) {
+            LOG(ERROR) << "DeleteChunkData error"
+                       << "while canceling CreateSnapshot, "
+                       << " ret = " << ret
+                       << ", fileName = " << task->GetFileName()
+                       << ", seqNum = " << chunkDataName.chunkSeqNum_
+                       << ", chunkIndex = " << chunkDataName.chunkIndex_
+                       << ", uuid = " << task->GetUuid();
+            HandleCreateSnapshotError(task);
+            return;
         }
     }
     CancelAfterCreateChunkIndexData(task);
@@ -738,6 +762,51 @@ int SnapshotCoreImpl::BuildChunkIndexData(
 }
 
 int SnapshotCoreImpl::BuildSegmentInfo(
+    const SnapshotInfo &info,
+    std::map<uint64_t, SegmentInfo> *segInfos) {
+    std::string fileName = info.GetFileName();
+    std::string user = info.GetUser();
+    uint64_t seq = info.GetSeqNum();
+    uint64_t fileLength = info.GetFileLength();
+    uint64_t segmentSize = info.GetSegmentSize();
+    // 分页获取已分配的segment，未分配的segment不会返回
+    uint64_t startOffset = 0;
+    do {
+        std::vector<SegmentInfo> segInfoPage;
+        uint64_t nextOffset = 0;
+        int ret = client_->ListSnapshotSegmentInfo(
+            fileName,
+            user,
+            seq,
+            startOffset,
+            kListSnapshotSegmentLimit,
+            &segInfoPage,
+            &nextOffset);
+        if (-LIBCURVE_ERROR::NOT_SUPPORT == ret && 0 == startOffset) {
+            return BuildSegmentInfoByOffset(info, segInfos);
+        } else if (LIBCURVE_ERROR::OK != ret) {
+            LOG(ERROR) << "ListSnapshotSegmentInfo error,"
+                       << " ret = " << ret
+                       << ", fileName = " << fileName
+                       << ", user = " << user
+                       << ", seq = " << seq
+                       << ", startOffset = " << startOffset
+                       << ", uuid = " << info.GetUuid();
+            return kErrCodeInternalError;
+        }
+        for (auto &segInfo : segInfoPage) {
+            if (segInfo.startoffset >= fileLength) {
+                continue;
+            }
+            uint64_t index = segInfo.startoffset / segmentSize;
+            segInfos->emplace(index, std::move(segInfo));
+        }
+        startOffset = nextOffset;
+    } while (startOffset != 0);
+    return kErrCodeSuccess;
+}
+
+int SnapshotCoreImpl::BuildSegmentInfoByOffset(
     const SnapshotInfo &info,
     std::map<uint64_t, SegmentInfo> *segInfos) {
     int ret = kErrCodeSuccess;
@@ -792,6 +861,12 @@ int SnapshotCoreImpl::TransferSnapshotData(
                    << ", uuid = " << task->GetUuid();
         return kErrCodeChunkSizeNotAligned;
     }
+    if (snapshotDeltaEnable_ && (0 == snapshotDeltaPageSize_ ||
+        chunkSplitSize_ % snapshotDeltaPageSize_ != 0)) {
+        LOG(ERROR) << "error!, chunkSplitSize is not align to delta page size"
+                   << ", uuid = " << task->GetUuid();
+        return kErrCodeChunkSizeNotAligned;
+    }
 
     std::vector<ChunkIndexType> chunkIndexVec = indexData.GetAllChunkIndex();
 
@@ -847,12 +922,18 @@ int SnapshotCoreImpl::TransferSnapshotData(
                         clientAsyncMethodRetryTimeSec_,
                         clientAsyncMethodRetryIntervalMs_,
                         readChunkSnapshotConcurrency_);
+                if (snapshotDeltaEnable_) {
+                    taskInfo->deltaPageSize_ = snapshotDeltaPageSize_;
+                    taskInfo->hasDeltaBase_ = indexData.GetChunkDeltaBase(
+                        chunkIndex, &taskInfo->deltaBase_);
+                }
                 UUID taskId = UUIDGenerator().GenerateUUID();
                 auto task = new TransferSnapshotDataChunkTask(
                     taskId,
                     taskInfo,
                     client_,
-                    dataStore_);
+                    dataStore_,
+                    transferPipeline_);
                 task->SetTracker(tracker);
                 tracker->AddOneTrace();
                 threadPool_->PushTask(task);
@@ -1005,22 +1086,17 @@ void SnapshotCoreImpl::HandleDeleteSnapshotTask(
                   << "chunkDataNum =  " << chunkIndexVec.size();
 
         for (auto &chunkIndex : chunkIndexVec) {
-            ChunkDataName chunkDataName;
-            indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-            if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
-                (dataStore_->ChunkDataExist(chunkDataName))) {
-                ret =  dataStore_->DeleteChunkData(chunkDataName);
-                if (ret < 0) {
-                    LOG(ERROR) << "DeleteChunkData error, "
-                               << " ret = " << ret
-                               << ", fileName = " << task->GetFileName()
-                               << ", seqNum = " << seqNum
-                               << ", chunkIndex = "
-                               << chunkDataName.chunkIndex_
-                               << ", uuid = " << task->GetUuid();
-                    HandleDeleteSnapshotError(task);
-                    return;
-                }
+            ret = DeleteChunkDataNotInUse(indexData, chunkIndex,
+                fileSnapshotMap);
+            if (ret < 0) {
+                LOG(ERROR) << "DeleteChunkData error, "
+                           << " ret = " << ret
+                           << ", fileName = " << task->GetFileName()
+                           << ", seqNum = " << seqNum
+                           << ", chunkIndex = " << chunkIndex
+                           << ", uuid = " << task->GetUuid();
+                HandleDeleteSnapshotError(task);
+                return;
             }
             task->SetProgress(static_cast<uint32_t>(
                 kDelProgressDeleteChunkDataStart + index * progressPerData));
@@ -1137,11 +1213,78 @@ int SnapshotCoreImpl::BuildSnapshotMap(const std::string &fileName,
     return kErrCodeSuccess;
 }
 
+bool SnapshotCoreImpl::BuildChunkDeltaBase(
+    const FileSnapMap &fileSnapshotMap,
+    ChunkIndexData *indexData) {
+    bool found = false;
+    for (auto &chunkIndex : indexData->GetAllChunkIndex()) {
+        ChunkDataName chunkDataName;
+        ChunkDataName base;
+        indexData->GetChunkDataName(chunkIndex, &chunkDataName);
+        // 未变化的chunk沿用之前快照记录的基准，自身为全量数据时则不记录
+        if (fileSnapshotMap.GetChunkDeltaBase(chunkIndex, &base) &&
+            base.chunkSeqNum_ != chunkDataName.chunkSeqNum_) {
+            indexData->PutChunkDeltaBase(chunkIndex, base.chunkSeqNum_);
+            found = true;
+        }
+    }
+    return found;
+}
+
+int SnapshotCoreImpl::DeleteChunkDataNotInUse(
+    const ChunkIndexData &indexData,
+    ChunkIndexType chunkIndex,
+    const FileSnapMap &fileSnapshotMap) {
+    int ret = kErrCodeSuccess;
+    ChunkDataName chunkDataName;
+    indexData.GetChunkDataName(chunkIndex, &chunkDataName);
+    if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
+        (dataStore_->ChunkDataExist(chunkDataName))) {
+        ret = dataStore_->DeleteChunkData(chunkDataName);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    ChunkDataName base;
+    if (!indexData.GetChunkDeltaBase(chunkIndex, &base)) {
+        return kErrCodeSuccess;
+    }
+    if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
+        (dataStore_->ChunkDeltaDataExist(chunkDataName))) {
+        ret = dataStore_->DeleteChunkDeltaData(chunkDataName);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    // 基准chunk可能只被本快照的增量引用
+    if ((!fileSnapshotMap.IsExistChunk(base)) &&
+        (dataStore_->ChunkDataExist(base))) {
+        ret = dataStore_->DeleteChunkData(base);
+    }
+    return ret;
+}
+
 int SnapshotCoreImpl::GetSnapshotList(std::vector<SnapshotInfo> *list) {
     metaStore_->GetSnapshotList(list);
     return kErrCodeSuccess;
 }
 
+int SnapshotCoreImpl::GetSnapshotListByPage(const SnapshotListFilter &filter,
+    uint64_t offset,
+    uint64_t limit,
+    std::vector<SnapshotInfo> *list,
+    uint64_t *total) {
+    int ret = metaStore_->GetSnapshotListByPage(filter, offset, limit,
+        list, total);
+    if (ret < 0) {
+        LOG(ERROR) << "GetSnapshotListByPage from metastore fail"
+                   << ", ret = " << ret;
+        return kErrCodeInternalError;
+    }
+    return kErrCodeSuccess;
+}
+
 int SnapshotCoreImpl::HandleCancelUnSchduledSnapshotTask(
     std::shared_ptr<SnapshotTaskInfo> task) {
     auto &snapInfo = task->GetSnapshotInfo();
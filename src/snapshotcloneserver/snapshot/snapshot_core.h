@@ -31,6 +31,7 @@
 #include "src/snapshotcloneserver/common/curvefs_client.h"
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
+#include "src/snapshotcloneserver/snapshot/snapshot_transfer_pipeline.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
 #include "src/snapshotcloneserver/common/config.h"
 #include "src/snapshotcloneserver/common/snapshot_reference.h"
@@ -68,6 +69,39 @@ struct FileSnapMap {
         }
         return find;
     }
+
+    /**
+     * @brief 获取chunk增量转储所基于的全量chunk
+     * @detail
+     *  取各快照中该chunk最新版本的数据，若其本身可能以增量存储，
+     *  则取其基准chunk，保证增量总是相对全量数据，合并时无需逐级回溯
+     *
+     * @param index chunk索引
+     * @param[out] base 基准chunk数据名
+     *
+     * @retval true 存在
+     * @retval false 不存在
+     */
+    bool GetChunkDeltaBase(ChunkIndexType index, ChunkDataName *base) const {
+        const ChunkIndexData *latestMap = nullptr;
+        ChunkDataName latest;
+        for (auto &v : maps) {
+            ChunkDataName name;
+            if (v.GetChunkDataName(index, &name) &&
+                (nullptr == latestMap ||
+                 name.chunkSeqNum_ > latest.chunkSeqNum_)) {
+                latestMap = &v;
+                latest = name;
+            }
+        }
+        if (nullptr == latestMap) {
+            return false;
+        }
+        if (!latestMap->GetChunkDeltaBase(index, base)) {
+            *base = latest;
+        }
+        return true;
+    }
 };
 
 /**
@@ -150,6 +184,23 @@ class SnapshotCore {
      */
     virtual int GetSnapshotList(std::vector<SnapshotInfo> *list) = 0;
 
+    /**
+     * @brief 分页获取满足过滤条件的快照信息
+     *
+     * @param filter 过滤条件
+     * @param offset 跳过的快照数
+     * @param limit 本页最多返回的快照数
+     * @param[out] list 本页的快照信息列表
+     * @param[out] total 满足过滤条件的快照总数
+     *
+     * @return 错误码
+     */
+    virtual int GetSnapshotListByPage(const SnapshotListFilter &filter,
+                                      uint64_t offset,
+                                      uint64_t limit,
+                                      std::vector<SnapshotInfo> *list,
+                                      uint64_t *total) = 0;
+
 
     virtual int GetSnapshotInfo(const UUID uuid,
         SnapshotInfo *info) = 0;
@@ -185,15 +236,27 @@ class SnapshotCoreImpl : public SnapshotCore {
       clientAsyncMethodRetryTimeSec_(option.clientAsyncMethodRetryTimeSec),
       clientAsyncMethodRetryIntervalMs_(
                 option.clientAsyncMethodRetryIntervalMs),
-      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency) {
+      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency),
+      snapshotDeltaEnable_(option.snapshotDeltaEnable),
+      snapshotDeltaPageSize_(option.snapshotDeltaPageSize) {
         threadPool_ = std::make_shared<ThreadPool>(
             option.snapshotCoreThreadNum);
+        SnapshotTransferOption transferOption;
+        transferOption.splitSize = option.chunkSplitSize;
+        transferOption.bufferPoolSize = option.snapshotTransferBufferPoolSize;
+        transferOption.readConcurrency =
+            option.snapshotTransferReadConcurrency;
+        transferOption.uploadThreadNum =
+            option.snapshotTransferUploadThreadNum;
+        transferPipeline_ =
+            std::make_shared<SnapshotTransferPipeline>(transferOption);
     }
 
     int Init();
 
     ~SnapshotCoreImpl() {
         threadPool_->Stop();
+        transferPipeline_->Stop();
     }
 
     // 公有接口定义见SnapshotCore接口注释
@@ -221,6 +284,12 @@ class SnapshotCoreImpl : public SnapshotCore {
 
     int GetSnapshotList(std::vector<SnapshotInfo> *list) override;
 
+    int GetSnapshotListByPage(const SnapshotListFilter &filter,
+                              uint64_t offset,
+                              uint64_t limit,
+                              std::vector<SnapshotInfo> *list,
+                              uint64_t *total) override;
+
     int HandleCancelUnSchduledSnapshotTask(
         std::shared_ptr<SnapshotTaskInfo> task) override;
 
@@ -238,6 +307,32 @@ class SnapshotCoreImpl : public SnapshotCore {
         uint64_t seqNum,
         FileSnapMap *fileSnapshotMap);
 
+    /**
+     * @brief 为需要转储的chunk选择增量转储的基准chunk
+     *
+     * @param fileSnapshotMap 文件的其他快照的索引块
+     * @param[in,out] indexData 索引块
+     *
+     * @retval true 索引块中记录了基准chunk
+     * @retval false 没有可用的基准chunk
+     */
+    bool BuildChunkDeltaBase(const FileSnapMap &fileSnapshotMap,
+        ChunkIndexData *indexData);
+
+    /**
+     * @brief 删除不再被其他快照引用的chunk数据，
+     *        包括全量数据、增量数据以及增量转储的基准chunk
+     *
+     * @param indexData 索引块
+     * @param chunkIndex chunk索引
+     * @param fileSnapshotMap 文件的其他快照的索引块
+     *
+     * @return 错误码
+     */
+    int DeleteChunkDataNotInUse(const ChunkIndexData &indexData,
+        ChunkIndexType chunkIndex,
+        const FileSnapMap &fileSnapshotMap);
+
     /**
      * @brief 构建Segment信息
      *
@@ -250,6 +345,19 @@ class SnapshotCoreImpl : public SnapshotCore {
         const SnapshotInfo &info,
         std::map<uint64_t, SegmentInfo> *segInfos);
 
+    /**
+     * @brief 逐个segment查询构建Segment信息，
+     *        用于curvefs不支持分页查询segment的情况
+     *
+     * @param info 快照信息
+     * @param segInfos Segment信息表
+     *
+     * @return 错误码
+     */
+    int BuildSegmentInfoByOffset(
+        const SnapshotInfo &info,
+        std::map<uint64_t, SegmentInfo> *segInfos);
+
     /**
      * @brief 在curvefs上创建快照
      *
@@ -402,6 +510,8 @@ class SnapshotCoreImpl : public SnapshotCore {
 
     // 执行并发步骤的线程池
     std::shared_ptr<ThreadPool> threadPool_;
+    // 快照数据转储流水线，所有快照任务共享读并发、缓冲区和上传线程
+    std::shared_ptr<SnapshotTransferPipeline> transferPipeline_;
 
     // 锁住打快照的文件名，防止并发同时对其打快照，同一文件的快照需排队
     NameLock snapshotNameLock_;
@@ -422,6 +532,10 @@ class SnapshotCoreImpl : public SnapshotCore {
     uint64_t clientAsyncMethodRetryIntervalMs_;
     // 异步ReadChunkSnapshot的并发数
     uint32_t readChunkSnapshotConcurrency_;
+    // 是否按页增量转储快照数据
+    bool snapshotDeltaEnable_;
+    // 增量转储的页大小
+    uint32_t snapshotDeltaPageSize_;
 };
 
 }  // namespace snapshotcloneserver
@@ -22,6 +22,9 @@
 
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 
+#include <butil/sha1.h>
+#include <cstring>
+
 #include "proto/snapshotcloneserver.pb.h"
 
 namespace curve {
@@ -65,6 +68,9 @@ bool ChunkIndexData::Serialize(std::string *data) const {
                 ChunkDataName(fileName_, m.second, m.first).
                 ToDataChunkKey()});
     }
+    for (const auto &m : this->deltaBase_) {
+        map.mutable_deltabase()->insert({m.first, m.second});
+    }
     // Todo：可以转化为stream给adpater接口使用SerializeToOstream
     return map.SerializeToString(data);
 }
@@ -82,6 +88,9 @@ bool ChunkIndexData::Unserialize(const std::string &data) {
                 return false;
             }
         }
+        for (const auto &m : map.deltabase()) {
+            this->deltaBase_.emplace(m.first, m.second);
+        }
         return true;
     } else {
         return false;
@@ -109,6 +118,13 @@ bool ChunkIndexData::IsExistChunkDataName(const ChunkDataName &name) const {
             return true;
         }
     }
+    // 作为增量转储基准的chunk同样被本快照引用
+    it = deltaBase_.find(name.chunkIndex_);
+    if (it != deltaBase_.end()) {
+        if (it->second == name.chunkSeqNum_) {
+            return true;
+        }
+    }
     return false;
 }
 
@@ -120,6 +136,120 @@ std::vector<ChunkIndexType> ChunkIndexData::GetAllChunkIndex() const {
     return ret;
 }
 
+bool ChunkIndexData::GetChunkDeltaBase(ChunkIndexType index,
+    ChunkDataName* baseOut) const {
+    auto it = deltaBase_.find(index);
+    if (it != deltaBase_.end()) {
+        *baseOut = ChunkDataName(fileName_, it->second, index);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+void ChunkPageDigest::Update(uint64_t offset, uint64_t len, const char *buf) {
+    unsigned char hash[butil::kSHA1Length];
+    for (uint64_t pos = 0; pos < len; pos += pageSize_) {
+        uint64_t pageIndex = (offset + pos) / pageSize_;
+        if (pageIndex >= digests_.size()) {
+            break;
+        }
+        butil::SHA1HashBytes(
+            reinterpret_cast<const unsigned char*>(buf + pos),
+            pageSize_, hash);
+        digests_[pageIndex].assign(reinterpret_cast<char*>(hash),
+                                   butil::kSHA1Length);
+    }
+}
+
+bool ChunkPageDigest::IsPageSame(uint32_t pageIndex, const char *page) const {
+    if (pageIndex >= digests_.size() ||
+        digests_[pageIndex].size() != butil::kSHA1Length) {
+        return false;
+    }
+    unsigned char hash[butil::kSHA1Length];
+    butil::SHA1HashBytes(reinterpret_cast<const unsigned char*>(page),
+                         pageSize_, hash);
+    return 0 == memcmp(hash, digests_[pageIndex].data(), butil::kSHA1Length);
+}
+
+bool ChunkPageDigest::Serialize(std::string *data) const {
+    ChunkPageDigests digests;
+    digests.set_pagesize(pageSize_);
+    std::string *out = digests.mutable_digests();
+    out->reserve(digests_.size() * butil::kSHA1Length);
+    for (const auto &d : digests_) {
+        if (d.size() != butil::kSHA1Length) {
+            LOG(ERROR) << "ChunkPageDigest is incomplete";
+            return false;
+        }
+        out->append(d);
+    }
+    return digests.SerializeToString(data);
+}
+
+bool ChunkPageDigest::Unserialize(const std::string &data) {
+    ChunkPageDigests digests;
+    if (!digests.ParseFromString(data) ||
+        0 == digests.pagesize() ||
+        digests.digests().size() % butil::kSHA1Length != 0) {
+        return false;
+    }
+    pageSize_ = digests.pagesize();
+    uint32_t pageNum = digests.digests().size() / butil::kSHA1Length;
+    digests_.resize(pageNum);
+    for (uint32_t i = 0; i < pageNum; i++) {
+        digests_[i] = digests.digests().substr(
+            i * butil::kSHA1Length, butil::kSHA1Length);
+    }
+    return true;
+}
+
+bool ChunkDeltaData::MergeTo(std::string *data) const {
+    for (const auto &page : pages_) {
+        uint64_t offset = static_cast<uint64_t>(page.first) * pageSize_;
+        if (offset + pageSize_ > data->size()) {
+            LOG(ERROR) << "ChunkDeltaData is out of the base chunk"
+                       << ", pageIndex = " << page.first
+                       << ", pageSize = " << pageSize_
+                       << ", chunkSize = " << data->size();
+            return false;
+        }
+        data->replace(offset, pageSize_, page.second);
+    }
+    return true;
+}
+
+bool ChunkDeltaData::Serialize(std::string *data) const {
+    ChunkPageDelta delta;
+    delta.set_pagesize(pageSize_);
+    std::string *out = delta.mutable_data();
+    out->reserve(dataSize_);
+    for (const auto &page : pages_) {
+        delta.add_pages(page.first);
+        out->append(page.second);
+    }
+    return delta.SerializeToString(data);
+}
+
+bool ChunkDeltaData::Unserialize(const std::string &data) {
+    ChunkPageDelta delta;
+    if (!delta.ParseFromString(data) ||
+        0 == delta.pagesize() ||
+        delta.data().size() !=
+            static_cast<uint64_t>(delta.pages_size()) * delta.pagesize()) {
+        return false;
+    }
+    pageSize_ = delta.pagesize();
+    pages_.clear();
+    for (int i = 0; i < delta.pages_size(); i++) {
+        pages_[delta.pages(i)] = delta.data().substr(
+            static_cast<uint64_t>(i) * pageSize_, pageSize_);
+    }
+    dataSize_ = pages_.size() * pageSize_;
+    return true;
+}
+
 }   // namespace snapshotcloneserver
 }   // namespace curve
 
@@ -32,10 +32,14 @@
 #include <string>
 #include <memory>
 
+#include "src/common/chunk_codec.h"
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/location_operator.h"
 
 using ::curve::common::SpinLock;
 using ::curve::common::LockGuard;
+using ::curve::common::EncodedSplit;
+using ::curve::common::LocationOperator;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -44,6 +48,10 @@ using ChunkIndexType = uint32_t;
 using SnapshotSeqType = uint64_t;
 
 const char kChunkDataNameSeprator[] = "-";
+// 按页增量数据对象名的后缀
+const char kChunkDeltaSuffix[] = ".delta";
+// 页摘要对象名的后缀
+const char kChunkPageDigestSuffix[] = ".digest";
 
 class ChunkDataName {
  public:
@@ -68,6 +76,22 @@ class ChunkDataName {
             + std::to_string(this->chunkSeqNum_);
     }
 
+    /**
+     * 构建按页增量数据对象的名称 datachunk对象名.delta
+     * @return: 对象名称字符串
+     */
+    std::string ToDeltaChunkKey() const {
+        return ToDataChunkKey() + kChunkDeltaSuffix;
+    }
+
+    /**
+     * 构建页摘要对象的名称 datachunk对象名.digest
+     * @return: 对象名称字符串
+     */
+    std::string ToPageDigestKey() const {
+        return ToDataChunkKey() + kChunkPageDigestSuffix;
+    }
+
     std::string fileName_;
     SnapshotSeqType chunkSeqNum_;
     ChunkIndexType chunkIndex_;
@@ -142,6 +166,25 @@ class ChunkIndexData {
 
     std::vector<ChunkIndexType> GetAllChunkIndex() const;
 
+    /**
+     * 记录chunk按页增量转储时所基于的chunk，基准chunk总是全量数据
+     * @param index chunk索引
+     * @param baseSeq 基准chunk的版本号
+     */
+    void PutChunkDeltaBase(ChunkIndexType index, SnapshotSeqType baseSeq) {
+        deltaBase_[index] = baseSeq;
+    }
+
+    /**
+     * 获取chunk增量转储所基于的chunk
+     * 存在全量数据对象时以全量数据为准，增量数据仅在全量数据不存在时使用
+     * @param index chunk索引
+     * @param[out] baseOut 基准chunk数据名
+     * @return: true 该chunk可能以增量存储/ false 该chunk以全量存储
+     */
+    bool GetChunkDeltaBase(ChunkIndexType index,
+                           ChunkDataName* baseOut) const;
+
     void SetFileName(const std::string &fileName) {
         fileName_ = fileName;
     }
@@ -155,6 +198,95 @@ class ChunkIndexData {
     std::string fileName_;
     // 快照文件索引信息map
     std::map<ChunkIndexType, SnapshotSeqType> chunkMap_;
+    // 增量转储chunk的基准chunk版本号map
+    std::map<ChunkIndexType, SnapshotSeqType> deltaBase_;
+};
+
+/**
+ * chunk数据按页计算的摘要，用于增量转储时找出相对基准chunk变化的页
+ */
+class ChunkPageDigest {
+ public:
+    ChunkPageDigest() : pageSize_(0) {}
+    ChunkPageDigest(uint64_t chunkSize, uint32_t pageSize)
+        : pageSize_(pageSize),
+          digests_(chunkSize / pageSize) {}
+
+    /**
+     * 计算一段数据的页摘要
+     * @param offset 数据在chunk中的偏移，按页对齐
+     * @param len 数据长度，按页对齐
+     * @param buf 数据内容
+     */
+    void Update(uint64_t offset, uint64_t len, const char *buf);
+
+    /**
+     * 判断一页数据与摘要记录的数据是否一致
+     * @param pageIndex 页索引
+     * @param page 页数据
+     * @return: true 一致/ false 不一致
+     */
+    bool IsPageSame(uint32_t pageIndex, const char *page) const;
+
+    uint32_t GetPageSize() const {
+        return pageSize_;
+    }
+
+    uint32_t GetPageNum() const {
+        return digests_.size();
+    }
+
+    bool Serialize(std::string *data) const;
+
+    bool Unserialize(const std::string &data);
+
+ private:
+    uint32_t pageSize_;
+    std::vector<std::string> digests_;
+};
+
+/**
+ * chunk相对基准chunk变化的页
+ */
+class ChunkDeltaData {
+ public:
+    ChunkDeltaData() : pageSize_(0), dataSize_(0) {}
+    explicit ChunkDeltaData(uint32_t pageSize)
+        : pageSize_(pageSize), dataSize_(0) {}
+
+    void PutPage(uint32_t pageIndex, const char *page) {
+        pages_[pageIndex].assign(page, pageSize_);
+        dataSize_ = pages_.size() * pageSize_;
+    }
+
+    uint64_t GetDataSize() const {
+        return dataSize_;
+    }
+
+    uint32_t GetPageSize() const {
+        return pageSize_;
+    }
+
+    const std::map<uint32_t, std::string> &GetPages() const {
+        return pages_;
+    }
+
+    /**
+     * 将变化的页合并到基准chunk的数据上
+     * @param[in,out] data 基准chunk的全量数据，合并后为本chunk的全量数据
+     * @return: true 合并成功/ false 增量与基准数据不匹配
+     */
+    bool MergeTo(std::string *data) const;
+
+    bool Serialize(std::string *data) const;
+
+    bool Unserialize(const std::string &data);
+
+ private:
+    uint32_t pageSize_;
+    uint64_t dataSize_;
+    // 页索引 => 页数据
+    std::map<uint32_t, std::string> pages_;
 };
 
 
@@ -166,8 +298,12 @@ class ChunkData{
 
 class TransferTask {
  public:
-     TransferTask() {}
+     TransferTask() : encoded_(false), dataSize_(0) {}
      std::string uploadId_;
+     // 是否按分片编码存储，由DataChunkTranferInit决定
+     bool encoded_;
+     // 数据chunk的大小，供存储预分配空间，0表示未知
+     uint64_t dataSize_;
 
      void AddPartInfo(int partNum, std::string etag) {
          m_.Lock();
@@ -179,10 +315,22 @@ class TransferTask {
          return partInfo_;
      }
 
+     void AddSplitInfo(int splitIndex, const EncodedSplit &split) {
+         m_.Lock();
+         splitInfo_.emplace(splitIndex, split);
+         m_.UnLock();
+     }
+
+     std::map<int, EncodedSplit> GetSplitInfo() {
+         return splitInfo_;
+     }
+
  private:
      mutable SpinLock m_;
      // partnumber <=> etag
      std::map<int, std::string> partInfo_;
+     // 分片索引 <=> 分片编码信息
+     std::map<int, EncodedSplit> splitInfo_;
 };
 
 class SnapshotDataStore {
@@ -228,11 +376,15 @@ class SnapshotDataStore {
     // 存储快照文件的数据信息到datastore
     virtual int PutChunkData(const ChunkDataName &name,
                              const ChunkData &data) = 0;
-
-    // 读取快照文件的数据信息
+*/
+    /**
+     * 读取快照的数据chunk，编码存储的chunk解码后返回全量数据
+     * @param 数据chunk名
+     * @param[out] chunk数据
+     * @return: 0 读取成功/ -1 读取失败
+     */
     virtual int GetChunkData(const ChunkDataName &name,
                              ChunkData *data) = 0;
-*/
     /**
      * 删除快照的数据chunk
      * @param 数据chunk名
@@ -289,6 +441,59 @@ class SnapshotDataStore {
      */
     virtual int DataChunkTranferAbort(const ChunkDataName &name,
                                       std::shared_ptr<TransferTask> task) = 0;
+    /**
+     * 存储全量数据chunk的页摘要
+     * @param 数据chunk名
+     * @param 页摘要
+     * @return: 0 存储成功/ -1 存储失败
+     */
+    virtual int PutChunkPageDigest(const ChunkDataName &name,
+                                   const ChunkPageDigest &digest) = 0;
+    /**
+     * 获取全量数据chunk的页摘要
+     * @param 数据chunk名
+     * @param[out] 页摘要
+     * @return: 0 获取成功/ -1 获取失败
+     */
+    virtual int GetChunkPageDigest(const ChunkDataName &name,
+                                   ChunkPageDigest *digest) = 0;
+    /**
+     * 存储数据chunk的按页增量数据
+     * @param 数据chunk名
+     * @param 增量数据
+     * @return: 0 存储成功/ -1 存储失败
+     */
+    virtual int PutChunkDeltaData(const ChunkDataName &name,
+                                  const ChunkDeltaData &delta) = 0;
+    /**
+     * 判断数据chunk的增量数据是否存在
+     * @param 数据chunk名
+     * @return: true 存在/ false 不存在
+     */
+    virtual bool ChunkDeltaDataExist(const ChunkDataName &name) = 0;
+    /**
+     * 删除数据chunk的增量数据
+     * @param 数据chunk名
+     * @return: 0 删除成功/ -1 删除失败
+     */
+    virtual int DeleteChunkDeltaData(const ChunkDataName &name) = 0;
+    /**
+     * 将基准chunk与增量数据合并，生成数据chunk的全量数据对象，
+     * 用于从快照克隆或恢复时直接读取
+     * @param 数据chunk名
+     * @param 基准chunk名
+     * @return: 0 合并成功/ -1 合并失败
+     */
+    virtual int MergeChunkDeltaData(const ChunkDataName &name,
+                                    const ChunkDataName &base) = 0;
+    /**
+     * 生成数据chunk在克隆源端的location，chunkserver据此读取克隆数据
+     * @param 数据chunk对象名
+     * @return: location字符串
+     */
+    virtual std::string GetChunkDataLocation(const std::string &key) {
+        return LocationOperator::GenerateS3Location(key);
+    }
 };
 
 }   // namespace snapshotcloneserver
@@ -0,0 +1,757 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/snapshotcloneserver/snapshot/snapshot_data_store_local.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "src/common/location_operator.h"
+
+using ::curve::common::ChunkCodec;
+using ::curve::common::EncodedChunkHeader;
+using ::curve::common::SplitEncodeType;
+using ::curve::common::kMaxEncodedChunkHeaderSize;
+using ::curve::common::LocationOperator;
+
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+namespace curve {
+namespace snapshotcloneserver {
+
+namespace {
+// 存放临时文件的目录，位于根目录下，保证rename在同一文件系统内
+const char kTempDirName[] = ".tmp";
+// direct io的对齐大小
+const uint64_t kDirectIOAlign = 4096;
+// copy_file_range不可用时用户态拷贝的缓冲区大小
+const uint64_t kCopyBufferSize = 1024 * 1024;
+
+int MakeDirs(const std::string &dir) {
+    std::string::size_type pos = 0;
+    while (pos != std::string::npos) {
+        pos = dir.find('/', pos + 1);
+        std::string sub = dir.substr(0, pos);
+        if (sub.empty() || sub.back() == '/') {
+            continue;
+        }
+        if (mkdir(sub.c_str(), 0755) < 0 && errno != EEXIST) {
+            LOG(ERROR) << "Failed to mkdir " << sub
+                       << ", error: " << strerror(errno);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+std::string DirName(const std::string &path) {
+    std::string::size_type pos = path.find_last_of('/');
+    return pos == std::string::npos ? "." : path.substr(0, pos);
+}
+
+int SyncDir(const std::string &dir) {
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open dir " << dir
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    int ret = fsync(fd);
+    close(fd);
+    return ret;
+}
+
+int PwriteAll(int fd, const char *buf, uint64_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t ret = pwrite(fd, buf, len, offset);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "pwrite failed, error: " << strerror(errno);
+            return -1;
+        }
+        buf += ret;
+        len -= ret;
+        offset += ret;
+    }
+    return 0;
+}
+
+// 读取到文件结尾时返回实际读取的长度
+int64_t PreadAll(int fd, char *buf, uint64_t len, uint64_t offset) {
+    uint64_t done = 0;
+    while (done < len) {
+        ssize_t ret = pread(fd, buf + done, len - done, offset + done);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "pread failed, error: " << strerror(errno);
+            return -1;
+        }
+        if (ret == 0) {
+            break;
+        }
+        done += ret;
+    }
+    return done;
+}
+
+/**
+ * 在内核中拷贝文件的一段数据，copy_file_range不可用(内核版本低或跨文件系统)
+ * 时退化为用户态读写
+ */
+int CopyRange(int fdIn, uint64_t offIn, int fdOut, uint64_t offOut,
+              uint64_t len) {
+#ifdef __NR_copy_file_range
+    while (len > 0) {
+        loff_t in = offIn;
+        loff_t out = offOut;
+        ssize_t ret = syscall(__NR_copy_file_range, fdIn, &in,
+                              fdOut, &out, len, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            break;
+        }
+        offIn += ret;
+        offOut += ret;
+        len -= ret;
+    }
+    if (len == 0) {
+        return 0;
+    }
+#endif
+    std::unique_ptr<char[]> buf(
+        new char[std::min<uint64_t>(len, kCopyBufferSize)]);
+    while (len > 0) {
+        uint64_t n = std::min<uint64_t>(len, kCopyBufferSize);
+        if (PreadAll(fdIn, buf.get(), n, offIn) != static_cast<int64_t>(n) ||
+            PwriteAll(fdOut, buf.get(), n, offOut) < 0) {
+            return -1;
+        }
+        offIn += n;
+        offOut += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// 将临时文件持久化后原子地替换为正式文件
+int CommitFile(const std::string &tmpPath, const std::string &path) {
+    std::string dir = DirName(path);
+    if (MakeDirs(dir) < 0) {
+        return -1;
+    }
+    if (rename(tmpPath.c_str(), path.c_str()) < 0) {
+        LOG(ERROR) << "Failed to rename " << tmpPath << " to " << path
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    return SyncDir(dir);
+}
+}  // namespace
+
+LocalSnapshotDataStore::~LocalSnapshotDataStore() {
+    for (auto &v : transferFiles_) {
+        CloseTransferFile(v.second, true);
+    }
+}
+
+int LocalSnapshotDataStore::Init(const std::string &path) {
+    rootPath_ = path;
+    while (rootPath_.size() > 1 && rootPath_.back() == '/') {
+        rootPath_.pop_back();
+    }
+    tmpPath_ = rootPath_ + "/" + kTempDirName;
+    if (MakeDirs(tmpPath_) < 0) {
+        LOG(ERROR) << "Failed to create snapshot data dir " << rootPath_;
+        return -1;
+    }
+
+    // 只有leader初始化datastore，残留的临时文件都来自未完成的转储
+    DIR *dir = opendir(tmpPath_.c_str());
+    if (dir == nullptr) {
+        LOG(ERROR) << "Failed to open dir " << tmpPath_
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 ||
+            strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        std::string file = tmpPath_ + "/" + entry->d_name;
+        if (unlink(file.c_str()) < 0) {
+            LOG(WARNING) << "Failed to remove temp file " << file
+                         << ", error: " << strerror(errno);
+        }
+    }
+    closedir(dir);
+
+    // nfs、tmpfs等文件系统不支持O_DIRECT，此时全部使用buffer io
+    std::string probe = TempPath("probe");
+    int fd = open(probe.c_str(), O_CREAT | O_WRONLY | O_DIRECT, 0644);
+    directIO_ = fd >= 0;
+    if (fd >= 0) {
+        close(fd);
+    }
+    unlink(probe.c_str());
+    LOG(INFO) << "Init local snapshot data store, path = " << rootPath_
+              << ", direct io = " << directIO_;
+    return 0;
+}
+
+std::string LocalSnapshotDataStore::ObjectPath(const std::string &key) const {
+    if (!key.empty() && key[0] == '/') {
+        return rootPath_ + key;
+    }
+    return rootPath_ + "/" + key;
+}
+
+std::string LocalSnapshotDataStore::TempPath(const std::string &key) {
+    std::string name = key;
+    std::replace(name.begin(), name.end(), '/', '_');
+    return tmpPath_ + "/" + std::to_string(uploadSeq_.fetch_add(1)) +
+           "_" + name;
+}
+
+int LocalSnapshotDataStore::PutObject(const std::string &key,
+                                      const std::string &data) {
+    std::string tmp = TempPath(key);
+    int fd = open(tmp.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to create " << tmp
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    int ret = PwriteAll(fd, data.data(), data.size(), 0);
+    if (ret == 0 && fdatasync(fd) < 0) {
+        LOG(ERROR) << "Failed to sync " << tmp
+                   << ", error: " << strerror(errno);
+        ret = -1;
+    }
+    close(fd);
+    if (ret == 0) {
+        ret = CommitFile(tmp, ObjectPath(key));
+    }
+    if (ret < 0) {
+        unlink(tmp.c_str());
+    }
+    return ret;
+}
+
+int LocalSnapshotDataStore::GetObject(const std::string &key,
+                                      std::string *data) {
+    std::string path = ObjectPath(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open " << path
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    struct stat st;
+    int ret = fstat(fd, &st);
+    if (ret == 0) {
+        data->resize(st.st_size);
+        if (PreadAll(fd, &(*data)[0], st.st_size, 0) != st.st_size) {
+            ret = -1;
+        }
+    }
+    close(fd);
+    return ret < 0 ? -1 : 0;
+}
+
+int LocalSnapshotDataStore::DeleteObject(const std::string &key) {
+    std::string path = ObjectPath(key);
+    if (unlink(path.c_str()) < 0 && errno != ENOENT) {
+        LOG(ERROR) << "Failed to delete " << path
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    return 0;
+}
+
+bool LocalSnapshotDataStore::ObjectExist(const std::string &key) {
+    struct stat st;
+    return stat(ObjectPath(key).c_str(), &st) == 0;
+}
+
+int LocalSnapshotDataStore::PutChunkIndexData(const ChunkIndexDataName &name,
+        const ChunkIndexData &indexData) {
+    std::string data;
+    if (!indexData.Serialize(&data)) {
+        LOG(ERROR) << "Failed to serialize ChunkIndexData";
+        return -1;
+    }
+    return PutObject(name.ToIndexDataChunkKey(), data);
+}
+
+int LocalSnapshotDataStore::GetChunkIndexData(const ChunkIndexDataName &name,
+        ChunkIndexData *indexData) {
+    std::string data;
+    if (GetObject(name.ToIndexDataChunkKey(), &data) < 0 ||
+        !indexData->Unserialize(data)) {
+        return -1;
+    }
+    return 0;
+}
+
+int LocalSnapshotDataStore::DeleteChunkIndexData(
+    const ChunkIndexDataName &name) {
+    return DeleteObject(name.ToIndexDataChunkKey());
+}
+
+bool LocalSnapshotDataStore::ChunkIndexDataExist(
+    const ChunkIndexDataName &name) {
+    return ObjectExist(name.ToIndexDataChunkKey());
+}
+
+int LocalSnapshotDataStore::GetChunkData(const ChunkDataName &name,
+                                         ChunkData *data) {
+    std::string key = name.ToDataChunkKey();
+    if (GetObject(key, &data->data_) < 0 ||
+        !ChunkCodec::DecodeChunk(&data->data_)) {
+        LOG(ERROR) << "Failed to get chunk data, key = " << key;
+        return -1;
+    }
+    return 0;
+}
+
+int LocalSnapshotDataStore::DeleteChunkData(const ChunkDataName &name) {
+    // 先删除页摘要，避免摘要残留而数据已删除时被选为增量转储的基准
+    if (DeleteObject(name.ToPageDigestKey()) < 0) {
+        return -1;
+    }
+    return DeleteObject(name.ToDataChunkKey());
+}
+
+bool LocalSnapshotDataStore::ChunkDataExist(const ChunkDataName &name) {
+    return ObjectExist(name.ToDataChunkKey());
+}
+
+LocalSnapshotDataStore::TransferFilePtr
+LocalSnapshotDataStore::GetTransferFile(const std::string &uploadId) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto iter = transferFiles_.find(uploadId);
+    return iter == transferFiles_.end() ? nullptr : iter->second;
+}
+
+LocalSnapshotDataStore::TransferFilePtr
+LocalSnapshotDataStore::RemoveTransferFile(const std::string &uploadId) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto iter = transferFiles_.find(uploadId);
+    if (iter == transferFiles_.end()) {
+        return nullptr;
+    }
+    TransferFilePtr file = iter->second;
+    transferFiles_.erase(iter);
+    return file;
+}
+
+void LocalSnapshotDataStore::CloseTransferFile(const TransferFilePtr &file,
+                                               bool unlinkFile) {
+    if (file->directFd >= 0) {
+        close(file->directFd);
+        file->directFd = -1;
+    }
+    if (file->fd >= 0) {
+        close(file->fd);
+        file->fd = -1;
+    }
+    if (unlinkFile) {
+        unlink(file->path.c_str());
+    }
+}
+
+int LocalSnapshotDataStore::DataChunkTranferInit(const ChunkDataName &name,
+                                    std::shared_ptr<TransferTask> task) {
+    std::string key = name.ToDataChunkKey();
+    auto file = std::make_shared<TransferFile>();
+    file->path = TempPath(key);
+    file->fd = open(file->path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (file->fd < 0) {
+        LOG(ERROR) << "Failed to create " << file->path
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    if (directIO_) {
+        file->directFd = open(file->path.c_str(), O_WRONLY | O_DIRECT);
+        LOG_IF(WARNING, file->directFd < 0)
+            << "Failed to open " << file->path << " with O_DIRECT"
+            << ", error: " << strerror(errno);
+    }
+    task->encoded_ = encodeEnable_;
+    // 未编码时文件大小即chunk大小，预分配以获得连续的空间；
+    // 编码时全零分片不写入，保持空洞
+    if (!task->encoded_ && task->dataSize_ > 0 &&
+        fallocate(file->fd, 0, 0, task->dataSize_) < 0) {
+        LOG_EVERY_N(WARNING, 1000) << "Failed to fallocate " << file->path
+                                   << ", error: " << strerror(errno);
+    }
+
+    task->uploadId_ = std::to_string(uploadSeq_.fetch_add(1));
+    std::lock_guard<std::mutex> lock(mtx_);
+    transferFiles_.emplace(task->uploadId_, file);
+    return 0;
+}
+
+int LocalSnapshotDataStore::WriteAt(const TransferFilePtr &file,
+                                    uint64_t offset,
+                                    const char *buf,
+                                    uint64_t len) {
+    if (file->directFd < 0 || offset % kDirectIOAlign != 0 ||
+        len % kDirectIOAlign != 0) {
+        return PwriteAll(file->fd, buf, len, offset);
+    }
+    if (reinterpret_cast<uintptr_t>(buf) % kDirectIOAlign == 0) {
+        return PwriteAll(file->directFd, buf, len, offset);
+    }
+    void *aligned = nullptr;
+    if (posix_memalign(&aligned, kDirectIOAlign, len) != 0) {
+        return PwriteAll(file->fd, buf, len, offset);
+    }
+    memcpy(aligned, buf, len);
+    int ret = PwriteAll(file->directFd, static_cast<char *>(aligned),
+                        len, offset);
+    free(aligned);
+    return ret;
+}
+
+int LocalSnapshotDataStore::DataChunkTranferAddPart(const ChunkDataName &name,
+                                        std::shared_ptr<TransferTask> task,
+                                        int partNum,
+                                        int partSize,
+                                        const char *buf) {
+    TransferFilePtr file = GetTransferFile(task->uploadId_);
+    if (file == nullptr) {
+        LOG(ERROR) << "Transfer task not found, key = "
+                   << name.ToDataChunkKey()
+                   << ", uploadId = " << task->uploadId_;
+        return -1;
+    }
+    // 分片大小相同，按分片的原始偏移写入；编码时在转储完成后再紧凑排列
+    uint64_t offset = static_cast<uint64_t>(partNum) * partSize;
+    if (!task->encoded_) {
+        return WriteAt(file, offset, buf, partSize);
+    }
+
+    if (EncodedChunkHeader::GetHeaderSize(partNum + 1) >
+        kMaxEncodedChunkHeaderSize) {
+        LOG(ERROR) << "Too many splits to encode, key = "
+                   << name.ToDataChunkKey()
+                   << ", partNum = " << partNum;
+        return -1;
+    }
+    std::string compressed;
+    EncodedSplit split = ChunkCodec::EncodeSplit(buf, partSize, &compressed);
+    int ret = 0;
+    if (split.type == SplitEncodeType::kSnappy) {
+        ret = PwriteAll(file->fd, compressed.data(), split.storedLen, offset);
+    } else if (split.type == SplitEncodeType::kRaw) {
+        ret = WriteAt(file, offset, buf, partSize);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+    task->AddSplitInfo(partNum, split);
+    return 0;
+}
+
+int LocalSnapshotDataStore::CompactEncodedFile(const std::string &key,
+    const TransferFilePtr &file,
+    const std::map<int, EncodedSplit> &splits,
+    std::string *outPath) {
+    EncodedChunkHeader header;
+    int index = 0;
+    for (auto &v : splits) {
+        if (v.first != index++) {
+            LOG(ERROR) << "Split missing, key = " << key
+                       << ", index = " << index - 1;
+            return -1;
+        }
+        header.AddSplit(v.second);
+    }
+    std::string headerData;
+    header.Encode(&headerData);
+
+    *outPath = TempPath(key);
+    int fd = open(outPath->c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to create " << *outPath
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    int ret = PwriteAll(fd, headerData.data(), headerData.size(), 0);
+    uint64_t rawOff = 0;
+    uint64_t storedOff = headerData.size();
+    for (auto &v : splits) {
+        if (ret < 0) {
+            break;
+        }
+        const EncodedSplit &split = v.second;
+        if (split.storedLen > 0) {
+            ret = CopyRange(file->fd, rawOff, fd, storedOff,
+                            split.storedLen);
+        }
+        rawOff += split.rawLen;
+        storedOff += split.storedLen;
+    }
+    if (ret == 0 && fdatasync(fd) < 0) {
+        LOG(ERROR) << "Failed to sync " << *outPath
+                   << ", error: " << strerror(errno);
+        ret = -1;
+    }
+    close(fd);
+    if (ret < 0) {
+        unlink(outPath->c_str());
+    }
+    return ret;
+}
+
+int LocalSnapshotDataStore::DataChunkTranferComplete(const ChunkDataName &name,
+                                        std::shared_ptr<TransferTask> task) {
+    std::string key = name.ToDataChunkKey();
+    TransferFilePtr file = RemoveTransferFile(task->uploadId_);
+    if (file == nullptr) {
+        LOG(ERROR) << "Transfer task not found, key = " << key
+                   << ", uploadId = " << task->uploadId_;
+        return -1;
+    }
+
+    int ret = 0;
+    if (task->encoded_) {
+        std::string encodedPath;
+        ret = CompactEncodedFile(key, file, task->GetSplitInfo(),
+                                 &encodedPath);
+        if (ret == 0) {
+            ret = CommitFile(encodedPath, ObjectPath(key));
+            if (ret < 0) {
+                unlink(encodedPath.c_str());
+            }
+        }
+        CloseTransferFile(file, true);
+        return ret;
+    }
+
+    if (fdatasync(file->fd) < 0) {
+        LOG(ERROR) << "Failed to sync " << file->path
+                   << ", error: " << strerror(errno);
+        ret = -1;
+    }
+    CloseTransferFile(file, false);
+    if (ret == 0) {
+        ret = CommitFile(file->path, ObjectPath(key));
+    }
+    if (ret < 0) {
+        unlink(file->path.c_str());
+    }
+    return ret;
+}
+
+int LocalSnapshotDataStore::DataChunkTranferAbort(const ChunkDataName &name,
+                                    std::shared_ptr<TransferTask> task) {
+    TransferFilePtr file = RemoveTransferFile(task->uploadId_);
+    if (file != nullptr) {
+        CloseTransferFile(file, true);
+    }
+    return 0;
+}
+
+int LocalSnapshotDataStore::PutChunkPageDigest(const ChunkDataName &name,
+                                               const ChunkPageDigest &digest) {
+    std::string data;
+    if (!digest.Serialize(&data)) {
+        LOG(ERROR) << "Failed to serialize ChunkPageDigest";
+        return -1;
+    }
+    return PutObject(name.ToPageDigestKey(), data);
+}
+
+int LocalSnapshotDataStore::GetChunkPageDigest(const ChunkDataName &name,
+                                               ChunkPageDigest *digest) {
+    std::string key = name.ToPageDigestKey();
+    std::string data;
+    if (GetObject(key, &data) < 0) {
+        return -1;
+    }
+    if (!digest->Unserialize(data)) {
+        LOG(ERROR) << "Failed to unserialize ChunkPageDigest, key = " << key;
+        return -1;
+    }
+    return 0;
+}
+
+int LocalSnapshotDataStore::PutChunkDeltaData(const ChunkDataName &name,
+                                              const ChunkDeltaData &delta) {
+    std::string data;
+    if (!delta.Serialize(&data)) {
+        LOG(ERROR) << "Failed to serialize ChunkDeltaData";
+        return -1;
+    }
+    return PutObject(name.ToDeltaChunkKey(), data);
+}
+
+bool LocalSnapshotDataStore::ChunkDeltaDataExist(const ChunkDataName &name) {
+    return ObjectExist(name.ToDeltaChunkKey());
+}
+
+int LocalSnapshotDataStore::DeleteChunkDeltaData(const ChunkDataName &name) {
+    return DeleteObject(name.ToDeltaChunkKey());
+}
+
+int LocalSnapshotDataStore::MergeByCopy(const std::string &baseKey,
+                                        const ChunkDeltaData &delta,
+                                        const std::string &tmpPath) {
+    std::string basePath = ObjectPath(baseKey);
+    int baseFd = open(basePath.c_str(), O_RDONLY);
+    if (baseFd < 0) {
+        LOG(ERROR) << "Failed to open " << basePath
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    struct stat st;
+    std::string prefix(kMaxEncodedChunkHeaderSize, '\0');
+    int64_t prefixLen = 0;
+    if (fstat(baseFd, &st) < 0 ||
+        (prefixLen = PreadAll(baseFd, &prefix[0], prefix.size(), 0)) < 0) {
+        close(baseFd);
+        return -1;
+    }
+    EncodedChunkHeader header;
+    if (header.Decode(prefix.data(), prefixLen)) {
+        close(baseFd);
+        return 1;
+    }
+
+    int fd = open(tmpPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to create " << tmpPath
+                   << ", error: " << strerror(errno);
+        close(baseFd);
+        return -1;
+    }
+    // reflink共享基准chunk的数据块，之后写入的页才分配新的空间
+    int ret = 0;
+    if (ioctl(fd, FICLONE, baseFd) < 0) {
+        ret = CopyRange(baseFd, 0, fd, 0, st.st_size);
+    }
+    close(baseFd);
+
+    uint64_t pageSize = delta.GetPageSize();
+    for (const auto &page : delta.GetPages()) {
+        if (ret < 0) {
+            break;
+        }
+        uint64_t offset = static_cast<uint64_t>(page.first) * pageSize;
+        if (offset + pageSize > static_cast<uint64_t>(st.st_size)) {
+            LOG(ERROR) << "ChunkDeltaData is out of the base chunk"
+                       << ", pageIndex = " << page.first
+                       << ", pageSize = " << pageSize
+                       << ", chunkSize = " << st.st_size;
+            ret = -1;
+            break;
+        }
+        ret = PwriteAll(fd, page.second.data(), pageSize, offset);
+    }
+    if (ret == 0 && fdatasync(fd) < 0) {
+        LOG(ERROR) << "Failed to sync " << tmpPath
+                   << ", error: " << strerror(errno);
+        ret = -1;
+    }
+    close(fd);
+    return ret;
+}
+
+int LocalSnapshotDataStore::MergeChunkDeltaData(const ChunkDataName &name,
+                                                const ChunkDataName &base) {
+    std::string baseKey = base.ToDataChunkKey();
+    std::string deltaKey = name.ToDeltaChunkKey();
+    std::string key = name.ToDataChunkKey();
+    std::string deltaStr;
+    ChunkDeltaData delta;
+    if (GetObject(deltaKey, &deltaStr) < 0 || !delta.Unserialize(deltaStr)) {
+        LOG(ERROR) << "Failed to get delta chunk, key = " << deltaKey;
+        return -1;
+    }
+
+    if (!encodeEnable_) {
+        std::string tmp = TempPath(key);
+        int ret = MergeByCopy(baseKey, delta, tmp);
+        if (ret == 0) {
+            ret = CommitFile(tmp, ObjectPath(key));
+        }
+        if (ret != 0) {
+            unlink(tmp.c_str());
+        }
+        if (ret <= 0) {
+            LOG_IF(ERROR, ret < 0) << "Failed to merge delta chunk, key = "
+                                   << deltaKey << ", base = " << baseKey;
+            return ret;
+        }
+    }
+
+    // 基准chunk已编码或目标需要编码，读出全量数据合并
+    std::string data;
+    if (GetObject(baseKey, &data) < 0 || !ChunkCodec::DecodeChunk(&data)) {
+        LOG(ERROR) << "Failed to get base chunk, key = " << baseKey;
+        return -1;
+    }
+    if (!delta.MergeTo(&data)) {
+        LOG(ERROR) << "Failed to merge delta chunk, key = " << deltaKey
+                   << ", base = " << baseKey;
+        return -1;
+    }
+    if (encodeEnable_) {
+        std::string encoded;
+        if (ChunkCodec::EncodeChunk(data, encodeSplitSize_, &encoded)) {
+            data.swap(encoded);
+        }
+    }
+    return PutObject(key, data);
+}
+
+std::string LocalSnapshotDataStore::GetChunkDataLocation(
+    const std::string &key) {
+    return LocationOperator::GenerateLocalLocation(key);
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
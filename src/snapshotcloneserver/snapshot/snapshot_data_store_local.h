@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_DATA_STORE_LOCAL_H_
+#define SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_DATA_STORE_LOCAL_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+/**
+ * 以本地目录(本地盘或nfs等挂载点)作为快照数据存储后端，
+ * 对象以文件形式存放在根目录下，文件的相对路径即对象名。
+ * 数据chunk转储时写入预分配的临时文件，对齐的分片使用direct io写入，
+ * 转储完成后fsync并rename为正式文件，保证文件存在即数据完整。
+ * 编码存储时文件格式与s3对象相同(头部 + 非全零分片)，
+ * chunkserver可按相同的方式读取。
+ */
+class LocalSnapshotDataStore : public SnapshotDataStore {
+ public:
+    LocalSnapshotDataStore()
+        : encodeEnable_(false),
+          encodeSplitSize_(0),
+          directIO_(false),
+          uploadSeq_(0) {}
+    ~LocalSnapshotDataStore();
+
+    /**
+     * 初始化，创建根目录及临时文件目录，并清理上次残留的临时文件
+     * @param path 根目录
+     * @return 0 初始化成功/ -1 初始化失败
+     */
+    int Init(const std::string &path) override;
+    int PutChunkIndexData(const ChunkIndexDataName &name,
+                          const ChunkIndexData &meta) override;
+    int GetChunkIndexData(const ChunkIndexDataName &name,
+                          ChunkIndexData *meta) override;
+    int DeleteChunkIndexData(const ChunkIndexDataName &name) override;
+    bool ChunkIndexDataExist(const ChunkIndexDataName &name) override;
+    int GetChunkData(const ChunkDataName &name,
+                     ChunkData *data) override;
+    int DeleteChunkData(const ChunkDataName &name) override;
+    bool ChunkDataExist(const ChunkDataName &name) override;
+    int DataChunkTranferInit(const ChunkDataName &name,
+                             std::shared_ptr<TransferTask> task) override;
+    int DataChunkTranferAddPart(const ChunkDataName &name,
+                                std::shared_ptr<TransferTask> task,
+                                int partNum,
+                                int partSize,
+                                const char* buf) override;
+    int DataChunkTranferComplete(const ChunkDataName &name,
+                                 std::shared_ptr<TransferTask> task) override;
+    int DataChunkTranferAbort(const ChunkDataName &name,
+                              std::shared_ptr<TransferTask> task) override;
+    int PutChunkPageDigest(const ChunkDataName &name,
+                           const ChunkPageDigest &digest) override;
+    int GetChunkPageDigest(const ChunkDataName &name,
+                           ChunkPageDigest *digest) override;
+    int PutChunkDeltaData(const ChunkDataName &name,
+                          const ChunkDeltaData &delta) override;
+    bool ChunkDeltaDataExist(const ChunkDataName &name) override;
+    int DeleteChunkDeltaData(const ChunkDataName &name) override;
+    /**
+     * 基准chunk未编码且目标不需要编码时，通过reflink共享基准chunk的数据块，
+     * 只写入变化的页；不支持reflink时使用copy_file_range在内核中拷贝
+     */
+    int MergeChunkDeltaData(const ChunkDataName &name,
+                            const ChunkDataName &base) override;
+    std::string GetChunkDataLocation(const std::string &key) override;
+
+    /**
+     * 设置chunk数据的编码存储，开启后全零分片不存储，其余分片压缩存储
+     * @param enable 是否开启
+     * @param splitSize 整体写入的chunk数据对象(增量合并产生)的分片大小
+     */
+    void SetEncodeOption(bool enable, uint32_t splitSize) {
+        encodeEnable_ = enable;
+        encodeSplitSize_ = splitSize;
+    }
+
+ private:
+    // 转储中的数据chunk临时文件
+    struct TransferFile {
+        TransferFile() : fd(-1), directFd(-1) {}
+        std::string path;
+        int fd;
+        // 以O_DIRECT打开的同一文件，文件系统不支持时为-1
+        int directFd;
+    };
+    using TransferFilePtr = std::shared_ptr<TransferFile>;
+
+    std::string ObjectPath(const std::string &key) const;
+    std::string TempPath(const std::string &key);
+
+    int PutObject(const std::string &key, const std::string &data);
+    int GetObject(const std::string &key, std::string *data);
+    int DeleteObject(const std::string &key);
+    bool ObjectExist(const std::string &key);
+
+    TransferFilePtr GetTransferFile(const std::string &uploadId);
+    TransferFilePtr RemoveTransferFile(const std::string &uploadId);
+    void CloseTransferFile(const TransferFilePtr &file, bool unlinkFile);
+
+    /**
+     * 写入数据，偏移和长度都对齐时使用direct io写入
+     */
+    int WriteAt(const TransferFilePtr &file, uint64_t offset,
+                const char *buf, uint64_t len);
+
+    /**
+     * 编码存储时，按分片信息将临时文件中的非全零分片依次拷贝到头部之后
+     */
+    int CompactEncodedFile(const std::string &key,
+                           const TransferFilePtr &file,
+                           const std::map<int, EncodedSplit> &splits,
+                           std::string *outPath);
+
+    /**
+     * 通过reflink或copy_file_range将基准chunk拷贝到临时文件后写入变化的页
+     * @return 0 成功/ -1 失败/ 1 基准chunk已编码，无法直接拷贝
+     */
+    int MergeByCopy(const std::string &baseKey,
+                    const ChunkDeltaData &delta,
+                    const std::string &tmpPath);
+
+ private:
+    std::string rootPath_;
+    std::string tmpPath_;
+    bool encodeEnable_;
+    uint32_t encodeSplitSize_;
+    // 根目录所在文件系统是否支持O_DIRECT
+    bool directIO_;
+    std::atomic<uint64_t> uploadSeq_;
+
+    std::mutex mtx_;
+    // uploadId => 转储中的临时文件
+    std::map<std::string, TransferFilePtr> transferFiles_;
+};
+
+}   // namespace snapshotcloneserver
+}   // namespace curve
+
+#endif  // SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_DATA_STORE_LOCAL_H_
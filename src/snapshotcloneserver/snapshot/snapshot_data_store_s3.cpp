@@ -27,6 +27,12 @@
 #include <aws/core/utils/memory/stl/AWSString.h>  //NOLINT
 #include <aws/core/utils/memory/stl/AWSMap.h>  //NOLINT
 #include <aws/core/utils/StringUtils.h>   //NOLINT
+
+using ::curve::common::ChunkCodec;
+using ::curve::common::EncodedChunkHeader;
+using ::curve::common::SplitEncodeType;
+using ::curve::common::kMaxEncodedChunkHeaderSize;
+
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -84,16 +90,19 @@ int S3SnapshotDataStore::PutChunkData(const ChunkDataName &name,
     std::string tmpdata = "test";
     s3Adapter4Data_->PutObject(aws_key, tmpdata);
 }
-
+*/
 int S3SnapshotDataStore::GetChunkData(const ChunkDataName &name,
         ChunkData *data) {
     std::string key = name.ToDataChunkKey();
-    std::string tmpdata;
     const Aws::String aws_key(key.c_str(), key.size());
-    s3Adapter4Data_->GetObject(aws_key, &tmpdata);
+    if (s3Adapter4Data_->GetObject(aws_key, &data->data_) < 0 ||
+        !ChunkCodec::DecodeChunk(&data->data_)) {
+        LOG(ERROR) << "Failed to get chunk data, key = " << key;
+        return -1;
+    }
     return 0;
 }
-*/
+
 bool S3SnapshotDataStore::ChunkDataExist(const ChunkDataName &name) {
     std::string key = name.ToDataChunkKey();
     const Aws::String aws_key(key.c_str(), key.size());
@@ -110,6 +119,13 @@ int S3SnapshotDataStore::DeleteChunkIndexData(const ChunkIndexDataName &name) {
 }
 
 int S3SnapshotDataStore::DeleteChunkData(const ChunkDataName &name) {
+    // 先删除页摘要，避免摘要残留而数据已删除时被选为增量转储的基准
+    std::string digestKey = name.ToPageDigestKey();
+    const Aws::String aws_digestKey(digestKey.c_str(), digestKey.size());
+    if (s3Adapter4Meta_->ObjectExist(aws_digestKey) &&
+        s3Adapter4Meta_->DeleteObject(aws_digestKey) < 0) {
+        return -1;
+    }
     std::string key = name.ToDataChunkKey();
     const Aws::String aws_key(key.c_str(), key.size());
     return s3Adapter4Meta_->DeleteObject(aws_key);
@@ -153,6 +169,7 @@ int S3SnapshotDataStore::DataChunkTranferInit(const ChunkDataName &name,
     }
     std::string str(aws_uploadId.c_str(), aws_uploadId.size());
     task->uploadId_ = str;
+    task->encoded_ = encodeEnable_;
     return 0;
 }
 
@@ -163,10 +180,44 @@ int S3SnapshotDataStore::DataChunkTranferAddPart(const ChunkDataName &name,
                                         const char *buf) {
     std::string key = name.ToDataChunkKey();
     const Aws::String aws_key(key.c_str(), key.size());
+    if (!task->encoded_) {
+        return UploadOnePart(aws_key, task, partNum + 1, partSize, buf);
+    }
+
+    // 编码存储时，第1个part为头部，在转储完成时上传，分片从第2个part开始
+    if (EncodedChunkHeader::GetHeaderSize(partNum + 1) >
+        kMaxEncodedChunkHeaderSize) {
+        LOG(ERROR) << "Too many splits to encode, key = " << key
+                   << ", partNum = " << partNum;
+        return -1;
+    }
+    std::string compressed;
+    EncodedSplit split = ChunkCodec::EncodeSplit(buf, partSize, &compressed);
+    if (split.type == SplitEncodeType::kSnappy) {
+        int ret = UploadOnePart(aws_key, task, partNum + 2,
+                                split.storedLen, compressed.data());
+        if (ret < 0) {
+            return ret;
+        }
+    } else if (split.type == SplitEncodeType::kRaw) {
+        int ret = UploadOnePart(aws_key, task, partNum + 2, partSize, buf);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    task->AddSplitInfo(partNum, split);
+    return 0;
+}
+
+int S3SnapshotDataStore::UploadOnePart(const Aws::String &key,
+                                       std::shared_ptr<TransferTask> task,
+                                       int partNum,
+                                       int partSize,
+                                       const char *buf) {
     const Aws::String uploadId(task->uploadId_.c_str(), task->uploadId_.size());
     Aws::S3::Model::CompletedPart cp =
         s3Adapter4Data_->UploadOnePart(
-            aws_key, uploadId, partNum + 1, partSize, buf);
+            key, uploadId, partNum, partSize, buf);
     std::string etag(cp.GetETag().c_str(), cp.GetETag().size());
     int tmp_partnum = cp.GetPartNumber();
     if (etag == "errorTag" && tmp_partnum == -1) {
@@ -182,6 +233,26 @@ int S3SnapshotDataStore::DataChunkTranferComplete(const ChunkDataName &name,
     std::string key = name.ToDataChunkKey();
     const Aws::String aws_key(key.c_str(), key.size());
     const Aws::String uploadId(task->uploadId_.c_str(), task->uploadId_.size());
+    if (task->encoded_) {
+        // 所有分片转储完成后才能确定头部，全零分片不上传数据
+        EncodedChunkHeader header;
+        int index = 0;
+        for (auto &v : task->GetSplitInfo()) {
+            if (v.first != index++) {
+                LOG(ERROR) << "Split missing, key = " << key
+                           << ", index = " << index - 1;
+                return -1;
+            }
+            header.AddSplit(v.second);
+        }
+        std::string headerData;
+        header.Encode(&headerData);
+        int ret = UploadOnePart(aws_key, task, 1,
+                                headerData.size(), headerData.data());
+        if (ret < 0) {
+            return ret;
+        }
+    }
     Aws::Vector<Aws::S3::Model::CompletedPart> cp_v;
     for (auto &v : task->GetPartInfo()) {
         Aws::String str(v.second.c_str(), v.second.size());
@@ -199,6 +270,95 @@ int S3SnapshotDataStore::DataChunkTranferAbort(const ChunkDataName &name,
     const Aws::String uploadId(task->uploadId_.c_str(), task->uploadId_.size());
     return s3Adapter4Data_->AbortMultiUpload(aws_key, uploadId);
 }
+
+int S3SnapshotDataStore::PutChunkPageDigest(const ChunkDataName &name,
+                                            const ChunkPageDigest &digest) {
+    std::string key = name.ToPageDigestKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    std::string data;
+    if (!digest.Serialize(&data)) {
+        LOG(ERROR) << "Failed to serialize ChunkPageDigest";
+        return -1;
+    }
+    return s3Adapter4Data_->PutObject(aws_key, data);
+}
+
+int S3SnapshotDataStore::GetChunkPageDigest(const ChunkDataName &name,
+                                            ChunkPageDigest *digest) {
+    std::string key = name.ToPageDigestKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    std::string data;
+    if (s3Adapter4Data_->GetObject(aws_key, &data) < 0) {
+        return -1;
+    }
+    if (!digest->Unserialize(data)) {
+        LOG(ERROR) << "Failed to unserialize ChunkPageDigest, key = " << key;
+        return -1;
+    }
+    return 0;
+}
+
+int S3SnapshotDataStore::PutChunkDeltaData(const ChunkDataName &name,
+                                           const ChunkDeltaData &delta) {
+    std::string key = name.ToDeltaChunkKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    std::string data;
+    if (!delta.Serialize(&data)) {
+        LOG(ERROR) << "Failed to serialize ChunkDeltaData";
+        return -1;
+    }
+    return s3Adapter4Data_->PutObject(aws_key, data);
+}
+
+bool S3SnapshotDataStore::ChunkDeltaDataExist(const ChunkDataName &name) {
+    std::string key = name.ToDeltaChunkKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    return s3Adapter4Meta_->ObjectExist(aws_key);
+}
+
+int S3SnapshotDataStore::DeleteChunkDeltaData(const ChunkDataName &name) {
+    std::string key = name.ToDeltaChunkKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    return s3Adapter4Meta_->DeleteObject(aws_key);
+}
+
+int S3SnapshotDataStore::MergeChunkDeltaData(const ChunkDataName &name,
+                                             const ChunkDataName &base) {
+    std::string baseKey = base.ToDataChunkKey();
+    const Aws::String aws_baseKey(baseKey.c_str(), baseKey.size());
+    std::string data;
+    if (s3Adapter4Data_->GetObject(aws_baseKey, &data) < 0 ||
+        !ChunkCodec::DecodeChunk(&data)) {
+        LOG(ERROR) << "Failed to get base chunk, key = " << baseKey;
+        return -1;
+    }
+
+    std::string deltaKey = name.ToDeltaChunkKey();
+    const Aws::String aws_deltaKey(deltaKey.c_str(), deltaKey.size());
+    std::string deltaStr;
+    ChunkDeltaData delta;
+    if (s3Adapter4Data_->GetObject(aws_deltaKey, &deltaStr) < 0 ||
+        !delta.Unserialize(deltaStr)) {
+        LOG(ERROR) << "Failed to get delta chunk, key = " << deltaKey;
+        return -1;
+    }
+    if (!delta.MergeTo(&data)) {
+        LOG(ERROR) << "Failed to merge delta chunk, key = " << deltaKey
+                   << ", base = " << baseKey;
+        return -1;
+    }
+
+    if (encodeEnable_) {
+        std::string encoded;
+        if (ChunkCodec::EncodeChunk(data, encodeSplitSize_, &encoded)) {
+            data.swap(encoded);
+        }
+    }
+
+    std::string key = name.ToDataChunkKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    return s3Adapter4Data_->PutObject(aws_key, data);
+}
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
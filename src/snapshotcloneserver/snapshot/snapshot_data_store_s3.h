@@ -37,7 +37,9 @@ namespace snapshotcloneserver {
 
 class S3SnapshotDataStore : public SnapshotDataStore {
  public:
-     S3SnapshotDataStore() {
+     S3SnapshotDataStore()
+        : encodeEnable_(false),
+          encodeSplitSize_(0) {
         s3Adapter4Meta_ = std::make_shared<S3Adapter>();
         s3Adapter4Data_ = std::make_shared<S3Adapter>();
     }
@@ -51,8 +53,8 @@ class S3SnapshotDataStore : public SnapshotDataStore {
     bool ChunkIndexDataExist(const ChunkIndexDataName &name) override;
     // int PutChunkData(const ChunkDataName &name,
     //                const ChunkData &data) override;
-    // int GetChunkData(const ChunkDataName &name,
-    //                ChunkData *data) override;
+    int GetChunkData(const ChunkDataName &name,
+                     ChunkData *data) override;
     int DeleteChunkData(const ChunkDataName &name) override;
     bool ChunkDataExist(const ChunkDataName &name) override;
 /*  nos暂时不支持，后续增加
@@ -70,6 +72,16 @@ class S3SnapshotDataStore : public SnapshotDataStore {
                                 std::shared_ptr<TransferTask> task) override;
      int DataChunkTranferAbort(const ChunkDataName &name,
                                std::shared_ptr<TransferTask> task) override;
+    int PutChunkPageDigest(const ChunkDataName &name,
+                           const ChunkPageDigest &digest) override;
+    int GetChunkPageDigest(const ChunkDataName &name,
+                           ChunkPageDigest *digest) override;
+    int PutChunkDeltaData(const ChunkDataName &name,
+                          const ChunkDeltaData &delta) override;
+    bool ChunkDeltaDataExist(const ChunkDataName &name) override;
+    int DeleteChunkDeltaData(const ChunkDataName &name) override;
+    int MergeChunkDeltaData(const ChunkDataName &name,
+                            const ChunkDataName &base) override;
 
      void SetMetaAdapter(std::shared_ptr<S3Adapter> adapter) {
          s3Adapter4Meta_ = adapter;
@@ -83,10 +95,28 @@ class S3SnapshotDataStore : public SnapshotDataStore {
      std::shared_ptr<S3Adapter> GetDataAdapter(void) {
          return s3Adapter4Data_;
      }
+     /**
+      * 设置chunk数据的编码存储，开启后全零分片不存储，其余分片压缩存储
+      * @param enable 是否开启
+      * @param splitSize 整体写入的chunk数据对象(增量合并产生)的分片大小
+      */
+     void SetEncodeOption(bool enable, uint32_t splitSize) {
+         encodeEnable_ = enable;
+         encodeSplitSize_ = splitSize;
+     }
+
+ private:
+    int UploadOnePart(const Aws::String &key,
+                      std::shared_ptr<TransferTask> task,
+                      int partNum,
+                      int partSize,
+                      const char *buf);
 
  private:
     std::shared_ptr<curve::common::S3Adapter> s3Adapter4Data_;
     std::shared_ptr<curve::common::S3Adapter> s3Adapter4Meta_;
+    bool encodeEnable_;
+    uint32_t encodeSplitSize_;
 };
 
 }   // namespace snapshotcloneserver
@@ -291,6 +291,23 @@ bool SnapshotFilterCondition::IsMatchCondition(const SnapshotInfo &snapInfo) {
     return true;
 }
 
+bool SnapshotFilterCondition::ToListFilter(Status *status,
+    SnapshotListFilter *filter) const {
+    filter->uuid = uuid_;
+    filter->file = file_;
+    filter->user = user_;
+    filter->status = nullptr;
+    if (status_ != nullptr) {
+        int st;
+        if (!common::StringToInt(*status_, &st)) {
+            return false;
+        }
+        *status = static_cast<Status>(st);
+        filter->status = status;
+    }
+    return true;
+}
+
 int SnapshotServiceManager::GetSnapshotListInner(
     std::vector<SnapshotInfo> snapInfos,
     SnapshotFilterCondition filter,
@@ -367,6 +384,29 @@ int SnapshotServiceManager::GetSnapshotListByFilter(
     return GetSnapshotListInner(snapInfos, filter, info);
 }
 
+int SnapshotServiceManager::GetSnapshotListByPage(
+                    const SnapshotFilterCondition &filter,
+                    uint64_t offset,
+                    uint64_t limit,
+                    std::vector<FileSnapshotInfo> *info,
+                    uint64_t *total) {
+    *total = 0;
+    Status status;
+    SnapshotListFilter listFilter;
+    if (!filter.ToListFilter(&status, &listFilter)) {
+        return kErrCodeSuccess;
+    }
+    std::vector<SnapshotInfo> snapInfos;
+    int ret = core_->GetSnapshotListByPage(listFilter, offset, limit,
+        &snapInfos, total);
+    if (ret < 0) {
+        LOG(ERROR) << "GetSnapshotListByPage error, "
+                   << " ret = " << ret;
+        return ret;
+    }
+    return GetSnapshotListInner(snapInfos, filter, info);
+}
+
 int SnapshotServiceManager::RecoverSnapshotTask() {
     std::vector<SnapshotInfo> list;
     int ret = core_->GetSnapshotList(&list);
@@ -124,6 +124,16 @@ class SnapshotFilterCondition {
                     status_(status) {}
     bool IsMatchCondition(const SnapshotInfo &snapInfo);
 
+    /**
+     * @brief 转换为metastore的过滤条件
+     *
+     * @param[out] status 保存状态过滤条件的值
+     * @param[out] filter metastore的过滤条件
+     *
+     * @return false 状态过滤条件非法，没有满足条件的快照
+     */
+    bool ToListFilter(Status *status, SnapshotListFilter *filter) const;
+
     void SetUuid(const std::string *uuid) {
         uuid_ = uuid;
     }
@@ -264,6 +274,23 @@ class SnapshotServiceManager {
     virtual int GetSnapshotListByFilter(const SnapshotFilterCondition &filter,
                     std::vector<FileSnapshotInfo> *info);
 
+    /**
+     * @brief 分页获取快照列表，只获取当前页的快照任务信息
+     *
+     * @param filter 过滤条件
+     * @param offset 跳过的快照数
+     * @param limit 本页最多返回的快照数
+     * @param[out] info 本页的快照信息列表
+     * @param[out] total 满足过滤条件的快照总数
+     *
+     * @return 错误码
+     */
+    virtual int GetSnapshotListByPage(const SnapshotFilterCondition &filter,
+                    uint64_t offset,
+                    uint64_t limit,
+                    std::vector<FileSnapshotInfo> *info,
+                    uint64_t *total);
+
     /**
      * @brief 恢复快照任务接口
      *
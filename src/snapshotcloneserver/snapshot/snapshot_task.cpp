@@ -40,33 +40,52 @@ void ReadChunkSnapshotClosure::Run() {
                      << ", chunkId = " << context_->cidInfo.cid_
                      << ", seqNum = " << context_->seqNum;
     }
+    pipeline_->ReleaseReadSlot(context_->retCode < 0 ? 0 : context_->len);
     tracker_->PushResultContext(context_);
     tracker_->HandleResponse(context_->retCode);
     return;
 }
 
+// 增量数据超过chunk的1/kDeltaFallbackDivisor时转为全量转储，
+// 避免基准chunk被长期引用且合并代价过高
+constexpr uint64_t kDeltaFallbackDivisor = 4;
+
+int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
+    if (taskInfo_->hasDeltaBase_) {
+        bool fallback = false;
+        int ret = TransferSnapshotDataChunkDelta(&fallback);
+        if (!fallback) {
+            return ret;
+        }
+    }
+    return TransferSnapshotDataChunkFull();
+}
+
 /**
- * @brief 转储快照的单个chunk
+ * @brief 全量转储快照的单个chunk
  * @detail
  *  由于单个chunk过大，chunk转储分片进行，分片大小为chunkSplitSize_，
  *  步骤如下：
  *  1. 创建一个转储任务transferTask，并调用DataChunkTranferInit初始化
  *  2. 调用ReadChunkSnapshot从curvefs读取chunk的一个分片
- *  3. 调用DataChunkTranferAddPart转储一个分片
- *  4. 重复2、3直到所有分片转储完成，调用DataChunkTranferComplete结束转储任务
+ *  3. 将分片提交到流水线的上传阶段，由上传线程调用DataChunkTranferAddPart
+ *  转储(含编码)并计算页摘要，读取不等待上传完成
+ *  4. 重复2、3直到所有分片读取完成，等待已提交的上传全部结束后，
+ *  调用DataChunkTranferComplete结束转储任务
  *  5. 中间如有读取或转储发生错误，则调用DataChunkTranferAbort放弃转储，
  *  并返回错误码
+ *  6. 开启增量转储时，转储完成后存储chunk的页摘要，供后续快照增量转储使用
  *
  * @return 错误码
  */
-int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
+int TransferSnapshotDataChunkTask::TransferSnapshotDataChunkFull() {
     ChunkDataName name = taskInfo_->name_;
     uint64_t chunkSize = taskInfo_->chunkSize_;
     ChunkIDInfo cidInfo = taskInfo_->cidInfo_;
-    uint64_t chunkSplitSize = taskInfo_->chunkSplitSize_;
 
     std::shared_ptr<TransferTask> transferTask =
         std::make_shared<TransferTask>();
+    transferTask->dataSize_ = chunkSize;
     int ret = dataStore_->DataChunkTranferInit(name,
             transferTask);
     if (ret < 0) {
@@ -79,6 +98,171 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
         return ret;
     }
 
+    std::unique_ptr<ChunkPageDigest> digest;
+    if (taskInfo_->deltaPageSize_ > 0) {
+        digest.reset(new ChunkPageDigest(chunkSize,
+                                         taskInfo_->deltaPageSize_));
+    }
+    auto uploadTracker = std::make_shared<TaskTracker>();
+    ChunkPageDigest *digestPtr = digest.get();
+    auto dataStore = dataStore_;
+    auto pipeline = pipeline_;
+    ret = ReadChunkSnapshot(
+        [&](const ReadChunkSnapshotContextPtr &context) {
+            // 已有分片上传失败，不再提交
+            int uploadRet = uploadTracker->GetResult();
+            if (uploadRet < 0) {
+                return uploadRet;
+            }
+            uploadTracker->AddOneTrace();
+            // 上传任务持有context，分片缓冲区在上传结束后才归还
+            pipeline_->PushUpload(
+                [name, transferTask, context, digestPtr,
+                 dataStore, pipeline, uploadTracker]() {
+                int addRet = dataStore->DataChunkTranferAddPart(
+                    name,
+                    transferTask,
+                    context->partIndex,
+                    context->len,
+                    context->buf.get());
+                if (addRet < 0) {
+                    LOG(ERROR) << "DataChunkTranferAddPart fail"
+                               << ", ret = " << addRet
+                               << ", chunkDataName = "
+                               << name.ToDataChunkKey()
+                               << ", index = " << context->partIndex;
+                } else {
+                    // 各分片的页互不重叠，可并发更新
+                    if (digestPtr != nullptr) {
+                        digestPtr->Update(context->partIndex * context->len,
+                                          context->len, context->buf.get());
+                    }
+                    pipeline->AddUploadBytes(context->len);
+                }
+                uploadTracker->HandleResponse(addRet);
+            });
+            return kErrCodeSuccess;
+        });
+    // 无论读取是否成功，都需等待已提交的上传结束
+    uploadTracker->Wait();
+    if (ret >= 0) {
+        ret = uploadTracker->GetResult();
+    }
+    if (ret >= 0) {
+        ret =
+            dataStore_->DataChunkTranferComplete(name, transferTask);
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferComplete fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = " << name.ToDataChunkKey()
+                       << ", logicalPool = " << cidInfo.lpid_
+                       << ", copysetId = " << cidInfo.cpid_
+                       << ", chunkId = " << cidInfo.cid_;
+        }
+    }
+    if (ret < 0) {
+            int ret2 =
+                dataStore_->DataChunkTranferAbort(
+                name,
+                transferTask);
+            if (ret2 < 0) {
+                LOG(ERROR) << "DataChunkTranferAbort fail"
+                           << ", ret = " << ret2
+                           << ", chunkDataName = " << name.ToDataChunkKey()
+                           << ", logicalPool = " << cidInfo.lpid_
+                           << ", copysetId = " << cidInfo.cpid_
+                           << ", chunkId = " << cidInfo.cid_;
+            }
+        return ret;
+    }
+
+    if (digest != nullptr) {
+        // 页摘要只影响后续快照能否增量转储，存储失败不影响本次转储
+        ret = dataStore_->PutChunkPageDigest(name, *digest);
+        LOG_IF(WARNING, ret < 0) << "PutChunkPageDigest fail"
+                                 << ", ret = " << ret
+                                 << ", chunkDataName = "
+                                 << name.ToDataChunkKey();
+    }
+    return kErrCodeSuccess;
+}
+
+/**
+ * @brief 按页增量转储快照的单个chunk
+ * @detail
+ *  读取chunk的全部分片，与基准chunk的页摘要逐页比较，
+ *  只存储发生变化的页。以下情况需转为全量转储：
+ *  1. 基准chunk没有可用的页摘要
+ *  2. 变化的数据过多
+ *
+ * @param[out] fallback 是否需要转为全量转储
+ *
+ * @return 错误码
+ */
+int TransferSnapshotDataChunkTask::TransferSnapshotDataChunkDelta(
+    bool *fallback) {
+    ChunkDataName name = taskInfo_->name_;
+    const ChunkDataName &base = taskInfo_->deltaBase_;
+    uint64_t chunkSize = taskInfo_->chunkSize_;
+    uint32_t pageSize = taskInfo_->deltaPageSize_;
+
+    *fallback = true;
+    ChunkPageDigest baseDigest;
+    if (dataStore_->GetChunkPageDigest(base, &baseDigest) < 0 ||
+        baseDigest.GetPageSize() != pageSize ||
+        baseDigest.GetPageNum() != chunkSize / pageSize) {
+        LOG(INFO) << "Base chunk has no page digest, transfer full chunk"
+                  << ", chunkDataName = " << name.ToDataChunkKey()
+                  << ", base = " << base.ToDataChunkKey();
+        return kErrCodeSuccess;
+    }
+
+    ChunkDeltaData delta(pageSize);
+    bool tooLarge = false;
+    int ret = ReadChunkSnapshot(
+        [&](const ReadChunkSnapshotContextPtr &context) {
+            uint64_t offset = context->partIndex * context->len;
+            for (uint64_t pos = 0; pos < context->len; pos += pageSize) {
+                uint32_t pageIndex = (offset + pos) / pageSize;
+                const char *page = context->buf.get() + pos;
+                if (!baseDigest.IsPageSame(pageIndex, page)) {
+                    delta.PutPage(pageIndex, page);
+                }
+            }
+            if (delta.GetDataSize() > chunkSize / kDeltaFallbackDivisor) {
+                tooLarge = true;
+                return kErrCodeInternalError;
+            }
+            return kErrCodeSuccess;
+        });
+    if (tooLarge) {
+        LOG(INFO) << "Too many pages changed, transfer full chunk"
+                  << ", chunkDataName = " << name.ToDataChunkKey()
+                  << ", base = " << base.ToDataChunkKey();
+        return kErrCodeSuccess;
+    }
+    *fallback = false;
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = dataStore_->PutChunkDeltaData(name, delta);
+    if (ret < 0) {
+        LOG(ERROR) << "PutChunkDeltaData fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = " << name.ToDataChunkKey()
+                   << ", base = " << base.ToDataChunkKey();
+        return ret;
+    }
+    return kErrCodeSuccess;
+}
+
+int TransferSnapshotDataChunkTask::ReadChunkSnapshot(
+    const PartHandler &handler) {
+    uint64_t chunkSize = taskInfo_->chunkSize_;
+    uint64_t chunkSplitSize = taskInfo_->chunkSplitSize_;
+
+    int ret = kErrCodeSuccess;
     auto tracker = std::make_shared<ReadChunkSnapshotTaskTracker>();
     for (uint64_t i = 0;
         i < chunkSize / chunkSplitSize;
@@ -87,14 +271,17 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
         context->cidInfo = taskInfo_->cidInfo_;
         context->seqNum = taskInfo_->name_.chunkSeqNum_;
         context->partIndex = i;
-        context->buf = std::unique_ptr<char[]>(new char[chunkSplitSize]);
+        ret = AcquireBuffer(tracker, handler, &context->buf);
+        if (ret < 0) {
+            return ret;
+        }
         context->len = chunkSplitSize;
         context->startTime = TimeUtility::GetTimeofDaySec();
         context->clientAsyncMethodRetryTimeSec =
             taskInfo_->clientAsyncMethodRetryTimeSec_;
         ret = StartAsyncReadChunkSnapshot(tracker, context);
         if (ret < 0) {
-            break;
+            return ret;
         }
         if (tracker->GetTaskNum() >= taskInfo_->readChunkSnapshotConcurrency_) {
             tracker->WaitSome(1);
@@ -102,62 +289,61 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
         std::list<ReadChunkSnapshotContextPtr> results =
             tracker->PopResultContexts();
         ret = HandleReadChunkSnapshotResultsAndRetry(
-            tracker, transferTask, results);
+            tracker, handler, results);
         if (ret < 0) {
-            break;
+            return ret;
         }
     }
-    if (ret >= 0) {
-        do {
-            tracker->WaitSome(1);
+    do {
+        tracker->WaitSome(1);
+        std::list<ReadChunkSnapshotContextPtr> results =
+            tracker->PopResultContexts();
+        if (0 == results.size()) {
+            // 已经完成，没有新的结果了
+            break;
+        }
+        ret = HandleReadChunkSnapshotResultsAndRetry(
+            tracker, handler, results);
+        if (ret < 0) {
+            return ret;
+        }
+    } while (true);
+    return ret;
+}
+
+int TransferSnapshotDataChunkTask::AcquireBuffer(
+    std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+    const PartHandler &handler,
+    SnapshotTransferPipeline::Buffer *buf) {
+    while (true) {
+        bool idle = (tracker->GetTaskNum() == 0);
+        {
             std::list<ReadChunkSnapshotContextPtr> results =
                 tracker->PopResultContexts();
-            if (0 == results.size()) {
-                // 已经完成，没有新的结果了
-                break;
-            }
-            ret = HandleReadChunkSnapshotResultsAndRetry(
-                tracker, transferTask, results);
-            if (ret < 0) {
-                break;
-            }
-        } while (true);
-        if (ret >= 0) {
-            ret =
-                dataStore_->DataChunkTranferComplete(name, transferTask);
+            int ret = HandleReadChunkSnapshotResultsAndRetry(
+                tracker, handler, results);
             if (ret < 0) {
-                LOG(ERROR) << "DataChunkTranferComplete fail"
-                           << ", ret = " << ret
-                           << ", chunkDataName = " << name.ToDataChunkKey()
-                           << ", logicalPool = " << cidInfo.lpid_
-                           << ", copysetId = " << cidInfo.cpid_
-                           << ", chunkId = " << cidInfo.cid_;
+                return ret;
             }
         }
+        *buf = pipeline_->TryAcquireBuffer();
+        if (*buf != nullptr) {
+            return kErrCodeSuccess;
+        }
+        if (idle && tracker->GetTaskNum() == 0) {
+            *buf = pipeline_->AcquireBuffer();
+            return kErrCodeSuccess;
+        }
+        tracker->WaitSome(1);
     }
-    if (ret < 0) {
-            int ret2 =
-                dataStore_->DataChunkTranferAbort(
-                name,
-                transferTask);
-            if (ret2 < 0) {
-                LOG(ERROR) << "DataChunkTranferAbort fail"
-                           << ", ret = " << ret2
-                           << ", chunkDataName = " << name.ToDataChunkKey()
-                           << ", logicalPool = " << cidInfo.lpid_
-                           << ", copysetId = " << cidInfo.cpid_
-                           << ", chunkId = " << cidInfo.cid_;
-            }
-        return ret;
-    }
-    return kErrCodeSuccess;
 }
 
 int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
     std::shared_ptr<ReadChunkSnapshotContext> context) {
+    pipeline_->AcquireReadSlot();
     ReadChunkSnapshotClosure *cb =
-        new ReadChunkSnapshotClosure(tracker, context);
+        new ReadChunkSnapshotClosure(tracker, context, pipeline_);
     tracker->AddOneTrace();
     uint64_t offset = context->partIndex * context->len;
     LOG_EVERY_SECOND(INFO) << "Doing ReadChunkSnapshot"
@@ -181,6 +367,8 @@ int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
                    << ", chunkId = " << context->cidInfo.cid_
                    << ", seqNum = " << context->seqNum
                    << ", offset = " << offset;
+        // 同步返回失败时回调不会执行
+        pipeline_->ReleaseReadSlot(0);
         return ret;
     }
     return kErrCodeSuccess;
@@ -188,7 +376,7 @@ int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
 
 int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
-    std::shared_ptr<TransferTask> transferTask,
+    const PartHandler &handler,
     const std::list<ReadChunkSnapshotContextPtr> &results) {
     int ret = kErrCodeSuccess;
     for (auto context : results) {
@@ -211,18 +399,8 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
                 return ret;
             }
         } else {
-            ret = dataStore_->DataChunkTranferAddPart(
-                taskInfo_->name_,
-                transferTask,
-                context->partIndex,
-                context->len,
-                context->buf.get());
+            ret = handler(context);
             if (ret < 0) {
-                LOG(ERROR) << "DataChunkTranferAddPart fail"
-                           << ", ret = " << ret
-                           << ", chunkDataName = "
-                           << taskInfo_->name_.ToDataChunkKey()
-                           << ", index = " << context->partIndex;
                 return ret;
             }
         }
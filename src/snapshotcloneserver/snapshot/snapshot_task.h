@@ -26,6 +26,7 @@
 #include <string>
 #include <memory>
 #include <list>
+#include <functional>
 
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
@@ -33,6 +34,7 @@
 #include "src/snapshotcloneserver/common/task_info.h"
 #include "src/snapshotcloneserver/common/snapshotclone_metric.h"
 #include "src/snapshotcloneserver/common/task_tracker.h"
+#include "src/snapshotcloneserver/snapshot/snapshot_transfer_pipeline.h"
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -180,8 +182,8 @@ struct ReadChunkSnapshotContext {
     uint64_t seqNum;
     // 分片的索引
     uint64_t partIndex;
-    // 分片的buffer
-    std::unique_ptr<char[]> buf;
+    // 分片的buffer，从转储流水线的缓冲池分配
+    SnapshotTransferPipeline::Buffer buf;
     // 分片长度
     uint64_t len;
     // 返回值
@@ -199,12 +201,15 @@ using ReadChunkSnapshotTaskTracker =
 struct ReadChunkSnapshotClosure : public SnapCloneClosure {
     ReadChunkSnapshotClosure(
         std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
-        std::shared_ptr<ReadChunkSnapshotContext> context)
+        std::shared_ptr<ReadChunkSnapshotContext> context,
+        std::shared_ptr<SnapshotTransferPipeline> pipeline)
         : tracker_(tracker),
-          context_(context) {}
+          context_(context),
+          pipeline_(pipeline) {}
     void Run() override;
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker_;
     std::shared_ptr<ReadChunkSnapshotContext> context_;
+    std::shared_ptr<SnapshotTransferPipeline> pipeline_;
 };
 
 struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
@@ -215,6 +220,12 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
     uint64_t clientAsyncMethodRetryTimeSec_;
     uint64_t clientAsyncMethodRetryIntervalMs_;
     uint32_t readChunkSnapshotConcurrency_;
+    // 增量转储的页大小，为0时不做增量转储也不计算页摘要
+    uint32_t deltaPageSize_;
+    // 是否存在增量转储的基准chunk
+    bool hasDeltaBase_;
+    // 增量转储的基准chunk
+    ChunkDataName deltaBase_;
 
     TransferSnapshotDataChunkTaskInfo(const ChunkDataName &name,
         uint64_t chunkSize,
@@ -229,7 +240,9 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
           chunkSplitSize_(chunkSplitSize),
           clientAsyncMethodRetryTimeSec_(clientAsyncMethodRetryTimeSec),
           clientAsyncMethodRetryIntervalMs_(clientAsyncMethodRetryIntervalMs),
-          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency) {}
+          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency),
+          deltaPageSize_(0),
+          hasDeltaBase_(false) {}
 };
 
 class TransferSnapshotDataChunkTask : public TrackerTask {
@@ -237,11 +250,13 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
     TransferSnapshotDataChunkTask(const TaskIdType &taskId,
         std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo,
         std::shared_ptr<CurveFsClient> client,
-        std::shared_ptr<SnapshotDataStore> dataStore)
+        std::shared_ptr<SnapshotDataStore> dataStore,
+        std::shared_ptr<SnapshotTransferPipeline> pipeline)
         : TrackerTask(taskId),
           taskInfo_(taskInfo),
           client_(client),
-          dataStore_(dataStore) {}
+          dataStore_(dataStore),
+          pipeline_(pipeline) {}
 
     std::shared_ptr<TransferSnapshotDataChunkTaskInfo> GetTaskInfo() const {
         return taskInfo_;
@@ -255,12 +270,60 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
 
  private:
     /**
-     * @brief 转储快照单个chunk
+     * @brief 分片处理函数，处理成功读取的一个分片
+     */
+    using PartHandler =
+        std::function<int(const ReadChunkSnapshotContextPtr &)>;
+
+    /**
+     * @brief 转储快照单个chunk，有基准chunk时优先增量转储
      *
      * @return 错误码
      */
     int TransferSnapshotDataChunk();
 
+    /**
+     * @brief 全量转储快照单个chunk
+     *
+     * @return 错误码
+     */
+    int TransferSnapshotDataChunkFull();
+
+    /**
+     * @brief 按页增量转储快照单个chunk
+     *
+     * @param[out] fallback 是否需要转为全量转储
+     *
+     * @return 错误码
+     */
+    int TransferSnapshotDataChunkDelta(bool *fallback);
+
+    /**
+     * @brief 并发读取chunk的所有分片，并依次交给handler处理
+     *
+     * @param handler 分片处理函数
+     *
+     * @return 错误码
+     */
+    int ReadChunkSnapshot(const PartHandler &handler);
+
+    /**
+     * @brief 从缓冲池分配分片缓冲区
+     * @detail
+     *  缓冲区用尽时先处理本任务已完成的读取，使其缓冲区进入上传阶段，
+     *  本任务没有正在进行的读取时才阻塞等待，避免各任务持有缓冲区相互等待
+     *
+     * @param tracker 异步ReadSnapshotChunk追踪器
+     * @param handler 分片处理函数
+     * @param[out] buf 分配的缓冲区
+     *
+     * @return 错误码
+     */
+    int AcquireBuffer(
+        std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
+        const PartHandler &handler,
+        SnapshotTransferPipeline::Buffer *buf);
+
     /**
      * @brief 开始异步ReadSnapshotChunk
      *
@@ -277,20 +340,21 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
      * @brief 处理ReadChunkSnapshot的结果并重试
      *
      * @param tracker 异步ReadSnapshotChunk追踪器
-     * @param transferTask 转储任务
+     * @param handler 分片处理函数
      * @param results ReadChunkSnapshot结果列表
      *
      * @return 错误码
      */
     int HandleReadChunkSnapshotResultsAndRetry(
         std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
-        std::shared_ptr<TransferTask> transferTask,
+        const PartHandler &handler,
         const std::list<ReadChunkSnapshotContextPtr> &results);
 
  protected:
     std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo_;
     std::shared_ptr<CurveFsClient> client_;
     std::shared_ptr<SnapshotDataStore> dataStore_;
+    std::shared_ptr<SnapshotTransferPipeline> pipeline_;
 };
 
 
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include "src/snapshotcloneserver/snapshot/snapshot_transfer_pipeline.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+using ::curve::common::LockGuard;
+using ::curve::common::UniqueLock;
+
+namespace curve {
+namespace snapshotcloneserver {
+
+// 上传队列长度为上传线程数的倍数，队列满时反压读阶段
+const uint32_t kUploadQueueFactor = 2;
+
+SnapshotTransferPipeline::SnapshotTransferPipeline(
+    const SnapshotTransferOption &option)
+    : option_(option),
+      allocatedBuffers_(0),
+      readInflight_(0) {
+    maxBuffers_ = std::max<uint64_t>(1,
+        option_.bufferPoolSize / std::max<uint64_t>(1, option_.splitSize));
+    option_.readConcurrency = std::max<uint32_t>(1, option_.readConcurrency);
+    option_.uploadThreadNum = std::max<uint32_t>(1, option_.uploadThreadNum);
+}
+
+SnapshotTransferPipeline::~SnapshotTransferPipeline() {
+    Stop();
+    for (char *buf : freeBuffers_) {
+        delete[] buf;
+    }
+    freeBuffers_.clear();
+}
+
+int SnapshotTransferPipeline::Start() {
+    int ret = uploadPool_.Start(option_.uploadThreadNum,
+        option_.uploadThreadNum * kUploadQueueFactor);
+    if (ret < 0) {
+        LOG(ERROR) << "SnapshotTransferPipeline start upload pool fail"
+                   << ", ret = " << ret;
+        return ret;
+    }
+    LOG(INFO) << "SnapshotTransferPipeline started"
+              << ", maxBuffers = " << maxBuffers_
+              << ", readConcurrency = " << option_.readConcurrency
+              << ", uploadThreadNum = " << option_.uploadThreadNum;
+    return 0;
+}
+
+void SnapshotTransferPipeline::Stop() {
+    uploadPool_.Stop();
+}
+
+SnapshotTransferPipeline::Buffer SnapshotTransferPipeline::TryAcquireBuffer() {
+    char *buf = nullptr;
+    {
+        LockGuard guard(mtx_);
+        if (!freeBuffers_.empty()) {
+            buf = freeBuffers_.back();
+            freeBuffers_.pop_back();
+        } else if (allocatedBuffers_ < maxBuffers_) {
+            allocatedBuffers_++;
+        } else {
+            metric_.bufferWait << 1;
+            return nullptr;
+        }
+    }
+    if (buf == nullptr) {
+        buf = new char[option_.splitSize];
+    }
+    return WrapBuffer(buf);
+}
+
+SnapshotTransferPipeline::Buffer SnapshotTransferPipeline::AcquireBuffer() {
+    char *buf = nullptr;
+    {
+        UniqueLock lock(mtx_);
+        bufferCv_.wait(lock, [this]() {
+            return !freeBuffers_.empty() || allocatedBuffers_ < maxBuffers_;
+        });
+        if (!freeBuffers_.empty()) {
+            buf = freeBuffers_.back();
+            freeBuffers_.pop_back();
+        } else {
+            allocatedBuffers_++;
+        }
+    }
+    if (buf == nullptr) {
+        buf = new char[option_.splitSize];
+    }
+    return WrapBuffer(buf);
+}
+
+SnapshotTransferPipeline::Buffer SnapshotTransferPipeline::WrapBuffer(
+    char *buf) {
+    metric_.bufferUsed << 1;
+    return Buffer(buf, [this](char *p) {
+        ReleaseBuffer(p);
+    });
+}
+
+void SnapshotTransferPipeline::ReleaseBuffer(char *buf) {
+    metric_.bufferUsed << -1;
+    LockGuard guard(mtx_);
+    freeBuffers_.push_back(buf);
+    bufferCv_.notify_one();
+}
+
+void SnapshotTransferPipeline::AcquireReadSlot() {
+    UniqueLock lock(mtx_);
+    readCv_.wait(lock, [this]() {
+        return readInflight_ < option_.readConcurrency;
+    });
+    readInflight_++;
+    metric_.readInflight << 1;
+}
+
+void SnapshotTransferPipeline::ReleaseReadSlot(uint64_t bytes) {
+    metric_.readBytes << bytes;
+    metric_.readInflight << -1;
+    LockGuard guard(mtx_);
+    readInflight_--;
+    readCv_.notify_one();
+}
+
+void SnapshotTransferPipeline::PushUpload(const UploadTask &task) {
+    metric_.uploadPending << 1;
+    uploadPool_.Enqueue([this, task]() {
+        task();
+        metric_.uploadPending << -1;
+    });
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
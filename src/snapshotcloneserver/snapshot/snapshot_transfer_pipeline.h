@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#ifndef SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_TRANSFER_PIPELINE_H_
+#define SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_TRANSFER_PIPELINE_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
+#include "src/snapshotcloneserver/common/snapshotclone_metric.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+struct SnapshotTransferOption {
+    // 分片大小，即缓冲区大小
+    uint64_t splitSize;
+    // 分片缓冲区总大小上限
+    uint64_t bufferPoolSize;
+    // 同时进行的ReadChunkSnapshot数上限
+    uint32_t readConcurrency;
+    // 上传线程数
+    uint32_t uploadThreadNum;
+};
+
+/**
+ * @brief 快照转储流水线，由所有快照任务共享
+ * @detail
+ *  转储分为读取、上传(含摘要和编码)两个阶段，各阶段独立控制并发：
+ *  1. 读阶段：全局ReadChunkSnapshot并发数有上限
+ *  2. 上传阶段：由独立的线程池执行，队列满时提交者阻塞
+ *  分片缓冲区从有上限的缓冲池分配并复用，缓冲区用尽时读阶段等待，
+ *  从而使较慢的阶段反压较快的阶段，内存不随快照任务数增长
+ */
+class SnapshotTransferPipeline {
+ public:
+    using Buffer = std::shared_ptr<char>;
+    using UploadTask = std::function<void()>;
+
+    explicit SnapshotTransferPipeline(const SnapshotTransferOption &option);
+    ~SnapshotTransferPipeline();
+
+    int Start();
+    void Stop();
+
+    uint64_t GetSplitSize() const {
+        return option_.splitSize;
+    }
+
+    /**
+     * @brief 尝试分配一个分片缓冲区，释放时自动归还缓冲池
+     *
+     * @return 缓冲区，缓冲区用尽时返回nullptr
+     */
+    Buffer TryAcquireBuffer();
+
+    /**
+     * @brief 分配一个分片缓冲区，缓冲区用尽时阻塞等待归还
+     *
+     * @return 缓冲区
+     */
+    Buffer AcquireBuffer();
+
+    /**
+     * @brief 开始一个读取，达到读并发上限时阻塞等待
+     */
+    void AcquireReadSlot();
+
+    /**
+     * @brief 结束一个读取
+     *
+     * @param bytes 成功读取的字节数
+     */
+    void ReleaseReadSlot(uint64_t bytes);
+
+    /**
+     * @brief 提交一个上传任务，上传队列满时阻塞等待
+     *
+     * @param task 上传任务
+     */
+    void PushUpload(const UploadTask &task);
+
+    /**
+     * @brief 记录上传的原始字节数
+     */
+    void AddUploadBytes(uint64_t bytes) {
+        metric_.uploadBytes << bytes;
+    }
+
+ private:
+    Buffer WrapBuffer(char *buf);
+    void ReleaseBuffer(char *buf);
+
+ private:
+    SnapshotTransferOption option_;
+    // 缓冲区数量上限
+    uint32_t maxBuffers_;
+
+    curve::common::Mutex mtx_;
+    curve::common::ConditionVariable bufferCv_;
+    curve::common::ConditionVariable readCv_;
+    // 空闲的缓冲区
+    std::vector<char *> freeBuffers_;
+    // 已分配的缓冲区数量
+    uint32_t allocatedBuffers_;
+    // 正在进行的读取数量
+    uint32_t readInflight_;
+
+    curve::common::TaskThreadPool<> uploadPool_;
+
+    SnapshotTransferMetric metric_;
+};
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
+
+#endif  // SRC_SNAPSHOTCLONESERVER_SNAPSHOT_SNAPSHOT_TRANSFER_PIPELINE_H_
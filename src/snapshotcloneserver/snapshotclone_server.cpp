@@ -39,6 +39,8 @@ const char configMetricName[] = "snapshotcloneserver_config";
 const char statusMetricName[] = "snapshotcloneserver_status";
 const char ACTIVE[] = "active";
 const char STANDBY[] = "standby";
+const char kS3DataStoreType[] = "s3";
+const char kLocalDataStoreType[] = "local";
 
 void InitClientOption(std::shared_ptr<Configuration> conf,
                       CurveClientOptions *clientOption) {
@@ -81,6 +83,27 @@ void InitSnapshotCloneServerOptions(std::shared_ptr<Configuration> conf,
                                         &serverOption->mdsSessionTimeUs);
     conf->GetValueFatalIfFail("server.readChunkSnapshotConcurrency",
             &serverOption->readChunkSnapshotConcurrency);
+    conf->GetBoolValue("server.snapshotDeltaEnable",
+                       &serverOption->snapshotDeltaEnable);
+    conf->GetUInt32Value("server.snapshotDeltaPageSize",
+                         &serverOption->snapshotDeltaPageSize);
+    LOG_IF(FATAL, serverOption->snapshotDeltaEnable &&
+        (0 == serverOption->snapshotDeltaPageSize ||
+         serverOption->chunkSplitSize %
+            serverOption->snapshotDeltaPageSize != 0))
+        << "server.snapshotDeltaPageSize must divide server.chunkSplitSize";
+    conf->GetBoolValue("server.snapshotEncodeEnable",
+                       &serverOption->snapshotEncodeEnable);
+    conf->GetUInt64Value("server.snapshotTransferBufferPoolSize",
+                         &serverOption->snapshotTransferBufferPoolSize);
+    conf->GetUInt32Value("server.snapshotTransferReadConcurrency",
+                         &serverOption->snapshotTransferReadConcurrency);
+    conf->GetUInt32Value("server.snapshotTransferUploadThreadNum",
+                         &serverOption->snapshotTransferUploadThreadNum);
+    LOG_IF(FATAL, serverOption->snapshotTransferBufferPoolSize <
+        serverOption->chunkSplitSize)
+        << "server.snapshotTransferBufferPoolSize must not be less than "
+        << "server.chunkSplitSize";
 
     conf->GetValueFatalIfFail("server.stage1PoolThreadNum",
                                      &serverOption->stage1PoolThreadNum);
@@ -102,6 +125,24 @@ void InitSnapshotCloneServerOptions(std::shared_ptr<Configuration> conf,
                             &serverOption->createCloneChunkConcurrency);
     conf->GetValueFatalIfFail("server.recoverChunkConcurrency",
                             &serverOption->recoverChunkConcurrency);
+    conf->GetUInt32Value("server.createCloneChunkBatchSize",
+                         &serverOption->createCloneChunkBatchSize);
+    conf->GetUInt32Value("server.recoverChunkBatchPartNum",
+                         &serverOption->recoverChunkBatchPartNum);
+    conf->GetUInt32Value("server.cloneReadMissWindowSec",
+                         &serverOption->cloneReadMissWindowSec);
+    conf->GetUInt32Value("server.cloneReadMissThrottleRate",
+                         &serverOption->cloneReadMissThrottleRate);
+    conf->GetUInt32Value("server.recoverChunkThrottledConcurrency",
+                         &serverOption->recoverChunkThrottledConcurrency);
+    conf->GetBoolValue("server.bulkRestoreEnable",
+                       &serverOption->bulkRestoreEnable);
+    conf->GetUInt32Value("server.bulkWriteMaxSize",
+                         &serverOption->bulkWriteMaxSize);
+    conf->GetUInt32Value("server.bulkWriteConcurrency",
+                         &serverOption->bulkWriteConcurrency);
+    conf->GetUInt32Value("server.bulkReadConcurrency",
+                         &serverOption->bulkReadConcurrency);
     conf->GetValueFatalIfFail("server.backEndReferenceRecordScanIntervalMs",
                         &serverOption->backEndReferenceRecordScanIntervalMs);
     conf->GetValueFatalIfFail("server.backEndReferenceFuncScanIntervalMs",
@@ -144,6 +185,16 @@ void SnapShotCloneServer::InitAllSnapshotCloneOptions(void) {
 
     conf_->GetValueFatalIfFail("s3.config_path",
         &(snapshotCloneServerOptions_.s3ConfPath));
+
+    conf_->GetStringValue("datastore.type",
+        &(snapshotCloneServerOptions_.dataStoreType));
+    conf_->GetStringValue("datastore.local_path",
+        &(snapshotCloneServerOptions_.localDataStorePath));
+
+    conf_->GetUInt32Value("metastore.shard_num",
+        &(snapshotCloneServerOptions_.metaStoreShardNum));
+    conf_->GetUInt32Value("metastore.batch_max_ops",
+        &(snapshotCloneServerOptions_.metaStoreBatchMaxOps));
 }
 
 void SnapShotCloneServer::StartDummy() {
@@ -236,14 +287,33 @@ bool SnapShotCloneServer::Init() {
     auto codec = std::make_shared<SnapshotCloneCodec>();
 
     metaStore_ = std::make_shared<SnapshotCloneMetaStoreEtcd>(etcdClient_,
-        codec);
+        codec, snapshotCloneServerOptions_.metaStoreShardNum,
+        snapshotCloneServerOptions_.metaStoreBatchMaxOps);
     if (metaStore_->Init() < 0) {
         LOG(ERROR) << "metaStore init fail.";
         return false;
     }
 
-    dataStore_ = std::make_shared<S3SnapshotDataStore>();
-    if (dataStore_->Init(snapshotCloneServerOptions_.s3ConfPath) < 0) {
+    const auto &serverOption = snapshotCloneServerOptions_.serverOption;
+    int ret = -1;
+    if (snapshotCloneServerOptions_.dataStoreType == kLocalDataStoreType) {
+        auto localDataStore = std::make_shared<LocalSnapshotDataStore>();
+        localDataStore->SetEncodeOption(serverOption.snapshotEncodeEnable,
+                                        serverOption.chunkSplitSize);
+        dataStore_ = localDataStore;
+        ret = dataStore_->Init(snapshotCloneServerOptions_.localDataStorePath);
+    } else if (snapshotCloneServerOptions_.dataStoreType ==
+               kS3DataStoreType) {
+        auto s3DataStore = std::make_shared<S3SnapshotDataStore>();
+        s3DataStore->SetEncodeOption(serverOption.snapshotEncodeEnable,
+                                     serverOption.chunkSplitSize);
+        dataStore_ = s3DataStore;
+        ret = dataStore_->Init(snapshotCloneServerOptions_.s3ConfPath);
+    } else {
+        LOG(ERROR) << "Unknown dataStore type: "
+                   << snapshotCloneServerOptions_.dataStoreType;
+    }
+    if (ret < 0) {
         LOG(ERROR) << "dataStore init fail.";
         return false;
     }
@@ -40,6 +40,7 @@
 
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store_s3.h"
+#include "src/snapshotcloneserver/snapshot/snapshot_data_store_local.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task_manager.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/snapshotcloneserver/snapshotclone_service.h"
@@ -79,6 +80,16 @@ struct SnapShotCloneServerOptions {
 
     // s3
     std::string  s3ConfPath;
+
+    // 快照数据存储后端，s3或local
+    std::string dataStoreType = "s3";
+    // local后端的根目录
+    std::string localDataStorePath;
+
+    // metastore内存记录的分片数
+    uint32_t metaStoreShardNum = kDefaultMetaStoreShardNum;
+    // metastore一个etcd事务中最多合并的写操作数
+    uint32_t metaStoreBatchMaxOps = kDefaultMetaStoreBatchMaxOps;
 };
 
 class SnapShotCloneServer {
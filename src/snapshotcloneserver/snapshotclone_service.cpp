@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 #include <limits>
+#include <map>
 
 #include "json/json.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
@@ -84,6 +85,10 @@ void SnapshotCloneServiceImpl::default_method(RpcController* cntl,
         HandleGetCloneTaskListAction(bcntl, requestId);
     } else if (*action == kGetCloneRefStatusAction) {
         HandleGetCloneRefStatusAction(bcntl, requestId);
+    } else if (*action == kReportCloneReadMissAction) {
+        // chunkserver周期性上报，不打印日志
+        HandleReportCloneReadMissAction(bcntl, requestId);
+        return;
     } else {
         HandleBadRequestError(bcntl, requestId);
     }
@@ -721,10 +726,13 @@ void SnapshotCloneServiceImpl::HandleGetFileSnapshotListAction(
               << ", requestId = " << requestId;
 
     std::vector<FileSnapshotInfo> info;
+    uint64_t totalCount = 0;
     int ret = kErrCodeSuccess;
 
+    // 由metastore分页，只获取当前页的快照
     SnapshotFilterCondition filter(uuid, file, user, status);
-    ret = snapshotManager_->GetSnapshotListByFilter(filter, &info);
+    ret = snapshotManager_->GetSnapshotListByPage(filter, offsetNum, limitNum,
+        &info, &totalCount);
     if (ret < 0) {
         bcntl->http_response().set_status_code(
             brpc::HTTP_STATUS_INTERNAL_SERVER_ERROR);
@@ -737,12 +745,10 @@ void SnapshotCloneServiceImpl::HandleGetFileSnapshotListAction(
     mainObj[kCodeStr] = std::to_string(kErrCodeSuccess);
     mainObj[kMessageStr] = code2Msg[kErrCodeSuccess];
     mainObj[kRequestIdStr] = requestId;
-    mainObj[kTotalCountStr] = info.size();
+    mainObj[kTotalCountStr] = static_cast<Json::UInt64>(totalCount);
     Json::Value listSnapObj;
-    for (std::vector<FileSnapshotInfo>::size_type i = offsetNum;
-        i < info.size() && i < limitNum + offsetNum;
-        i++) {
-        Json::Value fileSnapObj = info[i].ToJsonObj();
+    for (auto &fileSnapInfo : info) {
+        Json::Value fileSnapObj = fileSnapInfo.ToJsonObj();
         listSnapObj.append(fileSnapObj);
     }
     mainObj[kSnapshotsStr] = listSnapObj;
@@ -934,6 +940,46 @@ void SnapshotCloneServiceImpl::HandleGetCloneRefStatusAction(
     return;
 }
 
+void SnapshotCloneServiceImpl::HandleReportCloneReadMissAction(
+    brpc::Controller* bcntl, const std::string &requestId) {
+    const std::string *version =
+        bcntl->http_request().uri().GetQuery(kVersionStr);
+    if ((version == nullptr) ||
+        (version->empty())) {
+        HandleBadRequestError(bcntl, requestId);
+        return;
+    }
+
+    // 请求体格式：{"ReadMiss":[{"ChunkId":1,"Count":2}, ...]}
+    Json::Reader reader;
+    Json::Value body;
+    if (!reader.parse(bcntl->request_attachment().to_string(), body) ||
+        !body[kReadMissStr].isArray()) {
+        HandleBadRequestError(bcntl, requestId);
+        return;
+    }
+    std::map<uint64_t, uint32_t> missCounts;
+    for (const auto &item : body[kReadMissStr]) {
+        if (!item[kChunkIdStr].isUInt64() || !item[kCountStr].isUInt()) {
+            HandleBadRequestError(bcntl, requestId);
+            return;
+        }
+        missCounts[item[kChunkIdStr].asUInt64()] += item[kCountStr].asUInt();
+    }
+
+    cloneManager_->ReportCloneReadMiss(missCounts);
+
+    bcntl->http_response().set_status_code(brpc::HTTP_STATUS_OK);
+    butil::IOBufBuilder os;
+    Json::Value mainObj;
+    mainObj[kCodeStr] = std::to_string(kErrCodeSuccess);
+    mainObj[kMessageStr] = code2Msg[kErrCodeSuccess];
+    mainObj[kRequestIdStr] = requestId;
+    os << mainObj.toStyledString();
+    os.move_to(bcntl->response_attachment());
+    return;
+}
+
 void SnapshotCloneServiceImpl::SetErrorMessage(brpc::Controller* bcntl,
                         int errCode,
                         const std::string &requestId,
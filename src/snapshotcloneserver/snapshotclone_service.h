@@ -94,6 +94,8 @@ class SnapshotCloneServiceImpl : public SnapshotCloneService {
         const std::string &requestId);
     void HandleGetCloneRefStatusAction(brpc::Controller* bcntl,
         const std::string &requestId);
+    void HandleReportCloneReadMissAction(brpc::Controller* bcntl,
+        const std::string &requestId);
     bool CheckBoolParamter(
         const std::string *param, bool *valueOut);
     void SetErrorMessage(brpc::Controller* bcntl, int errCode,
@@ -29,6 +29,9 @@ DEFINE_string(mdsDummyPort, "6667", "dummy port of mds, "
                                     "if specify several, the order "
                                     "should be the same as mds addr");
 DEFINE_string(etcdAddr, "127.0.0.1:2379", "etcd addr");
+DEFINE_string(mdsFollowerReadAddr, "", "addr of the mds follower read "
+                                    "service, if specified, the read-only "
+                                    "requests are sent to it first");
 DEFINE_uint64(rpcTimeout, 3000, "millisecond for rpc timeout");
 DEFINE_uint64(rpcRetryTimes, 5, "rpc retry times");
 DEFINE_string(snapshotCloneAddr, "127.0.0.1:5555", "snapshot clone addr");
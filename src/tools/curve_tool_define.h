@@ -29,6 +29,7 @@
 DECLARE_string(mdsAddr);
 DECLARE_string(mdsDummyPort);
 DECLARE_string(etcdAddr);
+DECLARE_string(mdsFollowerReadAddr);
 DECLARE_uint64(rpcTimeout);
 DECLARE_uint64(rpcRetryTimes);
 DECLARE_string(snapshotCloneAddr);
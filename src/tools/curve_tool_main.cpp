@@ -80,6 +80,11 @@ void UpdateFlagsFromConf(curve::common::Configuration* conf) {
         if (GetCommandLineFlagInfo("etcdAddr", &info) && info.is_default) {
             conf->GetStringValue("etcdAddr", &FLAGS_etcdAddr);
         }
+        if (GetCommandLineFlagInfo("mdsFollowerReadAddr", &info) &&
+                                                            info.is_default) {
+            conf->GetStringValue("mdsFollowerReadAddr",
+                                 &FLAGS_mdsFollowerReadAddr);
+        }
         if (GetCommandLineFlagInfo("rpcTimeout", &info) && info.is_default) {
             conf->GetUInt64Value("rpcTimeout", &FLAGS_rpcTimeout);
         }
@@ -23,6 +23,7 @@
 
 DECLARE_uint64(rpcTimeout);
 DECLARE_uint64(rpcRetryTimes);
+DECLARE_string(mdsFollowerReadAddr);
 
 namespace curve {
 namespace tool {
@@ -67,12 +68,27 @@ int MDSClient::Init(const std::string& mdsAddr,
         }
         currentMdsIndex_ = i;
         isInited_ = true;
+        InitFollowerChannel();
         return 0;
     }
     std::cout << "Init channel to all mds fail!" << std::endl;
     return -1;
 }
 
+void MDSClient::InitFollowerChannel() {
+    if (FLAGS_mdsFollowerReadAddr.empty()) {
+        return;
+    }
+    if (followerChannel_.Init(FLAGS_mdsFollowerReadAddr.c_str(),
+                              nullptr) != 0) {
+        std::cout << "Init channel to mds follower "
+                  << FLAGS_mdsFollowerReadAddr
+                  << " fail, read from the leader!" << std::endl;
+        return;
+    }
+    followerReadEnable_ = true;
+}
+
 int MDSClient::InitDummyServerMap(const std::string& dummyPort) {
     std::vector<std::string> dummyPortVec;
     curve::common::SplitString(dummyPort, ",", &dummyPortVec);
@@ -116,7 +132,7 @@ int MDSClient::GetFileInfo(const std::string &fileName,
     curve::mds::CurveFSService_Stub stub(&channel_);
 
     auto fp = &curve::mds::CurveFSService_Stub::GetFileInfo;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "GetFileInfo info from all mds fail!" << std::endl;
         return -1;
     }
@@ -193,7 +209,7 @@ int MDSClient::ListDir(const std::string& dirName,
     curve::mds::CurveFSService_Stub stub(&channel_);
 
     auto fp = &curve::mds::CurveFSService_Stub::ListDir;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListDir from all mds fail!" << std::endl;
         return -1;
     }
@@ -304,7 +320,7 @@ int MDSClient::ListVolumesOnCopyset(
     curve::mds::CurveFSService_Stub stub(&channel_);
 
     auto fp = &curve::mds::CurveFSService_Stub::ListVolumesOnCopysets;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListVolumesOnCopyset from all mds fail!" << std::endl;
         return -1;
     }
@@ -391,7 +407,7 @@ int MDSClient::GetChunkServerListInCopySets(const PoolIdType& logicalPoolId,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::GetChunkServerListInCopySets;  // NOLINT
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "GetChunkServerListInCopySets from all mds fail!"
                   << std::endl;
         return -1;
@@ -420,7 +436,7 @@ int MDSClient::ListPhysicalPoolsInCluster(
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::ListPhysicalPool;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListPhysicalPool from all mds fail!"
                   << std::endl;
         return -1;
@@ -468,7 +484,7 @@ int MDSClient::ListLogicalPoolsInPhysicalPool(const PoolIdType& id,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::ListLogicalPool;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListLogicalPool from all mds fail!"
                   << std::endl;
         return -1;
@@ -495,7 +511,7 @@ int MDSClient::ListZoneInPhysicalPool(const PoolIdType& id,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::ListPoolZone;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListPoolZone from all mds fail!"
                   << std::endl;
         return -1;
@@ -522,7 +538,7 @@ int MDSClient::ListServersInZone(const ZoneIdType& id,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::ListZoneServer;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListZoneServer from all mds fail!"
                   << std::endl;
         return -1;
@@ -561,7 +577,7 @@ int MDSClient::ListChunkServersOnServer(ListChunkServerRequest* request,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::ListChunkServer;
-    if (SendRpcToMds(request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(request, &response, &stub, fp) != 0) {
         std::cout << "ListChunkServer from all mds fail!"
                   << std::endl;
         return -1;
@@ -618,7 +634,7 @@ int MDSClient::GetChunkServerInfo(GetChunkServerInfoRequest* request,
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::GetChunkServer;
-    if (SendRpcToMds(request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(request, &response, &stub, fp) != 0) {
         std::cout << "GetChunkServer from all mds fail!"
                   << std::endl;
         return -1;
@@ -693,7 +709,7 @@ int MDSClient::ListUnAvailCopySets(std::vector<CopysetInfo>* copysets) {
     curve::mds::topology::ListUnAvailCopySetsResponse response;
     curve::mds::topology::TopologyService_Stub stub(&channel_);
     auto fp = &curve::mds::topology::TopologyService_Stub::ListUnAvailCopySets;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "ListUnAvailCopySets from all mds fail!"
                   << std::endl;
         return -1;
@@ -718,7 +734,7 @@ int MDSClient::GetCopySetsInChunkServer(
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::GetCopySetsInChunkServer;  // NOLINT
-    if (SendRpcToMds(request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(request, &response, &stub, fp) != 0) {
         std::cout << "GetCopySetsInChunkServer from all mds fail!"
                   << std::endl;
         return -1;
@@ -743,7 +759,7 @@ int MDSClient::GetCopySetsInCluster(std::vector<CopysetInfo>* copysets) {
     curve::mds::topology::TopologyService_Stub stub(&channel_);
 
     auto fp = &curve::mds::topology::TopologyService_Stub::GetCopySetsInCluster;
-    if (SendRpcToMds(&request, &response, &stub, fp) != 0) {
+    if (SendReadRpcToMds(&request, &response, &stub, fp) != 0) {
         std::cout << "GetCopySetsInCluster from all mds fail!"
                   << std::endl;
         return -1;
@@ -1047,6 +1063,25 @@ int MDSClient::SendRpcToMds(Request* request, Response* response, T* obp,
     return -1;
 }
 
+template <typename T, typename Request, typename Response>
+int MDSClient::SendReadRpcToMds(Request* request, Response* response, T* obp,
+                void (T::*func)(google::protobuf::RpcController*,
+                            const Request*, Response*,
+                            google::protobuf::Closure*)) {
+    if (followerReadEnable_) {
+        T followerStub(&followerChannel_);
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(FLAGS_rpcTimeout);
+        (followerStub.*func)(&cntl, request, response, nullptr);
+        if (!cntl.Failed()) {
+            return 0;
+        }
+        // follower不可用或者不支持该请求时从leader读
+        response->Clear();
+    }
+    return SendRpcToMds(request, response, obp, func);
+}
+
 template <class T>
 void MDSClient::FillUserInfo(T* request) {
     uint64_t date = curve::common::TimeUtility::GetTimeofDayUs();
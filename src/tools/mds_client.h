@@ -88,7 +88,8 @@ using AllocMap = std::unordered_map<PoolIdType, uint64_t>;
 class MDSClient {
  public:
     MDSClient() : currentMdsIndex_(0), userName_(""),
-                  password_(""), isInited_(false) {}
+                  password_(""), isInited_(false),
+                  followerReadEnable_(false) {}
     virtual ~MDSClient() = default;
 
     /**
@@ -453,6 +454,24 @@ class MDSClient {
                             const Request*, Response*,
                             google::protobuf::Closure*));
 
+    /**
+     *  @brief 发送只读的RPC，设置了mdsFollowerReadAddr时先发给mds follower，
+     *         失败后再发给leader
+     *  @param request 要发送的request
+     *  @param[out] response 返回的response
+     *  @return 成功返回0，失败返回-1
+     */
+    template <typename T, typename Request, typename Response>
+    int SendReadRpcToMds(Request* request, Response* response, T* obp,
+                void (T::*func)(google::protobuf::RpcController*,
+                            const Request*, Response*,
+                            google::protobuf::Closure*));
+
+    /**
+     *  @brief 设置了mdsFollowerReadAddr时初始化到mds follower的channel
+     */
+    void InitFollowerChannel();
+
     /**
      *  @brief 获取server上的chunkserver的列表
      *  @param request 要发送的request
@@ -518,6 +537,10 @@ class MDSClient {
     std::string password_;
     // 避免重复初始化
     bool isInited_;
+    // 向mds follower发送只读RPC的channel
+    brpc::Channel followerChannel_;
+    // 是否先从mds follower读
+    bool followerReadEnable_;
 };
 }  // namespace tool
 }  // namespace curve
@@ -213,10 +213,13 @@ int StatusTool::ChunkServerListCmd() {
     uint64_t online = 0;
     uint64_t offline = 0;
     uint64_t unstable = 0;
+    // online状态由leader根据心跳得到，从follower读时需要自己检查
+    bool checkCSAlive = FLAGS_checkCSAlive ||
+                        !FLAGS_mdsFollowerReadAddr.empty();
     for (auto& chunkserver : chunkservers) {
         auto csId = chunkserver.chunkserverid();
         double unhealthyRatio;
-        if (FLAGS_checkCSAlive) {
+        if (checkCSAlive) {
             // 发RPC重置online状态
             std::string csAddr = chunkserver.hostip()
                         + ":" + std::to_string(chunkserver.port());
@@ -277,7 +280,7 @@ int StatusTool::ChunkServerListCmd() {
         std::cout << std::endl;
     }
     std::cout << "total: " << total << ", online: " << online;
-    if (!FLAGS_checkCSAlive) {
+    if (!checkCSAlive) {
         std::cout <<", unstable: " << unstable;
     }
     std::cout << ", offline: " << offline << std::endl;
@@ -23,6 +23,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <glog/logging.h>
+#include <sys/stat.h>
+
+#include <fstream>
 
 #include "include/client/libcurve.h"
 #include "src/chunkserver/clone_copyer.h"
@@ -195,11 +198,12 @@ TEST_F(CloneCopyerTest, BasicTest) {
 
 
         /* 用例:读s3上的数据，读取成功
-         * 预期:返回0
+         * 预期:先读取对象头部判断是否编码，未编码则直接读取，返回0
          */
         context.location = "test@s3";
         EXPECT_CALL(*s3Client_, GetObjectAsync(_))
-            .WillOnce(Invoke(
+            .Times(2)
+            .WillRepeatedly(Invoke(
                 [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
                     context->retCode = 0;
                     context->cb(s3Client_.get(), context);
@@ -292,5 +296,417 @@ TEST_F(CloneCopyerTest, DisableTest) {
     ASSERT_EQ(0, copyer.Fini());
 }
 
+TEST_F(CloneCopyerTest, SourceCacheTest) {
+    CloneSourceCacheOptions cacheOptions;
+    cacheOptions.enable = true;
+    cacheOptions.blockSize = 8192;
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = curveClient_;
+    options.s3Client = s3Client_;
+    options.sourceCache =
+        std::make_shared<CloneSourceCache>(cacheOptions, nullptr);
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(0, copyer.Init(options));
+
+    char* buf = new char[8192];
+    AsyncDownloadContext context;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:读curve上跨两个块的数据
+     * 预期:按块对齐下载两个块，并拷贝请求的部分
+     */
+    context.location = "test:0@cs";
+    context.offset = 4096;
+    context.size = 8192;
+    FileStatInfo fileInfo;
+    fileInfo.id = 1;
+    EXPECT_CALL(*curveClient_, Open4ReadOnly("test", _, true))
+        .WillOnce(Return(1));
+    EXPECT_CALL(*curveClient_, StatFile("test", _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*curveClient_, AioRead(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](int fd, CurveAioContext* context,
+                                  curve::client::UserDataType dataType) {
+            EXPECT_EQ(0, context->offset % 8192);
+            EXPECT_EQ(8192, context->length);
+            memset(context->buf, context->offset / 8192 + 1,
+                   context->length);
+            context->ret = context->length;
+            context->cb(context);
+            return LIBCURVE_ERROR::OK;
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(1, buf[0]);
+    ASSERT_EQ(1, buf[4095]);
+    ASSERT_EQ(2, buf[4096]);
+    ASSERT_EQ(2, buf[8191]);
+    closure.Reset();
+
+    /* 用例:另一个clone chunk读同一个源的相同范围
+     * 预期:从缓存读取，不再下载
+     */
+    context.location = "test:0@cs";
+    context.offset = 0;
+    context.size = 4096;
+    EXPECT_CALL(*curveClient_, AioRead(_, _, _))
+        .Times(0);
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(1, buf[0]);
+    closure.Reset();
+
+    /* 用例:读s3上的数据，下载失败
+     * 预期:返回失败，且不缓存
+     */
+    context.location = "test@s3";
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(3)
+        .WillOnce(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                context->retCode = -1;
+                context->cb(s3Client_.get(), context);
+            }))
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                context->retCode = 0;
+                context->cb(s3Client_.get(), context);
+            }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    closure.Reset();
+
+    delete [] buf;
+    EXPECT_CALL(*curveClient_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, UnInit())
+        .Times(1);
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
+TEST_F(CloneCopyerTest, SourceVersionTest) {
+    CloneSourceCacheOptions cacheOptions;
+    cacheOptions.enable = true;
+    cacheOptions.blockSize = 4096;
+    auto cache = std::make_shared<CloneSourceCache>(cacheOptions, nullptr);
+    const std::string dir = "./clone_copyer_version_test";
+    system(("rm -rf " + dir).c_str());
+    ASSERT_EQ(0, mkdir(dir.c_str(), 0755));
+
+    char* buf = new char[4096];
+    AsyncDownloadContext context;
+    context.buf = buf;
+    context.offset = 0;
+    context.size = 4096;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:curve文件被删除后以相同的文件名重新创建
+     * 预期:文件id不同，不会命中原文件的缓存
+     */
+    char fill = 1;
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillRepeatedly(Return(LIBCURVE_ERROR::OK));
+    EXPECT_CALL(*curveClient_, Open4ReadOnly("test", _, true))
+        .WillRepeatedly(Return(1));
+    EXPECT_CALL(*curveClient_, AioRead(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](int fd, CurveAioContext* context,
+                                   curve::client::UserDataType dataType) {
+            memset(context->buf, fill, context->length);
+            context->ret = context->length;
+            context->cb(context);
+            return LIBCURVE_ERROR::OK;
+        }));
+    for (uint64_t id : {1, 1, 2}) {
+        OriginCopyer copyer;
+        CopyerOptions options;
+        options.curveConf = CURVE_CONF;
+        options.curveClient = curveClient_;
+        options.s3Client = nullptr;
+        options.sourceCache = cache;
+        ASSERT_EQ(0, copyer.Init(options));
+        FileStatInfo fileInfo;
+        fileInfo.id = id;
+        EXPECT_CALL(*curveClient_, StatFile("test", _, _))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                            Return(LIBCURVE_ERROR::OK)));
+        fill = id;
+        context.location = "test:0@cs";
+        copyer.DownloadAsync(&closure);
+        ASSERT_TRUE(closure.IsRun());
+        ASSERT_FALSE(closure.IsFailed());
+        ASSERT_EQ(static_cast<char>(id), buf[0]);
+        closure.Reset();
+        EXPECT_CALL(*curveClient_, Close(1))
+            .Times(1);
+        EXPECT_CALL(*curveClient_, UnInit())
+            .Times(1);
+        ASSERT_EQ(0, copyer.Fini());
+    }
+
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.s3Conf = S3_CONF;
+    options.curveClient = nullptr;
+    options.s3Client = s3Client_;
+    options.localSnapshotDir = dir;
+    options.sourceCache = cache;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    /* 用例:本地快照对象被替换
+     * 预期:重新读取新的对象，不会命中原对象的缓存
+     */
+    context.location = "/obj-0-1@local";
+    std::ofstream(dir + "/obj-0-1", std::ios::binary)
+        << std::string(4096, 'a');
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ('a', buf[0]);
+    closure.Reset();
+    std::ofstream(dir + "/obj-0-1.tmp", std::ios::binary)
+        << std::string(4096, 'b');
+    ASSERT_EQ(0, rename((dir + "/obj-0-1.tmp").c_str(),
+                        (dir + "/obj-0-1").c_str()));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ('b', buf[0]);
+    closure.Reset();
+
+    /* 用例:s3对象被替换
+     * 预期:按原ETag的条件读失败，重试时读到新的对象，不会命中原对象的缓存
+     */
+    std::string etag = "v1";
+    fill = 1;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                if (!context->etag.empty() && context->etag != etag) {
+                    context->retCode = -1;
+                } else {
+                    memset(context->buf, fill, context->len);
+                    context->etag = etag;
+                    context->retCode = 0;
+                }
+                context->cb(s3Client_.get(), context);
+            }));
+    context.location = "obj-0-1@s3";
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(1, buf[0]);
+    closure.Reset();
+    etag = "v2";
+    fill = 2;
+    // 缓存的块在版本过期前仍可命中
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(1, buf[0]);
+    closure.Reset();
+    // 未缓存的块按原ETag读取失败
+    context.offset = 4096;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+    context.offset = 0;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(2, buf[0]);
+    closure.Reset();
+
+    delete [] buf;
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+    system(("rm -rf " + dir).c_str());
+}
+
+TEST_F(CloneCopyerTest, EncodedObjectTest) {
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveClient = nullptr;
+    options.s3Conf = S3_CONF;
+    options.s3Client = s3Client_;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 对象由全零分片、可压缩分片、不可压缩分片组成
+    std::string chunk(3 * 4096, '\0');
+    chunk.replace(4096, 4096, std::string(4096, 'a'));
+    uint32_t seed = 1;
+    for (uint32_t i = 2 * 4096; i < 3 * 4096; ++i) {
+        seed = seed * 1103515245 + 12345;
+        chunk[i] = static_cast<char>(seed >> 16);
+    }
+    std::string object;
+    ASSERT_TRUE(curve::common::ChunkCodec::EncodeChunk(chunk, 4096, &object));
+
+    auto readObject =
+        [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+            if (context->offset < object.size()) {
+                uint64_t len = std::min<uint64_t>(
+                    context->len, object.size() - context->offset);
+                memcpy(context->buf, object.data() + context->offset, len);
+            }
+            context->retCode = 0;
+            context->cb(s3Client_.get(), context);
+        };
+
+    char* buf = new char[8192];
+    AsyncDownloadContext context;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:读全零分片
+     * 预期:只读取对象头部，数据全零
+     */
+    context.location = "test@s3";
+    context.offset = 0;
+    context.size = 4096;
+    memset(buf, 1, 8192);
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(readObject));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(chunk.substr(0, 4096), std::string(buf, 4096));
+    closure.Reset();
+
+    /* 用例:读跨三个分片的数据
+     * 预期:头部已缓存，一次读取需要的存储数据并解码
+     */
+    context.offset = 2048;
+    context.size = 8192;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(readObject));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(chunk.substr(2048, 8192), std::string(buf, 8192));
+    closure.Reset();
+
+    /* 用例:读取超出对象范围
+     * 预期:返回失败
+     */
+    context.offset = 8192;
+    context.size = 8192;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(0);
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+
+    delete [] buf;
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
+TEST_F(CloneCopyerTest, LocalObjectTest) {
+    const std::string dir = "./clone_copyer_local_test";
+    system(("rm -rf " + dir).c_str());
+    ASSERT_EQ(0, mkdir(dir.c_str(), 0755));
+
+    std::string chunk(3 * 4096, '\0');
+    chunk.replace(4096, 4096, std::string(4096, 'a'));
+    uint32_t seed = 1;
+    for (uint32_t i = 2 * 4096; i < 3 * 4096; ++i) {
+        seed = seed * 1103515245 + 12345;
+        chunk[i] = static_cast<char>(seed >> 16);
+    }
+    std::string encoded;
+    ASSERT_TRUE(curve::common::ChunkCodec::EncodeChunk(chunk, 4096, &encoded));
+    std::ofstream(dir + "/raw-0-1", std::ios::binary) << chunk;
+    std::ofstream(dir + "/encoded-0-1", std::ios::binary) << encoded;
+
+    char* buf = new char[8192];
+    AsyncDownloadContext context;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:未配置本地快照目录
+     * 预期:返回失败
+     */
+    {
+        OriginCopyer copyer;
+        CopyerOptions options;
+        options.curveClient = nullptr;
+        options.s3Client = nullptr;
+        ASSERT_EQ(0, copyer.Init(options));
+        context.location = "/raw-0-1@local";
+        context.offset = 0;
+        context.size = 4096;
+        copyer.DownloadAsync(&closure);
+        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.IsFailed());
+        closure.Reset();
+        ASSERT_EQ(0, copyer.Fini());
+    }
+
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveClient = nullptr;
+    options.s3Client = nullptr;
+    options.localSnapshotDir = dir;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    /* 用例:读未编码的对象
+     * 预期:s3不参与，数据与对象一致
+     */
+    context.location = "/raw-0-1@local";
+    context.offset = 2048;
+    context.size = 8192;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(chunk.substr(2048, 8192), std::string(buf, 8192));
+    closure.Reset();
+
+    /* 用例:读编码的对象
+     * 预期:解码后的数据与原始数据一致
+     */
+    context.location = "/encoded-0-1@local";
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(chunk.substr(2048, 8192), std::string(buf, 8192));
+    closure.Reset();
+
+    /* 用例:对象不存在
+     * 预期:返回失败
+     */
+    context.location = "/notexist-0-1@local";
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+
+    delete [] buf;
+    ASSERT_EQ(0, copyer.Fini());
+    system(("rm -rf " + dir).c_str());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/clone_read_miss_reporter.h"
+
+namespace curve {
+namespace chunkserver {
+
+// reporter which records the reports instead of sending them
+class FakeCloneReadMissReporter : public CloneReadMissReporter {
+ public:
+    explicit FakeCloneReadMissReporter(
+        const CloneReadMissReporterOptions& options)
+        : CloneReadMissReporter(options) {}
+
+    bool Send(const std::string& addr, const std::string& body) override {
+        sentAddrs.push_back(addr);
+        if (failedAddrs.count(addr) > 0) {
+            return false;
+        }
+        bodies.push_back(body);
+        return true;
+    }
+
+    std::map<uint64_t, uint32_t> ParseLastBody() {
+        std::map<uint64_t, uint32_t> misses;
+        Json::Reader reader;
+        Json::Value value;
+        EXPECT_TRUE(reader.parse(bodies.back(), value));
+        for (const auto& item : value["ReadMiss"]) {
+            misses[item["ChunkId"].asUInt64()] = item["Count"].asUInt();
+        }
+        return misses;
+    }
+
+    std::set<std::string> failedAddrs;
+    std::vector<std::string> sentAddrs;
+    std::vector<std::string> bodies;
+};
+
+TEST(CloneReadMissReporterTest, RecordAndReportTest) {
+    CloneReadMissReporterOptions options;
+    options.addrs = {"127.0.0.1:5555"};
+    options.maxChunks = 2;
+    FakeCloneReadMissReporter reporter(options);
+
+    // nothing to report
+    reporter.ReportOnce();
+    ASSERT_TRUE(reporter.sentAddrs.empty());
+
+    reporter.Record(1);
+    reporter.Record(1);
+    reporter.Record(2);
+    // exceeds max chunks, dropped
+    reporter.Record(3);
+    // chunk already recorded is still counted
+    reporter.Record(2);
+    reporter.ReportOnce();
+    ASSERT_EQ(1, reporter.bodies.size());
+    std::map<uint64_t, uint32_t> misses = reporter.ParseLastBody();
+    ASSERT_EQ(2, misses.size());
+    ASSERT_EQ(2, misses[1]);
+    ASSERT_EQ(2, misses[2]);
+
+    // misses are cleared after reporting
+    reporter.ReportOnce();
+    ASSERT_EQ(1, reporter.bodies.size());
+    reporter.Record(3);
+    reporter.ReportOnce();
+    ASSERT_EQ(2, reporter.bodies.size());
+    misses = reporter.ParseLastBody();
+    ASSERT_EQ(1, misses.size());
+    ASSERT_EQ(1, misses[3]);
+}
+
+TEST(CloneReadMissReporterTest, FailoverTest) {
+    CloneReadMissReporterOptions options;
+    options.addrs = {"127.0.0.1:5555", "127.0.0.1:5556"};
+    FakeCloneReadMissReporter reporter(options);
+
+    // the first server fails, the report goes to the second one
+    reporter.failedAddrs.insert("127.0.0.1:5555");
+    reporter.Record(1);
+    reporter.ReportOnce();
+    ASSERT_EQ(2, reporter.sentAddrs.size());
+    ASSERT_EQ(1, reporter.bodies.size());
+
+    // the next report starts from the server accepted the last one
+    reporter.sentAddrs.clear();
+    reporter.Record(1);
+    reporter.ReportOnce();
+    ASSERT_EQ(1, reporter.sentAddrs.size());
+    ASSERT_EQ("127.0.0.1:5556", reporter.sentAddrs[0]);
+
+    // all servers fail, the misses are dropped
+    reporter.failedAddrs.insert("127.0.0.1:5556");
+    reporter.Record(1);
+    reporter.ReportOnce();
+    ASSERT_EQ(2, reporter.bodies.size());
+    reporter.failedAddrs.clear();
+    reporter.ReportOnce();
+    ASSERT_EQ(2, reporter.bodies.size());
+}
+
+TEST(CloneReadMissReporterTest, RunTest) {
+    CloneReadMissReporterOptions options;
+    FakeCloneReadMissReporter noAddrReporter(options);
+    ASSERT_EQ(-1, noAddrReporter.Run());
+
+    options.addrs = {"127.0.0.1:5555"};
+    options.intervalMs = 10;
+    FakeCloneReadMissReporter reporter(options);
+    ASSERT_EQ(0, reporter.Run());
+    ASSERT_EQ(-1, reporter.Run());
+    ASSERT_EQ(0, reporter.Fini());
+    ASSERT_EQ(0, reporter.Fini());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
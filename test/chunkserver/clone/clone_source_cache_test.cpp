@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/clone_source_cache.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFsFactory;
+using curve::fs::FileSystemType;
+
+const char kCacheDir[] = "./clone_source_cache_test";
+const uint32_t kBlockSize = 4096;
+
+class CloneSourceCacheTest : public testing::Test {
+ public:
+    void SetUp() {
+        fs_ = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+        ::system((std::string("rm -rf ") + kCacheDir).c_str());
+    }
+
+    void TearDown() {
+        ::system((std::string("rm -rf ") + kCacheDir).c_str());
+    }
+
+    // loader which fills the block with c and records the times called
+    CloneSourceCache::Loader MakeLoader(char c, int ret, int* count) {
+        return [c, ret, count](char* buf, size_t size,
+                               const CloneSourceCache::LoadDone& done) {
+            ++(*count);
+            memset(buf, c, size);
+            done(ret);
+        };
+    }
+
+ protected:
+    std::shared_ptr<curve::fs::LocalFileSystem> fs_;
+};
+
+TEST_F(CloneSourceCacheTest, MemoryTest) {
+    CloneSourceCacheOptions options;
+    options.enable = true;
+    options.blockSize = kBlockSize;
+    options.memoryCapacity = 2 * kBlockSize;
+    CloneSourceCache cache(options, fs_);
+    ASSERT_EQ(0, cache.Init());
+
+    int count = 0;
+    int result = -1;
+    CloneSourceCache::Block got;
+    auto done = [&](int ret, const CloneSourceCache::Block& block) {
+        result = ret;
+        got = block;
+    };
+
+    // miss, download once
+    cache.GetBlock("a", MakeLoader('a', 0, &count), done);
+    ASSERT_EQ(0, result);
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(std::string(kBlockSize, 'a'), *got);
+
+    // hit, no more download
+    cache.GetBlock("a", MakeLoader('x', 0, &count), done);
+    ASSERT_EQ(0, result);
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(std::string(kBlockSize, 'a'), *got);
+
+    // failed download is not cached
+    cache.GetBlock("b", MakeLoader('b', -1, &count), done);
+    ASSERT_EQ(-1, result);
+    ASSERT_EQ(2, count);
+    cache.GetBlock("b", MakeLoader('b', 0, &count), done);
+    ASSERT_EQ(0, result);
+    ASSERT_EQ(3, count);
+
+    // "a" is evicted by "c" as the capacity is two blocks
+    cache.GetBlock("b", MakeLoader('b', 0, &count), done);
+    cache.GetBlock("c", MakeLoader('c', 0, &count), done);
+    ASSERT_EQ(4, count);
+    cache.GetBlock("a", MakeLoader('a', 0, &count), done);
+    ASSERT_EQ(5, count);
+}
+
+TEST_F(CloneSourceCacheTest, SingleFlightTest) {
+    CloneSourceCacheOptions options;
+    options.enable = true;
+    options.blockSize = kBlockSize;
+    CloneSourceCache cache(options, fs_);
+    ASSERT_EQ(0, cache.Init());
+
+    // the download is finished after all the requests arrive
+    int count = 0;
+    CloneSourceCache::LoadDone pending;
+    auto loader = [&](char* buf, size_t size,
+                      const CloneSourceCache::LoadDone& done) {
+        ++count;
+        memset(buf, 'a', size);
+        pending = done;
+    };
+
+    std::vector<int> results;
+    auto done = [&](int ret, const CloneSourceCache::Block& block) {
+        results.push_back(ret);
+        ASSERT_EQ(std::string(kBlockSize, 'a'), *block);
+    };
+    for (int i = 0; i < 10; ++i) {
+        cache.GetBlock("a", loader, done);
+    }
+    ASSERT_EQ(1, count);
+    ASSERT_TRUE(results.empty());
+
+    pending(0);
+    ASSERT_EQ(10, results.size());
+    for (int ret : results) {
+        ASSERT_EQ(0, ret);
+    }
+}
+
+TEST_F(CloneSourceCacheTest, DiskTest) {
+    CloneSourceCacheOptions options;
+    options.enable = true;
+    options.blockSize = kBlockSize;
+    // keep nothing in memory, so the blocks are read from disk
+    options.memoryCapacity = 0;
+    options.diskCacheDir = kCacheDir;
+    options.diskCapacity = 2 * (kBlockSize + 64);
+    CloneSourceCache cache(options, fs_);
+    ASSERT_EQ(0, cache.Init());
+
+    int count = 0;
+    int result = -1;
+    CloneSourceCache::Block got;
+    auto done = [&](int ret, const CloneSourceCache::Block& block) {
+        result = ret;
+        got = block;
+    };
+
+    cache.GetBlock("a", MakeLoader('a', 0, &count), done);
+    ASSERT_EQ(1, count);
+    // wait for the block to be written to disk
+    for (int i = 0; i < 100; ++i) {
+        std::vector<std::string> names;
+        fs_->List(kCacheDir, &names);
+        if (names.size() == 1 && names[0].find(".tmp") == std::string::npos) {
+            break;
+        }
+        ::usleep(10 * 1000);
+    }
+
+    cache.GetBlock("a", MakeLoader('x', 0, &count), done);
+    ASSERT_EQ(0, result);
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(std::string(kBlockSize, 'a'), *got);
+
+    // the files left are dropped by Init
+    cache.Fini();
+    CloneSourceCache cache2(options, fs_);
+    ASSERT_EQ(0, cache2.Init());
+    std::vector<std::string> names;
+    ASSERT_EQ(0, fs_->List(kCacheDir, &names));
+    ASSERT_TRUE(names.empty());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -310,6 +310,158 @@ TEST_F(OpRequestTest, CreateCloneTest) {
     closure->Release();
 }
 
+TEST_F(OpRequestTest, CreateCloneBatchTest) {
+    // 创建CreateCloneChunkBatchRequest
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint32_t size = CHUNK_SIZE;
+    uint64_t sn = 1;
+    string location("test@cs");
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(1);
+    request->set_optype(CHUNK_OP_CREATE_CLONE_BATCH);
+    for (uint64_t chunkId = 1; chunkId <= 3; chunkId++) {
+        CloneChunkDesc* desc = request->add_clonechunks();
+        desc->set_chunkid(chunkId);
+        desc->set_location(location);
+        desc->set_size(size);
+        desc->set_sn(sn);
+    }
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<CreateCloneChunkBatchRequest> opReq =
+        std::make_shared<CreateCloneChunkBatchRequest>(node_,
+                                                       cntl,
+                                                       request,
+                                                       response,
+                                                       closure);
+    /**
+     * 测试Encode/Decode
+     */
+    {
+        butil::IOBuf log;
+        ASSERT_EQ(0, opReq->Encode(request, &cntl->request_attachment(), &log));
+
+        ChunkRequest decodeRequest;
+        butil::IOBuf data;
+        auto req = ChunkOpRequest::Decode(log, &decodeRequest, &data);
+        auto req1 = dynamic_cast<CreateCloneChunkBatchRequest*>(req.get());
+        ASSERT_TRUE(req1 != nullptr);
+
+        ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH,
+                  decodeRequest.optype());
+        ASSERT_EQ(3, decodeRequest.clonechunks_size());
+        ASSERT_EQ(3, decodeRequest.clonechunks(2).chunkid());
+        ASSERT_EQ(location, decodeRequest.clonechunks(2).location());
+    }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == true
+     * 预期： 整个批量只Propose一次
+     */
+    {
+        braft::Task task;
+        EXPECT_CALL(*node_, Propose(_))
+            .WillOnce(SaveArg<0>(&task));
+
+        opReq->Process();
+
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_NE(nullptr, task.done);
+        task.done->Run();
+        ASSERT_TRUE(closure->isDone_);
+    }
+    /**
+     * 测试OnApply
+     * 用例：一个chunk已存在，其他chunk创建成功
+     * 预期：返回 CHUNK_OP_STATUS_SUCCESS，并返回每个chunk的状态
+     */
+    {
+        closure->Reset();
+        response->Clear();
+
+        EXPECT_CALL(*datastore_, CreateCloneChunk(_, _, _, _, _))
+            .WillOnce(Return(CSErrorCode::Success))
+            .WillOnce(Return(CSErrorCode::ChunkConflictError))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(1);
+
+        opReq->OnApply(3, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response->status());
+        ASSERT_EQ(3, response->chunkstatus_size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response->chunkstatus(0));
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_EXIST,
+                  response->chunkstatus(1));
+    }
+    /**
+     * 测试OnApply
+     * 用例：一个chunk创建失败,返回其他错误
+     * 预期：返回 CHUNK_OP_STATUS_FAILURE_UNKNOWN，不更新apply index
+     */
+    {
+        closure->Reset();
+        response->Clear();
+
+        EXPECT_CALL(*datastore_, CreateCloneChunk(_, _, _, _, _))
+            .WillOnce(Return(CSErrorCode::Success))
+            .WillOnce(Return(CSErrorCode::InvalidArgError))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(3, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
+                  response->status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
+                  response->chunkstatus(1));
+    }
+    /**
+     * 测试OnApply
+     * 用例：CreateCloneChunk失败，返回InternalError
+     * 预期：进程退出
+     */
+    {
+        closure->Reset();
+
+        EXPECT_CALL(*datastore_, CreateCloneChunk(_, _, _, _, _))
+            .WillRepeatedly(Return(CSErrorCode::InternalError));
+
+        ASSERT_DEATH(opReq->OnApply(3, closure), "");
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：所有chunk创建成功或已存在
+     * 预期：每个chunk都创建一次
+     */
+    {
+        closure->Reset();
+
+        EXPECT_CALL(*datastore_, CreateCloneChunk(_, _, _, _, _))
+            .WillOnce(Return(CSErrorCode::Success))
+            .WillOnce(Return(CSErrorCode::ChunkConflictError))
+            .WillOnce(Return(CSErrorCode::Success));
+
+        butil::IOBuf data;
+        opReq->OnApplyFromLog(datastore_, *request, data);
+    }
+    // 释放资源
+    closure->Release();
+}
+
 TEST_F(OpRequestTest, PasteChunkTest) {
     // 生成临时的readrequest
     ChunkResponse *response = new ChunkResponse();
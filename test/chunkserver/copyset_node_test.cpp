@@ -222,6 +222,39 @@ TEST_F(CopysetNodeTest, error_test) {
         copysetNode.on_snapshot_save(&writer, &closure);
         LOG(INFO) << closure.status().error_cstr();
     }
+    // on_snapshot_save: sync dirty chunks failed
+    {
+        LogicPoolID logicPoolID = 123;
+        CopysetID copysetID = 1345;
+        Configuration conf;
+
+        CopysetNode copysetNode(logicPoolID, copysetID, conf);
+        ASSERT_EQ(0, copysetNode.Init(defaultOptions_));
+        FakeClosure closure;
+        FakeSnapshotWriter writer;
+        std::shared_ptr<MockLocalFileSystem>
+            mockfs = std::make_shared<MockLocalFileSystem>();
+        std::unique_ptr<ConfEpochFile>
+            epochFile(new ConfEpochFile(mockfs));
+        DataStoreOptions options;
+        options.baseDir = "./test-temp";
+        options.chunkSize = 16 * 1024 * 1024;
+        options.pageSize = 4 * 1024;
+        std::shared_ptr<FakeCSDataStore> dataStore =
+            std::make_shared<FakeCSDataStore>(options, fs);
+        dataStore->InjectError();
+
+        copysetNode.SetLocalFileSystem(mockfs);
+        copysetNode.SetConfEpochFile(std::move(epochFile));
+        copysetNode.SetCSDateStore(dataStore);
+        // 快照不会保存，raft日志不会被截断
+        EXPECT_CALL(*mockfs, Open(_, _)).Times(0);
+        EXPECT_CALL(*mockfs, List(_, _)).Times(0);
+
+        copysetNode.on_snapshot_save(&writer, &closure);
+        ASSERT_FALSE(closure.status().ok());
+        LOG(INFO) << closure.status().error_cstr();
+    }
     // on_snapshot_save: success
     {
         LogicPoolID logicPoolID = 123;
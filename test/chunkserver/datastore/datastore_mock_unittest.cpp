@@ -85,6 +85,7 @@ const char location[] = "/file1/0@curve";
 const int UT_ERRNO = 1234;
 
 bool hasCreatFlag(int flag) {return flag & O_CREAT;}
+bool hasDsyncFlag(int flag) {return flag & O_DSYNC;}
 
 ACTION_TEMPLATE(SetVoidArrayArgument,
                 HAS_1_TEMPLATE_PARAMS(int, k),
@@ -4127,5 +4128,131 @@ TEST_F(CSDataStore_test, GetStatusTest) {
         .Times(1);
 }
 
+/**
+ * SyncDirtyChunksTest
+ * case:chunk文件以O_DSYNC方式打开
+ * 预期结果:不需要sync chunk文件
+ */
+TEST_F(CSDataStore_test, SyncDirtyChunksTest1) {
+    // initialize
+    FakeEnv();
+    EXPECT_CALL(*lfs_, Open(chunk2Path, Truly(hasDsyncFlag)))
+        .WillOnce(Return(3));
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 2;
+    SequenceNum sn = 2;
+    char buf[PAGE_SIZE];  // NOLINT
+    memset(buf, 0, sizeof(buf));
+    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE, PAGE_SIZE))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
+                                                          sn,
+                                                          buf,
+                                                          0,
+                                                          PAGE_SIZE,
+                                                          nullptr));
+    EXPECT_CALL(*lfs_, Fdatasync(_))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
+/**
+ * SyncDirtyChunksTest
+ * case:chunk文件不以O_DSYNC方式打开
+ * 预期结果:只sync写过的chunk文件，sync失败的chunk在下次重试
+ */
+TEST_F(CSDataStore_test, SyncDirtyChunksTest2) {
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.enableOdsyncWhenOpenChunkFile = false;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+
+    // initialize
+    FakeEnv();
+    EXPECT_CALL(*lfs_, Open(chunk1Path, Truly(hasDsyncFlag)))
+        .Times(0);
+    EXPECT_CALL(*lfs_, Open(chunk2Path, Truly(hasDsyncFlag)))
+        .Times(0);
+    EXPECT_TRUE(dataStore->Initialize());
+
+    // 没有写过的chunk
+    EXPECT_CALL(*lfs_, Fdatasync(_))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+
+    ChunkID id = 2;
+    SequenceNum sn = 2;
+    char buf[PAGE_SIZE];  // NOLINT
+    memset(buf, 0, sizeof(buf));
+    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE, PAGE_SIZE))
+        .Times(2);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
+                                                          sn,
+                                                          buf,
+                                                          0,
+                                                          PAGE_SIZE,
+                                                          nullptr));
+    EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
+                                                          sn,
+                                                          buf,
+                                                          0,
+                                                          PAGE_SIZE,
+                                                          nullptr));
+    // 多次写入只sync一次
+    EXPECT_CALL(*lfs_, Fdatasync(3))
+        .WillOnce(Return(0));
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+    EXPECT_CALL(*lfs_, Fdatasync(_))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+
+    // sync失败，下次重试
+    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE, PAGE_SIZE))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
+                                                          sn,
+                                                          buf,
+                                                          0,
+                                                          PAGE_SIZE,
+                                                          nullptr));
+    EXPECT_CALL(*lfs_, Fdatasync(3))
+        .WillOnce(Return(-UT_ERRNO))
+        .WillOnce(Return(0));
+    EXPECT_EQ(CSErrorCode::InternalError, dataStore->SyncDirtyChunks());
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+
+    // 删除的chunk不需要sync
+    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_), PAGE_SIZE, PAGE_SIZE))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->WriteChunk(id,
+                                                          sn,
+                                                          buf,
+                                                          0,
+                                                          PAGE_SIZE,
+                                                          nullptr));
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->DeleteChunk(id, sn));
+    EXPECT_CALL(*lfs_, Fdatasync(_))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncDirtyChunks());
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -204,6 +204,10 @@ class FakeCSDataStore : public CSDataStore {
         }
     }
 
+    CSErrorCode SyncDirtyChunks() override {
+        return HasInjectError();
+    }
+
     void InjectError(CSErrorCode errorCode = CSErrorCode::InternalError) {
         error_ = errorCode;
     }
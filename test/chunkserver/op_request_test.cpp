@@ -25,8 +25,11 @@
 #include <butil/sys_byteorder.h>
 #include <brpc/controller.h>
 
+#include <map>
+#include <mutex>  // NOLINT
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/chunkserver/copyset_node.h"
@@ -38,6 +41,7 @@ namespace curve {
 namespace chunkserver {
 
 using ::google::protobuf::io::ZeroCopyOutputStream;
+using ::curve::chunkserver::concurrent::ConcurrentApplyOption;
 
 class OpFakeClosure : public Closure {
  public:
@@ -603,6 +607,351 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
     }
 }
 
+TEST(ChunkOpRequestTest, WriteChunkBulkTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint32_t size = 4096;
+    uint64_t sn = 1;
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    request.set_chunkid(1);
+    request.set_size(2 * size);
+    // 两个chunk上的数据按顺序拼接在attachment中
+    for (uint64_t chunkId = 1; chunkId <= 2; chunkId++) {
+        CloneChunkDesc *desc = request.add_clonechunks();
+        desc->set_chunkid(chunkId);
+        desc->set_sn(sn);
+        desc->set_offset((chunkId - 1) * size);
+        desc->set_size(size);
+    }
+    std::string str = std::string(size, 'a') + std::string(size, 'b');
+    brpc::Controller *cntl = new brpc::Controller();
+    cntl->request_attachment().append(str.c_str(), str.size());
+
+    Configuration conf;
+    std::shared_ptr<CopysetNode> nodePtr =
+        std::make_shared<CopysetNode>(logicPoolId, copysetId, conf);
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.pageSize = 4 * 1024;
+    std::shared_ptr<FakeCSDataStore> dataStore =
+        std::make_shared<FakeCSDataStore>(options, fs);
+    nodePtr->SetCSDateStore(dataStore);
+
+    ChunkOpRequest *opReq = new WriteChunkBulkRequest(nodePtr,
+                                                      cntl,
+                                                      &request,
+                                                      nullptr,
+                                                      nullptr);
+    butil::IOBuf log;
+    ASSERT_EQ(0, opReq->Encode(&request, &cntl->request_attachment(), &log));
+
+    ChunkRequest decodeRequest;
+    butil::IOBuf data;
+    auto req = ChunkOpRequest::Decode(log, &decodeRequest, &data);
+    ASSERT_TRUE(dynamic_cast<WriteChunkBulkRequest*>(req.get()) != nullptr);
+    ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK, decodeRequest.optype());
+    ASSERT_EQ(2, decodeRequest.clonechunks_size());
+    ASSERT_EQ(str, data.to_string());
+
+    // 不存在的chunk由写入创建
+    req->OnApplyFromLog(dataStore, decodeRequest, data);
+    ASSERT_FALSE(dataStore->HasInjectError());
+    char buf[4096];
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(1, sn, buf, 0, size));
+    ASSERT_EQ(std::string(size, 'a'), std::string(buf, size));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, sn, buf, size, size));
+    ASSERT_EQ(std::string(size, 'b'), std::string(buf, size));
+
+    delete opReq;
+    delete cntl;
+}
+
+// record the ops applied on every chunk in order, ops are serialized since
+// FakeCSDataStore is not thread safe
+class OrderRecordDataStore : public FakeCSDataStore {
+ public:
+    OrderRecordDataStore(DataStoreOptions options,
+                         std::shared_ptr<LocalFileSystem> fs) :
+        FakeCSDataStore(options, fs) {}
+
+    CSErrorCode CreateCloneChunk(ChunkID id,
+                                 SequenceNum sn,
+                                 SequenceNum correctedSn,
+                                 ChunkSizeType size,
+                                 const string& location) override {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ops_[id].push_back("create");
+        return FakeCSDataStore::CreateCloneChunk(id, sn, correctedSn,
+                                                 size, location);
+    }
+
+    CSErrorCode WriteChunk(ChunkID id,
+                           SequenceNum sn,
+                           const butil::IOBuf& buf,
+                           off_t offset,
+                           size_t length,
+                           uint32_t *cost,
+                           const std::string & csl = "") override {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ops_[id].push_back("write");
+        return FakeCSDataStore::WriteChunk(id, sn, buf, offset,
+                                           length, cost, csl);
+    }
+
+    std::vector<std::string> Ops(ChunkID id) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return ops_[id];
+    }
+
+ private:
+    std::mutex mtx_;
+    std::map<ChunkID, std::vector<std::string>> ops_;
+};
+
+TEST(ChunkOpRequestTest, CreateCloneChunkBatchApplyOrderTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint32_t size = 4096;
+    uint64_t sn = 1;
+
+    Configuration conf;
+    std::shared_ptr<CopysetNode> nodePtr =
+        std::make_shared<CopysetNode>(logicPoolId, copysetId, conf);
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.pageSize = 4 * 1024;
+    std::shared_ptr<OrderRecordDataStore> dataStore =
+        std::make_shared<OrderRecordDataStore>(options, fs);
+    nodePtr->SetCSDateStore(dataStore);
+
+    // chunk 1 and chunk 2 are hashed to different write queues
+    ConcurrentApplyModule applyModule;
+    ConcurrentApplyOption opt{3, 16, 1, 16};
+    ASSERT_TRUE(applyModule.Init(opt));
+
+    // batch entry creating chunk 1 and 2, the first chunk is chunk 1
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    request.set_chunkid(1);
+    for (uint64_t chunkId = 1; chunkId <= 2; chunkId++) {
+        CloneChunkDesc *desc = request.add_clonechunks();
+        desc->set_chunkid(chunkId);
+        desc->set_sn(sn);
+        desc->set_location("test@cs");
+        desc->set_size(options.chunkSize);
+    }
+    butil::IOBuf batchLog;
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&request, nullptr, &batchLog));
+
+    // a later user write on chunk 2, the second chunk of the batch
+    ChunkRequest writeRequest;
+    writeRequest.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    writeRequest.set_logicpoolid(logicPoolId);
+    writeRequest.set_copysetid(copysetId);
+    writeRequest.set_chunkid(2);
+    writeRequest.set_offset(0);
+    writeRequest.set_size(size);
+    writeRequest.set_sn(sn);
+    std::string userData(size, 'c');
+    butil::IOBuf writeData;
+    writeData.append(userData.c_str(), userData.size());
+    butil::IOBuf writeLog;
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&writeRequest, &writeData, &writeLog));
+
+    /**
+     * 用例：回放日志时，batch之后的用户写落在batch中非第一个chunk上，
+     *      且第一个chunk所在的队列被阻塞
+     * 预期：chunk 2先由batch创建为clone chunk，之后才apply用户写
+     */
+    CountDownEvent blocked(1);
+    applyModule.Push(1, CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+                     [&blocked]() { blocked.Wait(); });
+
+    ChunkRequest decodeRequest;
+    butil::IOBuf data;
+    auto batchReq = ChunkOpRequest::Decode(batchLog, &decodeRequest, &data);
+    ASSERT_TRUE(batchReq != nullptr);
+    batchReq->ScheduleApplyFromLog(&applyModule, dataStore,
+                                   decodeRequest, data);
+
+    ChunkRequest decodeWrite;
+    butil::IOBuf decodeData;
+    auto writeReq = ChunkOpRequest::Decode(writeLog, &decodeWrite,
+                                           &decodeData);
+    ASSERT_TRUE(writeReq != nullptr);
+    writeReq->ScheduleApplyFromLog(&applyModule, dataStore,
+                                   decodeWrite, decodeData);
+
+    blocked.Signal();
+    applyModule.Flush();
+    ASSERT_EQ(std::vector<std::string>({"create"}), dataStore->Ops(1));
+    ASSERT_EQ(std::vector<std::string>({"create", "write"}),
+              dataStore->Ops(2));
+
+    applyModule.Stop();
+}
+
+class CountFakeClosure : public Closure {
+ public:
+    CountFakeClosure() : runCount(0) {}
+    void Run() { runCount++; }
+    ~CountFakeClosure() {}
+
+    std::atomic<int> runCount;
+};
+
+TEST(ChunkOpRequestTest, WriteChunkBulkApplyOrderTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint32_t size = 4096;
+    uint64_t sn = 1;
+
+    Configuration conf;
+    std::shared_ptr<CopysetNode> nodePtr =
+        std::make_shared<CopysetNode>(logicPoolId, copysetId, conf);
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.pageSize = 4 * 1024;
+    std::shared_ptr<OrderRecordDataStore> dataStore =
+        std::make_shared<OrderRecordDataStore>(options, fs);
+    nodePtr->SetCSDateStore(dataStore);
+
+    // chunk 1 and chunk 2 are hashed to different write queues
+    ConcurrentApplyModule applyModule;
+    ConcurrentApplyOption opt{3, 16, 1, 16};
+    ASSERT_TRUE(applyModule.Init(opt));
+
+    // bulk entry on chunk 1 and 2, the first chunk is chunk 1
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE_BULK);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    request.set_chunkid(1);
+    request.set_size(2 * size);
+    for (uint64_t chunkId = 1; chunkId <= 2; chunkId++) {
+        CloneChunkDesc *desc = request.add_clonechunks();
+        desc->set_chunkid(chunkId);
+        desc->set_sn(sn);
+        desc->set_offset((chunkId - 1) * size);
+        desc->set_size(size);
+    }
+    std::string str = std::string(size, 'a') + std::string(size, 'b');
+    brpc::Controller *cntl = new brpc::Controller();
+    cntl->request_attachment().append(str.c_str(), str.size());
+    butil::IOBuf bulkLog;
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&request,
+                                        &cntl->request_attachment(),
+                                        &bulkLog));
+
+    // a later user write on chunk 2, the second chunk of the bulk
+    ChunkRequest writeRequest;
+    writeRequest.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    writeRequest.set_logicpoolid(logicPoolId);
+    writeRequest.set_copysetid(copysetId);
+    writeRequest.set_chunkid(2);
+    writeRequest.set_offset(size);
+    writeRequest.set_size(size);
+    writeRequest.set_sn(sn);
+    std::string userData(size, 'c');
+    butil::IOBuf writeData;
+    writeData.append(userData.c_str(), userData.size());
+    butil::IOBuf writeLog;
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&writeRequest, &writeData, &writeLog));
+
+    char buf[4096];
+    /**
+     * 用例：回放日志时，bulk之后的用户写落在bulk中非第一个chunk上，
+     *      且第一个chunk所在的队列被阻塞
+     * 预期：用户写在bulk写入该chunk之后apply，不会被bulk覆盖
+     */
+    {
+        CountDownEvent blocked(1);
+        applyModule.Push(1, CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+                         [&blocked]() { blocked.Wait(); });
+
+        ChunkRequest decodeRequest;
+        butil::IOBuf data;
+        auto bulkReq = ChunkOpRequest::Decode(bulkLog, &decodeRequest, &data);
+        ASSERT_TRUE(bulkReq != nullptr);
+        bulkReq->ScheduleApplyFromLog(&applyModule, dataStore,
+                                      decodeRequest, data);
+
+        ChunkRequest decodeWrite;
+        butil::IOBuf decodeData;
+        auto writeReq = ChunkOpRequest::Decode(writeLog, &decodeWrite,
+                                               &decodeData);
+        ASSERT_TRUE(writeReq != nullptr);
+        writeReq->ScheduleApplyFromLog(&applyModule, dataStore,
+                                       decodeWrite, decodeData);
+
+        blocked.Signal();
+        applyModule.Flush();
+        ASSERT_FALSE(dataStore->HasInjectError());
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(1, sn, buf, 0, size));
+        ASSERT_EQ(std::string(size, 'a'), std::string(buf, size));
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(2, sn, buf, size, size));
+        ASSERT_EQ(userData, std::string(buf, size));
+    }
+    /**
+     * 用例：leader上apply bulk，第一个chunk所在的队列被阻塞
+     * 预期：其他chunk先写入，最后一个chunk写入后才返回
+     */
+    {
+        ChunkResponse response;
+        CountFakeClosure done;
+        std::shared_ptr<ChunkOpRequest> bulkReq =
+            std::make_shared<WriteChunkBulkRequest>(nodePtr,
+                                                    cntl,
+                                                    &request,
+                                                    &response,
+                                                    nullptr);
+        CountDownEvent blocked(1);
+        applyModule.Push(1, CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+                         [&blocked]() { blocked.Wait(); });
+        bulkReq->ScheduleApply(&applyModule, 5, &done);
+
+        // wait the task of chunk 2 by another task on its queue
+        CountDownEvent chunk2Applied(1);
+        applyModule.Push(2, CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+                         [&chunk2Applied]() { chunk2Applied.Signal(); });
+        chunk2Applied.Wait();
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(2, sn, buf, size, size));
+        ASSERT_EQ(std::string(size, 'b'), std::string(buf, size));
+        ASSERT_EQ(0, done.runCount.load());
+
+        blocked.Signal();
+        applyModule.Flush();
+        ASSERT_EQ(1, done.runCount.load());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(2, response.chunkstatus_size());
+        ASSERT_EQ(5, response.appliedindex());
+        ASSERT_EQ(5, nodePtr->GetAppliedIndex());
+    }
+
+    applyModule.Stop();
+    delete cntl;
+}
+
 TEST(ChunkOpRequestTest, OnApplyFromLogTest) {
     LogicPoolID logicPoolId = 1;
     CopysetID copysetId = 10001;
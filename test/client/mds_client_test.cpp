@@ -417,5 +417,61 @@ TEST_F(MDSClientTest, TestOpenFile) {
     }
 }
 
+TEST_F(MDSClientTest, TestListSnapshotSegment) {
+    UserInfo userInfo;
+    const std::string fileName = "/TestListSnapshotSegment";
+    std::vector<SegmentInfo> segInfos;
+    uint64_t nextOffset = 0;
+
+    // 未升级的mds没有ListSegment，直接返回不支持，不进行重试
+    {
+        EXPECT_CALL(mockNameService_, ListSegment(_, _, _, _))
+            .WillOnce(Invoke(
+                [](google::protobuf::RpcController* cntl_base,
+                   const curve::mds::ListSegmentRequest* request,
+                   curve::mds::ListSegmentResponse* response,
+                   google::protobuf::Closure* done) {
+                    brpc::ClosureGuard doneGuard(done);
+                    brpc::Controller* cntl =
+                        static_cast<brpc::Controller*>(cntl_base);
+                    cntl->SetFailed(brpc::ENOMETHOD, "Fail to find method");
+                }));
+
+        auto startMs = TimeUtility::GetTimeofDayMs();
+        ASSERT_EQ(LIBCURVE_ERROR::NOT_SUPPORT,
+                  mdsClient_.ListSnapshotSegment(fileName, userInfo, 1, 0, 16,
+                                                 &segInfos, &nextOffset));
+        auto endMs = TimeUtility::GetTimeofDayMs();
+        ASSERT_GT(option_.mdsMaxRetryMS, endMs - startMs);
+    }
+
+    // mds返回一页segment
+    {
+        curve::mds::ListSegmentResponse response;
+        response.set_statuscode(curve::mds::StatusCode::kOK);
+        response.set_segmentsize(kGiB);
+        response.set_chunksize(16 * 1024 * 1024);
+        auto packed = response.add_segments();
+        packed->set_startoffset(kGiB);
+        packed->set_logicalpoolid(1);
+        packed->add_chunkid(100);
+        packed->add_copysetid(10);
+
+        EXPECT_CALL(mockNameService_, ListSegment(_, _, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<2>(response),
+                Invoke(FakeRpcService<curve::mds::ListSegmentRequest,
+                                      curve::mds::ListSegmentResponse>)));
+
+        ASSERT_EQ(LIBCURVE_ERROR::OK,
+                  mdsClient_.ListSnapshotSegment(fileName, userInfo, 1, 0, 16,
+                                                 &segInfos, &nextOffset));
+        ASSERT_EQ(1, segInfos.size());
+        ASSERT_EQ(kGiB, segInfos[0].startoffset);
+        ASSERT_EQ(100, segInfos[0].chunkvec[0].cid_);
+        ASSERT_EQ(0, nextOffset);
+    }
+}
+
 }  // namespace client
 }  // namespace curve
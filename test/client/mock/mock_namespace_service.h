@@ -52,6 +52,11 @@ class MockNameService : public CurveFSService {
                                   const ChangeOwnerRequest* request,
                                   ChangeOwnerResponse* response,
                                   google::protobuf::Closure* done));
+
+    MOCK_METHOD4(ListSegment, void(google::protobuf::RpcController* cntl,
+                                   const ListSegmentRequest* request,
+                                   ListSegmentResponse* response,
+                                   google::protobuf::Closure* done));
 };
 
 }  // namespace mds
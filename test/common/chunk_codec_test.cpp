@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/common/chunk_codec.h"
+
+namespace curve {
+namespace common {
+
+TEST(ChunkCodecTest, IsZeroTest) {
+    std::string buf(4099, '\0');
+    ASSERT_TRUE(ChunkCodec::IsZero(buf.data(), buf.size()));
+    buf[4098] = 1;
+    ASSERT_FALSE(ChunkCodec::IsZero(buf.data(), buf.size()));
+    buf[4098] = 0;
+    buf[17] = 1;
+    ASSERT_FALSE(ChunkCodec::IsZero(buf.data(), buf.size()));
+}
+
+TEST(ChunkCodecTest, EncodeSplitTest) {
+    std::string out;
+    // 全零分片不存储数据
+    std::string zero(4096, '\0');
+    EncodedSplit split = ChunkCodec::EncodeSplit(zero.data(), 4096, &out);
+    ASSERT_EQ(SplitEncodeType::kZero, split.type);
+    ASSERT_EQ(0, split.storedLen);
+
+    // 可压缩的分片
+    std::string same(4096, 'a');
+    split = ChunkCodec::EncodeSplit(same.data(), 4096, &out);
+    ASSERT_EQ(SplitEncodeType::kSnappy, split.type);
+    ASSERT_EQ(out.size(), split.storedLen);
+    ASSERT_LT(split.storedLen, 4096);
+    std::string raw(4096, '\0');
+    ASSERT_TRUE(ChunkCodec::Uncompress(out.data(), out.size(), &raw[0], 4096));
+    ASSERT_EQ(same, raw);
+    ASSERT_FALSE(ChunkCodec::Uncompress(out.data(), out.size(), &raw[0], 1));
+
+    // 不可压缩的分片原样存储
+    std::string random(4096, '\0');
+    uint32_t seed = 1;
+    for (auto &c : random) {
+        seed = seed * 1103515245 + 12345;
+        c = static_cast<char>(seed >> 16);
+    }
+    split = ChunkCodec::EncodeSplit(random.data(), 4096, &out);
+    ASSERT_EQ(SplitEncodeType::kRaw, split.type);
+    ASSERT_EQ(4096, split.storedLen);
+    ASSERT_TRUE(out.empty());
+}
+
+TEST(ChunkCodecTest, HeaderTest) {
+    EncodedChunkHeader header;
+    header.AddSplit({SplitEncodeType::kZero, 4096, 0});
+    header.AddSplit({SplitEncodeType::kSnappy, 4096, 100});
+    header.AddSplit({SplitEncodeType::kRaw, 1024, 1024});
+    std::string data;
+    header.Encode(&data);
+    ASSERT_EQ(header.GetHeaderSize(), data.size());
+
+    EncodedChunkHeader decoded;
+    ASSERT_TRUE(decoded.Decode(data.data(), data.size()));
+    ASSERT_EQ(3, decoded.GetSplits().size());
+    ASSERT_EQ(SplitEncodeType::kSnappy, decoded.GetSplits()[1].type);
+    ASSERT_EQ(9216, decoded.GetRawSize());
+    ASSERT_EQ(4096, decoded.GetRawOffset(1));
+    ASSERT_EQ(8192, decoded.GetRawOffset(2));
+    ASSERT_EQ(data.size(), decoded.GetStoredOffset(1));
+    ASSERT_EQ(data.size() + 100, decoded.GetStoredOffset(2));
+
+    // 头部不完整或损坏
+    ASSERT_FALSE(decoded.Decode(data.data(), data.size() - 1));
+    data[10] ^= 1;
+    ASSERT_FALSE(decoded.Decode(data.data(), data.size()));
+    // 未编码的数据
+    std::string raw(4096, 'a');
+    ASSERT_FALSE(decoded.Decode(raw.data(), raw.size()));
+}
+
+TEST(ChunkCodecTest, EncodeChunkTest) {
+    std::string chunk(4 * 4096, '\0');
+    chunk.replace(4096, 4096, std::string(4096, 'a'));
+    for (uint32_t i = 2 * 4096; i < 3 * 4096; ++i) {
+        chunk[i] = static_cast<char>(i * 7 + i / 3);
+    }
+
+    std::string encoded;
+    ASSERT_TRUE(ChunkCodec::EncodeChunk(chunk, 4096, &encoded));
+    ASSERT_LT(encoded.size(), chunk.size());
+    EncodedChunkHeader header;
+    ASSERT_TRUE(header.Decode(encoded.data(), encoded.size()));
+    ASSERT_EQ(4, header.GetSplits().size());
+    ASSERT_EQ(SplitEncodeType::kZero, header.GetSplits()[0].type);
+    ASSERT_EQ(SplitEncodeType::kZero, header.GetSplits()[3].type);
+
+    ASSERT_TRUE(ChunkCodec::DecodeChunk(&encoded));
+    ASSERT_EQ(chunk, encoded);
+
+    // 未编码的对象原样返回
+    std::string raw = chunk;
+    ASSERT_TRUE(ChunkCodec::DecodeChunk(&raw));
+    ASSERT_EQ(chunk, raw);
+
+    // 对象被截断
+    ASSERT_TRUE(ChunkCodec::EncodeChunk(chunk, 4096, &encoded));
+    encoded.resize(encoded.size() - 1);
+    ASSERT_FALSE(ChunkCodec::DecodeChunk(&encoded));
+
+    // 分片过多
+    ASSERT_FALSE(ChunkCodec::EncodeChunk(chunk, 1, &encoded));
+}
+
+}  // namespace common
+}  // namespace curve
@@ -35,6 +35,9 @@ TEST(LocationOperatorTest, GenerateTest) {
 
     location = LocationOperator::GenerateCurveLocation("test", 0);
     ASSERT_STREQ("test:0@cs", location.c_str());
+
+    location = LocationOperator::GenerateLocalLocation("/test-0-1");
+    ASSERT_STREQ("/test-0-1@local", location.c_str());
 }
 
 TEST(LocationOperatorTest, GenerateCurveLocationTest) {
@@ -71,6 +74,11 @@ TEST(LocationOperatorTest, GenerateCurveLocationTest) {
     location = "test@test@cs";
     ASSERT_EQ(OriginType::CurveOrigin,
               LocationOperator::ParseLocation(location, nullptr));
+
+    location = "/test-0-1@local";
+    ASSERT_EQ(OriginType::LocalOrigin,
+              LocationOperator::ParseLocation(location, &originPath));
+    ASSERT_STREQ(originPath.c_str(), "/test-0-1");
 }
 
 TEST(LocationOperatorTest, ParseCurvePathTest) {
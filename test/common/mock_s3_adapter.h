@@ -53,6 +53,9 @@ class MockS3Adapter : public S3Adapter {
                                 off_t,
                                 size_t));
     MOCK_METHOD1(GetObjectAsync, void(std::shared_ptr<GetObjectAsyncContext>));
+    MOCK_METHOD1(PutObjectAsync, void(std::shared_ptr<PutObjectAsyncContext>));
+    MOCK_METHOD1(UploadOnePartAsync,
+                 void(std::shared_ptr<UploadPartAsyncContext>));
     MOCK_METHOD1(DeleteObject, int(const Aws::String &));
     MOCK_METHOD1(ObjectExist, bool(const Aws::String &));
 /*
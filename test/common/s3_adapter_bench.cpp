@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+/*
+ * S3Adapter的同步/异步读写性能对比，需要一个本地的S3兼容服务（如minio），
+ * s3配置文件中的s3.nos_address等指向该服务，例如:
+ *   s3-adapter-bench -s3_conf=./conf/s3.conf -object_size=67108864 \
+ *       -io_size=65536 -io_depth=64
+ * 异步读按随机顺序提交相邻的范围读，用于观察请求合并的效果
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/common/s3_adapter.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "src/common/timeutility.h"
+
+DEFINE_string(s3_conf, "./conf/s3.conf", "s3 config path");
+DEFINE_string(object_prefix, "s3_adapter_bench", "prefix of test objects");
+DEFINE_uint64(object_size, 64 * 1024 * 1024, "size of one test object");
+DEFINE_uint64(io_size, 64 * 1024, "size of one read / write");
+DEFINE_uint32(io_depth, 64, "inflight requests of the async test, "
+                            "threads of the sync test");
+DEFINE_uint32(object_num, 4, "object num of the put test");
+
+using curve::common::S3Adapter;
+using curve::common::GetObjectAsyncContext;
+using curve::common::PutObjectAsyncContext;
+using curve::common::CountDownEvent;
+using curve::common::TimeUtility;
+
+namespace {
+
+void Report(const std::string &name, uint64_t bytes, uint64_t ios,
+            uint64_t startUs, uint64_t failed) {
+    uint64_t costUs = std::max<uint64_t>(1,
+        TimeUtility::GetTimeofDayUs() - startUs);
+    LOG(INFO) << name
+              << ": bandwidth = " << bytes * 1000000 / costUs / 1024 / 1024
+              << " MB/s, iops = " << ios * 1000000 / costUs
+              << ", failed = " << failed;
+}
+
+// 多个线程各自同步读对象的一部分
+void SyncGetTest(S3Adapter *adapter, const std::string &key) {
+    uint64_t ioNum = FLAGS_object_size / FLAGS_io_size;
+    std::atomic<uint64_t> next(0);
+    std::atomic<uint64_t> failed(0);
+    std::vector<std::thread> threads;
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (uint32_t i = 0; i < FLAGS_io_depth; i++) {
+        threads.emplace_back([&]() {
+            std::unique_ptr<char[]> buf(new char[FLAGS_io_size]);
+            uint64_t index;
+            while ((index = next.fetch_add(1)) < ioNum) {
+                if (adapter->GetObject(key, buf.get(),
+                    index * FLAGS_io_size, FLAGS_io_size) != 0) {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    Report("sync get", ioNum * FLAGS_io_size, ioNum, startUs, failed);
+}
+
+// 以随机顺序异步读整个对象，保持io_depth个请求在进行中
+void AsyncGetTest(S3Adapter *adapter, const std::string &key) {
+    uint64_t ioNum = FLAGS_object_size / FLAGS_io_size;
+    std::vector<uint64_t> order(ioNum);
+    for (uint64_t i = 0; i < ioNum; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(ioNum));
+
+    std::unique_ptr<char[]> buf(new char[FLAGS_object_size]);
+    std::atomic<uint64_t> failed(0);
+    std::atomic<uint32_t> inflight(0);
+    CountDownEvent done(ioNum);
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (uint64_t index : order) {
+        while (inflight.load() >= FLAGS_io_depth) {
+            std::this_thread::yield();
+        }
+        inflight++;
+        auto ctx = std::make_shared<GetObjectAsyncContext>();
+        ctx->key = key;
+        ctx->offset = index * FLAGS_io_size;
+        ctx->len = FLAGS_io_size;
+        ctx->buf = buf.get() + ctx->offset;
+        ctx->cb = [&](const S3Adapter*,
+            const std::shared_ptr<GetObjectAsyncContext> &context) {
+            if (context->retCode != 0) {
+                failed++;
+            }
+            inflight--;
+            done.Signal();
+        };
+        adapter->GetObjectAsync(ctx);
+    }
+    done.Wait();
+    Report("async get", ioNum * FLAGS_io_size, ioNum, startUs, failed);
+}
+
+// 异步上传多个对象
+void AsyncPutTest(S3Adapter *adapter, const std::string &data) {
+    std::atomic<uint64_t> failed(0);
+    CountDownEvent done(FLAGS_object_num);
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    for (uint32_t i = 0; i < FLAGS_object_num; i++) {
+        auto ctx = std::make_shared<PutObjectAsyncContext>();
+        ctx->key = FLAGS_object_prefix + "_put_" + std::to_string(i);
+        ctx->buffer = data.data();
+        ctx->bufferSize = data.size();
+        ctx->cb = [&](const S3Adapter*,
+            const std::shared_ptr<PutObjectAsyncContext> &context) {
+            if (context->retCode != 0) {
+                failed++;
+            }
+            done.Signal();
+        };
+        adapter->PutObjectAsync(ctx);
+    }
+    done.Wait();
+    Report("async put", data.size() * FLAGS_object_num, FLAGS_object_num,
+           startUs, failed);
+    for (uint32_t i = 0; i < FLAGS_object_num; i++) {
+        adapter->DeleteObject(
+            (FLAGS_object_prefix + "_put_" + std::to_string(i)).c_str());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+
+    if (FLAGS_io_size == 0 || FLAGS_object_size % FLAGS_io_size != 0) {
+        LOG(ERROR) << "object_size must be a multiple of io_size";
+        return -1;
+    }
+
+    S3Adapter adapter;
+    adapter.Init(FLAGS_s3_conf);
+    if (!adapter.BucketExist() && adapter.CreateBucket() != 0) {
+        LOG(ERROR) << "Create bucket fail";
+        adapter.Deinit();
+        return -1;
+    }
+
+    std::string data(FLAGS_object_size, 'a');
+    std::string key = FLAGS_object_prefix + "_get";
+    if (adapter.PutObject(key.c_str(), data) != 0) {
+        LOG(ERROR) << "Put test object fail";
+        adapter.Deinit();
+        return -1;
+    }
+
+    SyncGetTest(&adapter, key);
+    AsyncGetTest(&adapter, key);
+    AsyncPutTest(&adapter, data);
+
+    adapter.DeleteObject(key.c_str());
+    adapter.Deinit();
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/s3_adapter.h"
+
+namespace curve {
+namespace common {
+
+// 记录发出的读请求，由测试控制请求何时完成
+class FakeS3Adapter : public S3Adapter {
+ public:
+    struct IssuedGet {
+        std::string key;
+        off_t offset;
+        size_t len;
+        char *buf;
+        std::string etag;
+        std::function<void(int, const std::string &)> done;
+    };
+
+    // 以偏移的低8位填充数据后完成第一个未完成的请求
+    void CompleteFirst(int ret, const std::string &etag = "etag") {
+        IssuedGet get = issued.front();
+        issued.erase(issued.begin());
+        for (size_t i = 0; i < get.len; i++) {
+            get.buf[i] = static_cast<char>((get.offset + i) & 0xff);
+        }
+        get.done(ret, etag);
+    }
+
+    std::vector<IssuedGet> issued;
+
+ protected:
+    void IssueGetObjectAsync(const std::string &key,
+                             off_t offset,
+                             size_t len,
+                             char *buf,
+                             const std::string &etag,
+                             std::function<void(int, const std::string &)>
+                                 done) override {
+        issued.push_back({key, offset, len, buf, etag, done});
+    }
+};
+
+class S3AdapterAsyncTest : public ::testing::Test {
+ protected:
+    std::shared_ptr<GetObjectAsyncContext> Get(const std::string &key,
+                                               off_t offset,
+                                               size_t len,
+                                               const std::string &etag = "") {
+        auto ctx = std::make_shared<GetObjectAsyncContext>();
+        ctx->key = key;
+        ctx->etag = etag;
+        ctx->offset = offset;
+        ctx->len = len;
+        ctx->retCode = 1;
+        bufs_.emplace_back(new char[len]);
+        ctx->buf = bufs_.back().get();
+        ctx->cb = [this](const S3Adapter*,
+            const std::shared_ptr<GetObjectAsyncContext> &context) {
+            done_.push_back(context);
+        };
+        adapter_.GetObjectAsync(ctx);
+        return ctx;
+    }
+
+    static bool CheckData(const std::shared_ptr<GetObjectAsyncContext> &ctx) {
+        for (size_t i = 0; i < ctx->len; i++) {
+            if (ctx->buf[i] != static_cast<char>((ctx->offset + i) & 0xff)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FakeS3Adapter adapter_;
+    std::vector<std::unique_ptr<char[]>> bufs_;
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> done_;
+};
+
+TEST_F(S3AdapterAsyncTest, InflightWindowTest) {
+    // 不限制时直接发送
+    auto ctx1 = Get("obj", 0, 10);
+    auto ctx2 = Get("obj", 10, 10);
+    ASSERT_EQ(2, adapter_.issued.size());
+    adapter_.CompleteFirst(0);
+    adapter_.CompleteFirst(-1);
+    ASSERT_EQ(2, done_.size());
+    ASSERT_EQ(0, ctx1->retCode);
+    ASSERT_TRUE(CheckData(ctx1));
+    ASSERT_EQ(-1, ctx2->retCode);
+
+    // 窗口满时排队，不合并时逐个发送
+    done_.clear();
+    adapter_.SetAsyncRequestWindow(2, 0);
+    auto ctx3 = Get("obj", 0, 10);
+    auto ctx4 = Get("obj", 10, 10);
+    auto ctx5 = Get("obj", 20, 10);
+    ASSERT_EQ(2, adapter_.issued.size());
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(2, adapter_.issued.size());
+    ASSERT_EQ(20, adapter_.issued[1].offset);
+    ASSERT_EQ(10, adapter_.issued[1].len);
+    adapter_.CompleteFirst(0);
+    adapter_.CompleteFirst(0);
+    ASSERT_TRUE(adapter_.issued.empty());
+    ASSERT_EQ(3, done_.size());
+    ASSERT_TRUE(CheckData(ctx3));
+    ASSERT_TRUE(CheckData(ctx4));
+    ASSERT_TRUE(CheckData(ctx5));
+
+    // 窗口中的请求都已完成，新的请求直接发送
+    Get("obj", 30, 10);
+    ASSERT_EQ(1, adapter_.issued.size());
+    adapter_.CompleteFirst(0);
+}
+
+TEST_F(S3AdapterAsyncTest, CoalesceTest) {
+    adapter_.SetAsyncRequestWindow(1, 25);
+    auto ctx1 = Get("obj", 0, 10);
+    ASSERT_EQ(1, adapter_.issued.size());
+
+    // 排队的请求
+    auto ctx2 = Get("obj", 20, 10);
+    auto ctx3 = Get("obj2", 10, 10);
+    auto ctx4 = Get("obj", 10, 10);
+    // 与ctx2重叠
+    auto ctx5 = Get("obj", 25, 5);
+    // 合并后超过上限
+    auto ctx6 = Get("obj", 30, 10);
+    // 不相邻
+    auto ctx7 = Get("obj", 100, 10);
+    ASSERT_EQ(1, adapter_.issued.size());
+
+    // ctx2、ctx4、ctx5合并为一个请求
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ("obj", adapter_.issued[0].key);
+    ASSERT_EQ(10, adapter_.issued[0].offset);
+    ASSERT_EQ(20, adapter_.issued[0].len);
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(4, done_.size());
+    ASSERT_EQ(ctx4, done_[1]);
+    ASSERT_EQ(ctx2, done_[2]);
+    ASSERT_EQ(ctx5, done_[3]);
+    for (auto &ctx : {ctx1, ctx2, ctx4, ctx5}) {
+        ASSERT_EQ(0, ctx->retCode);
+        ASSERT_TRUE(CheckData(ctx));
+    }
+
+    // 其余请求按顺序发送
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ("obj2", adapter_.issued[0].key);
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ(30, adapter_.issued[0].offset);
+    ASSERT_EQ(10, adapter_.issued[0].len);
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ(100, adapter_.issued[0].offset);
+    adapter_.CompleteFirst(0);
+    ASSERT_TRUE(adapter_.issued.empty());
+    ASSERT_EQ(7, done_.size());
+    ASSERT_TRUE(CheckData(ctx3));
+    ASSERT_TRUE(CheckData(ctx6));
+    ASSERT_TRUE(CheckData(ctx7));
+}
+
+TEST_F(S3AdapterAsyncTest, CoalesceFailTest) {
+    adapter_.SetAsyncRequestWindow(1, 1024);
+    auto ctx1 = Get("obj", 0, 10);
+    auto ctx2 = Get("obj", 10, 10);
+    auto ctx3 = Get("obj", 20, 10);
+    adapter_.CompleteFirst(0);
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ(20, adapter_.issued[0].len);
+
+    // 合并的请求失败，所有请求都返回失败
+    adapter_.CompleteFirst(-1);
+    ASSERT_EQ(3, done_.size());
+    ASSERT_EQ(0, ctx1->retCode);
+    ASSERT_EQ(-1, ctx2->retCode);
+    ASSERT_EQ(-1, ctx3->retCode);
+}
+
+TEST_F(S3AdapterAsyncTest, EtagTest) {
+    adapter_.SetAsyncRequestWindow(1, 1024);
+    auto ctx1 = Get("obj", 0, 10);
+    ASSERT_EQ("", adapter_.issued[0].etag);
+
+    // ETag条件不同的请求不合并
+    auto ctx2 = Get("obj", 10, 10, "v1");
+    auto ctx3 = Get("obj", 20, 10, "v2");
+    auto ctx4 = Get("obj", 15, 10, "v1");
+    adapter_.CompleteFirst(0, "v1");
+    ASSERT_EQ("v1", ctx1->etag);
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ("v1", adapter_.issued[0].etag);
+    ASSERT_EQ(10, adapter_.issued[0].offset);
+    ASSERT_EQ(15, adapter_.issued[0].len);
+    adapter_.CompleteFirst(0, "v1");
+    ASSERT_EQ(0, ctx2->retCode);
+    ASSERT_EQ(0, ctx4->retCode);
+    ASSERT_TRUE(CheckData(ctx4));
+
+    // 对象已变化，条件读失败
+    ASSERT_EQ(1, adapter_.issued.size());
+    ASSERT_EQ("v2", adapter_.issued[0].etag);
+    adapter_.CompleteFirst(-1, "");
+    ASSERT_EQ(-1, ctx3->retCode);
+    ASSERT_EQ("v2", ctx3->etag);
+}
+
+}  // namespace common
+}  // namespace curve
@@ -138,6 +138,41 @@ TEST(TaskThreadPool, basic) {
         taskThreadPool.Stop();
     }
 
+    /* 测试队列满了，TryEnqueue直接返回失败 */
+    {
+        std::atomic<int32_t> runTaskCount;
+        runTaskCount.store(0, std::memory_order_release);
+        const int kQueueCapacity = 2;
+
+        CountDownEvent cond(1);
+        CountDownEvent startRunCond(1);
+        auto waitTask = [&] {
+            startRunCond.Signal();
+            cond.Wait();
+            runTaskCount.fetch_add(1, std::memory_order_acq_rel);
+        };
+        auto task = [&] {
+            runTaskCount.fetch_add(1, std::memory_order_acq_rel);
+        };
+
+        TaskThreadPool<> taskThreadPool;
+        ASSERT_EQ(0, taskThreadPool.Start(1, kQueueCapacity));
+        ASSERT_TRUE(taskThreadPool.TryEnqueue(waitTask));
+        startRunCond.Wait();
+
+        ASSERT_TRUE(taskThreadPool.TryEnqueue(task));
+        ASSERT_TRUE(taskThreadPool.TryEnqueue(task));
+        ASSERT_FALSE(taskThreadPool.TryEnqueue(task));
+        ASSERT_EQ(kQueueCapacity, taskThreadPool.QueueSize());
+
+        cond.Signal();
+        while (runTaskCount.load(std::memory_order_acquire) < 3) {
+            ::usleep(10);
+        }
+        ASSERT_TRUE(taskThreadPool.TryEnqueue(task));
+        taskThreadPool.Stop();
+    }
+
     /* 测试队列满了，push会阻塞 */
     {
         std::atomic<int32_t> runTaskCount;
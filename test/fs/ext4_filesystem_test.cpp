@@ -529,6 +529,18 @@ TEST_F(Ext4LocalFileSystemTest, FsyncTest) {
     ASSERT_EQ(lfs->Fsync(666), -errno);
 }
 
+// test Fdatasync
+TEST_F(Ext4LocalFileSystemTest, FdatasyncTest) {
+    // success
+    EXPECT_CALL(*wrapper, fdatasync(_))
+        .WillOnce(Return(0));
+    ASSERT_EQ(lfs->Fdatasync(666), 0);
+    // fdatasync failed
+    EXPECT_CALL(*wrapper, fdatasync(_))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(lfs->Fdatasync(666), -errno);
+}
+
 TEST_F(Ext4LocalFileSystemTest, ReadRealTest) {
     std::shared_ptr<PosixWrapper> pw = std::make_shared<PosixWrapper>();
     lfs->SetPosixWrapper(pw);
@@ -0,0 +1,393 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <fcntl.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "test/integration/chunkserver/datastore/datastore_integration_base.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFileSystemOption;
+using curve::fs::FileSystemInfo;
+
+const string baseDir = "./data_int_crash";    // NOLINT
+const string poolDir = "./chunkfilepool_int_crash";  // NOLINT
+const string poolMetaPath = "./chunkfilepool_int_crash.meta";  // NOLINT
+// 以下的测试读写数据都在[0, 32kb]范围内
+const uint64_t kMaxSize = 8 * PAGE_SIZE;
+
+/**
+ * 模拟掉电的本地文件系统
+ * 未以O_DSYNC打开的文件，写入的数据在fsync/fdatasync之前不持久化，
+ * Crash时这些写入被丢弃，文件恢复为最后一次同步时的内容
+ */
+class CrashFileSystem : public LocalFileSystem {
+ public:
+    explicit CrashFileSystem(std::shared_ptr<LocalFileSystem> lfs)
+        : lfs_(lfs) {}
+
+    int Init(const LocalFileSystemOption& option) override {
+        return lfs_->Init(option);
+    }
+    int Statfs(const string& path, struct FileSystemInfo* info) override {
+        return lfs_->Statfs(path, info);
+    }
+    int Open(const string& path, int flags) override {
+        int fd = lfs_->Open(path, flags);
+        if (fd >= 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            files_[fd] = {path, (flags & O_DSYNC) != 0};
+        }
+        return fd;
+    }
+    int Close(int fd) override {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            files_.erase(fd);
+        }
+        return lfs_->Close(fd);
+    }
+    int Delete(const string& path) override {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            unsynced_.erase(path);
+        }
+        return lfs_->Delete(path);
+    }
+    int Mkdir(const string& dirPath) override {
+        return lfs_->Mkdir(dirPath);
+    }
+    bool DirExists(const string& dirPath) override {
+        return lfs_->DirExists(dirPath);
+    }
+    bool FileExists(const string& filePath) override {
+        return lfs_->FileExists(filePath);
+    }
+    int Rename(const string& oldPath,
+               const string& newPath,
+               unsigned int flags = 0) override {
+        int rc = lfs_->Rename(oldPath, newPath, flags);
+        if (rc == 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto iter = unsynced_.find(oldPath);
+            if (iter != unsynced_.end()) {
+                unsynced_[newPath] = std::move(iter->second);
+                unsynced_.erase(oldPath);
+            }
+        }
+        return rc;
+    }
+    int List(const string& dirPath, vector<std::string>* names) override {
+        return lfs_->List(dirPath, names);
+    }
+    int Read(int fd, char* buf, uint64_t offset, int length) override {
+        return lfs_->Read(fd, buf, offset, length);
+    }
+    int Write(int fd, const char* buf, uint64_t offset, int length) override {
+        RecordWrite(fd, offset, length);
+        return lfs_->Write(fd, buf, offset, length);
+    }
+    int Write(int fd, butil::IOBuf buf, uint64_t offset,
+              int length) override {
+        RecordWrite(fd, offset, length);
+        return lfs_->Write(fd, buf, offset, length);
+    }
+    int Append(int fd, const char* buf, int length) override {
+        return lfs_->Append(fd, buf, length);
+    }
+    int Fallocate(int fd, int op, uint64_t offset, int length) override {
+        return lfs_->Fallocate(fd, op, offset, length);
+    }
+    int Fstat(int fd, struct stat* info) override {
+        return lfs_->Fstat(fd, info);
+    }
+    int Fsync(int fd) override {
+        int rc = lfs_->Fsync(fd);
+        if (rc == 0) {
+            MarkSynced(fd);
+        }
+        return rc;
+    }
+    int Fdatasync(int fd) override {
+        int rc = lfs_->Fdatasync(fd);
+        if (rc == 0) {
+            MarkSynced(fd);
+        }
+        return rc;
+    }
+
+    /**
+     * 模拟掉电，按写入的逆序恢复未同步的写入覆盖的内容
+     * 调用前需关闭所有文件
+     */
+    void Crash() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& pair : unsynced_) {
+            int fd = lfs_->Open(pair.first, O_RDWR);
+            ASSERT_GE(fd, 0);
+            auto& writes = pair.second;
+            for (auto iter = writes.rbegin(); iter != writes.rend(); ++iter) {
+                int length = iter->second.size();
+                ASSERT_EQ(length, lfs_->Write(fd, iter->second.data(),
+                                              iter->first, length));
+            }
+            ASSERT_EQ(0, lfs_->Fsync(fd));
+            lfs_->Close(fd);
+        }
+        unsynced_.clear();
+    }
+
+    // 未同步的写入次数
+    size_t UnsyncedWrites() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        size_t count = 0;
+        for (auto& pair : unsynced_) {
+            count += pair.second.size();
+        }
+        return count;
+    }
+
+ private:
+    struct OpenedFile {
+        string path;
+        bool dsync;
+    };
+
+    // 记录写入前的内容，用于Crash时恢复
+    void RecordWrite(int fd, uint64_t offset, int length) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto iter = files_.find(fd);
+        if (iter == files_.end() || iter->second.dsync) {
+            return;
+        }
+        std::string origin(length, '\0');
+        int rc = lfs_->Read(fd, &origin[0], offset, length);
+        ASSERT_GE(rc, 0);
+        unsynced_[iter->second.path].emplace_back(offset, std::move(origin));
+    }
+
+    void MarkSynced(int fd) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto iter = files_.find(fd);
+        if (iter != files_.end()) {
+            unsynced_.erase(iter->second.path);
+        }
+    }
+
+ private:
+    std::shared_ptr<LocalFileSystem> lfs_;
+    std::mutex mtx_;
+    // fd->打开的文件
+    std::unordered_map<int, OpenedFile> files_;
+    // 文件路径->未同步的写入(偏移，写入前的内容)
+    std::map<string, std::vector<std::pair<uint64_t, std::string>>>
+        unsynced_;
+};
+
+// 模拟raft日志中的一条写请求
+struct LogEntry {
+    ChunkID id;
+    char data;
+    off_t offset;
+    size_t length;
+};
+
+/**
+ * chunk文件不以O_DSYNC打开时的掉电测试
+ * 模拟copyset的流程：写请求先记入raft日志再apply到datastore，
+ * 打快照时同步脏chunk后截断日志，掉电重启后回放剩余的日志，
+ * 检查chunk的数据与所有写请求apply后的结果一致
+ */
+class CrashTestSuit : public DatastoreIntegrationBase {
+ public:
+    CrashTestSuit() {}
+    ~CrashTestSuit() {}
+
+    void SetUp() override {
+        DatastoreIntegrationBase::SetUp();
+        crashFs_ = std::make_shared<CrashFileSystem>(lfs_);
+    }
+
+    void TearDown() override {
+        dataStore_ = nullptr;
+        crashFs_ = nullptr;
+        DatastoreIntegrationBase::TearDown();
+    }
+
+ protected:
+    void StartDataStore(bool enableOdsync) {
+        enableOdsync_ = enableOdsync;
+        DataStoreOptions options;
+        options.baseDir = baseDir;
+        options.chunkSize = CHUNK_SIZE;
+        options.pageSize = PAGE_SIZE;
+        options.enableOdsyncWhenOpenChunkFile = enableOdsync;
+        dataStore_ = std::make_shared<CSDataStore>(crashFs_,
+                                                   filePool_,
+                                                   options);
+        ASSERT_TRUE(dataStore_->Initialize());
+    }
+
+    void Write(const LogEntry& entry) {
+        std::string buf(entry.length, entry.data);
+        uint32_t cost;
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore_->WriteChunk(entry.id, sn_, buf.data(),
+                                         entry.offset, entry.length,
+                                         &cost));
+    }
+
+    // 写请求记入日志后apply
+    void Apply(const LogEntry& entry) {
+        log_.push_back(entry);
+        Write(entry);
+        auto iter = expected_.find(entry.id);
+        if (iter == expected_.end()) {
+            iter = expected_.emplace(entry.id,
+                                     std::string(kMaxSize, '\0')).first;
+        }
+        iter->second.replace(entry.offset, entry.length, entry.length,
+                             entry.data);
+    }
+
+    // 模拟on_snapshot_save，快照完成后raft截断已包含在快照中的日志
+    void Snapshot(bool sync) {
+        if (sync) {
+            ASSERT_EQ(CSErrorCode::Success, dataStore_->SyncDirtyChunks());
+        }
+        log_.clear();
+    }
+
+    // 掉电后重启，并回放快照之后的日志
+    void CrashAndRecover() {
+        dataStore_ = nullptr;
+        crashFs_->Crash();
+        StartDataStore(enableOdsync_);
+        for (const auto& entry : log_) {
+            Write(entry);
+        }
+    }
+
+    std::string ReadChunk(ChunkID id) {
+        std::string buf(kMaxSize, '\0');
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore_->ReadChunk(id, sn_, &buf[0], 0, kMaxSize));
+        return buf;
+    }
+
+    bool CheckChunks() {
+        for (const auto& pair : expected_) {
+            if (ReadChunk(pair.first) != pair.second) {
+                LOG(ERROR) << "Chunk data mismatch, chunk id: " << pair.first;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 快照前后各写入一批数据，快照后的写入覆盖快照前写入的部分范围
+    void WriteAroundSnapshot(bool sync) {
+        Apply({1, 'a', 0, 4 * PAGE_SIZE});
+        Apply({2, 'b', PAGE_SIZE, 2 * PAGE_SIZE});
+        Apply({1, 'c', 2 * PAGE_SIZE, 4 * PAGE_SIZE});
+        Snapshot(sync);
+        Apply({1, 'd', PAGE_SIZE, PAGE_SIZE});
+        Apply({2, 'e', 4 * PAGE_SIZE, 2 * PAGE_SIZE});
+        Apply({3, 'f', 0, 8 * PAGE_SIZE});
+    }
+
+ protected:
+    std::shared_ptr<CrashFileSystem> crashFs_;
+    bool enableOdsync_ = true;
+    SequenceNum sn_ = 1;
+    std::vector<LogEntry> log_;
+    // chunk id->所有写请求apply后的数据
+    std::map<ChunkID, std::string> expected_;
+};
+
+/**
+ * 不以O_DSYNC打开chunk文件，打快照时同步脏chunk
+ * 预期：掉电丢弃了快照之后的写入，回放日志后数据完整
+ */
+TEST_F(CrashTestSuit, SyncBeforeTruncateTest) {
+    StartDataStore(false);
+    WriteAroundSnapshot(true);
+    ASSERT_LT(0, crashFs_->UnsyncedWrites());
+
+    // 回放前快照之后的写入已丢失，快照之前的写入已持久化
+    dataStore_ = nullptr;
+    crashFs_->Crash();
+    StartDataStore(false);
+    std::string chunk1 = ReadChunk(1);
+    ASSERT_EQ(std::string(PAGE_SIZE, 'a'), chunk1.substr(PAGE_SIZE, PAGE_SIZE));
+    ASSERT_EQ(std::string(4 * PAGE_SIZE, 'c'),
+              chunk1.substr(2 * PAGE_SIZE, 4 * PAGE_SIZE));
+
+    for (const auto& entry : log_) {
+        Write(entry);
+    }
+    ASSERT_TRUE(CheckChunks());
+
+    // 再次掉电，回放的写入未同步，需要再次回放
+    CrashAndRecover();
+    ASSERT_TRUE(CheckChunks());
+
+    // 打快照后日志已截断，掉电后数据仍然完整
+    Snapshot(true);
+    ASSERT_EQ(0, crashFs_->UnsyncedWrites());
+    CrashAndRecover();
+    ASSERT_TRUE(CheckChunks());
+}
+
+/**
+ * 不同步脏chunk就截断日志
+ * 预期：掉电后快照之前的写入丢失，用于验证测试能发现数据丢失
+ */
+TEST_F(CrashTestSuit, TruncateWithoutSyncTest) {
+    StartDataStore(false);
+    WriteAroundSnapshot(false);
+    CrashAndRecover();
+    ASSERT_FALSE(CheckChunks());
+}
+
+/**
+ * 以O_DSYNC打开chunk文件
+ * 预期：写入即持久化，不同步也不会丢失数据
+ */
+TEST_F(CrashTestSuit, OdsyncTest) {
+    StartDataStore(true);
+    WriteAroundSnapshot(false);
+    ASSERT_EQ(0, crashFs_->UnsyncedWrites());
+    CrashAndRecover();
+    ASSERT_TRUE(CheckChunks());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -225,6 +225,49 @@ int FakeCurveFsClient::RecoverChunk(
     return LIBCURVE_ERROR::OK;
 }
 
+int FakeCurveFsClient::CreateCloneChunkBatch(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    SnapCloneClosure *scc) {
+    for (auto &item : *items) {
+        item.ret = LIBCURVE_ERROR::OK;
+    }
+    scc->SetRetCode(LIBCURVE_ERROR::OK);
+    scc->Run();
+    fiu_return_on(
+        "test/integration/snapshotcloneserver/FakeCurveFsClient.CreateCloneChunkBatch", -LIBCURVE_ERROR::FAILED);  // NOLINT
+    return LIBCURVE_ERROR::OK;
+}
+
+int FakeCurveFsClient::RecoverChunkBatch(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    SnapCloneClosure *scc) {
+    for (auto &item : *items) {
+        item.ret = LIBCURVE_ERROR::OK;
+    }
+    scc->SetRetCode(LIBCURVE_ERROR::OK);
+    scc->Run();
+    fiu_return_on(
+        "test/integration/snapshotcloneserver/FakeCurveFsClient.RecoverChunkBatch", -LIBCURVE_ERROR::FAILED);  // NOLINT
+    return LIBCURVE_ERROR::OK;
+}
+
+int FakeCurveFsClient::WriteChunkBulk(
+    const ChunkIDInfo &copysetidinfo,
+    std::vector<CloneChunkBatchItem> *items,
+    const char *buf,
+    SnapCloneClosure *scc) {
+    for (auto &item : *items) {
+        item.ret = LIBCURVE_ERROR::OK;
+    }
+    scc->SetRetCode(LIBCURVE_ERROR::OK);
+    scc->Run();
+    fiu_return_on(
+        "test/integration/snapshotcloneserver/FakeCurveFsClient.WriteChunkBulk", -LIBCURVE_ERROR::FAILED);  // NOLINT
+    return LIBCURVE_ERROR::OK;
+}
+
 int FakeCurveFsClient::CompleteCloneMeta(
     const std::string &filename,
     const std::string &user) {
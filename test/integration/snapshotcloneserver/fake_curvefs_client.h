@@ -25,6 +25,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "src/snapshotcloneserver/common/curvefs_client.h"
 
@@ -110,6 +111,22 @@ class FakeCurveFsClient : public CurveFsClient {
         uint64_t len,
         SnapCloneClosure *scc) override;
 
+    int CreateCloneChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure *scc) override;
+
+    int RecoverChunkBatch(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure *scc) override;
+
+    int WriteChunkBulk(
+        const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        const char *buf,
+        SnapCloneClosure *scc) override;
+
     int CompleteCloneMeta(
         const std::string &filename,
         const std::string &user) override;
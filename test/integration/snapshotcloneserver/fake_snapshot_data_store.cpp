@@ -70,11 +70,25 @@ bool FakeSnapshotDataStore::ChunkIndexDataExist(
     return indexDataMap_.find(key) != indexDataMap_.end();
 }
 
+int FakeSnapshotDataStore::GetChunkData(const ChunkDataName &name,
+        ChunkData *data) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    fiu_return_on(
+        "test/integration/snapshotcloneserver/FakeSnapshotDataStore.GetChunkData", -1);  // NOLINT
+    if (chunkData_.find(name.ToDataChunkKey()) == chunkData_.end()) {
+        return -1;
+    }
+    // 不保存数据内容，读出为空视为全零
+    data->data_.clear();
+    return 0;
+}
+
 int FakeSnapshotDataStore::DeleteChunkData(const ChunkDataName &name) {
     std::lock_guard<std::mutex> guard(chunkDataMutex_);
     fiu_return_on(
         "test/integration/snapshotcloneserver/FakeSnapshotDataStore.DeleteChunkData", -1);  // NOLINT
     chunkData_.erase(name.ToDataChunkKey());
+    pageDigest_.erase(name.ToDataChunkKey());
     return 0;
 }
 
@@ -110,5 +124,52 @@ int FakeSnapshotDataStore::DataChunkTranferAbort(const ChunkDataName &name,
     return 0;
 }
 
+int FakeSnapshotDataStore::PutChunkPageDigest(const ChunkDataName &name,
+        const ChunkPageDigest &digest) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    pageDigest_[name.ToDataChunkKey()] = digest;
+    return 0;
+}
+
+int FakeSnapshotDataStore::GetChunkPageDigest(const ChunkDataName &name,
+        ChunkPageDigest *digest) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    auto it = pageDigest_.find(name.ToDataChunkKey());
+    if (it == pageDigest_.end()) {
+        return -1;
+    }
+    *digest = it->second;
+    return 0;
+}
+
+int FakeSnapshotDataStore::PutChunkDeltaData(const ChunkDataName &name,
+        const ChunkDeltaData &delta) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    deltaData_.insert(name.ToDataChunkKey());
+    return 0;
+}
+
+bool FakeSnapshotDataStore::ChunkDeltaDataExist(const ChunkDataName &name) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    return deltaData_.find(name.ToDataChunkKey()) != deltaData_.end();
+}
+
+int FakeSnapshotDataStore::DeleteChunkDeltaData(const ChunkDataName &name) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    deltaData_.erase(name.ToDataChunkKey());
+    return 0;
+}
+
+int FakeSnapshotDataStore::MergeChunkDeltaData(const ChunkDataName &name,
+        const ChunkDataName &base) {
+    std::lock_guard<std::mutex> guard(chunkDataMutex_);
+    if (deltaData_.find(name.ToDataChunkKey()) == deltaData_.end() ||
+        chunkData_.find(base.ToDataChunkKey()) == chunkData_.end()) {
+        return -1;
+    }
+    chunkData_.insert(name.ToDataChunkKey());
+    return 0;
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
@@ -43,6 +43,8 @@ class FakeSnapshotDataStore : public SnapshotDataStore {
     int DeleteChunkIndexData(const ChunkIndexDataName &name) override;
     bool ChunkIndexDataExist(const ChunkIndexDataName &name) override;
 
+    int GetChunkData(const ChunkDataName &name,
+                     ChunkData *data) override;
     int DeleteChunkData(const ChunkDataName &name) override;
     bool ChunkDataExist(const ChunkDataName &name) override;
 
@@ -57,11 +59,23 @@ class FakeSnapshotDataStore : public SnapshotDataStore {
                                 std::shared_ptr<TransferTask> task) override;
     int DataChunkTranferAbort(const ChunkDataName &name,
                                std::shared_ptr<TransferTask> task) override;
+    int PutChunkPageDigest(const ChunkDataName &name,
+                           const ChunkPageDigest &digest) override;
+    int GetChunkPageDigest(const ChunkDataName &name,
+                           ChunkPageDigest *digest) override;
+    int PutChunkDeltaData(const ChunkDataName &name,
+                          const ChunkDeltaData &delta) override;
+    bool ChunkDeltaDataExist(const ChunkDataName &name) override;
+    int DeleteChunkDeltaData(const ChunkDataName &name) override;
+    int MergeChunkDeltaData(const ChunkDataName &name,
+                            const ChunkDataName &base) override;
 
  private:
     std::map<std::string, ChunkIndexData> indexDataMap_;
     std::mutex indexMapMutex_;
     std::set<std::string> chunkData_;
+    std::map<std::string, ChunkPageDigest> pageDigest_;
+    std::set<std::string> deltaData_;
     std::mutex chunkDataMutex_;
 };
 
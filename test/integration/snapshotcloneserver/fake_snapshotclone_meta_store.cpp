@@ -100,6 +100,25 @@ int FakeSnapshotCloneMetaStore::GetSnapshotList(
     return 0;
 }
 
+int FakeSnapshotCloneMetaStore::GetSnapshotListByPage(
+    const SnapshotListFilter &filter, uint64_t offset, uint64_t limit,
+    std::vector<SnapshotInfo> *list, uint64_t *total) {
+    std::lock_guard<std::mutex> guard(snapInfos_mutex);
+    *total = 0;
+    for (auto it = snapInfos_.begin();
+              it != snapInfos_.end();
+              it++) {
+        if (!filter.IsMatch(it->second)) {
+            continue;
+        }
+        if (*total >= offset && *total - offset < limit) {
+            list->push_back(it->second);
+        }
+        (*total)++;
+    }
+    return 0;
+}
+
 uint32_t FakeSnapshotCloneMetaStore::GetSnapshotCount() {
     return snapInfos_.size();
 }
@@ -41,6 +41,11 @@ class FakeSnapshotCloneMetaStore : public SnapshotCloneMetaStore {
     int GetSnapshotList(const std::string &filename,
                         std::vector<SnapshotInfo> *v) override;
     int GetSnapshotList(std::vector<SnapshotInfo> *list) override;
+    int GetSnapshotListByPage(const SnapshotListFilter &filter,
+                              uint64_t offset,
+                              uint64_t limit,
+                              std::vector<SnapshotInfo> *list,
+                              uint64_t *total) override;
     uint32_t GetSnapshotCount() override;
 
     int AddCloneInfo(const CloneInfo &cloneInfo) override;
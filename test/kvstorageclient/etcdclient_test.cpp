@@ -281,11 +281,27 @@ TEST_F(TestEtcdClinetImp, test_EtcdClientInterface) {
     ASSERT_EQ(newFileInfo7.filename(), fileinfo.filename());
     ASSERT_EQ(newFileInfo7.filetype(), fileinfo.filetype());
 
-    // 9. test more Txn err
+    // 9. test Txn err, same key in one Txn
     ops.emplace_back(op8);
     ops.emplace_back(op9);
     ASSERT_EQ(EtcdErrCode::EtcdInvalidArgument, client_->TxnN(ops));
 
+    // test Txn with more than 3 ops
+    std::vector<std::string> txnKeys{"txn1", "txn2", "txn3", "txn4"};
+    ops.clear();
+    for (auto &txnKey : txnKeys) {
+        ops.emplace_back(Operation{ OpType::OpPut,
+            const_cast<char *>(txnKey.c_str()),
+            const_cast<char *>(txnKey.c_str()),
+            txnKey.size(), txnKey.size() });
+    }
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->TxnN(ops));
+    for (auto &txnKey : txnKeys) {
+        ASSERT_EQ(EtcdErrCode::EtcdOK, client_->Get(txnKey, &out));
+        ASSERT_EQ(txnKey, out);
+        ASSERT_EQ(EtcdErrCode::EtcdOK, client_->Delete(txnKey));
+    }
+
     // 10. abnormal
     ops.clear();
     ops.emplace_back(op3);
@@ -54,6 +54,13 @@ class MockChunkServerClient : public ChunkServerClient {
         ChunkID chunkId,
         uint64_t sn));
 
+    MOCK_METHOD5(DeleteChunkBatch,
+        int(ChunkServerIdType csId,
+        LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn));
+
     MOCK_METHOD4(GetLeader,
         int(ChunkServerIdType csId,
         LogicalPoolID logicalPoolId,
@@ -26,6 +26,7 @@
 #include <brpc/controller.h>
 #include <brpc/channel.h>
 #include <brpc/server.h>
+#include <brpc/errno.pb.h>
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
@@ -49,6 +50,8 @@ using ::curve::chunkserver::MockChunkService;
 using ::curve::chunkserver::MockCliService;
 using ::curve::chunkserver::ChunkRequest;
 using ::curve::chunkserver::ChunkResponse;
+using ::curve::chunkserver::DeleteChunkBatchRequest;
+using ::curve::chunkserver::DeleteChunkBatchResponse;
 using ::curve::chunkserver::CHUNK_OP_TYPE;
 using ::curve::chunkserver::CHUNK_OP_STATUS;
 using ::curve::chunkserver::CHUNK_OP_STATUS_FAILURE_UNKNOWN;
@@ -793,6 +796,117 @@ TEST_F(TestChunkServerClient, TestDeleteChunkReturnNotLeader) {
     ASSERT_EQ(kCsClientNotLeader, ret);
 }
 
+TEST_F(TestChunkServerClient, TestDeleteChunkBatchSuccess) {
+    uint32_t port = listenAddr_.port;
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    EXPECT_CALL(*chunkService, DeleteChunkBatch(_, _, _, _))
+        .WillOnce(Invoke([&](RpcController *controller,
+                             const DeleteChunkBatchRequest *request,
+                             DeleteChunkBatchResponse *response,
+                             Closure *done){
+                    brpc::ClosureGuard doneGuard(done);
+                    ASSERT_EQ(logicalPoolId, request->logicpoolid());
+                    ASSERT_EQ(copysetId, request->copysetid());
+                    ASSERT_EQ(sn, request->sn());
+                    ASSERT_EQ(chunkIds.size(), request->chunkid_size());
+                    for (int i = 0; i < request->chunkid_size(); i++) {
+                        ASSERT_EQ(chunkIds[i], request->chunkid(i));
+                        response->add_chunkstatus(
+                            CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+                    }
+                    response->set_status(
+                        CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+                }));
+
+    int ret = client_->DeleteChunkBatch(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+}
+
+TEST_F(TestChunkServerClient, TestDeleteChunkBatchReturnNotLeader) {
+    uint32_t port = listenAddr_.port;
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    DeleteChunkBatchResponse response;
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+    EXPECT_CALL(*chunkService, DeleteChunkBatch(_, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(response),
+                Invoke([](RpcController *controller,
+                          const DeleteChunkBatchRequest *request,
+                          DeleteChunkBatchResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                    })));
+
+    int ret = client_->DeleteChunkBatch(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientNotLeader, ret);
+}
+
+TEST_F(TestChunkServerClient, TestDeleteChunkBatchNotSupport) {
+    uint32_t port = listenAddr_.port;
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    // 未升级的chunkserver返回ENOMETHOD，不再重试
+    EXPECT_CALL(*chunkService, DeleteChunkBatch(_, _, _, _))
+        .WillOnce(Invoke([](RpcController *controller,
+                            const DeleteChunkBatchRequest *request,
+                            DeleteChunkBatchResponse *response,
+                            Closure *done){
+                    brpc::ClosureGuard doneGuard(done);
+                    brpc::Controller *cntl =
+                        static_cast<brpc::Controller *>(controller);
+                    cntl->SetFailed(brpc::ENOMETHOD, "Fail to find method");
+                }));
+
+    int ret = client_->DeleteChunkBatch(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientNotSupport, ret);
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
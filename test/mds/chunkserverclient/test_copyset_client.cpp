@@ -401,6 +401,61 @@ TEST_F(TestCopysetClient, TestDeleteChunkRedirectFail) {
         logicalPoolId, copysetId, chunkId, sn);
     ASSERT_EQ(kMdsFail, ret);
 }
+TEST_F(TestCopysetClient, TestDeleteChunkBatchRedirectSuccess) {
+    ChunkServerIdType leader = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    ChunkServerIdType newLeader = 0x02;
+    EXPECT_CALL(*mockCsClient_, DeleteChunkBatch(
+            leader, logicalPoolId, copysetId, chunkIds, sn))
+        .WillOnce(Return(kCsClientNotLeader));
+    EXPECT_CALL(*mockCsClient_, DeleteChunkBatch(
+            newLeader, logicalPoolId, copysetId, chunkIds, sn))
+        .WillOnce(Return(kMdsSuccess));
+
+    EXPECT_CALL(*mockCsClient_, GetLeader(
+        _, logicalPoolId, copysetId, _))
+        .WillOnce(DoAll(SetArgPointee<3>(newLeader),
+                Return(kMdsSuccess)));
+
+    int ret = client_->DeleteChunkBatch(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+}
+
+TEST_F(TestCopysetClient, TestDeleteChunkBatchFail) {
+    ChunkServerIdType leader = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    EXPECT_CALL(*mockCsClient_, DeleteChunkBatch(
+            leader, logicalPoolId, copysetId, chunkIds, sn))
+        .WillOnce(Return(kCsClientReturnFail));
+
+    int ret = client_->DeleteChunkBatch(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientReturnFail, ret);
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <set>
+#include "src/mds/heartbeat/copyset_report_cache.h"
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+using ::curve::mds::topology::CopySetInfo;
+
+TEST(CopysetReportCacheTest, test_record_and_compare) {
+    CopysetReportCache cache(4);
+    CopySetInfo report(1, 1);
+    report.SetEpoch(10);
+    report.SetLeader(1);
+    report.SetCopySetMembers(std::set<ChunkServerIdType>{1, 2, 3});
+
+    // not recorded yet
+    ASSERT_FALSE(cache.IsSameAsLast(report));
+    cache.Record(report);
+    ASSERT_TRUE(cache.IsSameAsLast(report));
+    ASSERT_EQ(1, cache.Size());
+
+    // epoch changed
+    CopySetInfo changed = report;
+    changed.SetEpoch(11);
+    ASSERT_FALSE(cache.IsSameAsLast(changed));
+
+    // leader changed
+    changed = report;
+    changed.SetLeader(2);
+    ASSERT_FALSE(cache.IsSameAsLast(changed));
+
+    // members changed
+    changed = report;
+    changed.SetCopySetMembers(std::set<ChunkServerIdType>{1, 2, 4});
+    ASSERT_FALSE(cache.IsSameAsLast(changed));
+
+    // candidate changed
+    changed = report;
+    changed.SetCandidate(4);
+    ASSERT_FALSE(cache.IsSameAsLast(changed));
+
+    // other copyset
+    CopySetInfo other(1, 2);
+    ASSERT_FALSE(cache.IsSameAsLast(other));
+    cache.Record(other);
+    ASSERT_EQ(2, cache.Size());
+
+    cache.Invalidate(report.GetCopySetKey());
+    ASSERT_FALSE(cache.IsSameAsLast(report));
+    ASSERT_TRUE(cache.IsSameAsLast(other));
+
+    cache.Clear();
+    ASSERT_EQ(0, cache.Size());
+    ASSERT_FALSE(cache.IsSameAsLast(other));
+}
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
@@ -22,10 +22,14 @@
 
 #include <gtest/gtest.h>
 #include <glog/logging.h>
+#include <brpc/controller.h>
+#include <brpc/errno.pb.h>
 #include <sys/time.h>
+#include <thread>  //NOLINT
 #include "src/mds/heartbeat/heartbeat_manager.h"
 #include "src/mds/heartbeat/chunkserver_healthy_checker.h"
 #include "src/common/timeutility.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "test/mds/mock/mock_coordinator.h"
 #include "test/mds/mock/mock_topology.h"
 #include "test/mds/mock/mock_topoAdapter.h"
@@ -34,9 +38,11 @@
 using ::testing::Return;
 using ::testing::SetArgPointee;
 using ::testing::DoAll;
+using ::testing::Invoke;
 using ::testing::_;
 using ::curve::mds::topology::MockTopology;
 using ::curve::mds::topology::MockTopologyStat;
+using ::curve::common::CountDownEvent;
 
 namespace curve {
 namespace mds {
@@ -662,7 +668,7 @@ TEST_F(TestHeartbeatManager,
         .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
     EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
         .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
-    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
         .WillOnce(Return(::curve::mds::topology::kTopoErrCodeInternalError));
     heartbeatManager_->ChunkServerHeartbeat(request, &response);
     ASSERT_EQ(0, response.needupdatecopysets_size());
@@ -744,7 +750,7 @@ TEST_F(TestHeartbeatManager, test_handle_copysetInfo_equal_epoch) {
         .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
     EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
         .WillOnce(Return(false));
-    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
         .WillOnce(Return(::curve::mds::topology::kTopoErrCodeInternalError));
     heartbeatManager_->ChunkServerHeartbeat(request, &response);
     ASSERT_EQ(0, response.needupdatecopysets_size());
@@ -788,7 +794,7 @@ TEST_F(TestHeartbeatManager, test_handle_copysetInfo_equal_epoch) {
         .WillOnce(DoAll(SetArgPointee<2>(chunkServer2), Return(true)))
         .WillOnce(DoAll(SetArgPointee<2>(chunkServer3), Return(true)))
         .WillOnce(DoAll(SetArgPointee<2>(chunkServer4), Return(true)));
-    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
         .WillOnce(Return(::curve::mds::topology::kTopoErrCodeInternalError));
     EXPECT_CALL(*topology_, GetCopySet(_, _))
         .Times(2)
@@ -829,7 +835,7 @@ TEST_F(TestHeartbeatManager, test_handle_copysetInfo_equal_epoch) {
         .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
     EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
         .WillOnce(Return(false));
-    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
         .WillOnce(Return(::curve::mds::topology::kTopoErrCodeSuccess));
     heartbeatManager_->ChunkServerHeartbeat(request, &response);
     ASSERT_EQ(0, response.needupdatecopysets_size());
@@ -915,6 +921,207 @@ TEST_F(TestHeartbeatManager, test_patrol_copySetInfo_return_order) {
     ASSERT_EQ(TRANSFER_LEADER, response.needupdatecopysets(0).type());
     ASSERT_EQ(3, response.needupdatecopysets(0).peers_size());
 }
+
+TEST_F(TestHeartbeatManager, test_skip_unchanged_copyset_report) {
+    HeartbeatOption option;
+    option.cleanFollowerAfterMs = 0;
+    option.heartbeatMissTimeOutMs = 10000;
+    option.offLineTimeOutMs = 30000;
+    option.mdsStartTime = steady_clock::now();
+    option.enableCopysetReportDiff = true;
+    auto heartbeatManager = std::make_shared<HeartbeatManager>(
+        option, topology_, topologyStat_, coordinator_);
+
+    auto request = GetChunkServerHeartbeatRequestForTest();
+    ::curve::mds::topology::ChunkServer chunkServer1(
+        1, "hello", "", 1, "192.168.10.1", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer2(
+        2, "hello", "", 1, "192.168.10.2", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer3(
+        3, "hello", "", 1, "192.168.10.3", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.1", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.2", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer2), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.3", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillRepeatedly(Return(::curve::mds::topology::UNINTIALIZE_ID));
+
+    // 1. topology record falls behind, report need to be applied
+    ::curve::mds::topology::CopySetInfo copySetInfo(1, 1);
+    copySetInfo.SetEpoch(9);
+    copySetInfo.SetLeader(1);
+    copySetInfo.SetCopySetMembers(std::set<ChunkServerIdType>{1, 2, 3});
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
+        .WillOnce(Return(::curve::mds::topology::kTopoErrCodeSuccess));
+    ChunkServerHeartbeatResponse response;
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+
+    // 2. same report again, only CopysetConfGenerator get the copyset
+    copySetInfo.SetEpoch(10);
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(1)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_)).Times(0);
+    response.Clear();
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+
+    // 3. report changed, compare with topology again
+    request.mutable_copysetinfos(0)->set_epoch(11);
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
+        .WillOnce(Return(::curve::mds::topology::kTopoErrCodeInternalError));
+    response.Clear();
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+
+    // 4. last update failed, so the report is not recorded
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*topology_, BatchUpdateCopySetTopo(_))
+        .WillOnce(Return(::curve::mds::topology::kTopoErrCodeSuccess));
+    response.Clear();
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+}
+
+class HeartbeatDoneClosure : public google::protobuf::Closure {
+ public:
+    explicit HeartbeatDoneClosure(CountDownEvent *event) : event_(event) {}
+    void Run() override {
+        event_->Signal();
+    }
+
+ private:
+    CountDownEvent *event_;
+};
+
+TEST_F(TestHeartbeatManager, test_heartbeat_async_dispatch_to_shard) {
+    HeartbeatOption option;
+    option.cleanFollowerAfterMs = 0;
+    option.heartbeatMissTimeOutMs = 10000;
+    option.offLineTimeOutMs = 30000;
+    option.mdsStartTime = steady_clock::now();
+    option.workerShardNum = 4;
+    option.workerQueueCapacity = 16;
+    auto heartbeatManager = std::make_shared<HeartbeatManager>(
+        option, topology_, topologyStat_, coordinator_);
+
+    EXPECT_CALL(*topology_, GetChunkServer(_, _))
+        .WillRepeatedly(Return(false));
+
+    // 1. shards not running, handled in place
+    {
+        auto request = GetChunkServerHeartbeatRequestForTest();
+        ChunkServerHeartbeatResponse response;
+        CountDownEvent event(1);
+        HeartbeatDoneClosure done(&event);
+        brpc::Controller cntl;
+        heartbeatManager->ChunkServerHeartbeatAsync(
+            &cntl, &request, &response, &done);
+        event.Wait();
+        ASSERT_EQ(HeartbeatStatusCode::hbChunkserverUnknown,
+                  response.statuscode());
+    }
+
+    // 2. shards running, handled by worker shards
+    heartbeatManager->Run();
+    {
+        const int num = 10;
+        std::vector<ChunkServerHeartbeatRequest> requests(num);
+        std::vector<ChunkServerHeartbeatResponse> responses(num);
+        std::vector<brpc::Controller> cntls(num);
+        CountDownEvent event(num);
+        HeartbeatDoneClosure done(&event);
+        for (int i = 0; i < num; i++) {
+            requests[i] = GetChunkServerHeartbeatRequestForTest();
+            requests[i].set_chunkserverid(i + 1);
+            heartbeatManager->ChunkServerHeartbeatAsync(
+                &cntls[i], &requests[i], &responses[i], &done);
+        }
+        event.Wait();
+        for (int i = 0; i < num; i++) {
+            ASSERT_EQ(HeartbeatStatusCode::hbChunkserverUnknown,
+                      responses[i].statuscode());
+        }
+    }
+    heartbeatManager->Stop();
+}
+
+TEST_F(TestHeartbeatManager, test_heartbeat_async_reject_and_stop) {
+    HeartbeatOption option;
+    option.cleanFollowerAfterMs = 0;
+    option.heartbeatMissTimeOutMs = 10000;
+    option.offLineTimeOutMs = 30000;
+    option.mdsStartTime = steady_clock::now();
+    option.workerShardNum = 1;
+    option.workerQueueCapacity = 1;
+    auto heartbeatManager = std::make_shared<HeartbeatManager>(
+        option, topology_, topologyStat_, coordinator_);
+    heartbeatManager->Run();
+
+    // the first heartbeat blocks the only worker thread
+    CountDownEvent blocked(1);
+    CountDownEvent release(1);
+    EXPECT_CALL(*topology_, GetChunkServer(_, _))
+        .WillOnce(Invoke([&](ChunkServerIdType, ChunkServer *) {
+            blocked.Signal();
+            release.Wait();
+            return false;
+        }))
+        .WillRepeatedly(Return(false));
+
+    const int num = 3;
+    std::vector<ChunkServerHeartbeatRequest> requests(num);
+    std::vector<ChunkServerHeartbeatResponse> responses(num);
+    std::vector<brpc::Controller> cntls(num);
+    CountDownEvent event(num);
+    HeartbeatDoneClosure done(&event);
+    for (int i = 0; i < num; i++) {
+        requests[i] = GetChunkServerHeartbeatRequestForTest();
+    }
+
+    heartbeatManager->ChunkServerHeartbeatAsync(
+        &cntls[0], &requests[0], &responses[0], &done);
+    blocked.Wait();
+    // the second one waits in the queue
+    heartbeatManager->ChunkServerHeartbeatAsync(
+        &cntls[1], &requests[1], &responses[1], &done);
+    // the queue is full, the third one is rejected without blocking
+    heartbeatManager->ChunkServerHeartbeatAsync(
+        &cntls[2], &requests[2], &responses[2], &done);
+    ASSERT_TRUE(cntls[2].Failed());
+    ASSERT_EQ(brpc::ELIMIT, cntls[2].ErrorCode());
+
+    // stop with a queued heartbeat, its done runs with an error
+    std::thread stopThread([&]() {
+        heartbeatManager->Stop();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    release.Signal();
+    stopThread.join();
+    event.Wait();
+
+    ASSERT_FALSE(cntls[0].Failed());
+    ASSERT_EQ(HeartbeatStatusCode::hbChunkserverUnknown,
+              responses[0].statuscode());
+    ASSERT_TRUE(cntls[1].Failed());
+    ASSERT_EQ(brpc::ELOGOFF, cntls[1].ErrorCode());
+}
 }  // namespace heartbeat
 }  // namespace mds
 }  // namespace curve
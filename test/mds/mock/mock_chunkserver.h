@@ -45,6 +45,12 @@ class MockChunkService : public ChunkService {
         const ChunkRequest *request,
         ChunkResponse *response,
         Closure *done));
+
+    MOCK_METHOD4(DeleteChunkBatch,
+        void(RpcController *controller,
+        const DeleteChunkBatchRequest *request,
+        DeleteChunkBatchResponse *response,
+        Closure *done));
 };
 
 class MockCliService : public CliService2 {
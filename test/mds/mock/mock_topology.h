@@ -127,6 +127,9 @@ class MockTopology : public Topology {
     MOCK_METHOD1(UpdateCopySetTopo,
         int(const ::curve::mds::topology::CopySetInfo &data));
 
+    MOCK_METHOD1(BatchUpdateCopySetTopo,
+        int(const std::vector<::curve::mds::topology::CopySetInfo> &datas));
+
     MOCK_METHOD2(SetCopySetAvalFlag, int(const CopySetKey &, bool));
 
     MOCK_METHOD3(UpdateCopySetAllocInfo,
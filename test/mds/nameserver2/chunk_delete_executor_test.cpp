@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <map>
+#include <mutex>  //NOLINT
+#include <thread>  //NOLINT
+#include <vector>
+
+#include "src/mds/nameserver2/chunk_delete_executor.h"
+#include "test/mds/mock/mock_topology.h"
+#include "test/mds/nameserver2/mock/mock_copyset_client.h"
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::Invoke;
+using ::testing::AnyNumber;
+using ::curve::mds::topology::MockTopology;
+using ::curve::mds::chunkserverclient::ChunkServerClientOption;
+using ::curve::mds::chunkserverclient::MockCopysetClient;
+
+namespace curve {
+namespace mds {
+
+class ChunkDeleteExecutorTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        topology_ = std::make_shared<MockTopology>();
+        ChunkServerClientOption option;
+        client_ = std::make_shared<MockCopysetClient>(topology_, option,
+            std::make_shared<ChannelPool>());
+    }
+
+    // 生成segmentNum个segment，第i个chunk位于copyset (i % copysetNum + 1)
+    std::vector<PageFileSegment> MakeSegments(uint32_t segmentNum,
+                                              uint32_t chunkPerSegment,
+                                              uint32_t copysetNum) {
+        std::vector<PageFileSegment> segments;
+        ChunkID chunkId = 1;
+        for (uint32_t i = 0; i < segmentNum; i++) {
+            PageFileSegment segment;
+            segment.set_logicalpoolid(1);
+            segment.set_segmentsize(kGB);
+            segment.set_chunksize(16 * kMB);
+            segment.set_startoffset(i * kGB);
+            for (uint32_t j = 0; j < chunkPerSegment; j++, chunkId++) {
+                auto chunk = segment.add_chunks();
+                chunk->set_chunkid(chunkId);
+                chunk->set_copysetid(chunkId % copysetNum + 1);
+            }
+            segments.push_back(segment);
+        }
+        return segments;
+    }
+
+    std::shared_ptr<MockTopology> topology_;
+    std::shared_ptr<MockCopysetClient> client_;
+};
+
+TEST_F(ChunkDeleteExecutorTest, test_delete_in_caller_thread) {
+    ChunkDeleteOption option;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    auto segments = MakeSegments(2, 4, 2);
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .Times(8)
+        .WillRepeatedly(Return(kMdsSuccess));
+    EXPECT_CALL(*client_, DeleteChunkBatch(_, _, _, _)).Times(0);
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunks(segments, 10));
+
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .WillOnce(Return(kMdsSuccess))
+        .WillOnce(Return(kCsClientReturnFail));
+    ASSERT_EQ(kCsClientReturnFail, executor.DeleteChunks(segments, 10));
+    executor.Stop();
+}
+
+TEST_F(ChunkDeleteExecutorTest, test_delete_chunk_batch_by_copyset) {
+    ChunkDeleteOption option;
+    option.threadNum = 4;
+    option.maxInflightPerTask = 8;
+    option.batchSize = 3;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    // 2个copyset各4个chunk，每个copyset拆成3+1两个请求
+    auto segments = MakeSegments(2, 4, 2);
+    std::mutex mtx;
+    std::map<CopysetID, std::vector<ChunkID>> deleted;
+    EXPECT_CALL(*client_, DeleteChunkBatch(1, _, _, 10))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](LogicalPoolID, CopysetID copysetId,
+                                   const std::vector<ChunkID> &chunkIds,
+                                   uint64_t) {
+            EXPECT_EQ(3, chunkIds.size());
+            std::lock_guard<std::mutex> lk(mtx);
+            auto &ids = deleted[copysetId];
+            ids.insert(ids.end(), chunkIds.begin(), chunkIds.end());
+            return kMdsSuccess;
+        }));
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](LogicalPoolID, CopysetID copysetId,
+                                   ChunkID chunkId, uint64_t) {
+            std::lock_guard<std::mutex> lk(mtx);
+            deleted[copysetId].push_back(chunkId);
+            return kMdsSuccess;
+        }));
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunks(segments, 10));
+
+    ASSERT_EQ(2, deleted.size());
+    for (auto &item : deleted) {
+        ASSERT_EQ(4, item.second.size());
+        for (ChunkID chunkId : item.second) {
+            ASSERT_EQ(item.first, chunkId % 2 + 1);
+        }
+    }
+    executor.Stop();
+}
+
+TEST_F(ChunkDeleteExecutorTest, test_fall_back_when_batch_not_support) {
+    ChunkDeleteOption option;
+    option.threadNum = 1;
+    option.batchSize = 4;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    // chunkserver未升级，第一个批量请求失败后所有chunk都逐个删除
+    auto segments = MakeSegments(2, 4, 2);
+    EXPECT_CALL(*client_, DeleteChunkBatch(1, _, _, 10))
+        .WillOnce(Return(kCsClientNotSupport));
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .Times(8)
+        .WillRepeatedly(Return(kMdsSuccess));
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunks(segments, 10));
+
+    EXPECT_CALL(*client_, DeleteChunkBatch(_, _, _, _)).Times(0);
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .Times(8)
+        .WillRepeatedly(Return(kMdsSuccess));
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunks(segments, 10));
+    executor.Stop();
+}
+
+TEST_F(ChunkDeleteExecutorTest, test_inflight_limit) {
+    ChunkDeleteOption option;
+    option.threadNum = 8;
+    option.maxInflightPerTask = 4;
+    option.maxInflightPerCopyset = 1;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    auto segments = MakeSegments(4, 8, 8);
+    std::mutex mtx;
+    uint32_t inflight = 0;
+    uint32_t maxInflight = 0;
+    std::map<CopysetID, uint32_t> copysetInflight;
+    uint32_t maxCopysetInflight = 0;
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .Times(32)
+        .WillRepeatedly(Invoke([&](LogicalPoolID, CopysetID copysetId,
+                                   ChunkID, uint64_t) {
+            {
+                std::lock_guard<std::mutex> lk(mtx);
+                inflight++;
+                maxInflight = std::max(maxInflight, inflight);
+                uint32_t n = ++copysetInflight[copysetId];
+                maxCopysetInflight = std::max(maxCopysetInflight, n);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            {
+                std::lock_guard<std::mutex> lk(mtx);
+                inflight--;
+                copysetInflight[copysetId]--;
+            }
+            return kMdsSuccess;
+        }));
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunks(segments, 10));
+    ASSERT_LE(maxInflight, 4);
+    ASSERT_GT(maxInflight, 1);
+    ASSERT_EQ(1, maxCopysetInflight);
+    executor.Stop();
+}
+
+TEST_F(ChunkDeleteExecutorTest, test_stop_dispatch_after_fail) {
+    ChunkDeleteOption option;
+    option.threadNum = 2;
+    option.maxInflightPerTask = 1;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    auto segments = MakeSegments(1, 8, 4);
+    EXPECT_CALL(*client_, DeleteChunk(1, _, _, 10))
+        .WillOnce(Return(kMdsSuccess))
+        .WillOnce(Return(kRpcFail));
+    ASSERT_EQ(kRpcFail, executor.DeleteChunks(segments, 10));
+    executor.Stop();
+}
+
+TEST_F(ChunkDeleteExecutorTest, test_delete_chunk_snapshots) {
+    ChunkDeleteOption option;
+    option.threadNum = 4;
+    option.maxInflightPerTask = 4;
+    option.batchSize = 4;
+    ChunkDeleteExecutor executor(client_, option);
+    ASSERT_EQ(0, executor.Start());
+
+    // 快照的删除没有批量接口，按chunk逐个删除
+    auto segments = MakeSegments(2, 4, 2);
+    EXPECT_CALL(*client_, DeleteChunkSnapshotOrCorrectSn(1, _, _, 11))
+        .Times(8)
+        .WillRepeatedly(Return(kMdsSuccess));
+    EXPECT_CALL(*client_, DeleteChunkBatch(_, _, _, _)).Times(0);
+    ASSERT_EQ(kMdsSuccess, executor.DeleteChunkSnapshots(segments, 11));
+    executor.Stop();
+}
+
+}  // namespace mds
+}  // namespace curve
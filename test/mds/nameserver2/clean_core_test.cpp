@@ -28,9 +28,13 @@
 #include "test/mds/mock/mock_topology.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "test/mds/mock/mock_alloc_statistic.h"
+#include "test/mds/nameserver2/mock/mock_copyset_client.h"
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+using ::curve::mds::chunkserverclient::MockCopysetClient;
 using curve::mds::topology::MockTopology;
 using ::curve::mds::chunkserverclient::ChunkServerClientOption;
 
@@ -267,5 +271,96 @@ TEST(CleanCore, testcleanfile) {
         ASSERT_EQ(progress.GetStatus(), TaskStatus::FAILED);
     }
 }
+TEST(CleanCore, testcleanfilewithchunkdeleter) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<MockCopysetClient>(topology,
+                                                      option, channelPool);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    ChunkDeleteOption deleteOption;
+    deleteOption.threadNum = 2;
+    deleteOption.maxInflightPerTask = 4;
+    deleteOption.batchSize = 2;
+    deleteOption.segmentWindow = 4;
+    auto chunkDeleter =
+        std::make_shared<ChunkDeleteExecutor>(client, deleteOption);
+    ASSERT_EQ(0, chunkDeleter->Start());
+    auto cleanCore = std::make_shared<CleanCore>(storage, client,
+                                                 allocStatistic, chunkDeleter);
+
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(0);
+    for (int i = 0; i < 4; i++) {
+        auto chunk = segment.add_chunks();
+        chunk->set_chunkid(i + 1);
+        chunk->set_copysetid(i % 2 + 1);
+    }
+
+    uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+    FileInfo cleanFile;
+    cleanFile.set_id(1);
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+    cleanFile.set_seqnum(1);
+
+    {
+        // mds切换前已经清理了前两个segment，从第三个segment继续
+        for (uint32_t i = 0; i < segmentNum; i++) {
+            if (i < 2) {
+                EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                    .WillOnce(Return(StoreStatus::KeyNotExist));
+            } else {
+                EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                    .WillOnce(DoAll(SetArgPointee<2>(segment),
+                                    Return(StoreStatus::OK)));
+                EXPECT_CALL(*storage,
+                            DeleteSegment(_, i * DefaultSegmentSize, _))
+                    .WillOnce(Return(StoreStatus::OK));
+            }
+        }
+        // 每个window内每个copyset的chunk两两打包
+        EXPECT_CALL(*client, DeleteChunkBatch(1, _, _, 1))
+            .Times(16)
+            .WillRepeatedly(Return(kMdsSuccess));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _))
+            .Times(segmentNum - 2);
+        EXPECT_CALL(*storage, DeleteFile(_, _))
+            .WillOnce(Return(StoreStatus::OK));
+
+        TaskProgress progress;
+        ASSERT_EQ(cleanCore->CleanFile(cleanFile, &progress),
+            StatusCode::kOK);
+        ASSERT_EQ(progress.GetStatus(), TaskStatus::SUCCESS);
+        ASSERT_EQ(progress.GetProgress(), 100);
+    }
+
+    {
+        // chunk删除失败时不删除segment，保留进度供下次重试
+        for (uint32_t i = 0; i < 4; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(DoAll(SetArgPointee<2>(segment),
+                                Return(StoreStatus::OK)));
+        }
+        EXPECT_CALL(*client, DeleteChunkBatch(1, _, _, 1))
+            .WillRepeatedly(Return(kCsClientReturnFail));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _))
+            .Times(0);
+        EXPECT_CALL(*storage, DeleteFile(_, _))
+            .Times(0);
+
+        TaskProgress progress;
+        ASSERT_EQ(cleanCore->CleanFile(cleanFile, &progress),
+            StatusCode::kCommonFileDeleteError);
+        ASSERT_EQ(progress.GetStatus(), TaskStatus::FAILED);
+        ASSERT_EQ(progress.GetProgress(), 0);
+    }
+    chunkDeleter->Stop();
+}
+
 }  // namespace mds
 }  // namespace curve
@@ -2730,6 +2730,118 @@ TEST_F(CurveFSTest, GetSnapShotFileSegment) {
     }
 }
 
+TEST_F(CurveFSTest, ListSegment) {
+    std::vector<PageFileSegment> segments;
+    offset_t nextOffset;
+    FileInfo fileInfo;
+    {
+        // directory not supported
+        ASSERT_EQ(curvefs_->ListSegment("/", 0, 0, 10, &segments,
+            &nextOffset, &fileInfo), StatusCode::kNotSupported);
+    }
+
+    FileInfo originalFile;
+    originalFile.set_id(1);
+    originalFile.set_seqnum(2);
+    originalFile.set_segmentsize(DefaultSegmentSize);
+    originalFile.set_length(3 * DefaultSegmentSize);
+    originalFile.set_filename("originalFile");
+    originalFile.set_filetype(FileType::INODE_PAGEFILE);
+
+    std::vector<PageFileSegment> storeSegments;
+    for (int i = 0; i < 3; i++) {
+        PageFileSegment segment;
+        segment.set_logicalpoolid(1);
+        segment.set_segmentsize(DefaultSegmentSize);
+        segment.set_chunksize(curvefs_->GetDefaultChunkSize());
+        segment.set_startoffset(i * DefaultSegmentSize);
+        storeSegments.push_back(segment);
+    }
+    {
+        // offset not align
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(originalFile),
+            Return(StoreStatus::OK)));
+
+        ASSERT_EQ(curvefs_->ListSegment("/originalFile", 0, 1, 10, &segments,
+            &nextOffset, &fileInfo), StatusCode::kParaError);
+    }
+    {
+        // storage list fail
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(originalFile),
+            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(1, 0, 10, _))
+        .WillOnce(Return(StoreStatus::InternalError));
+
+        ASSERT_EQ(curvefs_->ListSegment("/originalFile", 0, 0, 10, &segments,
+            &nextOffset, &fileInfo), StatusCode::kStorageError);
+    }
+    {
+        // page full, return next offset
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(originalFile),
+            Return(StoreStatus::OK)));
+        std::vector<PageFileSegment> page(storeSegments.begin(),
+                                          storeSegments.begin() + 2);
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(1, 0, 2, _))
+        .WillOnce(DoAll(SetArgPointee<3>(page),
+            Return(StoreStatus::OK)));
+
+        ASSERT_EQ(curvefs_->ListSegment("/originalFile", 0, 0, 2, &segments,
+            &nextOffset, &fileInfo), StatusCode::kOK);
+        ASSERT_EQ(2, segments.size());
+        ASSERT_EQ(2 * DefaultSegmentSize, nextOffset);
+        ASSERT_EQ(originalFile.length(), fileInfo.length());
+    }
+    {
+        // last page, limit 0 use default limit
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(originalFile),
+            Return(StoreStatus::OK)));
+        std::vector<PageFileSegment> page(storeSegments.begin() + 2,
+                                          storeSegments.end());
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(1, 2 * DefaultSegmentSize,
+                                                    kListSegmentDefaultLimit,
+                                                    _))
+        .WillOnce(DoAll(SetArgPointee<3>(page),
+            Return(StoreStatus::OK)));
+
+        ASSERT_EQ(curvefs_->ListSegment("/originalFile", 0,
+            2 * DefaultSegmentSize, 0, &segments, &nextOffset, &fileInfo),
+            StatusCode::kOK);
+        ASSERT_EQ(1, segments.size());
+        ASSERT_EQ(2 * DefaultSegmentSize, segments[0].startoffset());
+        ASSERT_EQ(0, nextOffset);
+    }
+    {
+        // snapshot, segments beyond snapshot length are filtered
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<2>(originalFile),
+            Return(StoreStatus::OK)));
+
+        std::vector<FileInfo> snapShotFiles;
+        FileInfo snapInfo;
+        snapInfo.set_seqnum(1);
+        snapInfo.set_segmentsize(DefaultSegmentSize);
+        snapInfo.set_length(2 * DefaultSegmentSize);
+        snapShotFiles.push_back(snapInfo);
+        EXPECT_CALL(*storage_, ListSnapshotFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(snapShotFiles),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(1, 0, 3, _))
+        .WillOnce(DoAll(SetArgPointee<3>(storeSegments),
+            Return(StoreStatus::OK)));
+
+        ASSERT_EQ(curvefs_->ListSegment("/originalFile", 1, 0, 3, &segments,
+            &nextOffset, &fileInfo), StatusCode::kOK);
+        ASSERT_EQ(2, segments.size());
+        ASSERT_EQ(0, nextOffset);
+        ASSERT_EQ(snapInfo.length(), fileInfo.length());
+    }
+}
+
 TEST_F(CurveFSTest, DeleteFileSnapShotFile) {
     {
         // GetSnapShotFileInfo error
@@ -3267,7 +3379,7 @@ TEST_F(CurveFSTest, testOpenFile) {
             .Times(2)
             .WillRepeatedly(Return(StoreStatus::OK));
 
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(_, _, _, _))
             .WillOnce(Return(StoreStatus::InternalError));
 
         CloneSourceSegment sourceSegment;
@@ -3290,9 +3402,9 @@ TEST_F(CurveFSTest, testOpenFile) {
             .WillRepeatedly(Return(StoreStatus::OK));
 
         std::vector<PageFileSegment> segments;
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(_, _, _, _))
             .WillOnce(
-                DoAll(SetArgPointee<1>(segments), Return(StoreStatus::OK)));
+                DoAll(SetArgPointee<3>(segments), Return(StoreStatus::OK)));
 
         CloneSourceSegment sourceSegment;
         ASSERT_EQ(curvefs_->OpenFile("/file1", "127.0.0.1", &protoSession,
@@ -3334,9 +3446,9 @@ TEST_F(CurveFSTest, testOpenFile) {
 
         std::vector<PageFileSegment> segments{segment1, segment2};
 
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(_, _, _, _))
             .WillOnce(
-                DoAll(SetArgPointee<1>(segments), Return(StoreStatus::OK)));
+                DoAll(SetArgPointee<3>(segments), Return(StoreStatus::OK)));
 
         CloneSourceSegment sourceSegment;
         ASSERT_EQ(curvefs_->OpenFile("/file1", "127.0.0.1", &protoSession,
@@ -4010,13 +4122,13 @@ TEST_F(CurveFSTest, ListAllVolumesOnCopyset) {
         std::vector<PageFileSegment> segVec1 = {segment};
         std::vector<PageFileSegment> segVec2 = {segment2};
         std::vector<PageFileSegment> segVec3 = {segment3};
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(_, _, _, _))
         .Times(3)
-        .WillOnce(DoAll(SetArgPointee<1>(segVec1),
+        .WillOnce(DoAll(SetArgPointee<3>(segVec1),
                     Return(StoreStatus::OK)))
-        .WillOnce(DoAll(SetArgPointee<1>(segVec2),
+        .WillOnce(DoAll(SetArgPointee<3>(segVec2),
                     Return(StoreStatus::OK)))
-        .WillOnce(DoAll(SetArgPointee<1>(segVec3),
+        .WillOnce(DoAll(SetArgPointee<3>(segVec3),
                     Return(StoreStatus::OK)));
         ASSERT_EQ(StatusCode::kOK,
                     curvefs_->ListVolumesOnCopyset(copysetVec, &fileNames));
@@ -4041,7 +4153,7 @@ TEST_F(CurveFSTest, ListAllVolumesOnCopyset) {
                     Return(StoreStatus::OK)))
         .WillOnce(DoAll(SetArgPointee<2>(fileVec2),
                     Return(StoreStatus::OK)));
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(_, _, _, _))
         .Times(1)
         .WillOnce(Return(StoreStatus::KeyNotExist));
         ASSERT_EQ(StatusCode::kStorageError,
@@ -308,6 +308,30 @@ class FakeNameServerStorage : public NameServerStorage {
         return StoreStatus::OK;
     }
 
+    StoreStatus ListSegmentWithLimit(InodeID id,
+                            uint64_t startOffset,
+                            uint32_t limit,
+                            std::vector<PageFileSegment> *segments) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::string startStoreKey =
+                NameSpaceStorageCodec::EncodeSegmentStoreKey(id, startOffset);
+        std::string endStoreKey =
+                NameSpaceStorageCodec::EncodeSegmentStoreKey(id + 1, 0);
+
+        uint32_t count = 0;
+        for (auto iter = memKvMap_.lower_bound(startStoreKey);
+             iter != memKvMap_.end() && count < limit; iter++, count++) {
+            if (iter->first.compare(endStoreKey) >= 0) {
+                break;
+            }
+            PageFileSegment segment;
+            segment.ParseFromString(iter->second);
+            segments->push_back(segment);
+        }
+
+        return StoreStatus::OK;
+    }
+
     StoreStatus ListSnapshotFile(InodeID startid,
                          InodeID endid,
                          std::vector<FileInfo> * files) override {
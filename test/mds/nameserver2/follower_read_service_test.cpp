@@ -0,0 +1,387 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <brpc/controller.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/mds/nameserver2/follower_read_service.h"
+#include "src/common/authenticator.h"
+#include "src/common/timeutility.h"
+#include "test/mds/nameserver2/mock/mock_namespace_storage.h"
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+using ::curve::common::Authenticator;
+using ::curve::common::TimeUtility;
+
+namespace curve {
+namespace mds {
+
+class FollowerReadServiceTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        storage_ = std::make_shared<MockNameServerStorage>();
+        RootAuthOption authOption;
+        authOption.rootOwner = "root";
+        authOption.rootPassword = "root_password";
+        service_ = std::make_shared<FollowerReadService>(storage_,
+                                                         authOption);
+
+        dir_.set_id(1);
+        dir_.set_parentid(ROOTINODEID);
+        dir_.set_filename("dir");
+        dir_.set_filetype(FileType::INODE_DIRECTORY);
+        dir_.set_owner("owner");
+
+        file_.set_id(2);
+        file_.set_parentid(1);
+        file_.set_filename("file");
+        file_.set_filetype(FileType::INODE_PAGEFILE);
+        file_.set_owner("owner");
+    }
+
+    std::string RootSignature(uint64_t date) {
+        std::string str2sig = Authenticator::GetString2Signature(date, "root");
+        return Authenticator::CalcString2Signature(str2sig, "root_password");
+    }
+
+ protected:
+    std::shared_ptr<MockNameServerStorage> storage_;
+    std::shared_ptr<FollowerReadService> service_;
+    FileInfo dir_;
+    FileInfo file_;
+};
+
+TEST_F(FollowerReadServiceTest, GetFileInfo) {
+    uint64_t date = TimeUtility::GetTimeofDayUs();
+
+    // 1. path invalid
+    {
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kParaError, response.statuscode());
+    }
+
+    // 2. request staled
+    {
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date - kStaledRequestTimeIntervalUs * 2);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOwnerAuthFail, response.statuscode());
+    }
+
+    // 3. success
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFile(1, "file", _))
+            .WillOnce(DoAll(SetArgPointee<2>(file_),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+        ASSERT_EQ(2, response.fileinfo().id());
+    }
+
+    // 4. owner of the parent directory mismatch
+    {
+        FileInfo otherDir = dir_;
+        otherDir.set_owner("other");
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(otherDir),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOwnerAuthFail, response.statuscode());
+        ASSERT_FALSE(response.has_fileinfo());
+    }
+
+    // 5. file not exist
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFile(1, "file", _))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kFileNotExists, response.statuscode());
+    }
+
+    // 6. intermediate is not a directory
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(file_),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kNotDirectory, response.statuscode());
+    }
+
+    // 7. storage error
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(Return(StoreStatus::InternalError));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kStorageError, response.statuscode());
+    }
+
+    // 8. root user reads any file with signature
+    {
+        FileInfo otherFile = file_;
+        otherFile.set_owner("other");
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFile(1, "file", _))
+            .WillOnce(DoAll(SetArgPointee<2>(otherFile),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("root");
+        request.set_date(date);
+        request.set_signature(RootSignature(date));
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+        ASSERT_EQ("other", response.fileinfo().owner());
+    }
+
+    // 9. root user with wrong signature
+    {
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("root");
+        request.set_date(date);
+        request.set_signature("wrong");
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOwnerAuthFail, response.statuscode());
+    }
+
+    // 10. root directory
+    {
+        brpc::Controller cntl;
+        GetFileInfoRequest request;
+        GetFileInfoResponse response;
+        request.set_filename("/");
+        request.set_owner("root");
+        request.set_date(date);
+        request.set_signature(RootSignature(date));
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+        ASSERT_EQ(ROOTINODEID, response.fileinfo().id());
+        ASSERT_EQ(FileType::INODE_DIRECTORY, response.fileinfo().filetype());
+
+        request.set_owner("owner");
+        service_->GetFileInfo(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOwnerAuthFail, response.statuscode());
+    }
+}
+
+TEST_F(FollowerReadServiceTest, ListDir) {
+    uint64_t date = TimeUtility::GetTimeofDayUs();
+
+    // 1. success
+    {
+        std::vector<FileInfo> files{file_};
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(1, 2, _))
+            .WillOnce(DoAll(SetArgPointee<2>(files),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        ListDirRequest request;
+        ListDirResponse response;
+        request.set_filename("/dir");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->ListDir(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+        ASSERT_EQ(1, response.fileinfo_size());
+        ASSERT_EQ("file", response.fileinfo(0).filename());
+    }
+
+    // 2. not a directory
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFile(1, "file", _))
+            .WillOnce(DoAll(SetArgPointee<2>(file_),
+                            Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        ListDirRequest request;
+        ListDirResponse response;
+        request.set_filename("/dir/file");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->ListDir(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kNotDirectory, response.statuscode());
+    }
+
+    // 3. list storage error
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dir_),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(1, 2, _))
+            .WillOnce(Return(StoreStatus::InternalError));
+        brpc::Controller cntl;
+        ListDirRequest request;
+        ListDirResponse response;
+        request.set_filename("/dir");
+        request.set_owner("owner");
+        request.set_date(date);
+        service_->ListDir(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kStorageError, response.statuscode());
+        ASSERT_EQ(0, response.fileinfo_size());
+    }
+
+    // 4. directory not exist for root user
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir", _))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        brpc::Controller cntl;
+        ListDirRequest request;
+        ListDirResponse response;
+        request.set_filename("/dir");
+        request.set_owner("root");
+        request.set_date(date);
+        request.set_signature(RootSignature(date));
+        service_->ListDir(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kDirNotExist, response.statuscode());
+    }
+}
+
+TEST_F(FollowerReadServiceTest, ListVolumesOnCopysets) {
+    // /dir/file has a chunk on copyset (1, 10), /file2 on copyset (1, 20)
+    FileInfo file2 = file_;
+    file2.set_id(3);
+    file2.set_parentid(ROOTINODEID);
+    file2.set_filename("file2");
+    PageFileSegment segment1;
+    segment1.set_logicalpoolid(1);
+    segment1.set_startoffset(0);
+    segment1.add_chunks()->set_copysetid(10);
+    PageFileSegment segment2 = segment1;
+    segment2.mutable_chunks(0)->set_copysetid(20);
+    std::vector<FileInfo> rootFiles{dir_, file2};
+    std::vector<FileInfo> dirFiles{file_};
+
+    // 1. success
+    {
+        EXPECT_CALL(*storage_, ListFile(ROOTINODEID, ROOTINODEID + 1, _))
+            .WillOnce(DoAll(SetArgPointee<2>(rootFiles),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(1, 2, _))
+            .WillOnce(DoAll(SetArgPointee<2>(dirFiles),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(2, 0, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<3>(std::vector<PageFileSegment>{segment1}),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(3, 0, _, _))
+            .WillOnce(DoAll(
+                SetArgPointee<3>(std::vector<PageFileSegment>{segment2}),
+                Return(StoreStatus::OK)));
+        brpc::Controller cntl;
+        ListVolumesOnCopysetsRequest request;
+        ListVolumesOnCopysetsResponse response;
+        auto copyset = request.add_copysets();
+        copyset->set_logicalpoolid(1);
+        copyset->set_copysetid(10);
+        service_->ListVolumesOnCopysets(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+        ASSERT_EQ(1, response.filenames_size());
+        ASSERT_EQ("file", response.filenames(0));
+    }
+
+    // 2. list segment storage error
+    {
+        EXPECT_CALL(*storage_, ListFile(ROOTINODEID, ROOTINODEID + 1, _))
+            .WillOnce(DoAll(SetArgPointee<2>(rootFiles),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(1, 2, _))
+            .WillOnce(DoAll(SetArgPointee<2>(dirFiles),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegmentWithLimit(2, 0, _, _))
+            .WillOnce(Return(StoreStatus::InternalError));
+        brpc::Controller cntl;
+        ListVolumesOnCopysetsRequest request;
+        ListVolumesOnCopysetsResponse response;
+        auto copyset = request.add_copysets();
+        copyset->set_logicalpoolid(1);
+        copyset->set_copysetid(10);
+        service_->ListVolumesOnCopysets(&cntl, &request, &response, nullptr);
+        ASSERT_EQ(StatusCode::kStorageError, response.statuscode());
+        ASSERT_EQ(0, response.filenames_size());
+    }
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -84,6 +84,9 @@ class MockNameServerStorage : public NameServerStorage {
         StoreStatus(std::vector<FileInfo> *snapShotFiles));
     MOCK_METHOD2(ListSegment,
         StoreStatus(InodeID, std::vector<PageFileSegment>*));
+    MOCK_METHOD4(ListSegmentWithLimit,
+        StoreStatus(InodeID, uint64_t, uint32_t,
+                    std::vector<PageFileSegment>*));
 };
 
 }  // namespace mds
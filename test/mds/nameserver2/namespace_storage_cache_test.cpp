@@ -22,6 +22,7 @@
 
 #include <gtest/gtest.h>
 #include <glog/logging.h>
+#include <unistd.h>
 #include <memory>
 #include <string>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
@@ -157,6 +158,38 @@ TEST(CaCheTest, TestCacheHitAndMissMetric) {
     ASSERT_EQ(10, cache->GetCacheMetrics()->cacheMiss.get_value());
 }
 
+TEST(CaCheTest, TestTimedLRUCache) {
+    auto metrics = std::make_shared<NameserverCacheMetrics>(
+        "test_timed_lru_cache");
+    TimedLRUCache cache(2, 100, metrics);
+
+    // 1. 未过期的元素可以读到
+    std::string out;
+    cache.Put("1", "one");
+    ASSERT_TRUE(cache.Get("1", &out));
+    ASSERT_EQ("one", out);
+
+    // 2. 超过容量后最旧的元素被剔出
+    cache.Put("2", "two");
+    cache.Put("3", "three");
+    ASSERT_FALSE(cache.Get("1", &out));
+    ASSERT_TRUE(cache.Get("2", &out));
+    ASSERT_EQ("two", out);
+
+    // 3. 过期的元素读不到, 并且被删除
+    ::usleep(150 * 1000);
+    ASSERT_FALSE(cache.Get("2", &out));
+    ASSERT_FALSE(cache.Get("3", &out));
+    ASSERT_EQ(0, metrics->cacheCount.get_value());
+
+    // 4. 重新put后刷新过期时间
+    cache.Put("2", "two");
+    ASSERT_TRUE(cache.Get("2", &out));
+    ASSERT_EQ("two", out);
+    cache.Remove("2");
+    ASSERT_FALSE(cache.Get("2", &out));
+}
+
 
 }  // namespace mds
 }  // namespace curve
@@ -439,5 +439,46 @@ TEST_F(TestNameServerStorageImp, test_ListSegment) {
     ASSERT_EQ(segment.DebugString(), segments[0].DebugString());
 }
 
+TEST_F(TestNameServerStorageImp, test_ListSegmentWithLimit) {
+    std::string startKey =
+        NameSpaceStorageCodec::EncodeSegmentStoreKey(1, 1024);
+    std::string endKey =
+        NameSpaceStorageCodec::EncodeSegmentStoreKey(2, 0);
+
+    // 1. list err
+    std::vector<PageFileSegment> segments;
+    EXPECT_CALL(*client_, ListWithLimitAndRevision(
+        startKey, endKey, 10, 0, _, _))
+        .WillOnce(Return(EtcdErrCode::EtcdCanceled));
+    ASSERT_EQ(StoreStatus::InternalError,
+        storage_->ListSegmentWithLimit(1, 1024, 10, &segments));
+
+    // 2. decode err
+    EXPECT_CALL(*client_, ListWithLimitAndRevision(
+        startKey, endKey, 10, 0, _, _))
+        .WillOnce(DoAll(
+            SetArgPointee<4>(std::vector<std::string>{"hello"}),
+            Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(StoreStatus::InternalError,
+        storage_->ListSegmentWithLimit(1, 1024, 10, &segments));
+
+    // 3. list ok
+    segments.clear();
+    std::string key, encodeSegment;
+    PageFileSegment segment;
+    GetPageFileSegmentForTest(&key, &segment);
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &encodeSegment));
+    EXPECT_CALL(*client_, ListWithLimitAndRevision(
+        startKey, endKey, 10, 0, _, _))
+        .WillOnce(DoAll(
+            SetArgPointee<4>(
+                std::vector<std::string>{encodeSegment, encodeSegment}),
+            Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(StoreStatus::OK,
+        storage_->ListSegmentWithLimit(1, 1024, 10, &segments));
+    ASSERT_EQ(2, segments.size());
+    ASSERT_EQ(segment.DebugString(), segments[1].DebugString());
+}
+
 }  // namespace mds
 }  // namespace curve
@@ -2579,6 +2579,101 @@ TEST_F(TestTopology, UpdateCopySetTopo_CopySetNotFound) {
     ASSERT_EQ(kTopoErrCodeCopySetNotFound, ret);
 }
 
+TEST_F(TestTopology, BatchUpdateCopySetTopo_success) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddZone(0x22, "zone2", physicalPoolId);
+    PrepareAddZone(0x23, "zone3", physicalPoolId);
+    PrepareAddServer(
+        0x31, "server1", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x21, 0x11);
+    PrepareAddServer(
+        0x32, "server2", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x22, 0x11);
+    PrepareAddServer(
+        0x33, "server3", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x23, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x32, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x44, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    std::set<ChunkServerIdType> replicas;
+    replicas.insert(0x41);
+    replicas.insert(0x42);
+    replicas.insert(0x43);
+    PrepareAddCopySet(0x51, logicalPoolId, replicas);
+    PrepareAddCopySet(0x52, logicalPoolId, replicas);
+
+    std::set<ChunkServerIdType> replicas2;
+    replicas2.insert(0x41);
+    replicas2.insert(0x42);
+    replicas2.insert(0x44);
+
+    std::vector<CopySetInfo> infos;
+    for (CopySetIdType id : {0x51, 0x52}) {
+        CopySetInfo csInfo(logicalPoolId, id);
+        csInfo.SetEpoch(2);
+        csInfo.SetLeader(0x42);
+        csInfo.SetCopySetMembers(replicas2);
+        csInfo.SetCandidate(0x43);
+        infos.emplace_back(csInfo);
+    }
+
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->BatchUpdateCopySetTopo(infos));
+
+    for (CopySetIdType id : {0x51, 0x52}) {
+        CopySetInfo out;
+        ASSERT_TRUE(topology_->GetCopySet(
+            CopySetKey(logicalPoolId, id), &out));
+        ASSERT_EQ(2, out.GetEpoch());
+        ASSERT_EQ(0x42, out.GetLeader());
+        ASSERT_EQ(replicas2, out.GetCopySetMembers());
+        ASSERT_EQ(0x43, out.GetCandidate());
+        ASSERT_TRUE(out.GetDirtyFlag());
+    }
+}
+
+TEST_F(TestTopology, BatchUpdateCopySetTopo_CopySetNotFound) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddZone(0x22, "zone2", physicalPoolId);
+    PrepareAddZone(0x23, "zone3", physicalPoolId);
+    PrepareAddServer(
+        0x31, "server1", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x21, 0x11);
+    PrepareAddServer(
+        0x32, "server2", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x22, 0x11);
+    PrepareAddServer(
+        0x33, "server3", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x23, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x32, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    std::set<ChunkServerIdType> replicas;
+    replicas.insert(0x41);
+    replicas.insert(0x42);
+    replicas.insert(0x43);
+    PrepareAddCopySet(0x51, logicalPoolId, replicas);
+
+    std::vector<CopySetInfo> infos;
+    CopySetInfo exist(logicalPoolId, 0x51);
+    exist.SetEpoch(3);
+    exist.SetCopySetMembers(replicas);
+    infos.emplace_back(exist);
+    infos.emplace_back(CopySetInfo(logicalPoolId, 0x52));
+
+    ASSERT_EQ(kTopoErrCodeCopySetNotFound,
+        topology_->BatchUpdateCopySetTopo(infos));
+
+    // copyset which exists still get updated
+    CopySetInfo out;
+    ASSERT_TRUE(topology_->GetCopySet(CopySetKey(logicalPoolId, 0x51), &out));
+    ASSERT_EQ(3, out.GetEpoch());
+}
+
 TEST_F(TestTopology, GetCopySet_success) {
     PoolIdType logicalPoolId = 0x01;
     PoolIdType physicalPoolId = 0x11;
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>  //NOLINT
+#include <vector>
+
+#include "src/mds/topology/topology_copyset_store.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+namespace {
+CopySetInfo MakeCopySet(PoolIdType poolId, CopySetIdType id,
+    const std::set<ChunkServerIdType> &members) {
+    CopySetInfo info(poolId, id);
+    info.SetCopySetMembers(members);
+    return info;
+}
+
+bool PersistOk(const CopySetInfo &) {
+    return true;
+}
+
+bool RemoveOk(const CopySetKey &) {
+    return true;
+}
+}  // namespace
+
+TEST(TestCopySetStore, test_add_get_remove) {
+    CopySetStore store(4);
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        store.Add(MakeCopySet(1, 1, {1, 2, 3}), PersistOk));
+    ASSERT_EQ(kTopoErrCodeIdDuplicated,
+        store.Add(MakeCopySet(1, 1, {1, 2, 3}), PersistOk));
+    ASSERT_EQ(kTopoErrCodeStorgeFail,
+        store.Add(MakeCopySet(1, 2, {1, 2, 3}),
+            [] (const CopySetInfo &) { return false; }));
+    ASSERT_EQ(1, store.Size());
+
+    CopySetInfo out;
+    ASSERT_TRUE(store.Get(CopySetKey(1, 1), &out));
+    ASSERT_EQ(3, out.GetCopySetMembers().size());
+    ASSERT_FALSE(store.Get(CopySetKey(1, 2), &out));
+
+    ASSERT_EQ(kTopoErrCodeStorgeFail, store.Remove(CopySetKey(1, 1),
+        [] (const CopySetKey &) { return false; }));
+    ASSERT_EQ(kTopoErrCodeSuccess, store.Remove(CopySetKey(1, 1), RemoveOk));
+    ASSERT_EQ(kTopoErrCodeCopySetNotFound,
+        store.Remove(CopySetKey(1, 1), RemoveOk));
+    ASSERT_EQ(0, store.Size());
+    ASSERT_TRUE(store.GetCopySetsInChunkServer(1).empty());
+}
+
+TEST(TestCopySetStore, test_modify_and_chunkserver_index) {
+    CopySetStore store(4);
+    std::map<CopySetKey, CopySetInfo> copysets;
+    copysets.emplace(CopySetKey(1, 1), MakeCopySet(1, 1, {1, 2, 3}));
+    copysets.emplace(CopySetKey(1, 2), MakeCopySet(1, 2, {2, 3, 4}));
+    copysets.emplace(CopySetKey(2, 1), MakeCopySet(2, 1, {1, 3, 4}));
+    store.Init(copysets);
+
+    auto keys = store.GetCopySetsInChunkServer(1);
+    ASSERT_EQ(2, keys.size());
+    ASSERT_EQ(CopySetKey(1, 1), keys[0]);
+    ASSERT_EQ(CopySetKey(2, 1), keys[1]);
+
+    // replace 1 with 5 in copyset (1, 1)
+    ASSERT_EQ(kTopoErrCodeSuccess, store.Modify(CopySetKey(1, 1),
+        [] (CopySetInfo *info) {
+            info->SetCopySetMembers({2, 3, 5});
+            info->SetEpoch(2);
+            return kTopoErrCodeSuccess;
+        }));
+    keys = store.GetCopySetsInChunkServer(1);
+    ASSERT_EQ(1, keys.size());
+    ASSERT_EQ(CopySetKey(2, 1), keys[0]);
+    keys = store.GetCopySetsInChunkServer(5);
+    ASSERT_EQ(1, keys.size());
+    ASSERT_EQ(CopySetKey(1, 1), keys[0]);
+
+    // failed modification do not change the version
+    uint64_t version = store.Version();
+    ASSERT_EQ(kTopoErrCodeStorgeFail, store.Modify(CopySetKey(1, 1),
+        [] (CopySetInfo *info) {
+            return kTopoErrCodeStorgeFail;
+        }));
+    ASSERT_EQ(version, store.Version());
+    ASSERT_EQ(kTopoErrCodeCopySetNotFound, store.Modify(CopySetKey(3, 1),
+        [] (CopySetInfo *info) {
+            return kTopoErrCodeSuccess;
+        }));
+
+    CopySetInfo out;
+    ASSERT_TRUE(store.Get(CopySetKey(1, 1), &out));
+    ASSERT_EQ(2, out.GetEpoch());
+}
+
+TEST(TestCopySetStore, test_batch_modify) {
+    const uint32_t stripeNum = 4;
+    CopySetStore store(stripeNum);
+    for (CopySetIdType id = 1; id <= 8; id++) {
+        ASSERT_EQ(kTopoErrCodeSuccess,
+            store.Add(MakeCopySet(1, id, {1, 2, 3}), PersistOk));
+    }
+    auto snapshot1 = store.GetSnapshot();
+
+    // (1, 100) does not exist, (1, 3) fails, others are still modified
+    std::vector<CopySetKey> keys = {CopySetKey(1, 1), CopySetKey(1, 100),
+        CopySetKey(1, 2), CopySetKey(1, 3), CopySetKey(1, 5)};
+    std::vector<int> rets;
+    uint64_t version = store.Version();
+    ASSERT_EQ(kTopoErrCodeStorgeFail, store.BatchModify(keys,
+        [&keys] (size_t index, CopySetInfo *info) {
+            if (keys[index] == CopySetKey(1, 3)) {
+                return kTopoErrCodeStorgeFail;
+            }
+            info->SetCopySetMembers({2, 3, 4});
+            info->SetEpoch(index + 10);
+            return kTopoErrCodeSuccess;
+        }, &rets));
+    ASSERT_EQ(std::vector<int>({kTopoErrCodeSuccess,
+        kTopoErrCodeCopySetNotFound, kTopoErrCodeSuccess,
+        kTopoErrCodeStorgeFail, kTopoErrCodeSuccess}), rets);
+    // one change of the store for the whole batch
+    ASSERT_EQ(version + 1, store.Version());
+
+    auto snapshot2 = store.GetSnapshot();
+    ASSERT_EQ(10, snapshot2->Find(CopySetKey(1, 1))->GetEpoch());
+    ASSERT_EQ(12, snapshot2->Find(CopySetKey(1, 2))->GetEpoch());
+    ASSERT_EQ(0, snapshot2->Find(CopySetKey(1, 3))->GetEpoch());
+    ASSERT_EQ(14, snapshot2->Find(CopySetKey(1, 5))->GetEpoch());
+    ASSERT_EQ(nullptr, snapshot2->Find(CopySetKey(1, 100)));
+    // the stripe of (1, 4) and (1, 8) is not touched
+    ASSERT_EQ(snapshot1->stripes[0], snapshot2->stripes[0]);
+
+    auto csKeys = store.GetCopySetsInChunkServer(4);
+    ASSERT_EQ(3, csKeys.size());
+    ASSERT_EQ(5, store.GetCopySetsInChunkServer(1).size());
+
+    // nothing modified, nothing changed
+    ASSERT_EQ(kTopoErrCodeCopySetNotFound, store.BatchModify(
+        {CopySetKey(2, 1)},
+        [] (size_t, CopySetInfo *) { return kTopoErrCodeSuccess; },
+        &rets));
+    ASSERT_EQ(version + 1, store.Version());
+}
+
+TEST(TestCopySetStore, test_snapshot) {
+    CopySetStore store(4);
+    for (CopySetIdType id = 1; id <= 10; id++) {
+        ASSERT_EQ(kTopoErrCodeSuccess,
+            store.Add(MakeCopySet(id % 2 + 1, id, {1, 2, 3}), PersistOk));
+    }
+
+    auto snapshot1 = store.GetSnapshot();
+    ASSERT_EQ(10, snapshot1->Size());
+    ASSERT_EQ(store.Version(), snapshot1->version);
+    // sorted by key
+    auto copysets = snapshot1->GetCopySets();
+    ASSERT_EQ(10, copysets.size());
+    ASSERT_EQ(CopySetKey(1, 2), copysets.front()->GetCopySetKey());
+    auto pool2 = snapshot1->GetCopySetsInLogicalPool(2);
+    ASSERT_EQ(5, pool2.size());
+    for (size_t i = 0; i < pool2.size(); i++) {
+        ASSERT_EQ(CopySetKey(2, 2 * i + 1), pool2[i]->GetCopySetKey());
+    }
+    ASSERT_EQ(nullptr, snapshot1->Find(CopySetKey(3, 1)));
+
+    // no change, same snapshot shared
+    auto snapshot2 = store.GetSnapshot();
+    ASSERT_EQ(snapshot1.get(), snapshot2.get());
+
+    // changed, old snapshot is immutable and new one is rebuilt
+    ASSERT_EQ(kTopoErrCodeSuccess, store.Modify(CopySetKey(1, 2),
+        [] (CopySetInfo *info) {
+            info->SetEpoch(10);
+            return kTopoErrCodeSuccess;
+        }));
+    auto snapshot3 = store.GetSnapshot();
+    ASSERT_NE(snapshot1.get(), snapshot3.get());
+    ASSERT_EQ(0, snapshot1->Find(CopySetKey(1, 2))->GetEpoch());
+    ASSERT_EQ(10, snapshot3->Find(CopySetKey(1, 2))->GetEpoch());
+}
+
+TEST(TestCopySetStore, test_snapshot_copy_only_changed_stripe) {
+    const uint32_t stripeNum = 16;
+    CopySetStore store(stripeNum);
+    for (CopySetIdType id = 1; id <= 1000; id++) {
+        ASSERT_EQ(kTopoErrCodeSuccess,
+            store.Add(MakeCopySet(1, id, {1, 2, 3}), PersistOk));
+    }
+    auto snapshot1 = store.GetSnapshot();
+    ASSERT_EQ(stripeNum, snapshot1->stripes.size());
+
+    // a heartbeat update of one copyset only copies the stripe it is in,
+    // the others are shared with the last snapshot
+    ASSERT_EQ(kTopoErrCodeSuccess, store.Modify(CopySetKey(1, 500),
+        [] (CopySetInfo *info) {
+            info->SetLeader(2);
+            return kTopoErrCodeSuccess;
+        }));
+    auto snapshot2 = store.GetSnapshot();
+    ASSERT_NE(snapshot1.get(), snapshot2.get());
+    ASSERT_EQ(1000, snapshot2->Size());
+    ASSERT_EQ(2, snapshot2->Find(CopySetKey(1, 500))->GetLeader());
+    int copied = 0;
+    for (uint32_t i = 0; i < stripeNum; i++) {
+        if (snapshot1->stripes[i] != snapshot2->stripes[i]) {
+            copied++;
+            ASSERT_EQ(1, snapshot2->stripes[i]->copysets.count(
+                CopySetKey(1, 500)));
+        }
+    }
+    ASSERT_EQ(1, copied);
+
+    // a failed modify changes nothing
+    ASSERT_EQ(kTopoErrCodeStorgeFail, store.Modify(CopySetKey(1, 1),
+        [] (CopySetInfo *) { return kTopoErrCodeStorgeFail; }));
+    ASSERT_EQ(snapshot2.get(), store.GetSnapshot().get());
+}
+
+TEST(TestCopySetStore, test_concurrent_modify_and_snapshot) {
+    CopySetStore store(8);
+    const int copysetNum = 100;
+    for (CopySetIdType id = 1; id <= copysetNum; id++) {
+        ASSERT_EQ(kTopoErrCodeSuccess,
+            store.Add(MakeCopySet(1, id, {1, 2, 3}), PersistOk));
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&store, t, copysetNum] () {
+            for (int round = 0; round < 100; round++) {
+                for (CopySetIdType id = t + 1; id <= copysetNum; id += 4) {
+                    store.Modify(CopySetKey(1, id),
+                        [] (CopySetInfo *info) {
+                            info->SetEpoch(info->GetEpoch() + 1);
+                            return kTopoErrCodeSuccess;
+                        });
+                }
+            }
+        });
+    }
+    std::thread reader([&store, &stop, copysetNum] () {
+        while (!stop.load()) {
+            auto snapshot = store.GetSnapshot();
+            ASSERT_EQ(copysetNum, snapshot->Size());
+        }
+    });
+
+    for (auto &t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    reader.join();
+
+    auto snapshot = store.GetSnapshot();
+    for (const CopySetInfo *info : snapshot->GetCopySets()) {
+        ASSERT_EQ(100, info->GetEpoch());
+    }
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
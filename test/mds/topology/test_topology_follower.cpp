@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <brpc/controller.h>
+#include <chrono>  // NOLINT
+#include <map>
+#include <memory>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "src/mds/topology/topology_follower.h"
+#include "test/mds/topology/mock_topology.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+
+class TestTopologyFollower : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        storage_ = std::make_shared<MockStorage>();
+        TopologyOption option;
+        topology_ = std::make_shared<FollowerTopology>(storage_, option, 100);
+        service_ = std::make_shared<FollowerTopologyServiceImpl>(topology_);
+
+        // the follower never writes the storage
+        EXPECT_CALL(*storage_, StorageClusterInfo(_)).Times(0);
+        EXPECT_CALL(*storage_, DeleteLogicalPool(_)).Times(0);
+        EXPECT_CALL(*storage_, DeleteCopySet(_)).Times(0);
+    }
+
+    void TearDown() override {
+        topology_->Stop();
+    }
+
+    void ExpectLoad(
+        const std::unordered_map<PoolIdType, PhysicalPool> &physicalPoolMap) {
+        std::vector<ClusterInformation> infos;
+        std::unordered_map<PoolIdType, LogicalPool> logicalPoolMap;
+        std::unordered_map<ZoneIdType, Zone> zoneMap;
+        std::unordered_map<ServerIdType, Server> serverMap;
+        std::unordered_map<ChunkServerIdType, ChunkServer> chunkServerMap;
+        std::map<CopySetKey, CopySetInfo> copySetMap;
+        // an unavailable logical pool, which is cleaned by TopologyImpl::Init
+        logicalPoolMap[0x01] = LogicalPool(0x01, "lpool1", 0x11, PAGEFILE,
+            LogicalPool::RedundanceAndPlaceMentPolicy(),
+            LogicalPool::UserPolicy(),
+            0, false);
+        copySetMap[std::pair<PoolIdType, CopySetIdType>(0x01, 0x51)] =
+            CopySetInfo(0x01, 0x51);
+
+        EXPECT_CALL(*storage_, LoadClusterInfo(_))
+            .WillOnce(DoAll(SetArgPointee<0>(infos),
+                            Return(true)))
+            .RetiresOnSaturation();
+        EXPECT_CALL(*storage_, LoadLogicalPool(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(logicalPoolMap),
+                            Return(true)));
+        EXPECT_CALL(*storage_, LoadPhysicalPool(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(physicalPoolMap),
+                            Return(true)));
+        EXPECT_CALL(*storage_, LoadZone(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(zoneMap),
+                            Return(true)));
+        EXPECT_CALL(*storage_, LoadServer(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(serverMap),
+                            Return(true)));
+        EXPECT_CALL(*storage_, LoadChunkServer(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(chunkServerMap),
+                            Return(true)));
+        EXPECT_CALL(*storage_, LoadCopySet(_, _))
+            .WillOnce(DoAll(SetArgPointee<0>(copySetMap),
+                            Return(true)));
+    }
+
+    void ListPhysicalPool(brpc::Controller *cntl,
+                          ListPhysicalPoolResponse *response) {
+        ListPhysicalPoolRequest request;
+        service_->ListPhysicalPool(cntl, &request, response, nullptr);
+    }
+
+ protected:
+    std::shared_ptr<MockStorage> storage_;
+    std::shared_ptr<FollowerTopology> topology_;
+    std::shared_ptr<FollowerTopologyServiceImpl> service_;
+};
+
+TEST_F(TestTopologyFollower, test_reload_and_serve) {
+    // 用例：topology加载之前
+    // 预期：请求失败，由client发给leader
+    {
+        brpc::Controller cntl;
+        ListPhysicalPoolResponse response;
+        ListPhysicalPool(&cntl, &response);
+        ASSERT_TRUE(cntl.Failed());
+    }
+
+    // 用例：加载topology
+    // 预期：从加载的topology读，无效的logical pool只从内存删除
+    std::unordered_map<PoolIdType, PhysicalPool> physicalPoolMap;
+    physicalPoolMap[0x11] = PhysicalPool(0x11, "pPool1", "des1");
+    ExpectLoad(physicalPoolMap);
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->Reload());
+    {
+        brpc::Controller cntl;
+        ListPhysicalPoolResponse response;
+        ListPhysicalPool(&cntl, &response);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(kTopoErrCodeSuccess, response.statuscode());
+        ASSERT_EQ(1, response.physicalpoolinfos_size());
+        ASSERT_EQ(0x11, response.physicalpoolinfos(0).physicalpoolid());
+    }
+    {
+        brpc::Controller cntl;
+        ListLogicalPoolRequest request;
+        ListLogicalPoolResponse response;
+        request.set_physicalpoolid(0x11);
+        service_->ListLogicalPool(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(kTopoErrCodeSuccess, response.statuscode());
+        ASSERT_EQ(0, response.logicalpoolinfos_size());
+    }
+
+    // 用例：重新加载topology
+    // 预期：读到新加载的topology
+    physicalPoolMap[0x12] = PhysicalPool(0x12, "pPool2", "des2");
+    ExpectLoad(physicalPoolMap);
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->Reload());
+    {
+        brpc::Controller cntl;
+        ListPhysicalPoolResponse response;
+        ListPhysicalPool(&cntl, &response);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(2, response.physicalpoolinfos_size());
+    }
+}
+
+TEST_F(TestTopologyFollower, test_reload_fail_keep_serving) {
+    std::unordered_map<PoolIdType, PhysicalPool> physicalPoolMap;
+    physicalPoolMap[0x11] = PhysicalPool(0x11, "pPool1", "des1");
+    ExpectLoad(physicalPoolMap);
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->Reload());
+
+    // 用例：重新加载失败
+    // 预期：继续使用上次加载的topology
+    EXPECT_CALL(*storage_, LoadClusterInfo(_))
+        .WillOnce(Return(false));
+    ASSERT_EQ(kTopoErrCodeStorgeFail, topology_->Reload());
+
+    brpc::Controller cntl;
+    ListPhysicalPoolResponse response;
+    ListPhysicalPool(&cntl, &response);
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(kTopoErrCodeSuccess, response.statuscode());
+    ASSERT_EQ(1, response.physicalpoolinfos_size());
+}
+
+TEST_F(TestTopologyFollower, test_run_reload_in_background) {
+    // 只有第一次加载成功
+    EXPECT_CALL(*storage_, LoadClusterInfo(_))
+        .WillRepeatedly(Return(false));
+    std::unordered_map<PoolIdType, PhysicalPool> physicalPoolMap;
+    physicalPoolMap[0x11] = PhysicalPool(0x11, "pPool1", "des1");
+    ExpectLoad(physicalPoolMap);
+
+    // 用例：后台定期重新加载
+    // 预期：reloadIntervalMs之后可以读到topology
+    ASSERT_EQ(nullptr, topology_->GetServiceManager());
+    topology_->Run();
+    for (int i = 0; i < 50 && nullptr == topology_->GetServiceManager();
+         i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    topology_->Stop();
+    ASSERT_NE(nullptr, topology_->GetServiceManager());
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
@@ -72,6 +72,13 @@ class MockSnapshotCore : public SnapshotCore {
     MOCK_METHOD1(GetSnapshotList,
         int(std::vector<SnapshotInfo> *list));
 
+    MOCK_METHOD5(GetSnapshotListByPage,
+        int(const SnapshotListFilter &filter,
+        uint64_t offset,
+        uint64_t limit,
+        std::vector<SnapshotInfo> *list,
+        uint64_t *total));
+
     MOCK_METHOD2(GetSnapshotInfo,
         int(const UUID uuid, SnapshotInfo *info));
 
@@ -91,6 +98,12 @@ class MockSnapshotCloneMetaStore : public SnapshotCloneMetaStore {
             std::vector<SnapshotInfo> *v));
     MOCK_METHOD1(GetSnapshotList,
         int(std::vector<SnapshotInfo> *list));
+    MOCK_METHOD5(GetSnapshotListByPage,
+        int(const SnapshotListFilter &filter,
+            uint64_t offset,
+            uint64_t limit,
+            std::vector<SnapshotInfo> *list,
+            uint64_t *total));
     MOCK_METHOD0(GetSnapshotCount,
         uint32_t());
     MOCK_METHOD1(AddCloneInfo, int(const CloneInfo &info));
@@ -143,6 +156,22 @@ class MockSnapshotDataStore : public SnapshotDataStore {
     MOCK_METHOD2(DataChunkTranferAbort,
         int(const ChunkDataName &name,
              std::shared_ptr<TransferTask> task));
+    MOCK_METHOD2(PutChunkPageDigest,
+        int(const ChunkDataName &name,
+            const ChunkPageDigest &digest));
+    MOCK_METHOD2(GetChunkPageDigest,
+        int(const ChunkDataName &name,
+            ChunkPageDigest *digest));
+    MOCK_METHOD2(PutChunkDeltaData,
+        int(const ChunkDataName &name,
+            const ChunkDeltaData &delta));
+    MOCK_METHOD1(ChunkDeltaDataExist,
+        bool(const ChunkDataName &name));
+    MOCK_METHOD1(DeleteChunkDeltaData,
+        int(const ChunkDataName &name));
+    MOCK_METHOD2(MergeChunkDeltaData,
+        int(const ChunkDataName &name,
+            const ChunkDataName &base));
 };
 
 class MockCurveFsClient : public CurveFsClient {
@@ -168,6 +197,15 @@ class MockCurveFsClient : public CurveFsClient {
         uint64_t seq,
         uint64_t offset,
         SegmentInfo *segInfo));
+
+    MOCK_METHOD7(ListSnapshotSegmentInfo,
+        int(const std::string &filename,
+        const std::string &user,
+        uint64_t seq,
+        uint64_t startOffset,
+        uint32_t limit,
+        std::vector<SegmentInfo> *segInfos,
+        uint64_t *nextOffset));
     MOCK_METHOD6(ReadChunkSnapshot,
         int(ChunkIDInfo cidinfo,
             uint64_t seq,
@@ -214,6 +252,22 @@ class MockCurveFsClient : public CurveFsClient {
         uint64_t len,
         SnapCloneClosure* scc));
 
+    MOCK_METHOD3(CreateCloneChunkBatch,
+        int(const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc));
+
+    MOCK_METHOD3(RecoverChunkBatch,
+        int(const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        SnapCloneClosure* scc));
+
+    MOCK_METHOD4(WriteChunkBulk,
+        int(const ChunkIDInfo &copysetidinfo,
+        std::vector<CloneChunkBatchItem> *items,
+        const char *buf,
+        SnapCloneClosure* scc));
+
     MOCK_METHOD2(CompleteCloneMeta,
         int(const std::string &filename,
         const std::string &user));
@@ -291,6 +345,13 @@ class MockSnapshotServiceManager : public SnapshotServiceManager {
         int(const SnapshotFilterCondition &filter,
         std::vector<FileSnapshotInfo> *info));
 
+    MOCK_METHOD5(GetSnapshotListByPage,
+        int(const SnapshotFilterCondition &filter,
+        uint64_t offset,
+        uint64_t limit,
+        std::vector<FileSnapshotInfo> *info,
+        uint64_t *total));
+
     MOCK_METHOD3(CancelSnapshot,
         int(const UUID &uuid,
         const std::string &user,
@@ -352,6 +413,9 @@ class MockCloneServiceManager : public CloneServiceManager {
         int(const std::string &src,
         CloneRefStatus *refStatus,
         std::vector<CloneInfo> *needCheckFiles));
+
+    MOCK_METHOD1(ReportCloneReadMiss,
+        void(const std::map<uint64_t, uint32_t> &missCounts));
 };
 
 class MockCloneCore : public CloneCore {
@@ -403,6 +467,9 @@ class MockCloneCore : public CloneCore {
 
     MOCK_METHOD1(HandleDeleteCloneInfo,
         int(const CloneInfo &cloneInfo));
+
+    MOCK_METHOD1(ReportCloneReadMiss,
+        void(const std::map<uint64_t, uint32_t> &missCounts));
 };
 
 class MockCloneServiceManagerBackend : public CloneServiceManagerBackend {
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "src/snapshotcloneserver/clone/clone_chunk_heat.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+TEST(TestCloneChunkHeatMap, TestPopHottestChunk) {
+    CloneChunkHeatMap heatMap(10);
+    heatMap.RegisterTask("task1", {1, 2, 3});
+    heatMap.RegisterTask("task2", {4});
+
+    uint64_t chunkId = 0;
+    ASSERT_FALSE(heatMap.PopHottestChunk("task1", &chunkId));
+
+    // 未登记的chunk忽略
+    heatMap.ReportReadMiss({{2, 1}, {3, 5}, {4, 2}, {100, 10}});
+    heatMap.ReportReadMiss({{2, 1}});
+
+    ASSERT_TRUE(heatMap.PopHottestChunk("task1", &chunkId));
+    ASSERT_EQ(3, chunkId);
+    ASSERT_TRUE(heatMap.PopHottestChunk("task1", &chunkId));
+    ASSERT_EQ(2, chunkId);
+    ASSERT_FALSE(heatMap.PopHottestChunk("task1", &chunkId));
+
+    // 已取出的chunk不再记录
+    heatMap.ReportReadMiss({{3, 5}});
+    ASSERT_FALSE(heatMap.PopHottestChunk("task1", &chunkId));
+
+    // 已开始恢复的chunk不再记录
+    heatMap.RemoveChunk(1);
+    heatMap.ReportReadMiss({{1, 5}});
+    ASSERT_FALSE(heatMap.PopHottestChunk("task1", &chunkId));
+
+    ASSERT_TRUE(heatMap.PopHottestChunk("task2", &chunkId));
+    ASSERT_EQ(4, chunkId);
+
+    heatMap.UnregisterTask("task1");
+    ASSERT_FALSE(heatMap.PopHottestChunk("task1", &chunkId));
+}
+
+TEST(TestCloneChunkHeatMap, TestReadMissRate) {
+    CloneChunkHeatMap heatMap(1);
+    heatMap.RegisterTask("task1", {1, 2});
+    ASSERT_EQ(0, heatMap.GetReadMissRate("task1"));
+    ASSERT_EQ(0, heatMap.GetReadMissRate("task2"));
+
+    heatMap.ReportReadMiss({{1, 100}, {2, 100}});
+    // 当前时间窗口未结束
+    ASSERT_EQ(0, heatMap.GetReadMissRate("task1"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    uint64_t rate = heatMap.GetReadMissRate("task1");
+    ASSERT_GT(rate, 0);
+    ASSERT_LE(rate, 200);
+
+    // 没有新的读缺失，速率下降
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    ASSERT_EQ(0, heatMap.GetReadMissRate("task1"));
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
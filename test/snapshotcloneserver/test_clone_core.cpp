@@ -23,10 +23,13 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
+
 #include "src/snapshotcloneserver/clone/clone_core.h"
 #include "src/snapshotcloneserver/clone/clone_task.h"
 #include "src/common/snapshotclone/snapshotclone_define.h"
 #include "src/common/location_operator.h"
+#include "src/common/concurrent/count_down_event.h"
 
 #include "test/snapshotcloneserver/mock_snapshot_server.h"
 
@@ -91,6 +94,9 @@ class TestCloneCoreImpl : public ::testing::Test {
     void MockBuildFileInfoFromFileSuccess(
         std::shared_ptr<CloneTaskInfo> task);
 
+    void MockBuildFileInfoFromDeltaSnapshotSuccess(
+        std::shared_ptr<CloneTaskInfo> task);
+
     void MockCreateCloneFileSuccess(
         std::shared_ptr<CloneTaskInfo> task);
 
@@ -833,6 +839,96 @@ TEST_F(TestCloneCoreImpl,
     core_->HandleCloneOrRecoverTask(task);
 }
 
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskNotMergeDeltaBeforeCreateCloneFile) {
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, true);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    // 创建clone文件失败时还没有开始合并
+    MockBuildFileInfoFromDeltaSnapshotSuccess(task);
+    MockCreateCloneFileFail(task);
+    EXPECT_CALL(*dataStore_, ChunkDataExist(_))
+        .Times(0);
+    EXPECT_CALL(*dataStore_, MergeChunkDeltaData(_, _))
+        .Times(0);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskMergeDeltaOnCreateCloneChunk) {
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, true);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromDeltaSnapshotSuccess(task);
+    // 只合并增量存储的chunk，且在clone文件创建之后
+    ::testing::Sequence seq;
+    FInfo fInfoOut;
+    fInfoOut.id = 100;
+    EXPECT_CALL(*client_, CreateCloneFile(_, _, _, _, _, _, _, _, _))
+        .InSequence(seq)
+        .WillOnce(DoAll(SetArgPointee<8>(fInfoOut),
+                Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*dataStore_, ChunkDataExist(ChunkDataName("file1", 1, 1)))
+        .InSequence(seq)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*dataStore_, MergeChunkDeltaData(
+        ChunkDataName("file1", 1, 1), ChunkDataName("file1", 0, 1)))
+        .InSequence(seq)
+        .WillOnce(Return(kErrCodeSuccess));
+    MockCloneMetaSuccess(task);
+    MockCreateCloneChunkSuccess(task);
+    MockCompleteCloneMetaSuccess(task);
+    MockChangeOwnerSuccess(task);
+    MockRenameCloneFileSuccess(task);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskFailOnMergeDelta) {
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, true);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    // 合并失败时不能进入下一步
+    MockBuildFileInfoFromDeltaSnapshotSuccess(task);
+    MockCreateCloneFileSuccess(task);
+    MockCloneMetaSuccess(task);
+    MockCreateCloneChunkSuccess(task);
+    EXPECT_CALL(*dataStore_, ChunkDataExist(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*dataStore_, MergeChunkDeltaData(_, _))
+        .WillOnce(Return(kErrCodeInternalError));
+    EXPECT_CALL(*client_, CompleteCloneMeta(_, _))
+        .Times(0);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
 TEST_F(TestCloneCoreImpl, HandleCloneOrRecoverTaskFailOnCloneMeta) {
     CloneInfo info("id1", "user1", CloneTaskType::kClone,
     "snapid1", "file1", CloneFileType::kSnapshot, true);
@@ -1118,6 +1214,283 @@ TEST_F(TestCloneCoreImpl,
     core_->HandleCloneOrRecoverTask(task);
 }
 
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskSuccessWithBatchRequest) {
+    option.cloneChunkSplitSize = 256 * 1024;
+    option.createCloneChunkBatchSize = 2;
+    option.recoverChunkBatchPartNum = 3;
+    core_ = std::make_shared<CloneCoreImpl>(client_,
+        metaStore_,
+        dataStore_,
+        snapshotRef_,
+        cloneRef_,
+        option);
+    EXPECT_CALL(*client_, Mkdir(_, _))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(core_->Init(), 0);
+
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, false);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCreateCloneFileSuccess(task);
+
+    // 两个chunk位于同一个copyset
+    SegmentInfo segInfoOut;
+    segInfoOut.segmentsize = 2 * 1024 * 1024;
+    segInfoOut.chunksize = 1024 * 1024;
+    segInfoOut.startoffset = 0;
+    segInfoOut.chunkvec = {{1, 1, 1},
+                           {2, 1, 1}};
+    segInfoOut.lpcpIDInfo.lpid = 1;
+    segInfoOut.lpcpIDInfo.cpidVec = {1};
+    EXPECT_CALL(*client_, GetOrAllocateSegmentInfo(_, 0, _, _, _))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<4>(segInfoOut),
+                Return(LIBCURVE_ERROR::OK)));
+
+    // 一个批量请求创建两个chunk，chunk2已存在不需要恢复
+    EXPECT_CALL(*client_, CreateCloneChunkBatch(_, _, _))
+        .WillOnce(DoAll(
+            Invoke([](const ChunkIDInfo &copysetidinfo,
+                      std::vector<CloneChunkBatchItem> *items,
+                      SnapCloneClosure* scc){
+                    ASSERT_EQ(2, items->size());
+                    ASSERT_EQ(1, copysetidinfo.cpid_);
+                    for (auto &item : *items) {
+                        item.ret = (item.cid == 2) ?
+                            -LIBCURVE_ERROR::EXISTS : LIBCURVE_ERROR::OK;
+                    }
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*client_, CreateCloneChunk(_, _, _, _, _, _))
+        .Times(0);
+    MockCompleteCloneMetaSuccess(task);
+
+    // chunk1的4个分片分两次恢复
+    EXPECT_CALL(*client_, RecoverChunkBatch(_, _, _))
+        .WillOnce(DoAll(
+            Invoke([](const ChunkIDInfo &copysetidinfo,
+                      std::vector<CloneChunkBatchItem> *items,
+                      SnapCloneClosure* scc){
+                    ASSERT_EQ(3, items->size());
+                    for (size_t i = 0; i < items->size(); i++) {
+                        ASSERT_EQ(1, (*items)[i].cid);
+                        ASSERT_EQ(i * 256 * 1024, (*items)[i].offset);
+                        ASSERT_EQ(256 * 1024, (*items)[i].len);
+                    }
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*client_, RecoverChunk(_, 768 * 1024, 256 * 1024, _))
+        .WillOnce(DoAll(
+            Invoke([](const ChunkIDInfo &chunkidinfo,
+                      uint64_t offset,
+                      uint64_t len,
+                      SnapCloneClosure* scc){
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneFileSuccess(task);
+    MockChangeOwnerSuccess(task);
+    MockRenameCloneFileSuccess(task);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskSuccessWithBulkWrite) {
+    option.cloneChunkSplitSize = 256 * 1024;
+    option.bulkRestoreEnable = true;
+    option.bulkWriteMaxSize = 1024 * 1024;
+    core_ = std::make_shared<CloneCoreImpl>(client_,
+        metaStore_,
+        dataStore_,
+        snapshotRef_,
+        cloneRef_,
+        option);
+    EXPECT_CALL(*client_, Mkdir(_, _))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(core_->Init(), 0);
+
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, false);
+    info.SetStatus(CloneStatus::cloning);
+    info.SetIsBulk(true);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCreateCloneFileSuccess(task);
+
+    SegmentInfo segInfoOut;
+    segInfoOut.segmentsize = 2 * 1024 * 1024;
+    segInfoOut.chunksize = 1024 * 1024;
+    segInfoOut.startoffset = 0;
+    segInfoOut.chunkvec = {{1, 1, 1},
+                           {2, 1, 1}};
+    segInfoOut.lpcpIDInfo.lpid = 1;
+    segInfoOut.lpcpIDInfo.cpidVec = {1};
+    EXPECT_CALL(*client_, GetOrAllocateSegmentInfo(_, 0, _, _, _))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<4>(segInfoOut),
+                Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneMetaSuccess(task);
+
+    // chunk1的第3个分片全零，chunk2全零
+    EXPECT_CALL(*dataStore_, GetChunkData(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const ChunkDataName &name,
+                                  ChunkData *data) {
+            data->data_.assign(1024 * 1024, '\0');
+            if (0 == name.chunkIndex_) {
+                std::fill(data->data_.begin(),
+                    data->data_.begin() + 512 * 1024, 'a');
+                std::fill(data->data_.begin() + 768 * 1024,
+                    data->data_.end(), 'b');
+            }
+            return kErrCodeSuccess;
+        }));
+    EXPECT_CALL(*client_, WriteChunkBulk(_, _, _, _))
+        .WillOnce(DoAll(
+            Invoke([](const ChunkIDInfo &copysetidinfo,
+                      std::vector<CloneChunkBatchItem> *items,
+                      const char *buf,
+                      SnapCloneClosure* scc){
+                    ASSERT_EQ(1, copysetidinfo.cpid_);
+                    ASSERT_EQ(2, items->size());
+                    ASSERT_EQ(1, (*items)[0].cid);
+                    ASSERT_EQ(0, (*items)[0].offset);
+                    ASSERT_EQ(512 * 1024, (*items)[0].len);
+                    ASSERT_EQ(1, (*items)[1].cid);
+                    ASSERT_EQ(768 * 1024, (*items)[1].offset);
+                    ASSERT_EQ(256 * 1024, (*items)[1].len);
+                    ASSERT_EQ('a', buf[0]);
+                    ASSERT_EQ('b', buf[512 * 1024]);
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    // 不需要创建clone chunk和恢复chunk
+    EXPECT_CALL(*client_, CreateCloneChunk(_, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*client_, CreateCloneChunkBatch(_, _, _))
+        .Times(0);
+    EXPECT_CALL(*client_, RecoverChunk(_, _, _, _))
+        .Times(0);
+    MockCompleteCloneFileSuccess(task);
+    MockChangeOwnerSuccess(task);
+    MockRenameCloneFileSuccess(task);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskFailOnBulkWriteGetChunkData) {
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, false);
+    info.SetStatus(CloneStatus::cloning);
+    info.SetIsBulk(true);
+    info.SetNextStep(CloneStep::kRecoverChunk);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCloneMetaSuccess(task);
+    // 后续chunk的数据可能已经在预读
+    EXPECT_CALL(*dataStore_, GetChunkData(_, _))
+        .WillRepeatedly(Return(kErrCodeInternalError));
+    EXPECT_CALL(*client_, WriteChunkBulk(_, _, _, _))
+        .Times(0);
+
+    core_->HandleCloneOrRecoverTask(task);
+}
+
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskBulkWritePrefetchChunkData) {
+    option.bulkRestoreEnable = true;
+    option.bulkReadConcurrency = 2;
+    core_ = std::make_shared<CloneCoreImpl>(client_,
+        metaStore_,
+        dataStore_,
+        snapshotRef_,
+        cloneRef_,
+        option);
+    EXPECT_CALL(*client_, Mkdir(_, _))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(core_->Init(), 0);
+
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, false);
+    info.SetStatus(CloneStatus::cloning);
+    info.SetIsBulk(true);
+    info.SetNextStep(CloneStep::kRecoverChunk);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCloneMetaSuccess(task);
+
+    // chunk1的数据在读取chunk2期间返回，说明两个chunk是并发读取的
+    curve::common::CountDownEvent chunk2Reading(1);
+    bool overlapped = false;
+    EXPECT_CALL(*dataStore_, GetChunkData(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](const ChunkDataName &name,
+                                   ChunkData *data) {
+            if (0 == name.chunkIndex_) {
+                overlapped = chunk2Reading.WaitFor(5000);
+            } else {
+                chunk2Reading.Signal();
+            }
+            data->data_.assign(1024 * 1024, 'a');
+            return kErrCodeSuccess;
+        }));
+    EXPECT_CALL(*client_, WriteChunkBulk(_, _, _, _))
+        .WillRepeatedly(DoAll(
+            Invoke([](const ChunkIDInfo &copysetidinfo,
+                      std::vector<CloneChunkBatchItem> *items,
+                      const char *buf,
+                      SnapCloneClosure* scc){
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneFileSuccess(task);
+    MockChangeOwnerSuccess(task);
+    MockRenameCloneFileSuccess(task);
+
+    core_->HandleCloneOrRecoverTask(task);
+    ASSERT_TRUE(overlapped);
+}
+
 void TestCloneCoreImpl::MockBuildFileInfoFromSnapshotSuccess(
     std::shared_ptr<CloneTaskInfo> task) {
     UUID uuid = "uuid1";
@@ -1169,6 +1542,29 @@ void TestCloneCoreImpl::MockBuildFileInfoFromSnapshotSuccess(
                 Return(LIBCURVE_ERROR::OK)));
 }
 
+void TestCloneCoreImpl::MockBuildFileInfoFromDeltaSnapshotSuccess(
+    std::shared_ptr<CloneTaskInfo> task) {
+    uint32_t chunksize = 1024 * 1024;
+    uint64_t segmentsize = 2 * chunksize;
+    SnapshotInfo info("uuid1", "user1", "file1", "snap1",
+        100, chunksize, segmentsize, segmentsize, 0, 0, 100, Status::done);
+    EXPECT_CALL(*metaStore_, GetSnapshotInfo(_, _))
+        .WillRepeatedly(DoAll(
+                SetArgPointee<1>(info),
+                Return(kErrCodeSuccess)));
+
+    // chunk1以chunk1的0号版本为基准按页增量存储
+    ChunkIndexData snapMeta;
+    snapMeta.SetFileName("file1");
+    snapMeta.PutChunkDataName(ChunkDataName("file1", 1, 0));
+    snapMeta.PutChunkDataName(ChunkDataName("file1", 1, 1));
+    snapMeta.PutChunkDeltaBase(1, 0);
+    EXPECT_CALL(*dataStore_, GetChunkIndexData(_, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(snapMeta),
+                    Return(kErrCodeSuccess)));
+}
+
 void TestCloneCoreImpl::MockBuildFileInfoFromFileSuccess(
     std::shared_ptr<CloneTaskInfo> task) {
     FInfo fInfo;
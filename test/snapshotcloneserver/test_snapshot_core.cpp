@@ -40,6 +40,7 @@ using ::testing::AllOf;
 using ::testing::SetArgPointee;
 using ::testing::Invoke;
 using ::testing::DoAll;
+using ::testing::SaveArg;
 
 class TestSnapshotCoreImpl : public ::testing::Test {
  public:
@@ -66,6 +67,10 @@ class TestSnapshotCoreImpl : public ::testing::Test {
                 snapshotRef_,
                 option);
         ASSERT_EQ(core_->Init(), 0);
+
+        // 默认按不支持分页查询处理，走逐个segment查询的流程
+        ON_CALL(*client_, ListSnapshotSegmentInfo(_, _, _, _, _, _, _))
+            .WillByDefault(Return(-LIBCURVE_ERROR::NOT_SUPPORT));
     }
 
     virtual void TearDown() {
@@ -513,6 +518,337 @@ TEST_F(TestSnapshotCoreImpl,
     ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
 }
 
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskDeltaSuccess) {
+    option.snapshotDeltaEnable = true;
+    option.snapshotDeltaPageSize = 4096;
+    core_ = std::make_shared<SnapshotCoreImpl>(client_,
+            metaStore_,
+            dataStore_,
+            snapshotRef_,
+            option);
+    ASSERT_EQ(core_->Init(), 0);
+
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = 2 * snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo1;
+    segInfo1.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo1.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    SegmentInfo segInfo2;
+    segInfo2.chunkvec.push_back(ChunkIDInfo(3, 3, 3));
+    segInfo2.chunkvec.push_back(ChunkIDInfo(4, 4, 4));
+
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+          user,
+          seqNum,
+            _,
+            _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo1),
+                    Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo2),
+                    Return(kErrCodeSuccess)));
+
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    // 第二次写入索引块时记录了基准chunk
+    ChunkIndexData putIndexData;
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SaveArg<1>(&putIndexData),
+                    Return(kErrCodeSuccess)));
+
+    std::vector<SnapshotInfo> snapInfos;
+    SnapshotInfo info2("uuid2", user, fileName, "desc2");
+    info.SetSeqNum(seqNum);
+    info2.SetSeqNum(seqNum - 1);
+    info2.SetStatus(Status::done);
+    snapInfos.push_back(info);
+    snapInfos.push_back(info2);
+
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    // 上一个快照中chunk 0 为全量数据，作为增量转储的基准
+    ChunkIndexData indexData;
+    indexData.SetFileName(fileName);
+    indexData.PutChunkDataName(ChunkDataName(fileName, 1, 0));
+    EXPECT_CALL(*dataStore_, GetChunkIndexData(_, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(indexData),
+                    Return(kErrCodeSuccess)));
+
+    std::string zero(snapInfo.chunksize, 0);
+    ChunkPageDigest baseDigest(snapInfo.chunksize,
+        option.snapshotDeltaPageSize);
+    baseDigest.Update(0, snapInfo.chunksize, zero.c_str());
+    EXPECT_CALL(*dataStore_, GetChunkPageDigest(
+            ChunkDataName(fileName, 1, 0), _))
+        .WillOnce(DoAll(SetArgPointee<1>(baseDigest),
+                    Return(kErrCodeSuccess)));
+
+    // chunk 0 只有第一页发生了变化
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        memset(buf, 0, len);
+                        if (1 == cidinfo.cid_ && 0 == offset) {
+                            buf[0] = 'a';
+                        }
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    ChunkDeltaData delta;
+    EXPECT_CALL(*dataStore_, PutChunkDeltaData(
+            ChunkDataName(fileName, 100, 0), _))
+        .WillOnce(DoAll(SaveArg<1>(&delta),
+                    Return(kErrCodeSuccess)));
+
+    // 其余chunk没有基准，全量转储并存储页摘要
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(6)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, PutChunkPageDigest(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<3>(FileStatus::Deleting),
+                        Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+
+    ChunkDataName base;
+    ASSERT_TRUE(putIndexData.GetChunkDeltaBase(0, &base));
+    ASSERT_EQ(ChunkDataName(fileName, 1, 0), base);
+    ASSERT_FALSE(putIndexData.GetChunkDeltaBase(1, &base));
+    ASSERT_EQ(option.snapshotDeltaPageSize, delta.GetDataSize());
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskListSegmentByPageSuccess) {
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = 2 * snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    LogicPoolID lpid1 = 1;
+    CopysetID cpid1 = 1;
+    ChunkID chunkId1 = 1;
+    LogicPoolID lpid2 = 2;
+    CopysetID cpid2 = 2;
+    ChunkID chunkId2 = 2;
+
+    SegmentInfo segInfo1;
+    segInfo1.chunkvec.push_back(
+        ChunkIDInfo(chunkId1, lpid1, cpid1));
+    segInfo1.chunkvec.push_back(
+        ChunkIDInfo(chunkId2, lpid2, cpid2));
+
+    LogicPoolID lpid3 = 3;
+    CopysetID cpid3 = 3;
+    ChunkID chunkId3 = 3;
+    LogicPoolID lpid4 = 4;
+    CopysetID cpid4 = 4;
+    ChunkID chunkId4 = 4;
+
+    SegmentInfo segInfo2;
+    segInfo2.chunkvec.push_back(
+        ChunkIDInfo(chunkId3, lpid3, cpid3));
+    segInfo2.chunkvec.push_back(
+        ChunkIDInfo(chunkId4, lpid4, cpid4));
+
+    segInfo1.startoffset = 0;
+    segInfo2.startoffset = snapInfo.segmentsize;
+    std::vector<SegmentInfo> page1 = {segInfo1};
+    std::vector<SegmentInfo> page2 = {segInfo2};
+    EXPECT_CALL(*client_, ListSnapshotSegmentInfo(fileName,
+          user,
+          seqNum,
+          0,
+          _, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(page1),
+                    SetArgPointee<6>(snapInfo.segmentsize),
+                    Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*client_, ListSnapshotSegmentInfo(fileName,
+          user,
+          seqNum,
+          snapInfo.segmentsize,
+          _, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(page2),
+                    SetArgPointee<6>(0),
+                    Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(_, _, _, _, _))
+        .Times(0);
+
+    uint64_t chunkSn = 100;
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(chunkSn);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    UUID uuid2 = "uuid2";
+    std::string desc2 = "desc2";
+
+    std::vector<SnapshotInfo> snapInfos;
+    SnapshotInfo info2(uuid2, user, fileName, desc2);
+    info.SetSeqNum(seqNum);
+    info2.SetSeqNum(seqNum - 1);
+    info2.SetStatus(Status::done);
+    snapInfos.push_back(info);
+    snapInfos.push_back(info2);
+
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    ChunkIndexData indexData;
+    indexData.PutChunkDataName(ChunkDataName(fileName, 1, 0));
+    EXPECT_CALL(*dataStore_, GetChunkIndexData(_, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(indexData),
+                    Return(kErrCodeSuccess)));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .Times(4)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(4)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<3>(FileStatus::Deleting),
+                        Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+}
+
 TEST_F(TestSnapshotCoreImpl,
     TestHandleCreateSnapshotTask_CreateSnapshotFail) {
     UUID uuid = "uuid1";
@@ -27,6 +27,14 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "test/snapshotcloneserver/mock_s3_adapter.h"
 using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::SaveArg;
+using ::testing::Lt;
+using ::curve::common::ChunkCodec;
+using ::curve::common::EncodedChunkHeader;
+using ::curve::common::SplitEncodeType;
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -195,6 +203,154 @@ TEST_F(TestS3SnapshotDataStore, testDeleteDataChunk) {
     ASSERT_EQ(-1, store_->DeleteChunkData(cdName));
 }
 
+TEST_F(TestS3SnapshotDataStore, testChunkDeltaDataOp) {
+    ChunkDataName cdName("test", 2, 1);
+    ChunkDataName baseName("test", 1, 1);
+    ChunkDeltaData delta(4);
+    delta.PutPage(1, "bbbb");
+    std::string deltaStr;
+    ASSERT_TRUE(delta.Serialize(&deltaStr));
+
+    EXPECT_CALL(*adapter4Data_, PutObject(Aws::String("test-1-2.delta"), _))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, store_->PutChunkDeltaData(cdName, delta));
+
+    EXPECT_CALL(*adapter4Meta_, ObjectExist(Aws::String("test-1-2.delta")))
+        .WillOnce(Return(true));
+    ASSERT_TRUE(store_->ChunkDeltaDataExist(cdName));
+
+    // 基准chunk与增量合并后写入全量数据对象
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-1"), _))
+        .WillOnce(DoAll(SetArgPointee<1>(std::string("aaaaaaaa")),
+                        Return(0)));
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-2.delta"), _))
+        .WillOnce(DoAll(SetArgPointee<1>(deltaStr),
+                        Return(0)));
+    EXPECT_CALL(*adapter4Data_,
+                PutObject(Aws::String("test-1-2"), std::string("aaaabbbb")))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, store_->MergeChunkDeltaData(cdName, baseName));
+
+    // 基准chunk不存在
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-1"), _))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(-1, store_->MergeChunkDeltaData(cdName, baseName));
+
+    EXPECT_CALL(*adapter4Meta_, DeleteObject(Aws::String("test-1-2.delta")))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, store_->DeleteChunkDeltaData(cdName));
+}
+
+TEST_F(TestS3SnapshotDataStore, testChunkPageDigestOp) {
+    ChunkDataName cdName("test", 1, 1);
+    std::string data(8, 'a');
+    ChunkPageDigest digest(data.size(), 4);
+    digest.Update(0, data.size(), data.c_str());
+    std::string digestStr;
+    ASSERT_TRUE(digest.Serialize(&digestStr));
+
+    EXPECT_CALL(*adapter4Data_,
+                PutObject(Aws::String("test-1-1.digest"), digestStr))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, store_->PutChunkPageDigest(cdName, digest));
+
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-1.digest"), _))
+        .WillOnce(DoAll(SetArgPointee<1>(digestStr),
+                        Return(0)))
+        .WillOnce(Return(-1));
+    ChunkPageDigest out;
+    ASSERT_EQ(0, store_->GetChunkPageDigest(cdName, &out));
+    ASSERT_EQ(4, out.GetPageSize());
+    ASSERT_EQ(2, out.GetPageNum());
+    ASSERT_EQ(-1, store_->GetChunkPageDigest(cdName, &out));
+
+    // 删除全量数据时一并删除页摘要
+    EXPECT_CALL(*adapter4Meta_, ObjectExist(Aws::String("test-1-1.digest")))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*adapter4Meta_, DeleteObject(Aws::String("test-1-1.digest")))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*adapter4Meta_, DeleteObject(Aws::String("test-1-1")))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, store_->DeleteChunkData(cdName));
+}
+
+TEST_F(TestS3SnapshotDataStore, testDataChunkTransferEncoded) {
+    store_->SetEncodeOption(true, 4096);
+    ChunkDataName cdName("test", 1, 1);
+    std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();
+    EXPECT_CALL(*adapter4Data_, MultiUploadInit(_))
+        .WillOnce(Return(Aws::String("test-uploadID")));
+    ASSERT_EQ(0, store_->DataChunkTranferInit(cdName, task));
+    ASSERT_TRUE(task->encoded_);
+
+    // 全零分片不上传，其余分片从第2个part开始上传
+    std::string zero(4096, '\0');
+    std::string same(4096, 'a');
+    EXPECT_CALL(*adapter4Data_, UploadOnePart(_, _, 2, _, _))
+        .Times(0);
+    EXPECT_CALL(*adapter4Data_, UploadOnePart(_, _, 3, Lt(4096), _))
+        .WillOnce(Return(Aws::S3::Model::CompletedPart()
+                         .WithETag("etag3").WithPartNumber(3)));
+    ASSERT_EQ(0, store_->
+              DataChunkTranferAddPart(cdName, task, 0, 4096, zero.data()));
+    ASSERT_EQ(0, store_->
+              DataChunkTranferAddPart(cdName, task, 1, 4096, same.data()));
+
+    // 转储完成时上传头部作为第1个part
+    EncodedChunkHeader header;
+    header.AddSplit({SplitEncodeType::kZero, 4096, 0});
+    header.AddSplit(task->GetSplitInfo()[1]);
+    EXPECT_CALL(*adapter4Data_,
+                UploadOnePart(_, _, 1,
+                              static_cast<int>(header.GetHeaderSize()), _))
+        .WillOnce(Return(Aws::S3::Model::CompletedPart()
+                         .WithETag("etag1").WithPartNumber(1)));
+    Aws::Vector<Aws::S3::Model::CompletedPart> parts;
+    EXPECT_CALL(*adapter4Data_, CompleteMultiUpload(_, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&parts),
+                        Return(0)));
+    ASSERT_EQ(0, store_->DataChunkTranferComplete(cdName, task));
+    ASSERT_EQ(2, parts.size());
+    ASSERT_EQ(1, parts[0].GetPartNumber());
+    ASSERT_EQ(3, parts[1].GetPartNumber());
+
+    // 缺少分片时无法完成转储
+    std::shared_ptr<TransferTask> task2 = std::make_shared<TransferTask>();
+    task2->encoded_ = true;
+    task2->AddSplitInfo(1, header.GetSplits()[1]);
+    ASSERT_EQ(-1, store_->DataChunkTranferComplete(cdName, task2));
+}
+
+TEST_F(TestS3SnapshotDataStore, testMergeChunkDeltaDataEncoded) {
+    store_->SetEncodeOption(true, 4);
+    ChunkDataName cdName("test", 2, 1);
+    ChunkDataName baseName("test", 1, 1);
+    ChunkDeltaData delta(4);
+    delta.PutPage(1, "bbbb");
+    std::string deltaStr;
+    ASSERT_TRUE(delta.Serialize(&deltaStr));
+    std::string base;
+    ASSERT_TRUE(ChunkCodec::EncodeChunk(std::string("aaaa\0\0\0\0", 8),
+                                        4, &base));
+
+    // 编码的基准chunk解码后合并，合并结果编码存储
+    std::string merged;
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-1"), _))
+        .WillOnce(DoAll(SetArgPointee<1>(base),
+                        Return(0)));
+    EXPECT_CALL(*adapter4Data_, GetObject(Aws::String("test-1-2.delta"), _))
+        .WillOnce(DoAll(SetArgPointee<1>(deltaStr),
+                        Return(0)));
+    EXPECT_CALL(*adapter4Data_, PutObject(Aws::String("test-1-2"), _))
+        .WillOnce(DoAll(SaveArg<1>(&merged),
+                        Return(0)));
+    ASSERT_EQ(0, store_->MergeChunkDeltaData(cdName, baseName));
+    EncodedChunkHeader header;
+    ASSERT_TRUE(header.Decode(merged.data(), merged.size()));
+    ASSERT_TRUE(ChunkCodec::DecodeChunk(&merged));
+    ASSERT_EQ("aaaabbbb", merged);
+}
+
 TEST(TestChunkDataName, TestToChunkDataNameSuccess) {
     std::vector<ChunkDataName> testcases = {
         {"file1", 10, 100},
@@ -280,6 +436,64 @@ TEST(TestChunkIndexData, TestGetAllChunkIndex) {
     ASSERT_EQ(100, ret[0]);
 }
 
+TEST(TestChunkIndexData, TestChunkDeltaBase) {
+    ChunkIndexData indexData;
+    indexData.SetFileName("file1");
+    indexData.PutChunkDataName(ChunkDataName("file1", 10, 100));
+    indexData.PutChunkDataName(ChunkDataName("file1", 10, 101));
+    indexData.PutChunkDeltaBase(100, 5);
+
+    std::string data;
+    ASSERT_TRUE(indexData.Serialize(&data));
+    ChunkIndexData out;
+    ASSERT_TRUE(out.Unserialize(data));
+
+    ChunkDataName base;
+    ASSERT_TRUE(out.GetChunkDeltaBase(100, &base));
+    ASSERT_EQ(ChunkDataName("file1", 5, 100), base);
+    ASSERT_FALSE(out.GetChunkDeltaBase(101, &base));
+    // 基准chunk同样被该快照引用
+    ASSERT_TRUE(out.IsExistChunkDataName(ChunkDataName("file1", 5, 100)));
+    ASSERT_FALSE(out.IsExistChunkDataName(ChunkDataName("file1", 5, 101)));
+}
+
+TEST(TestChunkPageDigest, TestIsPageSame) {
+    std::string data = "aaaabbbb";
+    ChunkPageDigest digest(data.size(), 4);
+    digest.Update(0, 4, data.c_str());
+    digest.Update(4, 4, data.c_str() + 4);
+    ASSERT_TRUE(digest.IsPageSame(0, "aaaa"));
+    ASSERT_TRUE(digest.IsPageSame(1, "bbbb"));
+    ASSERT_FALSE(digest.IsPageSame(1, "bbbc"));
+    ASSERT_FALSE(digest.IsPageSame(2, "bbbb"));
+
+    // 不完整的摘要不能序列化
+    ChunkPageDigest partial(data.size(), 4);
+    partial.Update(0, 4, data.c_str());
+    std::string str;
+    ASSERT_FALSE(partial.Serialize(&str));
+}
+
+TEST(TestChunkDeltaData, TestMergeTo) {
+    ChunkDeltaData delta(4);
+    delta.PutPage(0, "cccc");
+    delta.PutPage(2, "dddd");
+    ASSERT_EQ(8, delta.GetDataSize());
+
+    std::string str;
+    ASSERT_TRUE(delta.Serialize(&str));
+    ChunkDeltaData out;
+    ASSERT_TRUE(out.Unserialize(str));
+    ASSERT_EQ(8, out.GetDataSize());
+
+    std::string data = "aaaabbbbeeee";
+    ASSERT_TRUE(out.MergeTo(&data));
+    ASSERT_EQ("ccccbbbbdddd", data);
+
+    // 增量超出基准chunk的范围
+    std::string small = "aaaabbbb";
+    ASSERT_FALSE(out.MergeTo(&small));
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
-
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <memory>
+
+#include "src/snapshotcloneserver/snapshot/snapshot_data_store_local.h"
+
+using ::curve::common::ChunkCodec;
+
+namespace curve {
+namespace snapshotcloneserver {
+
+const char kLocalStorePath[] = "./snapshot_data_store_local_test";
+const uint32_t kTestSplitSize = 4096;
+const uint32_t kTestChunkSize = 4 * kTestSplitSize;
+
+class TestLocalSnapshotDataStore : public ::testing::Test {
+ public:
+    void SetUp() {
+        system((std::string("rm -rf ") + kLocalStorePath).c_str());
+        store_ = std::make_shared<LocalSnapshotDataStore>();
+        ASSERT_EQ(0, store_->Init(kLocalStorePath));
+    }
+    void TearDown() {
+        store_ = nullptr;
+        system((std::string("rm -rf ") + kLocalStorePath).c_str());
+    }
+
+    static std::string ReadFile(const std::string &key) {
+        std::ifstream in(std::string(kLocalStorePath) + key,
+                         std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    // 分片依次为全零、可压缩、不可压缩、可压缩的数据
+    static std::string MakeChunk() {
+        std::string data(kTestChunkSize, '\0');
+        for (uint32_t i = kTestSplitSize; i < 2 * kTestSplitSize; i++) {
+            data[i] = 'a';
+        }
+        uint32_t seed = 1;
+        for (uint32_t i = 2 * kTestSplitSize; i < 3 * kTestSplitSize; i++) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = static_cast<char>(seed >> 16);
+        }
+        for (uint32_t i = 3 * kTestSplitSize; i < kTestChunkSize; i++) {
+            data[i] = 'b';
+        }
+        return data;
+    }
+
+    int Transfer(const ChunkDataName &name, const std::string &data) {
+        auto task = std::make_shared<TransferTask>();
+        task->dataSize_ = data.size();
+        if (store_->DataChunkTranferInit(name, task) < 0) {
+            return -1;
+        }
+        // 分片乱序到达
+        for (int i : {2, 0, 3, 1}) {
+            if (store_->DataChunkTranferAddPart(name, task, i,
+                    kTestSplitSize, data.data() + i * kTestSplitSize) < 0) {
+                return -1;
+            }
+        }
+        return store_->DataChunkTranferComplete(name, task);
+    }
+
+    std::shared_ptr<LocalSnapshotDataStore> store_;
+};
+
+TEST_F(TestLocalSnapshotDataStore, testChunkIndexData) {
+    ChunkIndexDataName indexName("/vol1", 1);
+    ChunkIndexData indexData;
+    indexData.SetFileName("/vol1");
+    indexData.PutChunkDataName(ChunkDataName("/vol1", 1, 0));
+    ASSERT_FALSE(store_->ChunkIndexDataExist(indexName));
+    ASSERT_EQ(-1, store_->GetChunkIndexData(indexName, &indexData));
+
+    ASSERT_EQ(0, store_->PutChunkIndexData(indexName, indexData));
+    ASSERT_TRUE(store_->ChunkIndexDataExist(indexName));
+    ChunkIndexData out;
+    ASSERT_EQ(0, store_->GetChunkIndexData(indexName, &out));
+    ASSERT_EQ("/vol1", out.GetFileName());
+    ASSERT_TRUE(out.IsExistChunkDataName(ChunkDataName("/vol1", 1, 0)));
+
+    ASSERT_EQ(0, store_->DeleteChunkIndexData(indexName));
+    ASSERT_FALSE(store_->ChunkIndexDataExist(indexName));
+    // 删除不存在的对象成功
+    ASSERT_EQ(0, store_->DeleteChunkIndexData(indexName));
+}
+
+TEST_F(TestLocalSnapshotDataStore, testTransfer) {
+    ChunkDataName name("/vol1", 1, 0);
+    std::string data = MakeChunk();
+    ASSERT_EQ(0, Transfer(name, data));
+    ASSERT_TRUE(store_->ChunkDataExist(name));
+    ASSERT_EQ(data, ReadFile(name.ToDataChunkKey()));
+    ASSERT_EQ("/vol1-0-1@local",
+              store_->GetChunkDataLocation(name.ToDataChunkKey()));
+    ChunkData chunkData;
+    ASSERT_EQ(0, store_->GetChunkData(name, &chunkData));
+    ASSERT_EQ(data, chunkData.data_);
+
+    // 终止的转储不产生数据
+    ChunkDataName name2("/vol1", 1, 1);
+    auto task = std::make_shared<TransferTask>();
+    ASSERT_EQ(0, store_->DataChunkTranferInit(name2, task));
+    ASSERT_EQ(0, store_->DataChunkTranferAddPart(name2, task, 0,
+        kTestSplitSize, data.data()));
+    ASSERT_EQ(0, store_->DataChunkTranferAbort(name2, task));
+    ASSERT_FALSE(store_->ChunkDataExist(name2));
+    ASSERT_EQ(-1, store_->DataChunkTranferComplete(name2, task));
+
+    ChunkPageDigest digest(kTestChunkSize, kTestSplitSize);
+    digest.Update(0, kTestChunkSize, data.data());
+    ASSERT_EQ(0, store_->PutChunkPageDigest(name, digest));
+    ChunkPageDigest digestOut;
+    ASSERT_EQ(0, store_->GetChunkPageDigest(name, &digestOut));
+    ASSERT_EQ(4, digestOut.GetPageNum());
+
+    ASSERT_EQ(0, store_->DeleteChunkData(name));
+    ASSERT_FALSE(store_->ChunkDataExist(name));
+    ASSERT_EQ(-1, store_->GetChunkPageDigest(name, &digestOut));
+}
+
+TEST_F(TestLocalSnapshotDataStore, testEncodedTransfer) {
+    store_->SetEncodeOption(true, kTestSplitSize);
+    ChunkDataName name("/vol1", 1, 0);
+    std::string data = MakeChunk();
+    ASSERT_EQ(0, Transfer(name, data));
+
+    std::string stored = ReadFile(name.ToDataChunkKey());
+    ASSERT_LT(stored.size(), data.size());
+    ASSERT_TRUE(ChunkCodec::DecodeChunk(&stored));
+    ASSERT_EQ(data, stored);
+
+    // 读出时解码为全量数据
+    ChunkData chunkData;
+    ASSERT_EQ(0, store_->GetChunkData(name, &chunkData));
+    ASSERT_EQ(data, chunkData.data_);
+    ASSERT_EQ(-1, store_->GetChunkData(ChunkDataName("/vol1", 1, 1),
+                                       &chunkData));
+}
+
+TEST_F(TestLocalSnapshotDataStore, testMergeChunkDeltaData) {
+    ChunkDataName base("/vol1", 1, 0);
+    ChunkDataName name("/vol1", 2, 0);
+    std::string data = MakeChunk();
+    ASSERT_EQ(0, Transfer(base, data));
+
+    std::string page(kTestSplitSize, 'c');
+    ChunkDeltaData delta(kTestSplitSize);
+    delta.PutPage(0, page.data());
+    delta.PutPage(2, page.data());
+    ASSERT_EQ(0, store_->PutChunkDeltaData(name, delta));
+    ASSERT_TRUE(store_->ChunkDeltaDataExist(name));
+
+    std::string expected = data;
+    ASSERT_TRUE(delta.MergeTo(&expected));
+    ASSERT_EQ(0, store_->MergeChunkDeltaData(name, base));
+    ASSERT_EQ(expected, ReadFile(name.ToDataChunkKey()));
+    // 基准chunk不受影响
+    ASSERT_EQ(data, ReadFile(base.ToDataChunkKey()));
+
+    // 目标需要编码时读出全量数据合并
+    store_->SetEncodeOption(true, kTestSplitSize);
+    ChunkDataName name2("/vol1", 3, 0);
+    ASSERT_EQ(0, store_->PutChunkDeltaData(name2, delta));
+    ASSERT_EQ(0, store_->MergeChunkDeltaData(name2, base));
+    std::string stored = ReadFile(name2.ToDataChunkKey());
+    ASSERT_TRUE(ChunkCodec::DecodeChunk(&stored));
+    ASSERT_EQ(expected, stored);
+
+    // 基准chunk已编码
+    store_->SetEncodeOption(false, kTestSplitSize);
+    ChunkDataName name3("/vol1", 4, 0);
+    ASSERT_EQ(0, store_->PutChunkDeltaData(name3, delta));
+    ASSERT_EQ(0, store_->MergeChunkDeltaData(name3, name2));
+    ASSERT_EQ(expected, ReadFile(name3.ToDataChunkKey()));
+
+    ASSERT_EQ(0, store_->DeleteChunkDeltaData(name));
+    ASSERT_FALSE(store_->ChunkDeltaDataExist(name));
+    // 增量数据不存在
+    ASSERT_EQ(-1, store_->MergeChunkDeltaData(name, base));
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
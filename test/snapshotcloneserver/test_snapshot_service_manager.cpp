@@ -39,6 +39,7 @@ using ::testing::SetArgPointee;
 using ::testing::Invoke;
 using ::testing::DoAll;
 using ::testing::Property;
+using ::testing::SaveArg;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -964,6 +965,52 @@ TEST_F(TestSnapshotServiceManager, TestGetSnapshotListByFilterFail) {
     ASSERT_EQ(kErrCodeInternalError, ret);
 }
 
+TEST_F(TestSnapshotServiceManager, TestGetSnapshotListByPage) {
+    const std::string user = "user1";
+    const std::string status = "0";
+    std::vector<SnapshotInfo> snapInfo;
+    snapInfo.emplace_back("uuid2", user, "file1", "snap2");
+    snapInfo.back().SetStatus(Status::done);
+
+    SnapshotListFilter listFilter;
+    EXPECT_CALL(*core_, GetSnapshotListByPage(_, 1, 10, _, _))
+        .WillOnce(DoAll(SaveArg<0>(&listFilter),
+                SetArgPointee<3>(snapInfo),
+                SetArgPointee<4>(2),
+                Return(kErrCodeSuccess)));
+
+    SnapshotFilterCondition filter(nullptr, nullptr, &user, &status);
+    std::vector<FileSnapshotInfo> fileSnapInfo;
+    uint64_t total = 0;
+    int ret = manager_->GetSnapshotListByPage(filter, 1, 10,
+        &fileSnapInfo, &total);
+    ASSERT_EQ(kErrCodeSuccess, ret);
+    ASSERT_EQ(2, total);
+    ASSERT_EQ(1, fileSnapInfo.size());
+    ASSERT_EQ("uuid2", fileSnapInfo[0].GetSnapshotInfo().GetUuid());
+    ASSERT_EQ(100, fileSnapInfo[0].GetSnapProgress());
+    ASSERT_EQ(nullptr, listFilter.file);
+    ASSERT_EQ(user, *listFilter.user);
+    ASSERT_EQ(Status::done, *listFilter.status);
+
+    // 非法的状态过滤条件
+    const std::string badStatus = "x";
+    filter.SetStatus(&badStatus);
+    fileSnapInfo.clear();
+    ret = manager_->GetSnapshotListByPage(filter, 0, 10,
+        &fileSnapInfo, &total);
+    ASSERT_EQ(kErrCodeSuccess, ret);
+    ASSERT_EQ(0, total);
+    ASSERT_EQ(0, fileSnapInfo.size());
+
+    filter.SetStatus(nullptr);
+    EXPECT_CALL(*core_, GetSnapshotListByPage(_, 0, 10, _, _))
+        .WillOnce(Return(kErrCodeInternalError));
+    ret = manager_->GetSnapshotListByPage(filter, 0, 10,
+        &fileSnapInfo, &total);
+    ASSERT_EQ(kErrCodeInternalError, ret);
+}
+
 TEST_F(TestSnapshotServiceManager, TestRecoverSnapshotTaskSuccess) {
     const std::string file1 = "file1";
     const std::string user1 = "user1";
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: Sun Oct 18 2026
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "src/snapshotcloneserver/snapshot/snapshot_transfer_pipeline.h"
+#include "src/snapshotcloneserver/common/task_tracker.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+SnapshotTransferOption MakeTransferOption() {
+    SnapshotTransferOption option;
+    option.splitSize = 4096;
+    option.bufferPoolSize = 2 * 4096;
+    option.readConcurrency = 1;
+    option.uploadThreadNum = 2;
+    return option;
+}
+
+TEST(TestSnapshotTransferPipeline, TestBufferPool) {
+    SnapshotTransferPipeline pipeline(MakeTransferOption());
+    ASSERT_EQ(0, pipeline.Start());
+    ASSERT_EQ(4096, pipeline.GetSplitSize());
+
+    auto buf1 = pipeline.TryAcquireBuffer();
+    auto buf2 = pipeline.TryAcquireBuffer();
+    ASSERT_NE(nullptr, buf1);
+    ASSERT_NE(nullptr, buf2);
+    // 缓冲区用尽
+    ASSERT_EQ(nullptr, pipeline.TryAcquireBuffer());
+
+    // 归还后复用同一块缓冲区
+    char *raw = buf1.get();
+    buf1.reset();
+    auto buf3 = pipeline.TryAcquireBuffer();
+    ASSERT_EQ(raw, buf3.get());
+
+    // 阻塞分配等待归还
+    std::thread releaser([&buf2]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        buf2.reset();
+    });
+    auto buf4 = pipeline.AcquireBuffer();
+    ASSERT_NE(nullptr, buf4);
+    releaser.join();
+    pipeline.Stop();
+}
+
+TEST(TestSnapshotTransferPipeline, TestReadSlot) {
+    SnapshotTransferPipeline pipeline(MakeTransferOption());
+    ASSERT_EQ(0, pipeline.Start());
+
+    pipeline.AcquireReadSlot();
+    std::atomic<bool> acquired(false);
+    std::thread reader([&pipeline, &acquired]() {
+        pipeline.AcquireReadSlot();
+        acquired = true;
+        pipeline.ReleaseReadSlot(4096);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // 达到读并发上限，等待
+    ASSERT_FALSE(acquired);
+    pipeline.ReleaseReadSlot(4096);
+    reader.join();
+    ASSERT_TRUE(acquired);
+    pipeline.Stop();
+}
+
+TEST(TestSnapshotTransferPipeline, TestUpload) {
+    SnapshotTransferPipeline pipeline(MakeTransferOption());
+    ASSERT_EQ(0, pipeline.Start());
+
+    auto tracker = std::make_shared<TaskTracker>();
+    std::atomic<int> count(0);
+    for (int i = 0; i < 10; i++) {
+        auto buf = pipeline.AcquireBuffer();
+        tracker->AddOneTrace();
+        // 上传任务持有缓冲区，上传结束后归还
+        pipeline.PushUpload([buf, tracker, &count, &pipeline]() {
+            count++;
+            pipeline.AddUploadBytes(4096);
+            tracker->HandleResponse(0);
+        });
+    }
+    tracker->Wait();
+    ASSERT_EQ(10, count);
+    ASSERT_EQ(0, tracker->GetResult());
+    pipeline.Stop();
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
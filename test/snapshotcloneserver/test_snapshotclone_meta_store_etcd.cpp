@@ -27,6 +27,9 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <thread>  //NOLINT
+#include <chrono>  //NOLINT
+#include <future>  //NOLINT
 
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store_etcd.h"
 #include "src/kvstorageclient/etcd_client.h"
@@ -316,6 +319,178 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     ASSERT_EQ(-1, ret);
 }
 
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestGetSnapshotListByPage) {
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .Times(7)
+        .WillRepeatedly(Return(EtcdErrCode::EtcdOK));
+    for (int i = 0; i < 6; i++) {
+        SnapshotInfo snapInfo("uuid" + std::to_string(i),
+                            "user" + std::to_string(i % 2),
+                            "file" + std::to_string(i % 3), "snapxxx", 100,
+                            1024, 2048, 4096, 0, 0, 0,
+                            i < 4 ? Status::done : Status::pending);
+        ASSERT_EQ(0, metaStore_->AddSnapshot(snapInfo));
+    }
+
+    // 不过滤，按uuid顺序分页
+    std::vector<SnapshotInfo> list;
+    uint64_t total = 0;
+    SnapshotListFilter filter;
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 1, 3,
+        &list, &total));
+    ASSERT_EQ(6, total);
+    ASSERT_EQ(3, list.size());
+    ASSERT_EQ("uuid1", list[0].GetUuid());
+    ASSERT_EQ("uuid2", list[1].GetUuid());
+    ASSERT_EQ("uuid3", list[2].GetUuid());
+
+    // 超出范围
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 6, 3,
+        &list, &total));
+    ASSERT_EQ(6, total);
+    ASSERT_EQ(0, list.size());
+
+    // 按用户和状态过滤
+    std::string user = "user1";
+    Status status = Status::done;
+    filter.user = &user;
+    filter.status = &status;
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 0, 10,
+        &list, &total));
+    ASSERT_EQ(2, total);
+    ASSERT_EQ(2, list.size());
+    ASSERT_EQ("uuid1", list[0].GetUuid());
+    ASSERT_EQ("uuid3", list[1].GetUuid());
+
+    // 按文件过滤
+    std::string file = "file1";
+    filter = SnapshotListFilter();
+    filter.file = &file;
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 1, 10,
+        &list, &total));
+    ASSERT_EQ(2, total);
+    ASSERT_EQ(1, list.size());
+    ASSERT_EQ("uuid4", list[0].GetUuid());
+
+    // 按uuid过滤
+    std::string uuid = "uuid5";
+    filter.file = nullptr;
+    filter.uuid = &uuid;
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 0, 10,
+        &list, &total));
+    ASSERT_EQ(1, total);
+    ASSERT_EQ("uuid5", list[0].GetUuid());
+
+    // 更新状态后索引随之更新
+    SnapshotInfo snapInfo5;
+    ASSERT_EQ(0, metaStore_->GetSnapshotInfo("uuid5", &snapInfo5));
+    snapInfo5.SetStatus(Status::done);
+    ASSERT_EQ(0, metaStore_->UpdateSnapshot(snapInfo5));
+    filter.uuid = nullptr;
+    filter.status = &status;
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 0, 10,
+        &list, &total));
+    ASSERT_EQ(5, total);
+
+    EXPECT_CALL(*kvStorageClient_, Delete(_))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    ASSERT_EQ(0, metaStore_->DeleteSnapshot("uuid5"));
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetSnapshotListByPage(filter, 0, 10,
+        &list, &total));
+    ASSERT_EQ(4, total);
+    ASSERT_EQ(5, metaStore_->GetSnapshotCount());
+}
+
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestUpdateSnapshotBatchCommit) {
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(EtcdErrCode::EtcdOK));
+    std::vector<SnapshotInfo> snapInfos;
+    for (int i = 0; i < 3; i++) {
+        snapInfos.emplace_back("uuid" + std::to_string(i), "snapuser",
+                            "file1", "snapxxx", 100,
+                            1024, 2048, 4096, 0, 0, 0,
+                            Status::pending);
+        ASSERT_EQ(0, metaStore_->AddSnapshot(snapInfos.back()));
+    }
+
+    // 第一个更新提交etcd时阻塞，期间的更新排队等待下一批提交
+    std::promise<void> putBlocked;
+    std::promise<void> putRelease;
+    std::shared_future<void> release = putRelease.get_future().share();
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .WillOnce(Invoke([&](const std::string&, const std::string&) {
+            putBlocked.set_value();
+            release.wait();
+            return EtcdErrCode::EtcdOK;
+        }));
+    std::vector<Operation> committed;
+    EXPECT_CALL(*kvStorageClient_, TxnN(_))
+        .WillOnce(Invoke([&](const std::vector<Operation> &ops) {
+            committed = ops;
+            return EtcdErrCode::EtcdOK;
+        }));
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        ASSERT_EQ(0, metaStore_->UpdateSnapshot(snapInfos[0]));
+    });
+    putBlocked.get_future().wait();
+
+    // uuid1的两次非终态更新合并，uuid2的终态更新单独提交
+    SnapshotInfo info1 = snapInfos[1];
+    info1.SetSnapshotName("snap1");
+    SnapshotInfo info2 = snapInfos[1];
+    info2.SetSnapshotName("snap2");
+    SnapshotInfo info3 = snapInfos[2];
+    info3.SetStatus(Status::done);
+    for (auto &info : {info1, info2, info3}) {
+        threads.emplace_back([this, info]() {
+            ASSERT_EQ(0, metaStore_->UpdateSnapshot(info));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    putRelease.set_value();
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(2, committed.size());
+    SnapshotInfo out;
+    ASSERT_EQ(0, metaStore_->GetSnapshotInfo("uuid1", &out));
+    ASSERT_TRUE(JudgeSnapshotInfoEqual(info2, out));
+    ASSERT_EQ(0, metaStore_->GetSnapshotInfo("uuid2", &out));
+    ASSERT_TRUE(JudgeSnapshotInfoEqual(info3, out));
+}
+
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestUpdateSnapshotBatchCommitFail) {
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    SnapshotInfo snapInfo("uuid0", "snapuser", "file1", "snapxxx", 100,
+                        1024, 2048, 4096, 0, 0, 0,
+                        Status::pending);
+    ASSERT_EQ(0, metaStore_->AddSnapshot(snapInfo));
+
+    // 提交失败时内存记录不变
+    SnapshotInfo snapInfo2 = snapInfo;
+    snapInfo2.SetSnapshotName("snap2");
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdUnknown));
+    ASSERT_EQ(-1, metaStore_->UpdateSnapshot(snapInfo2));
+    SnapshotInfo out;
+    ASSERT_EQ(0, metaStore_->GetSnapshotInfo("uuid0", &out));
+    ASSERT_TRUE(JudgeSnapshotInfoEqual(snapInfo, out));
+}
+
 // cloneInfo
 
 TEST_F(TestSnapshotCloneMetaStoreEtcd,
@@ -415,9 +590,6 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     int ret = metaStore_->AddCloneInfo(cloneInfo);
     ASSERT_EQ(0, ret);
 
-    EXPECT_CALL(*kvStorageClient_, Get(_, _))
-        .WillOnce(Return(EtcdErrCode::EtcdOK));
-
     EXPECT_CALL(*kvStorageClient_, Put(_, _))
         .WillOnce(Return(EtcdErrCode::EtcdOK));
 
@@ -453,9 +625,6 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     int ret = metaStore_->AddCloneInfo(cloneInfo);
     ASSERT_EQ(0, ret);
 
-    EXPECT_CALL(*kvStorageClient_, Get(_, _))
-        .WillOnce(Return(EtcdErrCode::EtcdOK));
-
     EXPECT_CALL(*kvStorageClient_, Put(_, _))
         .WillOnce(Return(EtcdErrCode::EtcdUnknown));
 
@@ -472,8 +641,9 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
                      CloneStep::kCompleteCloneFile,
                      CloneStatus::cloning);
 
-    EXPECT_CALL(*kvStorageClient_, Get(_, _))
-        .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist));
+    // 内存中没有旧记录，不写etcd
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .Times(0);
 
     int ret = metaStore_->UpdateCloneInfo(cloneInfo);
     ASSERT_EQ(-1, ret);
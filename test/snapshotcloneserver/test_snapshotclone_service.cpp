@@ -351,9 +351,10 @@ TEST_F(TestSnapshotCloneServiceImpl, TestGetFileSnapshotListSuccess) {
     info.SetSnapshotInfo(sinfo);
     info.SetSnapProgress(50);
     infoVec.push_back(info);
-    EXPECT_CALL(*snapshotManager_, GetSnapshotListByFilter(_, _))
+    EXPECT_CALL(*snapshotManager_, GetSnapshotListByPage(_, 0, 10, _, _))
         .WillOnce(DoAll(
-                    SetArgPointee<1>(infoVec),
+                    SetArgPointee<3>(infoVec),
+                    SetArgPointee<4>(1),
                     Return(kErrCodeSuccess)));
 
     brpc::Channel channel;
@@ -420,9 +421,11 @@ TEST_F(TestSnapshotCloneServiceImpl,
     infoVec.push_back(info2);
     infoVec.push_back(info3);
 
-    EXPECT_CALL(*snapshotManager_, GetSnapshotListByFilter(_, _))
+    infoVec.erase(infoVec.begin());
+    EXPECT_CALL(*snapshotManager_, GetSnapshotListByPage(_, 1, 10, _, _))
         .WillOnce(DoAll(
-                    SetArgPointee<1>(infoVec),
+                    SetArgPointee<3>(infoVec),
+                    SetArgPointee<4>(3),
                     Return(kErrCodeSuccess)));
 
     brpc::Channel channel;
@@ -813,10 +816,8 @@ TEST_F(TestSnapshotCloneServiceImpl, TestGetFileSnapshotListFail) {
     std::string user = "test";
 
     std::vector<FileSnapshotInfo> info;
-    EXPECT_CALL(*snapshotManager_, GetSnapshotListByFilter(_, _))
-        .WillOnce(DoAll(
-                    SetArgPointee<1>(info),
-                    Return(kErrCodeInternalError)));
+    EXPECT_CALL(*snapshotManager_, GetSnapshotListByPage(_, 0, 10, _, _))
+        .WillOnce(Return(kErrCodeInternalError));
 
     brpc::Channel channel;
     brpc::ChannelOptions option;
@@ -2006,6 +2007,71 @@ TEST_F(TestSnapshotCloneServiceImpl, TestGetCloneRefStatusFail) {
     ASSERT_EQ(brpc::HTTP_STATUS_INTERNAL_SERVER_ERROR,
                     cntl.http_response().status_code());
 }
+
+TEST_F(TestSnapshotCloneServiceImpl, TestReportCloneReadMissSuccess) {
+    std::map<uint64_t, uint32_t> missCounts = {{1, 3}, {2, 1}};
+    EXPECT_CALL(*cloneManager_, ReportCloneReadMiss(missCounts))
+        .Times(1);
+
+    brpc::Channel channel;
+    brpc::ChannelOptions option;
+    option.protocol = "http";
+    std::string url = std::string("http://127.0.0.1:")
+                    + std::to_string(listenAddr_.port)
+                    + "/" + kServiceName + "?"
+                    + kActionStr + "=" + kReportCloneReadMissAction + "&"
+                    + kVersionStr + "=1";
+
+    if (channel.Init(url.c_str(), "", &option) != 0) {
+        FAIL() << "Fail to init channel"
+               << std::endl;
+    }
+
+    brpc::Controller cntl;
+    cntl.http_request().uri() = url.c_str();
+    cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+    cntl.request_attachment().append(
+        "{\"ReadMiss\":[{\"ChunkId\":1,\"Count\":2},"
+        "{\"ChunkId\":2,\"Count\":1},{\"ChunkId\":1,\"Count\":1}]}");
+
+    channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+    if (cntl.Failed()) {
+        LOG(ERROR) << cntl.ErrorText();
+    }
+    ASSERT_EQ(brpc::HTTP_STATUS_OK, cntl.http_response().status_code());
+}
+
+TEST_F(TestSnapshotCloneServiceImpl, TestReportCloneReadMissInvalidBody) {
+    EXPECT_CALL(*cloneManager_, ReportCloneReadMiss(_))
+        .Times(0);
+
+    brpc::Channel channel;
+    brpc::ChannelOptions option;
+    option.protocol = "http";
+    std::string url = std::string("http://127.0.0.1:")
+                    + std::to_string(listenAddr_.port)
+                    + "/" + kServiceName + "?"
+                    + kActionStr + "=" + kReportCloneReadMissAction + "&"
+                    + kVersionStr + "=1";
+
+    if (channel.Init(url.c_str(), "", &option) != 0) {
+        FAIL() << "Fail to init channel"
+               << std::endl;
+    }
+
+    brpc::Controller cntl;
+    cntl.http_request().uri() = url.c_str();
+    cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+    cntl.request_attachment().append(
+        "{\"ReadMiss\":[{\"ChunkId\":\"a\",\"Count\":2}]}");
+
+    channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+    if (cntl.Failed()) {
+        LOG(ERROR) << cntl.ErrorText();
+    }
+    ASSERT_EQ(brpc::HTTP_STATUS_BAD_REQUEST,
+                    cntl.http_response().status_code());
+}
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
@@ -71,6 +71,7 @@ TEST(TestSnapshotCloneServerCodec, TestCloneInfoEncodeDecodeEqual) {
                      CloneFileType::kSnapshot, false,
                      CloneStep::kCompleteCloneFile,
                      CloneStatus::recovering);
+    cloneInfo.SetIsBulk(true);
 
     SnapshotCloneCodec testObj;
     std::string value;
@@ -89,6 +90,7 @@ TEST(TestSnapshotCloneServerCodec, TestCloneInfoEncodeDecodeEqual) {
     ASSERT_EQ(cloneInfo.GetTime(), decodeCloneInfo.GetTime());
     ASSERT_EQ(cloneInfo.GetFileType(), decodeCloneInfo.GetFileType());
     ASSERT_EQ(cloneInfo.GetIsLazy(), decodeCloneInfo.GetIsLazy());
+    ASSERT_EQ(cloneInfo.GetIsBulk(), decodeCloneInfo.GetIsBulk());
     ASSERT_EQ(cloneInfo.GetNextStep(), decodeCloneInfo.GetNextStep());
     ASSERT_EQ(cloneInfo.GetStatus(), decodeCloneInfo.GetStatus());
 }
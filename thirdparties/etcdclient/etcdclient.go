@@ -93,6 +93,7 @@ import (
 	"strings"
 	"sync"
 	"time"
+	"unsafe"
 )
 
 const (
@@ -103,6 +104,7 @@ const (
 	EtcdDelete    = "Delete"
 	EtcdTxn2      = "Txn2"
 	EtcdTxn3      = "Txn3"
+	EtcdTxnN      = "TxnN"
 	EtcdCmpAndSwp = "CmpAndSwp"
 )
 
@@ -388,6 +390,24 @@ func EtcdClientTxn3(
 	return GetErrCode(EtcdTxn3, err)
 }
 
+//export EtcdClientTxnN
+func EtcdClientTxnN(
+	timeout C.int, cops *C.struct_Operation, opNum C.int) C.enum_EtcdErrCode {
+	ops := (*[1 << 20]C.struct_Operation)(unsafe.Pointer(cops))[:opNum:opNum]
+	etcdOps, err := GenOpList(ops)
+	if err != nil {
+		log.Printf("unknown op types, err: %v", err)
+		return C.EtcdTxnUnkownOp
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(),
+		time.Duration(int(timeout))*time.Millisecond)
+	defer cancel()
+
+	_, err = globalClient.Txn(ctx).Then(etcdOps...).Commit()
+	return GetErrCode(EtcdTxnN, err)
+}
+
 //export EtcdClientCompareAndSwap
 func EtcdClientCompareAndSwap(timeout C.int, key, prev, target *C.char,
 	keyLen, preLen, targetLen C.int) C.enum_EtcdErrCode {